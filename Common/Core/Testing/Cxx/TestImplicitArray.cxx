@@ -0,0 +1,238 @@
+/*==============================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImplicitArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+==============================================================================*/
+#include "vtkAffineArray.h"
+#include "vtkCompositeArray.h"
+#include "vtkConstantArray.h"
+#include "vtkIndexedArray.h"
+
+#include "vtkDataArrayRange.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkSmartPointer.h"
+
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+#define testAssert(expr, errorMessage)                                                             \
+  if (!(expr))                                                                                     \
+  {                                                                                                \
+    ++errors;                                                                                      \
+    vtkGenericWarningMacro(<< "Assertion failed: " #expr << "\n" << errorMessage);                 \
+  }
+
+//------------------------------------------------------------------------------
+int TestConstant()
+{
+  int errors = 0;
+
+  vtkNew<vtkConstantArray<int>> array;
+  array->ConstructBackend(42);
+  array->SetNumberOfComponents(2);
+  array->SetNumberOfTuples(1000);
+
+  testAssert(array->GetNumberOfValues() == 2000, "Wrong number of values.");
+  testAssert(array->GetArrayType() == vtkAbstractArray::ImplicitArray, "Wrong array type.");
+  testAssert(array->GetDataType() == VTK_INT, "Wrong data type.");
+  testAssert(array->GetActualMemorySize() < 2, "Implicit array holds memory.");
+
+  const auto range = vtk::DataArrayValueRange(array.GetPointer());
+  for (const int value : range)
+  {
+    testAssert(value == 42, "Wrong constant value.");
+  }
+
+  double valueRange[2];
+  array->GetRange(valueRange, 1);
+  testAssert(valueRange[0] == 42. && valueRange[1] == 42., "Wrong range.");
+
+  // NewInstance must return a writable array of the same value type:
+  vtkSmartPointer<vtkDataArray> copy = vtk::TakeSmartPointer(array->NewInstance());
+  testAssert(vtkIntArray::SafeDownCast(copy) != nullptr, "NewInstance is not a vtkIntArray.");
+  copy->DeepCopy(array);
+  testAssert(copy->GetNumberOfTuples() == 1000 && copy->GetComponent(999, 1) == 42.,
+    "DeepCopy into an AOS array failed.");
+
+  // Shallow copies share the backend:
+  vtkNew<vtkConstantArray<int>> shallow;
+  shallow->ShallowCopy(array);
+  testAssert(shallow->GetBackend() == array->GetBackend(), "ShallowCopy did not share backend.");
+  testAssert(shallow->GetNumberOfTuples() == 1000, "ShallowCopy lost the number of tuples.");
+
+  // Materialization into an AOS buffer:
+  std::vector<int> buffer(2000, 0);
+  array->ExportToVoidPointer(buffer.data());
+  testAssert(buffer[0] == 42 && buffer[1999] == 42, "ExportToVoidPointer failed.");
+
+  return errors;
+}
+
+//------------------------------------------------------------------------------
+int TestAffine()
+{
+  int errors = 0;
+
+  vtkNew<vtkAffineArray<double>> array;
+  array->ConstructBackend(0.5, 10.);
+  array->SetNumberOfComponents(3);
+  array->SetNumberOfTuples(100);
+
+  vtkIdType valueIdx = 0;
+  for (const double value : vtk::DataArrayValueRange<3>(array.GetPointer()))
+  {
+    testAssert(value == 0.5 * valueIdx + 10., "Wrong affine value at " << valueIdx);
+    ++valueIdx;
+  }
+  testAssert(valueIdx == 300, "Wrong number of iterated values.");
+
+  const auto tuples = vtk::DataArrayTupleRange<3>(array.GetPointer());
+  testAssert(tuples[10][2] == 0.5 * 32 + 10., "Wrong tuple component.");
+
+  double tuple[3];
+  array->GetTuple(99, tuple);
+  testAssert(tuple[0] == 0.5 * 297 + 10., "Wrong GetTuple value.");
+
+  vtkNew<vtkAffineArray<double>> deep;
+  deep->DeepCopy(array);
+  testAssert(deep->GetBackend() != array->GetBackend(), "DeepCopy shared the backend.");
+  testAssert(deep->GetValue(299) == array->GetValue(299), "DeepCopy changed values.");
+
+  return errors;
+}
+
+//------------------------------------------------------------------------------
+int TestComposite()
+{
+  int errors = 0;
+
+  vtkNew<vtkFloatArray> first;
+  first->SetNumberOfComponents(2);
+  first->SetNumberOfTuples(3);
+  vtkNew<vtkIntArray> second;
+  second->SetNumberOfComponents(2);
+  second->SetNumberOfTuples(4);
+  for (vtkIdType i = 0; i < 6; ++i)
+  {
+    first->SetValue(i, static_cast<float>(i));
+  }
+  for (vtkIdType i = 0; i < 8; ++i)
+  {
+    second->SetValue(i, static_cast<int>(6 + i));
+  }
+  // Arrays of the composite value type are read without conversion:
+  vtkNew<vtkDoubleArray> third;
+  third->SetNumberOfComponents(2);
+  third->SetNumberOfTuples(2);
+  for (vtkIdType i = 0; i < 4; ++i)
+  {
+    third->SetValue(i, static_cast<double>(14 + i));
+  }
+
+  vtkNew<vtkCompositeArray<double>> array;
+  array->ConstructBackend(std::vector<vtkDataArray*>{ first, second, third });
+  array->SetNumberOfComponents(2);
+  testAssert(array->GetBackend()->GetNumberOfValues() == 18, "Wrong composite size.");
+
+  // The composite array cannot be larger than the arrays it concatenates:
+  vtkObject::GlobalWarningDisplayOff();
+  array->SetNumberOfTuples(10);
+  vtkObject::GlobalWarningDisplayOn();
+  testAssert(array->GetNumberOfTuples() == 0, "Composite array larger than its arrays.");
+  array->SetNumberOfTuples(9);
+  testAssert(array->GetNumberOfTuples() == 9, "Wrong number of composite tuples.");
+
+  vtkIdType valueIdx = 0;
+  for (const double value : vtk::DataArrayValueRange<2>(array.GetPointer()))
+  {
+    testAssert(value == static_cast<double>(valueIdx), "Wrong composite value at " << valueIdx);
+    ++valueIdx;
+  }
+  testAssert(valueIdx == 18, "Wrong number of iterated values.");
+
+  return errors;
+}
+
+//------------------------------------------------------------------------------
+int TestIndexed()
+{
+  int errors = 0;
+
+  vtkNew<vtkIntArray> base;
+  base->SetNumberOfComponents(2);
+  base->SetNumberOfTuples(10);
+  for (vtkIdType i = 0; i < 20; ++i)
+  {
+    base->SetValue(i, static_cast<int>(i));
+  }
+
+  vtkNew<vtkIdList> handles;
+  handles->InsertNextId(9);
+  handles->InsertNextId(0);
+  handles->InsertNextId(4);
+
+  vtkNew<vtkIndexedArray<int>> array;
+  array->ConstructBackend(handles, base);
+  array->SetNumberOfComponents(2);
+
+  // There are as many indexed tuples as handles:
+  vtkObject::GlobalWarningDisplayOff();
+  bool resized = array->SetNumberOfValues(8);
+  vtkObject::GlobalWarningDisplayOn();
+  testAssert(!resized && array->GetNumberOfTuples() == 0, "Indexed array larger than handles.");
+  array->SetNumberOfTuples(handles->GetNumberOfIds());
+  testAssert(array->GetNumberOfTuples() == 3, "Wrong number of indexed tuples.");
+
+  testAssert(array->GetTypedComponent(0, 0) == 18 && array->GetTypedComponent(0, 1) == 19,
+    "Wrong indexed tuple 0.");
+  testAssert(array->GetTypedComponent(1, 1) == 1, "Wrong indexed tuple 1.");
+  testAssert(array->GetTypedComponent(2, 0) == 8, "Wrong indexed tuple 2.");
+  testAssert(array->LookupTypedValue(8) == 4, "Wrong lookup result.");
+
+  // Arrays of another value type are converted:
+  vtkNew<vtkFloatArray> floats;
+  floats->SetNumberOfComponents(2);
+  floats->SetNumberOfTuples(10);
+  for (vtkIdType i = 0; i < 20; ++i)
+  {
+    floats->SetValue(i, static_cast<float>(i) + 0.25f);
+  }
+  vtkNew<vtkIndexedArray<int>> converted;
+  converted->ConstructBackend(handles, floats);
+  converted->SetNumberOfComponents(2);
+  converted->SetNumberOfTuples(handles->GetNumberOfIds());
+  testAssert(converted->GetTypedComponent(0, 1) == 19 && converted->GetTypedComponent(2, 0) == 8,
+    "Wrong converted indexed values.");
+
+  return errors;
+}
+
+} // end anon namespace
+
+//------------------------------------------------------------------------------
+int TestImplicitArray(int, char*[])
+{
+  int errors = 0;
+  errors += TestConstant();
+  errors += TestAffine();
+  errors += TestComposite();
+  errors += TestIndexed();
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -10,6 +10,7 @@
 #include "vtkMathConfigure.h"
 
 #include <limits>
+#include <vector>
 
 #ifndef ABS
 #define ABS(x) ((x) < 0 ? -(x) : (x))
@@ -573,6 +574,67 @@ int TestMath(int, char*[])
     return 1;
   }
 
+  // Test LUFactorLinearSystem on singular matrices, more times than it
+  // warns, with sizes for which it allocates its scaling buffer or not.
+  {
+    vtkObject::GlobalWarningDisplayOff();
+    bool singularPassed = true;
+    for (int size : { 3, 12 })
+    {
+      for (bool zeroRow : { true, false })
+      {
+        for (int repeat = 0; repeat < 5; ++repeat)
+        {
+          // the last row is null, or the sum of the first two rows
+          std::vector<double> values(size * size);
+          std::vector<double*> A(size);
+          std::vector<int> index(size);
+          std::vector<double> scale(size);
+          for (int threadSafe = 0; threadSafe < 2; ++threadSafe)
+          {
+            for (int i = 0; i < size; ++i)
+            {
+              A[i] = &values[i * size];
+              for (int j = 0; j < size; ++j)
+              {
+                A[i][j] = (i == j ? 2.0 : 0.0) + (j == 0 ? i : 0.0);
+              }
+            }
+            for (int j = 0; j < size; ++j)
+            {
+              A[size - 1][j] = zeroRow ? 0.0 : A[0][j] + A[1][j];
+            }
+            vtkTypeBool factored = threadSafe
+              ? vtkMath::LUFactorLinearSystem(A.data(), index.data(), size, scale.data())
+              : vtkMath::LUFactorLinearSystem(A.data(), index.data(), size);
+            if (factored)
+            {
+              std::cerr << "LUFactorLinearSystem factored a singular " << size << "x" << size
+                        << " matrix" << (threadSafe ? " with a scaling buffer" : "") << " ("
+                        << (zeroRow ? "null row" : "dependent rows") << ", call " << repeat
+                        << ")." << std::endl;
+              singularPassed = false;
+            }
+          }
+        }
+      }
+    }
+    vtkObject::GlobalWarningDisplayOn();
+    if (!singularPassed)
+    {
+      return 1;
+    }
+
+    double row0[3] = { 4, 1, 0 }, row1[3] = { 1, 4, 1 }, row2[3] = { 0, 1, 4 };
+    double* A[3] = { row0, row1, row2 };
+    int index[3];
+    if (!vtkMath::LUFactorLinearSystem(A, index, 3))
+    {
+      std::cerr << "LUFactorLinearSystem failed on a regular matrix." << std::endl;
+      return 1;
+    }
+  }
+
   // Test color conversion.
   int colorsPassed = 1;
 
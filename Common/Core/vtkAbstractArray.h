@@ -659,6 +659,7 @@ public:
     TypedDataArray,
     MappedDataArray,
     ScaleSoADataArrayTemplate,
+    ImplicitArray,
 
     DataArrayTemplate = AoSDataArrayTemplate //! Legacy
   };
@@ -0,0 +1,64 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAffineArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkAffineArray
+ * @brief   An implicit array whose values are an affine function of their
+ * index.
+ *
+ *
+ * vtkAffineArray is a vtkImplicitArray driven by vtkAffineImplicitBackend: the
+ * value at (AOS) value index i is `Slope * i + Intercept`. Typical uses are
+ * ids (slope 1, intercept 0) and regularly spaced coordinates.
+ *
+ * @code
+ * vtkNew<vtkAffineArray<vtkIdType>> ids;
+ * ids->ConstructBackend(1, 0);
+ * ids->SetNumberOfTuples(numberOfPoints);
+ * @endcode
+ *
+ * @sa
+ * vtkImplicitArray vtkConstantArray
+ */
+
+#ifndef vtkAffineArray_h
+#define vtkAffineArray_h
+
+#include "vtkImplicitArray.h"
+
+template <typename ValueType>
+struct vtkAffineImplicitBackend
+{
+  vtkAffineImplicitBackend() = default;
+  vtkAffineImplicitBackend(ValueType slope, ValueType intercept)
+    : Slope(slope)
+    , Intercept(intercept)
+  {
+  }
+
+  ValueType operator()(vtkIdType valueIdx) const
+  {
+    return static_cast<ValueType>(this->Slope * valueIdx + this->Intercept);
+  }
+
+  ValueType Slope = ValueType(1);
+  ValueType Intercept = ValueType(0);
+};
+
+template <typename ValueType>
+using vtkAffineArray = vtkImplicitArray<vtkAffineImplicitBackend<ValueType>>;
+
+#endif // vtkAffineArray_h
+
+// VTK-HeaderTest-Exclude: vtkAffineArray.h
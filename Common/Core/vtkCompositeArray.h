@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompositeArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkCompositeArray
+ * @brief   An implicit array concatenating other arrays.
+ *
+ *
+ * vtkCompositeArray is a vtkImplicitArray driven by
+ * vtkCompositeImplicitBackend: its tuples are the tuples of a list of arrays
+ * laid end to end, without copying them. All the arrays must have the number
+ * of components of the composite array. The arrays are referenced, not
+ * copied, so modifying them modifies the composite array. Arrays storing the
+ * value type of the composite array contiguously are read without virtual
+ * calls; other arrays go through vtkDataArray::GetComponent.
+ *
+ * @code
+ * vtkNew<vtkCompositeArray<double>> coords;
+ * coords->ConstructBackend(std::vector<vtkDataArray*>{ first, second });
+ * coords->SetNumberOfComponents(3);
+ * coords->SetNumberOfTuples(first->GetNumberOfTuples() + second->GetNumberOfTuples());
+ * @endcode
+ *
+ * @sa
+ * vtkImplicitArray vtkIndexedArray
+ */
+
+#ifndef vtkCompositeArray_h
+#define vtkCompositeArray_h
+
+#include "vtkAOSDataArrayTemplate.h" // For the typed fast path
+#include "vtkDataArray.h"
+#include "vtkImplicitArray.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+#include <algorithm> // For std::upper_bound
+#include <vector>    // For std::vector
+
+template <typename ValueType>
+struct vtkCompositeImplicitBackend
+{
+  vtkCompositeImplicitBackend() = default;
+  vtkCompositeImplicitBackend(const std::vector<vtkDataArray*>& arrays)
+  {
+    this->Offsets.reserve(arrays.size() + 1);
+    this->Offsets.push_back(0);
+    for (vtkDataArray* array : arrays)
+    {
+      if (!array)
+      {
+        continue;
+      }
+      this->Arrays.emplace_back(array);
+      this->TypedArrays.push_back(vtkArrayDownCast<vtkAOSDataArrayTemplate<ValueType>>(array));
+      this->Offsets.push_back(this->Offsets.back() + array->GetNumberOfValues());
+    }
+  }
+
+  ValueType operator()(vtkIdType valueIdx) const
+  {
+    // Offsets[i] is the first value index of Arrays[i]:
+    const auto upper = std::upper_bound(this->Offsets.begin() + 1, this->Offsets.end(), valueIdx);
+    const std::size_t arrayIdx = static_cast<std::size_t>(upper - this->Offsets.begin() - 1);
+    const vtkIdType localIdx = valueIdx - this->Offsets[arrayIdx];
+    if (const vtkAOSDataArrayTemplate<ValueType>* typed = this->TypedArrays[arrayIdx])
+    {
+      return typed->GetValue(localIdx);
+    }
+    vtkDataArray* array = this->Arrays[arrayIdx];
+    const int numComps = array->GetNumberOfComponents();
+    return static_cast<ValueType>(array->GetComponent(localIdx / numComps, localIdx % numComps));
+  }
+
+  /**
+   * Total number of values of the concatenated arrays.
+   */
+  vtkIdType GetNumberOfValues() const { return this->Offsets.empty() ? 0 : this->Offsets.back(); }
+
+  std::vector<vtkSmartPointer<vtkDataArray>> Arrays;
+  // Arrays[i] when it stores ValueType contiguously, read without virtual calls:
+  std::vector<vtkAOSDataArrayTemplate<ValueType>*> TypedArrays;
+  std::vector<vtkIdType> Offsets;
+};
+
+template <typename ValueType>
+using vtkCompositeArray = vtkImplicitArray<vtkCompositeImplicitBackend<ValueType>>;
+
+#endif // vtkCompositeArray_h
+
+// VTK-HeaderTest-Exclude: vtkCompositeArray.h
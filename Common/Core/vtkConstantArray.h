@@ -0,0 +1,59 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConstantArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConstantArray
+ * @brief   An implicit array returning the same value everywhere.
+ *
+ *
+ * vtkConstantArray is a vtkImplicitArray driven by vtkConstantImplicitBackend.
+ * It is well suited for attributes that do not vary over a dataset, such as
+ * block or process ids, and uses a constant amount of memory whatever its
+ * number of tuples.
+ *
+ * @code
+ * vtkNew<vtkConstantArray<int>> blockIds;
+ * blockIds->ConstructBackend(blockId);
+ * blockIds->SetNumberOfTuples(numberOfCells);
+ * @endcode
+ *
+ * @sa
+ * vtkImplicitArray vtkAffineArray
+ */
+
+#ifndef vtkConstantArray_h
+#define vtkConstantArray_h
+
+#include "vtkImplicitArray.h"
+
+template <typename ValueType>
+struct vtkConstantImplicitBackend
+{
+  vtkConstantImplicitBackend() = default;
+  vtkConstantImplicitBackend(ValueType value)
+    : Value(value)
+  {
+  }
+
+  ValueType operator()(vtkIdType vtkNotUsed(valueIdx)) const { return this->Value; }
+
+  ValueType Value = ValueType();
+};
+
+template <typename ValueType>
+using vtkConstantArray = vtkImplicitArray<vtkConstantImplicitBackend<ValueType>>;
+
+#endif // vtkConstantArray_h
+
+// VTK-HeaderTest-Exclude: vtkConstantArray.h
@@ -11,6 +11,10 @@
 # - VTK_DISPATCH_SOA_ARRAYS (default: OFF)
 #   Include vtkSOADataArrayTemplate<ValueType> for the basic types supported
 #   by VTK.
+# - VTK_DISPATCH_IMPLICIT_ARRAYS (default: OFF)
+#   Include vtkConstantArray<ValueType>, vtkAffineArray<ValueType>,
+#   vtkCompositeArray<ValueType> and vtkIndexedArray<ValueType> for the basic
+#   types supported by VTK.
 # - VTK_DISPATCH_TYPED_ARRAYS (default: OFF)
 #   Include vtkTypedDataArray<ValueType> for the basic types supported
 #   by VTK. This enables the old-style in-situ vtkMappedDataArray subclasses
@@ -138,6 +142,16 @@ if (VTK_DISPATCH_SOA_ARRAYS)
   endif()
 endif()
 
+if (VTK_DISPATCH_IMPLICIT_ARRAYS)
+  foreach (implicit_array IN ITEMS vtkConstantArray vtkAffineArray vtkCompositeArray vtkIndexedArray)
+    list(APPEND vtkArrayDispatch_containers ${implicit_array})
+    set(vtkArrayDispatch_${implicit_array}_header ${implicit_array}.h)
+    set(vtkArrayDispatch_${implicit_array}_types
+      ${vtkArrayDispatch_all_types}
+    )
+  endforeach()
+endif()
+
 if (VTK_DISPATCH_TYPED_ARRAYS)
   list(APPEND vtkArrayDispatch_containers vtkTypedDataArray)
   set(vtkArrayDispatch_vtkTypedDataArray_header vtkTypedDataArray.h)
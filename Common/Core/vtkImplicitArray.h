@@ -0,0 +1,293 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkImplicitArray
+ * @brief   A read-only vtkGenericDataArray whose values are computed on the
+ * fly by a backend functor.
+ *
+ *
+ * vtkImplicitArray stores no values. Instead, every value access is
+ * forwarded to a backend object that maps a value index (in AOS ordering) to
+ * a value. The backend may be any copy-constructible type that provides:
+ *
+ * @code
+ * ValueType operator()(vtkIdType valueIdx) const;
+ * @endcode
+ *
+ * The ValueType of the array is deduced from the return type of this call
+ * operator. The number of components and tuples of the array are set as
+ * usual with SetNumberOfComponents and SetNumberOfTuples; these calls do not
+ * allocate any memory.
+ *
+ * Backends shipped with VTK are:
+ * - vtkConstantImplicitBackend (see vtkConstantArray)
+ * - vtkAffineImplicitBackend (see vtkAffineArray)
+ * - vtkCompositeImplicitBackend (see vtkCompositeArray)
+ * - vtkIndexedImplicitBackend (see vtkIndexedArray)
+ *
+ * Since vtkImplicitArray is a vtkGenericDataArray, it can be read through the
+ * vtkGenericDataArray API, vtk::DataArrayValueRange / vtk::DataArrayTupleRange
+ * and vtkArrayDispatch (when VTK_DISPATCH_IMPLICIT_ARRAYS is enabled) without
+ * materializing its values. The array is read-only: all set/insert methods
+ * report an error. NewInstance returns a vtkAOSDataArrayTemplate of the same
+ * value type so that algorithms which copy or interpolate attributes keep
+ * working. GetVoidPointer materializes the values in an internal AOS buffer
+ * and should be avoided.
+ *
+ * @code
+ * vtkNew<vtkConstantArray<int>> materials;
+ * materials->ConstructBackend(42);
+ * materials->SetNumberOfTuples(numberOfCells);
+ * @endcode
+ *
+ * @sa
+ * vtkGenericDataArray vtkAOSDataArrayTemplate vtkSOADataArrayTemplate
+ */
+
+#ifndef vtkImplicitArray_h
+#define vtkImplicitArray_h
+
+#include "vtkAOSDataArrayTemplate.h" // For NewInstance
+#include "vtkBuffer.h"                // For materialized AOS copy
+#include "vtkCommonCoreModule.h"      // For export macro
+#include "vtkGenericDataArray.h"
+#include "vtkObjectFactory.h" // For VTK_STANDARD_NEW_BODY
+
+#include <memory>      // For std::shared_ptr
+#include <type_traits> // For std::decay
+#include <utility>     // For std::declval, std::forward
+
+namespace vtkImplicitArrayDetail
+{
+/**
+ * Deduce the value type of an implicit array from the return type of its
+ * backend's call operator.
+ */
+template <class BackendT>
+struct BackendValueType
+{
+  using type =
+    typename std::decay<decltype(std::declval<const BackendT&>()(vtkIdType(0)))>::type;
+};
+
+/**
+ * Number of values a backend can provide, or -1 when it does not tell
+ * through a GetNumberOfValues() method.
+ */
+template <class BackendT>
+auto BackendNumberOfValues(const BackendT& backend, int)
+  -> decltype(static_cast<vtkIdType>(backend.GetNumberOfValues()))
+{
+  return static_cast<vtkIdType>(backend.GetNumberOfValues());
+}
+
+template <class BackendT>
+vtkIdType BackendNumberOfValues(const BackendT&, long)
+{
+  return -1;
+}
+} // namespace vtkImplicitArrayDetail
+
+template <class BackendT>
+class vtkImplicitArray
+  : public vtkGenericDataArray<vtkImplicitArray<BackendT>,
+      typename vtkImplicitArrayDetail::BackendValueType<BackendT>::type>
+{
+  using GenericDataArrayType = vtkGenericDataArray<vtkImplicitArray<BackendT>,
+    typename vtkImplicitArrayDetail::BackendValueType<BackendT>::type>;
+
+public:
+  using SelfType = vtkImplicitArray<BackendT>;
+  vtkAbstractTypeMacroWithNewInstanceType(
+    SelfType, GenericDataArrayType, vtkDataArray, typeid(SelfType).name());
+  using ValueType = typename Superclass::ValueType;
+  using BackendType = BackendT;
+
+  static vtkImplicitArray* New();
+
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Get the value at @a valueIdx. @a valueIdx assumes AOS ordering.
+   */
+  inline ValueType GetValue(vtkIdType valueIdx) const { return (*this->Backend)(valueIdx); }
+
+  /**
+   * Implicit arrays are read-only: this reports an error.
+   */
+  void SetValue(vtkIdType valueIdx, ValueType value);
+
+  /**
+   * Copy the tuple at @a tupleIdx into @a tuple.
+   */
+  inline void GetTypedTuple(vtkIdType tupleIdx, ValueType* tuple) const
+  {
+    const vtkIdType valueIdx = tupleIdx * this->NumberOfComponents;
+    for (int comp = 0; comp < this->NumberOfComponents; ++comp)
+    {
+      tuple[comp] = this->GetValue(valueIdx + comp);
+    }
+  }
+
+  /**
+   * Implicit arrays are read-only: this reports an error.
+   */
+  void SetTypedTuple(vtkIdType tupleIdx, const ValueType* tuple);
+
+  /**
+   * Get component @a comp of the tuple at @a tupleIdx.
+   */
+  inline ValueType GetTypedComponent(vtkIdType tupleIdx, int comp) const
+  {
+    return this->GetValue(tupleIdx * this->NumberOfComponents + comp);
+  }
+
+  /**
+   * Implicit arrays are read-only: this reports an error.
+   */
+  void SetTypedComponent(vtkIdType tupleIdx, int comp, ValueType value);
+
+  ///@{
+  /**
+   * Get/Set the backend computing the values of this array. The backend is
+   * shared between arrays that are shallow copies of each other.
+   */
+  void SetBackend(std::shared_ptr<BackendT> newBackend);
+  std::shared_ptr<BackendT> GetBackend() const { return this->Backend; }
+  ///@}
+
+  /**
+   * Construct a new backend in place from @a params and use it for this
+   * array.
+   */
+  template <typename... Params>
+  void ConstructBackend(Params&&... params)
+  {
+    this->SetBackend(std::make_shared<BackendT>(std::forward<Params>(params)...));
+  }
+
+  /**
+   * Use of this method is discouraged, it creates a deep copy of the data into
+   * a contiguous AoS-ordered buffer and prints a warning.
+   */
+  void* GetVoidPointer(vtkIdType valueIdx) override;
+
+  /**
+   * Export a copy of the data in AoS ordering to the preallocated memory
+   * buffer.
+   */
+  void ExportToVoidPointer(void* ptr) override;
+
+  /**
+   * Return the memory in kibibytes consumed by this array. Implicit arrays
+   * do not store their values, so this does not depend on the number of
+   * tuples (a materialized copy from GetVoidPointer is accounted for).
+   */
+  unsigned long GetActualMemorySize() const override;
+
+  ///@{
+  /**
+   * Copies are only supported from arrays of the same implicit type. A deep
+   * copy duplicates the backend while a shallow copy shares it.
+   */
+  void DeepCopy(vtkAbstractArray* aa) override { this->Superclass::DeepCopy(aa); }
+  void DeepCopy(vtkDataArray* other) override;
+  void ShallowCopy(vtkDataArray* other) override;
+  ///@}
+
+  ///@{
+  /**
+   * Set the number of tuples or values of the array. When the backend tells
+   * how many values it provides (see vtkCompositeArray and vtkIndexedArray),
+   * larger sizes are rejected with an error: SetNumberOfValues returns false
+   * and SetNumberOfTuples leaves the array unchanged.
+   */
+  void SetNumberOfTuples(vtkIdType numTuples) override;
+  bool SetNumberOfValues(vtkIdType numValues) override;
+  ///@}
+
+  /**
+   * Implicit arrays hold no memory, nothing to squeeze.
+   */
+  void Squeeze() override {}
+
+#ifndef __VTK_WRAP__
+  /**
+   * Perform a fast, safe cast from a vtkAbstractArray to a vtkImplicitArray.
+   * This method checks if source->GetArrayType() returns ImplicitArray
+   * and that the backend type matches before returning source as a
+   * vtkImplicitArray pointer. Otherwise, nullptr is returned.
+   */
+  static vtkImplicitArray<BackendT>* FastDownCast(vtkAbstractArray* source);
+#endif
+
+  int GetArrayType() const override { return vtkAbstractArray::ImplicitArray; }
+
+protected:
+  vtkImplicitArray();
+  ~vtkImplicitArray() override;
+
+  /**
+   * Return a writable AOS array of the same value type, such as vtkIntArray.
+   */
+  vtkObjectBase* NewInstanceInternal() const override
+  {
+    if (vtkDataArray* da = vtkDataArray::CreateDataArray(SelfType::VTK_DATA_TYPE))
+    {
+      return da;
+    }
+    return vtkAOSDataArrayTemplate<ValueType>::New();
+  }
+
+  ///@{
+  /**
+   * No memory is needed to hold the values: these only validate the
+   * request.
+   */
+  bool AllocateTuples(vtkIdType numTuples);
+  bool ReallocateTuples(vtkIdType numTuples);
+  ///@}
+
+  /**
+   * Report an error and return false when the backend cannot provide
+   * @a numValues values.
+   */
+  bool CheckNumberOfValues(vtkIdType numValues);
+
+  std::shared_ptr<BackendT> Backend;
+  vtkBuffer<ValueType>* AoSCopy;
+
+private:
+  vtkImplicitArray(const vtkImplicitArray&) = delete;
+  void operator=(const vtkImplicitArray&) = delete;
+
+  friend class vtkGenericDataArray<vtkImplicitArray<BackendT>, ValueType>;
+};
+
+// Declare vtkArrayDownCast implementations for implicit arrays:
+template <typename BackendT>
+struct vtkArrayDownCast_impl<vtkImplicitArray<BackendT>>
+{
+  inline vtkImplicitArray<BackendT>* operator()(vtkAbstractArray* array)
+  {
+    return vtkImplicitArray<BackendT>::FastDownCast(array);
+  }
+};
+
+#include "vtkImplicitArray.txx"
+
+#endif // vtkImplicitArray_h
+
+// VTK-HeaderTest-Exclude: vtkImplicitArray.h
@@ -0,0 +1,281 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArray.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkImplicitArray_txx
+#define vtkImplicitArray_txx
+
+#include "vtkImplicitArray.h"
+
+#include <cstdlib>
+#include <typeinfo>
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>* vtkImplicitArray<BackendT>::New()
+{
+  VTK_STANDARD_NEW_BODY(vtkImplicitArray<BackendT>);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>::vtkImplicitArray()
+  : AoSCopy(nullptr)
+{
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>::~vtkImplicitArray()
+{
+  if (this->AoSCopy)
+  {
+    this->AoSCopy->Delete();
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Backend: " << (this->Backend ? typeid(BackendT).name() : "(none)") << "\n";
+  os << indent << "Materialized: " << (this->AoSCopy ? "yes" : "no") << "\n";
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetValue(vtkIdType, ValueType)
+{
+  vtkErrorMacro("SetValue is not supported by read-only implicit arrays.");
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetTypedTuple(vtkIdType, const ValueType*)
+{
+  vtkErrorMacro("SetTypedTuple is not supported by read-only implicit arrays.");
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetTypedComponent(vtkIdType, int, ValueType)
+{
+  vtkErrorMacro("SetTypedComponent is not supported by read-only implicit arrays.");
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetBackend(std::shared_ptr<BackendT> newBackend)
+{
+  if (this->Backend == newBackend)
+  {
+    return;
+  }
+  this->Backend = newBackend;
+  if (this->AoSCopy)
+  {
+    this->AoSCopy->Delete();
+    this->AoSCopy = nullptr;
+  }
+  this->DataChanged();
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+bool vtkImplicitArray<BackendT>::AllocateTuples(vtkIdType numTuples)
+{
+  return numTuples >= 0;
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+bool vtkImplicitArray<BackendT>::ReallocateTuples(vtkIdType numTuples)
+{
+  return numTuples >= 0;
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+bool vtkImplicitArray<BackendT>::CheckNumberOfValues(vtkIdType numValues)
+{
+  if (!this->Backend)
+  {
+    return true;
+  }
+  const vtkIdType available = vtkImplicitArrayDetail::BackendNumberOfValues(*this->Backend, 0);
+  if (available >= 0 && numValues > available)
+  {
+    vtkErrorMacro(<< "Cannot size the array to " << numValues << " values, its backend only "
+                  << "provides " << available << ".");
+    return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::SetNumberOfTuples(vtkIdType numTuples)
+{
+  if (this->CheckNumberOfValues(numTuples * this->NumberOfComponents))
+  {
+    this->Superclass::SetNumberOfTuples(numTuples);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+bool vtkImplicitArray<BackendT>::SetNumberOfValues(vtkIdType numValues)
+{
+  return this->CheckNumberOfValues(numValues) && this->Superclass::SetNumberOfValues(numValues);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void* vtkImplicitArray<BackendT>::GetVoidPointer(vtkIdType valueIdx)
+{
+  // Allow warnings to be silenced:
+  const char* silence = getenv("VTK_SILENCE_GET_VOID_POINTER_WARNINGS");
+  if (!silence)
+  {
+    vtkWarningMacro(<< "GetVoidPointer called. This is very expensive for "
+                       "implicit arrays, as the values must be generated "
+                       "for each call. Using the vtkGenericDataArray API "
+                       "with vtkArrayDispatch are preferred. Define the "
+                       "environment variable "
+                       "VTK_SILENCE_GET_VOID_POINTER_WARNINGS to silence "
+                       "this warning.");
+  }
+
+  const vtkIdType numValues = this->GetNumberOfValues();
+
+  if (!this->AoSCopy)
+  {
+    this->AoSCopy = vtkBuffer<ValueType>::New();
+  }
+
+  if (!this->AoSCopy->Allocate(numValues))
+  {
+    vtkErrorMacro(<< "Error allocating a buffer of " << numValues << " '"
+                  << this->GetDataTypeAsString() << "' elements.");
+    return nullptr;
+  }
+
+  this->ExportToVoidPointer(static_cast<void*>(this->AoSCopy->GetBuffer()));
+
+  return static_cast<void*>(this->AoSCopy->GetBuffer() + valueIdx);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::ExportToVoidPointer(void* voidPtr)
+{
+  const vtkIdType numValues = this->GetNumberOfValues();
+  if (numValues == 0)
+  {
+    // Nothing to do.
+    return;
+  }
+
+  if (!voidPtr)
+  {
+    vtkErrorMacro(<< "Buffer is nullptr.");
+    return;
+  }
+
+  if (!this->Backend)
+  {
+    vtkErrorMacro(<< "No backend set on implicit array.");
+    return;
+  }
+
+  ValueType* ptr = static_cast<ValueType*>(voidPtr);
+  const BackendT& backend = *this->Backend;
+  for (vtkIdType valueIdx = 0; valueIdx < numValues; ++valueIdx)
+  {
+    *ptr++ = backend(valueIdx);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+unsigned long vtkImplicitArray<BackendT>::GetActualMemorySize() const
+{
+  size_t numBytes = sizeof(BackendT);
+  if (this->AoSCopy)
+  {
+    numBytes += static_cast<size_t>(this->AoSCopy->GetSize()) * sizeof(ValueType);
+  }
+  return static_cast<unsigned long>(numBytes / 1024 + 1);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::DeepCopy(vtkDataArray* other)
+{
+  if (!other || other == this)
+  {
+    return;
+  }
+
+  SelfType* o = SelfType::FastDownCast(other);
+  if (!o)
+  {
+    vtkErrorMacro(<< "Cannot deep copy a " << other->GetClassName()
+                  << " into a read-only implicit array.");
+    return;
+  }
+
+  this->vtkAbstractArray::DeepCopy(other);
+  this->SetNumberOfComponents(o->GetNumberOfComponents());
+  this->Size = o->Size;
+  this->MaxId = o->MaxId;
+  this->SetBackend(o->Backend ? std::make_shared<BackendT>(*o->Backend) : nullptr);
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+void vtkImplicitArray<BackendT>::ShallowCopy(vtkDataArray* other)
+{
+  SelfType* o = SelfType::FastDownCast(other);
+  if (o)
+  {
+    this->Size = o->Size;
+    this->MaxId = o->MaxId;
+    this->SetName(o->Name);
+    this->SetNumberOfComponents(o->NumberOfComponents);
+    this->CopyComponentNames(o);
+    this->SetBackend(o->Backend);
+  }
+  else
+  {
+    this->Superclass::ShallowCopy(other);
+  }
+}
+
+//-----------------------------------------------------------------------------
+template <class BackendT>
+vtkImplicitArray<BackendT>* vtkImplicitArray<BackendT>::FastDownCast(vtkAbstractArray* source)
+{
+  if (source && source->GetArrayType() == vtkAbstractArray::ImplicitArray &&
+    vtkDataTypesCompare(source->GetDataType(), vtkTypeTraits<ValueType>::VTK_TYPE_ID))
+  {
+    // Several backends share the same value type, so the backend itself must
+    // be checked.
+    return dynamic_cast<vtkImplicitArray<BackendT>*>(source);
+  }
+  return nullptr;
+}
+
+#endif // vtkImplicitArray_txx
@@ -0,0 +1,90 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIndexedArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkIndexedArray
+ * @brief   An implicit array indexing into another array.
+ *
+ *
+ * vtkIndexedArray is a vtkImplicitArray driven by vtkIndexedImplicitBackend:
+ * tuple i of the array is tuple `Handles->GetId(i)` of the referenced array.
+ * It can be used to express a subset or a permutation of an array (e.g. the
+ * attributes of extracted cells) without copying the values. The indexed
+ * array must have the number of components of the referenced array. A
+ * referenced array storing the value type of the indexed array contiguously
+ * is read without virtual calls.
+ *
+ * @code
+ * vtkNew<vtkIndexedArray<float>> subset;
+ * subset->ConstructBackend(cellIds, input->GetCellData()->GetArray("Pressure"));
+ * subset->SetNumberOfTuples(cellIds->GetNumberOfIds());
+ * @endcode
+ *
+ * @sa
+ * vtkImplicitArray vtkCompositeArray
+ */
+
+#ifndef vtkIndexedArray_h
+#define vtkIndexedArray_h
+
+#include "vtkAOSDataArrayTemplate.h" // For the typed fast path
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkImplicitArray.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+template <typename ValueType>
+struct vtkIndexedImplicitBackend
+{
+  vtkIndexedImplicitBackend() = default;
+  vtkIndexedImplicitBackend(vtkIdList* handles, vtkDataArray* array)
+    : Handles(handles)
+    , Array(array)
+    , TypedArray(vtkArrayDownCast<vtkAOSDataArrayTemplate<ValueType>>(array))
+  {
+  }
+
+  ValueType operator()(vtkIdType valueIdx) const
+  {
+    const int numComps = this->Array->GetNumberOfComponents();
+    const vtkIdType tupleIdx = this->Handles->GetId(valueIdx / numComps);
+    if (this->TypedArray)
+    {
+      return this->TypedArray->GetValue(tupleIdx * numComps + valueIdx % numComps);
+    }
+    return static_cast<ValueType>(this->Array->GetComponent(tupleIdx, valueIdx % numComps));
+  }
+
+  /**
+   * Number of values the indexed array can provide.
+   */
+  vtkIdType GetNumberOfValues() const
+  {
+    return this->Handles && this->Array
+      ? this->Handles->GetNumberOfIds() * this->Array->GetNumberOfComponents()
+      : 0;
+  }
+
+  vtkSmartPointer<vtkIdList> Handles;
+  vtkSmartPointer<vtkDataArray> Array;
+  // Array when it stores ValueType contiguously, read without virtual calls:
+  vtkAOSDataArrayTemplate<ValueType>* TypedArray = nullptr;
+};
+
+template <typename ValueType>
+using vtkIndexedArray = vtkImplicitArray<vtkIndexedImplicitBackend<ValueType>>;
+
+#endif // vtkIndexedArray_h
+
+// VTK-HeaderTest-Exclude: vtkIndexedArray.h
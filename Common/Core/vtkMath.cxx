@@ -31,6 +31,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkTypeTraits.h"
 
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <limits>
@@ -519,7 +520,7 @@ vtkTypeBool vtkMath::LUFactorLinearSystem(double** A, int* index, int size)
   double largest, temp1, temp2, sum;
 
   // Manage number of output warnings
-  static int numWarns = 0;
+  static std::atomic<int> numWarns(0);
 
   //
   // Loop over rows to get implicit scaling information
@@ -534,9 +535,16 @@ vtkTypeBool vtkMath::LUFactorLinearSystem(double** A, int* index, int size)
       }
     }
 
-    if (largest == 0.0 && numWarns++ < VTK_MAX_WARNS)
+    if (largest == 0.0)
     {
-      vtkGenericWarningMacro(<< "Unable to factor linear system");
+      if (numWarns++ < VTK_MAX_WARNS)
+      {
+        vtkGenericWarningMacro(<< "Unable to factor linear system");
+      }
+      if (size >= 10)
+      {
+        delete[] scale;
+      }
       return 0;
     }
     scale[i] = 1.0 / largest;
@@ -591,9 +599,16 @@ vtkTypeBool vtkMath::LUFactorLinearSystem(double** A, int* index, int size)
     //
     index[j] = maxI;
 
-    if (fabs(A[j][j]) <= VTK_SMALL_NUMBER && numWarns++ < VTK_MAX_WARNS)
+    if (fabs(A[j][j]) <= VTK_SMALL_NUMBER)
     {
-      vtkGenericWarningMacro(<< "Unable to factor linear system");
+      if (numWarns++ < VTK_MAX_WARNS)
+      {
+        vtkGenericWarningMacro(<< "Unable to factor linear system");
+      }
+      if (size >= 10)
+      {
+        delete[] scale;
+      }
       return 0;
     }
 
@@ -1314,7 +1329,7 @@ vtkTypeBool vtkMath::LUFactorLinearSystem(double** A, int* index, int size, doub
   double largest, temp1, temp2, sum;
 
   // Manage number of output warnings
-  static int numWarns = 0;
+  static std::atomic<int> numWarns(0);
 
   //
   // Loop over rows to get implicit scaling information
@@ -1329,9 +1344,12 @@ vtkTypeBool vtkMath::LUFactorLinearSystem(double** A, int* index, int size, doub
       }
     }
 
-    if (largest == 0.0 && numWarns++ < VTK_MAX_WARNS)
+    if (largest == 0.0)
     {
-      vtkGenericWarningMacro(<< "Unable to factor linear system");
+      if (numWarns++ < VTK_MAX_WARNS)
+      {
+        vtkGenericWarningMacro(<< "Unable to factor linear system");
+      }
       return 0;
     }
     tmpSize[i] = 1.0 / largest;
@@ -1386,9 +1404,12 @@ vtkTypeBool vtkMath::LUFactorLinearSystem(double** A, int* index, int size, doub
     //
     index[j] = maxI;
 
-    if (fabs(A[j][j]) <= VTK_SMALL_NUMBER && numWarns++ < VTK_MAX_WARNS)
+    if (fabs(A[j][j]) <= VTK_SMALL_NUMBER)
     {
-      vtkGenericWarningMacro(<< "Unable to factor linear system");
+      if (numWarns++ < VTK_MAX_WARNS)
+      {
+        vtkGenericWarningMacro(<< "Unable to factor linear system");
+      }
       return 0;
     }
 
@@ -0,0 +1,133 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMergePointsBatch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkMergePoints::InsertUniquePoints() merges and numbers the
+// points exactly as inserting them one at a time with InsertUniquePoint().
+
+#include "vtkIdList.h"
+#include "vtkMergePoints.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+bool CheckBatch(vtkPoints* points, const std::vector<vtkIdType>& ids, int dataType)
+{
+  double bounds[6];
+  points->GetBounds(bounds);
+  vtkIdType numIds = static_cast<vtkIdType>(ids.size());
+
+  vtkNew<vtkMergePoints> serial;
+  vtkNew<vtkPoints> serialPoints;
+  serialPoints->SetDataType(dataType);
+  serial->InitPointInsertion(serialPoints, bounds, numIds);
+  std::vector<vtkIdType> serialIds(numIds);
+  for (vtkIdType i = 0; i < numIds; ++i)
+  {
+    serial->InsertUniquePoint(points->GetPoint(ids[i]), serialIds[i]);
+  }
+
+  vtkNew<vtkMergePoints> batch;
+  vtkNew<vtkPoints> batchPoints;
+  batchPoints->SetDataType(dataType);
+  batch->InitPointInsertion(batchPoints, bounds, numIds);
+  std::vector<vtkIdType> batchIds(numIds);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 4 },
+    [&]() { batch->InsertUniquePoints(points, numIds, ids.data(), batchIds.data()); });
+
+  if (batchIds != serialIds ||
+    batchPoints->GetNumberOfPoints() != serialPoints->GetNumberOfPoints())
+  {
+    std::cerr << "The points are not merged as with InsertUniquePoint()." << std::endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < batchPoints->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], y[3];
+    batchPoints->GetPoint(ptId, x);
+    serialPoints->GetPoint(ptId, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      std::cerr << "Point " << ptId << " differs from InsertUniquePoint()." << std::endl;
+      return false;
+    }
+  }
+
+  // the locator keeps working with the inserted points
+  for (vtkIdType ptId = 0; ptId < batchPoints->GetNumberOfPoints(); ++ptId)
+  {
+    vtkIdType id;
+    if (batch->InsertUniquePoint(batchPoints->GetPoint(ptId), id) != 0 || id != ptId)
+    {
+      std::cerr << "Point " << ptId << " is not found after the batch insertion." << std::endl;
+      return false;
+    }
+  }
+  vtkIdType id;
+  double x[3] = { bounds[0], bounds[2], 0.5 * (bounds[4] + bounds[5]) + 1.0e-3 };
+  if (batch->InsertUniquePoint(x, id) != 1 || id != serialPoints->GetNumberOfPoints())
+  {
+    std::cerr << "A new point is not inserted after the batch insertion." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestMergePointsBatch(int, char*[])
+{
+  // points on a coarse lattice so that many of them coincide, with a few
+  // negative zeros that coincide with the positive ones
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int i = 0; i < 20000; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = static_cast<int>(random->GetNextRangeValue(-10., 10.)) * 0.1;
+    }
+    if (i % 97 == 0)
+    {
+      x[1] = -0.0;
+    }
+    points->InsertNextPoint(x);
+  }
+
+  // insert each point several times, in another order
+  std::vector<vtkIdType> ids;
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    ids.push_back((i * 7919) % points->GetNumberOfPoints());
+    if (i % 3 == 0)
+    {
+      ids.push_back(i);
+    }
+  }
+
+  bool success = CheckBatch(points, ids, VTK_DOUBLE);
+  success &= CheckBatch(points, ids, VTK_FLOAT);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
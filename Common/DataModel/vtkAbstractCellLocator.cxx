@@ -19,6 +19,7 @@
 #include "vtkDataArray.h"
 #include "vtkDataArrayRange.h"
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -26,9 +27,13 @@
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 vtkAbstractCellLocator::vtkAbstractCellLocator()
 {
@@ -57,9 +62,17 @@ bool vtkAbstractCellLocator::StoreCellBounds()
   // Allocate space for cell bounds storage, then fill
   vtkIdType numCells = this->DataSet->GetNumberOfCells();
   this->CellBounds = new double[numCells][6];
-  for (vtkIdType j = 0; j < numCells; j++)
+  if (numCells > 0)
   {
-    this->DataSet->GetCellBounds(j, CellBounds[j]);
+    // The first call to GetCellBounds() may build cells or links which is not
+    // thread safe, so do it serially before computing the rest in parallel.
+    this->DataSet->GetCellBounds(0, this->CellBounds[0]);
+    vtkSMPTools::For(1, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType j = begin; j < end; j++)
+      {
+        this->DataSet->GetCellBounds(j, this->CellBounds[j]);
+      }
+    });
   }
   return true;
 }
@@ -197,6 +210,157 @@ vtkIdType vtkAbstractCellLocator::FindCell(
   }
   return returnVal;
 }
+//------------------------------------------------------------------------------
+namespace
+{
+// Execute the queries of a batch, the first one by the calling thread so
+// that it builds the locator if needed.
+template <typename Functor>
+void ExecuteQueries(vtkIdType numQueries, bool concurrent, Functor& query)
+{
+  if (numQueries < 1)
+  {
+    return;
+  }
+  query(0, 1);
+  if (concurrent)
+  {
+    vtkSMPTools::For(1, numQueries, query);
+  }
+  else
+  {
+    query(1, numQueries);
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::FindCells(
+  vtkPoints* points, double tol2, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  cellIds->SetNumberOfIds(numPts);
+  vtkIdType* ids = cellIds->GetPointer(0);
+  double* pc = nullptr;
+  if (pcoords)
+  {
+    pcoords->SetNumberOfComponents(3);
+    pcoords->SetNumberOfTuples(numPts);
+    pc = pcoords->GetPointer(0);
+  }
+  int maxCellSize = this->DataSet ? this->DataSet->GetMaxCellSize() : 0;
+
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<double>> tlWeights;
+  auto find = [&](vtkIdType ptId, vtkIdType endPtId) {
+    vtkGenericCell* cell = tlCell.Local();
+    std::vector<double>& weights = tlWeights.Local();
+    weights.resize(maxCellSize > 0 ? maxCellSize : 1);
+    double x[3], pcLocal[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      points->GetPoint(ptId, x);
+      ids[ptId] = this->FindCell(x, tol2, cell, pcLocal, weights.data());
+      if (pc)
+      {
+        std::copy(pcLocal, pcLocal + 3, pc + 3 * ptId);
+      }
+    }
+  };
+  ::ExecuteQueries(numPts, this->SupportsConcurrentQueries(), find);
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::FindClosestPoints(
+  vtkPoints* points, vtkIdList* cellIds, vtkPoints* closestPoints, vtkDoubleArray* dist2)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  cellIds->SetNumberOfIds(numPts);
+  vtkIdType* ids = cellIds->GetPointer(0);
+  if (closestPoints)
+  {
+    closestPoints->SetNumberOfPoints(numPts);
+  }
+  double* d2 = nullptr;
+  if (dist2)
+  {
+    dist2->SetNumberOfComponents(1);
+    dist2->SetNumberOfTuples(numPts);
+    d2 = dist2->GetPointer(0);
+  }
+
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  auto find = [&](vtkIdType ptId, vtkIdType endPtId) {
+    vtkGenericCell* cell = tlCell.Local();
+    double x[3], closest[3], distance2;
+    int subId;
+    for (; ptId < endPtId; ++ptId)
+    {
+      points->GetPoint(ptId, x);
+      ids[ptId] = -1;
+      distance2 = VTK_DOUBLE_MAX;
+      this->FindClosestPoint(x, closest, cell, ids[ptId], subId, distance2);
+      if (closestPoints)
+      {
+        closestPoints->SetPoint(ptId, closest);
+      }
+      if (d2)
+      {
+        d2[ptId] = distance2;
+      }
+    }
+  };
+  ::ExecuteQueries(numPts, this->SupportsConcurrentQueries(), find);
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::IntersectWithLines(
+  vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  vtkIdType numLines = std::min(p1->GetNumberOfPoints(), p2->GetNumberOfPoints());
+  cellIds->SetNumberOfIds(numLines);
+  vtkIdType* ids = cellIds->GetPointer(0);
+  double* tValues = nullptr;
+  if (t)
+  {
+    t->SetNumberOfComponents(1);
+    t->SetNumberOfTuples(numLines);
+    tValues = t->GetPointer(0);
+  }
+  if (x)
+  {
+    x->SetNumberOfPoints(numLines);
+  }
+
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  auto intersect = [&](vtkIdType lineId, vtkIdType endLineId) {
+    vtkGenericCell* cell = tlCell.Local();
+    double a0[3], a1[3], tLocal, xLocal[3], pcoords[3];
+    int subId;
+    for (; lineId < endLineId; ++lineId)
+    {
+      p1->GetPoint(lineId, a0);
+      p2->GetPoint(lineId, a1);
+      ids[lineId] = -1;
+      tLocal = VTK_DOUBLE_MAX;
+      xLocal[0] = xLocal[1] = xLocal[2] = 0.0;
+      if (!this->IntersectWithLine(a0, a1, tol, tLocal, xLocal, pcoords, subId, ids[lineId], cell))
+      {
+        ids[lineId] = -1;
+      }
+      if (tValues)
+      {
+        tValues[lineId] = tLocal;
+      }
+      if (x)
+      {
+        x->SetPoint(lineId, xLocal);
+      }
+    }
+  };
+  ::ExecuteQueries(numLines, this->SupportsConcurrentQueries(), intersect);
+}
+
 //------------------------------------------------------------------------------
 bool vtkAbstractCellLocator::InsideCellBounds(double x[3], vtkIdType cell_ID)
 {
@@ -43,6 +43,7 @@
 #include <vector> // For Weights
 
 class vtkCellArray;
+class vtkDoubleArray;
 class vtkGenericCell;
 class vtkIdList;
 class vtkPoints;
@@ -252,6 +253,33 @@ public:
   virtual vtkIdType FindCell(
     double x[3], double tol2, vtkGenericCell* GenCell, double pcoords[3], double* weights);
 
+  ///@{
+  /**
+   * Batched versions of FindCell(), FindClosestPoint() and IntersectWithLine()
+   * that process all the points, or all the segments (p1[i],p2[i]), of the
+   * given vtkPoints. cellIds is resized to hold the id of the cell found for
+   * each query, or -1, and the optional arrays are resized to hold the
+   * parametric coordinates, the closest points, the squared distances, the
+   * line parameters or the intersection points of each query. The first
+   * query is executed by the calling thread, which builds the locator if
+   * needed, then the others are executed in parallel with vtkSMPTools if
+   * SupportsConcurrentQueries() returns true, sequentially otherwise.
+   */
+  void FindCells(
+    vtkPoints* points, double tol2, vtkIdList* cellIds, vtkDoubleArray* pcoords = nullptr);
+  void FindClosestPoints(vtkPoints* points, vtkIdList* cellIds,
+    vtkPoints* closestPoints = nullptr, vtkDoubleArray* dist2 = nullptr);
+  void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds,
+    vtkDoubleArray* t = nullptr, vtkPoints* x = nullptr);
+  ///@}
+
+  /**
+   * Return true if FindCell(), FindClosestPoint() and IntersectWithLine(),
+   * in their versions taking a vtkGenericCell, may be called concurrently
+   * from several threads once the locator is built. The default is false.
+   */
+  virtual bool SupportsConcurrentQueries() { return false; }
+
   /**
    * Quickly test if a point is inside the bounds of a particular cell.
    * Some locators cache cell bounds and this function can make use
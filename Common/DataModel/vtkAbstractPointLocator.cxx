@@ -16,6 +16,11 @@
 
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
 
 //------------------------------------------------------------------------------
 vtkAbstractPointLocator::vtkAbstractPointLocator()
@@ -64,6 +69,59 @@ void vtkAbstractPointLocator::FindPointsWithinRadius(
   this->FindPointsWithinRadius(R, p, result);
 }
 
+//------------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindClosestPoints(vtkPoints* points, vtkIdList* ptIds)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  ptIds->SetNumberOfIds(numPts);
+  vtkIdType* ids = ptIds->GetPointer(0);
+
+  auto find = [&](vtkIdType ptId, vtkIdType endPtId) {
+    double x[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      points->GetPoint(ptId, x);
+      ids[ptId] = this->FindClosestPoint(x);
+    }
+  };
+
+  if (numPts > 0)
+  {
+    find(0, 1);
+    vtkSMPTools::For(1, numPts, find);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractPointLocator::FindClosestPoints(int N, vtkPoints* points, vtkIdList* ptIds)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  N = (N < 0 ? 0 : N);
+  ptIds->SetNumberOfIds(N * numPts);
+  vtkIdType* ids = ptIds->GetPointer(0);
+
+  vtkSMPThreadLocalObject<vtkIdList> tlResult;
+  auto find = [&](vtkIdType ptId, vtkIdType endPtId) {
+    vtkIdList* result = tlResult.Local();
+    double x[3];
+    for (; ptId < endPtId; ++ptId)
+    {
+      points->GetPoint(ptId, x);
+      this->FindClosestNPoints(N, x, result);
+      vtkIdType numIds = std::min(result->GetNumberOfIds(), static_cast<vtkIdType>(N));
+      vtkIdType* out = ids + ptId * N;
+      std::copy(result->GetPointer(0), result->GetPointer(0) + numIds, out);
+      std::fill(out + numIds, out + N, -1);
+    }
+  };
+
+  if (numPts > 0 && N > 0)
+  {
+    find(0, 1);
+    vtkSMPTools::For(1, numPts, find);
+  }
+}
+
 //------------------------------------------------------------------------------
 void vtkAbstractPointLocator::GetBounds(double* bnds)
 {
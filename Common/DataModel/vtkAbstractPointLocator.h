@@ -34,6 +34,7 @@
 #include "vtkLocator.h"
 
 class vtkIdList;
+class vtkPoints;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkAbstractPointLocator : public vtkLocator
 {
@@ -89,6 +90,20 @@ public:
   void FindPointsWithinRadius(double R, double x, double y, double z, vtkIdList* result);
   ///@}
 
+  ///@{
+  /**
+   * Batched versions of FindClosestPoint() and FindClosestNPoints() that
+   * search the closest point, or the closest N points, to each point of
+   * the given vtkPoints. ptIds is resized to hold one id, or N ids sorted
+   * from closest to farthest, per query point, and -1 where fewer points are
+   * found. The first query is executed by the calling thread, which builds
+   * the locator if needed, then the others are executed in parallel with
+   * vtkSMPTools.
+   */
+  void FindClosestPoints(vtkPoints* points, vtkIdList* ptIds);
+  void FindClosestPoints(int N, vtkPoints* points, vtkIdList* ptIds);
+  ///@}
+
   ///@{
   /**
    * Provide an accessor to the bounds. Valid after the locator is built.
@@ -0,0 +1,390 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCellLocatorCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellLocatorCache.h"
+
+#include "vtkAbstractCellLocator.h"
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkDataArrayRange.h"
+#include "vtkDataSet.h"
+#include "vtkIdTypeArray.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkCellLocatorCache);
+
+namespace
+{
+
+// The objects identifying the mesh of a dataset: the arrays of its points
+// and cells, or the dataset itself for the types that are not handled, and
+// the sizes that must match for the meshes to be the same.
+struct MeshKey
+{
+  std::vector<vtkIdType> Shape;
+  std::vector<vtkObject*> Objects;
+};
+
+void AddCellArray(vtkCellArray* cells, MeshKey& key)
+{
+  key.Objects.push_back(cells->GetOffsetsArray());
+  key.Objects.push_back(cells->GetConnectivityArray());
+}
+
+MeshKey GetMeshKey(vtkDataSet* dataSet)
+{
+  MeshKey key;
+  key.Shape.push_back(dataSet->GetDataObjectType());
+  key.Shape.push_back(dataSet->GetNumberOfPoints());
+  key.Shape.push_back(dataSet->GetNumberOfCells());
+
+  vtkPolyData* pd = vtkPolyData::SafeDownCast(dataSet);
+  vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+  vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(dataSet);
+  if (!pd && !ug && !sg)
+  {
+    key.Objects.push_back(dataSet);
+    return key;
+  }
+
+  vtkPoints* points = static_cast<vtkPointSet*>(dataSet)->GetPoints();
+  key.Objects.push_back(points ? points->GetData() : nullptr);
+  if (pd)
+  {
+    AddCellArray(pd->GetVerts(), key);
+    AddCellArray(pd->GetLines(), key);
+    AddCellArray(pd->GetPolys(), key);
+    AddCellArray(pd->GetStrips(), key);
+  }
+  else if (ug)
+  {
+    if (ug->GetCells())
+    {
+      AddCellArray(ug->GetCells(), key);
+    }
+    key.Objects.push_back(ug->GetCellTypesArray());
+    key.Objects.push_back(ug->GetFaces());
+    key.Objects.push_back(ug->GetFaceLocations());
+  }
+  else
+  {
+    int dims[3];
+    sg->GetDimensions(dims);
+    key.Shape.insert(key.Shape.end(), dims, dims + 3);
+    // blanking hides cells from the locators
+    key.Objects.push_back(sg->GetPointGhostArray());
+    key.Objects.push_back(sg->GetCellGhostArray());
+  }
+  return key;
+}
+
+bool SameValues(vtkDataArray* a1, vtkDataArray* a2)
+{
+  if (a1->GetDataType() != a2->GetDataType() ||
+    a1->GetNumberOfComponents() != a2->GetNumberOfComponents() ||
+    a1->GetNumberOfTuples() != a2->GetNumberOfTuples())
+  {
+    return false;
+  }
+  if (a1->HasStandardMemoryLayout() && a2->HasStandardMemoryLayout())
+  {
+    const size_t size = static_cast<size_t>(a1->GetNumberOfValues()) * a1->GetDataTypeSize();
+    return size == 0 || std::memcmp(a1->GetVoidPointer(0), a2->GetVoidPointer(0), size) == 0;
+  }
+  const auto r1 = vtk::DataArrayValueRange(a1);
+  const auto r2 = vtk::DataArrayValueRange(a2);
+  return std::equal(r1.cbegin(), r1.cend(), r2.cbegin());
+}
+
+// Copy the parameters of the prototype that affect the search structure.
+// The locator builds it itself, without lazy evaluation.
+void CopyParameters(vtkAbstractCellLocator* prototype, vtkAbstractCellLocator* locator)
+{
+  locator->SetNumberOfCellsPerNode(prototype->GetNumberOfCellsPerNode());
+  locator->SetCacheCellBounds(prototype->GetCacheCellBounds());
+  locator->SetRetainCellLists(prototype->GetRetainCellLists());
+  locator->SetMaxLevel(prototype->GetMaxLevel());
+  locator->SetAutomatic(prototype->GetAutomatic());
+  locator->SetTolerance(prototype->GetTolerance());
+
+  vtkStaticCellLocator* staticPrototype = vtkStaticCellLocator::SafeDownCast(prototype);
+  vtkStaticCellLocator* staticLocator = vtkStaticCellLocator::SafeDownCast(locator);
+  if (staticPrototype && staticLocator)
+  {
+    staticLocator->SetDivisions(staticPrototype->GetDivisions());
+    staticLocator->SetMaxNumberOfBuckets(staticPrototype->GetMaxNumberOfBuckets());
+    staticLocator->SetUseDiagonalLengthTolerance(staticPrototype->GetUseDiagonalLengthTolerance());
+  }
+}
+
+} // anonymous namespace
+
+struct vtkCellLocatorCache::vtkInternals
+{
+  struct Entry
+  {
+    std::string ClassName;
+    std::vector<vtkIdType> Shape;
+    // The objects of the mesh, kept alive, and their MTime when the locator
+    // was built: if it changes, they have been modified in place.
+    std::vector<vtkSmartPointer<vtkObject>> Objects;
+    std::vector<vtkMTimeType> MTimes;
+    // Set once built, the entry being in the cache while it is built
+    vtkSmartPointer<vtkAbstractCellLocator> Locator;
+    bool Built = false;
+
+    bool IsStale() const
+    {
+      for (size_t i = 0; i < this->Objects.size(); ++i)
+      {
+        if (this->Objects[i] && this->Objects[i]->GetMTime() != this->MTimes[i])
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool HasShape(const std::string& className, const MeshKey& key) const
+    {
+      return this->ClassName == className && this->Shape == key.Shape &&
+        this->Objects.size() == key.Objects.size();
+    }
+
+    // Same objects, the entry not being stale they have the same MTime
+    bool HasObjects(const MeshKey& key) const
+    {
+      for (size_t i = 0; i < this->Objects.size(); ++i)
+      {
+        if (key.Objects[i] != this->Objects[i])
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool HasContents(const MeshKey& key) const
+    {
+      for (size_t i = 0; i < this->Objects.size(); ++i)
+      {
+        if (key.Objects[i] == this->Objects[i])
+        {
+          continue;
+        }
+        vtkDataArray* a1 = vtkDataArray::SafeDownCast(key.Objects[i]);
+        vtkDataArray* a2 = vtkDataArray::SafeDownCast(this->Objects[i]);
+        if (!a1 || !a2 || !SameValues(a1, a2))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  // Drop the stale entries and return the one with the objects of the key,
+  // moved to the front, if any
+  std::shared_ptr<Entry> FindObjects(const std::string& className, const MeshKey& key)
+  {
+    for (auto iter = this->Entries.begin(); iter != this->Entries.end();)
+    {
+      if ((*iter)->IsStale())
+      {
+        iter = this->Entries.erase(iter);
+        continue;
+      }
+      if ((*iter)->HasShape(className, key) && (*iter)->HasObjects(key))
+      {
+        this->Entries.splice(this->Entries.begin(), this->Entries, iter);
+        return this->Entries.front();
+      }
+      ++iter;
+    }
+    return nullptr;
+  }
+
+  // Wait for the locator of an entry to be built by another call
+  vtkSmartPointer<vtkAbstractCellLocator> Wait(
+    std::unique_lock<std::mutex>& lock, const std::shared_ptr<Entry>& entry)
+  {
+    this->Condition.wait(lock, [&]() { return entry->Built; });
+    return entry->Locator;
+  }
+
+  // Most recently used first
+  std::list<std::shared_ptr<Entry>> Entries;
+  std::mutex Mutex;
+  std::condition_variable Condition;
+};
+
+//------------------------------------------------------------------------------
+vtkCellLocatorCache::vtkCellLocatorCache()
+  : MaximumNumberOfLocators(16)
+  , CompareContents(true)
+  , NumberOfBuilds(0)
+  , Internals(new vtkInternals)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkCellLocatorCache::~vtkCellLocatorCache() = default;
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkAbstractCellLocator> vtkCellLocatorCache::GetCellLocator(
+  vtkDataSet* dataSet, vtkAbstractCellLocator* prototype)
+{
+  if (!dataSet)
+  {
+    return nullptr;
+  }
+
+  const std::string className = prototype ? prototype->GetClassName() : "vtkStaticCellLocator";
+  const MeshKey key = GetMeshKey(dataSet);
+  vtkInternals& internals = *this->Internals;
+
+  // Look for the same objects first, then compare the contents of the arrays
+  // of the meshes of the same shape without holding the lock
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+  std::shared_ptr<vtkInternals::Entry> found = internals.FindObjects(className, key);
+  if (!found && this->CompareContents)
+  {
+    std::vector<std::shared_ptr<vtkInternals::Entry>> candidates;
+    for (const auto& entry : internals.Entries)
+    {
+      if (entry->HasShape(className, key))
+      {
+        candidates.push_back(entry);
+      }
+    }
+    if (!candidates.empty())
+    {
+      lock.unlock();
+      auto match = std::find_if(candidates.begin(), candidates.end(),
+        [&](const std::shared_ptr<vtkInternals::Entry>& entry) {
+          return entry->HasContents(key);
+        });
+      lock.lock();
+      auto& entries = internals.Entries;
+      auto iter = match == candidates.end() ? entries.end()
+                                            : std::find(entries.begin(), entries.end(), *match);
+      if (iter != entries.end() && !(*iter)->IsStale())
+      {
+        entries.splice(entries.begin(), entries, iter);
+        found = entries.front();
+      }
+      else
+      {
+        // another call may have added the mesh meanwhile
+        found = internals.FindObjects(className, key);
+      }
+    }
+  }
+  if (found)
+  {
+    return internals.Wait(lock, found);
+  }
+
+  // Add the entry before building its locator, so that concurrent calls for
+  // the same mesh wait for it instead of building it again
+  auto entry = std::make_shared<vtkInternals::Entry>();
+  entry->ClassName = className;
+  entry->Shape = key.Shape;
+  for (vtkObject* object : key.Objects)
+  {
+    entry->Objects.emplace_back(object);
+    entry->MTimes.push_back(object ? object->GetMTime() : 0);
+  }
+  internals.Entries.push_front(entry);
+  while (static_cast<int>(internals.Entries.size()) > this->MaximumNumberOfLocators)
+  {
+    internals.Entries.pop_back();
+  }
+  lock.unlock();
+
+  // The locator is built on a copy of the structure of the dataset, without
+  // its point and cell data, unless the dataset is the key of the mesh.
+  vtkSmartPointer<vtkDataSet> mesh = dataSet;
+  if (key.Objects.size() != 1 || key.Objects[0] != dataSet)
+  {
+    mesh = vtkSmartPointer<vtkDataSet>::Take(dataSet->NewInstance());
+    mesh->CopyStructure(dataSet);
+  }
+
+  vtkSmartPointer<vtkAbstractCellLocator> locator;
+  if (prototype)
+  {
+    locator = vtkSmartPointer<vtkAbstractCellLocator>::Take(prototype->NewInstance());
+    CopyParameters(prototype, locator);
+  }
+  else
+  {
+    locator = vtkSmartPointer<vtkStaticCellLocator>::New();
+  }
+  locator->SetDataSet(mesh);
+  locator->BuildLocator();
+  vtkDebugMacro(<< "Built a " << className << " for a mesh of " << dataSet->GetNumberOfCells()
+                << " cells");
+
+  // the reference returned keeps the locator alive if the entry is discarded
+  // by a concurrent call
+  lock.lock();
+  entry->Locator = locator;
+  entry->Built = true;
+  this->NumberOfBuilds++;
+  lock.unlock();
+  internals.Condition.notify_all();
+  return locator;
+}
+
+//------------------------------------------------------------------------------
+int vtkCellLocatorCache::GetNumberOfLocators()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  return static_cast<int>(this->Internals->Entries.size());
+}
+
+//------------------------------------------------------------------------------
+void vtkCellLocatorCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  this->Internals->Entries.clear();
+}
+
+//------------------------------------------------------------------------------
+void vtkCellLocatorCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumNumberOfLocators: " << this->MaximumNumberOfLocators << "\n";
+  os << indent << "CompareContents: " << (this->CompareContents ? "On" : "Off") << "\n";
+  os << indent << "NumberOfLocators: " << this->GetNumberOfLocators() << "\n";
+  os << indent << "NumberOfBuilds: " << this->NumberOfBuilds << "\n";
+}
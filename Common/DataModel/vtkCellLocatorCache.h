@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCellLocatorCache.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkCellLocatorCache
+ * @brief   reuse cell locators built for the same mesh
+ *
+ * vtkCellLocatorCache keeps the cell locators it builds and returns them
+ * again for any dataset with the same mesh, that is the same points and
+ * cells, whatever its point and cell data. A transient simulation with a
+ * static mesh thus builds its locator once, instead of once per time step,
+ * when the filters finding cells in it share a cache: see
+ * vtkProbeFilter::SetCellLocatorCache(), vtkCellLocatorStrategy and
+ * vtkCellLocatorInterpolatedVelocityField.
+ *
+ * The mesh of a vtkPolyData, vtkUnstructuredGrid or vtkStructuredGrid is
+ * identified by the arrays of its points and cells. Datasets sharing these
+ * arrays, unmodified, have the same mesh. When CompareContents is on, the
+ * default, the arrays are otherwise compared value by value, which costs a
+ * pass over the mesh but finds identical meshes read again from a file at
+ * each time step. The mesh of other datasets is identified by the dataset
+ * itself and its modification time.
+ *
+ * The locators are built on a copy of the structure of the datasets that
+ * shares their arrays, so that cached locators do not keep the point and
+ * cell data of the datasets alive. The least recently used locator is
+ * discarded when there are more than MaximumNumberOfLocators. A cache can
+ * be shared by filters executing concurrently. The locators are looked up
+ * under a lock, by the arrays of the meshes first, then by their values.
+ * They are built, and the values compared, without holding the lock; a call
+ * for a mesh whose locator is being built waits for it. The cached locators
+ * must only be queried, not modified.
+ *
+ * @sa
+ * vtkAbstractCellLocator vtkCellLocatorStrategy vtkProbeFilter
+ */
+
+#ifndef vtkCellLocatorCache_h
+#define vtkCellLocatorCache_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkObject.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
+
+#include <memory> // For std::unique_ptr
+
+class vtkAbstractCellLocator;
+class vtkDataSet;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkCellLocatorCache : public vtkObject
+{
+public:
+  ///@{
+  /**
+   * Standard methods for instantiation, type information and printing.
+   */
+  static vtkCellLocatorCache* New();
+  vtkTypeMacro(vtkCellLocatorCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+  ///@}
+
+  /**
+   * Return a locator built for the mesh of the dataset, of the same class as
+   * the prototype or a vtkStaticCellLocator if there is none. A cached
+   * locator is returned if there is one for the same mesh and class,
+   * otherwise a new one is built, with the parameters of the prototype, and
+   * cached. The parameters specific to a subclass are only copied for
+   * vtkStaticCellLocator. The returned reference keeps the locator alive
+   * when it is discarded from the cache. Returns nullptr if the dataset is
+   * nullptr.
+   */
+  vtkSmartPointer<vtkAbstractCellLocator> GetCellLocator(
+    vtkDataSet* dataSet, vtkAbstractCellLocator* prototype = nullptr);
+
+  ///@{
+  /**
+   * Set / get the maximum number of locators kept by the cache. The default
+   * is 16.
+   */
+  vtkSetClampMacro(MaximumNumberOfLocators, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfLocators, int);
+  ///@}
+
+  ///@{
+  /**
+   * Set / get whether the arrays of the meshes are compared value by value
+   * when they are not the same arrays. On by default.
+   */
+  vtkSetMacro(CompareContents, bool);
+  vtkGetMacro(CompareContents, bool);
+  vtkBooleanMacro(CompareContents, bool);
+  ///@}
+
+  /**
+   * Return the number of locators in the cache.
+   */
+  int GetNumberOfLocators();
+
+  /**
+   * Return the number of locators built by the cache since it was created.
+   */
+  vtkGetMacro(NumberOfBuilds, vtkIdType);
+
+  /**
+   * Discard all the cached locators.
+   */
+  void Clear();
+
+protected:
+  vtkCellLocatorCache();
+  ~vtkCellLocatorCache() override;
+
+  int MaximumNumberOfLocators;
+  bool CompareContents;
+  vtkIdType NumberOfBuilds;
+
+private:
+  vtkCellLocatorCache(const vtkCellLocatorCache&) = delete;
+  void operator=(const vtkCellLocatorCache&) = delete;
+
+  struct vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+};
+
+#endif
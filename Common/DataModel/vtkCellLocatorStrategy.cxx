@@ -16,12 +16,14 @@
 
 #include "vtkAbstractCellLocator.h"
 #include "vtkCell.h"
+#include "vtkCellLocatorCache.h"
 #include "vtkGenericCell.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointSet.h"
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCellLocatorStrategy);
+vtkCxxSetObjectMacro(vtkCellLocatorStrategy, CellLocatorCache, vtkCellLocatorCache);
 
 //------------------------------------------------------------------------------
 vtkCellLocatorStrategy::vtkCellLocatorStrategy()
@@ -32,6 +34,8 @@ vtkCellLocatorStrategy::vtkCellLocatorStrategy()
   // leaks etc.
   this->OwnsLocator = false;
   this->CellLocator = nullptr;
+  this->CellLocatorCache = nullptr;
+  this->LocatorFromCache = false;
 }
 
 //------------------------------------------------------------------------------
@@ -42,6 +46,7 @@ vtkCellLocatorStrategy::~vtkCellLocatorStrategy()
     this->CellLocator->Delete();
     this->CellLocator = nullptr;
   }
+  this->SetCellLocatorCache(nullptr);
 }
 
 //------------------------------------------------------------------------------
@@ -62,6 +67,7 @@ void vtkCellLocatorStrategy::SetCellLocator(vtkAbstractCellLocator* cL)
     }
 
     this->OwnsLocator = true;
+    this->LocatorFromCache = false;
     this->Modified();
   }
 }
@@ -86,10 +92,25 @@ int vtkCellLocatorStrategy::Initialize(vtkPointSet* ps)
   // use that. If not, then used the point set's default build cell locator
   // method.
   vtkAbstractCellLocator* psCL = ps->GetCellLocator();
-  if (psCL == nullptr)
+  if (psCL == nullptr && this->CellLocatorCache != nullptr)
+  {
+    // Reuse the locator built for the same mesh, of the class of the locator
+    // specified here if any.
+    vtkAbstractCellLocator* prototype = this->OwnsLocator ? this->CellLocator : nullptr;
+    this->SetCellLocator(this->CellLocatorCache->GetCellLocator(ps, prototype));
+    this->LocatorFromCache = true;
+  }
+  else if (psCL == nullptr)
   {
     if (this->CellLocator != nullptr && this->OwnsLocator)
     {
+      if (this->LocatorFromCache)
+      {
+        // the cached locator may be used by others, do not rebuild it
+        vtkAbstractCellLocator* locator = this->CellLocator->NewInstance();
+        this->SetCellLocator(locator);
+        locator->Delete();
+      }
       this->CellLocator->SetDataSet(ps);
       this->CellLocator->BuildLocator();
     }
@@ -133,10 +154,22 @@ vtkIdType vtkCellLocatorStrategy::FindCell(double x[3], vtkCell* cell, vtkGeneri
   return this->CellLocator->FindCell(x, tol2, gencell, pcoords, weights);
 }
 
+//------------------------------------------------------------------------------
+void vtkCellLocatorStrategy::CopyParameters(vtkFindCellStrategy* from)
+{
+  this->Superclass::CopyParameters(from);
+
+  if (vtkCellLocatorStrategy* strategy = vtkCellLocatorStrategy::SafeDownCast(from))
+  {
+    this->SetCellLocatorCache(strategy->CellLocatorCache);
+  }
+}
+
 //------------------------------------------------------------------------------
 void vtkCellLocatorStrategy::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "CellLocator: " << this->CellLocator << "\n";
+  os << indent << "CellLocatorCache: " << this->CellLocatorCache << "\n";
 }
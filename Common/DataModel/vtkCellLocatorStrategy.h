@@ -19,10 +19,14 @@
  *
  * vtkCellLocatorStrategy is implements a FindCell() strategy based on
  * using the FindCell() method in a cell locator. This is often the
- * slowest strategy, but the most robust.
+ * slowest strategy, but the most robust. When a vtkCellLocatorCache is
+ * specified, and the point set has no cell locator, the locator built for
+ * the same mesh is taken from the cache, and the specified cell locator only
+ * serves as prototype: this avoids building the locator again for each time
+ * step of a static mesh.
  *
  * @sa
- * vtkFindCellStrategy vtkPointSet
+ * vtkFindCellStrategy vtkPointSet vtkCellLocatorCache
  */
 
 #ifndef vtkCellLocatorStrategy_h
@@ -32,6 +36,7 @@
 #include "vtkFindCellStrategy.h"
 
 class vtkAbstractCellLocator;
+class vtkCellLocatorCache;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkCellLocatorStrategy : public vtkFindCellStrategy
 {
@@ -71,12 +76,29 @@ public:
   vtkGetObjectMacro(CellLocator, vtkAbstractCellLocator);
   ///@}
 
+  ///@{
+  /**
+   * Set / get the cache from which the cell locator is taken when the point
+   * set has none. By default there is no cache.
+   */
+  virtual void SetCellLocatorCache(vtkCellLocatorCache*);
+  vtkGetObjectMacro(CellLocatorCache, vtkCellLocatorCache);
+  ///@}
+
+  /**
+   * Copy essential parameters between instances of this class, including
+   * the cell locator cache. See vtkFindCellStrategy for more information.
+   */
+  void CopyParameters(vtkFindCellStrategy* from) override;
+
 protected:
   vtkCellLocatorStrategy();
   ~vtkCellLocatorStrategy() override;
 
   vtkAbstractCellLocator* CellLocator;
   bool OwnsLocator; // was the locator specified? or taken from associated point set
+  vtkCellLocatorCache* CellLocatorCache;
+  bool LocatorFromCache;
 
 private:
   vtkCellLocatorStrategy(const vtkCellLocatorStrategy&) = delete;
@@ -106,11 +106,13 @@ void vtkHyperTreeGrid::SetMask(vtkBitArray* _arg)
   }
 }
 
-// Helper macros to quickly fetch a HT at a given index or iterator
+// Helper macros to quickly fetch a HT at a given index or iterator. The map of
+// trees is only searched so that concurrent lookups are safe.
 #define GetHyperTreeFromOtherMacro(_obj_, _index_)                                                 \
-  (static_cast<vtkHyperTree*>(_obj_->HyperTrees.find(_index_) != _obj_->HyperTrees.end()           \
-      ? _obj_->HyperTrees[_index_]                                                                 \
-      : nullptr))
+  ([&]() -> vtkHyperTree* {                                                                        \
+    auto _it_ = _obj_->HyperTrees.find(_index_);                                                   \
+    return _it_ != _obj_->HyperTrees.end() ? _it_->second.GetPointer() : nullptr;                  \
+  }())
 #define GetHyperTreeFromThisMacro(_index_) GetHyperTreeFromOtherMacro(this, _index_)
 
 //------------------------------------------------------------------------------
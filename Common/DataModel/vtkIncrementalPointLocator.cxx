@@ -15,6 +15,7 @@
 
 #include "vtkIncrementalPointLocator.h"
 #include "vtkObjectFactory.h"
+#include "vtkPoints.h"
 
 vtkIncrementalPointLocator::vtkIncrementalPointLocator() = default;
 
@@ -24,3 +25,16 @@ void vtkIncrementalPointLocator::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
 }
+
+vtkIdType vtkIncrementalPointLocator::InsertUniquePoints(
+  vtkPoints* points, vtkIdType numIds, const vtkIdType* ids, vtkIdType* insertedIds)
+{
+  vtkIdType numInserted = 0;
+  double x[3];
+  for (vtkIdType i = 0; i < numIds; ++i)
+  {
+    points->GetPoint(ids ? ids[i] : i, x);
+    numInserted += this->InsertUniquePoint(x, insertedIds[i]);
+  }
+  return numInserted;
+}
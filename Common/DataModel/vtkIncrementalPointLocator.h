@@ -113,6 +113,18 @@ public:
    */
   virtual int InsertUniquePoint(const double x[3], vtkIdType& ptId) = 0;
 
+  /**
+   * Insert a batch of points as if InsertUniquePoint() were called for each
+   * of them in turn. The ids of the points of the points argument to insert
+   * are given by ids, in order, or the first numIds points are inserted when
+   * ids is nullptr. The id of the point (newly inserted or not) of each of
+   * them is returned in insertedIds, of size numIds, and the number of newly
+   * inserted points is returned. The default implementation inserts the
+   * points one at a time, subclasses may insert them in parallel.
+   */
+  virtual vtkIdType InsertUniquePoints(
+    vtkPoints* points, vtkIdType numIds, const vtkIdType* ids, vtkIdType* insertedIds);
+
   /**
    * Insert a given point with a specified point index ptId. InitPointInsertion()
    * should have been called prior to this function. Also, IsInsertedPoint()
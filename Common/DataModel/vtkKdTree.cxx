@@ -97,6 +97,25 @@ private:
   TimeLog(const TimeLog&) = delete;
   TimeLog& operator=(const TimeLog&) = delete;
 };
+
+// Collect the ids of the regions whose data bounds intersect a sphere, in the
+// same order as vtkBSPIntersections::IntersectsSphere2(). Unlike the latter,
+// this does not modify any state so concurrent searches are thread safe.
+int RegionsIntersectingSphere2(
+  vtkKdNode* node, double x, double y, double z, double rSquared, int* ids)
+{
+  if (!node->IntersectsSphere2(x, y, z, rSquared, 1))
+  {
+    return 0;
+  }
+  if (node->GetLeft() == nullptr)
+  {
+    ids[0] = node->GetID();
+    return 1;
+  }
+  int nnodes = RegionsIntersectingSphere2(node->GetLeft(), x, y, z, rSquared, ids);
+  return nnodes + RegionsIntersectingSphere2(node->GetRight(), x, y, z, rSquared, ids + nnodes);
+}
 }
 
 #define SCOPETIMER(msg)                                                                            \
@@ -2354,12 +2373,7 @@ int vtkKdTree::FindClosestPointInSphere(
   }
   int* regionIds = new int[this->NumberOfRegions];
 
-  this->BSPCalculator->ComputeIntersectionsUsingDataBoundsOn();
-
-  int nRegions = this->BSPCalculator->IntersectsSphere2(
-    regionIds, this->NumberOfRegions, x, y, z, radius * radius);
-
-  this->BSPCalculator->ComputeIntersectionsUsingDataBoundsOff();
+  int nRegions = ::RegionsIntersectingSphere2(this->Top, x, y, z, radius * radius, regionIds);
 
   double minDistance2 = 4 * this->MaxWidth * this->MaxWidth;
   int localCloseId = -1;
@@ -19,9 +19,94 @@
 #include "vtkIdList.h"
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkMergePoints);
 
+namespace
+{
+// Sort the inserted points by bucket then by coordinates, in the precision
+// of the locator points, and flag the first point of each run of coincident
+// points. The points are first grouped by bucket with a counting sort, then
+// each bucket is sorted on its own. Returns false if a coordinate is not a
+// number, since such a point never coincides with another one.
+template <typename T>
+bool vtkMergePointsSortCoincident(vtkPoints* points, vtkIdType numIds, const vtkIdType* ids,
+  const std::vector<vtkIdType>& buckets, std::vector<vtkIdType>& offsets,
+  std::vector<vtkIdType>& order, std::vector<unsigned char>& firsts)
+{
+  std::vector<T> coords(3 * numIds);
+  std::vector<unsigned char> nans(numIds);
+  vtkSMPTools::For(0, numIds, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      points->GetPoint(ids ? ids[i] : i, x);
+      for (int j = 0; j < 3; ++j)
+      {
+        coords[3 * i + j] = static_cast<T>(x[j]);
+      }
+      nans[i] = (std::isnan(x[0]) || std::isnan(x[1]) || std::isnan(x[2]));
+    }
+  });
+  if (std::find(nans.begin(), nans.end(), 1) != nans.end())
+  {
+    return false;
+  }
+
+  // group the points by bucket, keeping the order of insertion within each
+  vtkIdType numBuckets = static_cast<vtkIdType>(offsets.size()) - 1;
+  for (vtkIdType i = 0; i < numIds; ++i)
+  {
+    ++offsets[buckets[i] + 1];
+  }
+  for (vtkIdType idx = 0; idx < numBuckets; ++idx)
+  {
+    offsets[idx + 1] += offsets[idx];
+  }
+  std::vector<vtkIdType> cursors(offsets.begin(), offsets.end() - 1);
+  for (vtkIdType i = 0; i < numIds; ++i)
+  {
+    order[cursors[buckets[i]]++] = i;
+  }
+
+  // the insertion order breaks the ties, so the first point of each run is
+  // the one that InsertUniquePoint() would have inserted
+  auto less = [&](vtkIdType a, vtkIdType b) {
+    const T* pa = &coords[3 * a];
+    const T* pb = &coords[3 * b];
+    for (int j = 0; j < 3; ++j)
+    {
+      if (pa[j] != pb[j])
+      {
+        return pa[j] < pb[j];
+      }
+    }
+    return a < b;
+  };
+  vtkSMPTools::For(0, numBuckets, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkIdType first = offsets[idx];
+      vtkIdType last = offsets[idx + 1];
+      std::sort(order.begin() + first, order.begin() + last, less);
+      for (vtkIdType s = first; s < last; ++s)
+      {
+        vtkIdType a = order[s];
+        vtkIdType b = (s > first ? order[s - 1] : -1);
+        firsts[s] = (b < 0 || coords[3 * a] != coords[3 * b] ||
+          coords[3 * a + 1] != coords[3 * b + 1] || coords[3 * a + 2] != coords[3 * b + 2]);
+      }
+    }
+  });
+  return true;
+}
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 // Determine whether point given by x[3] has been inserted into points list.
 // Return id of previously inserted point if this is true, otherwise return
@@ -165,6 +250,117 @@ int vtkMergePoints::InsertUniquePoint(const double x[3], vtkIdType& id)
   return 1;
 }
 
+//------------------------------------------------------------------------------
+vtkIdType vtkMergePoints::InsertUniquePoints(
+  vtkPoints* points, vtkIdType numIds, const vtkIdType* ids, vtkIdType* insertedIds)
+{
+  // points that are already inserted, or stored in other types than float
+  // and double, are handled one at a time
+  int dataType = this->Points->GetDataType();
+  if (this->InsertionPointId > 0 || this->Points->GetNumberOfPoints() > 0 ||
+    (dataType != VTK_FLOAT && dataType != VTK_DOUBLE))
+  {
+    return this->Superclass::InsertUniquePoints(points, numIds, ids, insertedIds);
+  }
+
+  std::vector<vtkIdType> buckets(numIds);
+  vtkSMPTools::For(0, numIds, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      points->GetPoint(ids ? ids[i] : i, x);
+      buckets[i] = this->GetBucketIndex(x);
+    }
+  });
+
+  std::vector<vtkIdType> offsets(this->NumberOfBuckets + 1, 0);
+  std::vector<vtkIdType> order(numIds);
+  std::vector<unsigned char> firsts(numIds);
+  bool sorted = (dataType == VTK_FLOAT
+      ? vtkMergePointsSortCoincident<float>(points, numIds, ids, buckets, offsets, order, firsts)
+      : vtkMergePointsSortCoincident<double>(points, numIds, ids, buckets, offsets, order, firsts));
+  if (!sorted)
+  {
+    return this->Superclass::InsertUniquePoints(points, numIds, ids, insertedIds);
+  }
+
+  // map each point to the first of its run of coincident points
+  std::vector<vtkIdType> merged(numIds);
+  vtkSMPTools::For(0, numIds, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType s = begin; s < end; ++s)
+    {
+      if (firsts[s])
+      {
+        vtkIdType t = s;
+        do
+        {
+          merged[order[t]] = order[s];
+        } while (++t < numIds && !firsts[t]);
+      }
+    }
+  });
+
+  // number the new points in the order of insertion
+  vtkIdType numInserted = 0;
+  for (vtkIdType i = 0; i < numIds; ++i)
+  {
+    if (merged[i] == i)
+    {
+      insertedIds[i] = numInserted++;
+    }
+  }
+  this->Points->SetNumberOfPoints(numInserted);
+  vtkSMPTools::For(0, numIds, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (merged[i] == i)
+      {
+        points->GetPoint(ids ? ids[i] : i, x);
+        this->Points->SetPoint(insertedIds[i], x);
+      }
+      else
+      {
+        insertedIds[i] = insertedIds[merged[i]];
+      }
+    }
+  });
+  this->Points->Modified();
+
+  // fill the buckets, each one with its points in the order of insertion
+  vtkSMPTools::For(0, this->NumberOfBuckets, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<vtkIdType> bucketIds;
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      if (offsets[idx] == offsets[idx + 1])
+      {
+        continue;
+      }
+      bucketIds.clear();
+      for (vtkIdType s = offsets[idx]; s < offsets[idx + 1]; ++s)
+      {
+        if (firsts[s])
+        {
+          bucketIds.push_back(insertedIds[order[s]]);
+        }
+      }
+      std::sort(bucketIds.begin(), bucketIds.end());
+
+      vtkIdList* bucket = vtkIdList::New();
+      bucket->Allocate(std::max<vtkIdType>(this->NumberOfPointsPerBucket / 2, bucketIds.size()),
+        this->NumberOfPointsPerBucket / 3);
+      for (vtkIdType ptId : bucketIds)
+      {
+        bucket->InsertNextId(ptId);
+      }
+      this->HashTable[idx] = bucket;
+    }
+  });
+
+  this->InsertionPointId = numInserted;
+  return numInserted;
+}
+
 //------------------------------------------------------------------------------
 void vtkMergePoints::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -60,6 +60,16 @@ public:
    */
   int InsertUniquePoint(const double x[3], vtkIdType& ptId) override;
 
+  /**
+   * Insert a batch of points as if InsertUniquePoint() were called for each
+   * of them in turn. When no point has been inserted yet, the coincident
+   * points are found in parallel by sorting the points by bucket, and the
+   * points are numbered in the order of their first insertion, exactly as
+   * with InsertUniquePoint().
+   */
+  vtkIdType InsertUniquePoints(
+    vtkPoints* points, vtkIdType numIds, const vtkIdType* ids, vtkIdType* insertedIds) override;
+
 protected:
   vtkMergePoints() = default;
   ~vtkMergePoints() override = default;
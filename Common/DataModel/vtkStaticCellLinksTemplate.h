@@ -98,6 +98,14 @@ public:
   void ThreadedBuildLinks(
     const vtkIdType numPts, const vtkIdType numCells, vtkCellArray* cellArray);
 
+  /**
+   * Sort the cell ids of each point in increasing order, in parallel. The
+   * threaded build does not order them; algorithms gathering the
+   * contributions of the cells of each point in the order of a loop over the
+   * cells need this.
+   */
+  void SortLinks();
+
   ///@{
   /**
    * Get the number of cells using the point specified by ptId.
@@ -24,6 +24,7 @@
 #include "vtkPolyData.h"
 #include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
 
@@ -379,6 +380,19 @@ void vtkStaticCellLinksTemplate<TIds>::ThreadedBuildLinks(
   delete[] counts;
 }
 
+//----------------------------------------------------------------------------
+// Sort the cell ids of each point, in parallel.
+template <typename TIds>
+void vtkStaticCellLinksTemplate<TIds>::SortLinks()
+{
+  vtkSMPTools::For(0, this->NumPts, [this](vtkIdType ptId, vtkIdType endPtId) {
+    for (; ptId < endPtId; ++ptId)
+    {
+      std::sort(this->Links + this->Offsets[ptId], this->Links + this->Offsets[ptId + 1]);
+    }
+  });
+}
+
 //----------------------------------------------------------------------------
 // Build the link list array for unstructured grids
 template <typename TIds>
@@ -464,11 +478,10 @@ void vtkStaticCellLinksTemplate<TIds>::BuildLinks(vtkPolyData* pd)
   vtkIdType npts, CellId, ptId;
 
   // Visit the four arrays
-  for (CellId = 0, j = 0; j < 4; ++j)
+  for (j = 0; j < 4; ++j)
   {
     // Count number of point uses
-    cellArrays[j]->Visit(vtkSCLT_detail::CountPoints{}, this->Offsets, 0, numCells[j], CellId);
-    CellId += numCells[j];
+    cellArrays[j]->Visit(vtkSCLT_detail::CountPoints{}, this->Offsets, 0, numCells[j]);
   } // for each of the four polydata cell arrays
 
   // Perform prefix sum (inclusive scan)
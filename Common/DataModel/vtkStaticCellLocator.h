@@ -184,6 +184,11 @@ public:
     return this->Superclass::IntersectWithLine(p1, p2, points, cellIds);
   }
 
+  /**
+   * Queries are thread safe, see vtkAbstractCellLocator::FindCells().
+   */
+  bool SupportsConcurrentQueries() override { return true; }
+
   ///@{
   /**
    * Satisfy vtkLocator abstract interface.
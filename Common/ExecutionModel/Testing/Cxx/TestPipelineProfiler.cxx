@@ -0,0 +1,138 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPipelineProfiler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the passes recorded by vtkPipelineProfiler and the causes given for
+// re-executions.
+
+#include "vtkElevationFilter.h"
+#include "vtkNew.h"
+#include "vtkPipelineProfiler.h"
+#include "vtkSphereSource.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// The RequestData passes recorded since the last call, for each class.
+std::vector<vtkPipelineProfiler::Event> GetRequestData()
+{
+  std::vector<vtkPipelineProfiler::Event> events;
+  for (const vtkPipelineProfiler::Event& event : vtkPipelineProfiler::GetEvents())
+  {
+    if (event.Pass == "RequestData")
+    {
+      events.push_back(event);
+    }
+  }
+  vtkPipelineProfiler::Clear();
+  return events;
+}
+
+bool Check(const std::vector<vtkPipelineProfiler::Event>& events, const char* className,
+  const std::string& cause)
+{
+  for (const vtkPipelineProfiler::Event& event : events)
+  {
+    if (event.ClassName == className)
+    {
+      if (event.Cause.find(cause) == std::string::npos)
+      {
+        std::cerr << className << " executed because of \"" << event.Cause << "\", expected \""
+                  << cause << "\"." << std::endl;
+        return false;
+      }
+      if (event.Duration < 0.0 || event.OutputSize == 0)
+      {
+        std::cerr << "Wrong duration or output size for " << className << "." << std::endl;
+        return false;
+      }
+      return true;
+    }
+  }
+  std::cerr << className << " did not execute." << std::endl;
+  return false;
+}
+
+} // anonymous namespace
+
+int TestPipelineProfiler(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  vtkNew<vtkElevationFilter> elevation;
+  elevation->SetInputConnection(sphere->GetOutputPort());
+
+  // Nothing is recorded unless enabled.
+  elevation->Update();
+  if (vtkPipelineProfiler::GetNumberOfEvents() != 0)
+  {
+    std::cerr << "Passes recorded while the profiler is disabled." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkPipelineProfiler::SetEnabled(true);
+  sphere->SetThetaResolution(32);
+  elevation->Update();
+  std::vector<vtkPipelineProfiler::Event> events = GetRequestData();
+  if (events.size() != 2 || !Check(events, "vtkSphereSource", "vtkSphereSource") ||
+    !Check(events, "vtkElevationFilter", "input 0:0 from vtkSphereSource"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  elevation->SetLowPoint(0.0, 0.0, -1.0);
+  elevation->Update();
+  events = GetRequestData();
+  if (events.size() != 1 || !Check(events, "vtkElevationFilter", "vtkElevationFilter"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Up to date: nothing executes.
+  elevation->Update();
+  if (!GetRequestData().empty())
+  {
+    std::cerr << "Up to date pipeline executed again." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkElevationFilter> other;
+  other->SetInputConnection(sphere->GetOutputPort());
+  other->Update();
+  const std::string trace = vtkPipelineProfiler::GetChromeTrace();
+  if (trace.find("\"traceEvents\"") == std::string::npos ||
+    trace.find("\"cause\":\"first execution\"") == std::string::npos ||
+    trace.find("RequestInformation") == std::string::npos)
+  {
+    std::cerr << "Unexpected Chrome trace:" << std::endl << trace << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Instances print the state of the profiler.
+  vtkNew<vtkPipelineProfiler> profiler;
+  std::ostringstream state;
+  profiler->Print(state);
+  if (state.str().find("Enabled: 1") == std::string::npos)
+  {
+    std::cerr << "Unexpected profiler state:" << std::endl << state.str() << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkPipelineProfiler::SetEnabled(false);
+
+  return EXIT_SUCCESS;
+}
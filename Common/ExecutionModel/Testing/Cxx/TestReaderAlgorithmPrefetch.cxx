@@ -0,0 +1,260 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestReaderAlgorithmPrefetch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkReaderAlgorithm reads the time steps ahead on background
+// threads with copies of the reader, and that the outputs are those of the
+// requested time steps when playing forward, backward, scrubbing and
+// modifying the reader while it reads ahead. Also check that no progress is
+// reported from the background threads, and that StopPrefetching() stops
+// reading ahead.
+
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkDataObject.h"
+#include "vtkFieldData.h"
+#include "vtkInformation.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkReaderAlgorithm.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const int NumberOfTimeSteps = 12;
+
+// Reads of each time step by a reader and its copies
+struct ReadCounts
+{
+  std::mutex Mutex;
+  std::vector<int> Reads = std::vector<int>(NumberOfTimeSteps, 0);
+  int BackgroundReads = 0;
+};
+
+// Reads a polydata per time step, with the time step plus an offset as
+// field data, and counts the reads of each time step.
+class TestPrefetchReader : public vtkReaderAlgorithm
+{
+public:
+  static TestPrefetchReader* New();
+  vtkTypeMacro(TestPrefetchReader, vtkReaderAlgorithm);
+
+  vtkSetMacro(Offset, int);
+
+  std::shared_ptr<ReadCounts> Counts = std::make_shared<ReadCounts>();
+
+  std::vector<int> GetReads()
+  {
+    std::lock_guard<std::mutex> lock(this->Counts->Mutex);
+    return this->Counts->Reads;
+  }
+
+  int GetBackgroundReads()
+  {
+    std::lock_guard<std::mutex> lock(this->Counts->Mutex);
+    return this->Counts->BackgroundReads;
+  }
+
+  int ReadMetaData(vtkInformation* metadata) override
+  {
+    double times[NumberOfTimeSteps];
+    for (int i = 0; i < NumberOfTimeSteps; i++)
+    {
+      times[i] = 0.5 * i;
+    }
+    double range[2] = { times[0], times[NumberOfTimeSteps - 1] };
+    metadata->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times, NumberOfTimeSteps);
+    metadata->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    return 1;
+  }
+
+  int ReadMesh(int, int, int, int timestep, vtkDataObject*) override
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->Counts->Mutex);
+      this->Counts->Reads[timestep]++;
+      if (std::this_thread::get_id() != this->MainThread)
+      {
+        this->Counts->BackgroundReads++;
+      }
+    }
+    this->UpdateProgress(0.5);
+    return 1;
+  }
+
+  int ReadPoints(int, int, int, int, vtkDataObject*) override { return 1; }
+
+  int ReadArrays(int, int, int, int timestep, vtkDataObject* output) override
+  {
+    vtkNew<vtkIntArray> value;
+    value->SetName("TimeStep");
+    value->InsertNextValue(timestep + this->Offset);
+    output->GetFieldData()->AddArray(value);
+    return 1;
+  }
+
+protected:
+  TestPrefetchReader() = default;
+  ~TestPrefetchReader() override = default;
+
+  int FillOutputPortInformation(int, vtkInformation* info) override
+  {
+    info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkPolyData");
+    return 1;
+  }
+
+  vtkReaderAlgorithm* NewPrefetchReader() override
+  {
+    TestPrefetchReader* reader = TestPrefetchReader::New();
+    reader->Offset = this->Offset;
+    reader->Counts = this->Counts;
+    reader->MainThread = this->MainThread;
+    return reader;
+  }
+
+  int Offset = 0;
+
+public:
+  std::thread::id MainThread = std::this_thread::get_id();
+
+private:
+  TestPrefetchReader(const TestPrefetchReader&) = delete;
+  void operator=(const TestPrefetchReader&) = delete;
+};
+
+vtkStandardNewMacro(TestPrefetchReader);
+
+std::atomic<int> BackgroundProgressEvents(0);
+
+void CheckProgressThread(vtkObject* caller, unsigned long, void*, void*)
+{
+  if (std::this_thread::get_id() != static_cast<TestPrefetchReader*>(caller)->MainThread)
+  {
+    BackgroundProgressEvents++;
+  }
+}
+
+// Update the reader to a time step and check its output, then wait for the
+// time steps to be read ahead as if the downstream pipeline were busy.
+bool Play(TestPrefetchReader* reader, int timestep, int expected)
+{
+  reader->UpdateTimeStep(0.5 * timestep);
+  vtkDataObject* output = reader->GetOutputDataObject(0);
+  vtkIntArray* value = vtkIntArray::SafeDownCast(output->GetFieldData()->GetArray("TimeStep"));
+  if (!value || value->GetValue(0) != expected)
+  {
+    std::cerr << "Time step " << timestep << " does not have the expected output "
+              << expected << "." << std::endl;
+    return false;
+  }
+  reader->WaitForPrefetching();
+  return true;
+}
+
+} // anonymous namespace
+
+int TestReaderAlgorithmPrefetch(int, char*[])
+{
+  bool success = true;
+
+  vtkNew<TestPrefetchReader> reader;
+  vtkNew<vtkCallbackCommand> progress;
+  progress->SetCallback(CheckProgressThread);
+  reader->AddObserver(vtkCommand::ProgressEvent, progress);
+  reader->SetNumberOfPrefetchedTimeSteps(3);
+  for (int t = 0; t < NumberOfTimeSteps; t++)
+  {
+    success &= Play(reader, t, t);
+  }
+  std::vector<int> reads = reader->GetReads();
+  for (int t = 0; t < NumberOfTimeSteps; t++)
+  {
+    if (reads[t] != 1)
+    {
+      std::cerr << "Time step " << t << " was read " << reads[t] << " times." << std::endl;
+      success = false;
+    }
+  }
+  if (reader->GetBackgroundReads() == 0)
+  {
+    std::cerr << "No time step was read ahead." << std::endl;
+    success = false;
+  }
+
+  // play backward, scrub, then modify the reader while it reads ahead, which
+  // invalidates the time steps read ahead
+  for (int t = NumberOfTimeSteps - 2; t >= 6; t--)
+  {
+    success &= Play(reader, t, t);
+  }
+  success &= Play(reader, 1, 1);
+  success &= Play(reader, 9, 9);
+  success &= Play(reader, 2, 2);
+  reader->UpdateTimeStep(0.5);
+  reader->SetOffset(100);
+  success &= Play(reader, 2, 102);
+  success &= Play(reader, 1, 101);
+  success &= Play(reader, 0, 100);
+
+  // a memory limit smaller than a time step stops reading ahead once a time
+  // step is cached
+  reader->SetPrefetchMemoryLimit(1);
+  reader->SetPrefetchDirection(1);
+  for (int t = 0; t < NumberOfTimeSteps; t += 2)
+  {
+    success &= Play(reader, t, t + 100);
+  }
+
+  // no time step is read once prefetching is stopped, until the next request,
+  // and the time steps read ahead are dropped
+  reader->SetPrefetchMemoryLimit(0);
+  success &= Play(reader, 0, 100);
+  reader->StopPrefetching();
+  reads = reader->GetReads();
+  reader->WaitForPrefetching();
+  if (reader->GetReads() != reads)
+  {
+    std::cerr << "Time steps were read after StopPrefetching()." << std::endl;
+    success = false;
+  }
+  success &= Play(reader, 1, 101);
+  if (reader->GetReads()[1] != reads[1] + 1)
+  {
+    std::cerr << "Time step 1 was not read again after StopPrefetching()." << std::endl;
+    success = false;
+  }
+
+  if (BackgroundProgressEvents != 0)
+  {
+    std::cerr << "Progress was reported from a background thread." << std::endl;
+    success = false;
+  }
+
+  // the reader is deleted while it reads ahead
+  vtkNew<TestPrefetchReader> other;
+  other->SetNumberOfPrefetchedTimeSteps(10);
+  other->UpdateTimeStep(0.);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
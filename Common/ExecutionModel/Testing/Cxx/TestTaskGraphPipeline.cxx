@@ -0,0 +1,235 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTaskGraphPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkTaskGraphPipeline executes each algorithm once, after its
+// inputs, that the independent branches execute concurrently, that the
+// algorithms that are not thread safe execute alone, that the algorithms can
+// use vtkSMPTools, and that the outputs are those of the sequential pipeline.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCollection.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSMPTools.h"
+#include "vtkSphereSource.h"
+#include "vtkTaskGraphPipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+
+std::atomic<int> Running(0);
+
+// Translates its input with vtkSMPTools and records how many algorithms were
+// executing alongside it.
+class TestTaskFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static TestTaskFilter* New();
+  vtkTypeMacro(TestTaskFilter, vtkPolyDataAlgorithm);
+
+  double Shift = 0.0;
+  int Executions = 0;
+  int MaxRunning = 0;
+
+protected:
+  TestTaskFilter() = default;
+  ~TestTaskFilter() override = default;
+
+  int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override
+  {
+    int running = ++Running;
+    this->Executions++;
+    this->MaxRunning = std::max(this->MaxRunning, running);
+
+    vtkPolyData* input = vtkPolyData::GetData(inputVector[0]);
+    vtkPolyData* output = vtkPolyData::GetData(outputVector);
+    vtkNew<vtkPoints> points;
+    points->DeepCopy(input->GetPoints());
+    vtkSMPTools::For(0, points->GetNumberOfPoints(), 64, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        double x[3];
+        points->GetPoint(i, x);
+        x[0] += this->Shift;
+        points->SetPoint(i, x);
+      }
+    });
+    output->CopyStructure(input);
+    output->SetPoints(points);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    this->MaxRunning = std::max(this->MaxRunning, Running.load());
+    --Running;
+    return 1;
+  }
+
+private:
+  TestTaskFilter(const TestTaskFilter&) = delete;
+  void operator=(const TestTaskFilter&) = delete;
+};
+
+vtkStandardNewMacro(TestTaskFilter);
+
+bool SamePoints(vtkPolyData* a, vtkPolyData* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+    a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestTaskGraphPipeline(int, char*[])
+{
+  vtkNew<vtkTaskGraphPipeline> prototype;
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype);
+
+  // a sphere feeding four branches of two filters, appended together, one
+  // filter of the third branch is not thread safe
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(32);
+  vtkNew<vtkAppendPolyData> append;
+  vtkNew<TestTaskFilter> filters[4][2];
+  for (int branch = 0; branch < 4; ++branch)
+  {
+    for (int k = 0; k < 2; ++k)
+    {
+      TestTaskFilter* filter = filters[branch][k];
+      filter->Shift = branch + 0.5 * k;
+      filter->SetInputConnection(
+        k == 0 ? sphere->GetOutputPort() : filters[branch][0]->GetOutputPort());
+      if (branch != 2 || k != 1)
+      {
+        filter->GetInformation()->Set(vtkTaskGraphPipeline::THREAD_SAFE(), 1);
+      }
+    }
+    append->AddInputConnection(filters[branch][1]->GetOutputPort());
+  }
+  vtkAlgorithm::SetDefaultExecutivePrototype(nullptr);
+
+  bool success = true;
+  int numberOfThreads = 1;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 4 }, [&]() {
+    numberOfThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+    append->Update();
+  });
+  for (int branch = 0; branch < 4; ++branch)
+  {
+    for (int k = 0; k < 2; ++k)
+    {
+      if (filters[branch][k]->Executions != 1)
+      {
+        std::cerr << "Filter " << k << " of branch " << branch << " executed "
+                  << filters[branch][k]->Executions << " times." << std::endl;
+        success = false;
+      }
+    }
+  }
+  if (filters[2][1]->MaxRunning != 1)
+  {
+    std::cerr << "The filter that is not thread safe did not execute alone." << std::endl;
+    success = false;
+  }
+  // the filters sleep while executing, so with several threads the
+  // independent branches overlap
+  int maxRunning = 0;
+  for (int branch = 0; branch < 4; ++branch)
+  {
+    for (int k = 0; k < 2; ++k)
+    {
+      if (branch != 2 || k != 1)
+      {
+        maxRunning = std::max(maxRunning, filters[branch][k]->MaxRunning);
+      }
+    }
+  }
+  if (numberOfThreads > 1 && maxRunning < 2)
+  {
+    std::cerr << "The independent branches did not execute concurrently." << std::endl;
+    success = false;
+  }
+
+  // the same pipeline, executed sequentially
+  vtkNew<vtkAppendPolyData> expected;
+  for (int branch = 0; branch < 4; ++branch)
+  {
+    vtkNew<TestTaskFilter> first;
+    first->Shift = branch;
+    first->SetInputConnection(sphere->GetOutputPort());
+    vtkNew<TestTaskFilter> second;
+    second->Shift = branch + 0.5;
+    second->SetInputConnection(first->GetOutputPort());
+    expected->AddInputConnection(second->GetOutputPort());
+  }
+  expected->Update();
+  if (!SamePoints(append->GetOutput(), expected->GetOutput()))
+  {
+    std::cerr << "The output differs from the sequential pipeline." << std::endl;
+    success = false;
+  }
+
+  // update the branches together after a modification of the source, then
+  // with nothing to execute
+  sphere->SetThetaResolution(16);
+  vtkNew<vtkCollection> sinks;
+  for (int branch = 0; branch < 4; ++branch)
+  {
+    sinks->AddItem(filters[branch][1]);
+  }
+  vtkIdType numberOfPoints = 0;
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    vtkTypeBool result = 0;
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ 4 },
+      [&]() { result = vtkTaskGraphPipeline::UpdateAlgorithms(sinks); });
+    numberOfPoints = sphere->GetOutput()->GetNumberOfPoints();
+    for (int branch = 0; branch < 4; ++branch)
+    {
+      if (!result || filters[branch][0]->Executions != 2 || filters[branch][1]->Executions != 2 ||
+        filters[branch][1]->GetOutput()->GetNumberOfPoints() != numberOfPoints)
+      {
+        std::cerr << "Branch " << branch << " is not updated." << std::endl;
+        success = false;
+      }
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -33,8 +33,10 @@
 #include "vtkInformationVector.h"
 #include "vtkLogger.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineProfiler.h"
 #include "vtkPointData.h"
 
+#include <sstream>
 #include <vector>
 
 vtkStandardNewMacro(vtkDemandDrivenPipeline);
@@ -221,7 +223,14 @@ vtkTypeBool vtkDemandDrivenPipeline::ProcessRequest(
 
       // Request information from the algorithm.
       vtkLogF(TRACE, "%s execute-information", vtkLogIdentifier(this->Algorithm));
+      const bool profile = vtkPipelineProfiler::GetEnabled();
+      const double start = profile ? vtkPipelineProfiler::GetTime() : 0.0;
       result = this->ExecuteInformation(request, inInfoVec, outInfoVec);
+      if (profile)
+      {
+        vtkPipelineProfiler::RecordPass(
+          this->Algorithm, "RequestInformation", start, inInfoVec, outInfoVec);
+      }
 
       // Information is now up to date.
       this->InformationTime.Modified();
@@ -243,6 +252,11 @@ vtkTypeBool vtkDemandDrivenPipeline::ProcessRequest(
     int result = 1;
     if (this->NeedToExecuteData(outputPort, inInfoVec, outInfoVec))
     {
+      // Find out why before the inputs are updated.
+      const bool profile = vtkPipelineProfiler::GetEnabled();
+      const std::string cause =
+        profile ? this->GetExecuteDataCause(outputPort, inInfoVec, outInfoVec) : std::string();
+
       // Update inputs first.
       if (!this->ForwardUpstream(request))
       {
@@ -258,7 +272,13 @@ vtkTypeBool vtkDemandDrivenPipeline::ProcessRequest(
 
       // Request data from the algorithm.
       vtkLogF(TRACE, "%s execute-data", vtkLogIdentifier(this->Algorithm));
+      const double start = profile ? vtkPipelineProfiler::GetTime() : 0.0;
       result = this->ExecuteData(request, inInfoVec, outInfoVec);
+      if (profile)
+      {
+        vtkPipelineProfiler::RecordPass(
+          this->Algorithm, "RequestData", start, inInfoVec, outInfoVec, cause);
+      }
 
       // Data are now up to date.
       this->DataTime.Modified();
@@ -1020,6 +1040,65 @@ int vtkDemandDrivenPipeline ::NeedToExecuteData(
   return 0;
 }
 
+//------------------------------------------------------------------------------
+std::string vtkDemandDrivenPipeline::GetExecuteDataCause(
+  int outputPort, vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec)
+{
+  const vtkMTimeType dataTime = this->DataTime.GetMTime();
+  if (dataTime == 0)
+  {
+    return "first execution";
+  }
+
+  std::ostringstream cause;
+  const char* separator = "";
+  if (this->Algorithm->GetMTime() > dataTime)
+  {
+    cause << vtkLogIdentifier(this->Algorithm) << " modified";
+    separator = "; ";
+  }
+  for (int i = 0; i < this->Algorithm->GetNumberOfInputPorts(); ++i)
+  {
+    for (int j = 0; j < inInfoVec[i]->GetNumberOfInformationObjects(); ++j)
+    {
+      vtkExecutive* producer;
+      int producerPort;
+      vtkExecutive::PRODUCER()->Get(inInfoVec[i]->GetInformationObject(j), producer, producerPort);
+      vtkDemandDrivenPipeline* ddp = vtkDemandDrivenPipeline::SafeDownCast(producer);
+      if (ddp && ddp->GetPipelineMTime() > dataTime)
+      {
+        cause << separator << "input " << i << ":" << j << " from "
+              << vtkLogIdentifier(ddp->GetAlgorithm()) << " modified";
+        separator = "; ";
+      }
+    }
+  }
+  if (cause.tellp() > 0)
+  {
+    return cause.str();
+  }
+  if (this->PipelineMTime > dataTime)
+  {
+    return "pipeline modified time changed";
+  }
+
+  // The algorithm and its inputs did not change since the last execution.
+  for (int i = 0; i < this->Algorithm->GetNumberOfOutputPorts(); ++i)
+  {
+    if (outputPort >= 0 && i != outputPort)
+    {
+      continue;
+    }
+    vtkDataObject* data = outInfoVec->GetInformationObject(i)->Get(vtkDataObject::DATA_OBJECT());
+    if (!data || this->PipelineMTime > data->GetUpdateTime())
+    {
+      cause << "output " << i << " not up to date";
+      return cause.str();
+    }
+  }
+  return "request changed";
+}
+
 //------------------------------------------------------------------------------
 int vtkDemandDrivenPipeline::SetReleaseDataFlag(int port, int n)
 {
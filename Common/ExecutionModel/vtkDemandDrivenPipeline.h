@@ -27,6 +27,8 @@
 #include "vtkCommonExecutionModelModule.h" // For export macro
 #include "vtkExecutive.h"
 
+#include <string> // For std::string
+
 class vtkAbstractArray;
 class vtkDataArray;
 class vtkDataSetAttributes;
@@ -205,6 +207,11 @@ protected:
   virtual int NeedToExecuteData(
     int outputPort, vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec);
 
+  // Describe which modification time requires the output data to be
+  // generated again. Used by vtkPipelineProfiler.
+  std::string GetExecuteDataCause(
+    int outputPort, vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec);
+
   // Handle before/after operations for ExecuteData method.
   virtual void ExecuteDataStart(
     vtkInformation* request, vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec);
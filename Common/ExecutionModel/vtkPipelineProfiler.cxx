@@ -0,0 +1,223 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineProfiler.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPipelineProfiler.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkDataObject.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+struct vtkPipelineProfilerState
+{
+  std::atomic<bool> Enabled{ false };
+  std::atomic<int> LogVerbosity{ vtkLogger::VERBOSITY_TRACE };
+  std::chrono::steady_clock::time_point Origin = std::chrono::steady_clock::now();
+  std::mutex Mutex;
+  std::vector<vtkPipelineProfiler::Event> Events;
+  std::map<std::thread::id, int> ThreadIds;
+};
+
+vtkPipelineProfilerState& GetState()
+{
+  static vtkPipelineProfilerState state;
+  return state;
+}
+
+//------------------------------------------------------------------------------
+// Total size of the data objects of all the information objects, in KiB.
+unsigned long GetDataSize(vtkInformationVector* infoVec)
+{
+  unsigned long size = 0;
+  for (int i = 0; infoVec && i < infoVec->GetNumberOfInformationObjects(); ++i)
+  {
+    vtkDataObject* data = infoVec->GetInformationObject(i)->Get(vtkDataObject::DATA_OBJECT());
+    if (data)
+    {
+      size += data->GetActualMemorySize();
+    }
+  }
+  return size;
+}
+
+//------------------------------------------------------------------------------
+std::string EscapeJSON(const std::string& str)
+{
+  std::string escaped;
+  for (char c : str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+}
+
+vtkStandardNewMacro(vtkPipelineProfiler);
+
+//------------------------------------------------------------------------------
+vtkPipelineProfiler::vtkPipelineProfiler() = default;
+
+//------------------------------------------------------------------------------
+vtkPipelineProfiler::~vtkPipelineProfiler() = default;
+
+//------------------------------------------------------------------------------
+void vtkPipelineProfiler::SetEnabled(bool enabled)
+{
+  GetState().Enabled = enabled;
+}
+
+//------------------------------------------------------------------------------
+bool vtkPipelineProfiler::GetEnabled()
+{
+  return GetState().Enabled;
+}
+
+//------------------------------------------------------------------------------
+void vtkPipelineProfiler::SetLogVerbosity(vtkLogger::Verbosity verbosity)
+{
+  GetState().LogVerbosity = verbosity;
+}
+
+//------------------------------------------------------------------------------
+vtkLogger::Verbosity vtkPipelineProfiler::GetLogVerbosity()
+{
+  return static_cast<vtkLogger::Verbosity>(GetState().LogVerbosity.load());
+}
+
+//------------------------------------------------------------------------------
+void vtkPipelineProfiler::Clear()
+{
+  vtkPipelineProfilerState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Events.clear();
+}
+
+//------------------------------------------------------------------------------
+std::vector<vtkPipelineProfiler::Event> vtkPipelineProfiler::GetEvents()
+{
+  vtkPipelineProfilerState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.Events;
+}
+
+//------------------------------------------------------------------------------
+int vtkPipelineProfiler::GetNumberOfEvents()
+{
+  vtkPipelineProfilerState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return static_cast<int>(state.Events.size());
+}
+
+//------------------------------------------------------------------------------
+double vtkPipelineProfiler::GetTime()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - GetState().Origin)
+    .count();
+}
+
+//------------------------------------------------------------------------------
+void vtkPipelineProfiler::RecordPass(vtkAlgorithm* algorithm, const char* pass, double start,
+  vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec, const std::string& cause)
+{
+  Event event;
+  event.Duration = vtkPipelineProfiler::GetTime() - start;
+  event.Start = start;
+  event.ClassName = algorithm->GetClassName();
+  event.Algorithm = vtkLogger::GetIdentifier(algorithm);
+  event.Pass = pass;
+  event.NumberOfThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  event.InputSize = 0;
+  for (int port = 0; inInfoVec && port < algorithm->GetNumberOfInputPorts(); ++port)
+  {
+    event.InputSize += GetDataSize(inInfoVec[port]);
+  }
+  event.OutputSize = GetDataSize(outInfoVec);
+  event.Cause = cause;
+
+  vtkVLogF(vtkPipelineProfiler::GetLogVerbosity(),
+    "%s %s: %.3f ms, %d threads, input %lu KiB, output %lu KiB%s%s", event.Algorithm.c_str(),
+    pass, event.Duration * 1000.0, event.NumberOfThreads, event.InputSize, event.OutputSize,
+    cause.empty() ? "" : ", cause: ", cause.c_str());
+
+  vtkPipelineProfilerState& state = GetState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  auto threadId = state.ThreadIds.emplace(
+    std::this_thread::get_id(), static_cast<int>(state.ThreadIds.size()));
+  event.ThreadId = threadId.first->second;
+  state.Events.push_back(std::move(event));
+}
+
+//------------------------------------------------------------------------------
+std::string vtkPipelineProfiler::GetChromeTrace()
+{
+  std::ostringstream os;
+  os << "{\"traceEvents\":[";
+  const std::vector<Event> events = vtkPipelineProfiler::GetEvents();
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    const Event& event = events[i];
+    // Times are in microseconds.
+    os << (i == 0 ? "\n" : ",\n") << "{\"name\":\"" << EscapeJSON(event.ClassName)
+       << "\",\"cat\":\"" << event.Pass << "\",\"ph\":\"X\",\"ts\":" << event.Start * 1e6
+       << ",\"dur\":" << event.Duration * 1e6 << ",\"pid\":0,\"tid\":" << event.ThreadId
+       << ",\"args\":{\"algorithm\":\"" << EscapeJSON(event.Algorithm)
+       << "\",\"threads\":" << event.NumberOfThreads << ",\"input_kib\":" << event.InputSize
+       << ",\"output_kib\":" << event.OutputSize;
+    if (!event.Cause.empty())
+    {
+      os << ",\"cause\":\"" << EscapeJSON(event.Cause) << "\"";
+    }
+    os << "}}";
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return os.str();
+}
+
+//------------------------------------------------------------------------------
+bool vtkPipelineProfiler::WriteChromeTrace(const std::string& fileName)
+{
+  std::ofstream file(fileName);
+  if (!file)
+  {
+    vtkLogF(ERROR, "Cannot open '%s' for writing.", fileName.c_str());
+    return false;
+  }
+  file << vtkPipelineProfiler::GetChromeTrace();
+  return static_cast<bool>(file);
+}
+
+//------------------------------------------------------------------------------
+void vtkPipelineProfiler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << vtkPipelineProfiler::GetEnabled() << endl;
+  os << indent << "LogVerbosity: " << vtkPipelineProfiler::GetLogVerbosity() << endl;
+  os << indent << "NumberOfEvents: " << vtkPipelineProfiler::GetNumberOfEvents() << endl;
+}
@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineProfiler.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkPipelineProfiler
+ * @brief   records the passes executed by all the algorithms of the pipeline
+ *
+ * vtkPipelineProfiler is a global, opt-in profiler of pipeline execution.
+ * Once enabled with `vtkPipelineProfiler::SetEnabled(true)`, the
+ * demand-driven executives record every RequestInformation,
+ * RequestUpdateExtent and RequestData pass they run on their algorithm:
+ * its duration, the number of threads vtkSMPTools would use, the sizes of the
+ * input and output data objects (see vtkDataObject::GetActualMemorySize) and,
+ * for RequestData, the reason the algorithm had to execute again: which
+ * modification time (the algorithm's or one of its inputs') changed since the
+ * previous execution.
+ *
+ * Each recorded pass is also logged through vtkLogger at the verbosity given
+ * by SetLogVerbosity(). The whole timeline can be exported in the Chrome
+ * trace event format (open it in chrome://tracing or https://ui.perfetto.dev)
+ * with GetChromeTrace() or WriteChromeTrace().
+ *
+ * Profiling is off by default. When it is off, the executives only check a
+ * flag.
+ *
+ * @sa
+ * vtkDemandDrivenPipeline vtkStreamingDemandDrivenPipeline vtkLogger
+ */
+
+#ifndef vtkPipelineProfiler_h
+#define vtkPipelineProfiler_h
+
+#include "vtkCommonExecutionModelModule.h" // For export macro
+#include "vtkLogger.h"                     // For vtkLogger::Verbosity
+#include "vtkObject.h"
+
+#include <string> // For std::string
+#include <vector> // For std::vector
+
+class vtkAlgorithm;
+class vtkInformationVector;
+
+class VTKCOMMONEXECUTIONMODEL_EXPORT vtkPipelineProfiler : public vtkObject
+{
+public:
+  /**
+   * All the methods are static. Instances only make the profiler available
+   * where objects are needed, for instance to print its state.
+   */
+  static vtkPipelineProfiler* New();
+  vtkTypeMacro(vtkPipelineProfiler, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///@{
+  /**
+   * Enable or disable the recording of the pipeline passes. Off by default.
+   */
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled();
+  ///@}
+
+  ///@{
+  /**
+   * Verbosity at which the recorded passes are logged with vtkLogger.
+   * Default is vtkLogger::VERBOSITY_TRACE.
+   */
+  static void SetLogVerbosity(vtkLogger::Verbosity verbosity);
+  static vtkLogger::Verbosity GetLogVerbosity();
+  ///@}
+
+  /**
+   * Forget all the recorded passes.
+   */
+  static void Clear();
+
+#ifndef __VTK_WRAP__
+  /**
+   * A pass run by an executive on its algorithm.
+   */
+  struct Event
+  {
+    // Class name of the algorithm and its identifier (see vtkLogIdentifier).
+    std::string ClassName;
+    std::string Algorithm;
+    // RequestInformation, RequestUpdateExtent or RequestData.
+    std::string Pass;
+    // Start time and duration, in seconds, on the clock of GetTime().
+    double Start;
+    double Duration;
+    int NumberOfThreads;
+    int ThreadId;
+    // Sizes of all the input and output data objects, in kibibytes.
+    unsigned long InputSize;
+    unsigned long OutputSize;
+    // Why RequestData had to execute the algorithm again, empty for other
+    // passes.
+    std::string Cause;
+  };
+
+  /**
+   * Get the recorded passes, in the order they ended.
+   */
+  static std::vector<Event> GetEvents();
+#endif // __VTK_WRAP__
+
+  /**
+   * Get the number of recorded passes.
+   */
+  static int GetNumberOfEvents();
+
+  /**
+   * Get the recorded passes in the Chrome trace event JSON format.
+   */
+  static std::string GetChromeTrace();
+
+  /**
+   * Write the recorded passes in the Chrome trace event JSON format.
+   * Returns false if the file could not be written.
+   */
+  static bool WriteChromeTrace(const std::string& fileName);
+
+  /**
+   * Current time on the profiler clock, in seconds since the profiler was
+   * first used. Used by the executives.
+   */
+  static double GetTime();
+
+  /**
+   * Record a pass that started at time `start`, as returned by GetTime().
+   * Used by the executives.
+   */
+  VTK_WRAPEXCLUDE
+  static void RecordPass(vtkAlgorithm* algorithm, const char* pass, double start,
+    vtkInformationVector** inInfoVec, vtkInformationVector* outInfoVec,
+    const std::string& cause = std::string());
+
+protected:
+  vtkPipelineProfiler();
+  ~vtkPipelineProfiler() override;
+
+private:
+  vtkPipelineProfiler(const vtkPipelineProfiler&) = delete;
+  void operator=(const vtkPipelineProfiler&) = delete;
+};
+
+#endif
@@ -17,19 +17,109 @@
 #include "vtkDataObject.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// State of the time steps read ahead on the background threads, protected
+// by Mutex.
+class vtkReaderAlgorithm::vtkInternals
+{
+public:
+  struct PendingStep
+  {
+    int TimeStep;
+    vtkSmartPointer<vtkDataObject> Data;
+  };
+
+  struct CachedStep
+  {
+    vtkSmartPointer<vtkDataObject> Data;
+    unsigned long Size;
+  };
+
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::vector<std::thread> Threads;
+  bool Stop = false;
+
+  // the request that the cached time steps were read for, any change
+  // invalidates them
+  int Piece = -1;
+  int NumberOfPieces = -1;
+  int GhostLevels = -1;
+  vtkMTimeType MTime = 0;
+  unsigned int Generation = 0;
+
+  // copies of the reader taken for the current generation, one per thread
+  std::vector<vtkSmartPointer<vtkReaderAlgorithm>> Readers;
+
+  int LastTimeStep = -1;
+  int Direction = 1;
+  unsigned long MemoryLimit = 0;
+  std::vector<int> Window;
+  std::deque<PendingStep> Pending;
+  std::vector<int> ReadingTimeSteps;
+  std::map<int, CachedStep> Cache;
+  unsigned long CacheSize = 0;
+
+  bool InWindow(int timestep) const
+  {
+    return std::find(this->Window.begin(), this->Window.end(), timestep) != this->Window.end();
+  }
+
+  bool IsReading(int timestep) const
+  {
+    return std::find(this->ReadingTimeSteps.begin(), this->ReadingTimeSteps.end(), timestep) !=
+      this->ReadingTimeSteps.end();
+  }
+
+  bool IsFull() const { return this->MemoryLimit > 0 && this->CacheSize >= this->MemoryLimit; }
+
+  void Invalidate()
+  {
+    this->Generation++;
+    this->Readers.clear();
+    this->Window.clear();
+    this->Pending.clear();
+    this->Cache.clear();
+    this->CacheSize = 0;
+    this->LastTimeStep = -1;
+  }
+};
+
 //------------------------------------------------------------------------------
 vtkReaderAlgorithm::vtkReaderAlgorithm()
 {
+  this->Internals = new vtkInternals;
+
   // by default assume filters have one input and one output
   // subclasses that deviate should modify this setting
   this->SetNumberOfOutputPorts(1);
+
+  this->NumberOfPrefetchedTimeSteps = 0;
+  this->PrefetchDirection = 0;
+  this->NumberOfPrefetchThreads = 0;
+  this->PrefetchMemoryLimit = 0;
 }
 
 //------------------------------------------------------------------------------
-vtkReaderAlgorithm::~vtkReaderAlgorithm() = default;
+vtkReaderAlgorithm::~vtkReaderAlgorithm()
+{
+  this->StopPrefetching();
+  delete this->Internals;
+  this->Internals = nullptr;
+}
 
 //------------------------------------------------------------------------------
 vtkTypeBool vtkReaderAlgorithm::ProcessRequest(
@@ -103,35 +193,260 @@ vtkTypeBool vtkReaderAlgorithm::ProcessRequest(
     int nghosts = reqs->Get(vtkSDDP::UPDATE_NUMBER_OF_GHOST_LEVELS());
     vtkDataObject* output = vtkDataObject::GetData(outInfo);
 
-    try
+    if (!this->ReadPrefetchedData(piece, npieces, nghosts, timeIndex, output))
     {
-      result = this->ReadMesh(piece, npieces, nghosts, timeIndex, output);
-      if (result)
-      {
-        result = this->ReadPoints(piece, npieces, nghosts, timeIndex, output);
-      }
-      if (result)
+      result = this->ReadData(piece, npieces, nghosts, timeIndex, output);
+    }
+    if (result && output != nullptr)
+    {
+      int numberOfTimeSteps = (hasTime && steps) ? reqs->Length(vtkSDDP::TIME_STEPS()) : 0;
+      this->PrefetchTimeSteps(timeIndex, numberOfTimeSteps, output);
+    }
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+int vtkReaderAlgorithm::ReadData(
+  int piece, int npieces, int nghosts, int timestep, vtkDataObject* output)
+{
+  int result;
+  try
+  {
+    result = this->ReadMesh(piece, npieces, nghosts, timestep, output);
+    if (result)
+    {
+      result = this->ReadPoints(piece, npieces, nghosts, timestep, output);
+    }
+    if (result)
+    {
+      result = this->ReadArrays(piece, npieces, nghosts, timestep, output);
+    }
+  }
+  catch (const std::exception&)
+  {
+    result = 0;
+  }
+
+  if (!result && output != nullptr)
+  {
+    // cleanup output so we don't end up producing partial results.
+    output->Initialize();
+  }
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+bool vtkReaderAlgorithm::ReadPrefetchedData(
+  int piece, int npieces, int nghosts, int timestep, vtkDataObject* output)
+{
+  vtkInternals& internals = *this->Internals;
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+  if (piece != internals.Piece || npieces != internals.NumberOfPieces ||
+    nghosts != internals.GhostLevels || this->GetMTime() != internals.MTime)
+  {
+    internals.Invalidate();
+    internals.Piece = piece;
+    internals.NumberOfPieces = npieces;
+    internals.GhostLevels = nghosts;
+    internals.MTime = this->GetMTime();
+    return false;
+  }
+
+  // wait for the time step if it is being read, rather than reading it again
+  internals.Condition.wait(lock, [&]() { return !internals.IsReading(timestep); });
+  auto cached = internals.Cache.find(timestep);
+  if (cached == internals.Cache.end() || output == nullptr ||
+    !cached->second.Data->IsA(output->GetClassName()))
+  {
+    // the time step is read by the caller, do not read it ahead as well
+    for (auto iter = internals.Pending.begin(); iter != internals.Pending.end(); ++iter)
+    {
+      if (iter->TimeStep == timestep)
       {
-        result = this->ReadArrays(piece, npieces, nghosts, timeIndex, output);
+        internals.Pending.erase(iter);
+        break;
       }
     }
-    catch (const std::exception&)
+    return false;
+  }
+  output->ShallowCopy(cached->second.Data);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void vtkReaderAlgorithm::PrefetchTimeSteps(
+  int timestep, int numberOfTimeSteps, vtkDataObject* output)
+{
+  vtkInternals& internals = *this->Internals;
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+
+  if (this->PrefetchDirection != 0)
+  {
+    internals.Direction = this->PrefetchDirection;
+  }
+  else if (internals.LastTimeStep >= 0 && timestep != internals.LastTimeStep)
+  {
+    internals.Direction = (timestep > internals.LastTimeStep ? 1 : -1);
+  }
+  internals.LastTimeStep = timestep;
+
+  internals.Window.clear();
+  for (int i = 1; i <= this->NumberOfPrefetchedTimeSteps; i++)
+  {
+    int next = timestep + i * internals.Direction;
+    if (next < 0 || next >= numberOfTimeSteps)
     {
-      result = 0;
+      break;
     }
+    internals.Window.push_back(next);
+  }
 
-    if (!result && output != nullptr)
+  // release the time steps that are not ahead anymore, and cancel the reads
+  // that have not started yet
+  for (auto iter = internals.Cache.begin(); iter != internals.Cache.end();)
+  {
+    if (internals.InWindow(iter->first))
     {
-      // cleanup output so we don't end up producing partial results.
-      output->Initialize();
+      ++iter;
+    }
+    else
+    {
+      internals.CacheSize -= iter->second.Size;
+      iter = internals.Cache.erase(iter);
+    }
+  }
+  internals.Pending.clear();
+  if (internals.Window.empty())
+  {
+    return;
+  }
+  for (int next : internals.Window)
+  {
+    if (internals.Cache.find(next) == internals.Cache.end() && !internals.IsReading(next))
+    {
+      vtkSmartPointer<vtkDataObject> data;
+      data.TakeReference(output->NewInstance());
+      internals.Pending.push_back({ next, data });
     }
   }
+  internals.MemoryLimit = this->PrefetchMemoryLimit;
 
-  return result;
+  // Copy the reader for the threads that do not have a copy of its current
+  // state yet, so that the reader can be modified while they read
+  size_t numberOfThreads = static_cast<size_t>(this->NumberOfPrefetchThreads);
+  if (numberOfThreads == 0)
+  {
+    numberOfThreads = std::min(internals.Window.size(),
+      std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1)));
+  }
+  numberOfThreads = std::max(numberOfThreads, internals.Threads.size());
+  while (internals.Readers.size() < numberOfThreads)
+  {
+    vtkSmartPointer<vtkReaderAlgorithm> reader;
+    reader.TakeReference(this->NewPrefetchReader());
+    if (!reader)
+    {
+      internals.Pending.clear();
+      return;
+    }
+    internals.Readers.push_back(reader);
+  }
+
+  internals.Stop = false;
+  while (internals.Threads.size() < numberOfThreads)
+  {
+    internals.ReadingTimeSteps.push_back(-1);
+    internals.Threads.emplace_back(
+      &vtkReaderAlgorithm::PrefetchLoop, this, static_cast<int>(internals.Threads.size()));
+  }
+  internals.Condition.notify_all();
+}
+
+//------------------------------------------------------------------------------
+void vtkReaderAlgorithm::PrefetchLoop(int threadIndex)
+{
+  vtkInternals& internals = *this->Internals;
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+  while (!internals.Stop)
+  {
+    if (internals.Pending.empty() || internals.IsFull() ||
+      static_cast<size_t>(threadIndex) >= internals.Readers.size())
+    {
+      internals.Condition.wait(lock);
+      continue;
+    }
+
+    vtkInternals::PendingStep step = internals.Pending.front();
+    internals.Pending.pop_front();
+    internals.ReadingTimeSteps[threadIndex] = step.TimeStep;
+    vtkSmartPointer<vtkReaderAlgorithm> reader = internals.Readers[threadIndex];
+    unsigned int generation = internals.Generation;
+    int piece = internals.Piece;
+    int npieces = internals.NumberOfPieces;
+    int nghosts = internals.GhostLevels;
+    lock.unlock();
+
+    int result = reader->ReadData(piece, npieces, nghosts, step.TimeStep, step.Data);
+    reader = nullptr;
+
+    lock.lock();
+    internals.ReadingTimeSteps[threadIndex] = -1;
+    // the time step is dropped if the request or the reader changed, or if
+    // it is not ahead anymore, while it was being read
+    if (result && generation == internals.Generation && internals.InWindow(step.TimeStep))
+    {
+      unsigned long size = step.Data->GetActualMemorySize();
+      internals.Cache[step.TimeStep] = { step.Data, size };
+      internals.CacheSize += size;
+    }
+    internals.Condition.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkReaderAlgorithm::WaitForPrefetching()
+{
+  vtkInternals& internals = *this->Internals;
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+  internals.Condition.wait(lock, [&]() {
+    return internals.Threads.empty() ||
+      (std::count(internals.ReadingTimeSteps.begin(), internals.ReadingTimeSteps.end(), -1) ==
+          static_cast<std::ptrdiff_t>(internals.ReadingTimeSteps.size()) &&
+        (internals.Pending.empty() || internals.IsFull()));
+  });
+}
+
+//------------------------------------------------------------------------------
+void vtkReaderAlgorithm::StopPrefetching()
+{
+  vtkInternals& internals = *this->Internals;
+  if (internals.Threads.empty())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(internals.Mutex);
+    internals.Stop = true;
+    internals.Invalidate();
+  }
+  internals.Condition.notify_all();
+  for (std::thread& thread : internals.Threads)
+  {
+    thread.join();
+  }
+  internals.Threads.clear();
+  internals.ReadingTimeSteps.clear();
 }
 
 //------------------------------------------------------------------------------
 void vtkReaderAlgorithm::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfPrefetchedTimeSteps: " << this->NumberOfPrefetchedTimeSteps << endl;
+  os << indent << "PrefetchDirection: " << this->PrefetchDirection << endl;
+  os << indent << "NumberOfPrefetchThreads: " << this->NumberOfPrefetchThreads << endl;
+  os << indent << "PrefetchMemoryLimit: " << this->PrefetchMemoryLimit << endl;
 }
@@ -26,6 +26,13 @@
  * partitions), caching, mapping time requests to indices etc.
  * This class implements the most basic API which is specialized as
  * needed by subclasses (for file series for example).
+ *
+ * During the playback of a time series, the next time steps can be read
+ * ahead on background threads while the pipeline downstream processes the
+ * current one, see SetNumberOfPrefetchedTimeSteps(). The time steps read
+ * ahead are read by copies of the reader, see NewPrefetchReader(), so that
+ * the reader itself is only used by the calling thread and may be modified
+ * at any time. Their reads report no progress.
  */
 
 #ifndef vtkReaderAlgorithm_h
@@ -102,13 +109,92 @@ public:
   virtual int ReadArrays(
     int piece, int npieces, int nghosts, int timestep, vtkDataObject* output) = 0;
 
+  /**
+   * Cancel the time steps waiting to be read ahead and wait for those being
+   * read, if any. The cached time steps are dropped. Reading ahead resumes
+   * on the next request.
+   */
+  void StopPrefetching();
+
+  /**
+   * Wait until the time steps to read ahead have been read, or until the
+   * memory limit stops reading ahead.
+   */
+  void WaitForPrefetching();
+
+  ///@{
+  /**
+   * Set the number of time steps that are read ahead, in the direction of
+   * playback, after each requested time step. They are read on a background
+   * thread into a cache and the output is shallow copied from the cache when
+   * they are requested. Requesting a time step outside of the steps being
+   * prefetched, when scrubbing for example, cancels the pending reads. The
+   * default is 0, time steps are only read when they are requested.
+   */
+  vtkSetClampMacro(NumberOfPrefetchedTimeSteps, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPrefetchedTimeSteps, int);
+  ///@}
+
+  ///@{
+  /**
+   * Set the direction of playback in which time steps are prefetched, 1 for
+   * increasing and -1 for decreasing time steps. The default is 0, the
+   * direction follows the last two requested time steps.
+   */
+  vtkSetClampMacro(PrefetchDirection, int, -1, 1);
+  vtkGetMacro(PrefetchDirection, int);
+  ///@}
+
+  ///@{
+  /**
+   * Set the number of background threads reading time steps ahead, each one
+   * with its own copy of the reader. The default is 0, one thread per time
+   * step read ahead up to the number of hardware threads.
+   */
+  vtkSetClampMacro(NumberOfPrefetchThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPrefetchThreads, int);
+  ///@}
+
+  ///@{
+  /**
+   * Set the memory, in kibibytes, that the prefetched time steps may use.
+   * No more time steps are read ahead once the cache reaches this size.
+   * The default is 0, no limit.
+   */
+  vtkSetMacro(PrefetchMemoryLimit, unsigned long);
+  vtkGetMacro(PrefetchMemoryLimit, unsigned long);
+  ///@}
+
 protected:
   vtkReaderAlgorithm();
   ~vtkReaderAlgorithm() override;
 
+  /**
+   * Create a new reader in the same state as this one, ready for ReadMesh(),
+   * ReadPoints() and ReadArrays() to be called. Time steps are read ahead by
+   * such copies, taken when the time steps to read ahead change, and each
+   * copy is only used by one background thread at a time. Copies of distinct
+   * readers may read concurrently. The default returns nullptr, the time
+   * steps are then not read ahead.
+   */
+  virtual vtkReaderAlgorithm* NewPrefetchReader() { return nullptr; }
+
+  int NumberOfPrefetchedTimeSteps;
+  int PrefetchDirection;
+  int NumberOfPrefetchThreads;
+  unsigned long PrefetchMemoryLimit;
+
 private:
   vtkReaderAlgorithm(const vtkReaderAlgorithm&) = delete;
   void operator=(const vtkReaderAlgorithm&) = delete;
+
+  int ReadData(int piece, int npieces, int nghosts, int timestep, vtkDataObject* output);
+  bool ReadPrefetchedData(int piece, int npieces, int nghosts, int timestep, vtkDataObject* output);
+  void PrefetchTimeSteps(int timestep, int numberOfTimeSteps, vtkDataObject* output);
+  void PrefetchLoop(int threadIndex);
+
+  class vtkInternals;
+  vtkInternals* Internals;
 };
 
 #endif
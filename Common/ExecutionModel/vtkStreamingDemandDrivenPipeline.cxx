@@ -37,6 +37,7 @@
 #include "vtkLogger.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineProfiler.h"
 #include "vtkSmartPointer.h"
 
 vtkStandardNewMacro(vtkStreamingDemandDrivenPipeline);
@@ -316,7 +317,14 @@ vtkTypeBool vtkStreamingDemandDrivenPipeline ::ProcessRequest(
         // Invoke the request on the algorithm.
         this->LastPropogateUpdateExtentShortCircuited = 0;
         vtkLogF(TRACE, "%s execute-update-extent", vtkLogIdentifier(this->Algorithm));
+        const bool profile = vtkPipelineProfiler::GetEnabled();
+        const double start = profile ? vtkPipelineProfiler::GetTime() : 0.0;
         result = this->CallAlgorithm(request, vtkExecutive::RequestUpstream, inInfoVec, outInfoVec);
+        if (profile)
+        {
+          vtkPipelineProfiler::RecordPass(
+            this->Algorithm, "RequestUpdateExtent", start, inInfoVec, outInfoVec);
+        }
 
         // Propagate the update extent to all inputs.
         if (result)
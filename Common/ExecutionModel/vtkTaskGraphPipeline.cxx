@@ -0,0 +1,444 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTaskGraphPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTaskGraphPipeline.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkCollection.h"
+#include "vtkCollectionRange.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkInformation.h"
+#include "vtkInformationExecutivePortKey.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+vtkStandardNewMacro(vtkTaskGraphPipeline);
+
+vtkInformationKeyMacro(vtkTaskGraphPipeline, THREAD_SAFE, Integer);
+
+//------------------------------------------------------------------------------
+// The algorithms that need to execute, and the order in which they can.
+// Each task is added to the ready list once all its producers are done, and
+// the workers, the calling thread and dedicated threads, claim the ready tasks
+// that the gate lets execute. A thread safe task holds the gate shared with
+// the other thread safe tasks, the other tasks hold it exclusively. The
+// workers are not vtkSMPTools tasks and wait on a condition variable, so
+// that the algorithms can use vtkSMPTools themselves.
+class vtkTaskGraphPipeline::vtkTaskGraph
+{
+public:
+  struct Task
+  {
+    vtkTaskGraphPipeline* Executive;
+    std::vector<int> Ports;
+    std::vector<int> Consumers;
+    int NumberOfProducers;
+    bool ThreadSafe;
+  };
+
+  std::vector<Task> Tasks;
+  std::map<vtkTaskGraphPipeline*, int> TaskIds;
+
+  // Add the task updating the output port of the executive, and the tasks
+  // of its producers. Returns false if the pipeline cannot be executed as a
+  // graph of tasks.
+  bool AddTask(vtkTaskGraphPipeline* executive, int port, int consumer);
+
+  // Whether some tasks can execute concurrently, otherwise the pipeline is
+  // better updated by the calling thread.
+  bool IsConcurrent() const
+  {
+    return std::count_if(this->Tasks.begin(), this->Tasks.end(),
+             [](const Task& task) { return task.ThreadSafe; }) > 1;
+  }
+
+  int Execute();
+
+private:
+  // Execute the ready tasks until all the tasks are done.
+  void Work();
+  // Remove from the ready list the first task that can execute and take the
+  // gate for it, or return -1. Called with the mutex locked.
+  int Claim();
+  // Release the gate of the task and add its consumers whose producers are
+  // all done to the ready list. Called with the mutex locked.
+  void Finish(int taskId, bool failed);
+
+  // the members below are guarded by the mutex
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::vector<int> ReadyTasks;
+  std::vector<int> Remaining;
+  std::vector<char> Failed;
+  int NumberOfPendingTasks = 0;
+  // number of thread safe tasks executing, or -1 for a task executing alone
+  int Gate = 0;
+};
+
+//------------------------------------------------------------------------------
+bool vtkTaskGraphPipeline::vtkTaskGraph::AddTask(
+  vtkTaskGraphPipeline* executive, int port, int consumer)
+{
+  auto found = this->TaskIds.find(executive);
+  if (found != this->TaskIds.end())
+  {
+    Task& task = this->Tasks[found->second];
+    if (std::find(task.Ports.begin(), task.Ports.end(), port) == task.Ports.end())
+    {
+      task.Ports.push_back(port);
+    }
+    if (consumer >= 0)
+    {
+      task.Consumers.push_back(consumer);
+      this->Tasks[consumer].NumberOfProducers++;
+    }
+    return true;
+  }
+
+  if (executive->SharedInputInformation)
+  {
+    return false;
+  }
+
+  // like the REQUEST_DATA pass, the producers of an algorithm that is up to
+  // date are not visited
+  if (!executive->NeedToExecuteData(
+        port, executive->GetInputInformation(), executive->GetOutputInformation()))
+  {
+    return true;
+  }
+
+  vtkAlgorithm* algorithm = executive->GetAlgorithm();
+  vtkInformation* algorithmInfo = algorithm->GetInformation();
+  int taskId = static_cast<int>(this->Tasks.size());
+  this->Tasks.push_back(Task{ executive, { port }, {}, 0,
+    algorithmInfo->Has(THREAD_SAFE()) && algorithmInfo->Get(THREAD_SAFE()) != 0 });
+  this->TaskIds[executive] = taskId;
+  if (consumer >= 0)
+  {
+    this->Tasks[taskId].Consumers.push_back(consumer);
+    this->Tasks[consumer].NumberOfProducers++;
+  }
+
+  for (int i = 0; i < algorithm->GetNumberOfInputPorts(); ++i)
+  {
+    for (int j = 0; j < algorithm->GetNumberOfInputConnections(i); ++j)
+    {
+      vtkInformation* inInfo = executive->GetInputInformation(i, j);
+      vtkExecutive* producer;
+      int producerPort;
+      vtkExecutive::PRODUCER()->Get(inInfo, producer, producerPort);
+      if (!producer)
+      {
+        continue;
+      }
+
+      // composite inputs are iterated over by swapping the data object in
+      // the information of the producer
+      if (vtkCompositeDataSet::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT())))
+      {
+        this->Tasks[taskId].ThreadSafe = false;
+      }
+
+      vtkTaskGraphPipeline* producerExecutive = vtkTaskGraphPipeline::SafeDownCast(producer);
+      if (!producerExecutive || !this->AddTask(producerExecutive, producerPort, taskId))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int vtkTaskGraphPipeline::vtkTaskGraph::Execute()
+{
+  int numberOfTasks = static_cast<int>(this->Tasks.size());
+  this->ReadyTasks.clear();
+  this->Remaining.resize(numberOfTasks);
+  this->Failed.assign(numberOfTasks, 0);
+  this->NumberOfPendingTasks = numberOfTasks;
+  this->Gate = 0;
+  for (int taskId = 0; taskId < numberOfTasks; ++taskId)
+  {
+    this->Remaining[taskId] = this->Tasks[taskId].NumberOfProducers;
+    if (this->Tasks[taskId].NumberOfProducers == 0)
+    {
+      this->ReadyTasks.push_back(taskId);
+    }
+  }
+
+  // the calling thread is one of the workers
+  int numberOfWorkers = std::min(numberOfTasks, vtkSMPTools::GetEstimatedNumberOfThreads());
+  std::vector<std::thread> threads;
+  for (int worker = 1; worker < numberOfWorkers; ++worker)
+  {
+    threads.emplace_back(&vtkTaskGraph::Work, this);
+  }
+  this->Work();
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  // the failures of the other tasks are passed on to the sinks
+  for (int taskId = 0; taskId < numberOfTasks; ++taskId)
+  {
+    if (this->Failed[taskId] && this->Tasks[taskId].Consumers.empty())
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+void vtkTaskGraphPipeline::vtkTaskGraph::Work()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  while (true)
+  {
+    int taskId = -1;
+    while (this->NumberOfPendingTasks > 0 && (taskId = this->Claim()) < 0)
+    {
+      this->Condition.wait(lock);
+    }
+    if (taskId < 0)
+    {
+      return;
+    }
+
+    // like the REQUEST_DATA pass, an algorithm does not execute if one of
+    // its inputs failed
+    bool failed = this->Failed[taskId] != 0;
+    if (!failed)
+    {
+      lock.unlock();
+      Task& task = this->Tasks[taskId];
+      task.Executive->InTask = true;
+      for (int port : task.Ports)
+      {
+        if (!task.Executive->Superclass::UpdateData(port))
+        {
+          failed = true;
+        }
+      }
+      task.Executive->InTask = false;
+      lock.lock();
+    }
+
+    this->Finish(taskId, failed);
+    this->Condition.notify_all();
+  }
+}
+
+//------------------------------------------------------------------------------
+int vtkTaskGraphPipeline::vtkTaskGraph::Claim()
+{
+  for (auto it = this->ReadyTasks.begin(); it != this->ReadyTasks.end(); ++it)
+  {
+    int taskId = *it;
+    if (!this->Failed[taskId])
+    {
+      if (this->Tasks[taskId].ThreadSafe && this->Gate >= 0)
+      {
+        this->Gate++;
+      }
+      else if (!this->Tasks[taskId].ThreadSafe && this->Gate == 0)
+      {
+        this->Gate = -1;
+      }
+      else
+      {
+        continue;
+      }
+    }
+    this->ReadyTasks.erase(it);
+    return taskId;
+  }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+void vtkTaskGraphPipeline::vtkTaskGraph::Finish(int taskId, bool failed)
+{
+  Task& task = this->Tasks[taskId];
+  if (!this->Failed[taskId])
+  {
+    if (task.ThreadSafe)
+    {
+      this->Gate--;
+    }
+    else
+    {
+      this->Gate = 0;
+    }
+  }
+  this->Failed[taskId] = failed ? 1 : 0;
+
+  for (int consumer : task.Consumers)
+  {
+    if (failed)
+    {
+      this->Failed[consumer] = 1;
+    }
+    if (--this->Remaining[consumer] == 0)
+    {
+      this->ReadyTasks.push_back(consumer);
+    }
+  }
+  this->NumberOfPendingTasks--;
+}
+
+//------------------------------------------------------------------------------
+vtkTaskGraphPipeline::vtkTaskGraphPipeline()
+{
+  this->InTask = false;
+}
+
+//------------------------------------------------------------------------------
+vtkTaskGraphPipeline::~vtkTaskGraphPipeline() = default;
+
+//------------------------------------------------------------------------------
+int vtkTaskGraphPipeline::UpdateData(int outputPort)
+{
+  // an algorithm that updates itself while it executes, for example to
+  // stream its input, updates its inputs too
+  if (this->InTask)
+  {
+    this->InTask = false;
+    int result = this->Superclass::UpdateData(outputPort);
+    this->InTask = true;
+    return result;
+  }
+
+  if (!this->CheckAlgorithm("UpdateData", nullptr))
+  {
+    return 0;
+  }
+  if (outputPort < -1 || outputPort >= this->Algorithm->GetNumberOfOutputPorts())
+  {
+    return this->Superclass::UpdateData(outputPort);
+  }
+
+  vtkTaskGraph graph;
+  if (!graph.AddTask(this, outputPort, -1) || !graph.IsConcurrent())
+  {
+    return this->Superclass::UpdateData(outputPort);
+  }
+  return graph.Execute();
+}
+
+//------------------------------------------------------------------------------
+vtkTypeBool vtkTaskGraphPipeline::UpdateAlgorithms(vtkCollection* algorithms)
+{
+  if (!algorithms)
+  {
+    return 1;
+  }
+
+  // the passes before REQUEST_DATA are done for each algorithm in turn
+  struct Sink
+  {
+    vtkTaskGraphPipeline* Executive;
+    int Port;
+  };
+  std::vector<Sink> sinks;
+  int result = 1;
+  for (vtkObject* object : vtk::Range(algorithms))
+  {
+    vtkAlgorithm* algorithm = vtkAlgorithm::SafeDownCast(object);
+    if (!algorithm)
+    {
+      continue;
+    }
+    int port = (algorithm->GetNumberOfOutputPorts() > 0 ? 0 : -1);
+    vtkTaskGraphPipeline* executive = vtkTaskGraphPipeline::SafeDownCast(algorithm->GetExecutive());
+    if (!executive)
+    {
+      result &= algorithm->GetExecutive()->Update(port);
+      continue;
+    }
+    if (!executive->UpdateInformation())
+    {
+      result = 0;
+      continue;
+    }
+    executive->PropagateTime(port);
+    executive->UpdateTimeDependentInformation(port);
+    if (!executive->PropagateUpdateExtent(port))
+    {
+      result = 0;
+      continue;
+    }
+    if (!executive->LastPropogateUpdateExtentShortCircuited)
+    {
+      sinks.push_back({ executive, port });
+    }
+  }
+
+  vtkTaskGraph graph;
+  bool asGraph = true;
+  for (const Sink& sink : sinks)
+  {
+    asGraph = asGraph && graph.AddTask(sink.Executive, sink.Port, -1);
+  }
+  if (asGraph && graph.IsConcurrent())
+  {
+    result &= graph.Execute();
+  }
+  else
+  {
+    for (const Sink& sink : sinks)
+    {
+      result &= sink.Executive->Superclass::UpdateData(sink.Port);
+    }
+  }
+
+  // the algorithms that asked to execute again are updated on their own
+  for (const Sink& sink : sinks)
+  {
+    if (sink.Executive->ContinueExecuting)
+    {
+      result &= sink.Executive->Update(sink.Port);
+    }
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+int vtkTaskGraphPipeline::ForwardUpstream(vtkInformation* request)
+{
+  // the inputs of a task are already up to date
+  if (this->InTask && request->Has(REQUEST_DATA()))
+  {
+    return 1;
+  }
+  return this->Superclass::ForwardUpstream(request);
+}
+
+//------------------------------------------------------------------------------
+void vtkTaskGraphPipeline::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
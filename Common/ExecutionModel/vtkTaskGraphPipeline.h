@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTaskGraphPipeline.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkTaskGraphPipeline
+ * @brief   Executive that executes independent branches of a pipeline
+ * concurrently.
+ *
+ * vtkTaskGraphPipeline is a vtkCompositeDataPipeline that, when the data of
+ * an algorithm is updated, first builds the graph of the upstream algorithms
+ * that need to execute, then executes them as soon as their inputs are up to
+ * date. Independent branches of the pipeline, such as several filters
+ * sharing the same reader, thus execute concurrently. The
+ * REQUEST_DATA_OBJECT, REQUEST_INFORMATION and REQUEST_UPDATE_EXTENT passes
+ * are unchanged and done sequentially.
+ *
+ * The algorithms execute on the calling thread and on dedicated threads, up
+ * to vtkSMPTools::GetEstimatedNumberOfThreads() in all, which wait for the
+ * tasks without spinning. The algorithms may thus use vtkSMPTools
+ * themselves, although with the STDThread backend only one of the
+ * algorithms executing concurrently runs its vtkSMPTools loops in parallel
+ * unless nested parallelism is enabled.
+ *
+ * Algorithms opt in to concurrent execution by setting THREAD_SAFE() in
+ * their information. Such an algorithm may execute concurrently with any
+ * other thread safe algorithm, including those sharing its inputs, so it
+ * must not modify its inputs, including data structures that are built on
+ * demand such as the cells and links of a vtkPolyData, nor any global state.
+ * Its observers are invoked from the thread that executes it. The other
+ * algorithms, and those with composite inputs, never execute concurrently
+ * with another algorithm, although possibly on another thread than the one
+ * that requested the update. Algorithms that stream their input with
+ * CONTINUE_EXECUTING should not be marked thread safe. When fewer than two
+ * algorithms to execute are thread safe, the pipeline is updated by the
+ * calling thread as by vtkCompositeDataPipeline.
+ *
+ * All the executives of the pipeline must be vtkTaskGraphPipeline, which can
+ * be ensured with vtkAlgorithm::SetDefaultExecutivePrototype(), otherwise
+ * the pipeline is updated sequentially as by vtkCompositeDataPipeline.
+ * UpdateAlgorithms() updates several algorithms with a single graph, such
+ * as the sinks of the branches of a pipeline.
+ *
+ * @sa
+ * vtkCompositeDataPipeline vtkThreadedCompositeDataPipeline vtkSMPTools
+ */
+
+#ifndef vtkTaskGraphPipeline_h
+#define vtkTaskGraphPipeline_h
+
+#include "vtkCommonExecutionModelModule.h" // For export macro
+#include "vtkCompositeDataPipeline.h"
+
+class vtkCollection;
+class vtkInformationIntegerKey;
+
+class VTKCOMMONEXECUTIONMODEL_EXPORT vtkTaskGraphPipeline : public vtkCompositeDataPipeline
+{
+public:
+  static vtkTaskGraphPipeline* New();
+  vtkTypeMacro(vtkTaskGraphPipeline, vtkCompositeDataPipeline);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Update the data of the algorithm, executing the upstream algorithms
+   * that need it as a graph of tasks.
+   */
+  int UpdateData(int outputPort) override;
+
+  /**
+   * Update all the algorithms of the collection, executing all the
+   * algorithms that need it, for any of them, as a single graph of tasks.
+   * The algorithms should have no output or have their first output
+   * updated, like vtkAlgorithm::Update() does. Returns 0 if any update
+   * failed.
+   */
+  static vtkTypeBool UpdateAlgorithms(vtkCollection* algorithms);
+
+  /**
+   * Key set to 1 in the information of an algorithm, see
+   * vtkAlgorithm::GetInformation(), that may execute concurrently with other
+   * thread safe algorithms.
+   */
+  static vtkInformationIntegerKey* THREAD_SAFE();
+
+protected:
+  vtkTaskGraphPipeline();
+  ~vtkTaskGraphPipeline() override;
+
+  using Superclass::ForwardUpstream;
+  int ForwardUpstream(vtkInformation* request) override;
+
+  // Set while the algorithm executes as a task, its inputs are up to date.
+  bool InTask;
+
+private:
+  vtkTaskGraphPipeline(const vtkTaskGraphPipeline&) = delete;
+  void operator=(const vtkTaskGraphPipeline&) = delete;
+
+  class vtkTaskGraph;
+  friend class vtkTaskGraph;
+};
+
+#endif
@@ -0,0 +1,320 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLocatorCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the filters sharing a vtkCellLocatorCache build the locator of
+// a static mesh once over several time steps, and build it again when the
+// mesh changes, that the locators have the parameters of the prototype, that
+// the locators stay valid when they are discarded by concurrent calls, and
+// that concurrent calls for the same mesh build its locator once.
+
+#include "vtkCellLocator.h"
+#include "vtkCellLocatorCache.h"
+#include "vtkCellLocatorInterpolatedVelocityField.h"
+#include "vtkCellLocatorStrategy.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProbeFilter.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkResampleWithDataSet.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStreamTracer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+// A time step with the mesh of the grid and new point data
+vtkSmartPointer<vtkUnstructuredGrid> NewTimeStep(vtkUnstructuredGrid* grid, double time)
+{
+  auto step = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  step->CopyStructure(grid);
+  vtkIdType numPts = grid->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> velocity;
+  velocity->SetName("velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    const double* x = grid->GetPoint(i);
+    scalars->SetValue(i, time * x[0] + x[1] * x[2]);
+    velocity->SetTuple3(i, 1., time * 0.1, -x[1] * 0.01);
+  }
+  step->GetPointData()->SetScalars(scalars);
+  step->GetPointData()->SetVectors(velocity);
+  return step;
+}
+
+// Probe with the cache and without, which must give the same values
+bool CheckProbe(vtkProbeFilter* probe, vtkDataSet* source, int time)
+{
+  probe->SetSourceData(source);
+  probe->Update();
+  vtkDataArray* scalars = probe->GetOutput()->GetPointData()->GetScalars();
+
+  vtkNew<vtkProbeFilter> reference;
+  reference->SetInputData(probe->GetInput());
+  reference->SetSourceData(source);
+  vtkNew<vtkStaticCellLocator> locator;
+  reference->SetCellLocatorPrototype(
+    probe->GetCellLocatorPrototype() ? probe->GetCellLocatorPrototype() : locator);
+  reference->Update();
+  vtkDataArray* expected = reference->GetOutput()->GetPointData()->GetScalars();
+
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); ++i)
+  {
+    if (scalars->GetTuple1(i) != expected->GetTuple1(i))
+    {
+      std::cerr << "Wrong probed value at time step " << time << " for point " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CheckBuilds(vtkCellLocatorCache* cache, vtkIdType expected, const char* when)
+{
+  if (cache->GetNumberOfBuilds() != expected)
+  {
+    std::cerr << cache->GetNumberOfBuilds() << " locators built instead of " << expected
+              << " after " << when << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestCellLocatorCache(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(-6, 6, -6, 6, -6, 6);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputConnection(wavelet->GetOutputPort());
+  tetrahedralize->Update();
+  vtkUnstructuredGrid* grid = tetrahedralize->GetOutput();
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < 500; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = random->GetNextRangeValue(-6.5, 6.5);
+    }
+    points->InsertNextPoint(x);
+  }
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points);
+
+  vtkNew<vtkCellLocatorCache> cache;
+  vtkNew<vtkProbeFilter> probe;
+  probe->SetInputData(input);
+  probe->SetCellLocatorCache(cache);
+
+  // time steps sharing the mesh
+  bool success = true;
+  for (int time = 0; time < 3; ++time)
+  {
+    success &= CheckProbe(probe, NewTimeStep(grid, time), time);
+  }
+  success &= CheckBuilds(cache, 1, "probing time steps sharing the mesh");
+
+  // a time step read again, with the same mesh in new arrays
+  vtkNew<vtkUnstructuredGrid> copy;
+  copy->DeepCopy(NewTimeStep(grid, 3));
+  success &= CheckProbe(probe, copy, 3);
+  success &= CheckBuilds(cache, 1, "probing a copy of the mesh");
+  cache->CompareContentsOff();
+  probe->Modified();
+  success &= CheckProbe(probe, copy, 3);
+  success &= CheckBuilds(cache, 2, "probing a copy of the mesh without comparing contents");
+  cache->CompareContentsOn();
+
+  // another class of locator
+  vtkNew<vtkCellLocator> prototype;
+  probe->SetCellLocatorPrototype(prototype);
+  success &= CheckProbe(probe, copy, 3);
+  success &= CheckBuilds(cache, 3, "probing with another locator");
+  probe->SetCellLocatorPrototype(nullptr);
+
+  // the resampling and the streamlines share the locator of the probe
+  vtkNew<vtkResampleWithDataSet> resample;
+  resample->SetInputData(input);
+  resample->SetSourceData(NewTimeStep(grid, 4));
+  resample->SetCellLocatorCache(cache);
+  resample->MarkBlankPointsAndCellsOff();
+  resample->Update();
+  success &= CheckBuilds(cache, 3, "resampling");
+
+  vtkNew<vtkCellLocatorInterpolatedVelocityField> interpolator;
+  interpolator->SetCellLocatorCache(cache);
+  vtkNew<vtkStreamTracer> tracer;
+  tracer->SetInterpolatorPrototype(interpolator);
+  tracer->SetSourceData(input);
+  tracer->SetMaximumPropagation(5.);
+  for (int time = 5; time < 7; ++time)
+  {
+    tracer->SetInputData(NewTimeStep(grid, time));
+    tracer->Update();
+    if (tracer->GetOutput()->GetNumberOfPoints() == 0)
+    {
+      std::cerr << "No streamlines at time step " << time << std::endl;
+      success = false;
+    }
+  }
+  success &= CheckBuilds(cache, 3, "tracing streamlines");
+
+  vtkNew<vtkCellLocatorStrategy> strategy;
+  strategy->SetCellLocatorCache(cache);
+  vtkSmartPointer<vtkUnstructuredGrid> step = NewTimeStep(grid, 7);
+  strategy->Initialize(step);
+  if (strategy->GetCellLocator() != cache->GetCellLocator(step))
+  {
+    std::cerr << "vtkCellLocatorStrategy does not use the cached locator" << std::endl;
+    success = false;
+  }
+
+  // the mesh changes when its points are modified
+  vtkPoints* copyPoints = copy->GetPoints();
+  for (vtkIdType i = 0; i < copyPoints->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    copyPoints->GetPoint(i, x);
+    x[0] += 0.5;
+    copyPoints->SetPoint(i, x);
+  }
+  copyPoints->Modified();
+  success &= CheckProbe(probe, copy, 8);
+  success &= CheckBuilds(cache, 4, "modifying the points of the mesh");
+
+  cache->SetMaximumNumberOfLocators(2);
+  success &= CheckProbe(probe, grid, 9);
+  if (cache->GetNumberOfLocators() != 2)
+  {
+    std::cerr << "The cache keeps " << cache->GetNumberOfLocators() << " locators instead of 2"
+              << std::endl;
+    success = false;
+  }
+
+  // the parameters of the prototype are those of the new locators
+  cache->Clear();
+  vtkNew<vtkStaticCellLocator> staticPrototype;
+  staticPrototype->SetNumberOfCellsPerNode(3);
+  staticPrototype->SetTolerance(0.125);
+  staticPrototype->CacheCellBoundsOff();
+  staticPrototype->SetMaxNumberOfBuckets(5000);
+  vtkSmartPointer<vtkAbstractCellLocator> built =
+    cache->GetCellLocator(NewTimeStep(grid, 10), staticPrototype);
+  vtkStaticCellLocator* staticLocator = vtkStaticCellLocator::SafeDownCast(built);
+  if (!staticLocator || staticLocator == staticPrototype.Get() ||
+    staticLocator->GetNumberOfCellsPerNode() != 3 || staticLocator->GetTolerance() != 0.125 ||
+    staticLocator->GetCacheCellBounds() || staticLocator->GetMaxNumberOfBuckets() != 5000)
+  {
+    std::cerr << "The locator does not have the parameters of the prototype" << std::endl;
+    success = false;
+  }
+
+  // concurrent calls for four meshes, with room for a single locator, so
+  // that each call discards the locators returned to the other threads
+  vtkSmartPointer<vtkUnstructuredGrid> meshes[4];
+  for (int i = 0; i < 4; ++i)
+  {
+    meshes[i] = vtkSmartPointer<vtkUnstructuredGrid>::New();
+    meshes[i]->DeepCopy(grid);
+    vtkPoints* meshPoints = meshes[i]->GetPoints();
+    for (vtkIdType j = 0; j < meshPoints->GetNumberOfPoints(); ++j)
+    {
+      double x[3];
+      meshPoints->GetPoint(j, x);
+      x[0] += i;
+      meshPoints->SetPoint(j, x);
+    }
+  }
+  vtkNew<vtkCellLocatorCache> sharedCache;
+  sharedCache->SetMaximumNumberOfLocators(1);
+  std::atomic<int> misses(0);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 4 }, [&]() {
+    vtkSMPTools::For(0, 64, 1, [&](vtkIdType begin, vtkIdType end) {
+      vtkNew<vtkGenericCell> cell;
+      for (vtkIdType k = begin; k < end; ++k)
+      {
+        const int i = static_cast<int>(k % 4);
+        vtkSmartPointer<vtkAbstractCellLocator> locator = sharedCache->GetCellLocator(meshes[i]);
+        // the center of the grid, shifted like the mesh, is in one of its cells
+        double x[3] = { i + 0.1, 0.1, 0.1 }, pcoords[3], weights[4];
+        if (!locator || locator->FindCell(x, 0., cell, pcoords, weights) < 0)
+        {
+          ++misses;
+        }
+      }
+    });
+  });
+  if (misses > 0 || sharedCache->GetNumberOfLocators() != 1)
+  {
+    std::cerr << misses << " concurrent searches failed" << std::endl;
+    success = false;
+  }
+
+  // concurrent calls for copies of a mesh wait for the locator being built
+  for (int i = 0; i < 4; ++i)
+  {
+    meshes[i]->DeepCopy(grid);
+  }
+  vtkNew<vtkCellLocatorCache> buildOnceCache;
+  std::atomic<int> differentLocators(0);
+  std::atomic<vtkAbstractCellLocator*> first(nullptr);
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 4 }, [&]() {
+    vtkSMPTools::For(0, 64, 1, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType k = begin; k < end; ++k)
+      {
+        vtkSmartPointer<vtkAbstractCellLocator> locator =
+          buildOnceCache->GetCellLocator(meshes[k % 4]);
+        vtkAbstractCellLocator* expected = nullptr;
+        if (!locator)
+        {
+          ++differentLocators;
+        }
+        else if (!first.compare_exchange_strong(expected, locator.Get()))
+        {
+          differentLocators += expected != locator.Get() ? 1 : 0;
+        }
+      }
+    });
+  });
+  success &= CheckBuilds(buildOnceCache, 1, "concurrent calls for copies of a mesh");
+  if (differentLocators > 0)
+  {
+    std::cerr << differentLocators << " concurrent calls got another locator" << std::endl;
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,238 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterRegions.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the regions labeled in parallel by vtkConnectivityFilter and
+// vtkPolyDataConnectivityFilter against a sequential wave propagation, and
+// that the output does not depend on the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConnectivityFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataConnectivityFilter.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+// Triangles picking their points at random among a pool of points, so that
+// they make many regions of various sizes.
+vtkSmartPointer<vtkPolyData> CreateInput()
+{
+  const vtkIdType numPts = 3000;
+  const vtkIdType numTris = 1500;
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(7);
+
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    points->InsertNextPoint(random->GetNextRangeValue(0, 1), random->GetNextRangeValue(0, 1), 0.);
+    scalars->InsertNextValue(static_cast<float>(random->GetNextRangeValue(0, 1)));
+  }
+  vtkNew<vtkCellArray> polys;
+  for (vtkIdType i = 0; i < numTris; ++i)
+  {
+    polys->InsertNextCell(3);
+    for (int j = 0; j < 3; ++j)
+    {
+      polys->InsertCellPoint(static_cast<vtkIdType>(random->GetNextRangeValue(0, numPts - 1)));
+    }
+  }
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points);
+  input->SetPolys(polys);
+  input->GetPointData()->SetScalars(scalars);
+  return input;
+}
+
+// Region of each cell with the sequential wave propagation, and the number
+// of regions.
+vtkIdType ReferenceRegions(
+  vtkPolyData* input, bool scalarConnectivity, const double range[2], std::vector<vtkIdType>& regions)
+{
+  const vtkIdType numCells = input->GetNumberOfCells();
+  vtkDataArray* scalars = input->GetPointData()->GetScalars();
+  input->BuildLinks();
+  vtkNew<vtkIdList> ptIds;
+  vtkNew<vtkIdList> cellIds;
+  auto connected = [&](vtkIdType cellId) {
+    if (!scalarConnectivity)
+    {
+      return true;
+    }
+    input->GetCellPoints(cellId, ptIds);
+    double r[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      double s = scalars->GetComponent(ptIds->GetId(i), 0);
+      r[0] = s < r[0] ? s : r[0];
+      r[1] = s > r[1] ? s : r[1];
+    }
+    return r[1] >= range[0] && r[0] <= range[1];
+  };
+
+  regions.assign(numCells, -1);
+  vtkIdType numRegions = 0;
+  for (vtkIdType seed = 0; seed < numCells; ++seed)
+  {
+    if (regions[seed] >= 0)
+    {
+      continue;
+    }
+    std::deque<vtkIdType> wave{ seed };
+    while (!wave.empty())
+    {
+      const vtkIdType cellId = wave.front();
+      wave.pop_front();
+      if (regions[cellId] >= 0)
+      {
+        continue;
+      }
+      regions[cellId] = numRegions;
+      vtkNew<vtkIdList> cellPtIds;
+      input->GetCellPoints(cellId, cellPtIds);
+      for (vtkIdType i = 0; i < cellPtIds->GetNumberOfIds(); ++i)
+      {
+        input->GetPointCells(cellPtIds->GetId(i), cellIds);
+        for (vtkIdType j = 0; j < cellIds->GetNumberOfIds(); ++j)
+        {
+          if (regions[cellIds->GetId(j)] < 0 && connected(cellIds->GetId(j)))
+          {
+            wave.push_back(cellIds->GetId(j));
+          }
+        }
+      }
+    }
+    ++numRegions;
+  }
+  return numRegions;
+}
+
+vtkSmartPointer<vtkConnectivityFilter> LabelRegions(
+  vtkPolyData* input, bool scalarConnectivity, const double range[2])
+{
+  vtkNew<vtkConnectivityFilter> connectivity;
+  connectivity->SetInputData(input);
+  connectivity->SetExtractionModeToAllRegions();
+  connectivity->ColorRegionsOn();
+  connectivity->SetScalarConnectivity(scalarConnectivity);
+  connectivity->SetScalarRange(range[0], range[1]);
+  connectivity->Update();
+  return connectivity.GetPointer();
+}
+
+vtkSmartPointer<vtkPolyDataConnectivityFilter> ExtractLargestRegion(
+  vtkPolyData* input, bool scalarConnectivity, const double range[2])
+{
+  vtkNew<vtkPolyDataConnectivityFilter> polyConnectivity;
+  polyConnectivity->SetInputData(input);
+  polyConnectivity->SetExtractionModeToLargestRegion();
+  polyConnectivity->ColorRegionsOn();
+  polyConnectivity->SetScalarConnectivity(scalarConnectivity);
+  polyConnectivity->SetScalarRange(range[0], range[1]);
+  polyConnectivity->Update();
+  return polyConnectivity.GetPointer();
+}
+
+bool SameOutputs(vtkPointSet* output1, vtkPointSet* output2)
+{
+  return output1->GetNumberOfCells() == output2->GetNumberOfCells() &&
+    vtkTest::SameArrays(output1->GetPoints()->GetData(), output2->GetPoints()->GetData()) &&
+    vtkTest::SameArrays(output1->GetPointData()->GetArray("RegionId"),
+      output2->GetPointData()->GetArray("RegionId"));
+}
+
+} // anonymous namespace
+
+int TestConnectivityFilterRegions(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> input = CreateInput();
+  const double range[2] = { 0.3, 0.6 };
+
+  for (bool scalarConnectivity : { false, true })
+  {
+    std::vector<vtkIdType> reference;
+    const vtkIdType numRegions = ReferenceRegions(input, scalarConnectivity, range, reference);
+    std::vector<vtkIdType> sizes(numRegions, 0);
+    for (vtkIdType region : reference)
+    {
+      ++sizes[region];
+    }
+
+    auto filters = vtkTest::RunSequentialAndThreaded(
+      [&]() { return LabelRegions(input, scalarConnectivity, range); });
+    auto polyFilters = vtkTest::RunSequentialAndThreaded(
+      [&]() { return ExtractLargestRegion(input, scalarConnectivity, range); });
+    for (vtkConnectivityFilter* connectivity : { filters.first, filters.second })
+    {
+      if (connectivity->GetNumberOfExtractedRegions() != numRegions)
+      {
+        std::cerr << "vtkConnectivityFilter found " << connectivity->GetNumberOfExtractedRegions()
+                  << " regions instead of " << numRegions << "." << std::endl;
+        return EXIT_FAILURE;
+      }
+      vtkDataArray* cellRegions = connectivity->GetOutput()->GetCellData()->GetArray("RegionId");
+      for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+      {
+        if (cellRegions->GetComponent(cellId, 0) != reference[cellId])
+        {
+          std::cerr << "Wrong region for cell " << cellId << "." << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    for (vtkPolyDataConnectivityFilter* polyConnectivity :
+      { polyFilters.first, polyFilters.second })
+    {
+      vtkIdTypeArray* polySizes = polyConnectivity->GetRegionSizes();
+      bool sameSizes = polyConnectivity->GetNumberOfExtractedRegions() == numRegions;
+      for (vtkIdType region = 0; sameSizes && region < numRegions; ++region)
+      {
+        sameSizes = polySizes->GetValue(region) == sizes[region];
+      }
+      if (!sameSizes)
+      {
+        std::cerr << "vtkPolyDataConnectivityFilter found wrong regions." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    if (!SameOutputs(filters.first->GetOutput(), filters.second->GetOutput()) ||
+      !SameOutputs(polyFilters.first->GetOutput(), polyFilters.second->GetOutput()))
+    {
+      std::cerr << "Threaded output differs from sequential output (scalar connectivity "
+                << (scalarConnectivity ? "on" : "off") << ")." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDelaunay3DSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the parallel insertion of vtkDelaunay3D builds the same
+// triangulation as the serial insertion with 1, 2 and 4 threads. With a
+// non-zero alpha, the triangles and lines output by vtkDelaunay3D depend on
+// the order of the tetrahedra, so only the tetrahedra are compared to the
+// serial insertion. The tetrahedra must also satisfy the Delaunay criterion:
+// no input point lies inside their circumsphere.
+
+#include "vtkDelaunay3D.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointSource.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTetra.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+
+using vtkCanonicalCells = std::vector<std::vector<vtkIdType>>;
+
+// The cells as sorted (type, sorted point ids) tuples, to compare
+// triangulations regardless of the order and orientation of their cells.
+vtkCanonicalCells GetCanonicalCells(vtkUnstructuredGrid* output)
+{
+  vtkCanonicalCells cells(output->GetNumberOfCells());
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    std::vector<vtkIdType>& cell = cells[cellId];
+    cell.push_back(output->GetCellType(cellId));
+    cell.insert(cell.end(), ptIds->begin(), ptIds->end());
+    std::sort(cell.begin() + 1, cell.end());
+  }
+  std::sort(cells.begin(), cells.end());
+  return cells;
+}
+
+vtkCanonicalCells GetTetras(const vtkCanonicalCells& cells)
+{
+  vtkCanonicalCells tetras;
+  std::copy_if(cells.begin(), cells.end(), std::back_inserter(tetras),
+    [](const std::vector<vtkIdType>& cell) { return cell[0] == VTK_TETRA; });
+  return tetras;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> Triangulate(vtkPolyData* input, bool parallel,
+  double alpha, bool bounding, const vtkSMPTools::Config& config)
+{
+  vtkNew<vtkDelaunay3D> delaunay;
+  delaunay->SetInputData(input);
+  delaunay->SetParallelInsertion(parallel);
+  delaunay->SetAlpha(alpha);
+  delaunay->SetBoundingTriangulation(bounding);
+  vtkSMPTools::LocalScope(config, [&]() { delaunay->Update(); });
+  return delaunay->GetOutput();
+}
+
+// Check that no input point lies inside the circumsphere of every 16th
+// tetrahedron, up to a relative tolerance.
+bool CheckDelaunayCriterion(vtkUnstructuredGrid* output, vtkPoints* points)
+{
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); cellId += 16)
+  {
+    if (output->GetCellType(cellId) != VTK_TETRA)
+    {
+      continue;
+    }
+    output->GetCellPoints(cellId, ptIds);
+    double x[4][3], center[3];
+    for (int i = 0; i < 4; ++i)
+    {
+      output->GetPoint(ptIds->GetId(i), x[i]);
+    }
+    const double radius2 = vtkTetra::Circumsphere(x[0], x[1], x[2], x[3], center);
+    for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+    {
+      if (vtkMath::Distance2BetweenPoints(points->GetPoint(ptId), center) < radius2 * (1 - 1e-6))
+      {
+        std::cerr << "Point " << ptId << " lies inside the circumsphere of tetrahedron " << cellId
+                  << "." << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestDelaunay3DSMP(int, char*[])
+{
+  vtkMath::RandomSeed(4355412);
+  vtkNew<vtkPointSource> source;
+  source->SetNumberOfPoints(5000);
+  source->SetRadius(1.0);
+  source->SetDistributionToUniform();
+  source->Update();
+
+  // Append coincident points, which must be discarded.
+  vtkNew<vtkPolyData> input;
+  vtkNew<vtkPoints> points;
+  points->DeepCopy(source->GetOutput()->GetPoints());
+  for (vtkIdType i = 0; i < 100; ++i)
+  {
+    points->InsertNextPoint(points->GetPoint(97 * i));
+  }
+  input->SetPoints(points);
+
+  const vtkSMPTools::Config sequentialConfig = vtkTest::SequentialConfig();
+  struct
+  {
+    double Alpha;
+    bool Bounding;
+  } cases[] = { { 0.0, false }, { 0.1, false }, { 0.0, true } };
+
+  for (const auto& c : cases)
+  {
+    const vtkCanonicalCells serial =
+      GetCanonicalCells(Triangulate(input, false, c.Alpha, c.Bounding, sequentialConfig));
+
+    vtkCanonicalCells sequential;
+    for (int numThreads : { 1, 2, 4 })
+    {
+      const vtkSMPTools::Config config =
+        numThreads == 1 ? sequentialConfig : vtkSMPTools::Config{ numThreads };
+      vtkSmartPointer<vtkUnstructuredGrid> output =
+        Triangulate(input, true, c.Alpha, c.Bounding, config);
+      if (!c.Bounding && !CheckDelaunayCriterion(output, points))
+      {
+        return EXIT_FAILURE;
+      }
+      const vtkCanonicalCells parallel = GetCanonicalCells(output);
+      if (numThreads == 1)
+      {
+        sequential = parallel;
+      }
+      if (parallel != sequential || GetTetras(parallel) != GetTetras(serial) ||
+        (c.Alpha == 0.0 && parallel != serial))
+      {
+        std::cerr << "Parallel insertion with " << numThreads << " threads built "
+                  << parallel.size() << " cells instead of " << serial.size() << " (alpha "
+                  << c.Alpha << ", bounding triangulation " << c.Bounding << ")." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
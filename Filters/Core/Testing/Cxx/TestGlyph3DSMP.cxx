@@ -0,0 +1,363 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkGlyph3D and vtkTensorGlyph generate the same glyphs with
+// ParallelGlyphing, whatever the number of threads, as without.
+
+#include "vtkCellData.h"
+#include "vtkConeSource.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkElevationFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkMath.h"
+#include "vtkIdList.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTensorGlyph.h"
+#include "vtkTexturedSphereSource.h"
+#include "vtkTransform.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Random points with scalars, vectors, normals, colors and tensors. Some
+// vectors are null or along x, and some points are hidden ghosts.
+vtkSmartPointer<vtkPolyData> NewInput(vtkIdType numPts)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  auto next = [&random](double min, double max) {
+    random->Next();
+    return random->GetRangeValue(min, max);
+  };
+
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numPts);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> normals;
+  normals->SetName("Normals");
+  normals->SetNumberOfComponents(3);
+  normals->SetNumberOfTuples(numPts);
+  vtkNew<vtkUnsignedCharArray> colors;
+  colors->SetName("Colors");
+  colors->SetNumberOfComponents(3);
+  colors->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> tensors;
+  tensors->SetName("Tensors");
+  tensors->SetNumberOfComponents(9);
+  tensors->SetNumberOfTuples(numPts);
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  ghosts->SetNumberOfTuples(numPts);
+
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    points->SetPoint(i, next(-10., 10.), next(-10., 10.), next(-10., 10.));
+    scalars->SetValue(i, next(-0.5, 1.5));
+    double v[3] = { next(-1., 1.), next(-1., 1.), next(-1., 1.) };
+    if (i % 13 == 0)
+    {
+      v[1] = v[2] = 0.;
+    }
+    else if (i % 17 == 0)
+    {
+      v[0] = v[1] = v[2] = 0.;
+    }
+    vectors->SetTuple(i, v);
+    normals->SetTuple3(i, next(-1., 1.), next(-1., 1.), next(-1., 1.));
+    colors->SetTuple3(i, i % 256, (3 * i) % 256, (7 * i) % 256);
+    for (int j = 0; j < 9; ++j)
+    {
+      tensors->SetComponent(i, j, next(-1., 1.));
+    }
+    ghosts->SetValue(i, i % 11 == 0 ? vtkDataSetAttributes::HIDDENPOINT : 0);
+  }
+
+  auto input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->SetVectors(vectors);
+  input->GetPointData()->SetNormals(normals);
+  input->GetPointData()->SetTensors(tensors);
+  input->GetPointData()->AddArray(colors);
+  input->GetPointData()->AddArray(ghosts);
+  return input;
+}
+
+// Compare the points, the cells and the point and cell data of the glyphs
+bool SameGlyphs(
+  vtkPolyData* expected, vtkPolyData* glyphs, double tolerance, const std::string& what)
+{
+  if (expected->GetNumberOfPoints() == 0 ||
+    glyphs->GetNumberOfPoints() != expected->GetNumberOfPoints() ||
+    glyphs->GetNumberOfCells() != expected->GetNumberOfCells())
+  {
+    std::cerr << what << ": " << glyphs->GetNumberOfPoints() << " points and "
+              << glyphs->GetNumberOfCells() << " cells instead of "
+              << expected->GetNumberOfPoints() << " and " << expected->GetNumberOfCells()
+              << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < expected->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    expected->GetPoint(i, x);
+    glyphs->GetPoint(i, y);
+    for (int j = 0; j < 3; ++j)
+    {
+      if (std::abs(x[j] - y[j]) > tolerance * (1. + std::abs(x[j])))
+      {
+        std::cerr << what << ": wrong point " << i << std::endl;
+        return false;
+      }
+    }
+  }
+  vtkNew<vtkIdList> expectedIds;
+  vtkNew<vtkIdList> ids;
+  for (vtkIdType i = 0; i < expected->GetNumberOfCells(); ++i)
+  {
+    expected->GetCellPoints(i, expectedIds);
+    glyphs->GetCellPoints(i, ids);
+    bool same = expectedIds->GetNumberOfIds() == ids->GetNumberOfIds();
+    for (vtkIdType j = 0; same && j < ids->GetNumberOfIds(); ++j)
+    {
+      same = expectedIds->GetId(j) == ids->GetId(j);
+    }
+    if (!same)
+    {
+      std::cerr << what << ": wrong cell " << i << std::endl;
+      return false;
+    }
+  }
+
+  vtkDataSetAttributes* expectedData[2] = { expected->GetPointData(), expected->GetCellData() };
+  vtkDataSetAttributes* data[2] = { glyphs->GetPointData(), glyphs->GetCellData() };
+  for (int d = 0; d < 2; ++d)
+  {
+    if (data[d]->GetNumberOfArrays() != expectedData[d]->GetNumberOfArrays())
+    {
+      std::cerr << what << ": " << data[d]->GetNumberOfArrays() << " arrays instead of "
+                << expectedData[d]->GetNumberOfArrays() << std::endl;
+      return false;
+    }
+    for (int a = 0; a < expectedData[d]->GetNumberOfArrays(); ++a)
+    {
+      vtkDataArray* expectedArray = expectedData[d]->GetArray(a);
+      if (!expectedArray)
+      {
+        continue;
+      }
+      vtkDataArray* array = data[d]->GetArray(expectedArray->GetName());
+      if (!array || array->GetDataType() != expectedArray->GetDataType() ||
+        array->GetNumberOfValues() != expectedArray->GetNumberOfValues())
+      {
+        std::cerr << what << ": wrong array " << expectedArray->GetName() << std::endl;
+        return false;
+      }
+      const int numComps = array->GetNumberOfComponents();
+      for (vtkIdType i = 0; i < array->GetNumberOfTuples(); ++i)
+      {
+        for (int j = 0; j < numComps; ++j)
+        {
+          const double value = expectedArray->GetComponent(i, j);
+          if (std::abs(array->GetComponent(i, j) - value) > tolerance * (1. + std::abs(value)))
+          {
+            std::cerr << what << ": wrong " << expectedArray->GetName() << " " << i << std::endl;
+            return false;
+          }
+        }
+      }
+    }
+  }
+  if ((expected->GetPointData()->GetScalars() != nullptr) !=
+    (glyphs->GetPointData()->GetScalars() != nullptr))
+  {
+    std::cerr << what << ": wrong active scalars" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Glyph serially and in parallel with the sequential backend and 4 threads,
+// and compare
+bool CheckParallelGlyphing(vtkPolyDataAlgorithm* filter,
+  const std::function<void(vtkTypeBool)>& setParallel, const std::string& what)
+{
+  setParallel(false);
+  filter->Update();
+  vtkNew<vtkPolyData> expected;
+  expected->DeepCopy(filter->GetOutput());
+
+  setParallel(true);
+  auto outputs = vtkTest::RunSequentialAndThreaded([&]() -> vtkSmartPointer<vtkPolyData> {
+    filter->Modified();
+    filter->Update();
+    vtkNew<vtkPolyData> output;
+    output->DeepCopy(filter->GetOutput());
+    return output.GetPointer();
+  });
+
+  return SameGlyphs(outputs.first, outputs.second, 0., what + " with 4 threads") &&
+    SameGlyphs(expected, outputs.second, 1e-5, what);
+}
+
+// Check that the ghost points are not glyphed, and that every other point is
+// glyphed once with the given number of points.
+bool CheckGlyphedPoints(vtkPolyData* input, vtkPolyData* glyphs, vtkIdType numGlyphPts)
+{
+  vtkDataArray* inputIds = glyphs->GetPointData()->GetArray("InputPointIds");
+  std::vector<vtkIdType> counts(input->GetNumberOfPoints(), 0);
+  for (vtkIdType i = 0; i < inputIds->GetNumberOfTuples(); ++i)
+  {
+    ++counts[static_cast<vtkIdType>(inputIds->GetComponent(i, 0))];
+  }
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+  {
+    if (counts[i] != (i % 11 == 0 ? 0 : numGlyphPts))
+    {
+      std::cerr << "Input point " << i << " has " << counts[i] << " glyph points." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Check that the glyph vectors point from the input points to the camera
+bool CheckCameraDirection(vtkPolyData* input, vtkPolyData* glyphs, const double camera[3])
+{
+  vtkDataArray* inputIds = glyphs->GetPointData()->GetArray("InputPointIds");
+  vtkDataArray* vectors = glyphs->GetPointData()->GetArray("GlyphVector");
+  for (vtkIdType i = 0; i < glyphs->GetNumberOfPoints(); ++i)
+  {
+    double x[3], direction[3], v[3];
+    input->GetPoint(static_cast<vtkIdType>(inputIds->GetComponent(i, 0)), x);
+    vtkMath::Subtract(camera, x, direction);
+    vtkMath::Normalize(direction);
+    vectors->GetTuple(i, v);
+    if (std::sqrt(vtkMath::Distance2BetweenPoints(direction, v)) > 1e-6)
+    {
+      std::cerr << "Glyph vector " << i << " does not point to the camera." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestGlyph3DSMP(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> input = NewInput(2500);
+  vtkNew<vtkTexturedSphereSource> sphere;
+  sphere->SetThetaResolution(6);
+  sphere->SetPhiResolution(5);
+  vtkNew<vtkConeSource> cone;
+  cone->SetResolution(5);
+
+  vtkNew<vtkGlyph3D> glyph;
+  glyph->SetInputData(input);
+  glyph->SetSourceConnection(sphere->GetOutputPort());
+  auto setParallel = [&glyph](vtkTypeBool parallel) { glyph->SetParallelGlyphing(parallel); };
+
+  // scaled by scalar and oriented by vector, with the source transformed
+  vtkNew<vtkTransform> transform;
+  transform->RotateZ(30.);
+  transform->Translate(0.5, 0., 0.);
+  glyph->SetSourceTransform(transform);
+  glyph->GeneratePointIdsOn();
+  glyph->FillCellDataOn();
+  bool success = CheckParallelGlyphing(glyph, setParallel, "Glyphs scaled by scalar") &&
+    CheckGlyphedPoints(input, glyph->GetOutput(), sphere->GetOutput()->GetNumberOfPoints());
+
+  // scaled by vector components, clamped and colored by scalar
+  glyph->SetSourceTransform(nullptr);
+  glyph->FillCellDataOff();
+  glyph->SetScaleModeToScaleByVectorComponents();
+  glyph->ClampingOn();
+  glyph->SetRange(-0.5, 0.8);
+  glyph->SetColorModeToColorByScalar();
+  glyph->SetInputArrayToProcess(
+    3, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "Colors");
+  glyph->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  success &= CheckParallelGlyphing(glyph, setParallel, "Glyphs scaled by vector components");
+
+  // a table of glyphs indexed by scalar, oriented by normal
+  glyph->ClampingOff();
+  glyph->SetRange(-0.5, 1.5);
+  glyph->SetSourceConnection(1, cone->GetOutputPort());
+  glyph->SetIndexModeToScalar();
+  glyph->SetVectorModeToUseNormal();
+  glyph->SetScaleModeToScaleByVector();
+  glyph->SetColorModeToColorByVector();
+  success &= CheckParallelGlyphing(glyph, setParallel, "Table of glyphs");
+
+  // glyphs facing the camera
+  glyph->SetIndexModeToOff();
+  glyph->SetVectorModeToFollowCameraDirection();
+  double cameraPosition[3] = { 20., 30., 40. };
+  glyph->SetFollowedCameraPosition(cameraPosition);
+  glyph->SetScaleModeToDataScalingOff();
+  glyph->SetColorModeToColorByScale();
+  success &= CheckParallelGlyphing(glyph, setParallel, "Glyphs facing the camera") &&
+    CheckCameraDirection(input, glyph->GetOutput(), cameraPosition);
+
+  // tensor glyphs
+  vtkNew<vtkSphereSource> tensorSphere;
+  tensorSphere->SetThetaResolution(6);
+  tensorSphere->SetPhiResolution(5);
+  vtkNew<vtkElevationFilter> elevation;
+  elevation->SetInputConnection(tensorSphere->GetOutputPort());
+  vtkNew<vtkTensorGlyph> tensorGlyph;
+  tensorGlyph->SetInputData(input);
+  tensorGlyph->SetSourceConnection(elevation->GetOutputPort());
+  auto setTensorParallel = [&tensorGlyph](
+                             vtkTypeBool parallel) { tensorGlyph->SetParallelGlyphing(parallel); };
+  success &= CheckParallelGlyphing(tensorGlyph, setTensorParallel, "Tensor glyphs");
+
+  tensorGlyph->ThreeGlyphsOn();
+  tensorGlyph->SymmetricOn();
+  tensorGlyph->SetColorModeToEigenvalues();
+  success &= CheckParallelGlyphing(tensorGlyph, setTensorParallel, "Three symmetric glyphs");
+
+  tensorGlyph->ThreeGlyphsOff();
+  tensorGlyph->ExtractEigenvaluesOff();
+  tensorGlyph->ClampScalingOn();
+  tensorGlyph->SetMaxScaleFactor(0.5);
+  tensorGlyph->ColorGlyphsOff();
+  success &= CheckParallelGlyphing(tensorGlyph, setTensorParallel, "Tensor columns");
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
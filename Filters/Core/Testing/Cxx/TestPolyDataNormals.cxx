@@ -0,0 +1,202 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormals.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the normals computed by vtkPolyDataNormals on a sphere, that they do
+// not depend on the number of threads used by vtkSMPTools, and that progress
+// and abort requests are handled by the calling thread while polygon normals
+// are computed.
+
+#include "vtkCallbackCommand.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCommand.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+
+vtkSmartPointer<vtkPolyData> ComputeNormals(vtkPolyData* input, bool splitting)
+{
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(input);
+  normals->SetSplitting(splitting);
+  normals->SetFeatureAngle(25.0);
+  normals->ComputeCellNormalsOn();
+  normals->Update();
+
+  vtkSmartPointer<vtkPolyData> output = normals->GetOutput();
+  return output;
+}
+
+bool SameOutputs(vtkPolyData* output1, vtkPolyData* output2)
+{
+  return vtkTest::SameArrays(output1->GetPoints()->GetData(), output2->GetPoints()->GetData()) &&
+    vtkTest::SameArrays(output1->GetPolys()->GetConnectivityArray(),
+      output2->GetPolys()->GetConnectivityArray()) &&
+    vtkTest::SameArrays(
+      output1->GetPointData()->GetNormals(), output2->GetPointData()->GetNormals()) &&
+    vtkTest::SameArrays(
+      output1->GetCellData()->GetNormals(), output2->GetCellData()->GetNormals()) &&
+    vtkTest::SameArrays(
+      output1->GetPointData()->GetArray("Ids"), output2->GetPointData()->GetArray("Ids"));
+}
+
+// Normals of a sphere centered at the origin are unit vectors pointing
+// outwards, and split points keep the coordinates of the point they split.
+bool ValidNormals(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkDataArray* pointNormals = output->GetPointData()->GetNormals();
+  vtkDataArray* ids = output->GetPointData()->GetArray("Ids");
+  double n[3], x[3], y[3];
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    pointNormals->GetTuple(ptId, n);
+    output->GetPoint(ptId, x);
+    input->GetPoint(static_cast<vtkIdType>(ids->GetComponent(ptId, 0)), y);
+    if (std::abs(vtkMath::Norm(n) - 1.) > 1e-6 || vtkMath::Dot(n, x) <= 0. ||
+      x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      std::cerr << "Wrong normal or coordinates at point " << ptId << "." << std::endl;
+      return false;
+    }
+  }
+
+  vtkDataArray* cellNormals = output->GetCellData()->GetNormals();
+  vtkIdType offset = output->GetNumberOfVerts();
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType cellId = offset; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    cellNormals->GetTuple(cellId, n);
+    output->GetCellPoints(cellId, cellPts);
+    output->GetPoint(cellPts->GetId(0), x);
+    if (std::abs(vtkMath::Norm(n) - 1.) > 1e-6 || vtkMath::Dot(n, x) <= 0.)
+    {
+      std::cerr << "Wrong normal at cell " << cellId << "." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Progress events of the polygon normal pass, aborting on the first one
+struct ProgressEvents
+{
+  int Count = 0;
+  int CountAfterAbort = 0;
+  bool OnMainThread = true;
+  std::thread::id MainThread = std::this_thread::get_id();
+};
+
+void AbortOnPolygonNormals(vtkObject* caller, unsigned long, void* clientData, void* callData)
+{
+  ProgressEvents* events = static_cast<ProgressEvents*>(clientData);
+  double progress = *static_cast<double*>(callData);
+  events->OnMainThread &= std::this_thread::get_id() == events->MainThread;
+  if (progress <= 0.333 || progress >= 0.5)
+  {
+    return;
+  }
+  vtkPolyDataNormals* normals = static_cast<vtkPolyDataNormals*>(caller);
+  if (normals->GetAbortExecute())
+  {
+    events->CountAfterAbort++;
+  }
+  events->Count++;
+  normals->AbortExecuteOn();
+}
+
+} // anonymous namespace
+
+int TestPolyDataNormals(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(12);
+  sphere->SetPhiResolution(12);
+  sphere->Update();
+
+  // Add a vertex cell so that polygon normals are stored after other cells,
+  // and point data to check attribute copy of split points.
+  vtkNew<vtkPolyData> input;
+  input->DeepCopy(sphere->GetOutput());
+  vtkNew<vtkCellArray> verts;
+  verts->InsertNextCell({ 0 });
+  input->SetVerts(verts);
+  vtkNew<vtkFloatArray> ids;
+  ids->SetName("Ids");
+  ids->SetNumberOfTuples(input->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    ids->SetValue(ptId, static_cast<float>(ptId));
+  }
+  input->GetPointData()->AddArray(ids);
+
+  for (bool splitting : { false, true })
+  {
+    auto outputs =
+      vtkTest::RunSequentialAndThreaded([&]() { return ComputeNormals(input, splitting); });
+
+    if (splitting && outputs.first->GetNumberOfPoints() <= input->GetNumberOfPoints())
+    {
+      std::cerr << "Expected points to be split." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!ValidNormals(input, outputs.first))
+    {
+      return EXIT_FAILURE;
+    }
+    if (!SameOutputs(outputs.first, outputs.second))
+    {
+      std::cerr << "Threaded output differs from sequential output (splitting "
+                << (splitting ? "on" : "off") << ")." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // With enough polygons for several chunks, the calling thread reports the
+  // progress of the polygon normals and stops at the first abort request.
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  ProgressEvents events;
+  vtkNew<vtkCallbackCommand> abortCommand;
+  abortCommand->SetCallback(AbortOnPolygonNormals);
+  abortCommand->SetClientData(&events);
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputConnection(sphere->GetOutputPort());
+  normals->AddObserver(vtkCommand::ProgressEvent, abortCommand);
+  vtkSMPTools::LocalScope(vtkTest::ThreadedConfig(), [&]() { normals->Update(); });
+  if (events.Count != 1 || events.CountAfterAbort != 0 || !events.OnMainThread)
+  {
+    std::cerr << "Expected a single polygon normal progress event on the main thread, got "
+              << events.Count << (events.OnMainThread ? "." : " not all on main thread.")
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
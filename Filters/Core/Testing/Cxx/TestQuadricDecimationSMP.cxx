@@ -0,0 +1,166 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimationSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the parallel collapse of vtkQuadricDecimation reaches the target
+// reduction with an error close to the serial one, preserves boundaries and
+// linear attributes, and that its output does not depend on the number of
+// threads.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkElevationFilter.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricDecimation.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTriangleFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+vtkSmartPointer<vtkQuadricDecimation> Decimate(vtkAlgorithm* source, bool parallel, bool attributes)
+{
+  vtkNew<vtkQuadricDecimation> decimation;
+  decimation->SetInputConnection(source->GetOutputPort());
+  decimation->SetTargetReduction(0.9);
+  decimation->SetParallelCollapse(parallel);
+  decimation->SetAttributeErrorMetric(attributes);
+  decimation->Update();
+  return decimation.GetPointer();
+}
+
+bool SameOutputs(vtkPolyData* output1, vtkPolyData* output2)
+{
+  return vtkTest::SameArrays(output1->GetPoints()->GetData(), output2->GetPoints()->GetData()) &&
+    vtkTest::SameArrays(
+      output1->GetPolys()->GetOffsetsArray(), output2->GetPolys()->GetOffsetsArray()) &&
+    vtkTest::SameArrays(
+      output1->GetPolys()->GetConnectivityArray(), output2->GetPolys()->GetConnectivityArray());
+}
+
+// Largest distance from the points used by the triangles to the sphere.
+double SphereError(vtkPolyData* output, double radius)
+{
+  double error = 0.0;
+  const vtkIdType* pts;
+  vtkIdType npts;
+  double x[3];
+  vtkCellArray* polys = output->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      output->GetPoint(pts[i], x);
+      error = std::max(error, std::abs(vtkMath::Norm(x) - radius));
+    }
+  }
+  return error;
+}
+
+} // anonymous namespace
+
+int TestQuadricDecimationSMP(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(1.0);
+  sphere->SetThetaResolution(120);
+  sphere->SetPhiResolution(120);
+
+  vtkSmartPointer<vtkQuadricDecimation> serial = Decimate(sphere, false, false);
+  auto decimations =
+    vtkTest::RunSequentialAndThreaded([&]() { return Decimate(sphere, true, false); });
+  vtkSmartPointer<vtkQuadricDecimation> sequential = decimations.first;
+  vtkSmartPointer<vtkQuadricDecimation> threaded = decimations.second;
+
+  if (!SameOutputs(sequential->GetOutput(), threaded->GetOutput()) ||
+    sequential->GetActualReduction() != threaded->GetActualReduction())
+  {
+    std::cerr << "Threaded output differs from sequential output." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (std::abs(threaded->GetActualReduction() - 0.9) > 0.01)
+  {
+    std::cerr << "Expected a reduction of 0.9, got " << threaded->GetActualReduction() << "."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  const double serialError = SphereError(serial->GetOutput(), 1.0);
+  const double parallelError = SphereError(threaded->GetOutput(), 1.0);
+  if (parallelError > 2.0 * serialError)
+  {
+    std::cerr << "Parallel collapse error " << parallelError << " is more than twice the serial "
+              << "error " << serialError << "." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // With a boundary and the attribute error metric.
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(60, 60);
+  vtkNew<vtkTriangleFilter> triangles;
+  triangles->SetInputConnection(plane->GetOutputPort());
+  vtkNew<vtkElevationFilter> elevation;
+  elevation->SetInputConnection(triangles->GetOutputPort());
+  elevation->SetLowPoint(-0.5, 0.0, 0.0);
+  elevation->SetHighPoint(0.5, 0.0, 0.0);
+
+  decimations =
+    vtkTest::RunSequentialAndThreaded([&]() { return Decimate(elevation, true, true); });
+  sequential = decimations.first;
+  threaded = decimations.second;
+  if (!SameOutputs(sequential->GetOutput(), threaded->GetOutput()) ||
+    sequential->GetActualReduction() != threaded->GetActualReduction() ||
+    !vtkTest::SameArrays(sequential->GetOutput()->GetPointData()->GetScalars(),
+      threaded->GetOutput()->GetPointData()->GetScalars()))
+  {
+    std::cerr << "Threaded output with attributes differs from sequential output." << std::endl;
+    return EXIT_FAILURE;
+  }
+  double bounds[6];
+  threaded->GetOutput()->GetBounds(bounds);
+  if (threaded->GetActualReduction() < 0.5 || bounds[0] != -0.5 || bounds[1] != 0.5 ||
+    bounds[2] != -0.5 || bounds[3] != 0.5)
+  {
+    std::cerr << "Wrong reduction " << threaded->GetActualReduction()
+              << " or boundary not preserved." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The points stay in the plane and the elevation, linear in x, stays
+  // consistent with their position.
+  vtkPolyData* output = threaded->GetOutput();
+  vtkDataArray* elevations = output->GetPointData()->GetScalars();
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    output->GetPoint(ptId, x);
+    if (std::abs(x[2]) > 1e-6 || std::abs(elevations->GetComponent(ptId, 0) - (x[0] + 0.5)) > 1e-3)
+    {
+      std::cerr << "Point " << ptId << " left the plane or has a wrong elevation." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSmoothPolyDataFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkSmoothPolyDataFilter gives the same result whatever the
+// number of threads, with and without ParallelSmoothing, that the parallel
+// smoothing stays close to the serial one, that it removes the noise of a
+// plane and that constrained smoothing keeps the points on the source.
+
+#include "vtkAppendPolyData.h"
+#include "vtkDataArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPlaneSource.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+#include "vtkSmoothPolyDataFilter.h"
+#include "vtkSphereSource.h"
+#include "vtkStripper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+vtkSmartPointer<vtkPolyData> Smooth(
+  vtkPolyData* input, vtkPolyData* source, bool parallel, bool featureEdges)
+{
+  vtkNew<vtkSmoothPolyDataFilter> smooth;
+  smooth->SetInputData(input);
+  if (source)
+  {
+    smooth->SetSourceData(source);
+  }
+  smooth->SetParallelSmoothing(parallel);
+  smooth->SetFeatureEdgeSmoothing(featureEdges);
+  smooth->SetNumberOfIterations(50);
+  smooth->SetRelaxationFactor(0.1);
+  smooth->Update();
+
+  vtkSmartPointer<vtkPolyData> output = smooth->GetOutput();
+  return output;
+}
+
+bool SamePoints(vtkPolyData* output1, vtkPolyData* output2)
+{
+  return vtkTest::SameArrays(output1->GetPoints()->GetData(), output2->GetPoints()->GetData());
+}
+
+double MaxDistance(vtkPolyData* output1, vtkPolyData* output2)
+{
+  double distance = 0.0;
+  double x1[3], x2[3];
+  for (vtkIdType i = 0; i < output1->GetNumberOfPoints(); ++i)
+  {
+    output1->GetPoint(i, x1);
+    output2->GetPoint(i, x2);
+    distance = std::max(distance, std::sqrt(vtkMath::Distance2BetweenPoints(x1, x2)));
+  }
+  return distance;
+}
+
+// Mean distance of the points from firstPt on to the plane z = 0.
+double MeanPlaneDistance(vtkPolyData* output, vtkIdType firstPt)
+{
+  double sum = 0.0;
+  for (vtkIdType i = firstPt; i < output->GetNumberOfPoints(); ++i)
+  {
+    sum += std::abs(output->GetPoint(i)[2]);
+  }
+  return sum / (output->GetNumberOfPoints() - firstPt);
+}
+
+// Largest distance of the points to the sphere of radius 0.5.
+double MaxSphereDistance(vtkPolyData* output)
+{
+  double distance = 0.0;
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    distance = std::max(distance, std::abs(vtkMath::Norm(output->GetPoint(i)) - 0.5));
+  }
+  return distance;
+}
+
+} // anonymous namespace
+
+int TestSmoothPolyDataFilterSMP(int, char*[])
+{
+  // A noisy sphere made of triangle strips, with an open plane, so that there
+  // are simple, feature edge, boundary and fixed vertices.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(80);
+  sphere->SetPhiResolution(60);
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkPlaneSource> plane;
+  plane->SetResolution(20, 20);
+  plane->SetCenter(2.0, 0.0, 0.0);
+  vtkNew<vtkAppendPolyData> append;
+  append->AddInputConnection(stripper->GetOutputPort());
+  append->AddInputConnection(plane->GetOutputPort());
+  append->Update();
+
+  vtkNew<vtkPolyData> input;
+  input->DeepCopy(append->GetOutput());
+  vtkMath::RandomSeed(8775070);
+  double x[3];
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+  {
+    input->GetPoint(i, x);
+    for (int k = 0; k < 3; ++k)
+    {
+      x[k] += vtkMath::Random(-0.01, 0.01);
+    }
+    input->GetPoints()->SetPoint(i, x);
+  }
+  const vtkIdType firstPlanePt = sphere->GetOutput()->GetNumberOfPoints();
+  const double noise = MeanPlaneDistance(input, firstPlanePt);
+
+  for (bool featureEdges : { false, true })
+  {
+    for (vtkPolyData* source : { static_cast<vtkPolyData*>(nullptr), sphere->GetOutput() })
+    {
+      auto outputs = vtkTest::RunSequentialAndThreaded(
+        [&]() { return Smooth(input, source, false, featureEdges); });
+      vtkSmartPointer<vtkPolyData> serial = outputs.first;
+      if (!SamePoints(serial, outputs.second))
+      {
+        std::cerr << "Threaded topological analysis changed the smoothing." << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      outputs = vtkTest::RunSequentialAndThreaded(
+        [&]() { return Smooth(input, source, true, featureEdges); });
+      if (!SamePoints(outputs.first, outputs.second))
+      {
+        std::cerr << "Parallel smoothing depends on the number of threads." << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      const double distance = MaxDistance(serial, outputs.second);
+      std::cout << "Feature edge smoothing " << featureEdges << ", source " << (source != nullptr)
+                << ": distance between serial and parallel smoothing " << distance << std::endl;
+      if (distance > 0.01)
+      {
+        std::cerr << "Parallel smoothing is too far from serial smoothing." << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      if (source && MaxSphereDistance(outputs.second) > 0.001)
+      {
+        std::cerr << "Constrained smoothing moved points off the source." << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!source && MeanPlaneDistance(outputs.second, firstPlanePt) > 0.5 * noise)
+      {
+        std::cerr << "Parallel smoothing did not remove the noise of the plane." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,209 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkThreshold keeps the cells satisfying its criterion, in the
+// input order, and produces the same output whatever the number of threads
+// used by vtkSMPTools, for point and cell scalars and all the component modes.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataObject.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreshold.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+const double Lower = -0.3;
+const double Upper = 0.4;
+
+// Whether the given tuple satisfies the criterion of the threshold filter
+bool Passes(vtkDataArray* array, vtkIdType id, int componentMode)
+{
+  const int numComps = array->GetNumberOfComponents();
+  int numPassed = 0;
+  for (int c = 0; c < numComps; ++c)
+  {
+    const double s = array->GetComponent(id, c);
+    numPassed += s >= Lower && s <= Upper ? 1 : 0;
+  }
+  switch (componentMode)
+  {
+    case VTK_COMPONENT_MODE_USE_ALL:
+      return numPassed == numComps;
+    case VTK_COMPONENT_MODE_USE_ANY:
+      return numPassed > 0;
+    default:
+      return array->GetComponent(id, 0) >= Lower && array->GetComponent(id, 0) <= Upper;
+  }
+}
+
+// Cell vectors of the input cells kept by the threshold filter, whose cells
+// pass when all their points do for point scalars.
+vtkSmartPointer<vtkDoubleArray> ReferenceCellVectors(
+  vtkDataSet* input, int association, const char* name, int componentMode, bool invert)
+{
+  vtkDataArray* cellVectors = input->GetCellData()->GetArray("CellVectors");
+  vtkSmartPointer<vtkDoubleArray> reference = vtkSmartPointer<vtkDoubleArray>::New();
+  reference->SetNumberOfComponents(cellVectors->GetNumberOfComponents());
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    bool keep = true;
+    if (association == vtkDataObject::FIELD_ASSOCIATION_POINTS)
+    {
+      vtkDataArray* scalars = input->GetPointData()->GetArray(name);
+      input->GetCellPoints(cellId, cellPts);
+      for (vtkIdType i = 0; keep && i < cellPts->GetNumberOfIds(); ++i)
+      {
+        keep = Passes(scalars, cellPts->GetId(i), componentMode);
+      }
+    }
+    else
+    {
+      keep = Passes(input->GetCellData()->GetArray(name), cellId, componentMode);
+    }
+    if (keep != invert)
+    {
+      reference->InsertNextTuple(cellVectors->GetTuple(cellId));
+    }
+  }
+  return reference;
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> Threshold(
+  vtkDataSet* input, int association, const char* name, int componentMode, bool invert)
+{
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputData(input);
+  threshold->SetInputArrayToProcess(0, 0, 0, association, name);
+  threshold->SetThresholdFunction(vtkThreshold::THRESHOLD_BETWEEN);
+  threshold->SetLowerThreshold(Lower);
+  threshold->SetUpperThreshold(Upper);
+  threshold->SetComponentMode(componentMode);
+  threshold->SetInvert(invert);
+  threshold->Update();
+
+  vtkSmartPointer<vtkUnstructuredGrid> output = threshold->GetOutput();
+  return output;
+}
+
+bool SameOutputs(vtkUnstructuredGrid* output1, vtkUnstructuredGrid* output2)
+{
+  return vtkTest::SameArrays(output1->GetPoints()->GetData(), output2->GetPoints()->GetData()) &&
+    vtkTest::SameArrays(
+      output1->GetCells()->GetOffsetsArray(), output2->GetCells()->GetOffsetsArray()) &&
+    vtkTest::SameArrays(output1->GetCells()->GetConnectivityArray(),
+      output2->GetCells()->GetConnectivityArray()) &&
+    vtkTest::SameArrays(output1->GetCellTypesArray(), output2->GetCellTypesArray()) &&
+    vtkTest::SameArrays(output1->GetPointData()->GetArray("Vectors"),
+      output2->GetPointData()->GetArray("Vectors")) &&
+    vtkTest::SameArrays(output1->GetCellData()->GetArray("CellVectors"),
+      output2->GetCellData()->GetArray("CellVectors"));
+}
+
+} // anonymous namespace
+
+int TestThresholdSMP(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-20, 20, -20, 20, -10, 10);
+  source->Update();
+
+  vtkNew<vtkImageData> input;
+  input->ShallowCopy(source->GetOutput());
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    vectors->SetTuple3(ptId, std::sin(0.01 * ptId), std::cos(0.03 * ptId), std::sin(0.05 * ptId));
+  }
+  input->GetPointData()->AddArray(vectors);
+  vtkNew<vtkDoubleArray> cellVectors;
+  cellVectors->SetName("CellVectors");
+  cellVectors->SetNumberOfComponents(2);
+  cellVectors->SetNumberOfTuples(numCells);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    cellVectors->SetTuple2(cellId, std::cos(0.02 * cellId), std::sin(0.07 * cellId));
+  }
+  input->GetCellData()->AddArray(cellVectors);
+
+  struct Scalars
+  {
+    int Association;
+    const char* Name;
+  };
+  const Scalars scalars[] = { { vtkDataObject::FIELD_ASSOCIATION_POINTS, "Vectors" },
+    { vtkDataObject::FIELD_ASSOCIATION_CELLS, "CellVectors" } };
+  const int componentModes[] = { VTK_COMPONENT_MODE_USE_SELECTED,
+    VTK_COMPONENT_MODE_USE_ALL, VTK_COMPONENT_MODE_USE_ANY };
+
+  for (const Scalars& s : scalars)
+  {
+    for (int componentMode : componentModes)
+    {
+      vtkIdType numThresholdedCells = 0;
+      for (bool invert : { false, true })
+      {
+        auto outputs = vtkTest::RunSequentialAndThreaded(
+          [&]() { return Threshold(input, s.Association, s.Name, componentMode, invert); });
+        vtkSmartPointer<vtkDoubleArray> reference =
+          ReferenceCellVectors(input, s.Association, s.Name, componentMode, invert);
+        if (!vtkTest::SameArrays(outputs.first->GetCellData()->GetArray("CellVectors"), reference))
+        {
+          std::cerr << "Wrong cells kept (" << s.Name << ", component mode " << componentMode
+                    << ", invert " << invert << ")." << std::endl;
+          return EXIT_FAILURE;
+        }
+        if (!SameOutputs(outputs.first, outputs.second))
+        {
+          std::cerr << "Threaded output differs from sequential output (" << s.Name
+                    << ", component mode " << componentMode << ", invert " << invert << ")."
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+        numThresholdedCells += outputs.second->GetNumberOfCells();
+      }
+
+      if (numThresholdedCells != numCells)
+      {
+        std::cerr << "Cell count and inverted cell count inconsistent (" << s.Name
+                  << ", component mode " << componentMode << ")." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
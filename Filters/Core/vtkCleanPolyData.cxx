@@ -21,6 +21,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
@@ -28,6 +29,7 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <unordered_map>
+#include <vector>
 
 vtkStandardNewMacro(vtkCleanPolyData);
 
@@ -47,6 +49,20 @@ bool InsertPointUsingGlobalId(vtkIdType globalId, vtkPoints* newPts,
   ptId = it->second;
   return false;
 }
+
+// Get the id of the next point merged by InsertUniquePoints(), the points
+// are numbered in the order of their first insertion
+bool InsertMergedPoint(const std::vector<vtkIdType>& mergedIds, vtkIdType& mergedIdx,
+  vtkIdType& numMergedPts, vtkIdType& ptId)
+{
+  ptId = mergedIds[mergedIdx++];
+  if (ptId == numMergedPts)
+  {
+    numMergedPts++;
+    return true;
+  }
+  return false;
+}
 } // anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -233,6 +249,40 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
   outputCD->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
   outputCD->CopyAllocate(inputCD);
 
+  // Without global ids, the points of all the cells are merged at once, in
+  // the order in which the cells are traversed below.
+  std::vector<vtkIdType> mergedIds;
+  vtkIdType mergedIdx = 0;
+  vtkIdType numMergedPts = 0;
+  if (this->PointMerging && !globalIdsArray)
+  {
+    std::vector<vtkIdType> cellPtIds;
+    cellPtIds.reserve(inVerts->GetNumberOfConnectivityIds() +
+      inLines->GetNumberOfConnectivityIds() + inPolys->GetNumberOfConnectivityIds() +
+      inStrips->GetNumberOfConnectivityIds());
+    for (vtkCellArray* cells : { inVerts, inLines, inPolys, inStrips })
+    {
+      for (cells->InitTraversal(); cells->GetNextCell(npts, pts);)
+      {
+        cellPtIds.insert(cellPtIds.end(), pts, pts + npts);
+      }
+    }
+
+    vtkNew<vtkPoints> operatedPts;
+    operatedPts->SetDataTypeToDouble();
+    operatedPts->SetNumberOfPoints(numPts);
+    for (i = 0; i < numPts; ++i)
+    {
+      inPts->GetPoint(i, x);
+      this->OperateOnPoint(x, newx);
+      operatedPts->SetPoint(i, newx);
+    }
+
+    mergedIds.resize(cellPtIds.size());
+    this->Locator->InsertUniquePoints(operatedPts, static_cast<vtkIdType>(cellPtIds.size()),
+      cellPtIds.data(), mergedIds.data());
+  }
+
   // Celldata needs to be copied correctly. If a poly is converted to
   // a line, or a line to a point, then using a CellCounter will not
   // do, as the cells should be ordered verts, lines, polys,
@@ -273,7 +323,7 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
         else if ((globalIdsArray &&
                    InsertPointUsingGlobalId(
                      globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
-          (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
+          (!globalIdsArray && InsertMergedPoint(mergedIds, mergedIdx, numMergedPts, ptId)))
         {
           outputPD->CopyData(inputPD, pts[i], ptId);
         }
@@ -322,7 +372,7 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
         else if ((globalIdsArray &&
                    InsertPointUsingGlobalId(
                      globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
-          (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
+          (!globalIdsArray && InsertMergedPoint(mergedIds, mergedIdx, numMergedPts, ptId)))
         {
           outputPD->CopyData(inputPD, pts[i], ptId);
         }
@@ -395,7 +445,7 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
         else if ((globalIdsArray &&
                    InsertPointUsingGlobalId(
                      globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
-          (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
+          (!globalIdsArray && InsertMergedPoint(mergedIds, mergedIdx, numMergedPts, ptId)))
         {
           outputPD->CopyData(inputPD, pts[i], ptId);
         }
@@ -489,7 +539,7 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
         else if ((globalIdsArray &&
                    InsertPointUsingGlobalId(
                      globalIdsArray->GetValue(pts[i]), newPts, addedGlobalIdsMap, newx, ptId)) ||
-          (!globalIdsArray && this->Locator->InsertUniquePoint(newx, ptId)))
+          (!globalIdsArray && InsertMergedPoint(mergedIds, mergedIdx, numMergedPts, ptId)))
         {
           outputPD->CopyData(inputPD, pts[i], ptId);
         }
@@ -0,0 +1,303 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectedRegionsInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConnectedRegionsInternal
+ * @brief   parallel labeling of the connected regions of a dataset
+ *
+ * vtkConnectedRegionsInternal labels the cells of a dataset with the number
+ * of the connected region they belong to, using vtkSMPTools and a lock-free
+ * union-find. Cells are connected through shared points. An optional
+ * criterion restricts the cells that can be reached from a neighbor (scalar
+ * connectivity); cells failing it still start a region of their own.
+ *
+ * The labeling is the one of a sequential wave propagation seeded by
+ * increasing cell ids: regions are numbered by increasing seed cell id, a
+ * region grows from its seed to all the cells satisfying the criterion that
+ * are reachable and not already part of a previous region. The result does
+ * not depend on the number of threads.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkConnectivityFilter vtkPolyDataConnectivityFilter
+ */
+
+#ifndef vtkConnectedRegionsInternal_h
+#define vtkConnectedRegionsInternal_h
+
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+//------------------------------------------------------------------------------
+// Lower an atomic value to v if v is smaller.
+void AtomicMin(std::atomic<vtkIdType>& value, vtkIdType v)
+{
+  vtkIdType current = value.load();
+  while (v < current && !value.compare_exchange_weak(current, v))
+  {
+  }
+}
+
+//------------------------------------------------------------------------------
+// Concurrent disjoint sets of ids. The larger root is always linked under the
+// smaller one, so the root of a set is its smallest id.
+class vtkConcurrentDisjointSets
+{
+public:
+  explicit vtkConcurrentDisjointSets(vtkIdType numIds)
+    : Parents(new std::atomic<vtkIdType>[numIds])
+  {
+    std::atomic<vtkIdType>* parents = this->Parents.get();
+    vtkSMPTools::For(0, numIds, [parents](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType id = begin; id < end; ++id)
+      {
+        parents[id].store(id, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  vtkIdType Find(vtkIdType id)
+  {
+    vtkIdType parent = this->Parents[id].load();
+    while (parent != id)
+    {
+      // Path halving. A failed exchange only means another thread already
+      // shortened the path.
+      vtkIdType grandParent = this->Parents[parent].load();
+      this->Parents[id].compare_exchange_weak(parent, grandParent);
+      id = grandParent;
+      parent = this->Parents[id].load();
+    }
+    return id;
+  }
+
+  void Union(vtkIdType id1, vtkIdType id2)
+  {
+    while (true)
+    {
+      id1 = this->Find(id1);
+      id2 = this->Find(id2);
+      if (id1 == id2)
+      {
+        return;
+      }
+      if (id1 < id2)
+      {
+        std::swap(id1, id2);
+      }
+      // Fails if id1 stopped being a root meanwhile: try again.
+      vtkIdType expected = id1;
+      if (this->Parents[id1].compare_exchange_strong(expected, id2))
+      {
+        return;
+      }
+    }
+  }
+
+private:
+  std::unique_ptr<std::atomic<vtkIdType>[]> Parents;
+};
+
+//------------------------------------------------------------------------------
+// Label the cells of the input with their region number (cellRegions, of
+// size the number of cells) and the points with the smallest region number
+// of the cells using them (pointRegions, of size the number of points, -1
+// for points not used by any cell). regionSizes receives the number of cells
+// of each region. Returns the number of regions.
+//
+// When criterion is not null, a cell can only be reached from a neighbor if
+// criterion(cellPointIds) returns true. It must be thread-safe.
+template <typename TCriterion>
+vtkIdType LabelConnectedRegions(vtkDataSet* input, const TCriterion* criterion,
+  vtkIdType* cellRegions, vtkIdType* pointRegions, vtkIdTypeArray* regionSizes)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  regionSizes->Reset();
+  if (numCells < 1)
+  {
+    std::fill_n(pointRegions, numPts, -1);
+    return 0;
+  }
+
+  // Build the internal structures needed by GetCellPoints while still
+  // single-threaded, so that later calls are thread-safe.
+  vtkNew<vtkIdList> cellPtIds;
+  input->GetCellPoints(0, cellPtIds);
+
+  vtkSMPThreadLocalObject<vtkIdList> tlCellPtIds;
+  std::vector<unsigned char> reachable(numCells, 1);
+  if (criterion)
+  {
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ptIds = tlCellPtIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        input->GetCellPoints(cellId, ptIds);
+        reachable[cellId] = (*criterion)(ptIds) ? 1 : 0;
+      }
+    });
+  }
+
+  // Join the reachable cells sharing a point. The first reachable cell to
+  // claim a point represents it.
+  std::unique_ptr<std::atomic<vtkIdType>[]> pointCells(new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      pointCells[ptId].store(-1, std::memory_order_relaxed);
+    }
+  });
+  vtkConcurrentDisjointSets sets(numCells);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ptIds = tlCellPtIds.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (!reachable[cellId])
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, ptIds);
+      for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+      {
+        vtkIdType other = -1;
+        if (!pointCells[ptIds->GetId(i)].compare_exchange_strong(other, cellId))
+        {
+          sets.Union(cellId, other);
+        }
+      }
+    }
+  });
+
+  // A set of reachable cells belongs to the region of its smallest cell,
+  // unless a smaller unreachable cell touches it: the wave started from that
+  // cell grabs the whole set first.
+  std::unique_ptr<std::atomic<vtkIdType>[]> owners;
+  if (criterion)
+  {
+    owners.reset(new std::atomic<vtkIdType>[numCells]);
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        owners[cellId].store(cellId, std::memory_order_relaxed);
+      }
+    });
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* ptIds = tlCellPtIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (reachable[cellId])
+        {
+          continue;
+        }
+        input->GetCellPoints(cellId, ptIds);
+        for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+        {
+          const vtkIdType other = pointCells[ptIds->GetId(i)].load();
+          if (other >= 0)
+          {
+            AtomicMin(owners[sets.Find(other)], cellId);
+          }
+        }
+      }
+    });
+  }
+
+  // Seed cell of each cell. It is never larger than the cell itself.
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (!reachable[cellId])
+      {
+        cellRegions[cellId] = cellId;
+      }
+      else
+      {
+        const vtkIdType root = sets.Find(cellId);
+        cellRegions[cellId] = owners ? owners[root].load() : root;
+      }
+    }
+  });
+
+  // Number the regions by increasing seed id.
+  std::vector<vtkIdType> sizes;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    const vtkIdType seed = cellRegions[cellId];
+    if (seed == cellId)
+    {
+      cellRegions[cellId] = static_cast<vtkIdType>(sizes.size());
+      sizes.push_back(0);
+    }
+    else
+    {
+      cellRegions[cellId] = cellRegions[seed];
+    }
+    ++sizes[cellRegions[cellId]];
+  }
+  const vtkIdType numRegions = static_cast<vtkIdType>(sizes.size());
+  regionSizes->SetNumberOfValues(numRegions);
+  std::copy(sizes.begin(), sizes.end(), regionSizes->GetPointer(0));
+
+  // Points take the first region reaching them.
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      pointCells[ptId].store(VTK_ID_MAX, std::memory_order_relaxed);
+    }
+  });
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* ptIds = tlCellPtIds.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      input->GetCellPoints(cellId, ptIds);
+      for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+      {
+        AtomicMin(pointCells[ptIds->GetId(i)], cellRegions[cellId]);
+      }
+    }
+  });
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const vtkIdType region = pointCells[ptId].load(std::memory_order_relaxed);
+      pointRegions[ptId] = region == VTK_ID_MAX ? -1 : region;
+    }
+  });
+
+  return numRegions;
+}
+
+} // anonymous namespace
+
+#endif // vtkConnectedRegionsInternal_h
+// VTK-HeaderTest-Exclude: vtkConnectedRegionsInternal.h
@@ -16,6 +16,7 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectedRegionsInternal.h"
 #include "vtkDataSet.h"
 #include "vtkDemandDrivenPipeline.h"
 #include "vtkFloatArray.h"
@@ -31,9 +32,36 @@
 #include "vtkUnstructuredGrid.h"
 
 #include <map>
+#include <vector>
 
 vtkObjectFactoryNewMacro(vtkConnectivityFilter);
 
+namespace
+{
+
+// Scalar connectivity criterion: a cell is connected when the range of its
+// point scalars intersects the scalar range.
+struct ScalarCriterion
+{
+  vtkDataArray* Scalars;
+  double Range[2];
+
+  bool operator()(vtkIdList* ptIds) const
+  {
+    double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      // Scalars are compared in single precision, as they always were.
+      const double s = static_cast<float>(this->Scalars->GetComponent(ptIds->GetId(i), 0));
+      range[0] = s < range[0] ? s : range[0];
+      range[1] = s > range[1] ? s : range[1];
+    }
+    return range[1] >= this->Range[0] && range[0] <= this->Range[1];
+  }
+};
+
+} // anonymous namespace
+
 // Construct with default extraction mode to extract largest regions.
 vtkConnectivityFilter::vtkConnectivityFilter()
 {
@@ -240,31 +268,44 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
   if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION)
-  { // visit all cells marking with region number
-    for (cellId = 0; cellId < numCells; cellId++)
+  { // label all cells with their region number, in parallel
+    std::vector<vtkIdType> pointRegions(numPts);
+    if (this->InScalars)
     {
-      if (cellId && !(cellId % 5000))
+      const ScalarCriterion criterion{ this->InScalars,
+        { this->ScalarRange[0], this->ScalarRange[1] } };
+      this->RegionNumber = ::LabelConnectedRegions(
+        input, &criterion, this->Visited, pointRegions.data(), this->RegionSizes);
+    }
+    else
+    {
+      this->RegionNumber = ::LabelConnectedRegions<ScalarCriterion>(
+        input, nullptr, this->Visited, pointRegions.data(), this->RegionSizes);
+    }
+    this->UpdateProgress(0.8);
+
+    for (i = 0; i < this->RegionNumber; i++)
+    {
+      if (this->RegionSizes->GetValue(i) > maxCellsInRegion)
       {
-        this->UpdateProgress(0.1 + 0.8 * cellId / numCells);
+        maxCellsInRegion = this->RegionSizes->GetValue(i);
+        largestRegionId = i;
       }
-
-      if (this->Visited[cellId] < 0)
+    }
+    for (cellId = 0; cellId < numCells; cellId++)
+    {
+      this->NewCellScalars->SetValue(cellId, this->Visited[cellId]);
+    }
+    // Output points are ordered by increasing input point id.
+    for (i = 0; i < numPts; i++)
+    {
+      if (pointRegions[i] >= 0)
       {
-        this->NumCellsInRegion = 0;
-        this->Wave->InsertNextId(cellId);
-        this->TraverseAndMark(input);
-
-        if (this->NumCellsInRegion > maxCellsInRegion)
-        {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
-        }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++, this->NumCellsInRegion);
-        this->Wave->Reset();
-        this->Wave2->Reset();
+        this->PointMap[i] = this->PointNumber++;
+        this->NewScalars->SetValue(this->PointMap[i], pointRegions[i]);
       }
     }
+    this->UpdateProgress(0.9);
   }
   else // regions have been seeded, everything considered in same region
   {
@@ -50,6 +50,11 @@
  * was processed and has no other significance with respect to the size of
  * or number of cells.
  *
+ * When regions are not seeded (largest, specified or all regions), they are
+ * labeled in parallel using vtkSMPTools. Regions are numbered by increasing
+ * smallest cell id and output points are ordered by increasing input point
+ * id, so the output does not depend on the number of threads.
+ *
  * @sa
  * vtkPolyDataConnectivityFilter
  */
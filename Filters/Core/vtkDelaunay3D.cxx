@@ -15,6 +15,7 @@
 
 #include "vtkDelaunay3D.h"
 
+#include "vtkCellArray.h"
 #include "vtkEdgeTable.h"
 #include "vtkExecutive.h"
 #include "vtkIncrementalPointLocator.h"
@@ -25,10 +26,16 @@
 #include "vtkPointData.h"
 #include "vtkPointLocator.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkTetra.h"
 #include "vtkTriangle.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 vtkStandardNewMacro(vtkDelaunay3D);
 
 //------------------------------------------------------------------------------
@@ -138,6 +145,7 @@ vtkDelaunay3D::vtkDelaunay3D()
   this->BoundingTriangulation = 0;
   this->Offset = 2.5;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->ParallelInsertion = 0;
   this->Locator = nullptr;
   this->TetraArray = nullptr;
 
@@ -169,6 +177,170 @@ vtkDelaunay3D::~vtkDelaunay3D()
 // special method for performance
 static int GetTetraFaceNeighbor(vtkUnstructuredGrid* Mesh, vtkIdType tetraId, vtkIdType p1,
   vtkIdType p2, vtkIdType p3, vtkIdType& nei);
+static int InTetraSphere(vtkTetraArray* tetraArray, const double x[3], vtkIdType tetraId);
+
+namespace
+{
+// What the search for the insertion cavity of a point found.
+enum vtkDelaunayCavityStatus
+{
+  CAVITY_FOUND,
+  CAVITY_DUPLICATE_POINT,
+  CAVITY_DEGENERACY
+};
+
+// Insertion cavity of a point: the tetrahedra violating the Delaunay
+// criterion, the faces bounding them, and all the tetrahedra checked to find
+// them (the cavity and its face neighbors). The latter must not be modified
+// by another insertion for the cavity to remain valid.
+struct vtkDelaunayCavity
+{
+  int Status;
+  std::vector<vtkIdType> Tetras;
+  std::vector<vtkIdType> Faces;
+  std::vector<vtkIdType> Checked;
+};
+
+//------------------------------------------------------------------------------
+// Same walk as vtkDelaunay3D::FindTetra(), without using the cell of the mesh
+// so that it can run concurrently.
+vtkIdType LocateTetra(vtkUnstructuredGrid* Mesh, vtkPoints* points, double x[3], vtkIdType tetraId)
+{
+  double p[4][3];
+  double b[4];
+  vtkIdType tetraPts[4];
+  vtkIdType npts;
+  const vtkIdType* pts;
+
+  // prevent aimless wandering
+  for (int depth = 0; depth <= 200; depth++)
+  {
+    Mesh->GetCellPoints(tetraId, npts, pts);
+    for (int j = 0; j < 4; j++)
+    {
+      tetraPts[j] = pts[j];
+      points->GetPoint(tetraPts[j], p[j]);
+    }
+    vtkTetra::BarycentricCoords(x, p[0], p[1], p[2], p[3], b);
+
+    // find the most negative face
+    int neg = -1;
+    double negValue = VTK_DOUBLE_MAX;
+    for (int j = 0; j < 4; j++)
+    {
+      if (b[j] < 0.0 && b[j] < negValue)
+      {
+        negValue = b[j];
+        neg = j;
+      }
+    }
+
+    // if no negatives, then inside this tetra
+    if (neg < 0)
+    {
+      return tetraId;
+    }
+
+    // march towards the most negative direction
+    vtkIdType face[3];
+    for (int j = 0, k = 0; j < 4; j++)
+    {
+      if (j != neg)
+      {
+        face[k++] = tetraPts[j];
+      }
+    }
+    if (!GetTetraFaceNeighbor(Mesh, tetraId, face[0], face[1], face[2], tetraId))
+    {
+      return -1;
+    }
+  }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+// Same search as vtkDelaunay3D::FindEnclosingFaces(), but the mesh, the
+// circumspheres and the locator are only read so that cavities of several
+// points can be searched concurrently.
+int FindCavity(vtkUnstructuredGrid* Mesh, vtkPoints* points, vtkTetraArray* tetraArray,
+  vtkIncrementalPointLocator* locator, double x[3], vtkDelaunayCavity& cavity)
+{
+  // faces in counterclockwise order when viewed from the center of the cell
+  static const int faces[4][3] = { { 0, 1, 2 }, { 1, 3, 2 }, { 2, 3, 0 }, { 3, 1, 0 } };
+
+  cavity.Tetras.clear();
+  cavity.Faces.clear();
+  cavity.Checked.clear();
+
+  if (locator->IsInsertedPoint(x) >= 0)
+  {
+    return CAVITY_DUPLICATE_POINT;
+  }
+
+  vtkIdType closestPoint = locator->FindClosestInsertedPoint(x);
+  vtkCellLinks* links = static_cast<vtkCellLinks*>(Mesh->GetCellLinks());
+  if (closestPoint < 0 || links->GetNcells(closestPoint) <= 0)
+  {
+    return CAVITY_DEGENERACY;
+  }
+  vtkIdType tetraId = LocateTetra(Mesh, points, x, links->GetCells(closestPoint)[0]);
+  if (tetraId < 0)
+  {
+    return CAVITY_DEGENERACY;
+  }
+  cavity.Tetras.push_back(tetraId);
+  cavity.Checked.push_back(tetraId);
+
+  vtkIdType npts;
+  const vtkIdType* pts;
+  vtkIdType tetraPts[4];
+  vtkIdType nei;
+  for (size_t i = 0; i < cavity.Tetras.size(); i++)
+  {
+    tetraId = cavity.Tetras[i];
+    Mesh->GetCellPoints(tetraId, npts, pts);
+    std::copy(pts, pts + 4, tetraPts);
+    for (int j = 0; j < 4; j++)
+    {
+      const vtkIdType p1 = tetraPts[faces[j][0]];
+      const vtkIdType p2 = tetraPts[faces[j][1]];
+      const vtkIdType p3 = tetraPts[faces[j][2]];
+      bool insertFace = false;
+      if (!GetTetraFaceNeighbor(Mesh, tetraId, p1, p2, p3, nei)) // a boundary face
+      {
+        insertFace = true;
+      }
+      else if (std::find(cavity.Checked.begin(), cavity.Checked.end(), nei) ==
+        cavity.Checked.end())
+      {
+        if (InTetraSphere(tetraArray, x, nei))
+        {
+          cavity.Tetras.push_back(nei);
+        }
+        else
+        {
+          insertFace = true;
+        }
+        cavity.Checked.push_back(nei);
+      }
+      else if (std::find(cavity.Tetras.begin(), cavity.Tetras.end(), nei) == cavity.Tetras.end())
+      {
+        insertFace = true; // checked but not deleted
+      }
+
+      if (insertFace)
+      {
+        cavity.Faces.push_back(p1);
+        cavity.Faces.push_back(p2);
+        cavity.Faces.push_back(p3);
+      }
+    }
+  }
+  // A cavity without boundary faces cannot be filled: the point is dropped,
+  // as by the serial insertion.
+  return cavity.Faces.empty() ? CAVITY_DEGENERACY : CAVITY_FOUND;
+}
+}
 
 //------------------------------------------------------------------------------
 // Find all faces that enclose a point. (Enclosure means not satisfying
@@ -484,29 +656,37 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
 
   points->Allocate(numPoints + 6);
 
-  Mesh = this->InitPointInsertion(center, this->Offset * tol, numPoints, points);
+  Mesh =
+    this->InitPointInsertion(center, this->Offset * tol, numPoints, points, input->GetBounds());
 
   // Insert each point into triangulation. Points laying "inside"
   // of tetra cause tetra to be deleted, leaving a void with bounding
   // faces. Combination of point and each face is used to form new
   // tetrahedra.
-  for (ptId = 0; ptId < numPoints; ptId++)
+  if (this->ParallelInsertion)
+  {
+    this->ParallelInsertPoints(Mesh, points, inPoints, holeTetras);
+  }
+  else
   {
-    inPoints->GetPoint(ptId, x);
+    for (ptId = 0; ptId < numPoints; ptId++)
+    {
+      inPoints->GetPoint(ptId, x);
 
-    this->InsertPoint(Mesh, points, ptId, x, holeTetras);
+      this->InsertPoint(Mesh, points, ptId, x, holeTetras);
 
-    if (!(ptId % 250))
-    {
-      vtkDebugMacro(<< "point #" << ptId);
-      this->UpdateProgress(static_cast<double>(ptId) / numPoints);
-      if (this->GetAbortExecute())
+      if (!(ptId % 250))
       {
-        break;
+        vtkDebugMacro(<< "point #" << ptId);
+        this->UpdateProgress(static_cast<double>(ptId) / numPoints);
+        if (this->GetAbortExecute())
+        {
+          break;
+        }
       }
-    }
 
-  } // for all points
+    } // for all points
+  }
 
   this->EndPointInsertion();
 
@@ -778,6 +958,16 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
 // you will be inserting points between (0,numPtsToInsert-1).
 vtkUnstructuredGrid* vtkDelaunay3D::InitPointInsertion(
   double center[3], double length, vtkIdType numPtsToInsert, vtkPoints*& points)
+{
+  return this->InitPointInsertion(center, length, numPtsToInsert, points, nullptr);
+}
+
+//------------------------------------------------------------------------------
+// When the bounds of the points to insert are known, the locator only covers
+// them, with buckets sized for the number of points. Covering the whole
+// bounding octahedron would leave most of the points in a few buckets.
+vtkUnstructuredGrid* vtkDelaunay3D::InitPointInsertion(double center[3], double length,
+  vtkIdType numPtsToInsert, vtkPoints*& points, const double* pointBounds)
 {
   double x[3], bounds[6];
   vtkIdType tetraId;
@@ -803,7 +993,14 @@ vtkUnstructuredGrid* vtkDelaunay3D::InitPointInsertion(
   {
     this->CreateDefaultLocator();
   }
-  this->Locator->InitPointInsertion(points, bounds);
+  if (pointBounds)
+  {
+    this->Locator->InitPointInsertion(points, pointBounds, numPtsToInsert);
+  }
+  else
+  {
+    this->Locator->InitPointInsertion(points, bounds);
+  }
 
   // create bounding octahedron: 6 points & 4 tetra
   x[0] = center[0] - length;
@@ -894,10 +1091,7 @@ vtkUnstructuredGrid* vtkDelaunay3D::InitPointInsertion(
 void vtkDelaunay3D::InsertPoint(
   vtkUnstructuredGrid* Mesh, vtkPoints* points, vtkIdType ptId, double x[3], vtkIdList* holeTetras)
 {
-  vtkIdType tetraId, numFaces;
-  int i;
-  vtkIdType nodes[4];
-  vtkIdType tetraNum, numTetras;
+  vtkIdType numFaces;
 
   this->Tetras->Reset();
   this->Faces->Reset();
@@ -911,58 +1105,235 @@ void vtkDelaunay3D::InsertPoint(
   if ((numFaces = this->FindEnclosingFaces(x, Mesh, this->Tetras, this->Faces, this->Locator)) > 0)
   {
     this->Locator->InsertPoint(ptId, x); // point is part of mesh now
-    numTetras = this->Tetras->GetNumberOfIds();
+    this->CreateTetras(Mesh, points, ptId, numFaces, holeTetras);
+  } // if enclosing faces found
+}
 
-    // create new tetra for each face
-    for (tetraNum = 0; tetraNum < numFaces; tetraNum++)
+//------------------------------------------------------------------------------
+// Fill the cavity left by the tetrahedra deleted for point ptId: create a
+// tetrahedron from the point and each face bounding the cavity.
+void vtkDelaunay3D::CreateTetras(vtkUnstructuredGrid* Mesh, vtkPoints* points, vtkIdType ptId,
+  vtkIdType numFaces, vtkIdList* holeTetras)
+{
+  vtkIdType tetraId;
+  int i;
+  vtkIdType nodes[4];
+  vtkIdType tetraNum, numTetras;
+
+  numTetras = this->Tetras->GetNumberOfIds();
+
+  // create new tetra for each face
+  for (tetraNum = 0; tetraNum < numFaces; tetraNum++)
+  {
+    // Define tetrahedron.  The order of the points matters: points
+    // 0, 1, and 2 must appear in counterclockwise order when seen
+    // from point 3.  When we get here, point ptId is inside the
+    // tetrahedron whose faces we're considering and we've
+    // guaranteed that the 3 points in this face are
+    // counterclockwise wrt the new point.  That lets us create a
+    // new tetrahedron with the right ordering.
+    nodes[0] = this->Faces->GetId(3 * tetraNum);
+    nodes[1] = this->Faces->GetId(3 * tetraNum + 1);
+    nodes[2] = this->Faces->GetId(3 * tetraNum + 2);
+    nodes[3] = ptId;
+
+    // either replace previously deleted tetra or create new one
+    if (tetraNum < numTetras)
     {
-      // Define tetrahedron.  The order of the points matters: points
-      // 0, 1, and 2 must appear in counterclockwise order when seen
-      // from point 3.  When we get here, point ptId is inside the
-      // tetrahedron whose faces we're considering and we've
-      // guaranteed that the 3 points in this face are
-      // counterclockwise wrt the new point.  That lets us create a
-      // new tetrahedron with the right ordering.
-      nodes[0] = this->Faces->GetId(3 * tetraNum);
-      nodes[1] = this->Faces->GetId(3 * tetraNum + 1);
-      nodes[2] = this->Faces->GetId(3 * tetraNum + 2);
-      nodes[3] = ptId;
-
-      // either replace previously deleted tetra or create new one
-      if (tetraNum < numTetras)
+      tetraId = this->Tetras->GetId(tetraNum);
+      Mesh->ReplaceCell(tetraId, 4, nodes);
+    }
+    else
+    {
+      tetraId = Mesh->InsertNextCell(VTK_TETRA, 4, nodes);
+    }
+
+    // Update data structures
+    for (i = 0; i < 4; i++)
+    {
+      if (this->References[nodes[i]] >= 0)
       {
-        tetraId = this->Tetras->GetId(tetraNum);
-        Mesh->ReplaceCell(tetraId, 4, nodes);
+        Mesh->ResizeCellList(nodes[i], 5);
+        this->References[nodes[i]] -= 5;
       }
-      else
+      this->References[nodes[i]]++;
+      Mesh->AddReferenceToCell(nodes[i], tetraId);
+    }
+
+    this->InsertTetra(Mesh, points, tetraId);
+
+  } // for each face
+
+  // Sometimes there are more tetras deleted than created. These
+  // have to be accounted for because they leave a "hole" in the
+  // data structure. Keep track of them here...mark them deleted later.
+  for (tetraNum = numFaces; tetraNum < numTetras; tetraNum++)
+  {
+    holeTetras->InsertNextId(this->Tetras->GetId(tetraNum));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Parallel insertion. Each round takes a batch of points in input order and
+// searches their cavities concurrently in the current mesh. Each point then
+// claims the tetrahedra checked for its cavity; the first point in the batch
+// wins a conflict. The points that won all their claims are inserted one after
+// the other: their cavities and the tetrahedra around them are disjoint, so
+// inserting one does not change the cavity of the others, and the result is
+// the same as if they had been inserted serially. The other points are tried
+// again in the next round. Nothing depends on the number of threads.
+void vtkDelaunay3D::ParallelInsertPoints(
+  vtkUnstructuredGrid* Mesh, vtkPoints* points, vtkPoints* inPoints, vtkIdList* holeTetras)
+{
+  // Rounds are kept small enough for most of the points to be inserted: the
+  // next batch is a quarter larger than the number of points just inserted.
+  static const vtkIdType maxBatchSize = 4096;
+
+  // The cavities are searched concurrently: the cell points must be read
+  // without using a temporary buffer.
+  vtkCellArray* meshCells = Mesh->GetCells();
+  if (!meshCells->IsStorageShareable())
+  {
+    meshCells->ConvertToDefaultStorage();
+  }
+
+  const vtkIdType numPoints = inPoints->GetNumberOfPoints();
+  vtkTetraArray* tetraArray = this->TetraArray;
+  vtkIncrementalPointLocator* locator = this->Locator;
+  std::vector<vtkIdType> batch;
+  std::vector<vtkIdType> deferred;
+  std::vector<vtkDelaunayCavity> cavities;
+  std::vector<char> inserted;
+  std::unique_ptr<std::atomic<vtkIdType>[]> claims;
+  vtkIdType numClaims = 0;
+  vtkIdType batchSize = 1;
+  vtkIdType numProcessed = 0;
+  vtkIdType nextPtId = 0;
+
+  while (!batch.empty() || nextPtId < numPoints)
+  {
+    while (static_cast<vtkIdType>(batch.size()) < batchSize && nextPtId < numPoints)
+    {
+      batch.push_back(nextPtId++);
+    }
+    const vtkIdType numCandidates = static_cast<vtkIdType>(batch.size());
+    if (static_cast<vtkIdType>(cavities.size()) < numCandidates)
+    {
+      cavities.resize(numCandidates);
+    }
+    inserted.assign(numCandidates, 0);
+
+    vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+      double x[3];
+      for (vtkIdType i = begin; i < end; i++)
       {
-        tetraId = Mesh->InsertNextCell(VTK_TETRA, 4, nodes);
+        inPoints->GetPoint(batch[i], x);
+        cavities[i].Status = FindCavity(Mesh, points, tetraArray, locator, x, cavities[i]);
       }
+    });
 
-      // Update data structures
-      for (i = 0; i < 4; i++)
+    // Claim the checked tetrahedra; the smallest index in the batch wins.
+    if (numClaims < Mesh->GetNumberOfCells())
+    {
+      numClaims = 2 * Mesh->GetNumberOfCells();
+      claims.reset(new std::atomic<vtkIdType>[numClaims]);
+    }
+    vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; i++)
       {
-        if (this->References[nodes[i]] >= 0)
+        for (vtkIdType tetraId : cavities[i].Checked)
         {
-          Mesh->ResizeCellList(nodes[i], 5);
-          this->References[nodes[i]] -= 5;
+          claims[tetraId] = VTK_ID_MAX;
         }
-        this->References[nodes[i]]++;
-        Mesh->AddReferenceToCell(nodes[i], tetraId);
       }
+    });
+    vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; i++)
+      {
+        for (vtkIdType tetraId : cavities[i].Checked)
+        {
+          vtkIdType claim = claims[tetraId];
+          while (i < claim && !claims[tetraId].compare_exchange_weak(claim, i))
+          {
+          }
+        }
+      }
+    });
+    vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; i++)
+      {
+        const std::vector<vtkIdType>& checked = cavities[i].Checked;
+        inserted[i] = cavities[i].Status == CAVITY_FOUND &&
+          std::all_of(checked.begin(), checked.end(),
+            [&](vtkIdType tetraId) { return claims[tetraId] == i; });
+      }
+    });
 
-      this->InsertTetra(Mesh, points, tetraId);
+    // Insert the winners in batch order, defer the others.
+    vtkIdType numInserted = 0;
+    deferred.clear();
+    for (vtkIdType i = 0; i < numCandidates; i++)
+    {
+      const vtkDelaunayCavity& cavity = cavities[i];
+      const vtkIdType ptId = batch[i];
+      if (cavity.Status == CAVITY_DUPLICATE_POINT)
+      {
+        this->NumberOfDuplicatePoints++;
+        continue;
+      }
+      if (cavity.Status == CAVITY_DEGENERACY)
+      {
+        this->NumberOfDegeneracies++;
+        continue;
+      }
+      if (!inserted[i])
+      {
+        deferred.push_back(ptId);
+        continue;
+      }
 
-    } // for each face
+      // The point may be coincident with a point inserted in this round.
+      double x[3];
+      inPoints->GetPoint(ptId, x);
+      if (this->Locator->IsInsertedPoint(x) >= 0)
+      {
+        this->NumberOfDuplicatePoints++;
+        continue;
+      }
+
+      vtkIdType npts;
+      const vtkIdType* tetraPts;
+      this->Tetras->SetNumberOfIds(static_cast<vtkIdType>(cavity.Tetras.size()));
+      for (size_t j = 0; j < cavity.Tetras.size(); j++)
+      {
+        const vtkIdType tetraId = cavity.Tetras[j];
+        this->Tetras->SetId(static_cast<vtkIdType>(j), tetraId);
+        Mesh->GetCellPoints(tetraId, npts, tetraPts);
+        for (int k = 0; k < 4; k++)
+        {
+          this->References[tetraPts[k]]--;
+          Mesh->RemoveReferenceToCell(tetraPts[k], tetraId);
+        }
+      }
+      this->Faces->SetNumberOfIds(static_cast<vtkIdType>(cavity.Faces.size()));
+      std::copy(cavity.Faces.begin(), cavity.Faces.end(), this->Faces->GetPointer(0));
 
-    // Sometimes there are more tetras deleted than created. These
-    // have to be accounted for because they leave a "hole" in the
-    // data structure. Keep track of them here...mark them deleted later.
-    for (tetraNum = numFaces; tetraNum < numTetras; tetraNum++)
+      this->Locator->InsertPoint(ptId, x);
+      this->CreateTetras(Mesh, points, ptId, this->Faces->GetNumberOfIds() / 3, holeTetras);
+      numInserted++;
+    }
+
+    numProcessed += numCandidates - static_cast<vtkIdType>(deferred.size());
+    batch.swap(deferred);
+    batchSize = std::min(numInserted + numInserted / 4 + 1, maxBatchSize);
+
+    vtkDebugMacro(<< numInserted << " of " << numCandidates << " points inserted in round");
+    this->UpdateProgress(static_cast<double>(numProcessed) / numPoints);
+    if (this->GetAbortExecute())
     {
-      holeTetras->InsertNextId(this->Tetras->GetId(tetraNum));
+      break;
     }
-  } // if enclosing faces found
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -1001,9 +1372,15 @@ void vtkDelaunay3D::CreateDefaultLocator()
 //------------------------------------------------------------------------------
 // See whether point is in sphere of tetrahedron
 int vtkDelaunay3D::InSphere(double x[3], vtkIdType tetraId)
+{
+  return InTetraSphere(this->TetraArray, x, tetraId);
+}
+
+//------------------------------------------------------------------------------
+static int InTetraSphere(vtkTetraArray* tetraArray, const double x[3], vtkIdType tetraId)
 {
   double dist2;
-  vtkDelaunayTetra* tetra = this->TetraArray->GetTetra(tetraId);
+  vtkDelaunayTetra* tetra = tetraArray->GetTetra(tetraId);
 
   // check if inside/outside circumcircle
   dist2 = (x[0] - tetra->center[0]) * (x[0] - tetra->center[0]) +
@@ -1051,6 +1428,7 @@ void vtkDelaunay3D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Tolerance: " << this->Tolerance << "\n";
   os << indent << "Offset: " << this->Offset << "\n";
   os << indent << "Bounding Triangulation: " << (this->BoundingTriangulation ? "On\n" : "Off\n");
+  os << indent << "Parallel Insertion: " << (this->ParallelInsertion ? "On\n" : "Off\n");
 
   if (this->Locator)
   {
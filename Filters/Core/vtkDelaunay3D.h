@@ -87,6 +87,13 @@
  * will be found. However, in degenerate cases an enclosing tetrahedron may
  * not be found and the point will be rejected.
  *
+ * @warning
+ * With ParallelInsertion on, the points are inserted in rounds, and the
+ * insertions that do not interfere are carried out together. The output is
+ * still a Delaunay triangulation and does not depend on the number of
+ * threads, but its cells are ordered differently than in the serial
+ * insertion, and degenerate cases may be triangulated differently.
+ *
  * @sa
  * vtkDelaunay2D vtkGaussianSplatter vtkUnstructuredGrid
  */
@@ -197,6 +204,21 @@ public:
   vtkBooleanMacro(BoundingTriangulation, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Turn on/off the parallel insertion of the points. When on, the points
+   * are inserted in rounds: the insertion cavities (the tetrahedra violating
+   * the Delaunay criterion) of a batch of points are searched concurrently
+   * with vtkSMPTools, then the points whose cavities do not touch each other
+   * are inserted and the others are tried again in the next round. The
+   * locator must support concurrent queries, as vtkPointLocator and
+   * vtkMergePoints do. Off by default.
+   */
+  vtkSetMacro(ParallelInsertion, vtkTypeBool);
+  vtkGetMacro(ParallelInsertion, vtkTypeBool);
+  vtkBooleanMacro(ParallelInsertion, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Set / get a spatial locator for merging points. By default,
@@ -269,6 +291,11 @@ protected:
 
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  // Same as the public InitPointInsertion(), the locator being initialized
+  // with the bounds of the points to insert when pointBounds is given.
+  vtkUnstructuredGrid* InitPointInsertion(double center[3], double length, vtkIdType numPts,
+    vtkPoints*& points, const double* pointBounds);
+
   double Alpha;
   vtkTypeBool AlphaTets;
   vtkTypeBool AlphaTris;
@@ -278,6 +305,7 @@ protected:
   vtkTypeBool BoundingTriangulation;
   double Offset;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelInsertion;
 
   vtkIncrementalPointLocator* Locator; // help locate points faster
 
@@ -295,6 +323,15 @@ protected:
   vtkIdType FindEnclosingFaces(double x[3], vtkUnstructuredGrid* Mesh, vtkIdList* tetras,
     vtkIdList* faces, vtkIncrementalPointLocator* Locator);
 
+  // Create a tetrahedron from the point and each of the first numFaces faces
+  // in Faces, replacing the deleted tetrahedra listed in Tetras.
+  void CreateTetras(vtkUnstructuredGrid* Mesh, vtkPoints* points, vtkIdType ptId,
+    vtkIdType numFaces, vtkIdList* holeTetras);
+
+  // Insert all the input points with ParallelInsertion on.
+  void ParallelInsertPoints(
+    vtkUnstructuredGrid* Mesh, vtkPoints* points, vtkPoints* inPoints, vtkIdList* holeTetras);
+
   int FillInputPortInformation(int, vtkInformation*) override;
 
 private:                    // members added for performance
@@ -14,7 +14,10 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkArrayListTemplate.h" // For processing attribute data
 #include "vtkCell.h"
+#include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
@@ -26,6 +29,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,9 +37,680 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
+namespace
+{
+
+// The input points are glyphed in parallel by blocks: the size of the output
+// of each block is counted first, which gives the offsets of its glyphs.
+constexpr vtkIdType GlyphBlockSize = 1024;
+
+// The kinds of cells of vtkPolyData: vertices, lines, polygons and strips
+constexpr int NumberOfCellKinds = 4;
+
+// A glyph of the table, read once for the parallel glyphing: its points,
+// transformed by the SourceTransform, its normals, and its cells by kind.
+struct GlyphSource
+{
+  vtkIdType NumberOfPoints = 0;
+  std::vector<double> Points;
+  std::vector<double> Normals;
+  vtkIdType NumberOfCells[NumberOfCellKinds] = { 0, 0, 0, 0 };
+  std::vector<vtkIdType> Offsets[NumberOfCellKinds];
+  std::vector<vtkIdType> Connectivity[NumberOfCellKinds];
+
+  void Initialize(vtkPolyData* source, vtkTransform* sourceTransform)
+  {
+    this->NumberOfPoints = source->GetNumberOfPoints();
+    this->Points.resize(3 * this->NumberOfPoints);
+    vtkSmartPointer<vtkPoints> points = source->GetPoints();
+    if (points && sourceTransform)
+    {
+      auto transformed = vtkSmartPointer<vtkPoints>::New();
+      transformed->SetDataTypeToDouble();
+      transformed->Allocate(this->NumberOfPoints);
+      sourceTransform->TransformPoints(points, transformed);
+      points = transformed;
+    }
+    for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+    {
+      points->GetPoint(i, &this->Points[3 * i]);
+    }
+
+    vtkDataArray* normals = source->GetPointData()->GetNormals();
+    if (normals)
+    {
+      this->Normals.resize(3 * this->NumberOfPoints);
+      for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+      {
+        normals->GetTuple(i, &this->Normals[3 * i]);
+      }
+    }
+
+    vtkCellArray* cells[NumberOfCellKinds] = { source->GetVerts(), source->GetLines(),
+      source->GetPolys(), source->GetStrips() };
+    for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+    {
+      this->NumberOfCells[kind] = cells[kind]->GetNumberOfCells();
+      this->Offsets[kind].reserve(this->NumberOfCells[kind] + 1);
+      this->Offsets[kind].push_back(0);
+      this->Connectivity[kind].reserve(cells[kind]->GetNumberOfConnectivityIds());
+      vtkIdType npts;
+      const vtkIdType* pts;
+      auto iter = vtk::TakeSmartPointer(cells[kind]->NewIterator());
+      for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
+      {
+        iter->GetCurrentCell(npts, pts);
+        this->Connectivity[kind].insert(this->Connectivity[kind].end(), pts, pts + npts);
+        this->Offsets[kind].push_back(static_cast<vtkIdType>(this->Connectivity[kind].size()));
+      }
+    }
+  }
+};
+
+// The size of the output generated by some input points, or its offset
+struct GlyphCounts
+{
+  vtkIdType NumberOfPoints = 0;
+  vtkIdType NumberOfCells[NumberOfCellKinds] = { 0, 0, 0, 0 };
+  vtkIdType ConnectivitySize[NumberOfCellKinds] = { 0, 0, 0, 0 };
+
+  void Add(const GlyphSource& glyph)
+  {
+    this->NumberOfPoints += glyph.NumberOfPoints;
+    for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+    {
+      this->NumberOfCells[kind] += glyph.NumberOfCells[kind];
+      this->ConnectivitySize[kind] += static_cast<vtkIdType>(glyph.Connectivity[kind].size());
+    }
+  }
+
+  void Add(const GlyphCounts& counts)
+  {
+    this->NumberOfPoints += counts.NumberOfPoints;
+    for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+    {
+      this->NumberOfCells[kind] += counts.NumberOfCells[kind];
+      this->ConnectivitySize[kind] += counts.ConnectivitySize[kind];
+    }
+  }
+};
+
+// Place the glyph of each input point: select it in the table of glyphs, and
+// compute the matrix that orients and scales it. The serial and the parallel
+// glyphing both place the glyphs with it.
+class GlyphPlacement
+{
+public:
+  GlyphPlacement(vtkGlyph3D* self, vtkDataSet* input, const std::vector<vtkPolyData*>& sources,
+    vtkDataArray* inSScalars, vtkDataArray* inVectors, vtkDataArray* inNormals, bool haveVectors)
+    : Self(self)
+    , Input(input)
+    , InputUG(vtkUniformGrid::SafeDownCast(input))
+    , Sources(sources)
+    , SScalars(inSScalars)
+    , HaveVectors(haveVectors)
+  {
+    this->Vectors = self->GetVectorMode() == VTK_USE_NORMAL ? inNormals : inVectors;
+    vtkDataArray* ghosts = input->GetPointData()->GetArray(vtkDataSetAttributes::GhostArrayName());
+    if (ghosts && ghosts->GetDataType() == VTK_UNSIGNED_CHAR &&
+      ghosts->GetNumberOfComponents() == 1)
+    {
+      this->GhostLevels = static_cast<vtkUnsignedCharArray*>(ghosts)->GetPointer(0);
+    }
+    const double* range = self->GetRange();
+    this->Range[0] = range[0];
+    this->Range[1] = range[1];
+    this->Den = (range[1] - range[0] == 0.0 ? 1.0 : range[1] - range[0]);
+    self->GetFollowedCameraPosition(this->FollowedCameraPosition);
+    self->GetFollowedCameraViewUp(this->FollowedCameraViewUp);
+  }
+
+  // Return the index of the glyph of a point in the sources, or -1 if it is
+  // not glyphed: its glyph is empty, or it is a ghost, blanked or invisible.
+  int SelectGlyph(vtkIdType ptId) const
+  {
+    double s, v[3], vMag, scale[3];
+    this->EvaluatePoint(ptId, s, v, vMag, scale);
+    int index = 0;
+    const int numberOfSources = static_cast<int>(this->Sources.size());
+    if (this->Self->GetIndexMode() != VTK_INDEXING_OFF)
+    {
+      const double value = this->Self->GetIndexMode() == VTK_INDEXING_BY_SCALAR ? s : vMag;
+      index = static_cast<int>((value - this->Range[0]) * numberOfSources / this->Den);
+      index = (index < 0 ? 0 : (index >= numberOfSources ? (numberOfSources - 1) : index));
+    }
+    if (index < 0 || !this->Sources[index])
+    {
+      return -1;
+    }
+    // If we are processing a piece, we do not want to duplicate glyphs on the borders.
+    if (this->GhostLevels &&
+      this->GhostLevels[ptId] &
+        (vtkDataSetAttributes::DUPLICATEPOINT | vtkDataSetAttributes::HIDDENPOINT))
+    {
+      return -1;
+    }
+    if ((this->InputUG && !this->InputUG->IsPointVisible(ptId)) ||
+      !this->Self->IsPointVisible(this->Input, ptId))
+    {
+      return -1;
+    }
+    return index;
+  }
+
+  // Get the position x of the glyph of a point, its vector v, its scalar, which
+  // is its scale before the scale factor, and the matrix whose columns are its
+  // oriented and scaled axes.
+  void PlaceGlyph(
+    vtkIdType ptId, double x[3], double v[3], double& scalar, double matrix[3][3]) const
+  {
+    double s, vMag, scale[3];
+    this->EvaluatePoint(ptId, s, v, vMag, scale);
+    this->Input->GetPoint(ptId, x);
+
+    // Orient the glyph: the columns of the matrix are its axes
+    for (int i = 0; i < 3; ++i)
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        matrix[i][j] = (i == j ? 1.0 : 0.0);
+      }
+    }
+    if (this->HaveVectors && this->Self->GetVectorMode() == VTK_FOLLOW_CAMERA_DIRECTION)
+    {
+      // v = glyphNormal_World (glyph normal direction in World coordinate system)
+      for (int i = 0; i < 3; ++i)
+      {
+        v[i] = this->FollowedCameraPosition[i] - x[i];
+      }
+      vtkMath::Normalize(v);
+      if (this->Self->GetOrient())
+      {
+        // glyph up direction in World coordinate system (approximately the same
+        // as FollowedCameraViewUp, but adjusted to be orthogonal to the normal)
+        double glyphRight[3], glyphUp[3];
+        vtkMath::Cross(this->FollowedCameraViewUp, v, glyphRight);
+        vtkMath::Cross(v, glyphRight, glyphUp);
+        for (int i = 0; i < 3; ++i)
+        {
+          matrix[i][0] = glyphRight[i];
+          matrix[i][1] = glyphUp[i];
+          matrix[i][2] = v[i];
+        }
+      }
+    }
+    else if (this->HaveVectors && this->Self->GetOrient() && vMag > 0.0)
+    {
+      if (v[1] == 0.0 && v[2] == 0.0)
+      {
+        if (v[0] < 0) // just flip x if we need to
+        {
+          matrix[0][0] = matrix[2][2] = -1.0;
+        }
+      }
+      else
+      {
+        // rotate by 180 degrees around the bisector of x and v
+        double axis[3] = { v[0] + vMag, v[1], v[2] };
+        vtkMath::Normalize(axis);
+        for (int i = 0; i < 3; ++i)
+        {
+          for (int j = 0; j < 3; ++j)
+          {
+            matrix[i][j] = 2.0 * axis[i] * axis[j] - (i == j ? 1.0 : 0.0);
+          }
+        }
+      }
+    }
+
+    // scale data if appropriate
+    scalar = this->Self->GetColorMode() == VTK_COLOR_BY_VECTOR ? vMag : scale[0];
+    if (this->Self->GetScaling())
+    {
+      const double scaleFactor = this->Self->GetScaleFactor();
+      const bool dataScaling = this->Self->GetScaleMode() != VTK_DATA_SCALING_OFF;
+      for (int j = 0; j < 3; ++j)
+      {
+        double factor = dataScaling ? scale[j] * scaleFactor : scaleFactor;
+        factor = (factor == 0.0 ? 1.0e-10 : factor);
+        for (int i = 0; i < 3; ++i)
+        {
+          matrix[i][j] *= factor;
+        }
+      }
+    }
+  }
+
+private:
+  // Get the scalar, the vector and the scale of a point, clamped if enabled
+  void EvaluatePoint(vtkIdType ptId, double& s, double v[3], double& vMag, double scale[3]) const
+  {
+    s = vMag = 0.0;
+    v[0] = v[1] = v[2] = 0.0;
+    scale[0] = scale[1] = scale[2] = 1.0;
+    const int scaleMode = this->Self->GetScaleMode();
+    if (this->SScalars)
+    {
+      s = this->SScalars->GetComponent(ptId, 0);
+      if (scaleMode == VTK_SCALE_BY_SCALAR || scaleMode == VTK_DATA_SCALING_OFF)
+      {
+        scale[0] = scale[1] = scale[2] = s;
+      }
+    }
+    if (this->HaveVectors)
+    {
+      if (this->Self->GetVectorMode() == VTK_FOLLOW_CAMERA_DIRECTION)
+      {
+        vMag = 1.0; // v is the direction to the camera, set by PlaceGlyph()
+      }
+      else
+      {
+        this->Vectors->GetTuple(ptId, v);
+        vMag = vtkMath::Norm(v);
+        if (scaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
+        {
+          scale[0] = v[0];
+          scale[1] = v[1];
+          scale[2] = v[2];
+        }
+        else if (scaleMode == VTK_SCALE_BY_VECTOR)
+        {
+          scale[0] = scale[1] = scale[2] = vMag;
+        }
+      }
+    }
+    if (this->Self->GetClamping())
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        scale[i] = (std::min(std::max(scale[i], this->Range[0]), this->Range[1]) - this->Range[0]) /
+          this->Den;
+      }
+    }
+  }
+
+  vtkGlyph3D* Self;
+  vtkDataSet* Input;
+  vtkUniformGrid* InputUG;
+  const std::vector<vtkPolyData*>& Sources;
+  const unsigned char* GhostLevels = nullptr;
+  vtkDataArray* SScalars;
+  vtkDataArray* Vectors;
+  bool HaveVectors;
+  double Range[2];
+  double Den;
+  double FollowedCameraPosition[3];
+  double FollowedCameraViewUp[3];
+};
+
+// Generate the glyphs of vtkGlyph3D in parallel. The glyph of each point is
+// selected and the output of each block of points is counted, then the
+// glyphs are placed and written into the preallocated output. Their 3x3
+// matrices are applied directly instead of through a vtkTransform.
+class GlyphGenerator
+{
+public:
+  GlyphGenerator(vtkGlyph3D* self, vtkDataSet* input, const GlyphPlacement& placement,
+    vtkDataArray* inSScalars, vtkDataArray* inCScalars, bool haveVectors)
+    : Self(self)
+    , Input(input)
+    , Placement(placement)
+    , SScalars(inSScalars)
+    , CScalars(inCScalars)
+    , HaveVectors(haveVectors)
+  {
+  }
+
+  bool Execute(const std::vector<vtkPolyData*>& sources, vtkPolyData* output);
+
+private:
+  // Generate the glyphs of each block from its offsets
+  template <typename TPoint>
+  void Generate(TPoint* outPts, ArrayList& pointArrays, ArrayList& cellArrays)
+  {
+    const vtkIdType numPts = this->Input->GetNumberOfPoints();
+    const vtkIdType numBlocks = static_cast<vtkIdType>(this->BlockOffsets.size()) - 1;
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType firstBlock, vtkIdType lastBlock) {
+      for (vtkIdType block = firstBlock; block < lastBlock; ++block)
+      {
+        GlyphCounts at = this->BlockOffsets[block];
+        const vtkIdType end = std::min((block + 1) * GlyphBlockSize, numPts);
+        for (vtkIdType ptId = block * GlyphBlockSize; ptId < end; ++ptId)
+        {
+          const int index = this->Selection[ptId];
+          if (index >= 0)
+          {
+            const GlyphSource& glyph = this->Glyphs[index];
+            this->GenerateGlyph(ptId, glyph, at, outPts, pointArrays, cellArrays);
+            at.Add(glyph);
+          }
+        }
+      }
+    });
+  }
+
+  template <typename TPoint>
+  void GenerateGlyph(vtkIdType ptId, const GlyphSource& glyph, const GlyphCounts& at,
+    TPoint* outPts, ArrayList& pointArrays, ArrayList& cellArrays);
+
+  vtkGlyph3D* Self;
+  vtkDataSet* Input;
+  const GlyphPlacement& Placement;
+  vtkDataArray* SScalars;
+  vtkDataArray* CScalars;
+  bool HaveVectors;
+
+  std::vector<GlyphSource> Glyphs;
+  std::vector<int> Selection;
+  std::vector<GlyphCounts> BlockOffsets;
+
+  // The output, written in parallel
+  vtkIdType* Offsets[NumberOfCellKinds];
+  vtkIdType* Connectivity[NumberOfCellKinds];
+  vtkIdType CellKindOffsets[NumberOfCellKinds];
+  float* GlyphScalars = nullptr;
+  vtkDataArray* ColorScalars = nullptr;
+  float* GlyphVectors = nullptr;
+  float* Normals = nullptr;
+  vtkDataArray* TCoords = nullptr;
+  vtkDataArray* SourceTCoords = nullptr;
+  vtkIdType* PointIds = nullptr;
+  bool CopyPointData = false;
+  bool CopyCellData = false;
+};
+
+//------------------------------------------------------------------------------
+template <typename TPoint>
+void GlyphGenerator::GenerateGlyph(vtkIdType ptId, const GlyphSource& glyph,
+  const GlyphCounts& at, TPoint* outPts, ArrayList& pointArrays, ArrayList& cellArrays)
+{
+  double x[3], v[3], scalar, matrix[3][3];
+  this->Placement.PlaceGlyph(ptId, x, v, scalar, matrix);
+  const vtkIdType firstPt = at.NumberOfPoints;
+
+  // Copy all topology (transformation independent)
+  for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+  {
+    const vtkIdType numCells = glyph.NumberOfCells[kind];
+    vtkIdType* offsets = this->Offsets[kind] + at.NumberOfCells[kind];
+    for (vtkIdType i = 0; i < numCells; ++i)
+    {
+      offsets[i] = at.ConnectivitySize[kind] + glyph.Offsets[kind][i];
+    }
+    vtkIdType* connectivity = this->Connectivity[kind] + at.ConnectivitySize[kind];
+    const std::vector<vtkIdType>& glyphConnectivity = glyph.Connectivity[kind];
+    for (size_t i = 0; i < glyphConnectivity.size(); ++i)
+    {
+      connectivity[i] = glyphConnectivity[i] + firstPt;
+    }
+    if (this->CopyCellData)
+    {
+      const vtkIdType firstCell = this->CellKindOffsets[kind] + at.NumberOfCells[kind];
+      for (vtkIdType i = 0; i < numCells; ++i)
+      {
+        cellArrays.Copy(ptId, firstCell + i);
+      }
+    }
+  }
+
+  // the normals are transformed by the transposed inverse matrix
+  double normalMatrix[3][3];
+  if (this->Normals)
+  {
+    vtkMath::Invert3x3(matrix, normalMatrix);
+    vtkMath::Transpose3x3(normalMatrix, normalMatrix);
+  }
+
+  for (vtkIdType i = 0; i < glyph.NumberOfPoints; ++i)
+  {
+    const vtkIdType outPtId = firstPt + i;
+    const double* p = &glyph.Points[3 * i];
+    TPoint* outPt = outPts + 3 * outPtId;
+    for (int j = 0; j < 3; ++j)
+    {
+      outPt[j] =
+        static_cast<TPoint>(x[j] + matrix[j][0] * p[0] + matrix[j][1] * p[1] + matrix[j][2] * p[2]);
+    }
+    if (this->Normals)
+    {
+      const double* n = &glyph.Normals[3 * i];
+      double normal[3];
+      vtkMath::Multiply3x3(normalMatrix, n, normal);
+      vtkMath::Normalize(normal);
+      std::copy(normal, normal + 3, this->Normals + 3 * outPtId);
+    }
+    if (this->GlyphVectors)
+    {
+      std::copy(v, v + 3, this->GlyphVectors + 3 * outPtId);
+    }
+    if (this->GlyphScalars)
+    {
+      this->GlyphScalars[outPtId] = static_cast<float>(scalar);
+    }
+    else if (this->ColorScalars)
+    {
+      this->ColorScalars->SetTuple(outPtId, ptId, this->CScalars);
+    }
+    if (this->TCoords)
+    {
+      this->TCoords->SetTuple(outPtId, i, this->SourceTCoords);
+    }
+    if (this->PointIds)
+    {
+      this->PointIds[outPtId] = ptId;
+    }
+    if (this->CopyPointData)
+    {
+      pointArrays.Copy(ptId, outPtId);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+bool GlyphGenerator::Execute(const std::vector<vtkPolyData*>& sources, vtkPolyData* output)
+{
+  vtkGlyph3D* self = this->Self;
+  const vtkIdType numPts = this->Input->GetNumberOfPoints();
+  this->Glyphs.resize(sources.size());
+  bool haveNormals = true;
+  for (size_t i = 0; i < sources.size(); ++i)
+  {
+    if (sources[i])
+    {
+      this->Glyphs[i].Initialize(sources[i], self->GetSourceTransform());
+      haveNormals &= !this->Glyphs[i].Normals.empty();
+    }
+  }
+
+  // Select the glyph of each point, and count the output of each block
+  const vtkIdType numBlocks = (numPts + GlyphBlockSize - 1) / GlyphBlockSize;
+  this->Selection.resize(numPts);
+  this->BlockOffsets.resize(numBlocks + 1);
+  vtkSMPTools::For(0, numBlocks, [this, numPts](vtkIdType firstBlock, vtkIdType lastBlock) {
+    for (vtkIdType block = firstBlock; block < lastBlock; ++block)
+    {
+      GlyphCounts& counts = this->BlockOffsets[block + 1];
+      const vtkIdType end = std::min((block + 1) * GlyphBlockSize, numPts);
+      for (vtkIdType ptId = block * GlyphBlockSize; ptId < end; ++ptId)
+      {
+        const int index = this->Placement.SelectGlyph(ptId);
+        this->Selection[ptId] = index;
+        if (index >= 0)
+        {
+          counts.Add(this->Glyphs[index]);
+        }
+      }
+    }
+  });
+  for (vtkIdType block = 0; block < numBlocks; ++block)
+  {
+    this->BlockOffsets[block + 1].Add(this->BlockOffsets[block]);
+  }
+  const GlyphCounts& total = this->BlockOffsets[numBlocks];
+  self->UpdateProgress(0.5);
+  if (self->GetAbortExecute())
+  {
+    return true;
+  }
+
+  // Allocate the output
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(
+    self->GetOutputPointsPrecision() == vtkAlgorithm::DOUBLE_PRECISION ? VTK_DOUBLE : VTK_FLOAT);
+  newPts->SetNumberOfPoints(total.NumberOfPoints);
+
+  vtkSmartPointer<vtkIdTypeArray> offsets[NumberOfCellKinds];
+  vtkSmartPointer<vtkIdTypeArray> connectivity[NumberOfCellKinds];
+  vtkIdType numCells = 0;
+  for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+  {
+    offsets[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    offsets[kind]->SetNumberOfValues(total.NumberOfCells[kind] + 1);
+    offsets[kind]->SetValue(total.NumberOfCells[kind], total.ConnectivitySize[kind]);
+    this->Offsets[kind] = offsets[kind]->GetPointer(0);
+    connectivity[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity[kind]->SetNumberOfValues(total.ConnectivitySize[kind]);
+    this->Connectivity[kind] = connectivity[kind]->GetPointer(0);
+    this->CellKindOffsets[kind] = numCells;
+    numCells += total.NumberOfCells[kind];
+  }
+
+  vtkPointData* outputPD = output->GetPointData();
+  vtkCellData* outputCD = output->GetCellData();
+  vtkPointData* pd = this->Input->GetPointData();
+  ArrayList pointArrays;
+  ArrayList cellArrays;
+  if (self->GetIndexMode() == VTK_INDEXING_OFF)
+  {
+    this->SourceTCoords = sources[0]->GetPointData()->GetTCoords();
+    outputPD->CopyAllocate(pd, total.NumberOfPoints);
+    pointArrays.AddArrays(total.NumberOfPoints, pd, outputPD, 0.0, false);
+    this->CopyPointData = true;
+    if (self->GetFillCellData())
+    {
+      outputCD->CopyGlobalIdsOn();
+      outputCD->CopyAllocate(pd, numCells);
+      cellArrays.AddArrays(numCells, pd, outputCD, 0.0, false);
+      this->CopyCellData = true;
+    }
+  }
+
+  vtkSmartPointer<vtkIdTypeArray> pointIds;
+  if (self->GetGeneratePointIds())
+  {
+    pointIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    pointIds->SetName(self->GetPointIdsName());
+    pointIds->SetNumberOfValues(total.NumberOfPoints);
+    this->PointIds = pointIds->GetPointer(0);
+  }
+  vtkSmartPointer<vtkDataArray> newScalars;
+  const int colorMode = self->GetColorMode();
+  if (colorMode == VTK_COLOR_BY_SCALAR && this->CScalars)
+  {
+    newScalars.TakeReference(this->CScalars->NewInstance());
+    newScalars->SetNumberOfComponents(this->CScalars->GetNumberOfComponents());
+    newScalars->SetNumberOfTuples(total.NumberOfPoints);
+    newScalars->SetName(this->CScalars->GetName());
+    this->ColorScalars = newScalars;
+  }
+  else if ((colorMode == VTK_COLOR_BY_SCALE && this->SScalars) ||
+    (colorMode == VTK_COLOR_BY_VECTOR && this->HaveVectors))
+  {
+    auto glyphScalars = vtkSmartPointer<vtkFloatArray>::New();
+    glyphScalars->SetNumberOfTuples(total.NumberOfPoints);
+    if (colorMode == VTK_COLOR_BY_VECTOR)
+    {
+      glyphScalars->SetName("VectorMagnitude");
+    }
+    else
+    {
+      glyphScalars->SetName(self->GetScaleMode() == VTK_SCALE_BY_SCALAR ? this->SScalars->GetName()
+                                                                        : "GlyphScale");
+    }
+    this->GlyphScalars = glyphScalars->GetPointer(0);
+    newScalars = glyphScalars;
+  }
+  vtkSmartPointer<vtkFloatArray> newVectors;
+  if (this->HaveVectors)
+  {
+    newVectors = vtkSmartPointer<vtkFloatArray>::New();
+    newVectors->SetNumberOfComponents(3);
+    newVectors->SetNumberOfTuples(total.NumberOfPoints);
+    newVectors->SetName("GlyphVector");
+    this->GlyphVectors = newVectors->GetPointer(0);
+  }
+  vtkSmartPointer<vtkFloatArray> newNormals;
+  if (haveNormals)
+  {
+    newNormals = vtkSmartPointer<vtkFloatArray>::New();
+    newNormals->SetNumberOfComponents(3);
+    newNormals->SetNumberOfTuples(total.NumberOfPoints);
+    newNormals->SetName("Normals");
+    this->Normals = newNormals->GetPointer(0);
+  }
+  vtkSmartPointer<vtkFloatArray> newTCoords;
+  if (this->SourceTCoords)
+  {
+    newTCoords = vtkSmartPointer<vtkFloatArray>::New();
+    newTCoords->SetNumberOfComponents(this->SourceTCoords->GetNumberOfComponents());
+    newTCoords->SetNumberOfTuples(total.NumberOfPoints);
+    newTCoords->SetName("TCoords");
+    this->TCoords = newTCoords;
+  }
+
+  if (newPts->GetDataType() == VTK_DOUBLE)
+  {
+    this->Generate(static_cast<double*>(newPts->GetVoidPointer(0)), pointArrays, cellArrays);
+  }
+  else
+  {
+    this->Generate(static_cast<float*>(newPts->GetVoidPointer(0)), pointArrays, cellArrays);
+  }
+
+  // Update the output
+  output->SetPoints(newPts);
+  vtkNew<vtkCellArray> cells[NumberOfCellKinds];
+  for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+  {
+    cells[kind]->SetData(offsets[kind], connectivity[kind]);
+  }
+  output->SetVerts(cells[0]);
+  output->SetLines(cells[1]);
+  output->SetPolys(cells[2]);
+  output->SetStrips(cells[3]);
+
+  if (pointIds)
+  {
+    outputPD->AddArray(pointIds);
+  }
+  if (newScalars)
+  {
+    int idx = outputPD->AddArray(newScalars);
+    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+  }
+  if (newVectors)
+  {
+    outputPD->SetVectors(newVectors);
+  }
+  if (newNormals)
+  {
+    outputPD->SetNormals(newNormals);
+  }
+  if (newTCoords)
+  {
+    outputPD->SetTCoords(newTCoords);
+  }
+  return true;
+}
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 // Construct object with scaling on, scaling mode is by scalar value,
 // scale factor = 1.0, the range is (0,1), orient geometry is on, and
@@ -65,6 +740,7 @@ vtkGlyph3D::vtkGlyph3D()
   this->FillCellData = 0;
   this->SourceTransform = nullptr;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelGlyphing = 0;
 
   // by default process active point scalars
   this->SetInputArrayToProcess(
@@ -130,12 +806,8 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     return true;
   }
 
-  // this is used to respect blanking specified on uniform grids.
-  vtkUniformGrid* inputUG = vtkUniformGrid::SafeDownCast(input);
-
   vtkPointData* pd;
   vtkDataArray* inCScalars; // Scalars for Coloring
-  unsigned char* inGhostLevels = nullptr;
   vtkDataArray *inNormals, *sourceNormals = nullptr;
   vtkDataArray* sourceTCoords = nullptr;
   vtkIdType numPts, numSourcePts, numSourceCells, inPtId, i;
@@ -146,7 +818,7 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   vtkDataArray* newVectors = nullptr;
   vtkDataArray* newNormals = nullptr;
   vtkDataArray* newTCoords = nullptr;
-  double x[3], v[3], vNew[3], s = 0.0, vMag = 0.0, value, tc[3];
+  double x[3], v[3], scalar, matrix[3][3], tc[3];
   vtkTransform* trans = vtkTransform::New();
   vtkNew<vtkIdList> pointIdList;
   vtkIdList* cellPts;
@@ -154,7 +826,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   vtkIdList* pts;
   vtkIdType ptIncr, cellIncr, cellId;
   int haveVectors, haveNormals, haveTCoords = 0;
-  double scalex, scaley, scalez, den;
   vtkPointData* outputPD = output->GetPointData();
   vtkCellData* outputCD = output->GetCellData();
   int numberOfSources = this->GetNumberOfInputConnections(1);
@@ -170,7 +841,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   pts = vtkIdList::New();
   pts->Allocate(VTK_CELL_SIZE);
 
-  pd = input->GetPointData();
   inNormals = this->GetInputArrayToProcess(2, input);
   inCScalars = this->GetInputArrayToProcess(3, input);
   if (inCScalars == nullptr)
@@ -178,20 +848,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     inCScalars = inSScalars;
   }
 
-  vtkDataArray* temp = nullptr;
-  if (pd)
-  {
-    temp = pd->GetArray(vtkDataSetAttributes::GhostArrayName());
-  }
-  if ((!temp) || (temp->GetDataType() != VTK_UNSIGNED_CHAR) || (temp->GetNumberOfComponents() != 1))
-  {
-    vtkDebugMacro("No appropriate ghost levels field available.");
-  }
-  else
-  {
-    inGhostLevels = static_cast<vtkUnsignedCharArray*>(temp)->GetPointer(0);
-  }
-
   numPts = input->GetNumberOfPoints();
   if (numPts < 1)
   {
@@ -203,10 +859,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
 
   // Check input for consistency
   //
-  if ((den = this->Range[1] - this->Range[0]) == 0.0)
-  {
-    den = 1.0;
-  }
   if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION ||
     (this->VectorMode != VTK_VECTOR_ROTATION_OFF &&
       ((this->VectorMode == VTK_USE_VECTOR && inVectors != nullptr) ||
@@ -218,6 +870,17 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   {
     haveVectors = 0;
   }
+  if (haveVectors && this->VectorMode != VTK_FOLLOW_CAMERA_DIRECTION)
+  {
+    vtkDataArray* array3D = this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
+    if (array3D->GetNumberOfComponents() > 3)
+    {
+      vtkErrorMacro(<< "vtkDataArray " << array3D->GetName() << " has more than 3 components.\n");
+      pts->Delete();
+      trans->Delete();
+      return false;
+    }
+  }
 
   if ((this->IndexMode == VTK_INDEXING_BY_SCALAR && !inSScalars) ||
     (this->IndexMode == VTK_INDEXING_BY_VECTOR &&
@@ -260,13 +923,37 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
     source = defaultSource;
   }
 
+  // The table of glyphs, or the single glyph when indexing is off
+  std::vector<vtkPolyData*> sources;
+  if (this->IndexMode != VTK_INDEXING_OFF)
+  {
+    for (i = 0; i < numberOfSources; i++)
+    {
+      sources.push_back(this->GetSource(i, sourceVector));
+    }
+  }
+  else
+  {
+    sources.push_back(source);
+  }
+  GlyphPlacement placement(
+    this, input, sources, inSScalars, inVectors, inNormals, haveVectors != 0);
+
+  if (this->ParallelGlyphing)
+  {
+    pts->Delete();
+    trans->Delete();
+    GlyphGenerator generator(this, input, placement, inSScalars, inCScalars, haveVectors != 0);
+    return generator.Execute(sources, output);
+  }
+
   if (this->IndexMode != VTK_INDEXING_OFF)
   {
     pd = nullptr;
     haveNormals = 1;
     for (numSourcePts = numSourceCells = i = 0; i < numberOfSources; i++)
     {
-      source = this->GetSource(i, sourceVector);
+      source = sources[i];
       if (source != nullptr)
       {
         if (source->GetNumberOfPoints() > numSourcePts)
@@ -409,7 +1096,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
   cellIncr = 0;
   for (inPtId = 0; inPtId < numPts; inPtId++)
   {
-    scalex = scaley = scalez = 1.0;
     if (!(inPtId % 10000))
     {
       this->UpdateProgress(static_cast<double>(inPtId) / numPts);
@@ -419,129 +1105,21 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
       }
     }
 
-    // Get the scalar and vector data
-    if (inSScalars)
-    {
-      s = inSScalars->GetComponent(inPtId, 0);
-      if (this->ScaleMode == VTK_SCALE_BY_SCALAR || this->ScaleMode == VTK_DATA_SCALING_OFF)
-      {
-        scalex = scaley = scalez = s;
-      }
-    }
-
-    if (haveVectors)
-    {
-      if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
-      {
-        vMag = 1.0; // v will be set later
-      }
-      else
-      {
-        vtkDataArray* array3D = this->VectorMode == VTK_USE_NORMAL ? inNormals : inVectors;
-        if (array3D->GetNumberOfComponents() > 3)
-        {
-          vtkErrorMacro(<< "vtkDataArray " << array3D->GetName()
-                        << " has more than 3 components.\n");
-          pts->Delete();
-          trans->Delete();
-          if (newPts)
-          {
-            newPts->Delete();
-          }
-          if (newVectors)
-          {
-            newVectors->Delete();
-          }
-          return false;
-        }
-
-        v[0] = 0;
-        v[1] = 0;
-        v[2] = 0;
-        array3D->GetTuple(inPtId, v);
-        vMag = vtkMath::Norm(v);
-        if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
-        {
-          scalex = v[0];
-          scaley = v[1];
-          scalez = v[2];
-        }
-        else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
-        {
-          scalex = scaley = scalez = vMag;
-        }
-      }
-    }
-
-    // Clamp data scale if enabled
-    if (this->Clamping)
-    {
-      scalex = (scalex < this->Range[0] ? this->Range[0]
-                                        : (scalex > this->Range[1] ? this->Range[1] : scalex));
-      scalex = (scalex - this->Range[0]) / den;
-      scaley = (scaley < this->Range[0] ? this->Range[0]
-                                        : (scaley > this->Range[1] ? this->Range[1] : scaley));
-      scaley = (scaley - this->Range[0]) / den;
-      scalez = (scalez < this->Range[0] ? this->Range[0]
-                                        : (scalez > this->Range[1] ? this->Range[1] : scalez));
-      scalez = (scalez - this->Range[0]) / den;
-    }
-
-    // Compute index into table of glyphs
-    if (this->IndexMode != VTK_INDEXING_OFF)
-    {
-      if (this->IndexMode == VTK_INDEXING_BY_SCALAR)
-      {
-        value = s;
-      }
-      else
-      {
-        value = vMag;
-      }
-
-      int index = static_cast<int>((value - this->Range[0]) * numberOfSources / den);
-      index = (index < 0 ? 0 : (index >= numberOfSources ? (numberOfSources - 1) : index));
-
-      source = this->GetSource(index, sourceVector);
-      if (source != nullptr)
-      {
-        sourcePts = source->GetPoints();
-        sourceNormals = source->GetPointData()->GetNormals();
-        numSourcePts = sourcePts->GetNumberOfPoints();
-        numSourceCells = source->GetNumberOfCells();
-      }
-    }
-
-    // Make sure we're not indexing into empty glyph
-    if (source == nullptr)
-    {
-      continue;
-    }
-
-    // Check ghost points.
-    // If we are processing a piece, we do not want to duplicate glyphs on the borders.
-    if (inGhostLevels &&
-      inGhostLevels[inPtId] &
-        (vtkDataSetAttributes::DUPLICATEPOINT | vtkDataSetAttributes::HIDDENPOINT))
-    {
-      continue;
-    }
-
-    if (inputUG && !inputUG->IsPointVisible(inPtId))
+    // Select the glyph, skipping empty glyphs, ghost and blanked points
+    int index = placement.SelectGlyph(inPtId);
+    if (index < 0)
     {
-      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
-      // it.
       continue;
     }
-
-    if (!this->IsPointVisible(input, inPtId))
+    if (this->IndexMode != VTK_INDEXING_OFF)
     {
-      continue;
+      source = sources[index];
+      sourcePts = source->GetPoints();
+      sourceNormals = source->GetPointData()->GetNormals();
+      numSourcePts = sourcePts->GetNumberOfPoints();
+      numSourceCells = source->GetNumberOfCells();
     }
 
-    // Now begin copying/transforming glyph
-    trans->Identity();
-
     // Copy all topology (transformation independent)
     for (cellId = 0; cellId < numSourceCells; cellId++)
     {
@@ -555,9 +1133,12 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
       output->InsertNextCell(source->GetCellType(cellId), pts);
     }
 
-    // translate Source to Input point
-    input->GetPoint(inPtId, x);
-    trans->Translate(x[0], x[1], x[2]);
+    // translate Source to Input point, then orient and scale it
+    placement.PlaceGlyph(inPtId, x, v, scalar, matrix);
+    double glyphToWorld[16] = { matrix[0][0], matrix[0][1], matrix[0][2], x[0], matrix[1][0],
+      matrix[1][1], matrix[1][2], x[1], matrix[2][0], matrix[2][1], matrix[2][2], x[2], 0.0, 0.0,
+      0.0, 1.0 };
+    trans->SetMatrix(glyphToWorld);
 
     if (haveVectors)
     {
@@ -566,46 +1147,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
       {
         newVectors->InsertTuple(i + ptIncr, v);
       }
-      if (this->Orient)
-      {
-        if (this->VectorMode == VTK_FOLLOW_CAMERA_DIRECTION)
-        {
-          // v = glyphNormal_World (glyph normal direction in World coordinate system)
-          v[0] = this->FollowedCameraPosition[0] - x[0];
-          v[1] = this->FollowedCameraPosition[1] - x[1];
-          v[2] = this->FollowedCameraPosition[2] - x[2];
-          vtkMath::Normalize(v);
-          double glyphRight_World[3]; // glyph right direction in World coordinate system
-          vtkMath::Cross(this->FollowedCameraViewUp, v, glyphRight_World);
-          // glyph up direction in World coordinate system
-          // (approximately the same as this->FollowedCameraViewUp, but slightly adjusted to be
-          // orthogonal to the normal direction)
-          double glyphUp_World[3];
-          vtkMath::Cross(v, glyphRight_World, glyphUp_World);
-          double glyphToWorld[16] = { glyphRight_World[0], glyphUp_World[0], v[0], 0.0,
-            glyphRight_World[1], glyphUp_World[1], v[1], 0.0, glyphRight_World[2], glyphUp_World[2],
-            v[2], 0.0, 0.0, 0.0, 0.0, 1.0 };
-          trans->Concatenate(glyphToWorld);
-        }
-        else if (vMag > 0.0)
-        {
-          // if there is no y or z component
-          if (v[1] == 0.0 && v[2] == 0.0)
-          {
-            if (v[0] < 0) // just flip x if we need to
-            {
-              trans->RotateWXYZ(180.0, 0, 1, 0);
-            }
-          }
-          else
-          {
-            vNew[0] = (v[0] + vMag) / 2.0;
-            vNew[1] = v[1] / 2.0;
-            vNew[2] = v[2] / 2.0;
-            trans->RotateWXYZ(180.0, vNew[0], vNew[1], vNew[2]);
-          }
-        }
-      }
     }
 
     if (haveTCoords)
@@ -617,13 +1158,13 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
       }
     }
 
-    // determine scale factor from scalars if appropriate
     // Copy scalar value
-    if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
+    if ((inSScalars && this->ColorMode == VTK_COLOR_BY_SCALE) ||
+      (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR))
     {
       for (i = 0; i < numSourcePts; i++)
       {
-        newScalars->InsertTuple(i + ptIncr, &scalex); // = scaley = scalez
+        newScalars->InsertTuple(i + ptIncr, &scalar);
       }
     }
     else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
@@ -633,42 +1174,6 @@ bool vtkGlyph3D::Execute(vtkDataSet* input, vtkInformationVector* sourceVector,
         outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr + i);
       }
     }
-    if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
-    {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        newScalars->InsertTuple(i + ptIncr, &vMag);
-      }
-    }
-
-    // scale data if appropriate
-    if (this->Scaling)
-    {
-      if (this->ScaleMode == VTK_DATA_SCALING_OFF)
-      {
-        scalex = scaley = scalez = this->ScaleFactor;
-      }
-      else
-      {
-        scalex *= this->ScaleFactor;
-        scaley *= this->ScaleFactor;
-        scalez *= this->ScaleFactor;
-      }
-
-      if (scalex == 0.0)
-      {
-        scalex = 1.0e-10;
-      }
-      if (scaley == 0.0)
-      {
-        scaley = 1.0e-10;
-      }
-      if (scalez == 0.0)
-      {
-        scalez = 1.0e-10;
-      }
-      trans->Scale(scalex, scaley, scalez);
-    }
 
     // multiply points and normals by resulting matrix
     if (this->SourceTransform)
@@ -904,6 +1409,7 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Fill Cell Data: " << (this->FillCellData ? "On\n" : "Off\n");
+  os << indent << "Parallel Glyphing: " << (this->ParallelGlyphing ? "On\n" : "Off\n");
 
   os << indent << "SourceTransform: ";
   if (this->SourceTransform)
@@ -73,6 +73,15 @@
  * vtkAlgorithm. The first array is scalars, the next vectors, the next
  * normals and finally color scalars.
  *
+ * @warning
+ * If ParallelGlyphing is on, the glyphs are generated with vtkSMPTools: the
+ * glyph of each point is selected first, which gives the offsets of its
+ * points and cells in the output, then the glyphs are transformed and written
+ * in parallel. The output is the same as the serial one, except that the
+ * cells are grouped by kind (vertices, lines, polygons and strips) as in any
+ * vtkPolyData, instead of glyph by glyph, when the sources mix these kinds.
+ * IsPointVisible() is then called concurrently, and must be thread-safe.
+ *
  * @sa
  * vtkTensorGlyph
  */
@@ -332,6 +341,16 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Turn on/off the generation of the glyphs in parallel (see the class
+   * documentation). Off by default.
+   */
+  vtkSetMacro(ParallelGlyphing, vtkTypeBool);
+  vtkGetMacro(ParallelGlyphing, vtkTypeBool);
+  vtkBooleanMacro(ParallelGlyphing, vtkTypeBool);
+  ///@}
+
 protected:
   vtkGlyph3D();
   ~vtkGlyph3D() override;
@@ -371,6 +390,7 @@ protected:
   char* PointIdsName;
   vtkTransform* SourceTransform;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelGlyphing; // whether to generate the glyphs in parallel
 
 private:
   vtkGlyph3D(const vtkGlyph3D&) = delete;
@@ -17,6 +17,7 @@
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkConnectedRegionsInternal.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -28,9 +29,39 @@
 #include "vtkPolyData.h"
 
 #include <algorithm> // for fill_n
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
+namespace
+{
+
+// Thread-safe equivalent of vtkPolyDataConnectivityFilter::IsScalarConnected.
+struct ScalarCriterion
+{
+  vtkDataArray* Scalars;
+  double Range[2];
+  bool Full;
+
+  bool operator()(vtkIdList* ptIds) const
+  {
+    double range[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      const double s = static_cast<float>(this->Scalars->GetComponent(ptIds->GetId(i), 0));
+      range[0] = s < range[0] ? s : range[0];
+      range[1] = s > range[1] ? s : range[1];
+    }
+    if (this->Full)
+    {
+      return range[0] >= this->Range[0] && range[1] <= this->Range[1];
+    }
+    return range[1] >= this->Range[0] && range[0] <= this->Range[1];
+  }
+};
+
+} // anonymous namespace
+
 // Construct with default extraction mode to extract largest regions.
 vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
 {
@@ -129,11 +160,18 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
     }
   }
 
-  // Build cell structure
+  // Build cell structure. Links are only needed to grow seeded regions.
   //
   this->Mesh = vtkPolyData::New();
   this->Mesh->CopyStructure(input);
-  this->Mesh->BuildLinks();
+  this->Mesh->BuildCells();
+  const bool seeded = this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS ||
+    this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS ||
+    this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION;
+  if (seeded)
+  {
+    this->Mesh->BuildLinks();
+  }
   this->UpdateProgress(0.10);
 
   // Remove all visited point ids
@@ -184,34 +222,42 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
-    this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
-    this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION)
-  { // visit all cells marking with region number
-    for (cellId = 0; cellId < numCells; cellId++)
+  if (!seeded)
+  { // label all cells with their region number, in parallel
+    std::vector<vtkIdType> pointRegions(numPts);
+    if (this->InScalars)
+    {
+      const ScalarCriterion criterion{ this->InScalars,
+        { this->ScalarRange[0], this->ScalarRange[1] }, this->FullScalarConnectivity != 0 };
+      this->RegionNumber = ::LabelConnectedRegions(
+        this->Mesh, &criterion, this->Visited, pointRegions.data(), this->RegionSizes);
+    }
+    else
+    {
+      this->RegionNumber = ::LabelConnectedRegions<ScalarCriterion>(
+        this->Mesh, nullptr, this->Visited, pointRegions.data(), this->RegionSizes);
+    }
+    this->UpdateProgress(0.8);
+
+    for (i = 0; i < this->RegionNumber; i++)
     {
-      if (cellId && !(cellId % 5000))
+      if (this->RegionSizes->GetValue(i) > maxCellsInRegion)
       {
-        this->UpdateProgress(0.1 + 0.8 * cellId / numCells);
+        maxCellsInRegion = this->RegionSizes->GetValue(i);
+        largestRegionId = i;
       }
-
-      if (this->Visited[cellId] < 0)
+    }
+    // Output points are ordered by increasing input point id.
+    vtkIdTypeArray* newScalars = vtkArrayDownCast<vtkIdTypeArray>(this->NewScalars);
+    for (i = 0; i < numPts; i++)
+    {
+      if (pointRegions[i] >= 0)
       {
-        this->NumCellsInRegion = 0;
-        this->Wave.push_back(cellId);
-        this->TraverseAndMark();
-
-        if (this->NumCellsInRegion > maxCellsInRegion)
-        {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
-        }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++, this->NumCellsInRegion);
-        this->Wave.clear();
-        this->Wave2.clear();
+        this->PointMap[i] = this->PointNumber++;
+        newScalars->SetValue(this->PointMap[i], pointRegions[i]);
       }
     }
+    this->UpdateProgress(0.9);
   }
   else // regions have been seeded, everything considered in same region
   {
@@ -292,6 +338,8 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   // if coloring regions; send down new scalar data
   if (this->ColorRegions)
   {
+    // The region ids were allocated for all the input points.
+    this->NewScalars->SetNumberOfTuples(this->PointNumber);
     int idx = outputPD->AddArray(this->NewScalars);
     outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
   }
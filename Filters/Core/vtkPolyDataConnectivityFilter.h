@@ -43,6 +43,11 @@
  * This use of ScalarConnectivity is particularly useful for selecting cells
  * for later processing.
  *
+ * When regions are not seeded (largest, specified or all regions), they are
+ * labeled in parallel using vtkSMPTools. Regions are numbered by increasing
+ * smallest cell id and output points are ordered by increasing input point
+ * id, so the output does not depend on the number of threads.
+ *
  * @sa
  * vtkConnectivityFilter
  */
@@ -15,6 +15,7 @@
 #include "vtkPolyDataNormals.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
@@ -27,12 +28,425 @@
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkTriangleStrip.h"
 
-#include "vtkNew.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Compute the normal of each polygon. The normals are written in the float
+// array at the polygon's position, so the result does not depend on the
+// number of threads.
+struct ComputePolygonNormals
+{
+  vtkCellArray* Polys;
+  vtkPoints* Points;
+  float* PolyNormals;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkCellArrayIterator>> CellIterator;
+
+  ComputePolygonNormals(vtkCellArray* polys, vtkPoints* pts, float* polyNormals)
+    : Polys(polys)
+    , Points(pts)
+    , PolyNormals(polyNormals)
+  {
+  }
+
+  void Initialize() { this->CellIterator.Local().TakeReference(this->Polys->NewIterator()); }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkCellArrayIterator* cellIter = this->CellIterator.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double n[3];
+    float* polyNormal = this->PolyNormals + 3 * cellId;
+
+    for (; cellId < endCellId; ++cellId, polyNormal += 3)
+    {
+      cellIter->GetCellAtId(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      polyNormal[0] = static_cast<float>(n[0]);
+      polyNormal[1] = static_cast<float>(n[1]);
+      polyNormal[2] = static_cast<float>(n[2]);
+    }
+  }
+
+  void Reduce() {}
+};
+
+//------------------------------------------------------------------------------
+// Splitting support. Around each point, the polygons using the point are
+// gathered into regions of polygons connected through edges which are not
+// feature edges. Each point is processed independently of the others: the
+// regions are recorded in thread local storage indexed by the (sorted) ids of
+// the polygons using the point, rather than in a dataset-wide array, so that
+// points can be processed concurrently.
+struct MarkFeatureRegions
+{
+  vtkPolyData* Mesh;
+  vtkCellArray* Polys;
+  const float* PolyNormals;
+  double CosAngle;
+
+  struct LocalData
+  {
+    vtkSmartPointer<vtkCellArrayIterator> CellIterator;
+    vtkSmartPointer<vtkIdList> Neighbors;
+    std::vector<vtkIdType> CellIds; // sorted, unique ids of the cells using the point
+    std::vector<int> Regions;       // region of each cell in CellIds
+
+    int& RegionOf(vtkIdType cellId)
+    {
+      return this->Regions[std::lower_bound(this->CellIds.begin(), this->CellIds.end(), cellId) -
+        this->CellIds.begin()];
+    }
+  };
+  vtkSMPThreadLocal<LocalData> Local;
+
+  MarkFeatureRegions(vtkPolyData* mesh, const float* polyNormals, double cosAngle)
+    : Mesh(mesh)
+    , Polys(mesh->GetPolys())
+    , PolyNormals(polyNormals)
+    , CosAngle(cosAngle)
+  {
+  }
+
+  void Initialize()
+  {
+    LocalData& local = this->Local.Local();
+    local.CellIterator.TakeReference(this->Polys->NewIterator());
+    local.Neighbors = vtkSmartPointer<vtkIdList>::New();
+    local.Neighbors->Allocate(VTK_CELL_SIZE);
+  }
+
+  // Label each subregion of cells using ptId that are connected (and not
+  // separated by a feature edge) with a region number, and return the
+  // number of regions. Regions are numbered in the order of the cells in the
+  // point's links so that the result matches a sequential traversal.
+  int MarkRegions(vtkIdType ptId, LocalData& local)
+  {
+    // Get the cells using this point and make sure that we have to do something
+    vtkIdType ncells;
+    vtkIdType* cells;
+    this->Mesh->GetPointCells(ptId, ncells, cells);
+    if (ncells <= 1)
+    {
+      return 1; // point does not need to be further disconnected
+    }
+
+    // Start by initializing the cells as unvisited
+    local.CellIds.assign(cells, cells + ncells);
+    std::sort(local.CellIds.begin(), local.CellIds.end());
+    local.CellIds.erase(
+      std::unique(local.CellIds.begin(), local.CellIds.end()), local.CellIds.end());
+    local.Regions.assign(local.CellIds.size(), -1);
+
+    vtkCellArrayIterator* cellIter = local.CellIterator;
+    vtkIdList* neighbors = local.Neighbors;
+    vtkIdType numPts;
+    const vtkIdType* pts;
+    int numRegions = 0;
+    vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
+    for (vtkIdType j = 0; j < ncells; j++) // for all cells connected to point
+    {
+      if (local.RegionOf(cells[j]) >= 0)
+      {
+        continue;
+      }
+      local.RegionOf(cells[j]) = numRegions;
+      // okay, mark all the cells connected to this seed cell and using ptId
+      cellIter->GetCellAtId(cells[j], numPts, pts);
+
+      // find the two edges
+      for (spot = 0; spot < numPts; spot++)
+      {
+        if (pts[spot] == ptId)
+        {
+          break;
+        }
+      }
+
+      if (spot == 0)
+      {
+        neiPt[0] = pts[spot + 1];
+        neiPt[1] = pts[numPts - 1];
+      }
+      else if (spot == (numPts - 1))
+      {
+        neiPt[0] = pts[spot - 1];
+        neiPt[1] = pts[0];
+      }
+      else
+      {
+        neiPt[0] = pts[spot + 1];
+        neiPt[1] = pts[spot - 1];
+      }
+
+      for (int i = 0; i < 2; i++) // for each of the two edges of the seed cell
+      {
+        cellId = cells[j];
+        nei = neiPt[i];
+        while (cellId >= 0) // while we can grow this region
+        {
+          this->Mesh->GetCellEdgeNeighbors(cellId, ptId, nei, neighbors);
+          if (neighbors->GetNumberOfIds() == 1 &&
+            local.RegionOf((neiCellId = neighbors->GetId(0))) < 0)
+          {
+            const float* thisNormal = this->PolyNormals + 3 * cellId;
+            const float* neiNormal = this->PolyNormals + 3 * neiCellId;
+            const double dot = static_cast<double>(thisNormal[0]) * neiNormal[0] +
+              static_cast<double>(thisNormal[1]) * neiNormal[1] +
+              static_cast<double>(thisNormal[2]) * neiNormal[2];
+
+            if (dot > this->CosAngle)
+            {
+              // visit and arrange to visit next edge neighbor
+              local.RegionOf(neiCellId) = numRegions;
+              cellId = neiCellId;
+              cellIter->GetCellAtId(cellId, numPts, pts);
+
+              for (spot = 0; spot < numPts; spot++)
+              {
+                if (pts[spot] == ptId)
+                {
+                  break;
+                }
+              }
+
+              if (spot == 0)
+              {
+                nei = (pts[spot + 1] != nei ? pts[spot + 1] : pts[numPts - 1]);
+              }
+              else if (spot == (numPts - 1))
+              {
+                nei = (pts[spot - 1] != nei ? pts[spot - 1] : pts[0]);
+              }
+              else
+              {
+                nei = (pts[spot + 1] != nei ? pts[spot + 1] : pts[spot - 1]);
+              }
+            } // if not separated by edge angle
+            else
+            {
+              cellId = -1; // separated by edge angle
+            }
+          } // if can move to edge neighbor
+          else
+          {
+            cellId = -1; // separated by previous visit, boundary, or non-manifold
+          }
+        } // while visit wave is propagating
+      }   // for each of the two edges of the starting cell
+      numRegions++;
+    } // for all cells connected to point ptId
+
+    return numRegions;
+  }
+};
+
+// First pass: count the number of points that have to be created for each
+// input point. For N regions around a point, N-1 duplicate points are needed.
+struct CountSplitPoints : public MarkFeatureRegions
+{
+  vtkIdType* NumSplits;
+
+  CountSplitPoints(
+    vtkPolyData* mesh, const float* polyNormals, double cosAngle, vtkIdType* numSplits)
+    : MarkFeatureRegions(mesh, polyNormals, cosAngle)
+    , NumSplits(numSplits)
+  {
+  }
+
+  // vtkSMPTools only detects an Initialize() member declared in the functor
+  // class itself.
+  void Initialize() { this->MarkFeatureRegions::Initialize(); }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    LocalData& local = this->Local.Local();
+    for (; ptId < endPtId; ++ptId)
+    {
+      this->NumSplits[ptId] = this->MarkRegions(ptId, local) - 1;
+    }
+  }
+
+  void Reduce() {}
+};
+
+// A point replacement in the connectivity of the output polygons.
+struct PointReplacement
+{
+  vtkIdType CellId;
+  vtkIdType CellPointIndex;
+  vtkIdType PointId;
+};
+
+// Second pass: for all cells not in the first region, the point is replaced
+// with a new point, which is a duplicate of the original one but
+// disconnected topologically. New point ids are given by the prefix sum of
+// the first pass, so they are the same as in a sequential traversal. The
+// replacements are only recorded here because the output connectivity is
+// also read while splitting other points.
+struct SplitPoints : public MarkFeatureRegions
+{
+  vtkCellArray* NewPolys;
+  const vtkIdType* SplitOffsets;
+  vtkIdType* Map;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkCellArrayIterator>> NewCellIterator;
+  vtkSMPThreadLocal<std::vector<PointReplacement>> Replacements;
+
+  SplitPoints(vtkPolyData* mesh, const float* polyNormals, double cosAngle, vtkCellArray* newPolys,
+    const vtkIdType* splitOffsets, vtkIdType* map)
+    : MarkFeatureRegions(mesh, polyNormals, cosAngle)
+    , NewPolys(newPolys)
+    , SplitOffsets(splitOffsets)
+    , Map(map)
+  {
+  }
+
+  void Initialize()
+  {
+    this->MarkFeatureRegions::Initialize();
+    this->NewCellIterator.Local().TakeReference(this->NewPolys->NewIterator());
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    LocalData& local = this->Local.Local();
+    vtkCellArrayIterator* newCellIter = this->NewCellIterator.Local();
+    std::vector<PointReplacement>& replacements = this->Replacements.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+
+    for (; ptId < endPtId; ++ptId)
+    {
+      const vtkIdType lastId = this->SplitOffsets[ptId];
+      if (lastId == this->SplitOffsets[ptId + 1])
+      {
+        continue; // a single region, no splitting required
+      }
+
+      this->MarkRegions(ptId, local);
+      for (size_t i = 0; i < local.CellIds.size(); ++i)
+      {
+        if (local.Regions[i] > 0) // replace point if splitting needed
+        {
+          const vtkIdType replacementPoint = lastId + local.Regions[i] - 1;
+          this->Map[replacementPoint] = ptId;
+          newCellIter->GetCellAtId(local.CellIds[i], npts, pts);
+          for (vtkIdType j = 0; j < npts; ++j)
+          {
+            if (pts[j] == ptId)
+            {
+              replacements.push_back(PointReplacement{ local.CellIds[i], j, replacementPoint });
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+// Apply the recorded point replacements to the output connectivity.
+struct ReplaceCellPoints
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, const std::vector<PointReplacement>& replacements)
+  {
+    using ValueType = typename CellStateT::ValueType;
+    auto* conn = state.GetConnectivity();
+    for (const PointReplacement& replacement : replacements)
+    {
+      conn->SetValue(state.GetBeginOffset(replacement.CellId) + replacement.CellPointIndex,
+        static_cast<ValueType>(replacement.PointId));
+    }
+  }
+};
+
+//------------------------------------------------------------------------------
+// Gather the normals of the polygons using each point. The polygon normals
+// are summed in increasing polygon id order, which is the order of the
+// sequential accumulation, so results are bitwise identical to it.
+struct GatherPointNormals
+{
+  vtkStaticCellLinksTemplate<vtkIdType>* Links;
+  const float* PolyNormals;
+  float* Normals;
+  vtkSMPThreadLocal<std::vector<vtkIdType>> CellIds;
+
+  GatherPointNormals(
+    vtkStaticCellLinksTemplate<vtkIdType>* links, const float* polyNormals, float* normals)
+    : Links(links)
+    , PolyNormals(polyNormals)
+    , Normals(normals)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    std::vector<vtkIdType>& cellIds = this->CellIds.Local();
+    float* normal = this->Normals + 3 * ptId;
+
+    for (; ptId < endPtId; ++ptId, normal += 3)
+    {
+      const vtkIdType* cells = this->Links->GetCells(ptId);
+      cellIds.assign(cells, cells + this->Links->GetNcells(ptId));
+      std::sort(cellIds.begin(), cellIds.end());
+      for (const vtkIdType cellId : cellIds)
+      {
+        const float* polyNormal = this->PolyNormals + 3 * cellId;
+        normal[0] += polyNormal[0];
+        normal[1] += polyNormal[1];
+        normal[2] += polyNormal[2];
+      }
+    }
+  }
+};
+
+//------------------------------------------------------------------------------
+struct NormalizePointNormals
+{
+  float* Normals;
+  double FlipDirection;
+
+  NormalizePointNormals(float* normals, double flipDirection)
+    : Normals(normals)
+    , FlipDirection(flipDirection)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    float* normal = this->Normals + 3 * ptId;
+    for (; ptId < endPtId; ++ptId, normal += 3)
+    {
+      const double length =
+        sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) *
+        this->FlipDirection;
+      if (length != 0.0)
+      {
+        normal[0] /= length;
+        normal[1] /= length;
+        normal[2] /= length;
+      }
+    }
+  }
+};
+
+} // anonymous namespace
+
 // Construct with feature angle=30, splitting and consistency turned on,
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -53,7 +467,6 @@ vtkPolyDataNormals::vtkPolyDataNormals()
   this->CellIds = nullptr;
   this->CellPoints = nullptr;
   this->NeighborPoints = nullptr;
-  this->Map = nullptr;
   this->OldMesh = nullptr;
   this->NewMesh = nullptr;
   this->Visited = nullptr;
@@ -91,7 +504,7 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   vtkDataSetAttributes* outCD = output->GetCellData();
   double n[3];
   vtkCellArray* newPolys;
-  vtkIdType ptId, oldId;
+  vtkIdType ptId;
 
   vtkDebugMacro(<< "Generating surface normals");
 
@@ -362,44 +775,67 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
     this->PolyNormals->SetTuple(cellId, n);
   }
 
-  for (cellId = 0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts); cellId++)
+  float* fPolyNormals = this->PolyNormals->WritePointer(3 * offsetCells, 3 * numPolys);
+  ComputePolygonNormals computePolygonNormals(newPolys, inPts, fPolyNormals);
+  // Polygons are processed in chunks, so that the calling thread reports
+  // progress and checks for an abort request in between.
+  const vtkIdType chunkSize = std::max<vtkIdType>(1000, numPolys / 20);
+  for (vtkIdType begin = 0; begin < numPolys; begin += chunkSize)
   {
-    if ((cellId % 1000) == 0)
+    this->UpdateProgress(0.333 + 0.167 * begin / numPolys);
+    if (this->GetAbortExecute())
     {
-      this->UpdateProgress(0.333 + 0.333 * (double)cellId / (double)numPolys);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
+      break;
     }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(offsetCells + cellId, n);
+    vtkSMPTools::For(begin, std::min(begin + chunkSize, numPolys), computePolygonNormals);
   }
 
+  this->UpdateProgress(0.5);
+
   // Split mesh if sharp features
   if (this->Splitting)
   {
     //  Traverse all nodes; evaluate loops and feature edges.  If feature
     //  edges found, split mesh creating new nodes.  Update polygon
-    // connectivity.
+    // connectivity. Points are processed in parallel: a first pass counts
+    // the points to create around each point, a prefix sum assigns the ids
+    // of the new points, and a second pass splits the mesh.
     //
     this->CosAngle = cos(vtkMath::RadiansFromDegrees(this->FeatureAngle));
+
+    std::vector<vtkIdType> splitOffsets(numPts + 1, 0);
+    CountSplitPoints countSplitPoints(
+      this->OldMesh, fPolyNormals, this->CosAngle, splitOffsets.data());
+    vtkSMPTools::For(0, numPts, countSplitPoints);
+
+    numNewPts = numPts;
+    for (ptId = 0; ptId < numPts; ptId++)
+    {
+      const vtkIdType numSplits = splitOffsets[ptId];
+      splitOffsets[ptId] = numNewPts;
+      numNewPts += numSplits;
+    }
+    splitOffsets[numPts] = numNewPts;
+
     //  Splitting will create new points.  We have to create index array
     // to map new points into old points.
     //
-    this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (vtkIdType i = 0; i < numPts; i++)
-    {
-      this->Map->SetId(i, i);
-    }
+    vtkNew<vtkIdList> map;
+    map->SetNumberOfIds(numNewPts);
+    vtkIdType* mapPtr = map->GetPointer(0);
+    std::iota(mapPtr, mapPtr + numPts, 0);
 
-    for (ptId = 0; ptId < numPts; ptId++)
+    if (numNewPts > numPts)
     {
-      this->MarkAndSplit(ptId);
-    } // for all input points
-
-    numNewPts = this->Map->GetNumberOfIds();
+      SplitPoints splitPoints(this->OldMesh, fPolyNormals, this->CosAngle, newPolys,
+        splitOffsets.data(), mapPtr);
+      vtkSMPTools::For(0, numPts, splitPoints);
+      for (const auto& replacements : splitPoints.Replacements)
+      {
+        newPolys->Visit(ReplaceCellPoints{}, replacements);
+      }
+      newPolys->Modified();
+    }
 
     vtkDebugMacro(<< "Created " << numNewPts - numPts << " new points");
 
@@ -433,13 +869,8 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
     }
 
     newPts->SetNumberOfPoints(numNewPts);
-    for (ptId = 0; ptId < numNewPts; ptId++)
-    {
-      oldId = this->Map->GetId(ptId);
-      newPts->SetPoint(ptId, inPts->GetPoint(oldId));
-      outPD->CopyData(pd, oldId, ptId);
-    }
-    this->Map->Delete();
+    inPts->GetPoints(map, newPts);
+    outPD->CopyData(pd, map);
   } // splitting
 
   else // no splitting, so no new points
@@ -477,33 +908,32 @@ int vtkPolyDataNormals::RequestData(vtkInformation* vtkNotUsed(request),
   float* fNormals = newNormals->WritePointer(0, 3 * numNewPts);
   std::fill_n(fNormals, 3 * numNewPts, 0);
 
-  float* fPolyNormals = this->PolyNormals->WritePointer(3 * offsetCells, 3 * numPolys);
-
   if (this->ComputePointNormals)
   {
-    for (cellId = 0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts); ++cellId)
+    if (vtkSMPTools::GetEstimatedNumberOfThreads() > 1)
     {
-      for (vtkIdType i = 0; i < npts; ++i)
-      {
-        fNormals[3 * pts[i]] += fPolyNormals[3 * cellId];
-        fNormals[3 * pts[i] + 1] += fPolyNormals[3 * cellId + 1];
-        fNormals[3 * pts[i] + 2] += fPolyNormals[3 * cellId + 2];
-      }
+      // Gather the polygon normals at each point using links, which avoids
+      // concurrent accumulation at shared points.
+      vtkStaticCellLinksTemplate<vtkIdType> links;
+      links.ThreadedBuildLinks(numNewPts, numPolys, newPolys);
+      GatherPointNormals gatherPointNormals(&links, fPolyNormals, fNormals);
+      vtkSMPTools::For(0, numNewPts, gatherPointNormals);
     }
-
-    for (vtkIdType i = 0; i < numNewPts; ++i)
+    else
     {
-      const double length =
-        sqrt(fNormals[3 * i] * fNormals[3 * i] + fNormals[3 * i + 1] * fNormals[3 * i + 1] +
-          fNormals[3 * i + 2] * fNormals[3 * i + 2]) *
-        flipDirection;
-      if (length != 0.0)
+      for (cellId = 0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts); ++cellId)
       {
-        fNormals[3 * i] /= length;
-        fNormals[3 * i + 1] /= length;
-        fNormals[3 * i + 2] /= length;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          fNormals[3 * pts[i]] += fPolyNormals[3 * cellId];
+          fNormals[3 * pts[i] + 1] += fPolyNormals[3 * cellId + 1];
+          fNormals[3 * pts[i] + 2] += fPolyNormals[3 * cellId + 2];
+        }
       }
     }
+
+    NormalizePointNormals normalizePointNormals(fNormals, flipDirection);
+    vtkSMPTools::For(0, numNewPts, normalizePointNormals);
   }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -624,155 +1054,6 @@ void vtkPolyDataNormals::TraverseAndOrder()
   } // while wave still propagating
 }
 
-//
-//  Mark polygons around vertex.  Create new vertex (if necessary) and
-//  replace (i.e., split mesh).
-//
-void vtkPolyDataNormals::MarkAndSplit(vtkIdType ptId)
-{
-  int i, j;
-
-  // Get the cells using this point and make sure that we have to do something
-  vtkIdType ncells;
-  vtkIdType* cells;
-  this->OldMesh->GetPointCells(ptId, ncells, cells);
-  if (ncells <= 1)
-  {
-    return; // point does not need to be further disconnected
-  }
-
-  // Start moving around the "cycle" of points using the point. Label
-  // each point as requiring a visit. Then label each subregion of cells
-  // connected to this point that are connected (and not separated by
-  // a feature edge) with a given region number. For each N regions
-  // created, N-1 duplicate (split) points are created. The split point
-  // replaces the current point ptId in the polygons connectivity array.
-  //
-  // Start by initializing the cells as unvisited
-  for (i = 0; i < ncells; i++)
-  {
-    this->Visited[cells[i]] = -1;
-  }
-
-  // Loop over all cells and mark the region that each is in.
-  //
-  vtkIdType numPts;
-  const vtkIdType* pts;
-  int numRegions = 0;
-  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
-  double thisNormal[3], neiNormal[3];
-  for (j = 0; j < ncells; j++) // for all cells connected to point
-  {
-    if (this->Visited[cells[j]] < 0) // for all unvisited cells
-    {
-      this->Visited[cells[j]] = numRegions;
-      // okay, mark all the cells connected to this seed cell and using ptId
-      this->OldMesh->GetCellPoints(cells[j], numPts, pts);
-
-      // find the two edges
-      for (spot = 0; spot < numPts; spot++)
-      {
-        if (pts[spot] == ptId)
-        {
-          break;
-        }
-      }
-
-      if (spot == 0)
-      {
-        neiPt[0] = pts[spot + 1];
-        neiPt[1] = pts[numPts - 1];
-      }
-      else if (spot == (numPts - 1))
-      {
-        neiPt[0] = pts[spot - 1];
-        neiPt[1] = pts[0];
-      }
-      else
-      {
-        neiPt[0] = pts[spot + 1];
-        neiPt[1] = pts[spot - 1];
-      }
-
-      for (i = 0; i < 2; i++) // for each of the two edges of the seed cell
-      {
-        cellId = cells[j];
-        nei = neiPt[i];
-        while (cellId >= 0) // while we can grow this region
-        {
-          this->OldMesh->GetCellEdgeNeighbors(cellId, ptId, nei, this->CellIds);
-          if (this->CellIds->GetNumberOfIds() == 1 &&
-            this->Visited[(neiCellId = this->CellIds->GetId(0))] < 0)
-          {
-            this->PolyNormals->GetTuple(cellId, thisNormal);
-            this->PolyNormals->GetTuple(neiCellId, neiNormal);
-
-            if (vtkMath::Dot(thisNormal, neiNormal) > CosAngle)
-            {
-              // visit and arrange to visit next edge neighbor
-              this->Visited[neiCellId] = numRegions;
-              cellId = neiCellId;
-              this->OldMesh->GetCellPoints(cellId, numPts, pts);
-
-              for (spot = 0; spot < numPts; spot++)
-              {
-                if (pts[spot] == ptId)
-                {
-                  break;
-                }
-              }
-
-              if (spot == 0)
-              {
-                nei = (pts[spot + 1] != nei ? pts[spot + 1] : pts[numPts - 1]);
-              }
-              else if (spot == (numPts - 1))
-              {
-                nei = (pts[spot - 1] != nei ? pts[spot - 1] : pts[0]);
-              }
-              else
-              {
-                nei = (pts[spot + 1] != nei ? pts[spot + 1] : pts[spot - 1]);
-              }
-
-            } // if not separated by edge angle
-            else
-            {
-              cellId = -1; // separated by edge angle
-            }
-          } // if can move to edge neighbor
-          else
-          {
-            cellId = -1; // separated by previous visit, boundary, or non-manifold
-          }
-        } // while visit wave is propagating
-      }   // for each of the two edges of the starting cell
-      numRegions++;
-    } // if cell is unvisited
-  }   // for all cells connected to point ptId
-
-  if (numRegions <= 1)
-  {
-    return; // a single region, no splitting ever required
-  }
-
-  // Okay, for all cells not in the first region, the ptId is
-  // replaced with a new ptId, which is a duplicate of the first
-  // point, but disconnected topologically.
-  //
-  vtkIdType lastId = this->Map->GetNumberOfIds();
-  vtkIdType replacementPoint;
-  for (j = 0; j < ncells; j++)
-  {
-    if (this->Visited[cells[j]] > 0) // replace point if splitting needed
-    {
-      replacementPoint = lastId + this->Visited[cells[j]] - 1;
-      this->Map->InsertId(replacementPoint, ptId);
-      this->NewMesh->ReplaceCellPoint(cells[j], ptId, replacementPoint);
-    } // if not in first regions and requiring splitting
-  }   // for all cells connected to ptId
-}
-
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
@@ -18,10 +18,12 @@
 #include "vtkBoundingBox.h"
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkCellLocatorCache.h"
 #include "vtkCellLocatorStrategy.h"
 #include "vtkCharArray.h"
 #include "vtkFindCellStrategy.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -30,6 +32,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
+#include "vtkPoints.h"
 #include "vtkSMPThreadLocal.h"
 #include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
@@ -41,6 +44,7 @@
 
 vtkStandardNewMacro(vtkProbeFilter);
 vtkCxxSetObjectMacro(vtkProbeFilter, CellLocatorPrototype, vtkAbstractCellLocator);
+vtkCxxSetObjectMacro(vtkProbeFilter, CellLocatorCache, vtkCellLocatorCache);
 vtkCxxSetObjectMacro(vtkProbeFilter, FindCellStrategy, vtkFindCellStrategy);
 
 #define CELL_TOLERANCE_FACTOR_SQR 1e-6
@@ -72,6 +76,7 @@ vtkProbeFilter::vtkProbeFilter()
   this->CellArrays = new vtkVectorOfArrays();
 
   this->CellLocatorPrototype = nullptr;
+  this->CellLocatorCache = nullptr;
   this->FindCellStrategy = nullptr;
 
   this->PointList = nullptr;
@@ -95,6 +100,7 @@ vtkProbeFilter::~vtkProbeFilter()
 
   this->SetValidPointMaskArrayName(nullptr);
   this->SetCellLocatorPrototype(nullptr);
+  this->SetCellLocatorCache(nullptr);
   this->SetFindCellStrategy(nullptr);
 
   delete this->CellArrays;
@@ -455,6 +461,13 @@ void vtkProbeFilter::ProbeEmptyPoints(
       this->FindCellStrategy->Initialize(ps);
       strategy = this->FindCellStrategy;
     }
+    else if (this->CellLocatorCache != nullptr)
+    {
+      // the strategy registers the locator owned by the cache
+      cellLocStrategy->SetCellLocator(
+        this->CellLocatorCache->GetCellLocator(source, this->CellLocatorPrototype));
+      strategy = static_cast<vtkFindCellStrategy*>(cellLocStrategy.GetPointer());
+    }
     else if (this->CellLocatorPrototype != nullptr)
     {
       cellLocStrategy->SetCellLocator(this->CellLocatorPrototype->NewInstance());
@@ -475,6 +488,39 @@ void vtkProbeFilter::ProbeEmptyPoints(
     vtkDebugMacro(<< "Using strategy: " << strategy->GetClassName());
   }
 
+  // If the strategy uses a cell locator that supports concurrent queries,
+  // find the cells of all the points to probe at once.
+  std::vector<vtkIdType> batchCellIds;
+  vtkCellLocatorStrategy* locStrategy = vtkCellLocatorStrategy::SafeDownCast(strategy);
+  vtkAbstractCellLocator* locator = locStrategy ? locStrategy->GetCellLocator() : nullptr;
+  if (locator && locator->SupportsConcurrentQueries())
+  {
+    vtkNew<vtkPoints> queryPoints;
+    queryPoints->SetDataTypeToDouble();
+    queryPoints->Allocate(numPts);
+    for (ptId = 0; ptId < numPts; ptId++)
+    {
+      if (maskArray[ptId] != static_cast<char>(1))
+      {
+        input->GetPoint(ptId, x);
+        queryPoints->InsertNextPoint(x);
+      }
+    }
+    vtkNew<vtkIdList> foundCellIds;
+    locator->FindCells(queryPoints, tol2, foundCellIds);
+
+    batchCellIds.resize(numPts, -1);
+    vtkIdType queryId = 0;
+    for (ptId = 0; ptId < numPts; ptId++)
+    {
+      if (maskArray[ptId] != static_cast<char>(1))
+      {
+        batchCellIds[ptId] = foundCellIds->GetId(queryId++);
+      }
+    }
+  }
+  const bool batched = !batchCellIds.empty();
+
   // Loop over all input points, interpolating source data
   //
   vtkNew<vtkGenericCell> gcell;
@@ -498,22 +544,31 @@ void vtkProbeFilter::ProbeEmptyPoints(
     // Get the xyz coordinate of the point in the input dataset
     input->GetPoint(ptId, x);
 
-    vtkIdType cellId = (strategy != nullptr)
-      ? strategy->FindCell(x, nullptr, gcell.GetPointer(), -1, tol2, subId, pcoords, weights)
-      : source->FindCell(x, nullptr, -1, tol2, subId, pcoords, weights);
+    vtkIdType cellId;
+    if (batched)
+    {
+      cellId = batchCellIds[ptId];
+    }
+    else
+    {
+      cellId = (strategy != nullptr)
+        ? strategy->FindCell(x, nullptr, gcell.GetPointer(), -1, tol2, subId, pcoords, weights)
+        : source->FindCell(x, nullptr, -1, tol2, subId, pcoords, weights);
+    }
 
     vtkCell* cell = nullptr;
     if (cellId >= 0 && !::IsBlankedCell(sourceGhostFlags, cellId))
     {
       cell = source->GetCell(cellId);
-      if (this->ComputeTolerance)
+      if (this->ComputeTolerance || batched)
       {
-        // If ComputeTolerance is set, compute a tolerance proportional to the
+        // The weights of the cells found in batch are computed here. If
+        // ComputeTolerance is set, compute a tolerance proportional to the
         // cell length.
         double dist2;
         double closestPoint[3];
         cell->EvaluatePosition(x, closestPoint, subId, pcoords, dist2, weights);
-        if (dist2 > (cell->GetLength2() * CELL_TOLERANCE_FACTOR_SQR))
+        if (this->ComputeTolerance && dist2 > (cell->GetLength2() * CELL_TOLERANCE_FACTOR_SQR))
         {
           continue;
         }
@@ -1050,4 +1105,5 @@ void vtkProbeFilter::PrintSelf(ostream& os, vtkIndent indent)
      << (this->FindCellStrategy ? this->FindCellStrategy->GetClassName() : "NULL") << "\n";
   os << indent << "CellLocatorPrototype: "
      << (this->CellLocatorPrototype ? this->CellLocatorPrototype->GetClassName() : "NULL") << "\n";
+  os << indent << "CellLocatorCache: " << this->CellLocatorCache << "\n";
 }
@@ -46,7 +46,9 @@
  * by specifying an instance of vtkFindCellStrategy. (Note: image data
  * probing never uses a locator since finding a containing cell is a simple,
  * fast operation. This specifying a vtkFindCellStrategy or cell locator
- * prototype has no effect.)
+ * prototype has no effect.) When the source changes at each time step but
+ * its mesh does not, specify a vtkCellLocatorCache so that the cell locator
+ * is built once.
  *
  * @warning
  * The vtkProbeFilter, once it finds the cell containing a query point, uses
@@ -59,7 +61,7 @@
  *
  * @sa
  * vtkFindCellStrategy vtkPointLocator vtkCellLocator vtkStaticPointLocator
- * vtkStaticCellLocator vtkPointInterpolator vtkSPHInterpolator
+ * vtkStaticCellLocator vtkPointInterpolator vtkSPHInterpolator vtkCellLocatorCache
  */
 
 #ifndef vtkProbeFilter_h
@@ -71,6 +73,7 @@
 
 class vtkAbstractCellLocator;
 class vtkCell;
+class vtkCellLocatorCache;
 class vtkCharArray;
 class vtkIdTypeArray;
 class vtkImageData;
@@ -222,6 +225,18 @@ public:
   vtkGetObjectMacro(CellLocatorPrototype, vtkAbstractCellLocator);
   ///@}
 
+  ///@{
+  /**
+   * Set/Get the cache of cell locators. When a vtkFindCellStrategy is not
+   * defined, the cell locator built for the mesh of the source, of the class
+   * of the prototype or a vtkStaticCellLocator, is taken from the cache, so
+   * that it is reused as long as the mesh does not change. The same cache can
+   * be shared by several filters. By default there is no cache.
+   */
+  virtual void SetCellLocatorCache(vtkCellLocatorCache*);
+  vtkGetObjectMacro(CellLocatorCache, vtkCellLocatorCache);
+  ///@}
+
 protected:
   vtkProbeFilter();
   ~vtkProbeFilter() override;
@@ -276,6 +291,7 @@ protected:
 
   // Support various methods to support the FindCell() operation
   vtkAbstractCellLocator* CellLocatorPrototype;
+  vtkCellLocatorCache* CellLocatorCache;
   vtkFindCellStrategy* FindCellStrategy;
 
   vtkDataSetAttributes::FieldList* CellList;
@@ -49,12 +49,74 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+// An edge of the working mesh and the cost of collapsing it. Edges are sorted
+// by cost, then by end points so that the order is unique.
+struct vtkQuadricEdge
+{
+  double Cost;
+  vtkIdType Pt0Id;
+  vtkIdType Pt1Id;
+
+  bool operator<(const vtkQuadricEdge& other) const
+  {
+    if (this->Cost != other.Cost)
+    {
+      return this->Cost < other.Cost;
+    }
+    return this->Pt0Id < other.Pt0Id || (this->Pt0Id == other.Pt0Id && this->Pt1Id < other.Pt1Id);
+  }
+};
+
+// Temporary arrays used by a thread to collapse edges in parallel.
+struct vtkQuadricWorkspace
+{
+  std::vector<double> X;
+  std::vector<double> Quad;
+  std::vector<double> B;
+  std::vector<double> Data;
+  std::vector<double*> A;
+  std::vector<vtkIdType> PointIds;
+  vtkSmartPointer<vtkIdList> CellIds;
+
+  void Initialize(int size, int quadSize)
+  {
+    if (this->CellIds)
+    {
+      return;
+    }
+    this->X.resize(size);
+    this->Quad.resize(quadSize);
+    this->B.resize(size);
+    this->Data.resize(size * size);
+    this->A.resize(size);
+    for (int i = 0; i < size; i++)
+    {
+      this->A[i] = this->Data.data() + i * size;
+    }
+    this->CellIds = vtkSmartPointer<vtkIdList>::New();
+  }
+};
+}
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
 //------------------------------------------------------------------------------
@@ -74,6 +136,7 @@ vtkQuadricDecimation::vtkQuadricDecimation()
 
   this->AttributeErrorMetric = 0;
   this->VolumePreservation = 0;
+  this->ParallelCollapse = 0;
   this->ScalarsAttribute = 1;
   this->VectorsAttribute = 1;
   this->NormalsAttribute = 1;
@@ -226,6 +289,11 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
   this->Mesh->SetPoints(points);
   points->Delete();
   polys->DeepCopy(input->GetPolys());
+  if (this->ParallelCollapse && !polys->IsStorageShareable())
+  {
+    // pointers to the cell points are used from several threads
+    polys->ConvertToDefaultStorage();
+  }
   this->Mesh->SetPolys(polys);
   polys->Delete();
   if (this->AttributeErrorMetric)
@@ -248,24 +316,28 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
-  vtkDebugMacro(<< "Computing Edges");
-  this->Edges->InitEdgeInsertion(numPts, 1); // storing edge id as attribute
-  this->EdgeCosts->Allocate(this->Mesh->GetPolys()->GetNumberOfCells() * 3);
-  for (i = 0; i < this->Mesh->GetNumberOfCells(); i++)
+  // the parallel collapse computes the edges at each round
+  if (!this->ParallelCollapse)
   {
-    this->Mesh->GetCellPoints(i, npts, pts);
-
-    for (j = 0; j < 3; j++)
+    vtkDebugMacro(<< "Computing Edges");
+    this->Edges->InitEdgeInsertion(numPts, 1); // storing edge id as attribute
+    this->EdgeCosts->Allocate(this->Mesh->GetPolys()->GetNumberOfCells() * 3);
+    for (i = 0; i < this->Mesh->GetNumberOfCells(); i++)
     {
-      if (this->Edges->IsEdge(pts[j], pts[(j + 1) % 3]) == -1)
+      this->Mesh->GetCellPoints(i, npts, pts);
+
+      for (j = 0; j < 3; j++)
       {
-        // If this edge has not been processed, get an id for it, add it to
-        // the edge list (Edges), and add its endpoints to the EndPoint1List
-        // and EndPoint2List (the 2 endpoints to different lists).
-        edgeId = this->Edges->GetNumberOfEdges();
-        this->Edges->InsertEdge(pts[j], pts[(j + 1) % 3], edgeId);
-        this->EndPoint1List->InsertId(edgeId, pts[j]);
-        this->EndPoint2List->InsertId(edgeId, pts[(j + 1) % 3]);
+        if (this->Edges->IsEdge(pts[j], pts[(j + 1) % 3]) == -1)
+        {
+          // If this edge has not been processed, get an id for it, add it to
+          // the edge list (Edges), and add its endpoints to the EndPoint1List
+          // and EndPoint2List (the 2 endpoints to different lists).
+          edgeId = this->Edges->GetNumberOfEdges();
+          this->Edges->InsertEdge(pts[j], pts[(j + 1) % 3], edgeId);
+          this->EndPoint1List->InsertId(edgeId, pts[j]);
+          this->EndPoint2List->InsertId(edgeId, pts[(j + 1) % 3]);
+        }
       }
     }
   }
@@ -298,74 +370,83 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
   this->AddBoundaryConstraints();
   this->UpdateProgress(0.15);
 
-  vtkDebugMacro(<< "Computing Costs");
-  // Compute the cost of and target point for collapsing each edge.
-  for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
-  {
-    if (this->AttributeErrorMetric)
-    {
-      cost = this->ComputeCost2(i, x);
-    }
-    else
-    {
-      cost = this->ComputeCost(i, x);
-    }
-    this->EdgeCosts->Insert(cost, i);
-    this->TargetPoints->InsertTuple(i, x);
-  }
-  this->UpdateProgress(0.20);
-
-  // Okay collapse edges until desired reduction is reached
   this->ActualReduction = 0.0;
   this->NumberOfEdgeCollapses = 0;
-  edgeId = this->EdgeCosts->Pop(0, cost);
-
-  int abort = 0;
-  while (
-    !abort && edgeId >= 0 && cost < VTK_DOUBLE_MAX && this->ActualReduction < this->TargetReduction)
+  if (this->ParallelCollapse)
   {
-    if (!(this->NumberOfEdgeCollapses % 10000))
+    vtkDebugMacro(<< "Collapsing edges in parallel");
+    numDeletedTris = this->ParallelCollapseEdges(numTris);
+    vtkDebugMacro(<< "Number Of Edge Collapses: " << this->NumberOfEdgeCollapses);
+  }
+  else
+  {
+    vtkDebugMacro(<< "Computing Costs");
+    // Compute the cost of and target point for collapsing each edge.
+    for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
     {
-      vtkDebugMacro(<< "Collapsing edge#" << this->NumberOfEdgeCollapses);
-      this->UpdateProgress(0.20 + 0.80 * this->NumberOfEdgeCollapses / numPts);
-      abort = this->GetAbortExecute();
+      if (this->AttributeErrorMetric)
+      {
+        cost = this->ComputeCost2(i, x);
+      }
+      else
+      {
+        cost = this->ComputeCost(i, x);
+      }
+      this->EdgeCosts->Insert(cost, i);
+      this->TargetPoints->InsertTuple(i, x);
     }
+    this->UpdateProgress(0.20);
 
-    endPtIds[0] = this->EndPoint1List->GetId(edgeId);
-    endPtIds[1] = this->EndPoint2List->GetId(edgeId);
-    this->TargetPoints->GetTuple(edgeId, x);
+    // Okay collapse edges until desired reduction is reached
+    edgeId = this->EdgeCosts->Pop(0, cost);
 
-    // check for a poorly placed point
-    if (!this->IsGoodPlacement(endPtIds[0], endPtIds[1], x))
+    int abort = 0;
+    while (!abort && edgeId >= 0 && cost < VTK_DOUBLE_MAX &&
+      this->ActualReduction < this->TargetReduction)
     {
-      vtkDebugMacro(<< "Poor placement detected " << edgeId << " " << cost);
-      // return the point to the queue but with the max cost so that
-      // when it is recomputed it will be reconsidered
-      this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
+      if (!(this->NumberOfEdgeCollapses % 10000))
+      {
+        vtkDebugMacro(<< "Collapsing edge#" << this->NumberOfEdgeCollapses);
+        this->UpdateProgress(0.20 + 0.80 * this->NumberOfEdgeCollapses / numPts);
+        abort = this->GetAbortExecute();
+      }
 
-      edgeId = this->EdgeCosts->Pop(0, cost);
-      continue;
-    }
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+      this->TargetPoints->GetTuple(edgeId, x);
 
-    this->NumberOfEdgeCollapses++;
+      // check for a poorly placed point
+      if (!this->IsGoodPlacement(endPtIds[0], endPtIds[1], x))
+      {
+        vtkDebugMacro(<< "Poor placement detected " << edgeId << " " << cost);
+        // return the point to the queue but with the max cost so that
+        // when it is recomputed it will be reconsidered
+        this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
 
-    // Set the new coordinates of point0.
-    this->SetPointAttributeArray(endPtIds[0], x);
-    vtkDebugMacro(<< "Cost: " << cost << " Edge: " << endPtIds[0] << " " << endPtIds[1]);
+        edgeId = this->EdgeCosts->Pop(0, cost);
+        continue;
+      }
 
-    // Merge the quadrics of the two points.
-    this->AddQuadric(endPtIds[1], endPtIds[0]);
+      this->NumberOfEdgeCollapses++;
 
-    this->UpdateEdgeData(endPtIds[0], endPtIds[1]);
+      // Set the new coordinates of point0.
+      this->SetPointAttributeArray(endPtIds[0], x);
+      vtkDebugMacro(<< "Cost: " << cost << " Edge: " << endPtIds[0] << " " << endPtIds[1]);
 
-    // Update the output triangles.
-    numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
-    this->ActualReduction = (double)numDeletedTris / numTris;
-    edgeId = this->EdgeCosts->Pop(0, cost);
-  }
+      // Merge the quadrics of the two points.
+      this->AddQuadric(endPtIds[1], endPtIds[0]);
 
-  vtkDebugMacro(<< "Number Of Edge Collapses: " << this->NumberOfEdgeCollapses
-                << " Cost: " << cost);
+      this->UpdateEdgeData(endPtIds[0], endPtIds[1]);
+
+      // Update the output triangles.
+      numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
+      this->ActualReduction = (double)numDeletedTris / numTris;
+      edgeId = this->EdgeCosts->Pop(0, cost);
+    }
+
+    vtkDebugMacro(<< "Number Of Edge Collapses: " << this->NumberOfEdgeCollapses
+                  << " Cost: " << cost);
+  }
 
   // clean up working data
   for (i = 0; i < numPts; i++)
@@ -419,18 +500,13 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
 }
 
 //------------------------------------------------------------------------------
-void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
+void vtkQuadricDecimation::ComputeTriangleQuadric(
+  const vtkIdType* pts, double* QEM, double n[3], double& d, double& area)
 {
   vtkPolyData* input = this->Mesh;
-  double* QEM;
-  vtkIdType ptId;
-  int i, j;
-  vtkCellArray* polys;
-  vtkIdType npts;
-  const vtkIdType* pts = nullptr;
+  int i;
   double point0[3], point1[3], point2[3];
-  double n[3];
-  double tempP1[3], tempP2[3], d, triArea2;
+  double tempP1[3], tempP2[3];
   double data[16];
   double *A[4], x[4];
   int index[4];
@@ -439,211 +515,278 @@ void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
   A[2] = data + 8;
   A[3] = data + 12;
 
-  // allocate local QEM sparse matrix
-  QEM = new double[11 + 4 * this->NumberOfComponents];
-
-  // clear and allocate global QEM array
-  for (ptId = 0; ptId < numPts; ptId++)
+  input->GetPoint(pts[0], point0);
+  input->GetPoint(pts[1], point1);
+  input->GetPoint(pts[2], point2);
+  for (i = 0; i < 3; i++)
   {
-    this->ErrorQuadrics[ptId].Quadric = new double[11 + 4 * this->NumberOfComponents];
-    for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
-    {
-      this->ErrorQuadrics[ptId].Quadric[i] = 0.0;
-    }
+    tempP1[i] = point1[i] - point0[i];
+    tempP2[i] = point2[i] - point0[i];
   }
-
-  polys = input->GetPolys();
-  // compute the QEM for each face
-  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  vtkMath::Cross(tempP1, tempP2, n);
+  area = vtkMath::Normalize(n);
+  // area = (area * area * 0.25);
+  area = area * 0.5;
+  // I am unsure whether this should be squared or not??
+  d = -vtkMath::Dot(n, point0);
+  // could possible add in angle weights??
+
+  // set the geometric part of the QEM
+  QEM[0] = n[0] * n[0];
+  QEM[1] = n[0] * n[1];
+  QEM[2] = n[0] * n[2];
+  QEM[3] = d * n[0];
+
+  QEM[4] = n[1] * n[1];
+  QEM[5] = n[1] * n[2];
+  QEM[6] = d * n[1];
+
+  QEM[7] = n[2] * n[2];
+  QEM[8] = d * n[2];
+
+  QEM[9] = d * d;
+  QEM[10] = 1;
+
+  // reset the attribute part so that it is never left from another triangle
+  for (i = 11; i < 11 + 4 * this->NumberOfComponents; i++)
+  {
+    QEM[i] = 0.0;
+  }
+  if (this->AttributeErrorMetric)
   {
-    input->GetPoint(pts[0], point0);
-    input->GetPoint(pts[1], point1);
-    input->GetPoint(pts[2], point2);
     for (i = 0; i < 3; i++)
     {
-      tempP1[i] = point1[i] - point0[i];
-      tempP2[i] = point2[i] - point0[i];
+      A[0][i] = point0[i];
+      A[1][i] = point1[i];
+      A[2][i] = point2[i];
+      A[3][i] = n[i];
     }
-    vtkMath::Cross(tempP1, tempP2, n);
-    triArea2 = vtkMath::Normalize(n);
-    // triArea2 = (triArea2 * triArea2 * 0.25);
-    triArea2 = triArea2 * 0.5;
-    // I am unsure whether this should be squared or not??
-    d = -vtkMath::Dot(n, point0);
-    // could possible add in angle weights??
-
-    // set the geometric part of the QEM
-    QEM[0] = n[0] * n[0];
-    QEM[1] = n[0] * n[1];
-    QEM[2] = n[0] * n[2];
-    QEM[3] = d * n[0];
-
-    QEM[4] = n[1] * n[1];
-    QEM[5] = n[1] * n[2];
-    QEM[6] = d * n[1];
-
-    QEM[7] = n[2] * n[2];
-    QEM[8] = d * n[2];
-
-    QEM[9] = d * d;
-    QEM[10] = 1;
+    A[0][3] = A[1][3] = A[2][3] = 1;
+    A[3][3] = 0;
 
-    if (this->AttributeErrorMetric)
+    // should handle poorly condition matrix better
+    if (vtkMath::LUFactorLinearSystem(A, index, 4))
     {
-      for (i = 0; i < 3; i++)
-      {
-        A[0][i] = point0[i];
-        A[1][i] = point1[i];
-        A[2][i] = point2[i];
-        A[3][i] = n[i];
-      }
-      A[0][3] = A[1][3] = A[2][3] = 1;
-      A[3][3] = 0;
-
-      // should handle poorly condition matrix better
-      if (vtkMath::LUFactorLinearSystem(A, index, 4))
+      for (i = 0; i < this->NumberOfComponents; i++)
       {
-        for (i = 0; i < this->NumberOfComponents; i++)
+        x[3] = 0;
+        if (i < this->AttributeComponents[0])
         {
-          x[3] = 0;
-          if (i < this->AttributeComponents[0])
-          {
-            x[0] = input->GetPointData()->GetScalars()->GetComponent(pts[0], i) *
-              this->AttributeScale[0];
-            x[1] = input->GetPointData()->GetScalars()->GetComponent(pts[1], i) *
-              this->AttributeScale[0];
-            x[2] = input->GetPointData()->GetScalars()->GetComponent(pts[2], i) *
-              this->AttributeScale[0];
-          }
-          else if (i < this->AttributeComponents[1])
-          {
-            x[0] = input->GetPointData()->GetVectors()->GetComponent(
-                     pts[0], i - this->AttributeComponents[0]) *
-              this->AttributeScale[1];
-            x[1] = input->GetPointData()->GetVectors()->GetComponent(
-                     pts[1], i - this->AttributeComponents[0]) *
-              this->AttributeScale[1];
-            x[2] = input->GetPointData()->GetVectors()->GetComponent(
-                     pts[2], i - this->AttributeComponents[0]) *
-              this->AttributeScale[1];
-          }
-          else if (i < this->AttributeComponents[2])
-          {
-            x[0] = input->GetPointData()->GetNormals()->GetComponent(
-                     pts[0], i - this->AttributeComponents[1]) *
-              this->AttributeScale[2];
-            x[1] = input->GetPointData()->GetNormals()->GetComponent(
-                     pts[1], i - this->AttributeComponents[1]) *
-              this->AttributeScale[2];
-            x[2] = input->GetPointData()->GetNormals()->GetComponent(
-                     pts[2], i - this->AttributeComponents[1]) *
-              this->AttributeScale[2];
-          }
-          else if (i < this->AttributeComponents[3])
-          {
-            x[0] = input->GetPointData()->GetTCoords()->GetComponent(
-                     pts[0], i - this->AttributeComponents[2]) *
-              this->AttributeScale[3];
-            x[1] = input->GetPointData()->GetTCoords()->GetComponent(
-                     pts[1], i - this->AttributeComponents[2]) *
-              this->AttributeScale[3];
-            x[2] = input->GetPointData()->GetTCoords()->GetComponent(
-                     pts[2], i - this->AttributeComponents[2]) *
-              this->AttributeScale[3];
-          }
-          else if (i < this->AttributeComponents[4])
-          {
-            x[0] = input->GetPointData()->GetTensors()->GetComponent(
-                     pts[0], i - this->AttributeComponents[3]) *
-              this->AttributeScale[4];
-            x[1] = input->GetPointData()->GetTensors()->GetComponent(
-                     pts[1], i - this->AttributeComponents[3]) *
-              this->AttributeScale[4];
-            x[2] = input->GetPointData()->GetTensors()->GetComponent(
-                     pts[2], i - this->AttributeComponents[3]) *
-              this->AttributeScale[4];
-          }
-          vtkMath::LUSolveLinearSystem(A, index, x, 4);
+          x[0] = input->GetPointData()->GetScalars()->GetComponent(pts[0], i) *
+            this->AttributeScale[0];
+          x[1] = input->GetPointData()->GetScalars()->GetComponent(pts[1], i) *
+            this->AttributeScale[0];
+          x[2] = input->GetPointData()->GetScalars()->GetComponent(pts[2], i) *
+            this->AttributeScale[0];
+        }
+        else if (i < this->AttributeComponents[1])
+        {
+          x[0] = input->GetPointData()->GetVectors()->GetComponent(
+                   pts[0], i - this->AttributeComponents[0]) *
+            this->AttributeScale[1];
+          x[1] = input->GetPointData()->GetVectors()->GetComponent(
+                   pts[1], i - this->AttributeComponents[0]) *
+            this->AttributeScale[1];
+          x[2] = input->GetPointData()->GetVectors()->GetComponent(
+                   pts[2], i - this->AttributeComponents[0]) *
+            this->AttributeScale[1];
+        }
+        else if (i < this->AttributeComponents[2])
+        {
+          x[0] = input->GetPointData()->GetNormals()->GetComponent(
+                   pts[0], i - this->AttributeComponents[1]) *
+            this->AttributeScale[2];
+          x[1] = input->GetPointData()->GetNormals()->GetComponent(
+                   pts[1], i - this->AttributeComponents[1]) *
+            this->AttributeScale[2];
+          x[2] = input->GetPointData()->GetNormals()->GetComponent(
+                   pts[2], i - this->AttributeComponents[1]) *
+            this->AttributeScale[2];
+        }
+        else if (i < this->AttributeComponents[3])
+        {
+          x[0] = input->GetPointData()->GetTCoords()->GetComponent(
+                   pts[0], i - this->AttributeComponents[2]) *
+            this->AttributeScale[3];
+          x[1] = input->GetPointData()->GetTCoords()->GetComponent(
+                   pts[1], i - this->AttributeComponents[2]) *
+            this->AttributeScale[3];
+          x[2] = input->GetPointData()->GetTCoords()->GetComponent(
+                   pts[2], i - this->AttributeComponents[2]) *
+            this->AttributeScale[3];
+        }
+        else if (i < this->AttributeComponents[4])
+        {
+          x[0] = input->GetPointData()->GetTensors()->GetComponent(
+                   pts[0], i - this->AttributeComponents[3]) *
+            this->AttributeScale[4];
+          x[1] = input->GetPointData()->GetTensors()->GetComponent(
+                   pts[1], i - this->AttributeComponents[3]) *
+            this->AttributeScale[4];
+          x[2] = input->GetPointData()->GetTensors()->GetComponent(
+                   pts[2], i - this->AttributeComponents[3]) *
+            this->AttributeScale[4];
+        }
+        vtkMath::LUSolveLinearSystem(A, index, x, 4);
 
-          // add in the contribution of this element into the QEM
-          QEM[0] += x[0] * x[0];
-          QEM[1] += x[0] * x[1];
-          QEM[2] += x[0] * x[2];
-          QEM[3] += x[3] * x[0];
+        // add in the contribution of this element into the QEM
+        QEM[0] += x[0] * x[0];
+        QEM[1] += x[0] * x[1];
+        QEM[2] += x[0] * x[2];
+        QEM[3] += x[3] * x[0];
 
-          QEM[4] += x[1] * x[1];
-          QEM[5] += x[1] * x[2];
-          QEM[6] += x[3] * x[1];
+        QEM[4] += x[1] * x[1];
+        QEM[5] += x[1] * x[2];
+        QEM[6] += x[3] * x[1];
 
-          QEM[7] += x[2] * x[2];
-          QEM[8] += x[3] * x[2];
+        QEM[7] += x[2] * x[2];
+        QEM[8] += x[3] * x[2];
 
-          QEM[9] += x[3] * x[3];
+        QEM[9] += x[3] * x[3];
 
-          QEM[11 + i * 4] = -x[0];
-          QEM[12 + i * 4] = -x[1];
-          QEM[13 + i * 4] = -x[2];
-          QEM[14 + i * 4] = -x[3];
-        }
-      }
-      else
-      {
-        vtkErrorMacro(<< "Unable to factor attribute matrix!");
+        QEM[11 + i * 4] = -x[0];
+        QEM[12 + i * 4] = -x[1];
+        QEM[13 + i * 4] = -x[2];
+        QEM[14 + i * 4] = -x[3];
       }
     }
+    else
+    {
+      vtkErrorMacro(<< "Unable to factor attribute matrix!");
+    }
+  }
+}
 
-    // add the QEM to all points of the face
-    for (i = 0; i < 3; i++)
+//------------------------------------------------------------------------------
+void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
+{
+  // The quadric of each triangle, weighted by its area, is computed once and
+  // followed by its volume constraint.
+  const int size = 11 + 4 * this->NumberOfComponents;
+  const int stride = size + 4;
+  const vtkIdType numTris = this->Mesh->GetNumberOfCells();
+  std::vector<double> triQuadrics(numTris * stride);
+  vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+    std::vector<double> QEM(size);
+    double n[3], d, triArea2;
+    vtkIdType npts;
+    const vtkIdType* pts;
+
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
     {
-      for (j = 0; j < 11 + 4 * this->NumberOfComponents; j++)
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      this->ComputeTriangleQuadric(pts, QEM.data(), n, d, triArea2);
+      double* triQuadric = triQuadrics.data() + cellId * stride;
+      for (int j = 0; j < size; j++)
       {
-        this->ErrorQuadrics[pts[i]].Quadric[j] += QEM[j] * triArea2;
+        triQuadric[j] = QEM[j] * triArea2;
       }
 
-      // Set volume constraint values g_vol and d_vol
-      if (this->VolumePreservation)
+      // Volume constraint values: vector g_vol, the triangle normal with
+      // length triArea * 2, and scalar d_vol, its product with the position
+      // of pts[0]
+      for (int j = 0; j < 3; j++)
       {
-        // Vector g_vol
-        for (j = 0; j < 3; j++)
+        triQuadric[size + j] = n[j] * triArea2 * 2.0;
+      }
+      triQuadric[size + 3] = -d * triArea2 * 2.0;
+    }
+  });
+
+  // Each point sums the quadrics of the triangles using it, in the order of
+  // the triangles, so that the result does not depend on the number of
+  // threads.
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdType ncells;
+    vtkIdType* cells;
+
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+    {
+      double* quadric = new double[size];
+      std::fill(quadric, quadric + size, 0.0);
+      this->ErrorQuadrics[ptId].Quadric = quadric;
+      double* volume = this->VolumePreservation ? this->VolumeConstraints + ptId * 4 : nullptr;
+
+      this->Mesh->GetPointCells(ptId, ncells, cells);
+      for (vtkIdType i = 0; i < ncells; i++)
+      {
+        const double* triQuadric = triQuadrics.data() + cells[i] * stride;
+        for (int j = 0; j < size; j++)
         {
-          this->VolumeConstraints[pts[i] * 4 + j] +=
-            n[j] * triArea2 * 2.0; // triangle normal with length triArea * 2
+          quadric[j] += triQuadric[j];
+        }
+        if (volume)
+        {
+          for (int j = 0; j < 4; j++)
+          {
+            volume[j] += triQuadric[size + j];
+          }
         }
-        // Scalar d_vol
-        this->VolumeConstraints[pts[i] * 4 + 3] +=
-          -d * triArea2 * 2.0; // (triangle normal with length triArea * 2) * (pts[0] position)
       }
     }
-  } // for all triangles
-
-  delete[] QEM;
+  });
 }
 
+//------------------------------------------------------------------------------
 void vtkQuadricDecimation::AddBoundaryConstraints()
 {
   vtkPolyData* input = this->Mesh;
-  double* QEM;
-  vtkIdType cellId;
-  int i, j;
-  vtkIdType npts;
-  const vtkIdType* pts;
-  double t0[3], t1[3], t2[3];
-  double e0[3], e1[3], n[3], c, d, w;
-  vtkIdList* cellIds = vtkIdList::New();
+  const vtkIdType numTris = input->GetNumberOfCells();
 
-  // allocate local QEM space matrix
-  QEM = new double[11 + 4 * this->NumberOfComponents];
+  // Flag the boundary edges of each triangle, edge i going from pts[i] to
+  // pts[(i + 1) % 3].
+  std::vector<unsigned char> boundaryEdges(numTris);
+  vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+    vtkNew<vtkIdList> cellIds;
+    vtkIdType npts;
+    const vtkIdType* pts;
 
-  for (cellId = 0; cellId < input->GetNumberOfCells(); cellId++)
-  {
-    input->GetCellPoints(cellId, npts, pts);
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+    {
+      input->GetCellPoints(cellId, npts, pts);
+      unsigned char flags = 0;
+      for (int i = 0; i < 3; i++)
+      {
+        input->GetCellEdgeNeighbors(cellId, pts[i], pts[(i + 1) % 3], cellIds);
+        if (cellIds->GetNumberOfIds() == 0)
+        {
+          flags |= 1 << i;
+        }
+      }
+      boundaryEdges[cellId] = flags;
+    }
+  });
 
-    for (i = 0; i < 3; i++)
+  // The constraint of each boundary edge, weighted by its length, is computed
+  // once. Triangles store theirs contiguously, from their offset.
+  std::vector<vtkIdType> offsets(numTris + 1, 0);
+  for (vtkIdType cellId = 0; cellId < numTris; cellId++)
+  {
+    const unsigned char flags = boundaryEdges[cellId];
+    offsets[cellId + 1] = offsets[cellId] + (flags & 1) + ((flags >> 1) & 1) + ((flags >> 2) & 1);
+  }
+  std::vector<double> constraints(offsets[numTris] * 11);
+  vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double t0[3], t1[3], t2[3];
+    double e0[3], e1[3], n[3], c, d, w;
+    int j;
+
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
     {
-      input->GetCellEdgeNeighbors(cellId, pts[i], pts[(i + 1) % 3], cellIds);
-      if (cellIds->GetNumberOfIds() == 0)
+      if (!boundaryEdges[cellId])
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, npts, pts);
+      double* QEM = constraints.data() + offsets[cellId] * 11;
+      for (int i = 0; i < 3; i++)
       {
-        // this is a boundary
+        if (!(boundaryEdges[cellId] & (1 << i)))
+        {
+          continue;
+        }
         input->GetPoint(pts[(i + 2) % 3], t0);
         input->GetPoint(pts[i], t1);
         input->GetPoint(pts[(i + 1) % 3], t2);
@@ -673,35 +816,71 @@ void vtkQuadricDecimation::AddBoundaryConstraints()
         // w *= w;
         // area issue ??
         // could possible add in angle weights??
-        QEM[0] = n[0] * n[0];
-        QEM[1] = n[0] * n[1];
-        QEM[2] = n[0] * n[2];
-        QEM[3] = d * n[0];
-
-        QEM[4] = n[1] * n[1];
-        QEM[5] = n[1] * n[2];
-        QEM[6] = d * n[1];
+        QEM[0] = n[0] * n[0] * w;
+        QEM[1] = n[0] * n[1] * w;
+        QEM[2] = n[0] * n[2] * w;
+        QEM[3] = d * n[0] * w;
 
-        QEM[7] = n[2] * n[2];
-        QEM[8] = d * n[2];
+        QEM[4] = n[1] * n[1] * w;
+        QEM[5] = n[1] * n[2] * w;
+        QEM[6] = d * n[1] * w;
 
-        QEM[9] = d * d;
+        QEM[7] = n[2] * n[2] * w;
+        QEM[8] = d * n[2] * w;
 
-        QEM[10] = 1;
+        QEM[9] = d * d * w;
 
-        // need to add orthogonal plane with the other Attributes, but this
-        // is not clear??
-        // check to interaction with attribute data
-        for (j = 0; j < 11; j++)
+        QEM[10] = w;
+        QEM += 11;
+      }
+    }
+  });
+
+  // Each point adds the constraints of the boundary edges using it, in the
+  // order of the triangles, so that the result does not depend on the number
+  // of threads.
+  // need to add orthogonal plane with the other Attributes, but this
+  // is not clear??
+  // check to interaction with attribute data
+  vtkSMPTools::For(0, input->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end) {
+    vtkIdType ncells, npts;
+    vtkIdType* cells;
+    const vtkIdType* pts;
+
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+    {
+      double* quadric = this->ErrorQuadrics[ptId].Quadric;
+      input->GetPointCells(ptId, ncells, cells);
+      for (vtkIdType cellIdx = 0; cellIdx < ncells; cellIdx++)
+      {
+        const vtkIdType cellId = cells[cellIdx];
+        if (!boundaryEdges[cellId] || (cellIdx > 0 && cellId == cells[cellIdx - 1]))
+        {
+          // no boundary edge, or degenerate triangle using this point twice,
+          // already done
+          continue;
+        }
+        input->GetCellPoints(cellId, npts, pts);
+        const double* QEM = constraints.data() + offsets[cellId] * 11;
+        for (int i = 0; i < 3; i++)
         {
-          this->ErrorQuadrics[pts[i]].Quadric[j] += QEM[j] * w;
-          this->ErrorQuadrics[pts[(i + 1) % 3]].Quadric[j] += QEM[j] * w;
+          if (!(boundaryEdges[cellId] & (1 << i)))
+          {
+            continue;
+          }
+          const int uses = (pts[i] == ptId ? 1 : 0) + (pts[(i + 1) % 3] == ptId ? 1 : 0);
+          for (int u = 0; u < uses; u++)
+          {
+            for (int j = 0; j < 11; j++)
+            {
+              quadric[j] += QEM[j];
+            }
+          }
+          QEM += 11;
         }
       }
     }
-  }
-  cellIds->Delete();
-  delete[] QEM;
+  });
 }
 
 //------------------------------------------------------------------------------
@@ -848,6 +1027,14 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
 
 //------------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
+{
+  return this->ComputeCost(
+    this->EndPoint1List->GetId(edgeId), this->EndPoint2List->GetId(edgeId), x, this->TempQuad);
+}
+
+//------------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost(
+  vtkIdType pt0Id, vtkIdType pt1Id, double* x, double* quad)
 {
   static const double errorNumber = 1e-10;
   double temp[3], A[3][3], b[3];
@@ -859,25 +1046,25 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
   double v[3], c, norm, normTemp, temp2[3];
   double pt1[3], pt2[3];
 
-  pointIds[0] = this->EndPoint1List->GetId(edgeId);
-  pointIds[1] = this->EndPoint2List->GetId(edgeId);
+  pointIds[0] = pt0Id;
+  pointIds[1] = pt1Id;
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
   {
-    this->TempQuad[i] =
+    quad[i] =
       this->ErrorQuadrics[pointIds[0]].Quadric[i] + this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
 
   norm = vtkMath::Norm(A[0]);
   normTemp = vtkMath::Norm(A[1]);
@@ -931,7 +1118,7 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
 
   // Compute the cost
   // x'*quad*x
-  index = this->TempQuad;
+  index = quad;
   for (i = 0; i < 4; i++)
   {
     cost += (*index++) * newPoint[i] * newPoint[i];
@@ -946,6 +1133,14 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
 
 //------------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
+{
+  return this->ComputeCost2(this->EndPoint1List->GetId(edgeId),
+    this->EndPoint2List->GetId(edgeId), x, this->TempQuad, this->TempA, this->TempB);
+}
+
+//------------------------------------------------------------------------------
+double vtkQuadricDecimation::ComputeCost2(
+  vtkIdType pt0Id, vtkIdType pt1Id, double* x, double* quad, double** A, double* b)
 {
   // this function is so ugly because the functionality of converting an QEM
   // into a dense matrix was not extracted into a separate function and
@@ -956,34 +1151,34 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
   int i, j;
   int solveOk;
 
-  pointIds[0] = this->EndPoint1List->GetId(edgeId);
-  pointIds[1] = this->EndPoint2List->GetId(edgeId);
+  pointIds[0] = pt0Id;
+  pointIds[1] = pt1Id;
 
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
   {
-    this->TempQuad[i] =
+    quad[i] =
       this->ErrorQuadrics[pointIds[0]].Quadric[i] + this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
   // copy the temp quad into TempA
   // converting from the sparse matrix format into a dense
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
-  this->TempB[0] = -this->TempQuad[3];
-  this->TempB[1] = -this->TempQuad[6];
-  this->TempB[2] = -this->TempQuad[8];
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
 
   for (i = 3; i < 3 + this->NumberOfComponents; i++)
   {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11 + 4 * (i - 3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11 + 4 * (i - 3) + 1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11 + 4 * (i - 3) + 2];
-    this->TempB[i] = -this->TempQuad[11 + 4 * (i - 3) + 3];
+    A[0][i] = A[i][0] = quad[11 + 4 * (i - 3)];
+    A[1][i] = A[i][1] = quad[11 + 4 * (i - 3) + 1];
+    A[2][i] = A[i][2] = quad[11 + 4 * (i - 3) + 2];
+    b[i] = -quad[11 + 4 * (i - 3) + 3];
   }
 
   // Set zero to all components of the submatrix a[3:n;3:n] and al to its diagonal
@@ -993,11 +1188,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
     {
       if (i == j)
       {
-        this->TempA[i][j] = this->TempQuad[10];
+        A[i][j] = quad[10];
       }
       else
       {
-        this->TempA[i][j] = 0;
+        A[i][j] = 0;
       }
     }
   }
@@ -1008,48 +1203,46 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
     {
       if (i >= 3)
       {
-        this->TempA[i][3 + this->NumberOfComponents] = 0;
-        this->TempA[3 + this->NumberOfComponents][i] = 0;
+        A[i][3 + this->NumberOfComponents] = 0;
+        A[3 + this->NumberOfComponents][i] = 0;
       }
       else
       {
-        this->TempA[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[i][3 + this->NumberOfComponents] +=
-          this->VolumeConstraints[pointIds[1] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] +=
-          this->VolumeConstraints[pointIds[1] * 4 + i];
+        A[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[i][3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + i];
+        A[3 + this->NumberOfComponents][i] += this->VolumeConstraints[pointIds[1] * 4 + i];
       }
     }
     // Add constraint to b
-    this->TempB[3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + 3];
-    this->TempB[3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + 3];
+    b[3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + 3];
+    b[3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + 3];
   }
 
   for (i = 0; i < 3 + this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    x[i] = this->TempB[i];
+    x[i] = b[i];
   }
 
   // solve A*x = b
   // this clobers A
   // need to develop a quality of the solution test??
   solveOk = vtkMath::SolveLinearSystem(
-    this->TempA, x, 3 + this->NumberOfComponents + this->VolumePreservation);
+    A, x, 3 + this->NumberOfComponents + this->VolumePreservation);
 
   // need to copy back into A
-  this->TempA[0][0] = this->TempQuad[0];
-  this->TempA[0][1] = this->TempA[1][0] = this->TempQuad[1];
-  this->TempA[0][2] = this->TempA[2][0] = this->TempQuad[2];
-  this->TempA[1][1] = this->TempQuad[4];
-  this->TempA[1][2] = this->TempA[2][1] = this->TempQuad[5];
-  this->TempA[2][2] = this->TempQuad[7];
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
 
   for (i = 3; i < 3 + this->NumberOfComponents; i++)
   {
-    this->TempA[0][i] = this->TempA[i][0] = this->TempQuad[11 + 4 * (i - 3)];
-    this->TempA[1][i] = this->TempA[i][1] = this->TempQuad[11 + 4 * (i - 3) + 1];
-    this->TempA[2][i] = this->TempA[i][2] = this->TempQuad[11 + 4 * (i - 3) + 2];
+    A[0][i] = A[i][0] = quad[11 + 4 * (i - 3)];
+    A[1][i] = A[i][1] = quad[11 + 4 * (i - 3) + 1];
+    A[2][i] = A[i][2] = quad[11 + 4 * (i - 3) + 2];
   }
 
   for (i = 3; i < 3 + this->NumberOfComponents; i++)
@@ -1058,11 +1251,11 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
     {
       if (i == j)
       {
-        this->TempA[i][j] = this->TempQuad[10];
+        A[i][j] = quad[10];
       }
       else
       {
-        this->TempA[i][j] = 0;
+        A[i][j] = 0;
       }
     }
   }
@@ -1073,17 +1266,15 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
     {
       if (i >= 3)
       {
-        this->TempA[i][3 + this->NumberOfComponents] = 0;
-        this->TempA[3 + this->NumberOfComponents][i] = 0;
+        A[i][3 + this->NumberOfComponents] = 0;
+        A[3 + this->NumberOfComponents][i] = 0;
       }
       else
       {
-        this->TempA[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
-        this->TempA[i][3 + this->NumberOfComponents] +=
-          this->VolumeConstraints[pointIds[1] * 4 + i];
-        this->TempA[3 + this->NumberOfComponents][i] +=
-          this->VolumeConstraints[pointIds[1] * 4 + i];
+        A[i][3 + this->NumberOfComponents] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[3 + this->NumberOfComponents][i] = this->VolumeConstraints[pointIds[0] * 4 + i];
+        A[i][3 + this->NumberOfComponents] += this->VolumeConstraints[pointIds[1] * 4 + i];
+        A[3 + this->NumberOfComponents][i] += this->VolumeConstraints[pointIds[1] * 4 + i];
       }
     }
   }
@@ -1116,7 +1307,7 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
       temp2[i] = 0;
       for (j = 0; j < 3 + this->NumberOfComponents; ++j)
       {
-        temp2[i] += this->TempA[i][j] * v[j];
+        temp2[i] += A[i][j] * v[j];
       }
     }
 
@@ -1134,13 +1325,13 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
         temp[i] = 0;
         for (j = 0; j < 3 + this->NumberOfComponents; ++j)
         {
-          temp[i] += this->TempA[i][j] * pt1[j];
+          temp[i] += A[i][j] * pt1[j];
         }
       }
 
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
       {
-        temp[i] = this->TempB[i] - temp[i];
+        temp[i] = b[i] - temp[i];
       }
 
       for (i = 0; i < 3 + this->NumberOfComponents; i++)
@@ -1174,33 +1365,39 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double* x)
   // x'*A*x - 2*b*x + d
   for (i = 0; i < 3 + this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    cost += this->TempA[i][i] * x[i] * x[i];
+    cost += A[i][i] * x[i] * x[i];
     for (j = i + 1; j < 3 + this->NumberOfComponents + this->VolumePreservation; j++)
     {
-      cost += 2.0 * this->TempA[i][j] * x[i] * x[j];
+      cost += 2.0 * A[i][j] * x[i] * x[j];
     }
   }
   for (i = 0; i < 3 + this->NumberOfComponents + this->VolumePreservation; i++)
   {
-    cost -= 2.0 * this->TempB[i] * x[i];
+    cost -= 2.0 * b[i] * x[i];
   }
 
-  cost += this->TempQuad[9];
+  cost += quad[9];
 
   return cost;
 }
 
 int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id)
+{
+  return this->CollapseEdge(pt0Id, pt1Id, this->CollapseCellIds);
+}
+
+//------------------------------------------------------------------------------
+int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id, vtkIdList* cellIds)
 {
   int j, numDeleted = 0;
   vtkIdType i, cellId;
   vtkIdType npts;
   const vtkIdType* pts;
 
-  this->Mesh->GetPointCells(pt0Id, this->CollapseCellIds);
-  for (i = 0; i < this->CollapseCellIds->GetNumberOfIds(); i++)
+  this->Mesh->GetPointCells(pt0Id, cellIds);
+  for (i = 0; i < cellIds->GetNumberOfIds(); i++)
   {
-    cellId = this->CollapseCellIds->GetId(i);
+    cellId = cellIds->GetId(i);
     this->Mesh->GetCellPoints(cellId, npts, pts);
     for (j = 0; j < 3; j++)
     {
@@ -1213,11 +1410,11 @@ int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id)
     }
   }
 
-  this->Mesh->GetPointCells(pt1Id, this->CollapseCellIds);
-  this->Mesh->ResizeCellList(pt0Id, this->CollapseCellIds->GetNumberOfIds());
-  for (i = 0; i < this->CollapseCellIds->GetNumberOfIds(); i++)
+  this->Mesh->GetPointCells(pt1Id, cellIds);
+  this->Mesh->ResizeCellList(pt0Id, cellIds->GetNumberOfIds());
+  for (i = 0; i < cellIds->GetNumberOfIds(); i++)
   {
-    cellId = this->CollapseCellIds->GetId(i);
+    cellId = cellIds->GetId(i);
     this->Mesh->GetCellPoints(cellId, npts, pts);
     // making sure we don't already have the triangle we're about to
     // change this one to
@@ -1240,6 +1437,232 @@ int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id)
   return numDeleted;
 }
 
+//------------------------------------------------------------------------------
+vtkIdType vtkQuadricDecimation::ParallelCollapseEdges(vtkIdType numTris)
+{
+  vtkPolyData* mesh = this->Mesh;
+  const vtkIdType numPts = mesh->GetNumberOfPoints();
+  const int size = 3 + this->NumberOfComponents + this->VolumePreservation;
+  const int quadSize = 11 + 4 * this->NumberOfComponents + this->VolumePreservation;
+  const double targetDeletedTris = this->TargetReduction * numTris;
+  vtkIdType numDeletedTris = 0;
+
+  vtkSMPThreadLocal<vtkQuadricWorkspace> workspaces;
+  auto getWorkspace = [&]() -> vtkQuadricWorkspace& {
+    vtkQuadricWorkspace& workspace = workspaces.Local();
+    workspace.Initialize(size, quadSize);
+    return workspace;
+  };
+  // Cost of collapsing an edge; the collapsed point is stored in workspace.X.
+  auto computeCost = [&](vtkIdType pt0Id, vtkIdType pt1Id, vtkQuadricWorkspace& workspace) {
+    if (this->AttributeErrorMetric)
+    {
+      return this->ComputeCost2(pt0Id, pt1Id, workspace.X.data(), workspace.Quad.data(),
+        workspace.A.data(), workspace.B.data());
+    }
+    return this->ComputeCost(pt0Id, pt1Id, workspace.X.data(), workspace.Quad.data());
+  };
+  // The points of the triangles using the given points, including them.
+  auto getOneRing = [mesh](const vtkIdType* ptIds, int numPtIds, std::vector<vtkIdType>& oneRing) {
+    vtkIdType ncells, npts;
+    vtkIdType* cells;
+    const vtkIdType* pts;
+    oneRing.clear();
+    for (int i = 0; i < numPtIds; i++)
+    {
+      mesh->GetPointCells(ptIds[i], ncells, cells);
+      for (vtkIdType j = 0; j < ncells; j++)
+      {
+        mesh->GetCellPoints(cells[j], npts, pts);
+        oneRing.insert(oneRing.end(), pts, pts + npts);
+      }
+    }
+  };
+  // The neighbors of a point with a larger id, sorted.
+  auto getEdges = [&](vtkIdType ptId, std::vector<vtkIdType>& neighbors) {
+    getOneRing(&ptId, 1, neighbors);
+    neighbors.erase(std::remove_if(neighbors.begin(), neighbors.end(),
+                      [ptId](vtkIdType neighbor) { return neighbor <= ptId; }),
+      neighbors.end());
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+  };
+
+  std::vector<vtkIdType> offsets(numPts + 1, 0);
+  std::vector<vtkQuadricEdge> edges;
+  std::vector<int> numDeleted;
+  enum
+  {
+    Undecided,
+    Selected,
+    Discarded
+  };
+  std::vector<unsigned char> state;
+  std::vector<unsigned char> locked(numPts);
+  std::unique_ptr<std::atomic<vtkIdType>[]> claims(new std::atomic<vtkIdType>[numPts]);
+
+  int abort = 0;
+  while (!abort && numDeletedTris < targetDeletedTris)
+  {
+    // Gather the edges of the mesh: each point lists its neighbors with a
+    // larger id.
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      vtkQuadricWorkspace& workspace = getWorkspace();
+      for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+        getEdges(ptId, workspace.PointIds);
+        offsets[ptId + 1] = static_cast<vtkIdType>(workspace.PointIds.size());
+      }
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    edges.resize(offsets[numPts]);
+
+    // Compute the cost of collapsing each edge. A collapse that would fold
+    // triangles over is given the maximum cost and is reconsidered in the
+    // next rounds, once its neighborhood has changed.
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      vtkQuadricWorkspace& workspace = getWorkspace();
+      for (vtkIdType ptId = begin; ptId < end; ptId++)
+      {
+        getEdges(ptId, workspace.PointIds);
+        vtkQuadricEdge* edge = edges.data() + offsets[ptId];
+        for (vtkIdType neighbor : workspace.PointIds)
+        {
+          double cost = computeCost(ptId, neighbor, workspace);
+          if (!(cost < VTK_DOUBLE_MAX) ||
+            !this->IsGoodPlacement(ptId, neighbor, workspace.X.data()))
+          {
+            cost = VTK_DOUBLE_MAX;
+          }
+          *edge++ = vtkQuadricEdge{ cost, ptId, neighbor };
+        }
+      }
+    });
+    vtkSMPTools::Sort(edges.begin(), edges.end());
+    auto firstInvalid = std::lower_bound(edges.begin(), edges.end(), VTK_DOUBLE_MAX,
+      [](const vtkQuadricEdge& edge, double cost) { return edge.Cost < cost; });
+    const vtkIdType numValid = static_cast<vtkIdType>(firstInvalid - edges.begin());
+    if (numValid == 0)
+    {
+      break;
+    }
+
+    // The candidates are the cheapest quarter of the edges. No more are
+    // needed to reach the target reduction than half the triangles left to
+    // delete, since a collapse deletes two triangles inside the mesh.
+    const vtkIdType maxCollapses =
+      static_cast<vtkIdType>(std::ceil((targetDeletedTris - numDeletedTris) / 2.0));
+    const vtkIdType numCandidates = std::min(std::max<vtkIdType>(numValid / 4, 1), maxCollapses);
+
+    // Select candidates whose one-rings are disjoint, so that they can be
+    // collapsed independently. In each pass, a candidate is selected if it
+    // is the cheapest remaining candidate whose one-ring contains each point
+    // of its own one-ring; candidates whose one-ring intersects a selected one
+    // are discarded. Passes continue until all candidates are decided.
+    state.assign(numCandidates, Undecided);
+    std::fill(locked.begin(), locked.end(), 0);
+    vtkIdType numUndecided = numCandidates;
+    while (numUndecided > 0)
+    {
+      vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+        vtkQuadricWorkspace& workspace = getWorkspace();
+        for (vtkIdType rank = begin; rank < end; rank++)
+        {
+          if (state[rank] == Undecided)
+          {
+            const vtkIdType ptIds[2] = { edges[rank].Pt0Id, edges[rank].Pt1Id };
+            getOneRing(ptIds, 2, workspace.PointIds);
+            for (vtkIdType ptId : workspace.PointIds)
+            {
+              claims[ptId].store(numCandidates, std::memory_order_relaxed);
+            }
+          }
+        }
+      });
+      vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+        vtkQuadricWorkspace& workspace = getWorkspace();
+        for (vtkIdType rank = begin; rank < end; rank++)
+        {
+          if (state[rank] != Undecided)
+          {
+            continue;
+          }
+          const vtkIdType ptIds[2] = { edges[rank].Pt0Id, edges[rank].Pt1Id };
+          getOneRing(ptIds, 2, workspace.PointIds);
+          auto isLocked = [&](vtkIdType ptId) { return locked[ptId] != 0; };
+          if (std::any_of(workspace.PointIds.begin(), workspace.PointIds.end(), isLocked))
+          {
+            state[rank] = Discarded;
+            continue;
+          }
+          for (vtkIdType ptId : workspace.PointIds)
+          {
+            vtkIdType claim = claims[ptId].load(std::memory_order_relaxed);
+            while (rank < claim &&
+              !claims[ptId].compare_exchange_weak(claim, rank, std::memory_order_relaxed))
+            {
+            }
+          }
+        }
+      });
+      vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+        vtkQuadricWorkspace& workspace = getWorkspace();
+        for (vtkIdType rank = begin; rank < end; rank++)
+        {
+          if (state[rank] != Undecided)
+          {
+            continue;
+          }
+          const vtkIdType ptIds[2] = { edges[rank].Pt0Id, edges[rank].Pt1Id };
+          getOneRing(ptIds, 2, workspace.PointIds);
+          auto isClaimed = [&](vtkIdType ptId) {
+            return claims[ptId].load(std::memory_order_relaxed) == rank;
+          };
+          if (std::all_of(workspace.PointIds.begin(), workspace.PointIds.end(), isClaimed))
+          {
+            // the one-rings of selected candidates are disjoint
+            state[rank] = Selected;
+            for (vtkIdType ptId : workspace.PointIds)
+            {
+              locked[ptId] = 1;
+            }
+          }
+        }
+      });
+      numUndecided = std::count(state.begin(), state.end(), Undecided);
+    }
+
+    // Collapse the selected edges, as done by the serial algorithm.
+    numDeleted.assign(numCandidates, 0);
+    vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+      vtkQuadricWorkspace& workspace = getWorkspace();
+      for (vtkIdType rank = begin; rank < end; rank++)
+      {
+        if (state[rank] == Selected)
+        {
+          const vtkIdType pt0Id = edges[rank].Pt0Id;
+          const vtkIdType pt1Id = edges[rank].Pt1Id;
+          computeCost(pt0Id, pt1Id, workspace);
+          this->SetPointAttributeArray(pt0Id, workspace.X.data());
+          this->AddQuadric(pt1Id, pt0Id);
+          numDeleted[rank] = this->CollapseEdge(pt0Id, pt1Id, workspace.CellIds);
+        }
+      }
+    });
+    this->NumberOfEdgeCollapses +=
+      static_cast<int>(std::count(state.begin(), state.end(), Selected));
+    numDeletedTris += std::accumulate(numDeleted.begin(), numDeleted.end(), vtkIdType(0));
+    this->ActualReduction = static_cast<double>(numDeletedTris) / numTris;
+
+    vtkDebugMacro(<< "Collapsed " << this->NumberOfEdgeCollapses << " edges, cost up to "
+                  << edges[numCandidates - 1].Cost);
+    this->UpdateProgress(0.15 + 0.85 * numDeletedTris / targetDeletedTris);
+    abort = this->GetAbortExecute();
+  }
+
+  return numDeletedTris;
+}
+
 // triangle t0, t1, t2 and point x
 // determines if t0 and x are on the same side of the plane defined by
 // t1 and t2, and parallel to the normal of the triangle
@@ -1455,6 +1878,7 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Attribute Error Metric: " << (this->AttributeErrorMetric ? "On\n" : "Off\n");
   os << indent << "Volume Preservation: " << (this->VolumePreservation ? "On\n" : "Off\n");
+  os << indent << "Parallel Collapse: " << (this->ParallelCollapse ? "On\n" : "Off\n");
   os << indent << "Scalars Attribute: " << (this->ScalarsAttribute ? "On\n" : "Off\n");
   os << indent << "Vectors Attribute: " << (this->VectorsAttribute ? "On\n" : "Off\n");
   os << indent << "Normals Attribute: " << (this->NormalsAttribute ? "On\n" : "Off\n");
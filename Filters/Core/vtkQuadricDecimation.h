@@ -48,6 +48,19 @@
  * Attributes" is also a good take on the subject especially as it pertains
  * to the error metric applied to attributes.
  *
+ * When ParallelCollapse is on, the quadrics are computed with vtkSMPTools
+ * and edges are collapsed in rounds instead of one at a time. Each round
+ * computes the cost of all the edges in parallel, considers the cheapest
+ * quarter of them, and collapses in parallel those that are the cheapest
+ * candidate of their neighborhood, so that no two edges collapsed in the
+ * same round share a vertex of their one-rings. The greedy order of the
+ * serial algorithm is thus relaxed: every collapsed edge is among the
+ * cheapest 25% of the edges of the mesh at the start of its round, where
+ * the serial algorithm always collapses the cheapest one. The result
+ * differs slightly from the serial one but does not depend on the number
+ * of threads. There is no guaranteed bound on the error of the result
+ * relative to the serial one.
+ *
  * @par Thanks:
  * Thanks to Bradley Lowekamp of the National Library of Medicine/NIH for
  * contributing this class.
@@ -148,6 +161,19 @@ public:
   vtkGetMacro(TensorsWeight, double);
   ///@}
 
+  ///@{
+  /**
+   * Collapse independent sets of edges in parallel rounds instead of one
+   * edge at a time from a global priority queue (see the class
+   * documentation). This is much faster on large meshes with multiple
+   * threads, at the cost of a slightly less greedy collapse order. Off by
+   * default.
+   */
+  vtkSetMacro(ParallelCollapse, vtkTypeBool);
+  vtkGetMacro(ParallelCollapse, vtkTypeBool);
+  vtkBooleanMacro(ParallelCollapse, vtkTypeBool);
+  ///@}
+
   ///@{
   /**
    * Get the actual reduction. This value is only valid after the
@@ -167,6 +193,13 @@ protected:
    * triangles deleted.
    */
   int CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id);
+  int CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id, vtkIdList* cellIds);
+
+  /**
+   * Collapse edges in parallel rounds until the target reduction is
+   * reached; return the number of triangles deleted.
+   */
+  vtkIdType ParallelCollapseEdges(vtkIdType numTris);
 
   /**
    * Compute quadric for all vertices
@@ -178,6 +211,13 @@ protected:
    */
   void AddBoundaryConstraints(void);
 
+  /**
+   * Compute the quadric of a triangle, without its area weight, and its
+   * unit normal, plane offset and area.
+   */
+  void ComputeTriangleQuadric(
+    const vtkIdType* pts, double* QEM, double n[3], double& d, double& area);
+
   /**
    * Compute quadric for this vertex.
    */
@@ -198,6 +238,17 @@ protected:
   double ComputeCost2(vtkIdType edgeId, double* x);
   ///@}
 
+  ///@{
+  /**
+   * Same as above for the edge between two points, using the given
+   * temporary arrays instead of TempQuad, TempA and TempB so that they can
+   * be called from several threads.
+   */
+  double ComputeCost(vtkIdType pt0Id, vtkIdType pt1Id, double* x, double* quad);
+  double ComputeCost2(
+    vtkIdType pt0Id, vtkIdType pt1Id, double* x, double* quad, double** A, double* b);
+  ///@}
+
   /**
    * Find all edges that will have an endpoint change ids because of an edge
    * collapse.  p1Id and p2Id are the endpoints of the edge.  p2Id is the
@@ -234,6 +285,7 @@ protected:
   double ActualReduction;
   vtkTypeBool AttributeErrorMetric;
   vtkTypeBool VolumePreservation;
+  vtkTypeBool ParallelCollapse;
 
   vtkTypeBool ScalarsAttribute;
   vtkTypeBool VectorsAttribute;
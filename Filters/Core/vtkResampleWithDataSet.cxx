@@ -126,6 +126,16 @@ vtkAbstractCellLocator* vtkResampleWithDataSet::GetCellLocatorPrototype() const
   return this->Prober->GetCellLocatorPrototype();
 }
 
+void vtkResampleWithDataSet::SetCellLocatorCache(vtkCellLocatorCache* cache)
+{
+  this->Prober->SetCellLocatorCache(cache);
+}
+
+vtkCellLocatorCache* vtkResampleWithDataSet::GetCellLocatorCache() const
+{
+  return this->Prober->GetCellLocatorCache();
+}
+
 //------------------------------------------------------------------------------
 void vtkResampleWithDataSet::SetTolerance(double arg)
 {
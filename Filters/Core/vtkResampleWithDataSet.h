@@ -35,6 +35,7 @@
 #include "vtkPassInputTypeAlgorithm.h"
 
 class vtkAbstractCellLocator;
+class vtkCellLocatorCache;
 class vtkCompositeDataProbeFilter;
 class vtkDataSet;
 
@@ -160,6 +161,15 @@ public:
   virtual vtkAbstractCellLocator* GetCellLocatorPrototype() const;
   ///@}
 
+  ///@{
+  /*
+   * Set/Get the cache of cell locators to use for probing the source dataset.
+   * The value is forwarded to the underlying probe filter.
+   */
+  virtual void SetCellLocatorCache(vtkCellLocatorCache*);
+  virtual vtkCellLocatorCache* GetCellLocatorCache() const;
+  ///@}
+
   vtkMTimeType GetMTime() override;
 
 protected:
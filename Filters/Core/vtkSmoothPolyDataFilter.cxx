@@ -15,20 +15,33 @@
 #include "vtkSmoothPolyDataFilter.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkCellLocator.h"
 #include "vtkFloatArray.h"
+#include "vtkGenericCell.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
+#include "vtkStaticCellLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleFilter.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkSmoothPolyDataFilter);
 
@@ -109,7 +122,8 @@ vtkSmoothPoint* vtkSmoothPoints::Resize(vtkIdType sz)
 // feature edge smoothing turned off; feature
 // angle 45 degrees; edge angle 15 degrees; and boundary smoothing turned
 // on. Error scalars and vectors are not generated (by default). The
-// convergence criterion is 0.0 of the bounding box diagonal.
+// convergence criterion is 0.0 of the bounding box diagonal. Parallel
+// smoothing is off.
 vtkSmoothPolyDataFilter::vtkSmoothPolyDataFilter()
 {
   this->Convergence = 0.0; // goes to number of specified iterations
@@ -126,6 +140,7 @@ vtkSmoothPolyDataFilter::vtkSmoothPolyDataFilter()
   this->GenerateErrorVectors = 0;
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelSmoothing = 0;
 
   this->SmoothPoints = nullptr;
 
@@ -155,17 +170,315 @@ vtkPolyData* vtkSmoothPolyDataFilter::GetSource()
 namespace
 {
 
-// Special structure for marking vertices
-typedef struct _vtkMeshVertex
+// Classification of the mesh vertices, and for each vertex the connected
+// points (edges) it is smoothed with. The edges of a vertex are gathered in a
+// slot large enough for all the cells using the vertex, then the slots are
+// compacted.
+struct vtkMeshVertices
 {
-  char type;
-  vtkIdList* edges; // connected edges (list of connected point ids)
-  _vtkMeshVertex()
+  std::vector<char> Types;
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> NumberOfEdges;
+  std::vector<vtkIdType> Edges;
+
+  vtkMeshVertices(vtkIdType numPts, vtkStaticCellLinksTemplate<vtkIdType>* links)
+    : Types(numPts, VTK_SIMPLE_VERTEX)
+    , Offsets(numPts + 1)
+    , NumberOfEdges(numPts, 0)
   {
-    type = VTK_SIMPLE_VERTEX; // can smooth
-    edges = nullptr;
+    // Two edges for the lines, and two for each polygon using the vertex.
+    this->Offsets[0] = 0;
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+      this->Offsets[ptId + 1] =
+        this->Offsets[ptId] + 2 + (links ? 2 * links->GetNcells(ptId) : 0);
+    }
+    this->Edges.resize(this->Offsets[numPts]);
+  }
+
+  vtkIdType GetNumberOfEdges(vtkIdType ptId) const { return this->NumberOfEdges[ptId]; }
+  const vtkIdType* GetEdges(vtkIdType ptId) const
+  {
+    return this->Edges.data() + this->Offsets[ptId];
+  }
+  void ResetEdges(vtkIdType ptId) { this->NumberOfEdges[ptId] = 0; }
+  void InsertEdge(vtkIdType ptId, vtkIdType edgeId)
+  {
+    this->Edges[this->Offsets[ptId] + this->NumberOfEdges[ptId]++] = edgeId;
+  }
+
+  // Update vertex ptId with its polygon edge to otherId, classified as edge.
+  void AddPolygonEdge(vtkIdType ptId, vtkIdType otherId, int edge)
+  {
+    char& type = this->Types[ptId];
+    if (edge && type == VTK_SIMPLE_VERTEX)
+    {
+      this->ResetEdges(ptId);
+      this->InsertEdge(ptId, otherId);
+      type = edge;
+    }
+    else if ((edge && type == VTK_BOUNDARY_EDGE_VERTEX) ||
+      (edge && type == VTK_FEATURE_EDGE_VERTEX) || (!edge && type == VTK_SIMPLE_VERTEX))
+    {
+      this->InsertEdge(ptId, otherId);
+      if (type && edge == VTK_BOUNDARY_EDGE_VERTEX)
+      {
+        type = VTK_BOUNDARY_EDGE_VERTEX;
+      }
+    }
+  }
+
+  // Remove the unused room at the end of the slots.
+  void Compact()
+  {
+    const vtkIdType numPts = static_cast<vtkIdType>(this->Types.size());
+    std::vector<vtkIdType> offsets(numPts + 1);
+    offsets[0] = 0;
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+      offsets[ptId + 1] = offsets[ptId] + this->NumberOfEdges[ptId];
+    }
+    std::vector<vtkIdType> edges(offsets[numPts]);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+      for (; ptId < endPtId; ++ptId)
+      {
+        std::copy_n(this->Edges.begin() + this->Offsets[ptId], this->NumberOfEdges[ptId],
+          edges.begin() + offsets[ptId]);
+      }
+    });
+    this->Offsets.swap(offsets);
+    this->Edges.swap(edges);
+  }
+};
+
+// Classify the vertices used by the polygons and gather their edges. The
+// polygons were traversed edge by edge, each edge updating both its points;
+// here each vertex replays the updates it would have received, in the same
+// order: its cells by increasing id and, in each cell, the edges using it.
+// Classifying an edge only reads the mesh, so the vertices are processed
+// independently and the result is the same as the serial traversal.
+struct AnalyzePolygons
+{
+  vtkCellArray* Polys;
+  vtkPoints* Points;
+  vtkStaticCellLinksTemplate<vtkIdType>* Links;
+  vtkMeshVertices* Vertices;
+  vtkTypeBool FeatureEdgeSmoothing;
+  double CosFeatureAngle;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkCellArrayIterator>> CellIterator;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkCellArrayIterator>> NeighborIterator;
+
+  AnalyzePolygons(vtkCellArray* polys, vtkPoints* points,
+    vtkStaticCellLinksTemplate<vtkIdType>* links, vtkMeshVertices* vertices,
+    vtkTypeBool featureEdgeSmoothing, double cosFeatureAngle)
+    : Polys(polys)
+    , Points(points)
+    , Links(links)
+    , Vertices(vertices)
+    , FeatureEdgeSmoothing(featureEdgeSmoothing)
+    , CosFeatureAngle(cosFeatureAngle)
+  {
+  }
+
+  void Initialize()
+  {
+    this->CellIterator.Local().TakeReference(this->Polys->NewIterator());
+    this->NeighborIterator.Local().TakeReference(this->Polys->NewIterator());
+  }
+
+  // Classify the edge (p1,p2) of a cell from the cells sharing it, as
+  // returned by vtkPolyData::GetCellEdgeNeighbors(). Return -1 if the edge
+  // was classified when visiting a previous cell.
+  int ClassifyEdge(
+    vtkIdType cellId, vtkIdType npts, const vtkIdType* pts, vtkIdType p1, vtkIdType p2)
+  {
+    const vtkIdType* cells1 = this->Links->GetCells(p1);
+    const vtkIdType* cells1End = cells1 + this->Links->GetNcells(p1);
+    const vtkIdType* cells2 = this->Links->GetCells(p2);
+    const vtkIdType* cells2End = cells2 + this->Links->GetNcells(p2);
+
+    vtkIdType numNei = 0, nei = -1;
+    bool visited = false;
+    for (; cells1 != cells1End; ++cells1)
+    {
+      if (*cells1 != cellId && std::binary_search(cells2, cells2End, *cells1))
+      {
+        nei = (numNei == 0 ? *cells1 : nei);
+        visited = visited || *cells1 < cellId;
+        ++numNei;
+      }
+    }
+
+    if (numNei == 0)
+    {
+      return VTK_BOUNDARY_EDGE_VERTEX;
+    }
+    else if (numNei >= 2)
+    {
+      return (visited ? VTK_SIMPLE_VERTEX : VTK_FEATURE_EDGE_VERTEX);
+    }
+    else if (nei < cellId)
+    {
+      return -1;
+    }
+
+    if (this->FeatureEdgeSmoothing)
+    {
+      vtkIdType numNeiPts;
+      const vtkIdType* neiPts;
+      double normal[3], neiNormal[3];
+      vtkPolygon::ComputeNormal(this->Points, static_cast<int>(npts), pts, normal);
+      this->NeighborIterator.Local()->GetCellAtId(nei, numNeiPts, neiPts);
+      vtkPolygon::ComputeNormal(this->Points, static_cast<int>(numNeiPts), neiPts, neiNormal);
+
+      if (vtkMath::Dot(normal, neiNormal) <= this->CosFeatureAngle)
+      {
+        return VTK_FEATURE_EDGE_VERTEX;
+      }
+    }
+    return VTK_SIMPLE_VERTEX;
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkCellArrayIterator* cellIter = this->CellIterator.Local();
+    vtkIdType npts;
+    const vtkIdType* pts;
+
+    for (; ptId < endPtId; ++ptId)
+    {
+      if (this->Vertices->Types[ptId] == VTK_FIXED_VERTEX)
+      {
+        continue; // fixed vertices are never updated
+      }
+
+      const vtkIdType* cells = this->Links->GetCells(ptId);
+      const vtkIdType ncells = this->Links->GetNcells(ptId);
+      for (vtkIdType k = 0; k < ncells; ++k)
+      {
+        // a cell using the vertex several times is listed as many times
+        const vtkIdType cellId = cells[k];
+        if (k > 0 && cells[k - 1] == cellId)
+        {
+          continue;
+        }
+
+        cellIter->GetCellAtId(cellId, npts, pts);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          const vtkIdType p1 = pts[i];
+          const vtkIdType p2 = pts[(i + 1) % npts];
+          if (p1 != ptId && p2 != ptId)
+          {
+            continue;
+          }
+
+          const int edge = this->ClassifyEdge(cellId, npts, pts, p1, p2);
+          if (edge < 0)
+          {
+            continue; // a visited edge; skip rest of analysis
+          }
+          if (p1 == ptId)
+          {
+            this->Vertices->AddPolygonEdge(ptId, p2, edge);
+          }
+          if (p2 == ptId)
+          {
+            this->Vertices->AddPolygonEdge(ptId, p1, edge);
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+// Post-process edge vertices to make sure we can smooth them, and count the
+// vertices of each type.
+struct ClassifyEdgeVertices
+{
+  vtkPoints* Points;
+  vtkMeshVertices* Vertices;
+  vtkTypeBool BoundarySmoothing;
+  double CosEdgeAngle;
+  vtkSMPThreadLocal<std::array<vtkIdType, 4>> LocalCounts;
+  std::array<vtkIdType, 4> Counts; // indexed by vertex type
+
+  ClassifyEdgeVertices(vtkPoints* points, vtkMeshVertices* vertices,
+    vtkTypeBool boundarySmoothing, double cosEdgeAngle)
+    : Points(points)
+    , Vertices(vertices)
+    , BoundarySmoothing(boundarySmoothing)
+    , CosEdgeAngle(cosEdgeAngle)
+  {
+    this->Counts.fill(0);
   }
-} vtkMeshVertex, *vtkMeshVertexPtr;
+
+  void Initialize() { this->LocalCounts.Local().fill(0); }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    std::array<vtkIdType, 4>& counts = this->LocalCounts.Local();
+    double x1[3], x2[3], x3[3], l1[3], l2[3];
+
+    for (; ptId < endPtId; ++ptId)
+    {
+      char& type = this->Vertices->Types[ptId];
+      if (type == VTK_SIMPLE_VERTEX || type == VTK_FIXED_VERTEX)
+      {
+        counts[type]++;
+      }
+
+      else if (!this->BoundarySmoothing && type == VTK_BOUNDARY_EDGE_VERTEX)
+      {
+        type = VTK_FIXED_VERTEX;
+        counts[VTK_BOUNDARY_EDGE_VERTEX]++;
+      }
+
+      else if (this->Vertices->GetNumberOfEdges(ptId) != 2)
+      {
+        type = VTK_FIXED_VERTEX;
+        counts[VTK_FIXED_VERTEX]++;
+      }
+
+      else // check angle between edges
+      {
+        const vtkIdType* edges = this->Vertices->GetEdges(ptId);
+        this->Points->GetPoint(edges[0], x1);
+        this->Points->GetPoint(ptId, x2);
+        this->Points->GetPoint(edges[1], x3);
+
+        for (int k = 0; k < 3; k++)
+        {
+          l1[k] = x2[k] - x1[k];
+          l2[k] = x3[k] - x2[k];
+        }
+        if (vtkMath::Normalize(l1) >= 0.0 && vtkMath::Normalize(l2) >= 0.0 &&
+          vtkMath::Dot(l1, l2) < this->CosEdgeAngle)
+        {
+          type = VTK_FIXED_VERTEX;
+          counts[VTK_FIXED_VERTEX]++;
+        }
+        else
+        {
+          counts[type]++;
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    for (auto iter = this->LocalCounts.begin(); iter != this->LocalCounts.end(); ++iter)
+    {
+      for (int type = 0; type < 4; ++type)
+      {
+        this->Counts[type] += (*iter)[type];
+      }
+    }
+  }
+};
 
 template <typename T>
 struct vtkSPDF_InternalParams
@@ -176,11 +489,11 @@ struct vtkSPDF_InternalParams
   T factor;
   T conv;
   vtkIdType numPts;
-  vtkMeshVertexPtr vertexPtr;
+  const vtkMeshVertices* vertices;
   vtkPolyData* source;
   vtkSmoothPoints* SmoothPoints;
   double* w;
-  vtkCellLocator* cellLocator;
+  vtkAbstractCellLocator* cellLocator;
 };
 
 template <typename T>
@@ -202,8 +515,8 @@ void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
     maxDist = 0.0;
     T* newPtsCoords = static_cast<T*>(params.newPts->GetVoidPointer(0));
     T* start = newPtsCoords;
-    vtkMeshVertexPtr vertsPtr = params.vertexPtr;
-    vtkIdType npts, *edgeIdPtr;
+    vtkIdType npts;
+    const vtkIdType* edgeIdPtr;
     T dist, deltaX[3];
     double dist2, xNew[3], closestPt[3];
 
@@ -211,11 +524,11 @@ void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
     // position of its connected neighbors using the relaxation factor.
     for (vtkIdType i = 0; i < params.numPts; ++i)
     {
-      if (vertsPtr->type != VTK_FIXED_VERTEX && vertsPtr->edges != nullptr &&
-        (npts = vertsPtr->edges->GetNumberOfIds()) > 0)
+      if (params.vertices->Types[i] != VTK_FIXED_VERTEX &&
+        (npts = params.vertices->GetNumberOfEdges(i)) > 0)
       {
         deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-        edgeIdPtr = vertsPtr->edges->GetPointer(0);
+        edgeIdPtr = params.vertices->GetEdges(i);
         // Compute the mean (cumulated) direction vector
         for (vtkIdType j = 0; j < npts; ++j)
         {
@@ -269,13 +582,121 @@ void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
       {
         newPtsCoords += 3;
       }
-      ++vertsPtr;
     } // for all points
   }   // for not converged or within iteration count
 
   vtkDebugWithObjectMacro(params.spdf, << "Performed " << iterationNumber << " smoothing passes");
 }
 
+// Threaded version of vtkSPDF_MovePoints using Jacobi iterations: each pass
+// moves all the points from their positions at the previous pass, read from
+// one buffer and written to the other, so the result does not depend on the
+// number of threads. Convergence is measured on the motion of the points.
+template <typename T>
+void vtkSPDF_ParallelMovePoints(vtkSPDF_InternalParams<T>& params)
+{
+  vtkNew<vtkPoints> otherPts;
+  otherPts->SetDataType(params.newPts->GetDataType());
+  otherPts->SetNumberOfPoints(params.numPts);
+  T* const newPtsCoords = static_cast<T*>(params.newPts->GetVoidPointer(0));
+  T* current = newPtsCoords;
+  T* next = static_cast<T*>(otherPts->GetVoidPointer(0));
+
+  const vtkMeshVertices* vertices = params.vertices;
+  const int maxCellSize = params.source ? params.source->GetMaxCellSize() : 0;
+  vtkSMPThreadLocalObject<vtkGenericCell> cells;
+  vtkSMPThreadLocal<std::vector<double>> weights;
+
+  int iterationNumber = 0;
+  for (T maxDist = std::numeric_limits<T>::max();
+       maxDist > params.conv && iterationNumber < params.numberOfIterations; ++iterationNumber)
+  {
+    if (iterationNumber && !(iterationNumber % 5))
+    {
+      params.spdf->UpdateProgress(0.5 + 0.5 * iterationNumber / params.numberOfIterations);
+      if (params.spdf->GetAbortExecute())
+      {
+        break;
+      }
+    }
+
+    vtkSMPThreadLocal<T> localMaxDist(0);
+    vtkSMPTools::For(0, params.numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+      T& threadMaxDist = localMaxDist.Local();
+      vtkGenericCell* cell = cells.Local();
+      std::vector<double>& w = weights.Local();
+      w.resize(maxCellSize);
+      T deltaX[3];
+      double xNew[3], closestPt[3], dist2;
+
+      for (; ptId < endPtId; ++ptId)
+      {
+        const T* x = current + 3 * ptId;
+        T* y = next + 3 * ptId;
+        const vtkIdType npts = vertices->GetNumberOfEdges(ptId);
+        if (vertices->Types[ptId] == VTK_FIXED_VERTEX || npts == 0)
+        {
+          std::copy_n(x, 3, y);
+          continue;
+        }
+
+        // Compute the mean (cumulated) direction vector and move the point
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+        const vtkIdType* edgeIds = vertices->GetEdges(ptId);
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          for (int k = 0; k < 3; ++k)
+          {
+            deltaX[k] += current[3 * edgeIds[j] + k];
+          }
+        }
+        for (int k = 0; k < 3; ++k)
+        {
+          y[k] = x[k] + params.factor * (deltaX[k] / npts - x[k]);
+        }
+
+        // Constrain point to surface
+        if (params.source)
+        {
+          vtkSmoothPoint* sPtr = params.SmoothPoints->GetSmoothPoint(ptId);
+          std::copy_n(y, 3, xNew);
+          if (sPtr->cellId >= 0) // in cell
+          {
+            params.source->GetCell(sPtr->cellId, cell);
+          }
+          if (sPtr->cellId < 0 ||
+            cell->EvaluatePosition(xNew, closestPt, sPtr->subId, sPtr->p, dist2, w.data()) == 0)
+          { // not in cell anymore
+            params.cellLocator->FindClosestPoint(
+              xNew, closestPt, cell, sPtr->cellId, sPtr->subId, dist2);
+          }
+          for (int k = 0; k < 3; ++k)
+          {
+            y[k] = static_cast<T>(closestPt[k]);
+          }
+        }
+
+        const T dist = static_cast<T>(std::sqrt(vtkMath::Distance2BetweenPoints(x, y)));
+        threadMaxDist = std::max(threadMaxDist, dist);
+      } // for all points
+    }); // end lambda
+
+    maxDist = 0.0;
+    for (auto iter = localMaxDist.begin(); iter != localMaxDist.end(); ++iter)
+    {
+      maxDist = std::max(maxDist, *iter);
+    }
+    std::swap(current, next);
+  } // for not converged or within iteration count
+
+  if (current != newPtsCoords)
+  {
+    std::copy_n(current, 3 * params.numPts, newPtsCoords);
+  }
+
+  vtkDebugWithObjectMacro(params.spdf, << "Performed " << iterationNumber << " smoothing passes");
+}
+
 } // namespace
 
 int vtkSmoothPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
@@ -296,23 +717,20 @@ int vtkSmoothPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
   vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
   vtkIdType numPts, numCells, i, numPolys, numStrips;
-  int j, k;
+  int j;
   vtkIdType npts = 0;
   const vtkIdType* pts = nullptr;
-  vtkIdType p1, p2;
   double conv;
-  double x1[3], x2[3], x3[3], l1[3], l2[3];
+  double x1[3], x2[3], x3[3];
   double CosFeatureAngle; // Cosine of angle between adjacent polys
   double CosEdgeAngle;    // Cosine of angle between adjacent edges
   double closestPt[3], dist2, *w = nullptr;
-  vtkIdType numSimple = 0, numBEdges = 0, numFixed = 0, numFEdges = 0;
-  vtkPolyData *inMesh, *Mesh;
+  vtkPolyData *inMesh = nullptr, *Mesh = nullptr;
   vtkPoints* inPts;
   vtkTriangleFilter* toTris = nullptr;
   vtkCellArray *inVerts, *inLines, *inPolys, *inStrips;
   vtkPoints* newPts;
-  vtkMeshVertexPtr Verts;
-  vtkCellLocator* cellLocator = nullptr;
+  vtkAbstractCellLocator* cellLocator = nullptr;
 
   // Check input
   //
@@ -335,7 +753,8 @@ int vtkSmoothPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
                 << "\tBoundary Smoothing " << (this->BoundarySmoothing ? "On\n" : "Off\n")
                 << "\tFeature Edge Smoothing " << (this->FeatureEdgeSmoothing ? "On\n" : "Off\n")
                 << "\tError Scalars " << (this->GenerateErrorScalars ? "On\n" : "Off\n")
-                << "\tError Vectors " << (this->GenerateErrorVectors ? "On\n" : "Off\n"));
+                << "\tError Vectors " << (this->GenerateErrorVectors ? "On\n" : "Off\n")
+                << "\tParallel Smoothing " << (this->ParallelSmoothing ? "On\n" : "Off\n"));
 
   if (this->NumberOfIterations <= 0 || this->RelaxationFactor == 0.0)
   { // don't do anything! pass data through
@@ -353,84 +772,27 @@ int vtkSmoothPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
   // using a subset of the attached vertices.
   //
   vtkDebugMacro(<< "Analyzing topology...");
-  Verts = new vtkMeshVertex[numPts];
 
   inPts = input->GetPoints();
   conv = this->Convergence * input->GetLength();
 
-  // check vertices first. Vertices are never smoothed_--------------
-  for (inVerts = input->GetVerts(), inVerts->InitTraversal(); inVerts->GetNextCell(npts, pts);)
-  {
-    for (j = 0; j < npts; j++)
-    {
-      Verts[pts[j]].type = VTK_FIXED_VERTEX;
-    }
-  }
-  this->UpdateProgress(0.10);
-
-  // now check lines. Only manifold lines can be smoothed------------
-  for (inLines = input->GetLines(), inLines->InitTraversal(); inLines->GetNextCell(npts, pts);)
-  {
-    for (j = 0; j < npts; j++)
-    {
-      if (Verts[pts[j]].type == VTK_SIMPLE_VERTEX)
-      {
-        if (j == (npts - 1)) // end-of-line marked FIXED
-        {
-          Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        }
-        else if (j == 0) // beginning-of-line marked FIXED
-        {
-          Verts[pts[0]].type = VTK_FIXED_VERTEX;
-          inPts->GetPoint(pts[0], x2);
-          inPts->GetPoint(pts[1], x3);
-        }
-        else // is edge vertex (unless already edge vertex!)
-        {
-          Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
-          Verts[pts[j]].edges = vtkIdList::New();
-          Verts[pts[j]].edges->SetNumberOfIds(2);
-          Verts[pts[j]].edges->SetId(0, pts[j - 1]);
-          Verts[pts[j]].edges->SetId(1, pts[j + 1]);
-        }
-      } // if simple vertex
-
-      else if (Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX)
-      { // multiply connected, becomes fixed!
-        Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        Verts[pts[j]].edges->Delete();
-        Verts[pts[j]].edges = nullptr;
-      }
-
-    } // for all points in this line
-  }   // for all lines
-  this->UpdateProgress(0.25);
-
-  // now polygons and triangle strips-------------------------------
+  // The polygons and triangle strips are analyzed in parallel from the
+  // sorted cell links of their triangulation, which also size the
+  // connectivity array.
   inPolys = input->GetPolys();
   numPolys = inPolys->GetNumberOfCells();
   inStrips = input->GetStrips();
   numStrips = inStrips->GetNumberOfCells();
+  vtkStaticCellLinksTemplate<vtkIdType> links;
 
   if (numPolys > 0 || numStrips > 0)
   { // build cell structure
-    vtkCellArray* polys;
-    vtkIdType cellId;
-    int numNei, nei, edge;
-    vtkIdType numNeiPts;
-    const vtkIdType* neiPts;
-    double normal[3], neiNormal[3];
-    vtkIdList* neighbors;
-
-    neighbors = vtkIdList::New();
-    neighbors->Allocate(VTK_CELL_SIZE);
-
     inMesh = vtkPolyData::New();
     inMesh->SetPoints(inPts);
     inMesh->SetPolys(inPolys);
     Mesh = inMesh;
 
-    if ((numStrips = inStrips->GetNumberOfCells()) > 0)
+    if (numStrips > 0)
     { // convert data to triangles
       inMesh->SetStrips(inStrips);
       toTris = vtkTriangleFilter::New();
@@ -439,182 +801,82 @@ int vtkSmoothPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
       Mesh = toTris->GetOutput();
     }
 
-    Mesh->BuildLinks(); // to do neighborhood searching
-    polys = Mesh->GetPolys();
-    this->UpdateProgress(0.375);
-
-    for (cellId = 0, polys->InitTraversal(); polys->GetNextCell(npts, pts); cellId++)
-    {
-      for (i = 0; i < npts; i++)
-      {
-        p1 = pts[i];
-        p2 = pts[(i + 1) % npts];
+    // to do neighborhood searching, with the cells of each point in
+    // increasing order
+    vtkCellArray* polys = Mesh->GetPolys();
+    links.ThreadedBuildLinks(numPts, polys->GetNumberOfCells(), polys);
+    links.SortLinks();
+  }
 
-        if (Verts[p1].edges == nullptr)
-        {
-          Verts[p1].edges = vtkIdList::New();
-          Verts[p1].edges->Allocate(16, 6);
-        }
-        if (Verts[p2].edges == nullptr)
-        {
-          Verts[p2].edges = vtkIdList::New();
-          Verts[p2].edges->Allocate(16, 6);
-        }
+  vtkMeshVertices vertices(numPts, Mesh ? &links : nullptr);
 
-        Mesh->GetCellEdgeNeighbors(cellId, p1, p2, neighbors);
-        numNei = neighbors->GetNumberOfIds();
+  // check vertices first. Vertices are never smoothed_--------------
+  for (inVerts = input->GetVerts(), inVerts->InitTraversal(); inVerts->GetNextCell(npts, pts);)
+  {
+    for (j = 0; j < npts; j++)
+    {
+      vertices.Types[pts[j]] = VTK_FIXED_VERTEX;
+    }
+  }
+  this->UpdateProgress(0.10);
 
-        edge = VTK_SIMPLE_VERTEX;
-        if (numNei == 0)
+  // now check lines. Only manifold lines can be smoothed------------
+  for (inLines = input->GetLines(), inLines->InitTraversal(); inLines->GetNextCell(npts, pts);)
+  {
+    for (j = 0; j < npts; j++)
+    {
+      if (vertices.Types[pts[j]] == VTK_SIMPLE_VERTEX)
+      {
+        if (j == (npts - 1) || j == 0) // end- or beginning-of-line marked FIXED
         {
-          edge = VTK_BOUNDARY_EDGE_VERTEX;
+          vertices.Types[pts[j]] = VTK_FIXED_VERTEX;
         }
-
-        else if (numNei >= 2)
+        else // is edge vertex (unless already edge vertex!)
         {
-          // check to make sure that this edge hasn't been marked already
-          for (j = 0; j < numNei; j++)
-          {
-            if (neighbors->GetId(j) < cellId)
-            {
-              break;
-            }
-          }
-          if (j >= numNei)
-          {
-            edge = VTK_FEATURE_EDGE_VERTEX;
-          }
+          vertices.Types[pts[j]] = VTK_FEATURE_EDGE_VERTEX;
+          vertices.InsertEdge(pts[j], pts[j - 1]);
+          vertices.InsertEdge(pts[j], pts[j + 1]);
         }
+      } // if simple vertex
 
-        else if (numNei == 1 && (nei = neighbors->GetId(0)) > cellId)
-        {
-          if (this->FeatureEdgeSmoothing)
-          {
-            vtkPolygon::ComputeNormal(inPts, npts, pts, normal);
-            Mesh->GetCellPoints(nei, numNeiPts, neiPts);
-            vtkPolygon::ComputeNormal(inPts, numNeiPts, neiPts, neiNormal);
-
-            if (vtkMath::Dot(normal, neiNormal) <= CosFeatureAngle)
-            {
-              edge = VTK_FEATURE_EDGE_VERTEX;
-            }
-          }
-        }
-        else // a visited edge; skip rest of analysis
-        {
-          continue;
-        }
+      else if (vertices.Types[pts[j]] == VTK_FEATURE_EDGE_VERTEX)
+      { // multiply connected, becomes fixed!
+        vertices.Types[pts[j]] = VTK_FIXED_VERTEX;
+        vertices.ResetEdges(pts[j]);
+      }
 
-        if (edge && Verts[p1].type == VTK_SIMPLE_VERTEX)
-        {
-          Verts[p1].edges->Reset();
-          Verts[p1].edges->InsertNextId(p2);
-          Verts[p1].type = edge;
-        }
-        else if ((edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-          (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
-          (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX))
-        {
-          Verts[p1].edges->InsertNextId(p2);
-          if (Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX)
-          {
-            Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-        }
+    } // for all points in this line
+  }   // for all lines
+  this->UpdateProgress(0.25);
 
-        if (edge && Verts[p2].type == VTK_SIMPLE_VERTEX)
-        {
-          Verts[p2].edges->Reset();
-          Verts[p2].edges->InsertNextId(p1);
-          Verts[p2].type = edge;
-        }
-        else if ((edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-          (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
-          (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX))
-        {
-          Verts[p2].edges->InsertNextId(p1);
-          if (Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX)
-          {
-            Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
-          }
-        }
-      }
-    }
+  // now polygons and triangle strips-------------------------------
+  if (Mesh)
+  {
+    AnalyzePolygons analyzePolygons(Mesh->GetPolys(), inPts, &links, &vertices,
+      this->FeatureEdgeSmoothing, CosFeatureAngle);
+    vtkSMPTools::For(0, numPts, analyzePolygons);
 
     inMesh->Delete();
     if (toTris)
     {
       toTris->Delete();
     }
-
-    neighbors->Delete();
   } // if strips or polys
 
   this->UpdateProgress(0.50);
 
   // post-process edge vertices to make sure we can smooth them
-  for (i = 0; i < numPts; i++)
-  {
-    if (Verts[i].type == VTK_SIMPLE_VERTEX)
-    {
-      numSimple++;
-    }
-
-    else if (Verts[i].type == VTK_FIXED_VERTEX)
-    {
-      numFixed++;
-    }
-
-    else if (Verts[i].type == VTK_FEATURE_EDGE_VERTEX || Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX)
-    { // see how many edges; if two, what the angle is
-
-      if (!this->BoundarySmoothing && Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX)
-      {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numBEdges++;
-      }
-
-      else if ((npts = Verts[i].edges->GetNumberOfIds()) != 2)
-      {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numFixed++;
-      }
-
-      else // check angle between edges
-      {
-        inPts->GetPoint(Verts[i].edges->GetId(0), x1);
-        inPts->GetPoint(i, x2);
-        inPts->GetPoint(Verts[i].edges->GetId(1), x3);
-
-        for (k = 0; k < 3; k++)
-        {
-          l1[k] = x2[k] - x1[k];
-          l2[k] = x3[k] - x2[k];
-        }
-        if (vtkMath::Normalize(l1) >= 0.0 && vtkMath::Normalize(l2) >= 0.0 &&
-          vtkMath::Dot(l1, l2) < CosEdgeAngle)
-        {
-          numFixed++;
-          Verts[i].type = VTK_FIXED_VERTEX;
-        }
-        else
-        {
-          if (Verts[i].type == VTK_FEATURE_EDGE_VERTEX)
-          {
-            numFEdges++;
-          }
-          else
-          {
-            numBEdges++;
-          }
-        }
-      } // if along edge
-    }   // if edge vertex
-  }     // for all points
-
-  vtkDebugMacro(<< "Found\n\t" << numSimple << " simple vertices\n\t" << numFEdges
-                << " feature edge vertices\n\t" << numBEdges << " boundary edge vertices\n\t"
-                << numFixed << " fixed vertices\n\t");
+  ClassifyEdgeVertices classifyEdgeVertices(
+    inPts, &vertices, this->BoundarySmoothing, CosEdgeAngle);
+  vtkSMPTools::For(0, numPts, classifyEdgeVertices);
+  vertices.Compact();
+
+  vtkDebugMacro(<< "Found\n\t" << classifyEdgeVertices.Counts[VTK_SIMPLE_VERTEX]
+                << " simple vertices\n\t" << classifyEdgeVertices.Counts[VTK_FEATURE_EDGE_VERTEX]
+                << " feature edge vertices\n\t"
+                << classifyEdgeVertices.Counts[VTK_BOUNDARY_EDGE_VERTEX]
+                << " boundary edge vertices\n\t" << classifyEdgeVertices.Counts[VTK_FIXED_VERTEX]
+                << " fixed vertices\n\t");
 
   vtkDebugMacro(<< "Beginning smoothing iterations...");
 
@@ -640,7 +902,33 @@ int vtkSmoothPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
 
   // If Source defined, we do constrained smoothing (that is, points are
   // constrained to the surface of the mesh object).
-  if (source)
+  if (source && this->ParallelSmoothing)
+  { // the static cell locator supports concurrent queries
+    this->SmoothPoints = new vtkSmoothPoints;
+    this->SmoothPoints->InsertSmoothPoint(numPts - 1);
+    cellLocator = vtkStaticCellLocator::New();
+
+    if (source->NeedToBuildCells())
+    {
+      source->BuildCells();
+    }
+    cellLocator->SetDataSet(source);
+    cellLocator->BuildLocator();
+
+    vtkSMPThreadLocalObject<vtkGenericCell> cells;
+    vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+      vtkGenericCell* cell = cells.Local();
+      double x[3], closest[3], d2;
+      for (; ptId < endPtId; ++ptId)
+      {
+        vtkSmoothPoint* sPtr = this->SmoothPoints->GetSmoothPoint(ptId);
+        inPts->GetPoint(ptId, x);
+        cellLocator->FindClosestPoint(x, closest, cell, sPtr->cellId, sPtr->subId, d2);
+        newPts->SetPoint(ptId, closest);
+      }
+    });
+  }
+  else if (source)
   {
     this->SmoothPoints = new vtkSmoothPoints;
     vtkSmoothPoint* sPtr;
@@ -669,23 +957,39 @@ int vtkSmoothPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
   if (newPts->GetDataType() == VTK_DOUBLE)
   {
     vtkSPDF_InternalParams<double> params = { this, this->NumberOfIterations, newPts,
-      this->RelaxationFactor, conv, numPts, Verts, source, this->SmoothPoints, w, cellLocator };
+      this->RelaxationFactor, conv, numPts, &vertices, source, this->SmoothPoints, w,
+      cellLocator };
 
-    vtkSPDF_MovePoints(params);
+    if (this->ParallelSmoothing)
+    {
+      vtkSPDF_ParallelMovePoints(params);
+    }
+    else
+    {
+      vtkSPDF_MovePoints(params);
+    }
   }
   else
   {
     vtkSPDF_InternalParams<float> params = { this, this->NumberOfIterations, newPts,
-      static_cast<float>(this->RelaxationFactor), static_cast<float>(conv), numPts, Verts, source,
-      this->SmoothPoints, w, cellLocator };
+      static_cast<float>(this->RelaxationFactor), static_cast<float>(conv), numPts, &vertices,
+      source, this->SmoothPoints, w, cellLocator };
 
-    vtkSPDF_MovePoints(params);
+    if (this->ParallelSmoothing)
+    {
+      vtkSPDF_ParallelMovePoints(params);
+    }
+    else
+    {
+      vtkSPDF_MovePoints(params);
+    }
   }
 
   if (source)
   {
     cellLocator->Delete();
     delete this->SmoothPoints;
+    this->SmoothPoints = nullptr;
     delete[] w;
   }
 
@@ -736,17 +1040,6 @@ int vtkSmoothPolyDataFilter::RequestData(vtkInformation* vtkNotUsed(request),
   output->SetPolys(input->GetPolys());
   output->SetStrips(input->GetStrips());
 
-  // free up connectivity storage
-  for (i = 0; i < numPts; i++)
-  {
-    if (Verts[i].edges != nullptr)
-    {
-      Verts[i].edges->Delete();
-      Verts[i].edges = nullptr;
-    }
-  }
-  delete[] Verts;
-
   return 1;
 }
 
@@ -787,4 +1080,5 @@ void vtkSmoothPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Smoothing: " << (this->ParallelSmoothing ? "On\n" : "Off\n");
 }
@@ -77,6 +77,14 @@
  * second input: the Source. If defined, the input mesh is constrained to
  * lie on the surface defined by the Source ivar.
  *
+ * The topological analysis is threaded with vtkSMPTools. If the ivar
+ * ParallelSmoothing is on, the smoothing iterations are threaded too: each
+ * iteration moves all the vertices from their positions at the previous
+ * iteration (Jacobi iterations) instead of using the positions already
+ * updated during the same iteration (Gauss-Seidel iterations). The result
+ * then does not depend on the number of threads, but differs slightly from
+ * the default smoothing.
+ *
  *
  * @warning
  * The Laplacian operation reduces high frequency information in the geometry
@@ -109,7 +117,8 @@ public:
    * feature edge smoothing turned off; feature
    * angle 45 degrees; edge angle 15 degrees; and boundary smoothing turned
    * on. Error scalars and vectors are not generated (by default). The
-   * convergence criterion is 0.0 of the bounding box diagonal.
+   * convergence criterion is 0.0 of the bounding box diagonal. Parallel
+   * smoothing is off.
    */
   static vtkSmoothPolyDataFilter* New();
 
@@ -215,6 +224,18 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Turn on/off the threaded smoothing iterations (see the class
+   * documentation). Each iteration then moves the vertices in parallel from
+   * their positions at the previous iteration, and the convergence criterion
+   * applies to the actual motion of the vertices. Off by default.
+   */
+  vtkSetMacro(ParallelSmoothing, vtkTypeBool);
+  vtkGetMacro(ParallelSmoothing, vtkTypeBool);
+  vtkBooleanMacro(ParallelSmoothing, vtkTypeBool);
+  ///@}
+
 protected:
   vtkSmoothPolyDataFilter();
   ~vtkSmoothPolyDataFilter() override = default;
@@ -232,6 +253,7 @@ protected:
   vtkTypeBool GenerateErrorScalars;
   vtkTypeBool GenerateErrorVectors;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelSmoothing;
 
   vtkSmoothPoints* SmoothPoints;
 
@@ -14,22 +14,439 @@
 =========================================================================*/
 #include "vtkTensorGlyph.h"
 
+#include "vtkArrayListTemplate.h" // For processing attribute data
 #include "vtkCell.h"
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkDataSet.h"
 #include "vtkExecutive.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 vtkStandardNewMacro(vtkTensorGlyph);
 
+namespace
+{
+
+// The kinds of cells of vtkPolyData: vertices, lines, polygons and strips
+constexpr int NumberOfCellKinds = 4;
+
+// Generate the tensor glyphs in parallel. Every point has the same number of
+// glyphs, which gives the offsets of its points and cells in the output, and
+// the glyphs are transformed and written into the preallocated output with
+// 3x3 matrices, as vtkTensorGlyph::RequestData() does with a vtkTransform.
+class TensorGlyphGenerator
+{
+public:
+  TensorGlyphGenerator(vtkTensorGlyph* self, vtkDataSet* input, vtkPolyData* source,
+    vtkDataArray* inTensors, vtkDataArray* inScalars)
+    : Self(self)
+    , Input(input)
+    , Tensors(inTensors)
+    , Scalars(inScalars)
+  {
+    this->NumberOfSourcePoints = source->GetNumberOfPoints();
+    this->SourcePoints.resize(3 * this->NumberOfSourcePoints);
+    for (vtkIdType i = 0; i < this->NumberOfSourcePoints; ++i)
+    {
+      source->GetPoint(i, &this->SourcePoints[3 * i]);
+    }
+    vtkDataArray* normals = source->GetPointData()->GetNormals();
+    if (normals)
+    {
+      this->SourceNormals.resize(3 * this->NumberOfSourcePoints);
+      for (vtkIdType i = 0; i < this->NumberOfSourcePoints; ++i)
+      {
+        normals->GetTuple(i, &this->SourceNormals[3 * i]);
+      }
+    }
+    vtkCellArray* cells[NumberOfCellKinds] = { source->GetVerts(), source->GetLines(),
+      source->GetPolys(), source->GetStrips() };
+    for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+    {
+      this->SourceOffsets[kind].push_back(0);
+      vtkIdType npts;
+      const vtkIdType* pts;
+      auto iter = vtk::TakeSmartPointer(cells[kind]->NewIterator());
+      for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
+      {
+        iter->GetCurrentCell(npts, pts);
+        std::vector<vtkIdType>& connectivity = this->SourceConnectivity[kind];
+        connectivity.insert(connectivity.end(), pts, pts + npts);
+        this->SourceOffsets[kind].push_back(
+          static_cast<vtkIdType>(this->SourceConnectivity[kind].size()));
+      }
+    }
+    this->NumberOfDirections = (self->GetThreeGlyphs() ? 3 : 1) * (self->GetSymmetric() + 1);
+  }
+
+  void Execute(vtkPolyData* source, vtkPolyData* output);
+
+private:
+  void GenerateGlyphs(vtkIdType ptId, ArrayList& pointArrays);
+
+  vtkTensorGlyph* Self;
+  vtkDataSet* Input;
+  vtkDataArray* Tensors;
+  vtkDataArray* Scalars;
+  int NumberOfDirections;
+  vtkIdType NumberOfSourcePoints;
+  std::vector<double> SourcePoints;
+  std::vector<double> SourceNormals;
+  std::vector<vtkIdType> SourceOffsets[NumberOfCellKinds];
+  std::vector<vtkIdType> SourceConnectivity[NumberOfCellKinds];
+
+  // The output, written in parallel
+  float* Points = nullptr;
+  vtkIdType* Offsets[NumberOfCellKinds];
+  vtkIdType* Connectivity[NumberOfCellKinds];
+  float* GlyphScalars = nullptr;
+  float* Normals = nullptr;
+  bool CopyPointData = false;
+};
+
+//------------------------------------------------------------------------------
+void TensorGlyphGenerator::GenerateGlyphs(vtkIdType ptId, ArrayList& pointArrays)
+{
+  vtkTensorGlyph* self = this->Self;
+  const int numDirs = this->NumberOfDirections;
+  const vtkIdType numSourcePts = this->NumberOfSourcePoints;
+
+  // Copy the topology of the glyphs of each source cell
+  for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+  {
+    const std::vector<vtkIdType>& sourceOffsets = this->SourceOffsets[kind];
+    const std::vector<vtkIdType>& sourceConnectivity = this->SourceConnectivity[kind];
+    const vtkIdType numCells = static_cast<vtkIdType>(sourceOffsets.size()) - 1;
+    const vtkIdType connectivitySize = static_cast<vtkIdType>(sourceConnectivity.size());
+    vtkIdType cellId = ptId * numDirs * numCells;
+    vtkIdType connectivityId = ptId * numDirs * connectivitySize;
+    for (vtkIdType c = 0; c < numCells; ++c)
+    {
+      for (int dir = 0; dir < numDirs; ++dir)
+      {
+        const vtkIdType ptIncr = (numDirs * ptId + dir) * numSourcePts;
+        this->Offsets[kind][cellId++] = connectivityId;
+        for (vtkIdType i = sourceOffsets[c]; i < sourceOffsets[c + 1]; ++i)
+        {
+          this->Connectivity[kind][connectivityId++] = sourceConnectivity[i] + ptIncr;
+        }
+      }
+    }
+  }
+
+  // Symmetric tensor support
+  double tensor[9];
+  this->Tensors->GetTuple(ptId, tensor);
+  if (this->Tensors->GetNumberOfComponents() == 6)
+  {
+    vtkMath::TensorFromSymmetricTensor(tensor);
+  }
+
+  // compute orientation vectors and scale factors from tensor
+  double w[3], xv[3], yv[3], zv[3];
+  if (self->GetExtractEigenvalues())
+  {
+    // the eigenvalues of the symmetrical part of the tensor are real
+    double m0[3], m1[3], m2[3], v0[3], v1[3], v2[3];
+    double *m[3] = { m0, m1, m2 }, *v[3] = { v0, v1, v2 };
+    for (int j = 0; j < 3; j++)
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        m[i][j] = 0.5 * (tensor[i + 3 * j] + tensor[j + 3 * i]);
+      }
+    }
+    vtkMath::Jacobi(m, w, v);
+    for (int i = 0; i < 3; i++)
+    {
+      xv[i] = v[i][0];
+      yv[i] = v[i][1];
+      zv[i] = v[i][2];
+    }
+  }
+  else // use tensor columns as eigenvectors
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      xv[i] = tensor[i];
+      yv[i] = tensor[i + 3];
+      zv[i] = tensor[i + 6];
+    }
+    w[0] = vtkMath::Normalize(xv);
+    w[1] = vtkMath::Normalize(yv);
+    w[2] = vtkMath::Normalize(zv);
+  }
+
+  const double scaleFactor = self->GetScaleFactor();
+  double maxScale = 0.0;
+  for (int i = 0; i < 3; i++)
+  {
+    w[i] *= scaleFactor;
+    maxScale = std::max(maxScale, std::abs(w[i]));
+  }
+  if (self->GetClampScaling() && maxScale > self->GetMaxScaleFactor())
+  {
+    maxScale = self->GetMaxScaleFactor() / maxScale;
+    for (int i = 0; i < 3; i++)
+    {
+      w[i] *= maxScale; // preserve overall shape of glyph
+    }
+  }
+
+  // make sure scale is okay (non-zero)
+  maxScale = std::max({ 0.0, w[0], w[1], w[2] });
+  if (maxScale == 0.0)
+  {
+    maxScale = 1.0;
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    if (w[i] == 0.0)
+    {
+      w[i] = maxScale * 1.0e-06;
+    }
+  }
+
+  double x[3];
+  this->Input->GetPoint(ptId, x);
+  const bool threeGlyphs = self->GetThreeGlyphs() != 0;
+  double scalar = 0.0;
+  if (this->Scalars && self->GetColorMode() == vtkTensorGlyph::COLOR_BY_SCALARS)
+  {
+    scalar = this->Scalars->GetComponent(ptId, 0);
+  }
+
+  // Now do the real work for each "direction"
+  for (int dir = 0; dir < numDirs; dir++)
+  {
+    const int eigenDir = dir % (threeGlyphs ? 3 : 1);
+    const int symmetricDir = dir / (threeGlyphs ? 3 : 1);
+
+    // the axes of the glyph are the eigenvectors, rotated around z by 90
+    // degrees for the eigen direction 1 and around y by -90 degrees for 2,
+    // then scaled, and mirrored for the symmetric glyphs
+    const double* axes[3] = { xv, yv, zv };
+    double sign[3] = { 1.0, 1.0, 1.0 };
+    if (eigenDir == 1)
+    {
+      axes[0] = yv;
+      axes[1] = xv;
+      sign[1] = -1.0;
+    }
+    else if (eigenDir == 2)
+    {
+      axes[0] = zv;
+      axes[2] = xv;
+      sign[2] = -1.0;
+    }
+    if (threeGlyphs)
+    {
+      sign[0] *= w[eigenDir];
+      sign[1] *= scaleFactor;
+      sign[2] *= scaleFactor;
+    }
+    else
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        sign[j] *= w[j];
+      }
+    }
+    if (symmetricDir == 1)
+    {
+      sign[0] = -sign[0];
+    }
+    double matrix[3][3];
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        matrix[i][j] = axes[j][i] * sign[j];
+      }
+    }
+
+    // if the eigenvalue is negative, shift to reverse direction, when
+    // several glyphs are drawn
+    const double shift = (w[eigenDir] < 0 && numDirs > 1) ? -self->GetLength() : 0.0;
+
+    // a negative determinant means the transform turns the glyph surface
+    // inside out, which the normals are corrected for
+    double normalMatrix[3][3];
+    if (this->Normals)
+    {
+      vtkMath::Invert3x3(matrix, normalMatrix);
+      vtkMath::Transpose3x3(normalMatrix, normalMatrix);
+      if (vtkMath::Determinant3x3(matrix) < 0)
+      {
+        for (int i = 0; i < 3; i++)
+        {
+          vtkMath::MultiplyScalar(normalMatrix[i], -1.0);
+        }
+      }
+    }
+
+    const double eigenvalue = w[eigenDir];
+    const vtkIdType ptIncr = (numDirs * ptId + dir) * numSourcePts;
+    for (vtkIdType i = 0; i < numSourcePts; i++)
+    {
+      const vtkIdType outPtId = ptIncr + i;
+      const double p[3] = { this->SourcePoints[3 * i] + shift, this->SourcePoints[3 * i + 1],
+        this->SourcePoints[3 * i + 2] };
+      float* outPt = this->Points + 3 * outPtId;
+      for (int j = 0; j < 3; j++)
+      {
+        outPt[j] = static_cast<float>(
+          x[j] + matrix[j][0] * p[0] + matrix[j][1] * p[1] + matrix[j][2] * p[2]);
+      }
+      if (this->Normals)
+      {
+        double normal[3];
+        vtkMath::Multiply3x3(normalMatrix, &this->SourceNormals[3 * i], normal);
+        vtkMath::Normalize(normal);
+        std::copy(normal, normal + 3, this->Normals + 3 * outPtId);
+      }
+      if (this->GlyphScalars)
+      {
+        // If ThreeGlyphs is false the first (largest) eigenvalue is used
+        this->GlyphScalars[outPtId] = static_cast<float>(
+          self->GetColorMode() == vtkTensorGlyph::COLOR_BY_EIGENVALUES ? eigenvalue : scalar);
+      }
+      else if (this->CopyPointData)
+      {
+        pointArrays.Copy(i, outPtId);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void TensorGlyphGenerator::Execute(vtkPolyData* source, vtkPolyData* output)
+{
+  vtkTensorGlyph* self = this->Self;
+  const vtkIdType numPts = this->Input->GetNumberOfPoints();
+  const vtkIdType numOutPts = this->NumberOfDirections * numPts * this->NumberOfSourcePoints;
+
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataTypeToFloat();
+  newPts->SetNumberOfPoints(numOutPts);
+  this->Points = static_cast<float*>(newPts->GetVoidPointer(0));
+
+  vtkSmartPointer<vtkIdTypeArray> offsets[NumberOfCellKinds];
+  vtkSmartPointer<vtkIdTypeArray> connectivity[NumberOfCellKinds];
+  for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+  {
+    const vtkIdType numCells = this->NumberOfDirections * numPts *
+      (static_cast<vtkIdType>(this->SourceOffsets[kind].size()) - 1);
+    const vtkIdType connectivitySize = this->NumberOfDirections * numPts *
+      static_cast<vtkIdType>(this->SourceConnectivity[kind].size());
+    offsets[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    offsets[kind]->SetNumberOfValues(numCells + 1);
+    offsets[kind]->SetValue(numCells, connectivitySize);
+    this->Offsets[kind] = offsets[kind]->GetPointer(0);
+    connectivity[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity[kind]->SetNumberOfValues(connectivitySize);
+    this->Connectivity[kind] = connectivity[kind]->GetPointer(0);
+  }
+
+  // only copy scalar data through
+  vtkPointData* outPD = output->GetPointData();
+  vtkPointData* pd = source->GetPointData();
+  ArrayList pointArrays;
+  vtkSmartPointer<vtkFloatArray> newScalars;
+  if (self->GetColorGlyphs() &&
+    ((self->GetColorMode() == vtkTensorGlyph::COLOR_BY_EIGENVALUES) ||
+      (this->Scalars && (self->GetColorMode() == vtkTensorGlyph::COLOR_BY_SCALARS))))
+  {
+    newScalars = vtkSmartPointer<vtkFloatArray>::New();
+    newScalars->SetNumberOfTuples(numOutPts);
+    if (self->GetColorMode() == vtkTensorGlyph::COLOR_BY_EIGENVALUES)
+    {
+      newScalars->SetName("MaxEigenvalue");
+    }
+    else
+    {
+      newScalars->SetName(this->Scalars->GetName());
+    }
+    this->GlyphScalars = newScalars->GetPointer(0);
+  }
+  else
+  {
+    outPD->CopyAllOff();
+    outPD->CopyScalarsOn();
+    outPD->CopyAllocate(pd, numOutPts);
+    pointArrays.AddArrays(numOutPts, pd, outPD, 0.0, false);
+    this->CopyPointData = true;
+  }
+  vtkSmartPointer<vtkFloatArray> newNormals;
+  if (!this->SourceNormals.empty())
+  {
+    newNormals = vtkSmartPointer<vtkFloatArray>::New();
+    newNormals->SetNumberOfComponents(3);
+    newNormals->SetName("Normals");
+    newNormals->SetNumberOfTuples(numOutPts);
+    this->Normals = newNormals->GetPointer(0);
+  }
+
+  vtkSMPTools::For(0, numPts, [&](vtkIdType ptId, vtkIdType endPtId) {
+    for (; ptId < endPtId; ++ptId)
+    {
+      this->GenerateGlyphs(ptId, pointArrays);
+    }
+  });
+
+  output->SetPoints(newPts);
+  vtkCellArray* sourceCells[NumberOfCellKinds] = { source->GetVerts(), source->GetLines(),
+    source->GetPolys(), source->GetStrips() };
+  for (int kind = 0; kind < NumberOfCellKinds; ++kind)
+  {
+    if (sourceCells[kind]->GetNumberOfCells() > 0)
+    {
+      vtkNew<vtkCellArray> cells;
+      cells->SetData(offsets[kind], connectivity[kind]);
+      switch (kind)
+      {
+        case 0:
+          output->SetVerts(cells);
+          break;
+        case 1:
+          output->SetLines(cells);
+          break;
+        case 2:
+          output->SetPolys(cells);
+          break;
+        default:
+          output->SetStrips(cells);
+      }
+    }
+  }
+  if (newScalars)
+  {
+    int idx = outPD->AddArray(newScalars);
+    outPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+  }
+  if (newNormals)
+  {
+    outPD->SetNormals(newNormals);
+  }
+}
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 // Construct object with scaling on and scale factor 1.0. Eigenvalues are
 // extracted, glyphs are colored with input scalar data, and logarithmic
@@ -46,6 +463,7 @@ vtkTensorGlyph::vtkTensorGlyph()
   this->ThreeGlyphs = 0;
   this->Symmetric = 0;
   this->Length = 1.0;
+  this->ParallelGlyphing = 0;
 
   this->SetNumberOfInputPorts(2);
 
@@ -152,6 +570,14 @@ int vtkTensorGlyph::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
   }
 
+  if (this->ParallelGlyphing)
+  {
+    TensorGlyphGenerator generator(this, input, source, inTensors, inScalars);
+    generator.Execute(source, output);
+    vtkDebugMacro(<< "Generated " << numPts << " tensor glyphs");
+    return 1;
+  }
+
   pts = new vtkIdType[source->GetMaxCellSize()];
   trans = vtkTransform::New();
   matrix = vtkMatrix4x4::New();
@@ -560,4 +986,5 @@ void vtkTensorGlyph::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Three Glyphs: " << (this->ThreeGlyphs ? "On\n" : "Off\n");
   os << indent << "Symmetric: " << (this->Symmetric ? "On\n" : "Off\n");
   os << indent << "Length: " << this->Length << "\n";
+  os << indent << "Parallel Glyphing: " << (this->ParallelGlyphing ? "On\n" : "Off\n");
 }
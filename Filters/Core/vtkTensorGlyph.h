@@ -74,6 +74,11 @@
  * additional capability over the vtkGlyph3D object. That is, the
  * glyph can be oriented in three directions instead of one.
  *
+ * If the boolean variable ParallelGlyphing is set, the glyphs are generated
+ * in parallel with vtkSMPTools, directly into the preallocated output. The
+ * output is the same as the serial one, except for the order of the cells
+ * when the source mixes vertices, lines, polygons and strips.
+ *
  * @par Thanks:
  * Thanks to Jose Paulo Moitinho de Almeida for enhancements.
  *
@@ -236,6 +241,15 @@ public:
   vtkGetMacro(MaxScaleFactor, double);
   ///@}
 
+  ///@{
+  /**
+   * Turn on/off the generation of the glyphs in parallel. Off by default.
+   */
+  vtkSetMacro(ParallelGlyphing, vtkTypeBool);
+  vtkGetMacro(ParallelGlyphing, vtkTypeBool);
+  vtkBooleanMacro(ParallelGlyphing, vtkTypeBool);
+  ///@}
+
 protected:
   vtkTensorGlyph();
   ~vtkTensorGlyph() override;
@@ -254,6 +268,7 @@ protected:
   vtkTypeBool ThreeGlyphs;        // Boolean controls drawing 1 or 3 glyphs
   vtkTypeBool Symmetric;          // Boolean controls drawing a "mirror" of each glyph
   double Length;                  // Distance, in x, from the origin to the end of the glyph
+  vtkTypeBool ParallelGlyphing;   // Boolean controls generating the glyphs in parallel
 private:
   vtkTensorGlyph(const vtkTensorGlyph&) = delete;
   void operator=(const vtkTensorGlyph&) = delete;
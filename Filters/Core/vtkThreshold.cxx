@@ -19,19 +19,26 @@
 #include "vtkThreshold.h"
 
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
-#include "vtkCellIterator.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
+#include <numeric>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
@@ -179,13 +186,8 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
   }
 
-  outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
-  outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
-
-  vtkIdType numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
 
   vtkSmartPointer<vtkPoints> newPoints = vtkSmartPointer<vtkPoints>::Take(vtkPoints::New());
 
@@ -211,107 +213,199 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
     newPoints->SetDataType(VTK_DOUBLE);
   }
 
-  newPoints->Allocate(numPts);
-
-  vtkSmartPointer<vtkIdList> pointMap =
-    vtkSmartPointer<vtkIdList>::Take(vtkIdList::New()); // maps old point ids into new
-  pointMap->SetNumberOfIds(numPts);
-  for (vtkIdType i = 0; i < numPts; i++)
+  if (numCells < 1)
   {
-    pointMap->SetId(i, -1);
+    output->SetPoints(newPoints);
+    return 1;
   }
 
-  vtkSmartPointer<vtkIdList> newCellPts = vtkSmartPointer<vtkIdList>::Take(vtkIdList::New());
-
   // are we using pointScalars?
   int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
   bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
 
-  // Check that the scalars of each cell satisfy the threshold criterion
-  vtkSmartPointer<vtkCellIterator> it =
-    vtkSmartPointer<vtkCellIterator>::Take(input->NewCellIterator());
-  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextCell())
-  {
-    int cellType = it->GetCellType();
-    if (cellType == VTK_EMPTY_CELL)
+  // Make the input API thread-safe by calling it once in a single thread.
+  vtkSMPThreadLocalObject<vtkIdList> tlCellPts;
+  input->GetCellType(0);
+  input->GetCellPoints(0, tlCellPts.Local());
+
+  // Check that the scalars of each cell satisfy the threshold criterion. The
+  // size of the kept cells is recorded, -1 flags cells thrown away.
+  std::vector<vtkIdType> cellSizes(numCells);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* cellPts = tlCellPts.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
     {
-      continue;
-    }
+      cellSizes[cellId] = -1;
+      if (input->GetCellType(cellId) == VTK_EMPTY_CELL)
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, cellPts);
+      const int numCellPts = static_cast<int>(cellPts->GetNumberOfIds());
+      int keepCell = usePointScalars
+        ? this->EvaluatePointScalars(inScalars, cellPts, numCellPts)
+        : this->EvaluateComponents(inScalars, cellId);
 
-    vtkIdType cellId = it->GetCellId();
-    vtkIdList* cellPts = it->GetPointIds();
-    int numCellPts = it->GetNumberOfPoints();
+      // Invert the keep flag if the Invert option is enabled.
+      keepCell = this->Invert ? (1 - keepCell) : keepCell;
 
-    int keepCell(0);
-    if (usePointScalars)
+      // keep non-empty cells satisfying the thresholding
+      if (numCellPts > 0 && keepCell)
+      {
+        cellSizes[cellId] = numCellPts;
+      }
+    }
+  });
+
+  // Prefix sums over blocks of cells give the output cell ids and
+  // connectivity offsets of each block, then the blocks are filled
+  // concurrently.
+  const vtkIdType blockSize = 1024;
+  const vtkIdType numBlocks = (numCells + blockSize - 1) / blockSize;
+  std::vector<vtkIdType> blockCells(numBlocks + 1, 0);
+  std::vector<vtkIdType> blockConnectivity(numBlocks + 1, 0);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType block = begin; block < end; ++block)
     {
-      if (this->AllScalars)
+      const vtkIdType lastCell = std::min((block + 1) * blockSize, numCells);
+      for (vtkIdType cellId = block * blockSize; cellId < lastCell; ++cellId)
       {
-        keepCell = 1;
-        for (int i = 0; keepCell && (i < numCellPts); i++)
+        if (cellSizes[cellId] >= 0)
         {
-          vtkIdType ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents(inScalars, ptId);
+          ++blockCells[block + 1];
+          blockConnectivity[block + 1] += cellSizes[cellId];
         }
       }
-      else
+    }
+  });
+  std::partial_sum(blockCells.begin(), blockCells.end(), blockCells.begin());
+  std::partial_sum(
+    blockConnectivity.begin(), blockConnectivity.end(), blockConnectivity.begin());
+  const vtkIdType numNewCells = blockCells[numBlocks];
+  const vtkIdType connectivitySize = blockConnectivity[numBlocks];
+
+  vtkNew<vtkIdList> cellMap; // output cell id -> input cell id
+  cellMap->SetNumberOfIds(numNewCells);
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numNewCells + 1);
+  offsets->SetValue(numNewCells, connectivitySize);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      vtkIdType newCellId = blockCells[block];
+      vtkIdType offset = blockConnectivity[block];
+      const vtkIdType lastCell = std::min((block + 1) * blockSize, numCells);
+      for (vtkIdType cellId = block * blockSize; cellId < lastCell; ++cellId)
       {
-        if (!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for (int i = 0; (!keepCell) && (i < numCellPts); i++)
-          {
-            vtkIdType ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents(inScalars, ptId);
-          }
-        }
-        else
+        if (cellSizes[cellId] >= 0)
         {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
+          cellMap->SetId(newCellId, cellId);
+          offsets->SetValue(newCellId++, offset);
+          offset += cellSizes[cellId];
         }
       }
     }
-    else // use cell scalars
+  });
+
+  // Flag the points used by the kept cells. The cells sharing a point flag
+  // it concurrently. Output points are ordered by increasing input point id.
+  std::vector<std::atomic<unsigned char>> usedFlags(numPts);
+  vtkSMPTools::For(0, numNewCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* cellPts = tlCellPts.Local();
+    for (vtkIdType newCellId = begin; newCellId < end; ++newCellId)
     {
-      keepCell = this->EvaluateComponents(inScalars, cellId);
+      input->GetCellPoints(cellMap->GetId(newCellId), cellPts);
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+      {
+        usedFlags[cellPts->GetId(i)].store(1, std::memory_order_relaxed);
+      }
+    }
+  });
+  std::vector<vtkIdType> pointMap(numPts); // maps old point ids into new
+  vtkIdType numNewPts = 0;
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    pointMap[ptId] = usedFlags[ptId].load(std::memory_order_relaxed) ? numNewPts++ : -1;
+  }
+  vtkNew<vtkIdList> pointIds; // output point id -> input point id
+  pointIds->SetNumberOfIds(numNewPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    if (pointMap[ptId] >= 0)
+    {
+      pointIds->SetId(pointMap[ptId], ptId);
     }
+  }
 
-    // Invert the keep flag if the Invert option is enabled.
-    keepCell = this->Invert ? (1 - keepCell) : keepCell;
+  newPoints->SetNumberOfPoints(numNewPts);
+  vtkSMPTools::For(0, numNewPts, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    for (vtkIdType newId = begin; newId < end; ++newId)
+    {
+      input->GetPoint(pointIds->GetId(newId), x);
+      newPoints->SetPoint(newId, x);
+    }
+  });
+
+  // Fill the output cells.
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(connectivitySize);
+  vtkNew<vtkUnsignedCharArray> cellTypes;
+  cellTypes->SetNumberOfValues(numNewCells);
+  vtkSMPTools::For(0, numNewCells, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdList* cellPts = tlCellPts.Local();
+    for (vtkIdType newCellId = begin; newCellId < end; ++newCellId)
+    {
+      const vtkIdType cellId = cellMap->GetId(newCellId);
+      cellTypes->SetValue(newCellId, static_cast<unsigned char>(input->GetCellType(cellId)));
+      input->GetCellPoints(cellId, cellPts);
+      vtkIdType* cellConnectivity = connectivity->GetPointer(offsets->GetValue(newCellId));
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+      {
+        cellConnectivity[i] = pointMap[cellPts->GetId(i)];
+      }
+    }
+  });
+  vtkNew<vtkCellArray> newCells;
+  newCells->SetData(offsets, connectivity);
 
-    if (numCellPts > 0 && keepCell)
+  // special handling for polyhedron cells
+  vtkUnstructuredGrid* ugInput = vtkUnstructuredGrid::SafeDownCast(input);
+  if (ugInput && ugInput->GetFaces())
+  {
+    vtkNew<vtkIdTypeArray> faceLocations;
+    faceLocations->SetNumberOfValues(numNewCells);
+    vtkNew<vtkIdTypeArray> faces;
+    vtkNew<vtkIdList> faceStream;
+    for (vtkIdType newCellId = 0; newCellId < numNewCells; ++newCellId)
     {
-      // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
-      for (vtkIdType i = 0; i < numCellPts; i++)
+      const vtkIdType cellId = cellMap->GetId(newCellId);
+      if (cellTypes->GetValue(newCellId) != VTK_POLYHEDRON)
       {
-        vtkIdType ptId = cellPts->GetId(i);
-        vtkIdType newId = pointMap->GetId(ptId);
-        if (newId < 0)
-        {
-          double x[3];
-          input->GetPoint(ptId, x);
-          newId = newPoints->InsertNextPoint(x);
-          pointMap->SetId(ptId, newId);
-          outPD->CopyData(pd, ptId, newId);
-        }
-        newCellPts->InsertId(i, newId);
+        faceLocations->SetValue(newCellId, -1);
+        continue;
       }
-      // special handling for polyhedron cells
-      if (cellType == VTK_POLYHEDRON)
+      faceLocations->SetValue(newCellId, faces->GetNumberOfValues());
+      ugInput->GetFaceStream(cellId, faceStream);
+      vtkUnstructuredGrid::ConvertFaceStreamPointIds(faceStream, pointMap.data());
+      for (vtkIdType i = 0; i < faceStream->GetNumberOfIds(); ++i)
       {
-        newCellPts->Reset();
-        vtkIdList* faces = it->GetFaces();
-        for (vtkIdType j = 0; j < faces->GetNumberOfIds(); ++j)
-        {
-          newCellPts->InsertNextId(faces->GetId(j));
-        }
-        vtkUnstructuredGrid::ConvertFaceStreamPointIds(newCellPts, pointMap->GetPointer(0));
+        faces->InsertNextValue(faceStream->GetId(i));
       }
-      vtkIdType newCellId = output->InsertNextCell(it->GetCellType(), newCellPts);
-      outCD->CopyData(cd, cellId, newCellId);
-      newCellPts->Reset();
-    } // satisfied thresholding
-  }   // for all cells
+    }
+    output->SetCells(cellTypes, newCells, faceLocations, faces);
+  }
+  else
+  {
+    output->SetCells(cellTypes, newCells);
+  }
+
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(pd, numNewPts);
+  outPD->CopyData(pd, pointIds);
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(cd, numNewCells);
+  outCD->CopyData(cd, cellMap);
 
   vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells() << " number of cells.");
 
@@ -322,6 +416,37 @@ int vtkThreshold::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+int vtkThreshold::EvaluatePointScalars(vtkDataArray* scalars, vtkIdList* cellPts, int numCellPts)
+{
+  int keepCell(0);
+  if (this->AllScalars)
+  {
+    keepCell = 1;
+    for (int i = 0; keepCell && (i < numCellPts); i++)
+    {
+      vtkIdType ptId = cellPts->GetId(i);
+      keepCell = this->EvaluateComponents(scalars, ptId);
+    }
+  }
+  else
+  {
+    if (!this->UseContinuousCellRange)
+    {
+      keepCell = 0;
+      for (int i = 0; (!keepCell) && (i < numCellPts); i++)
+      {
+        vtkIdType ptId = cellPts->GetId(i);
+        keepCell = this->EvaluateComponents(scalars, ptId);
+      }
+    }
+    else
+    {
+      keepCell = this->EvaluateCell(scalars, cellPts, numCellPts);
+    }
+  }
+  return keepCell;
+}
+
 int vtkThreshold::EvaluateCell(vtkDataArray* scalars, vtkIdList* cellPts, int numCellPts)
 {
   int c(0);
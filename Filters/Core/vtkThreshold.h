@@ -30,6 +30,11 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * This filter is multithreaded with vtkSMPTools: cells are evaluated in
+ * parallel, then the output is sized with prefix sums and filled in
+ * parallel. Output points are ordered by increasing input point id, so the
+ * output does not depend on the number of threads.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
  */
@@ -259,6 +264,7 @@ protected:
   int (vtkThreshold::*ThresholdFunction)(double s) const = &vtkThreshold::Between;
 
   int EvaluateComponents(vtkDataArray* scalars, vtkIdType id);
+  int EvaluatePointScalars(vtkDataArray* scalars, vtkIdList* cellPts, int numCellPts);
   int EvaluateCell(vtkDataArray* scalars, vtkIdList* cellPts, int numCellPts);
   int EvaluateCell(vtkDataArray* scalars, int c, vtkIdList* cellPts, int numCellPts);
 
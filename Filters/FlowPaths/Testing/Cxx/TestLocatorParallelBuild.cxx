@@ -0,0 +1,150 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLocatorParallelBuild.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkCellTreeLocator and vtkModifiedBSPTree build the same tree,
+// and thus answer the queries identically, whatever the number of threads.
+
+#include "vtkAbstractCellLocator.h"
+#include "vtkCellArray.h"
+#include "vtkCellTreeLocator.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkGenericCell.h"
+#include "vtkIntArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTools.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct QueryResults
+{
+  std::vector<vtkIdType> Cells;
+  std::vector<vtkIdType> Hits;
+  std::vector<double> Points;
+};
+
+template <class TLocator>
+void BuildAndQuery(vtkDataSet* input, int numberOfThreads, vtkPoints* p1, vtkPoints* p2,
+  QueryResults& results)
+{
+  vtkNew<TLocator> locator;
+  locator->SetDataSet(input);
+  vtkSMPTools::LocalScope(
+    vtkSMPTools::Config{ numberOfThreads }, [&]() { locator->BuildLocator(); });
+
+  // the boxes of the leaves describe the tree
+  vtkNew<vtkPolyData> representation;
+  vtkNew<vtkPoints> boxPoints;
+  boxPoints->SetDataTypeToDouble();
+  representation->SetPoints(boxPoints);
+  vtkNew<vtkCellArray> boxLines;
+  representation->SetLines(boxLines);
+  vtkNew<vtkIntArray> boxLevels;
+  representation->GetPointData()->AddArray(boxLevels);
+  locator->GenerateRepresentation(-1, representation);
+  vtkPoints* points = representation->GetPoints();
+  for (vtkIdType i = 0; points && i < points->GetNumberOfPoints(); ++i)
+  {
+    const double* x = points->GetPoint(i);
+    results.Points.insert(results.Points.end(), x, x + 3);
+  }
+
+  vtkNew<vtkGenericCell> cell;
+  double pcoords[3], weights[8], t, x[3];
+  int subId;
+  for (vtkIdType i = 0; i < p1->GetNumberOfPoints(); ++i)
+  {
+    results.Cells.push_back(locator->FindCell(p1->GetPoint(i), 0., cell, pcoords, weights));
+    vtkIdType cellId = -1;
+    locator->IntersectWithLine(
+      p1->GetPoint(i), p2->GetPoint(i), 0.001, t, x, pcoords, subId, cellId, cell);
+    results.Hits.push_back(cellId);
+  }
+}
+
+template <class TLocator>
+bool CheckLocator(const std::string& name, vtkDataSet* input, vtkPoints* p1, vtkPoints* p2)
+{
+  QueryResults expected;
+  BuildAndQuery<TLocator>(input, 1, p1, p2, expected);
+  QueryResults results;
+  BuildAndQuery<TLocator>(input, 4, p1, p2, results);
+
+  bool success = true;
+  if (expected.Points.empty() || expected.Points != results.Points)
+  {
+    std::cerr << name << " builds a different tree with several threads." << std::endl;
+    success = false;
+  }
+  if (expected.Cells != results.Cells)
+  {
+    std::cerr << name << "::FindCell() differs when built with several threads." << std::endl;
+    success = false;
+  }
+  if (expected.Hits != results.Hits)
+  {
+    std::cerr << name << "::IntersectWithLine() differs when built with several threads."
+              << std::endl;
+    success = false;
+  }
+  return success;
+}
+
+} // anonymous namespace
+
+int TestLocatorParallelBuild(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(-12, 12, -12, 12, -12, 12);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputConnection(wavelet->GetOutputPort());
+  tetrahedralize->Update();
+  vtkUnstructuredGrid* grid = tetrahedralize->GetOutput();
+
+  const double* bounds = grid->GetBounds();
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> p1;
+  p1->SetDataTypeToDouble();
+  vtkNew<vtkPoints> p2;
+  p2->SetDataTypeToDouble();
+  for (int i = 0; i < 1000; ++i)
+  {
+    double x[3], y[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = random->GetNextRangeValue(bounds[2 * j] - 1., bounds[2 * j + 1] + 1.);
+      y[j] = random->GetNextRangeValue(bounds[2 * j] - 1., bounds[2 * j + 1] + 1.);
+    }
+    p1->InsertNextPoint(x);
+    p2->InsertNextPoint(y);
+  }
+
+  bool success = CheckLocator<vtkCellTreeLocator>("vtkCellTreeLocator", grid, p1, p2);
+  success &= CheckLocator<vtkModifiedBSPTree>("vtkModifiedBSPTree", grid, p1, p2);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
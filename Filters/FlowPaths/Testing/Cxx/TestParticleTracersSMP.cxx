@@ -0,0 +1,258 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestParticleTracersSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the parallel advection of vtkParticleTracerBase gives the same
+// particles whatever the number of threads, and the same particles as the
+// serial advection using the same locators, that the locator of a static mesh
+// is built once, and that MaximumParticleAge bounds the streaklines.
+
+#include "vtkCellLocatorCache.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkParticleTracer.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreaklineFilter.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkUnstructuredGridAlgorithm.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+// A rotating flow in a static unstructured mesh: all the time steps share
+// the points and cells of the mesh.
+class TestUnsteadyFlowSource : public vtkUnstructuredGridAlgorithm
+{
+public:
+  static TestUnsteadyFlowSource* New();
+  vtkTypeMacro(TestUnsteadyFlowSource, vtkUnstructuredGridAlgorithm);
+
+  void SetMesh(vtkUnstructuredGrid* mesh) { this->Mesh = mesh; }
+
+protected:
+  TestUnsteadyFlowSource() { this->SetNumberOfInputPorts(0); }
+
+  int RequestInformation(vtkInformation*, vtkInformationVector**,
+    vtkInformationVector* outputVector) override
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    double timeSteps[10];
+    for (int i = 0; i < 10; ++i)
+    {
+      timeSteps[i] = i;
+    }
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), timeSteps, 10);
+    double range[2] = { 0., 9. };
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+    return 1;
+  }
+
+  int RequestData(
+    vtkInformation*, vtkInformationVector**, vtkInformationVector* outputVector) override
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkUnstructuredGrid* output = vtkUnstructuredGrid::GetData(outInfo);
+    double time = 0.;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()))
+    {
+      time = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+    }
+
+    output->CopyStructure(this->Mesh);
+    vtkIdType numPts = output->GetNumberOfPoints();
+    vtkNew<vtkDoubleArray> velocity;
+    velocity->SetName("Velocity");
+    velocity->SetNumberOfComponents(3);
+    velocity->SetNumberOfTuples(numPts);
+    vtkNew<vtkDoubleArray> scalars;
+    scalars->SetName("Scalars");
+    scalars->SetNumberOfTuples(numPts);
+    const double speed = 0.1 * (1. + 0.1 * time);
+    for (vtkIdType i = 0; i < numPts; ++i)
+    {
+      const double* x = output->GetPoint(i);
+      velocity->SetTuple3(i, -x[2] * speed, 0.2 + 0.01 * x[0], x[0] * speed);
+      scalars->SetValue(i, x[0] * x[1] + time * x[2]);
+    }
+    output->GetPointData()->SetVectors(velocity);
+    output->GetPointData()->SetScalars(scalars);
+    output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+    return 1;
+  }
+
+private:
+  vtkSmartPointer<vtkUnstructuredGrid> Mesh;
+};
+
+vtkStandardNewMacro(TestUnsteadyFlowSource);
+
+// Compare the particles and all their point data
+bool SameParticles(
+  vtkPolyData* expected, vtkPolyData* particles, double tolerance, const std::string& what)
+{
+  vtkIdType numPts = expected->GetNumberOfPoints();
+  if (numPts == 0 || particles->GetNumberOfPoints() != numPts)
+  {
+    std::cerr << what << ": " << particles->GetNumberOfPoints() << " particles instead of "
+              << numPts << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    const double* x = expected->GetPoint(i);
+    const double* y = particles->GetPoint(i);
+    for (int j = 0; j < 3; ++j)
+    {
+      if (std::abs(x[j] - y[j]) > tolerance)
+      {
+        std::cerr << what << ": wrong position of particle " << i << std::endl;
+        return false;
+      }
+    }
+  }
+  vtkPointData* expectedPD = expected->GetPointData();
+  for (int a = 0; a < expectedPD->GetNumberOfArrays(); ++a)
+  {
+    vtkDataArray* expectedArray = expectedPD->GetArray(a);
+    vtkDataArray* array = particles->GetPointData()->GetArray(expectedArray->GetName());
+    if (!array || array->GetNumberOfValues() != expectedArray->GetNumberOfValues())
+    {
+      std::cerr << what << ": wrong array " << expectedArray->GetName() << std::endl;
+      return false;
+    }
+    int numComps = array->GetNumberOfComponents();
+    for (vtkIdType i = 0; i < numPts; ++i)
+    {
+      for (int j = 0; j < numComps; ++j)
+      {
+        double value = expectedArray->GetComponent(i, j);
+        if (std::abs(array->GetComponent(i, j) - value) > tolerance * (1. + std::abs(value)))
+        {
+          std::cerr << what << ": wrong " << expectedArray->GetName() << " of particle " << i
+                    << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Trace with the locators of a cache, so that the serial advection finds the
+// same cells as the parallel one
+vtkSmartPointer<vtkPolyData> TraceParticles(vtkAlgorithm* source, vtkPolyData* seeds, bool parallel)
+{
+  vtkNew<vtkCellLocatorCache> cache;
+  vtkNew<vtkParticleTracer> tracer;
+  tracer->SetCellLocatorCache(cache);
+  tracer->SetInputConnection(0, source->GetOutputPort());
+  tracer->SetInputData(1, seeds);
+  tracer->SetForceReinjectionEveryNSteps(2);
+  tracer->SetTerminationTime(6.);
+  tracer->SetParallelAdvection(parallel);
+  tracer->Update();
+  auto particles = vtkSmartPointer<vtkPolyData>::New();
+  particles->DeepCopy(tracer->GetOutput());
+  return particles;
+}
+
+} // anonymous namespace
+
+int TestParticleTracersSMP(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(-6, 6, -6, 6, -6, 6);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputConnection(wavelet->GetOutputPort());
+  tetrahedralize->Update();
+  vtkNew<TestUnsteadyFlowSource> source;
+  source->SetMesh(tetrahedralize->GetOutput());
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> seedPoints;
+  for (int i = 0; i < 300; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = random->GetNextRangeValue(-5.5, 5.5);
+    }
+    seedPoints->InsertNextPoint(x);
+  }
+  vtkNew<vtkPolyData> seeds;
+  seeds->SetPoints(seedPoints);
+
+  vtkSmartPointer<vtkPolyData> expected = TraceParticles(source, seeds, false);
+  auto parallel =
+    vtkTest::RunSequentialAndThreaded([&]() { return TraceParticles(source, seeds, true); });
+  bool success =
+    SameParticles(parallel.first, parallel.second, 0., "Parallel advection with 4 threads");
+  success &= SameParticles(expected, parallel.second, 0., "Parallel advection");
+
+  // some particles leave the mesh, so that all the cases are covered: the
+  // seeds are injected at the time steps 0, 2, 4 and 6
+  if (expected->GetNumberOfPoints() >= 4 * seeds->GetNumberOfPoints())
+  {
+    std::cerr << "No particle left the mesh" << std::endl;
+    success = false;
+  }
+
+  // the streaklines of a static mesh build its locator once, and are bounded
+  // by the maximum age of the particles
+  vtkNew<vtkCellLocatorCache> cache;
+  vtkNew<vtkStreaklineFilter> streaklines;
+  streaklines->SetInputConnection(0, source->GetOutputPort());
+  streaklines->SetInputData(1, seeds);
+  streaklines->SetTerminationTime(8.);
+  streaklines->SetParallelAdvection(true);
+  streaklines->SetCellLocatorCache(cache);
+  vtkSMPTools::LocalScope(vtkTest::ThreadedConfig(), [&]() { streaklines->Update(); });
+  vtkIdType numPts = streaklines->GetOutput()->GetNumberOfPoints();
+  if (cache->GetNumberOfBuilds() != 1)
+  {
+    std::cerr << cache->GetNumberOfBuilds() << " locators built for a static mesh" << std::endl;
+    success = false;
+  }
+
+  streaklines->SetMaximumParticleAge(2.5);
+  vtkSMPTools::LocalScope(vtkTest::ThreadedConfig(), [&]() { streaklines->Update(); });
+  vtkPolyData* output = streaklines->GetOutput();
+  vtkDataArray* age = output->GetPointData()->GetArray("ParticleAge");
+  if (output->GetNumberOfPoints() == 0 || output->GetNumberOfPoints() >= numPts ||
+    age->GetRange()[1] > 2.5)
+  {
+    std::cerr << "MaximumParticleAge does not bound the streaklines" << std::endl;
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -151,6 +151,19 @@ void vtkCachingInterpolatedVelocityField::SetDataSet(
   this->Weights.assign(maxsize, 0.0);
 }
 //------------------------------------------------------------------------------
+void vtkCachingInterpolatedVelocityField::CopyParameters(vtkCachingInterpolatedVelocityField* from)
+{
+  this->SetVectorsSelection(from->VectorsSelection);
+  this->CacheList = from->CacheList;
+  for (auto& data : this->CacheList)
+  {
+    data.Cell = vtkSmartPointer<vtkGenericCell>::New();
+  }
+  this->Weights.assign(from->Weights.size(), 0.0);
+  this->LastCacheIndex = 0;
+  this->ClearLastCellInfo();
+}
+//------------------------------------------------------------------------------
 void vtkCachingInterpolatedVelocityField::SetLastCellInfo(vtkIdType c, int datasetindex)
 {
   if ((this->LastCacheIndex != datasetindex) || (this->LastCellId != c))
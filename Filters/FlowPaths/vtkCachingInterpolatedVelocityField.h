@@ -102,6 +102,14 @@ public:
   void SelectVectors(const char* fieldName) { this->SetVectorsSelection(fieldName); }
   ///@}
 
+  /**
+   * Copy the datasets, their locators and the vectors selection of another
+   * function, which this one then evaluates with its own cells and weights.
+   * Functions copied from the same one can thus be evaluated concurrently,
+   * provided that the locators of the datasets support concurrent queries.
+   */
+  void CopyParameters(vtkCachingInterpolatedVelocityField* from);
+
   /**
    * Set LastCellId to c and LastCacheIndex datasetindex, cached from last evaluation.
    * If c isn't -1 then the corresponding cell is stored in Cache->Cell.
@@ -66,6 +66,27 @@ void vtkCellLocatorInterpolatedVelocityField::SetCellLocatorPrototype(
   vtkCellLocatorStrategy::SafeDownCast(this->FindCellStrategy)->SetCellLocator(prototype);
 }
 
+//------------------------------------------------------------------------------
+void vtkCellLocatorInterpolatedVelocityField::SetCellLocatorCache(vtkCellLocatorCache* cache)
+{
+  // Make sure the find cell strategy is appropriate for using a
+  // cell Locator
+  if (!vtkCellLocatorStrategy::SafeDownCast(this->FindCellStrategy))
+  {
+    vtkNew<vtkCellLocatorStrategy> strat;
+    this->SetFindCellStrategy(strat);
+  }
+
+  vtkCellLocatorStrategy::SafeDownCast(this->FindCellStrategy)->SetCellLocatorCache(cache);
+}
+
+//------------------------------------------------------------------------------
+vtkCellLocatorCache* vtkCellLocatorInterpolatedVelocityField::GetCellLocatorCache()
+{
+  vtkCellLocatorStrategy* strategy = vtkCellLocatorStrategy::SafeDownCast(this->FindCellStrategy);
+  return strategy ? strategy->GetCellLocatorCache() : nullptr;
+}
+
 //------------------------------------------------------------------------------
 void vtkCellLocatorInterpolatedVelocityField::AddDataSet(vtkDataSet* dataset)
 {
@@ -55,6 +55,7 @@
 #include "vtkFiltersFlowPathsModule.h" // For export macro
 
 class vtkAbstractCellLocator;
+class vtkCellLocatorCache;
 class vtkCellLocatorInterpolatedVelocityFieldCellLocatorsType;
 
 class VTKFILTERSFLOWPATHS_EXPORT vtkCellLocatorInterpolatedVelocityField
@@ -107,6 +108,16 @@ public:
   vtkGetObjectMacro(CellLocatorPrototype, vtkAbstractCellLocator);
   ///@}
 
+  ///@{
+  /**
+   * Set/Get the cache from which the cell locators of the datasets are taken,
+   * so that they are not built again at each time step when the mesh does
+   * not change (see vtkCellLocatorStrategy). By default there is no cache.
+   */
+  void SetCellLocatorCache(vtkCellLocatorCache* cache);
+  vtkCellLocatorCache* GetCellLocatorCache();
+  ///@}
+
 protected:
   vtkCellLocatorInterpolatedVelocityField();
   ~vtkCellLocatorInterpolatedVelocityField() override;
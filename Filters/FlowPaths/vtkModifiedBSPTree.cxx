@@ -18,6 +18,7 @@
 #include "vtkIdListCollection.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 
 #include <algorithm>
 #include <functional>
@@ -84,8 +85,6 @@ public:
 
 typedef cell_extents* cell_extents_List;
 
-static int global_list_count = 0;
-
 class Sorted_cell_extents_Lists
 {
 public:
@@ -99,7 +98,6 @@ public:
       Mins[i] = new cell_extents[nCells]; // max num <= nCells/2 ?
       Maxs[i] = new cell_extents[nCells];
     }
-    global_list_count += 1;
   };
   ~Sorted_cell_extents_Lists()
   {
@@ -108,7 +106,6 @@ public:
       delete[](Mins[i]);
       delete[](Maxs[i]);
     }
-    global_list_count -= 1;
   }
 };
 
@@ -202,7 +199,7 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
 
   // create the root node
   this->mRoot = new BSPNode();
-  this->mRoot->mAxis = rand() % 3;
+  this->mRoot->mAxis = 0;
   this->mRoot->depth = 0;
   //
   if (numCells == 0)
@@ -212,37 +209,108 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
   //
   this->StoreCellBounds();
   //
-  // sort the cells into 6 lists using structure for subdividing tests
+  // sort the cells into 6 lists using structure for subdividing tests,
+  // the 6 lists are independent so they are sorted in parallel
   Sorted_cell_extents_Lists* lists = new Sorted_cell_extents_Lists(numCells);
-  for (int i = 0; i < 3; i++)
-  { // loop over each axis
-    for (vtkIdType j = 0; j < numCells; j++)
-    {                                                   // loop over each cell
-      lists->Mins[i][j].min = CellBounds[j][i * 2];     // i=0 xmin, i=1 ymin, i=2 zmin
-      lists->Mins[i][j].max = CellBounds[j][i * 2 + 1]; // i=0 xmax, i=1 ymax, i=2 zmax
-      lists->Mins[i][j].cell_ID = j;
-      //
-      lists->Maxs[i][j].min = CellBounds[j][i * 2];
-      lists->Maxs[i][j].max = CellBounds[j][i * 2 + 1];
-      lists->Maxs[i][j].cell_ID = j;
+  vtkSMPTools::For(0, 6, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType l = begin; l < end; ++l)
+    {
+      int i = static_cast<int>(l / 2); // i=0 x, i=1 y, i=2 z
+      cell_extents_List list = (l % 2) ? lists->Maxs[i] : lists->Mins[i];
+      for (vtkIdType j = 0; j < numCells; j++)
+      {
+        list[j].min = this->CellBounds[j][i * 2];
+        list[j].max = this->CellBounds[j][i * 2 + 1];
+        list[j].cell_ID = j;
+      }
+      qsort(list, numCells, sizeof(cell_extents), (l % 2) ? CompareMax : CompareMin);
     }
-    // Sort
-    qsort(lists->Mins[i], numCells, sizeof(cell_extents), CompareMin);
-    qsort(lists->Maxs[i], numCells, sizeof(cell_extents), CompareMax);
-  }
+  });
   //
-  // call the recursive subdivision routine
+  // Split the top of the tree sequentially until there are enough subtrees
+  // to keep all the threads busy, then subdivide these in parallel. Nodes
+  // are split the same way whatever the order, so the tree does not depend
+  // on the number of threads.
   //
   vtkDebugMacro(<< "Beginning Subdivision");
   //
-  if (numCells > 0)
+  struct PendingNode
+  {
+    BSPNode* Node;
+    Sorted_cell_extents_Lists* Lists;
+    vtkIdType NumCells;
+  };
+  std::vector<PendingNode> pending{ { this->mRoot, lists, numCells } };
+  const std::size_t targetSize = 4 * vtkSMPTools::GetEstimatedNumberOfThreads();
+  const vtkIdType minCells = std::max<vtkIdType>(1024, 4 * this->NumberOfCellsPerNode);
+  bool split = true;
+  while (split && pending.size() < targetSize)
   {
-    Subdivide(this->mRoot, lists, this->DataSet, numCells, 0, this->MaxLevel,
-      this->NumberOfCellsPerNode, this->Level);
+    split = false;
+    std::vector<PendingNode> next;
+    for (const PendingNode& item : pending)
+    {
+      if (item.NumCells < minCells)
+      {
+        next.push_back(item);
+        continue;
+      }
+      Sorted_cell_extents_Lists* childLists[3];
+      vtkIdType childCells[3];
+      if (this->SplitNode(item.Node, item.Lists, item.NumCells, item.Node->depth, this->MaxLevel,
+            this->NumberOfCellsPerNode, childLists, childCells))
+      {
+        split = true;
+        for (int i = 0; i < 3; i++)
+        {
+          if (childLists[i])
+          {
+            next.push_back({ item.Node->mChild[i], childLists[i], childCells[i] });
+          }
+        }
+      }
+      delete item.Lists;
+    }
+    pending.swap(next);
   }
-  delete lists;
+
+  vtkSMPTools::For(0, static_cast<vtkIdType>(pending.size()), 1,
+    [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const PendingNode& item = pending[i];
+        int maxDepth = 0;
+        this->Subdivide(item.Node, item.Lists, this->DataSet, item.NumCells, item.Node->depth,
+          this->MaxLevel, this->NumberOfCellsPerNode, maxDepth);
+        delete item.Lists;
+      }
+    });
   // Child nodes are responsible for freeing the temporary sorted lists
   //
+  // Gather the statistics of the tree
+  std::vector<BSPNode*> stack{ this->mRoot };
+  while (!stack.empty())
+  {
+    BSPNode* node = stack.back();
+    stack.pop_back();
+    this->Level = std::max(this->Level, node->depth);
+    if (node->mChild[0])
+    {
+      this->npn += 1; // Parent node
+      for (int i = 0; i < 3; i++)
+      {
+        if (node->mChild[i])
+        {
+          stack.push_back(node->mChild[i]);
+        }
+      }
+    }
+    else
+    {
+      this->nln += 1; // Leaf node
+      this->tot_depth += node->depth;
+    }
+  }
   this->BuildTime.Modified();
   //
   double av_depth = (double)tot_depth / nln;
@@ -260,15 +328,45 @@ void vtkModifiedBSPTree::BuildLocatorInternal()
 void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lists,
   vtkDataSet* dataset, vtkIdType nCells, int depth, int maxlevel, vtkIdType maxCells, int& MaxDepth)
 {
-  //
-  // We've got lists sorted on the axes, so we can easily get BBox
-  node->setMin(lists->Mins[0][0].min, lists->Mins[1][0].min, lists->Mins[2][0].min);
-  node->setMax(lists->Maxs[0][0].max, lists->Maxs[1][0].max, lists->Maxs[2][0].max);
   // Update depth info
   if (node->depth > MaxDepth)
   {
     MaxDepth = depth;
   }
+  Sorted_cell_extents_Lists* childLists[3];
+  vtkIdType childCells[3];
+  if (!this->SplitNode(node, lists, nCells, depth, maxlevel, maxCells, childLists, childCells))
+  {
+    return;
+  }
+  //
+  // And of course, we really ought to subdivide again - Hoorah!
+  // NB: it is possible for the middle node to be empty, it has then been deleted
+  for (int i = 0; i < 3; i++)
+  {
+    if (childLists[i])
+    {
+      Subdivide(node->mChild[i], childLists[i], dataset, childCells[i], depth + 1, maxlevel,
+        maxCells, MaxDepth);
+      delete childLists[i];
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Divide the node in 3 children and partition its cells in their lists, or
+// make it a leaf when no further subdivision is necessary or possible. The
+// lists of the node are not modified, so that subtrees can be subdivided in
+// parallel.
+//
+bool vtkModifiedBSPTree::SplitNode(BSPNode* node, Sorted_cell_extents_Lists* lists,
+  vtkIdType nCells, int depth, int maxlevel, vtkIdType maxCells,
+  Sorted_cell_extents_Lists* childLists[3], vtkIdType childCells[3])
+{
+  //
+  // We've got lists sorted on the axes, so we can easily get BBox
+  node->setMin(lists->Mins[0][0].min, lists->Mins[1][0].min, lists->Mins[2][0].min);
+  node->setMax(lists->Maxs[0][0].max, lists->Maxs[1][0].max, lists->Maxs[2][0].max);
   //
   // Make sure child nodes are clear to start with
   node->mChild[2] = node->mChild[1] = node->mChild[0] = nullptr;
@@ -315,12 +413,6 @@ void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lis
     // construct the 3 children
     if (found)
     {
-      for (int i = 0; i < 3; i++)
-      {
-        node->mChild[i] = new BSPNode();
-        node->mChild[i]->depth = node->depth + 1;
-        node->mChild[i]->mAxis = rand() % 3;
-      }
       Daxis = node->mAxis;
       Sorted_cell_extents_Lists* left = new Sorted_cell_extents_Lists(nCells);
       Sorted_cell_extents_Lists* mid = new Sorted_cell_extents_Lists(nCells);
@@ -439,62 +531,37 @@ void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lis
       {
         // vtkDebugMacro(<<"Child 0 or 2 empty : Aborting subdivision for node " << Cmin_l[0] << " "
         // << Cmin_m[0] << " " << Cmin_r[0]); clean up all the memory we allocated. Yikes.
-        for (int i = 0; i < 3; i++)
-        {
-          delete node->mChild[i];
-          node->mChild[i] = nullptr;
-        }
         delete left;
         delete mid;
         delete right;
       }
       else
       {
-        //
-        // Now we can delete the lists that the parent passed on to us
-        //
-        //
-        // And of course, we really ought to subdivide again - Hoorah!
-        // NB: it is possible for a node to be empty now, so check and delete if necessary
-        if (Cmin_l[0])
-        {
-          Subdivide(
-            node->mChild[0], left, dataset, Cmin_l[0], depth + 1, maxlevel, maxCells, MaxDepth);
-        }
-        else
-        {
-          vtkWarningMacro(<< "Child 0 Empty ! - this shouldn't happen");
-        }
-        delete left;
-
-        if (Cmin_m[0])
-        {
-          Subdivide(
-            node->mChild[1], mid, dataset, Cmin_m[0], depth + 1, maxlevel, maxCells, MaxDepth);
-        }
-        else
-        {
-          delete node->mChild[1];
-          node->mChild[1] = nullptr;
-        }
-        delete mid;
-
-        if (Cmin_r[0])
-        {
-          Subdivide(
-            node->mChild[2], right, dataset, Cmin_r[0], depth + 1, maxlevel, maxCells, MaxDepth);
-        }
-        else
+        // The children start their search for a plane along the next axis,
+        // this is deterministic so that subtrees can be built in any order.
+        Sorted_cell_extents_Lists* childList[3] = { left, mid, right };
+        const vtkIdType childCount[3] = { Cmin_l[0], Cmin_m[0], Cmin_r[0] };
+        for (int i = 0; i < 3; i++)
         {
-          vtkWarningMacro(<< "Child 2 Empty ! - this shouldn't happen");
+          if (childCount[i])
+          {
+            node->mChild[i] = new BSPNode();
+            node->mChild[i]->depth = node->depth + 1;
+            node->mChild[i]->mAxis = (node->mAxis + 1) % 3;
+            childLists[i] = childList[i];
+            childCells[i] = childCount[i];
+          }
+          else
+          {
+            delete childList[i];
+            childLists[i] = nullptr;
+            childCells[i] = 0;
+          }
         }
-        delete right;
-        //
-        npn += 1; // Parent node
         //
         // we've done all we were asked to do
         //
-        return;
+        return true;
       }
     }
   }
@@ -503,8 +570,6 @@ void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lis
   //
   // Copy the cell IDs into the actual node structure for proper use
   node->num_cells = nCells;
-  nln += 1; // Leaf node
-  tot_depth += node->depth;
   for (int i = 0; i < 6; i++)
   {
     node->sorted_cell_lists[i] = new vtkIdType[nCells];
@@ -519,6 +584,7 @@ void vtkModifiedBSPTree::Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lis
     }
   }
   // Thank buggery that's all over.
+  return false;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -250,6 +250,12 @@ protected:
   void Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lists, vtkDataSet* dataSet,
     vtkIdType nCells, int depth, int maxlevel, vtkIdType maxCells, int& MaxDepth);
 
+  // Split a node in up to 3 children, returning their lists of cells, or make
+  // it a leaf and return false.
+  bool SplitNode(BSPNode* node, Sorted_cell_extents_Lists* lists, vtkIdType nCells, int depth,
+    int maxlevel, vtkIdType maxCells, Sorted_cell_extents_Lists* childLists[3],
+    vtkIdType childCells[3]);
+
   // We provide a function which does the cell/ray test so that
   // it can be overridden by subclasses to perform special treatment
   // (Example : Particles stored in tree, have no dimension, so we must
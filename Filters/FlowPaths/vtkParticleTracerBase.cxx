@@ -17,6 +17,7 @@
 #include "vtkAbstractParticleWriter.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkCellLocatorCache.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkDataObjectTreeRange.h"
 #include "vtkDoubleArray.h"
@@ -34,6 +35,8 @@
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSignedCharArray.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -79,6 +82,7 @@ ParticleTracerSetMacro(ComputeVorticity, bool);
 ParticleTracerSetMacro(RotationScale, double);
 ParticleTracerSetMacro(ForceReinjectionEveryNSteps, int);
 ParticleTracerSetMacro(TerminalSpeed, double);
+ParticleTracerSetMacro(MaximumParticleAge, double);
 
 namespace
 {
@@ -102,6 +106,65 @@ inline int FindInterval(double a, const std::vector<double>& A)
 }
 };
 
+namespace vtkParticleTracerBaseNamespace
+{
+// Advance the particles of a block, each thread with its own copies of the
+// velocity field and the integrator of the filter.
+class ParticleAdvectionFunctor
+{
+public:
+  ParticleAdvectionFunctor(vtkParticleTracerBase* tracer,
+    const std::vector<ParticleListIterator>& particles, std::vector<ParticleStep>& steps,
+    double currentTime, double targetTime)
+    : Tracer(tracer)
+    , Particles(particles)
+    , Steps(steps)
+    , CurrentTime(currentTime)
+    , TargetTime(targetTime)
+  {
+  }
+
+  void Initialize()
+  {
+    // the copies are kept over the blocks
+    LocalAdvection& local = this->Local.Local();
+    if (!local.Interpolator)
+    {
+      local.Interpolator = vtkSmartPointer<vtkTemporalInterpolatedVelocityField>::New();
+      local.Interpolator->CopyParameters(this->Tracer->GetInterpolator());
+      local.Integrator.TakeReference(this->Tracer->GetIntegrator()->NewInstance());
+      local.Integrator->SetFunctionSet(local.Interpolator);
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    LocalAdvection& local = this->Local.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Tracer->AdvanceParticle(*this->Particles[i], this->Steps[i], this->CurrentTime,
+        this->TargetTime, local.Integrator, local.Interpolator);
+    }
+  }
+
+  void Reduce() {}
+
+private:
+  struct LocalAdvection
+  {
+    vtkSmartPointer<vtkTemporalInterpolatedVelocityField> Interpolator;
+    vtkSmartPointer<vtkInitialValueProblemSolver> Integrator;
+  };
+
+  vtkParticleTracerBase* Tracer;
+  const std::vector<ParticleListIterator>& Particles;
+  std::vector<ParticleStep>& Steps;
+  double CurrentTime;
+  double TargetTime;
+  vtkSMPThreadLocal<LocalAdvection> Local;
+};
+}
+
 //------------------------------------------------------------------------------
 vtkParticleTracerBase::vtkParticleTracerBase()
 {
@@ -132,6 +195,8 @@ vtkParticleTracerBase::vtkParticleTracerBase()
   this->RotationScale = 1.0;
   this->MaximumError = 1.0e-6;
   this->TerminalSpeed = vtkParticleTracerBase::Epsilon;
+  this->MaximumParticleAge = VTK_DOUBLE_MAX;
+  this->ParallelAdvection = 0;
   this->IntegrationStep = 0.5;
 
   this->Interpolator = vtkSmartPointer<vtkTemporalInterpolatedVelocityField>::New();
@@ -400,6 +465,19 @@ int vtkParticleTracerBase::InitializeInterpolator()
   vtkDebugMacro(<< "Interpolator using array " << vecname);
   this->Interpolator->SelectVectors(vecname);
 
+  // The parallel advection needs locators supporting concurrent queries,
+  // which are taken from a cache of the filter if none is given.
+  vtkCellLocatorCache* locatorCache = this->CellLocatorCache;
+  if (!locatorCache && this->ParallelAdvection)
+  {
+    if (!this->AdvectionLocatorCache)
+    {
+      this->AdvectionLocatorCache = vtkSmartPointer<vtkCellLocatorCache>::New();
+    }
+    locatorCache = this->AdvectionLocatorCache;
+  }
+  this->Interpolator->SetCellLocatorCache(locatorCache);
+
   this->AllFixedGeometry = 1;
 
   int numValidInputBlocks[2] = { 0, 0 };
@@ -440,6 +518,12 @@ int vtkParticleTracerBase::InitializeInterpolator()
           inp->ComputeBounds();
           inp->GetBounds(&bbox.b[0]);
           this->CachedBounds[T].push_back(bbox);
+          if (this->ParallelAdvection)
+          {
+            // build the cells before the threads get them
+            double cellBounds[6];
+            inp->GetCellBounds(0, cellBounds);
+          }
           bool static_dataset = (this->StaticMesh != 0);
           this->AllFixedGeometry = this->AllFixedGeometry && static_dataset;
           // add the dataset to the interpolator
@@ -456,6 +540,14 @@ int vtkParticleTracerBase::InitializeInterpolator()
       anotherIterP->GoToNextItem();
     }
   }
+  // keep the locators of both time steps for the next step, where a static
+  // mesh reuses them
+  const int numLocators = numValidInputBlocks[0] + numValidInputBlocks[1];
+  if (locatorCache && locatorCache == this->AdvectionLocatorCache &&
+    locatorCache->GetMaximumNumberOfLocators() < numLocators)
+  {
+    locatorCache->SetMaximumNumberOfLocators(numLocators);
+  }
   if (numValidInputBlocks[0] == 0 || numValidInputBlocks[1] == 0)
   {
     vtkErrorMacro("Not enough inputs have been found. Can not execute."
@@ -893,18 +985,25 @@ vtkPolyData* vtkParticleTracerBase::Execute(vtkInformationVector** inputVector)
     {
       vtkDebugMacro(<< "Begin Pass " << pass << " with " << this->ParticleHistories.size()
                     << " Particles");
-      for (ParticleListIterator it = it_first; it != it_last;)
+      if (this->ParallelAdvection)
       {
-        // Keep the 'next' iterator handy because if a particle is terminated
-        // or leaves the domain, the 'current' iterator will be deleted.
-        it_next = it;
-        it_next++;
-        this->IntegrateParticle(it, from, this->CurrentTimeValue, integrator);
-        if (this->GetAbortExecute())
+        this->IntegrateParticles(it_first, it_last, from, this->CurrentTimeValue);
+      }
+      else
+      {
+        for (ParticleListIterator it = it_first; it != it_last;)
         {
-          break;
+          // Keep the 'next' iterator handy because if a particle is terminated
+          // or leaves the domain, the 'current' iterator will be deleted.
+          it_next = it;
+          it_next++;
+          this->IntegrateParticle(it, from, this->CurrentTimeValue, integrator);
+          if (this->GetAbortExecute())
+          {
+            break;
+          }
+          it = it_next;
         }
-        it = it_next;
       }
       // Particles might have been deleted during the first pass as they move
       // out of domain or age. Before adding any new particles that are sent
@@ -1090,16 +1189,26 @@ int vtkParticleTracerBase::RequestData(
 //------------------------------------------------------------------------------
 void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double currenttime,
   double targettime, vtkInitialValueProblemSolver* integrator)
+{
+  ParticleStep step;
+  this->AdvanceParticle(*it, step, currenttime, targettime, integrator, this->Interpolator);
+  this->FinishParticle(it, step, false);
+}
+
+//------------------------------------------------------------------------------
+int vtkParticleTracerBase::AdvanceParticle(ParticleInformation& info, ParticleStep& step,
+  double currenttime, double targettime, vtkInitialValueProblemSolver* integrator,
+  vtkTemporalInterpolatedVelocityField* interpolator)
 {
   double epsilon = (targettime - currenttime) / 100.0;
-  double velocity[3], point1[4], point2[4] = { 0.0, 0.0, 0.0, 0.0 };
+  double point1[4], point2[4] = { 0.0, 0.0, 0.0, 0.0 };
   double minStep = 0, maxStep = 0;
   double stepWanted, stepTaken = 0.0;
   int substeps = 0;
 
-  ParticleInformation& info = (*it);
-  ParticleInformation previous = (*it);
-  bool particle_good = true;
+  step.Previous = info;
+  step.Velocity[0] = step.Velocity[1] = step.Velocity[2] = 0.0;
+  step.Status = PARTICLE_ADVANCED;
 
   info.ErrorCode = 0;
 
@@ -1109,6 +1218,7 @@ void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double c
   if (currenttime == targettime)
   {
     Assert(point1[3] == currenttime);
+    step.Status = PARTICLE_UNMOVED;
   }
   else
   {
@@ -1120,11 +1230,11 @@ void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double c
     //
     if (this->AllFixedGeometry)
     {
-      this->Interpolator->SetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
+      interpolator->SetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
     }
     else
     {
-      this->Interpolator->ClearCache();
+      interpolator->ClearCache();
     }
 
     double delT = (targettime - currenttime) * this->IntegrationStep;
@@ -1153,18 +1263,9 @@ void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double c
       {
         // if the particle is sent, remove it from the list
         info.ErrorCode = 1;
-        if (!this->RetryWithPush(info, point1, delT, substeps))
+        if (!this->RetryWithPush(info, point1, delT, substeps, interpolator))
         {
-          if (previous.PointId < 0 && previous.TailPointId < 0)
-          {
-            vtkErrorMacro("the particle should have been added");
-          }
-          else
-          {
-            this->SendParticleToAnotherProcess(info, previous, this->ParticlePointData);
-          }
-          this->ParticleHistories.erase(it);
-          particle_good = false;
+          step.Status = PARTICLE_LOST;
           break;
         }
         else
@@ -1199,36 +1300,72 @@ void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double c
       }
     }
 
-    if (particle_good)
+    if (step.Status == PARTICLE_ADVANCED)
     {
       // The integration succeeded, but check the computed final position
       // is actually inside the domain (the intermediate steps taken inside
       // the integrator were ok, but the final step may just pass out)
       // if it moves out, we can't interpolate scalars, so we must send it away
-      info.LocationState = this->Interpolator->TestPoint(info.CurrentPosition.x);
+      info.LocationState = interpolator->TestPoint(info.CurrentPosition.x);
       if (info.LocationState == ID_OUTSIDE_ALL)
       {
         info.ErrorCode = 2;
-        // if the particle is sent, remove it from the list
-        if (this->SendParticleToAnotherProcess(info, previous, this->OutputPointData))
-        {
-          this->ParticleHistories.erase(it);
-          particle_good = false;
-        }
+        step.Status = PARTICLE_OUTSIDE;
       }
+      interpolator->GetLastGoodVelocity(step.Velocity);
     }
+  }
 
-    // Has this particle stagnated
-    //
-    if (particle_good)
+  //
+  // store the last Cell Ids and dataset indices for next time particle is updated
+  //
+  interpolator->GetCachedCellIds(step.CachedCellId, step.CachedDataSetId);
+
+#ifdef DEBUGPARTICLETRACE
+  double eps = (this->GetCacheDataTime(1) - this->GetCacheDataTime(0)) / 100;
+  Assert(point1[3] >= (this->GetCacheDataTime(0) - eps) &&
+    point1[3] <= (this->GetCacheDataTime(1) + eps));
+#endif
+  return step.Status;
+}
+
+//------------------------------------------------------------------------------
+void vtkParticleTracerBase::FinishParticle(
+  ParticleListIterator& it, ParticleStep& step, bool findCell)
+{
+  ParticleInformation& info = (*it);
+  bool particle_good = true;
+
+  if (step.Status == PARTICLE_LOST)
+  {
+    if (step.Previous.PointId < 0 && step.Previous.TailPointId < 0)
     {
-      this->Interpolator->GetLastGoodVelocity(velocity);
-      info.speed = vtkMath::Norm(velocity);
-      if (it->speed <= this->TerminalSpeed)
-      {
-        this->ParticleHistories.erase(it);
-        particle_good = false;
-      }
+      vtkErrorMacro("the particle should have been added");
+    }
+    else
+    {
+      this->SendParticleToAnotherProcess(info, step.Previous, this->ParticlePointData);
+    }
+    this->ParticleHistories.erase(it);
+    particle_good = false;
+  }
+  // if the particle is sent, remove it from the list
+  else if (step.Status == PARTICLE_OUTSIDE &&
+    this->SendParticleToAnotherProcess(info, step.Previous, this->OutputPointData))
+  {
+    this->ParticleHistories.erase(it);
+    particle_good = false;
+  }
+
+  // Has this particle stagnated, or become too old
+  //
+  if (particle_good && step.Status != PARTICLE_UNMOVED)
+  {
+    info.speed = vtkMath::Norm(step.Velocity);
+    if (info.speed <= this->TerminalSpeed || info.age > this->MaximumParticleAge)
+    {
+      this->ParticleHistories.erase(it);
+      particle_good = false;
     }
   }
 
@@ -1240,27 +1377,76 @@ void vtkParticleTracerBase::IntegrateParticle(ParticleListIterator& it, double c
   //
   if (particle_good)
   {
-    //
-    // store the last Cell Ids and dataset indices for next time particle is updated
-    //
-    this->Interpolator->GetCachedCellIds(info.CachedCellId, info.CachedDataSetId);
+    if (findCell)
+    {
+      // the cached cell contains the particle, so that this finds the cell
+      // and weights of the velocity field which advanced it
+      this->Interpolator->ClearCache();
+      this->Interpolator->SetCachedCellIds(step.CachedCellId, step.CachedDataSetId);
+      this->Interpolator->TestPoint(info.CurrentPosition.x);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+      info.CachedCellId[i] = step.CachedCellId[i];
+      info.CachedDataSetId[i] = step.CachedDataSetId[i];
+    }
     //
     info.TimeStepAge += 1;
     //
     // Now generate the output geometry and scalars
     //
-    this->AddParticle(info, velocity);
+    this->AddParticle(info, step.Velocity);
   }
   else
   {
     this->Interpolator->ClearCache();
   }
+}
 
-#ifdef DEBUGPARTICLETRACE
-  double eps = (this->GetCacheDataTime(1) - this->GetCacheDataTime(0)) / 100;
-  Assert(point1[3] >= (this->GetCacheDataTime(0) - eps) &&
-    point1[3] <= (this->GetCacheDataTime(1) + eps));
-#endif
+//------------------------------------------------------------------------------
+void vtkParticleTracerBase::IntegrateParticles(ParticleListIterator first,
+  ParticleListIterator last, double currenttime, double targettime)
+{
+  // The steps are kept until the particles are finished in order, so that
+  // the particles are advanced by blocks to bound their memory.
+  const std::size_t blockSize = 65536;
+  std::vector<ParticleListIterator> particles;
+  std::vector<ParticleStep> steps;
+  ParticleAdvectionFunctor functor(this, particles, steps, currenttime, targettime);
+
+  for (ParticleListIterator it = first; it != last && !this->GetAbortExecute();)
+  {
+    particles.clear();
+    for (; it != last && particles.size() < blockSize; ++it)
+    {
+      particles.push_back(it);
+    }
+    steps.resize(particles.size());
+    vtkSMPTools::For(0, static_cast<vtkIdType>(particles.size()), functor);
+
+    // the particles finished may be removed from the list, which keeps the
+    // iterators of the next block valid
+    for (std::size_t i = 0; i < particles.size(); ++i)
+    {
+      this->FinishParticle(particles[i], steps[i], true);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkParticleTracerBase::SetCellLocatorCache(vtkCellLocatorCache* cache)
+{
+  if (this->CellLocatorCache != cache)
+  {
+    this->CellLocatorCache = cache;
+    this->Modified();
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkCellLocatorCache* vtkParticleTracerBase::GetCellLocatorCache()
+{
+  return this->CellLocatorCache;
 }
 
 //------------------------------------------------------------------------------
@@ -1277,6 +1463,9 @@ void vtkParticleTracerBase::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "StaticMesh: " << this->StaticMesh << endl;
   os << indent << "TerminationTime: " << this->TerminationTime << endl;
   os << indent << "StaticSeeds: " << this->StaticSeeds << endl;
+  os << indent << "MaximumParticleAge: " << this->MaximumParticleAge << endl;
+  os << indent << "ParallelAdvection: " << this->ParallelAdvection << endl;
+  os << indent << "CellLocatorCache: " << this->CellLocatorCache << endl;
 }
 
 //------------------------------------------------------------------------------
@@ -1472,13 +1661,13 @@ void vtkParticleTracerBase::CreateProtoPD(vtkDataObject* input)
 }
 
 //------------------------------------------------------------------------------
-bool vtkParticleTracerBase::RetryWithPush(
-  ParticleInformation& info, double* point1, double delT, int substeps)
+bool vtkParticleTracerBase::RetryWithPush(ParticleInformation& info, double* point1,
+  double delT, int substeps, vtkTemporalInterpolatedVelocityField* interpolator)
 {
   double velocity[3];
-  this->Interpolator->ClearCache();
+  interpolator->ClearCache();
 
-  info.LocationState = this->Interpolator->TestPoint(point1);
+  info.LocationState = interpolator->TestPoint(point1);
 
   if (info.LocationState == ID_OUTSIDE_ALL)
   {
@@ -1487,7 +1676,7 @@ bool vtkParticleTracerBase::RetryWithPush(
     // send the particle 'as is' and hope it lands in another process
     if (substeps > 0)
     {
-      this->Interpolator->GetLastGoodVelocity(velocity);
+      interpolator->GetLastGoodVelocity(velocity);
     }
     else
     {
@@ -1498,19 +1687,19 @@ bool vtkParticleTracerBase::RetryWithPush(
   else if (info.LocationState == ID_OUTSIDE_T0)
   {
     // the particle left the volume but can be tested at T2, so use the velocity at T2
-    this->Interpolator->GetLastGoodVelocity(velocity);
+    interpolator->GetLastGoodVelocity(velocity);
     info.ErrorCode = 4;
   }
   else if (info.LocationState == ID_OUTSIDE_T1)
   {
     // the particle left the volume but can be tested at T1, so use the velocity at T1
-    this->Interpolator->GetLastGoodVelocity(velocity);
+    interpolator->GetLastGoodVelocity(velocity);
     info.ErrorCode = 5;
   }
   else
   {
     // The test returned INSIDE_ALL, so test failed near start of integration,
-    this->Interpolator->GetLastGoodVelocity(velocity);
+    interpolator->GetLastGoodVelocity(velocity);
   }
 
   // try adding a one increment push to the particle to get over a rotating/moving boundary
@@ -1520,7 +1709,7 @@ bool vtkParticleTracerBase::RetryWithPush(
   }
 
   info.CurrentPosition.x[3] += delT;
-  info.LocationState = this->Interpolator->TestPoint(info.CurrentPosition.x);
+  info.LocationState = interpolator->TestPoint(info.CurrentPosition.x);
   info.age += delT;
   info.SimulationTime += delT; // = this->GetCurrentTimeValue();
 
@@ -20,6 +20,13 @@
  * in a vector field. Note that the input vtkPointData structure must
  * be identical on all datasets.
  *
+ * When ParallelAdvection is on, the particles are advected over each time
+ * step with vtkSMPTools, by blocks of particles, each thread with its own
+ * copy of the velocity field and the integrator. The cells of the point sets
+ * are then found with vtkStaticCellLocator, taken from a vtkCellLocatorCache
+ * so that the locators of a static mesh are built once. The output is
+ * generated in the order of the particles, as in the serial advection.
+ *
  * @sa
  * vtkRibbonFilter vtkRuledSurfaceFilter vtkInitialValueProblemSolver
  * vtkRungeKutta2 vtkRungeKutta4 vtkRungeKutta45 vtkStreamTracer
@@ -38,6 +45,7 @@
 class vtkAbstractInterpolatedVelocityField;
 class vtkAbstractParticleWriter;
 class vtkCellArray;
+class vtkCellLocatorCache;
 class vtkCompositeDataSet;
 class vtkDataArray;
 class vtkDataSet;
@@ -93,10 +101,33 @@ struct ParticleInformation_t
 };
 using ParticleInformation = struct ParticleInformation_t;
 
+// How a particle ended a time step, see vtkParticleTracerBase::AdvanceParticle()
+enum ParticleStepStatus
+{
+  PARTICLE_ADVANCED, // inside the domain at the end of the time step
+  PARTICLE_OUTSIDE,  // outside the domain at the end of the time step
+  PARTICLE_LOST,     // left the domain during the time step
+  PARTICLE_UNMOVED   // the time step is empty
+};
+
+// What is needed to update the particle list and the output once a particle
+// has been advanced over a time step.
+struct ParticleStep_t
+{
+  ParticleInformation Previous; // the particle before the time step
+  double Velocity[3];
+  vtkIdType CachedCellId[2];
+  int CachedDataSetId[2];
+  int Status;
+};
+using ParticleStep = struct ParticleStep_t;
+
 typedef std::vector<ParticleInformation> ParticleVector;
 typedef ParticleVector::iterator ParticleIterator;
 typedef std::list<ParticleInformation> ParticleDataList;
 typedef ParticleDataList::iterator ParticleListIterator;
+
+class ParticleAdvectionFunctor;
 };
 
 class VTKFILTERSFLOWPATHS_EXPORT vtkParticleTracerBase : public vtkPolyDataAlgorithm
@@ -133,6 +164,44 @@ public:
   void SetTerminalSpeed(double);
   ///@}
 
+  ///@{
+  /**
+   * Specify the maximum age of the particles, above which they are
+   * terminated. This bounds the number of particles, and thus the memory, of
+   * long running tracers reinjecting particles, such as the streaklines of
+   * vtkStreaklineFilter, whose length is then limited to this age. The
+   * default is VTK_DOUBLE_MAX, i.e. the particles are never terminated
+   * because of their age.
+   */
+  vtkGetMacro(MaximumParticleAge, double);
+  void SetMaximumParticleAge(double);
+  ///@}
+
+  ///@{
+  /**
+   * Turn on/off the parallel advection of the particles (see the class
+   * documentation). The cells found for the particles may differ from the
+   * serial advection at the faces of the cells, as another locator is used.
+   * Off by default.
+   */
+  vtkSetMacro(ParallelAdvection, vtkTypeBool);
+  vtkGetMacro(ParallelAdvection, vtkTypeBool);
+  vtkBooleanMacro(ParallelAdvection, vtkTypeBool);
+  ///@}
+
+  ///@{
+  /**
+   * Set / get a cache from which the cell locators of the point sets are
+   * taken. The locators of a static mesh are then built once for all the time
+   * steps, even when StaticMesh is off, and may be shared with other filters.
+   * When no cache is set, the serial advection builds a vtkCellLocator for
+   * each dataset and the parallel advection uses a cache of the filter.
+   * nullptr by default.
+   */
+  void SetCellLocatorCache(vtkCellLocatorCache* cache);
+  vtkCellLocatorCache* GetCellLocatorCache();
+  ///@}
+
   ///@{
   /**
    * This can be used to scale the rate with which the streamribbons
@@ -394,6 +463,18 @@ protected:
   void IntegrateParticle(vtkParticleTracerBaseNamespace::ParticleListIterator& it,
     double currenttime, double terminationtime, vtkInitialValueProblemSolver* integrator);
 
+  /**
+   * Advance a particle between the two times supplied with the given
+   * integrator and velocity field, without modifying the particle list or the
+   * output. The step records what is needed to update them, and its status is
+   * returned. Several particles can be advanced concurrently with their own
+   * integrators and velocity fields.
+   */
+  int AdvanceParticle(vtkParticleTracerBaseNamespace::ParticleInformation& info,
+    vtkParticleTracerBaseNamespace::ParticleStep& step, double currenttime,
+    double terminationtime, vtkInitialValueProblemSolver* integrator,
+    vtkTemporalInterpolatedVelocityField* interpolator);
+
   // if the particle is added to send list, then returns value is 1,
   // if it is kept on this process after a retry return value is 0
   virtual bool SendParticleToAnotherProcess(vtkParticleTracerBaseNamespace::ParticleInformation&,
@@ -486,7 +567,23 @@ private:
    * to the integrator that is used.
    */
   bool RetryWithPush(vtkParticleTracerBaseNamespace::ParticleInformation& info, double* point1,
-    double delT, int subSteps);
+    double delT, int subSteps, vtkTemporalInterpolatedVelocityField* interpolator);
+
+  /**
+   * Send, remove or output a particle advanced by AdvanceParticle(). When
+   * the particle has been advanced with another velocity field, its cell is
+   * found again from the cached cells to interpolate its point data.
+   */
+  void FinishParticle(vtkParticleTracerBaseNamespace::ParticleListIterator& it,
+    vtkParticleTracerBaseNamespace::ParticleStep& step, bool findCell);
+
+  /**
+   * Advance the particles of the list from first to last in parallel, by
+   * blocks, and finish them in order after each block.
+   */
+  void IntegrateParticles(vtkParticleTracerBaseNamespace::ParticleListIterator first,
+    vtkParticleTracerBaseNamespace::ParticleListIterator last, double currenttime,
+    double terminationtime);
 
   bool SetTerminationTimeNoModify(double t);
 
@@ -497,6 +594,8 @@ private:
   bool ComputeVorticity;
   double RotationScale;
   double TerminalSpeed;
+  double MaximumParticleAge;
+  vtkTypeBool ParallelAdvection;
 
   // A counter to keep track of how many times we reinjected
   int ReinjectionCounter;
@@ -534,6 +633,11 @@ private:
   vtkSmartPointer<vtkTemporalInterpolatedVelocityField> Interpolator;
   vtkAbstractInterpolatedVelocityField* InterpolatorPrototype;
 
+  // The cache of the locators given by the user, and the one of the filter
+  // used by the parallel advection otherwise
+  vtkSmartPointer<vtkCellLocatorCache> CellLocatorCache;
+  vtkSmartPointer<vtkCellLocatorCache> AdvectionLocatorCache;
+
   // Data for time step CurrentTimeStep-1 and CurrentTimeStep
   vtkSmartPointer<vtkMultiBlockDataSet> CachedData[2];
 
@@ -570,6 +674,7 @@ private:
 
   friend class ParticlePathFilterInternal;
   friend class StreaklineFilterInternal;
+  friend class vtkParticleTracerBaseNamespace::ParticleAdvectionFunctor;
 
   static const double Epsilon;
 };
@@ -16,12 +16,14 @@
 
 #include "vtkAbstractCellLocator.h"
 #include "vtkCachingInterpolatedVelocityField.h"
+#include "vtkCellLocatorCache.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
 
 #include <vector>
 //------------------------------------------------------------------------------
@@ -63,9 +65,13 @@ void vtkTemporalInterpolatedVelocityField::SetDataSetAtTime(
   {
     this->ScaleCoeff = 1.0 / (this->Times[1] - this->Times[0]);
   }
+  // the locators of the point sets come from the cache, if any, and must
+  // then not be modified
+  const bool useCache = this->CellLocatorCache && vtkPointSet::SafeDownCast(dataset);
   if (N == 0)
   {
-    this->IVF[N]->SetDataSet(I, dataset, staticdataset, nullptr);
+    this->IVF[N]->SetDataSet(I, dataset, staticdataset,
+      useCache ? this->CellLocatorCache->GetCellLocator(dataset) : nullptr);
   }
   // when the datasets for the second time set are added, set the static flag
   if (N == 1)
@@ -81,11 +87,38 @@ void vtkTemporalInterpolatedVelocityField::SetDataSetAtTime(
     }
     else
     {
-      this->IVF[N]->SetDataSet(I, dataset, staticdataset, nullptr);
+      this->IVF[N]->SetDataSet(I, dataset, staticdataset,
+        useCache ? this->CellLocatorCache->GetCellLocator(dataset) : nullptr);
     }
   }
 }
 //------------------------------------------------------------------------------
+void vtkTemporalInterpolatedVelocityField::SetCellLocatorCache(vtkCellLocatorCache* cache)
+{
+  if (this->CellLocatorCache != cache)
+  {
+    this->CellLocatorCache = cache;
+    this->Modified();
+  }
+}
+//------------------------------------------------------------------------------
+vtkCellLocatorCache* vtkTemporalInterpolatedVelocityField::GetCellLocatorCache()
+{
+  return this->CellLocatorCache;
+}
+//------------------------------------------------------------------------------
+void vtkTemporalInterpolatedVelocityField::CopyParameters(
+  vtkTemporalInterpolatedVelocityField* from)
+{
+  this->Times[0] = from->Times[0];
+  this->Times[1] = from->Times[1];
+  this->ScaleCoeff = from->ScaleCoeff;
+  this->StaticDataSets = from->StaticDataSets;
+  this->CellLocatorCache = from->CellLocatorCache;
+  this->IVF[0]->CopyParameters(from->IVF[0]);
+  this->IVF[1]->CopyParameters(from->IVF[1]);
+}
+//------------------------------------------------------------------------------
 bool vtkTemporalInterpolatedVelocityField::IsStatic(int datasetIndex)
 {
   return this->StaticDataSets[datasetIndex];
@@ -31,7 +31,10 @@
  *
  * @warning
  * vtkTemporalInterpolatedVelocityField is probably not thread safe.
- * A new instance should be created by each thread.
+ * A new instance should be created by each thread, and given the datasets
+ * of a shared instance with CopyParameters(). The datasets must then be
+ * searched with locators supporting concurrent queries, such as the
+ * vtkStaticCellLocator built by a vtkCellLocatorCache.
  *
  * @warning
  * Datasets are added in lists. The list for T1 must be identical to that for T0
@@ -59,6 +62,7 @@
 #define ID_OUTSIDE_T0 02
 #define ID_OUTSIDE_T1 03
 
+class vtkCellLocatorCache;
 class vtkDataSet;
 class vtkDataArray;
 class vtkPointData;
@@ -102,6 +106,24 @@ public:
    */
   void SetDataSetAtTime(int I, int N, double T, vtkDataSet* dataset, bool staticdataset);
 
+  ///@{
+  /**
+   * Set / get a cache from which the cell locators of the point sets added
+   * with SetDataSetAtTime() are taken, instead of building a vtkCellLocator
+   * for each of them. The locators of a static mesh are then reused over all
+   * the time steps, and can be queried concurrently. nullptr by default.
+   */
+  void SetCellLocatorCache(vtkCellLocatorCache* cache);
+  vtkCellLocatorCache* GetCellLocatorCache();
+  ///@}
+
+  /**
+   * Copy the datasets of another field at both times, with their locators,
+   * so that this field evaluates the same velocities with its own cells and
+   * weights. See vtkCachingInterpolatedVelocityField::CopyParameters().
+   */
+  void CopyParameters(vtkTemporalInterpolatedVelocityField* from);
+
   ///@{
   /**
    * Between iterations of the Particle Tracer, Id's of the Cell
@@ -177,6 +199,7 @@ protected:
   vtkSmartPointer<vtkCachingInterpolatedVelocityField> IVF[2];
   // we want to keep track of static datasets so we can optimize caching
   std::vector<bool> StaticDataSets;
+  vtkSmartPointer<vtkCellLocatorCache> CellLocatorCache;
 
 private:
   // Hide this since we need multiple time steps and are using a different
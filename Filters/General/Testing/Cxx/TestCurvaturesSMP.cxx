@@ -0,0 +1,95 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCurvaturesSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the curvatures computed by vtkCurvatures do not depend on the
+// number of threads, and that the Gauss and mean curvatures are right on a
+// sphere.
+
+#include "vtkCurvatures.h"
+#include "vtkDataArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStripper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+vtkSmartPointer<vtkDataArray> ComputeCurvature(vtkAlgorithm* source, int type)
+{
+  vtkNew<vtkCurvatures> curvatures;
+  curvatures->SetInputConnection(source->GetOutputPort());
+  curvatures->SetCurvatureType(type);
+  curvatures->Update();
+
+  vtkSmartPointer<vtkDataArray> scalars = curvatures->GetOutput()->GetPointData()->GetScalars();
+  return scalars;
+}
+
+} // anonymous namespace
+
+int TestCurvaturesSMP(int, char*[])
+{
+  // Curvatures of a sphere of radius 2: K = 1/4 and H = 1/2. The principal
+  // curvatures, sqrt(H^2 - K) away from H, are too sensitive to check.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(2.0);
+  sphere->SetThetaResolution(100);
+  sphere->SetPhiResolution(100);
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(sphere->GetOutputPort());
+  const double expected[] = { 0.25, 0.5 };
+  vtkAlgorithm* sources[] = { sphere, stripper };
+
+  for (vtkAlgorithm* source : sources)
+  {
+    for (int type = VTK_CURVATURE_GAUSS; type <= VTK_CURVATURE_MINIMUM; ++type)
+    {
+      auto curvatures =
+        vtkTest::RunSequentialAndThreaded([&]() { return ComputeCurvature(source, type); });
+      vtkSmartPointer<vtkDataArray> threaded = curvatures.second;
+      if (!vtkTest::SameArrays(curvatures.first, threaded))
+      {
+        std::cerr << threaded->GetName() << " depends on the number of threads." << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      if (type <= VTK_CURVATURE_MEAN)
+      {
+        // Check away from the poles, where the facets are the most distorted.
+        double error = 0.0;
+        for (vtkIdType i = 2; i < threaded->GetNumberOfTuples(); ++i)
+        {
+          error = std::max(error, std::abs(threaded->GetComponent(i, 0) - expected[type]));
+        }
+        std::cout << threaded->GetName() << ": error " << error << std::endl;
+        if (error > 0.1 * expected[type])
+        {
+          std::cerr << threaded->GetName() << " is wrong on a sphere." << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,276 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLocatorBatchQueries.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the batched queries of the cell and point locators return the
+// same results as the queries of single points, and that vtkProbeFilter
+// gives the same output when it finds its cells in batch.
+
+#include "vtkAbstractCellLocator.h"
+#include "vtkAbstractPointLocator.h"
+#include "vtkCellLocator.h"
+#include "vtkCellTreeLocator.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkKdTreePointLocator.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointLocator.h"
+#include "vtkPoints.h"
+#include "vtkProbeFilter.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+void RandomPoints(vtkMinimalStandardRandomSequence* random, const double bounds[6],
+  vtkIdType numPts, vtkPoints* points)
+{
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      // slightly larger than the bounds so that some points are outside
+      x[j] = random->GetNextRangeValue(bounds[2 * j] - 1., bounds[2 * j + 1] + 1.);
+    }
+    points->SetPoint(i, x);
+  }
+}
+
+bool CheckCellLocator(
+  const std::string& name, vtkAbstractCellLocator* locator, vtkPoints* p1, vtkPoints* p2)
+{
+  bool success = true;
+  vtkIdType numPts = p1->GetNumberOfPoints();
+  vtkNew<vtkGenericCell> cell;
+  std::vector<double> weights(8);
+  double pcoords[3];
+
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkDoubleArray> batchPcoords;
+  locator->FindCells(p1, 0., cellIds, batchPcoords);
+  vtkIdType found = 0;
+  for (vtkIdType i = 0; i < numPts && success; ++i)
+  {
+    vtkIdType cellId = locator->FindCell(p1->GetPoint(i), 0., cell, pcoords, weights.data());
+    found += (cellId >= 0 ? 1 : 0);
+    if (cellId != cellIds->GetId(i) ||
+      (cellId >= 0 && vtkMath::Distance2BetweenPoints(pcoords, batchPcoords->GetTuple3(i)) > 0.))
+    {
+      std::cerr << name << "::FindCells() differs from FindCell() for point " << i << std::endl;
+      success = false;
+    }
+  }
+  if (found == 0 || found == numPts)
+  {
+    std::cerr << name << " found a cell for " << found << " points out of " << numPts
+              << std::endl;
+    success = false;
+  }
+
+  vtkNew<vtkDoubleArray> t;
+  vtkNew<vtkPoints> x;
+  x->SetDataTypeToDouble();
+  locator->IntersectWithLines(p1, p2, 0.001, cellIds, t, x);
+  for (vtkIdType i = 0; i < numPts && success; ++i)
+  {
+    double tHit, xHit[3];
+    int subId;
+    vtkIdType cellId = -1;
+    int hit = locator->IntersectWithLine(
+      p1->GetPoint(i), p2->GetPoint(i), 0.001, tHit, xHit, pcoords, subId, cellId, cell);
+    if ((hit ? cellId : -1) != cellIds->GetId(i) ||
+      (hit &&
+        (tHit != t->GetValue(i) ||
+          vtkMath::Distance2BetweenPoints(xHit, x->GetPoint(i)) > 0.)))
+    {
+      std::cerr << name << "::IntersectWithLines() differs from IntersectWithLine() for line "
+                << i << std::endl;
+      success = false;
+    }
+  }
+
+  return success;
+}
+
+bool CheckPointLocator(const std::string& name, vtkAbstractPointLocator* locator, vtkPoints* points)
+{
+  bool success = true;
+  vtkIdType numPts = points->GetNumberOfPoints();
+  locator->BuildLocator();
+
+  vtkNew<vtkIdList> ptIds;
+  locator->FindClosestPoints(points, ptIds);
+  for (vtkIdType i = 0; i < numPts && success; ++i)
+  {
+    if (locator->FindClosestPoint(points->GetPoint(i)) != ptIds->GetId(i))
+    {
+      std::cerr << name << "::FindClosestPoints() differs from FindClosestPoint() for point " << i
+                << std::endl;
+      success = false;
+    }
+  }
+
+  const int N = 5;
+  vtkNew<vtkIdList> result;
+  locator->FindClosestPoints(N, points, ptIds);
+  for (vtkIdType i = 0; i < numPts && success; ++i)
+  {
+    locator->FindClosestNPoints(N, points->GetPoint(i), result);
+    for (int j = 0; j < N; ++j)
+    {
+      if (result->GetId(j) != ptIds->GetId(i * N + j))
+      {
+        std::cerr << name << "::FindClosestPoints(N) differs from FindClosestNPoints() for point "
+                  << i << std::endl;
+        success = false;
+        break;
+      }
+    }
+  }
+
+  return success;
+}
+
+} // anonymous namespace
+
+int TestLocatorBatchQueries(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(-8, 8, -8, 8, -8, 8);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputConnection(wavelet->GetOutputPort());
+  tetrahedralize->Update();
+  vtkUnstructuredGrid* grid = tetrahedralize->GetOutput();
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> p1;
+  RandomPoints(random, grid->GetBounds(), 2000, p1);
+  vtkNew<vtkPoints> p2;
+  RandomPoints(random, grid->GetBounds(), 2000, p2);
+
+  const vtkSMPTools::Config threadedConfig{ 4 };
+  bool success = true;
+  vtkSMPTools::LocalScope(threadedConfig, [&]() {
+    vtkNew<vtkStaticCellLocator> staticCellLocator;
+    staticCellLocator->SetDataSet(grid);
+    success &= CheckCellLocator("vtkStaticCellLocator", staticCellLocator, p1, p2);
+
+    vtkNew<vtkCellTreeLocator> cellTreeLocator;
+    cellTreeLocator->SetDataSet(grid);
+    cellTreeLocator->BuildLocator();
+    success &= CheckCellLocator("vtkCellTreeLocator", cellTreeLocator, p1, p2);
+
+    vtkNew<vtkIdList> cellIds;
+    vtkNew<vtkPoints> closestPoints;
+    closestPoints->SetDataTypeToDouble();
+    vtkNew<vtkDoubleArray> dist2;
+    staticCellLocator->FindClosestPoints(p1, cellIds, closestPoints, dist2);
+    vtkNew<vtkGenericCell> cell;
+    for (vtkIdType i = 0; i < p1->GetNumberOfPoints(); ++i)
+    {
+      double closest[3], d2;
+      vtkIdType cellId;
+      int subId;
+      staticCellLocator->FindClosestPoint(p1->GetPoint(i), closest, cell, cellId, subId, d2);
+      if (cellId != cellIds->GetId(i) || d2 != dist2->GetValue(i) ||
+        vtkMath::Distance2BetweenPoints(closest, closestPoints->GetPoint(i)) > 0.)
+      {
+        std::cerr << "vtkStaticCellLocator::FindClosestPoints() differs from FindClosestPoint()"
+                  << " for point " << i << std::endl;
+        success = false;
+        break;
+      }
+    }
+
+    vtkNew<vtkStaticPointLocator> staticPointLocator;
+    staticPointLocator->SetDataSet(grid);
+    success &= CheckPointLocator("vtkStaticPointLocator", staticPointLocator, p1);
+    vtkNew<vtkPointLocator> pointLocator;
+    pointLocator->SetDataSet(grid);
+    success &= CheckPointLocator("vtkPointLocator", pointLocator, p1);
+    vtkNew<vtkKdTreePointLocator> kdTreePointLocator;
+    kdTreePointLocator->SetDataSet(grid);
+    success &= CheckPointLocator("vtkKdTreePointLocator", kdTreePointLocator, p1);
+
+    // vtkCellLocator does not support concurrent queries, so the probe
+    // filter finds the cells one at a time. The locators may find different
+    // cells for the points near the faces of the cells, within the tolerance,
+    // so the points near the boundary of the grid are not probed and the
+    // interpolated values are compared with a tolerance.
+    vtkNew<vtkPoints> probePoints;
+    const double* bounds = grid->GetBounds();
+    for (vtkIdType i = 0; i < p1->GetNumberOfPoints(); ++i)
+    {
+      const double* x = p1->GetPoint(i);
+      bool nearBoundary = false;
+      for (int j = 0; j < 6; ++j)
+      {
+        nearBoundary |= std::abs(x[j / 2] - bounds[j]) < 0.01;
+      }
+      if (!nearBoundary)
+      {
+        probePoints->InsertNextPoint(x);
+      }
+    }
+    vtkNew<vtkUnstructuredGrid> probes;
+    probes->SetPoints(probePoints);
+    vtkNew<vtkProbeFilter> probe;
+    probe->SetInputData(probes);
+    probe->SetSourceData(grid);
+    vtkNew<vtkCellLocator> cellLocator;
+    probe->SetCellLocatorPrototype(cellLocator);
+    probe->Update();
+    vtkNew<vtkUnstructuredGrid> expected;
+    expected->DeepCopy(probe->GetOutput());
+
+    probe->SetCellLocatorPrototype(staticCellLocator);
+    probe->Update();
+    vtkDataArray* expectedMask = expected->GetPointData()->GetArray("vtkValidPointMask");
+    vtkDataArray* expectedScalars = expected->GetPointData()->GetScalars();
+    vtkDataArray* mask = probe->GetOutput()->GetPointData()->GetArray("vtkValidPointMask");
+    vtkDataArray* scalars = probe->GetOutput()->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < probePoints->GetNumberOfPoints(); ++i)
+    {
+      if (mask->GetComponent(i, 0) != expectedMask->GetComponent(i, 0) ||
+        std::abs(scalars->GetComponent(i, 0) - expectedScalars->GetComponent(i, 0)) > 1e-2)
+      {
+        std::cerr << "vtkProbeFilter output differs when finding cells in batch for point " << i
+                  << std::endl;
+        success = false;
+        break;
+      }
+    }
+  });
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
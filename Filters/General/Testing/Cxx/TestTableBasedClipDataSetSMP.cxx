@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSetSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkTableBasedClipDataSet clips unstructured grids the same way
+// whatever the number of threads used by vtkSMPTools, with input scalars and
+// with an implicit function, that the output lies on the right side of the
+// clip value and that it keeps exactly the cells on that side or crossing it.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTableBasedClipDataSet.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+vtkSmartPointer<vtkUnstructuredGrid> Clip(
+  vtkUnstructuredGrid* input, vtkPlane* plane, bool insideOut)
+{
+  vtkNew<vtkTableBasedClipDataSet> clipper;
+  clipper->SetInputData(input);
+  clipper->SetValue(plane ? 0.0 : 150.0);
+  clipper->SetClipFunction(plane);
+  clipper->SetInsideOut(insideOut);
+  clipper->SetGenerateClipScalars(plane != nullptr);
+  // vtkPlane is thread safe
+  clipper->SetParallelFunctionEvaluation(vtkSMPTools::GetEstimatedNumberOfThreads() > 1);
+  clipper->Update();
+
+  vtkSmartPointer<vtkUnstructuredGrid> output = clipper->GetOutput();
+  return output;
+}
+
+// Arrays missing from both outputs are the same.
+bool SameOptionalArrays(vtkDataArray* array1, vtkDataArray* array2)
+{
+  return (!array1 && !array2) || vtkTest::SameArrays(array1, array2);
+}
+
+// The active point scalars are RTData, or ClipDataSetScalars which replace it
+// when a clip function is set.
+bool SameOutputs(vtkUnstructuredGrid* output1, vtkUnstructuredGrid* output2)
+{
+  return vtkTest::SameArrays(output1->GetPoints()->GetData(), output2->GetPoints()->GetData()) &&
+    vtkTest::SameArrays(
+      output1->GetCells()->GetOffsetsArray(), output2->GetCells()->GetOffsetsArray()) &&
+    vtkTest::SameArrays(output1->GetCells()->GetConnectivityArray(),
+      output2->GetCells()->GetConnectivityArray()) &&
+    vtkTest::SameArrays(output1->GetCellTypesArray(), output2->GetCellTypesArray()) &&
+    vtkTest::SameArrays(
+      output1->GetPointData()->GetScalars(), output2->GetPointData()->GetScalars()) &&
+    SameOptionalArrays(output1->GetPointData()->GetArray("RTData"),
+      output2->GetPointData()->GetArray("RTData")) &&
+    SameOptionalArrays(output1->GetCellData()->GetArray("CellIds"),
+      output2->GetCellData()->GetArray("CellIds"));
+}
+
+// Check that the cells of the input entirely on the kept side of the clip
+// value are in the output, and that all output cells come from input cells
+// reaching that side.
+bool CheckClippedCells(
+  vtkUnstructuredGrid* input, vtkPlane* plane, bool insideOut, vtkUnstructuredGrid* output)
+{
+  const double value = plane ? 0.0 : 150.0;
+  vtkDataArray* rtData = input->GetPointData()->GetArray("RTData");
+  std::vector<double> sides(input->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    const double s =
+      plane ? plane->EvaluateFunction(input->GetPoint(ptId)) : rtData->GetComponent(ptId, 0);
+    sides[ptId] = insideOut ? value - s : s - value;
+  }
+
+  std::vector<bool> inOutput(input->GetNumberOfCells(), false);
+  vtkDataArray* outCellIds = output->GetCellData()->GetArray("CellIds");
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    inOutput[static_cast<vtkIdType>(outCellIds->GetComponent(cellId, 0))] = true;
+  }
+
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    input->GetCellPoints(cellId, cellPts);
+    bool allKept = true;
+    bool anyKept = false;
+    for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+    {
+      const double side = sides[cellPts->GetId(i)];
+      allKept = allKept && side > 1e-3;
+      anyKept = anyKept || side > -1e-3;
+    }
+    if ((allKept && !inOutput[cellId]) || (!anyKept && inOutput[cellId]))
+    {
+      std::cerr << "Cell " << cellId << (allKept ? " is missing from" : " should not be in")
+                << " the output." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestTableBasedClipDataSetSMP(int, char*[])
+{
+  // Hexahedra and tetrahedra, in more than one block of cells.
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-12, 12, -12, 12, -6, 6);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputConnection(source->GetOutputPort());
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputConnection(source->GetOutputPort());
+  append->AddInputConnection(tetrahedralize->GetOutputPort());
+  append->Update();
+
+  vtkNew<vtkUnstructuredGrid> input;
+  input->ShallowCopy(append->GetOutput());
+  input->GetPointData()->SetActiveScalars("RTData");
+  vtkNew<vtkFloatArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(input->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->SetValue(cellId, static_cast<float>(cellId));
+  }
+  input->GetCellData()->AddArray(cellIds);
+
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.5, 0.25, 0.0);
+  plane->SetNormal(1.0, 2.0, 0.5);
+
+  for (vtkPlane* clipFunction : { static_cast<vtkPlane*>(nullptr), plane.Get() })
+  {
+    for (bool insideOut : { false, true })
+    {
+      auto outputs =
+        vtkTest::RunSequentialAndThreaded([&]() { return Clip(input, clipFunction, insideOut); });
+      vtkSmartPointer<vtkUnstructuredGrid> threaded = outputs.second;
+      if (threaded->GetNumberOfCells() == 0 || !SameOutputs(outputs.first, threaded))
+      {
+        std::cerr << "Threaded output differs from sequential output (clip function "
+                  << (clipFunction ? "on" : "off") << ", inside out " << insideOut << ")."
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      if (!CheckClippedCells(input, clipFunction, insideOut, threaded))
+      {
+        std::cerr << "Wrong cells clipped (clip function " << (clipFunction ? "on" : "off")
+                  << ", inside out " << insideOut << ")." << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // Output points lie on the kept side of the clip value.
+      vtkDataArray* scalars = clipFunction
+        ? threaded->GetPointData()->GetArray("ClipDataSetScalars")
+        : threaded->GetPointData()->GetArray("RTData");
+      const double value = clipFunction ? 0.0 : 150.0;
+      for (vtkIdType ptId = 0; ptId < threaded->GetNumberOfPoints(); ++ptId)
+      {
+        const double s = scalars->GetComponent(ptId, 0) - value;
+        if ((insideOut && s > 1e-3) || (!insideOut && s < -1e-3))
+        {
+          std::cerr << "Point " << ptId << " is on the wrong side of the clip value (clip "
+                    << "function " << (clipFunction ? "on" : "off") << ", inside out "
+                    << insideOut << ")." << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
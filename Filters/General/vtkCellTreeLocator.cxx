@@ -21,6 +21,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include <algorithm>
 #include <cassert>
@@ -270,7 +271,7 @@ private:
 
   // -------------------------------------------------------------------------
 
-  void FindMinMax(const PerCell* begin, const PerCell* end, float* min, float* max)
+  static void FindMinMax(const PerCell* begin, const PerCell* end, float* min, float* max)
   {
     if (begin == end)
     {
@@ -297,14 +298,29 @@ private:
 
   // -------------------------------------------------------------------------
 
-  void Split(unsigned int index, float min[3], float max[3])
+  using NodeVector = std::vector<vtkCellTreeLocator::vtkCellTreeNode>;
+
+  // A subtree whose root is m_nodes[Index], built independently of the others.
+  struct SubTree
+  {
+    unsigned int Index;
+    float Min[3];
+    float Max[3];
+    NodeVector Nodes;
+  };
+
+  // Split the node in two children appended to nodes and return true, or
+  // return false if the node is a leaf. The cells of the node are partitioned
+  // in place, so nodes with disjoint cells can be split concurrently.
+  bool SplitNode(NodeVector& nodes, unsigned int index, const float min[3], const float max[3],
+    float lmin[3], float lmax[3], float rmin[3], float rmax[3])
   {
-    unsigned int start = this->m_nodes[index].Start();
-    unsigned int size = this->m_nodes[index].Size();
+    unsigned int start = nodes[index].Start();
+    unsigned int size = nodes[index].Size();
 
     if (size < this->m_leafsize)
     {
-      return;
+      return false;
     }
 
     PerCell* begin = &(this->m_pc[start]);
@@ -405,8 +421,6 @@ private:
       std::nth_element(begin, mid, end, CenterOrder(dim));
     }
 
-    float lmin[3], lmax[3], rmin[3], rmax[3];
-
     FindMinMax(begin, mid, lmin, lmax);
     FindMinMax(mid, end, rmin, rmax);
 
@@ -416,11 +430,83 @@ private:
     child[0].MakeLeaf(begin - &(this->m_pc[0]), mid - begin);
     child[1].MakeLeaf(mid - &(this->m_pc[0]), end - mid);
 
-    this->m_nodes[index].MakeNode((int)m_nodes.size(), dim, clip);
-    this->m_nodes.insert(m_nodes.end(), child, child + 2);
+    nodes[index].MakeNode((int)nodes.size(), dim, clip);
+    nodes.insert(nodes.end(), child, child + 2);
+    return true;
+  }
+
+  void Split(NodeVector& nodes, unsigned int index, const float min[3], const float max[3])
+  {
+    float lmin[3], lmax[3], rmin[3], rmax[3];
+    if (this->SplitNode(nodes, index, min, max, lmin, lmax, rmin, rmax))
+    {
+      Split(nodes, nodes[index].GetLeftChildIndex(), lmin, lmax);
+      Split(nodes, nodes[index].GetRightChildIndex(), rmin, rmax);
+    }
+  }
+
+  // Split the top of the tree sequentially until there are enough subtrees
+  // to keep the threads busy, then build the subtrees in parallel and append
+  // their nodes to m_nodes. Each node is split the same way whatever the
+  // order, and the nodes are reordered breadth first afterwards, so the tree
+  // does not depend on the number of threads.
+  void ParallelSplit(const float min[3], const float max[3])
+  {
+    const std::size_t minSubTrees = 4 * vtkSMPTools::GetEstimatedNumberOfThreads();
+    const unsigned int minSize = std::max(4096u, 4 * this->m_leafsize);
+
+    std::vector<SubTree> subTrees(1);
+    subTrees[0].Index = 0;
+    std::copy(min, min + 3, subTrees[0].Min);
+    std::copy(max, max + 3, subTrees[0].Max);
+    bool split = true;
+    while (split && subTrees.size() < minSubTrees)
+    {
+      split = false;
+      std::vector<SubTree> next;
+      for (const SubTree& subTree : subTrees)
+      {
+        SubTree left, right;
+        if (this->m_nodes[subTree.Index].Size() < minSize ||
+          !this->SplitNode(this->m_nodes, subTree.Index, subTree.Min, subTree.Max, left.Min,
+            left.Max, right.Min, right.Max))
+        {
+          next.push_back(subTree);
+          continue;
+        }
+        split = true;
+        left.Index = this->m_nodes[subTree.Index].GetLeftChildIndex();
+        right.Index = this->m_nodes[subTree.Index].GetRightChildIndex();
+        next.push_back(left);
+        next.push_back(right);
+      }
+      subTrees.swap(next);
+    }
+
+    vtkSMPTools::For(0, static_cast<vtkIdType>(subTrees.size()), 1,
+      [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          SubTree& subTree = subTrees[i];
+          subTree.Nodes.push_back(this->m_nodes[subTree.Index]);
+          this->Split(subTree.Nodes, 0, subTree.Min, subTree.Max);
+        }
+      });
 
-    Split(this->m_nodes[index].GetLeftChildIndex(), lmin, lmax);
-    Split(this->m_nodes[index].GetRightChildIndex(), rmin, rmax);
+    // The local node k > 0 of a subtree is the node base + k - 1 of the tree.
+    for (SubTree& subTree : subTrees)
+    {
+      const unsigned int base = static_cast<unsigned int>(this->m_nodes.size());
+      for (auto& node : subTree.Nodes)
+      {
+        if (node.IsNode())
+        {
+          node.SetChildren(base + node.GetLeftChildIndex() - 1);
+        }
+      }
+      this->m_nodes[subTree.Index] = subTree.Nodes[0];
+      this->m_nodes.insert(this->m_nodes.end(), subTree.Nodes.begin() + 1, subTree.Nodes.end());
+    }
   }
 
 public:
@@ -433,7 +519,6 @@ public:
   void Build(vtkCellTreeLocator* ctl, vtkCellTreeLocator::vtkCellTree& ct, vtkDataSet* ds)
   {
     const vtkIdType size = ds->GetNumberOfCells();
-    double cellBounds[6];
     this->m_pc.resize(size);
 
     float min[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
@@ -445,35 +530,39 @@ public:
       -std::numeric_limits<float>::max(),
     };
 
-    for (vtkIdType i = 0; i < size; ++i)
+    // The first call to GetCellBounds() may build cells or links which is not
+    // thread safe, so do it serially before computing the rest in parallel.
+    if (!ctl->CellBounds && size > 0)
     {
-      this->m_pc[i].Ind = i;
-
-      double* boundsPtr = cellBounds;
-      if (ctl->CellBounds)
-      {
-        boundsPtr = ctl->CellBounds[i];
-      }
-      else
-      {
-        ds->GetCellBounds(i, boundsPtr);
-      }
-
-      for (int d = 0; d < 3; ++d)
+      double cellBounds[6];
+      ds->GetCellBounds(0, cellBounds);
+    }
+    vtkSMPTools::For(0, size, [&](vtkIdType begin, vtkIdType end) {
+      double cellBounds[6];
+      for (vtkIdType i = begin; i < end; ++i)
       {
-        this->m_pc[i].Min[d] = boundsPtr[2 * d + 0];
-        this->m_pc[i].Max[d] = boundsPtr[2 * d + 1];
+        this->m_pc[i].Ind = i;
 
-        if (this->m_pc[i].Min[d] < min[d])
+        double* boundsPtr = cellBounds;
+        if (ctl->CellBounds)
         {
-          min[d] = this->m_pc[i].Min[d];
+          boundsPtr = ctl->CellBounds[i];
+        }
+        else
+        {
+          ds->GetCellBounds(i, boundsPtr);
         }
 
-        if (this->m_pc[i].Max[d] > max[d]) /// This can be m_pc[i].max[d] instead of min
+        for (int d = 0; d < 3; ++d)
         {
-          max[d] = this->m_pc[i].Max[d];
+          this->m_pc[i].Min[d] = boundsPtr[2 * d + 0];
+          this->m_pc[i].Max[d] = boundsPtr[2 * d + 1];
         }
       }
+    });
+    if (size > 0)
+    {
+      FindMinMax(&this->m_pc[0], &this->m_pc[0] + size, min, max);
     }
 
     ct.DataBBox[0] = min[0];
@@ -487,7 +576,7 @@ public:
     root.MakeLeaf(0, size);
     this->m_nodes.push_back(root);
 
-    Split(0, min, max);
+    this->ParallelSplit(min, max);
 
     ct.Nodes.resize(this->m_nodes.size());
     ct.Nodes[0] = this->m_nodes[0];
@@ -683,18 +772,13 @@ double _getMinDistNEG_Z(const double origin[3], const double dir[3], const doubl
 typedef std::pair<double, int> Intersection;
 
 int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3], double tol,
-  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell)
+  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId)
 {
-  int hit = this->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId);
-  if (hit)
-  {
-    this->DataSet->GetCell(cellId, cell);
-  }
-  return hit;
+  return this->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId, this->GenericCell);
 }
 
 int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3], double tol,
-  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellIds)
+  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellIds, vtkGenericCell* cell)
 {
   //
   vtkCellTreeNode *node, *near, *far;
@@ -821,7 +905,7 @@ int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3]
       ctmax = _tmax;
       if (this->RayMinMaxT(boundsPtr, p1, ray_vec, ctmin, ctmax))
       {
-        if (this->IntersectCellInternal(cell_ID, p1, p2, tol, t_hit, ipt, pcoords, subId))
+        if (this->IntersectCellInternal(cell_ID, p1, p2, tol, t_hit, ipt, pcoords, subId, cell))
         {
           if (t_hit < closest_intersection)
           {
@@ -840,6 +924,7 @@ int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3]
   if (HIT)
   {
     t = closest_intersection;
+    this->DataSet->GetCell(cellIds, cell);
   }
   //
   return HIT;
@@ -1218,10 +1303,11 @@ void vtkCellTreeLocator::Classify(const double origin[3], const double dir[3], d
 }
 //------------------------------------------------------------------------------
 int vtkCellTreeLocator::IntersectCellInternal(vtkIdType cell_ID, const double p1[3],
-  const double p2[3], const double tol, double& t, double ipt[3], double pcoords[3], int& subId)
+  const double p2[3], const double tol, double& t, double ipt[3], double pcoords[3], int& subId,
+  vtkGenericCell* cell)
 {
-  this->DataSet->GetCell(cell_ID, this->GenericCell);
-  return this->GenericCell->IntersectWithLine(
+  this->DataSet->GetCell(cell_ID, cell);
+  return cell->IntersectWithLine(
     const_cast<double*>(p1), const_cast<double*>(p2), tol, t, ipt, pcoords, subId);
 }
 //------------------------------------------------------------------------------
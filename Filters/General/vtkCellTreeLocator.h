@@ -122,6 +122,12 @@ public:
    */
   vtkIdType FindCell(double x[3]) override { return this->Superclass::FindCell(x); }
 
+  /**
+   * FindCell() and IntersectWithLine() are thread safe once the tree is
+   * built, see vtkAbstractCellLocator::FindCells().
+   */
+  bool SupportsConcurrentQueries() override { return true; }
+
   ///@{
   /**
    * Satisfy vtkLocator abstract interface.
@@ -214,8 +220,11 @@ protected:
   // it can be overridden by subclasses to perform special treatment
   // (Example : Particles stored in tree, have no dimension, so we must
   // override the cell test to return a value based on some particle size
+  // The cell is used to test the intersection, it is a thread local cell for
+  // concurrent queries.
   virtual int IntersectCellInternal(vtkIdType cell_ID, const double p1[3], const double p2[3],
-    const double tol, double& t, double ipt[3], double pcoords[3], int& subId);
+    const double tol, double& t, double ipt[3], double pcoords[3], int& subId,
+    vtkGenericCell* cell);
 
   int NumberOfBuckets;
 
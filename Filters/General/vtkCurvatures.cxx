@@ -15,6 +15,7 @@
 #include "vtkCurvatures.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkDoubleArray.h"
 #include "vtkFieldData.h"
@@ -28,14 +29,47 @@
 #include "vtkPolyData.h"
 #include "vtkPolyDataNormals.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleFilter.h"
 #include "vtkTriangleStrip.h"
 
+#include <algorithm>
 #include <memory> // For unique_ptr
+#include <vector>
 
 vtkStandardNewMacro(vtkCurvatures);
 
+namespace
+{
+// Return the neighbour of cell f across the edge (v_l,v_r) if there is
+// exactly one, -1 otherwise, counting the neighbours as
+// vtkPolyData::GetCellEdgeNeighbors() does.
+vtkIdType vtkCurvaturesGetEdgeNeighbor(
+  vtkStaticCellLinksTemplate<vtkIdType>& links, vtkIdType f, vtkIdType v_l, vtkIdType v_r)
+{
+  const vtkIdType* cells_l = links.GetCells(v_l);
+  const vtkIdType* cells_lEnd = cells_l + links.GetNcells(v_l);
+  const vtkIdType* cells_r = links.GetCells(v_r);
+  const vtkIdType* cells_rEnd = cells_r + links.GetNcells(v_r);
+
+  vtkIdType neighbour = -1;
+  int numNeighbours = 0;
+  for (; cells_l != cells_lEnd; ++cells_l)
+  {
+    if (*cells_l != f && std::binary_search(cells_r, cells_rEnd, *cells_l))
+    {
+      neighbour = *cells_l;
+      ++numNeighbours;
+    }
+  }
+  return (numNeighbours == 1 ? neighbour : -1);
+}
+} // anonymous namespace
+
 //-------------------------------------------------------//
 vtkCurvatures::vtkCurvatures()
 {
@@ -76,9 +110,6 @@ void vtkCurvatures::GetMeanCurvature(vtkPolyData* mesh)
   int numPts = polyData->GetNumberOfPoints();
 
   //     create-allocate
-  const vtkNew<vtkIdList> vertices;
-  const vtkNew<vtkIdList> vertices_n;
-  const vtkNew<vtkIdList> neighbours;
   const vtkNew<vtkDoubleArray> meanCurvature;
   meanCurvature->SetName("Mean_Curvature");
   meanCurvature->SetNumberOfComponents(1);
@@ -86,126 +117,174 @@ void vtkCurvatures::GetMeanCurvature(vtkPolyData* mesh)
   // Get the array so we can write to it directly
   double* meanCurvatureData = meanCurvature->GetPointer(0);
 
-  //     create-allocate
-  double n_f[3]; // normal of facet (could be stored for later?)
-  double n_n[3]; // normal of edge
-  double t[3];   // to store the cross product of n_f n_n
-  double ore[3]; // origin of e
-  double end[3]; // end of e
-  double oth[3]; //     third vertex necessary for comp of n
-  double vn0[3];
-  double vn1[3]; // vertices for computation of neighbour's n
-  double vn2[3];
-  double e[3]; // edge (oriented)
-
-  polyData->BuildLinks();
-  // data init
-  const int F = polyData->GetNumberOfCells();
-  // init, preallocate the mean curvature
-  const std::unique_ptr<int[]> num_neighb(new int[numPts]);
-  for (int v = 0; v < numPts; v++)
+  // The cells of the mesh in the order of their ids, and the cells using
+  // each point in increasing order, to find the neighbours of the edges.
+  const vtkIdType F = polyData->GetNumberOfCells();
+  std::vector<vtkIdType> offsets(1, 0);
+  std::vector<vtkIdType> connectivity;
+  offsets.reserve(F + 1);
+  for (vtkCellArray* cells :
+    { polyData->GetVerts(), polyData->GetLines(), polyData->GetPolys(), polyData->GetStrips() })
   {
-    meanCurvatureData[v] = 0.0;
-    num_neighb[v] = 0;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (cells->InitTraversal(); cells->GetNextCell(npts, pts);)
+    {
+      connectivity.insert(connectivity.end(), pts, pts + npts);
+      offsets.push_back(static_cast<vtkIdType>(connectivity.size()));
+    }
   }
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  links.BuildLinks(polyData);
+  // the points gather the contributions of their cells in the same order
+  // as a loop over the cells
+  links.SortLinks();
 
   //     main loop
-  vtkDebugMacro(<< "Main loop: loop over facets such that id > id of neighb");
-  vtkDebugMacro(<< "so that every edge comes only once");
-
-  for (vtkIdType f = 0; f < F; ++f)
-  {
-    polyData->GetCellPoints(f, vertices);
-    const vtkIdType nv = vertices->GetNumberOfIds();
-
-    for (vtkIdType v = 0; v < nv; v++)
+  vtkDebugMacro(<< "Main loop: compute H_e on each edge of the facets such that");
+  vtkDebugMacro(<< "id > id of neighb so that every edge comes only once");
+
+  // H_e of the edge v of facet f, stored at offsets[f] + v, if the edge
+  // contributes.
+  std::vector<double> edgeCurvature(connectivity.size());
+  std::vector<char> hasEdgeCurvature(connectivity.size(), 0);
+  vtkSMPTools::For(0, F, [&](vtkIdType f, vtkIdType endF) {
+    double n_f[3]; // normal of facet (could be stored for later?)
+    double n_n[3]; // normal of edge
+    double t[3];   // to store the cross product of n_f n_n
+    double ore[3]; // origin of e
+    double end[3]; // end of e
+    double oth[3]; //     third vertex necessary for comp of n
+    double vn0[3];
+    double vn1[3]; // vertices for computation of neighbour's n
+    double vn2[3];
+    double e[3]; // edge (oriented)
+
+    for (; f < endF; ++f)
     {
-      // get neighbour
-      const vtkIdType v_l = vertices->GetId(v);
-      const vtkIdType v_r = vertices->GetId((v + 1) % nv);
-      const vtkIdType v_o = vertices->GetId((v + 2) % nv);
-      polyData->GetCellEdgeNeighbors(f, v_l, v_r, neighbours);
-
-      vtkIdType n; // n short for neighbor
-
-      // compute only if there is really ONE neighbour
-      // AND meanCurvature has not been computed yet!
-      // (ensured by n > f)
-      if (neighbours->GetNumberOfIds() == 1 && (n = neighbours->GetId(0)) > f)
+      const vtkIdType* vertices = connectivity.data() + offsets[f];
+      const vtkIdType nv = offsets[f + 1] - offsets[f];
+
+      for (vtkIdType v = 0; v < nv; v++)
       {
-        double Hf; // temporary store
-
-        // find 3 corners of f: in order!
-        polyData->GetPoint(v_l, ore);
-        polyData->GetPoint(v_r, end);
-        polyData->GetPoint(v_o, oth);
-        // compute normal of f
-        vtkTriangle::ComputeNormal(ore, end, oth, n_f);
-        // compute common edge
-        e[0] = end[0];
-        e[1] = end[1];
-        e[2] = end[2];
-        e[0] -= ore[0];
-        e[1] -= ore[1];
-        e[2] -= ore[2];
-        const double length = vtkMath::Normalize(e);
-        double Af = vtkTriangle::TriangleArea(ore, end, oth);
-        // find 3 corners of n: in order!
-        polyData->GetCellPoints(n, vertices_n);
-        polyData->GetPoint(vertices_n->GetId(0), vn0);
-        polyData->GetPoint(vertices_n->GetId(1), vn1);
-        polyData->GetPoint(vertices_n->GetId(2), vn2);
-        Af += double(vtkTriangle::TriangleArea(vn0, vn1, vn2));
-        // compute normal of n
-        vtkTriangle::ComputeNormal(vn0, vn1, vn2, n_n);
-        // the cosine is n_f * n_n
-        const double cs = vtkMath::Dot(n_f, n_n);
-        // the sin is (n_f x n_n) * e
-        vtkMath::Cross(n_f, n_n, t);
-        const double sn = vtkMath::Dot(t, e);
-        // signed angle in [-pi,pi]
-        if (sn != 0.0 || cs != 0.0)
+        double& Hf = edgeCurvature[offsets[f] + v];
+
+        // get neighbour
+        const vtkIdType v_l = vertices[v];
+        const vtkIdType v_r = vertices[(v + 1) % nv];
+        const vtkIdType v_o = vertices[(v + 2) % nv];
+        const vtkIdType n = vtkCurvaturesGetEdgeNeighbor(links, f, v_l, v_r);
+
+        // compute only if there is really ONE neighbour
+        // AND meanCurvature has not been computed yet!
+        // (ensured by n > f)
+        if (n > f && offsets[n + 1] - offsets[n] >= 3)
         {
-          const double angle = atan2(sn, cs);
-          Hf = length * angle;
+          // find 3 corners of f: in order!
+          polyData->GetPoint(v_l, ore);
+          polyData->GetPoint(v_r, end);
+          polyData->GetPoint(v_o, oth);
+          // compute normal of f
+          vtkTriangle::ComputeNormal(ore, end, oth, n_f);
+          // compute common edge
+          e[0] = end[0];
+          e[1] = end[1];
+          e[2] = end[2];
+          e[0] -= ore[0];
+          e[1] -= ore[1];
+          e[2] -= ore[2];
+          const double length = vtkMath::Normalize(e);
+          double Af = vtkTriangle::TriangleArea(ore, end, oth);
+          // find 3 corners of n: in order!
+          const vtkIdType* vertices_n = connectivity.data() + offsets[n];
+          polyData->GetPoint(vertices_n[0], vn0);
+          polyData->GetPoint(vertices_n[1], vn1);
+          polyData->GetPoint(vertices_n[2], vn2);
+          Af += double(vtkTriangle::TriangleArea(vn0, vn1, vn2));
+          // compute normal of n
+          vtkTriangle::ComputeNormal(vn0, vn1, vn2, n_n);
+          // the cosine is n_f * n_n
+          const double cs = vtkMath::Dot(n_f, n_n);
+          // the sin is (n_f x n_n) * e
+          vtkMath::Cross(n_f, n_n, t);
+          const double sn = vtkMath::Dot(t, e);
+          // signed angle in [-pi,pi]
+          if (sn != 0.0 || cs != 0.0)
+          {
+            const double angle = atan2(sn, cs);
+            Hf = length * angle;
+          }
+          else
+          {
+            Hf = 0.0;
+          }
+          // weighted Hf, added to scalar at v_l and v_r below
+          if (Af != 0.0)
+          {
+            (Hf /= Af) *= 3.0;
+          }
+          hasEdgeCurvature[offsets[f] + v] = 1;
         }
-        else
+      }
+    }
+  });
+
+  // Gather at each point the H_e of its edges, in the order of the facets,
+  // and put curvature in vtkArray
+  vtkSMPTools::For(0, numPts, [&](vtkIdType p, vtkIdType endP) {
+    for (; p < endP; ++p)
+    {
+      double H = 0.0;
+      int num_neighb = 0;
+      const vtkIdType* cells = links.GetCells(p);
+      const vtkIdType ncells = links.GetNcells(p);
+      for (vtkIdType k = 0; k < ncells; ++k)
+      {
+        const vtkIdType f = cells[k];
+        if (k > 0 && cells[k - 1] == f)
         {
-          Hf = 0.0;
+          continue;
         }
-        // add weighted Hf to scalar at v_l and v_r
-        if (Af != 0.0)
+        const vtkIdType* vertices = connectivity.data() + offsets[f];
+        const vtkIdType nv = offsets[f + 1] - offsets[f];
+        for (vtkIdType v = 0; v < nv; v++)
         {
-          (Hf /= Af) *= 3.0;
+          if (!hasEdgeCurvature[offsets[f] + v])
+          {
+            continue;
+          }
+          const double Hf = edgeCurvature[offsets[f] + v];
+          if (vertices[v] == p)
+          {
+            H += Hf;
+            num_neighb += 1;
+          }
+          if (vertices[(v + 1) % nv] == p)
+          {
+            H += Hf;
+            num_neighb += 1;
+          }
         }
-        meanCurvatureData[v_l] += Hf;
-        meanCurvatureData[v_r] += Hf;
-        num_neighb[v_l] += 1;
-        num_neighb[v_r] += 1;
       }
-    }
-  }
 
-  // put curvature in vtkArray
-  for (int v = 0; v < numPts; v++)
-  {
-    if (num_neighb[v] > 0)
-    {
-      const double Hf = 0.5 * meanCurvatureData[v] / num_neighb[v];
-      if (this->InvertMeanCurvature)
+      if (num_neighb > 0)
       {
-        meanCurvatureData[v] = -Hf;
+        const double Hf = 0.5 * H / num_neighb;
+        if (this->InvertMeanCurvature)
+        {
+          meanCurvatureData[p] = -Hf;
+        }
+        else
+        {
+          meanCurvatureData[p] = Hf;
+        }
       }
       else
       {
-        meanCurvatureData[v] = Hf;
+        meanCurvatureData[p] = 0.0;
       }
     }
-    else
-    {
-      meanCurvatureData[v] = 0.0;
-    }
-  }
+  });
 
   mesh->GetPointData()->AddArray(meanCurvature);
   mesh->GetPointData()->SetActiveScalars("Mean_Curvature");
@@ -264,76 +343,114 @@ void vtkCurvatures::GetGaussCurvature(vtkPolyData* output)
 void vtkCurvatures::ComputeGaussCurvature(
   vtkCellArray* facets, vtkPolyData* output, double* gaussCurvatureData)
 {
-  double v0[3], v1[3], v2[3], e0[3], e1[3], e2[3];
-
-  double A, alpha0, alpha1, alpha2;
-
-  vtkIdType f;
-  const vtkIdType* vert = nullptr;
-
   // other data
   vtkIdType Nv = output->GetNumberOfPoints();
+  const vtkIdType numFacets = facets->GetNumberOfCells();
+
+  // The area of each facet and the angles at its first three vertices.
+  const std::unique_ptr<double[]> facetData(new double[4 * numFacets]);
+  vtkSMPThreadLocal<vtkSmartPointer<vtkCellArrayIterator>> iterators;
+  vtkSMPTools::For(0, numFacets, [&](vtkIdType f, vtkIdType endF) {
+    vtkSmartPointer<vtkCellArrayIterator>& iter = iterators.Local();
+    if (!iter)
+    {
+      iter.TakeReference(facets->NewIterator());
+    }
+    double v0[3], v1[3], v2[3], e0[3], e1[3], e2[3];
+    vtkIdType npts;
+    const vtkIdType* vert = nullptr;
 
-  const std::unique_ptr<double[]> K(new double[Nv]);
-  const std::unique_ptr<double[]> dA(new double[Nv]);
-  double pi2 = 2.0 * vtkMath::Pi();
-  for (int k = 0; k < Nv; k++)
-  {
-    K[k] = pi2;
-    dA[k] = 0.0;
-  }
+    for (; f < endF; ++f)
+    {
+      iter->GetCellAtId(f, npts, vert);
+      double* data = facetData.get() + 4 * f;
+      if (npts < 3)
+      {
+        data[0] = data[1] = data[2] = data[3] = 0.0;
+        continue;
+      }
 
-  facets->InitTraversal();
-  while (facets->GetNextCell(f, vert))
-  {
-    output->GetPoint(vert[0], v0);
-    output->GetPoint(vert[1], v1);
-    output->GetPoint(vert[2], v2);
-    // edges
-    e0[0] = v1[0];
-    e0[1] = v1[1];
-    e0[2] = v1[2];
-    e0[0] -= v0[0];
-    e0[1] -= v0[1];
-    e0[2] -= v0[2];
-
-    e1[0] = v2[0];
-    e1[1] = v2[1];
-    e1[2] = v2[2];
-    e1[0] -= v1[0];
-    e1[1] -= v1[1];
-    e1[2] -= v1[2];
-
-    e2[0] = v0[0];
-    e2[1] = v0[1];
-    e2[2] = v0[2];
-    e2[0] -= v2[0];
-    e2[1] -= v2[1];
-    e2[2] -= v2[2];
-
-    alpha0 = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e1, e2);
-    alpha1 = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e2, e0);
-    alpha2 = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e0, e1);
-
-    // surf. area
-    A = double(vtkTriangle::TriangleArea(v0, v1, v2));
-    // UPDATE
-    dA[vert[0]] += A;
-    dA[vert[1]] += A;
-    dA[vert[2]] += A;
-    K[vert[0]] -= alpha1;
-    K[vert[1]] -= alpha2;
-    K[vert[2]] -= alpha0;
-  }
+      output->GetPoint(vert[0], v0);
+      output->GetPoint(vert[1], v1);
+      output->GetPoint(vert[2], v2);
+      // edges
+      e0[0] = v1[0];
+      e0[1] = v1[1];
+      e0[2] = v1[2];
+      e0[0] -= v0[0];
+      e0[1] -= v0[1];
+      e0[2] -= v0[2];
+
+      e1[0] = v2[0];
+      e1[1] = v2[1];
+      e1[2] = v2[2];
+      e1[0] -= v1[0];
+      e1[1] -= v1[1];
+      e1[2] -= v1[2];
+
+      e2[0] = v0[0];
+      e2[1] = v0[1];
+      e2[2] = v0[2];
+      e2[0] -= v2[0];
+      e2[1] -= v2[1];
+      e2[2] -= v2[2];
+
+      // surf. area and the angles at vert[0], vert[1] and vert[2]
+      data[0] = double(vtkTriangle::TriangleArea(v0, v1, v2));
+      data[1] = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e2, e0);
+      data[2] = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e0, e1);
+      data[3] = vtkMath::Pi() - vtkMath::AngleBetweenVectors(e1, e2);
+    }
+  });
+
+  // Gather at each vertex the contributions of its facets, in the order of
+  // the facets, and put curvature in vtkArray
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  links.ThreadedBuildLinks(Nv, numFacets, facets);
+  links.SortLinks();
+
+  const double pi2 = 2.0 * vtkMath::Pi();
+  vtkSMPTools::For(0, Nv, [&](vtkIdType v, vtkIdType endV) {
+    vtkSmartPointer<vtkCellArrayIterator>& iter = iterators.Local();
+    if (!iter)
+    {
+      iter.TakeReference(facets->NewIterator());
+    }
+    vtkIdType npts;
+    const vtkIdType* vert = nullptr;
 
-  // put curvature in vtkArray
-  for (int v = 0; v < Nv; v++)
-  {
-    if (dA[v] > 0.0)
+    for (; v < endV; ++v)
     {
-      gaussCurvatureData[v] = 3.0 * K[v] / dA[v];
+      double K = pi2;
+      double dA = 0.0;
+      const vtkIdType* cells = links.GetCells(v);
+      const vtkIdType ncells = links.GetNcells(v);
+      for (vtkIdType k = 0; k < ncells; ++k)
+      {
+        const vtkIdType f = cells[k];
+        if (k > 0 && cells[k - 1] == f)
+        {
+          continue;
+        }
+        iter->GetCellAtId(f, npts, vert);
+        const double* data = facetData.get() + 4 * f;
+        for (vtkIdType i = 0; i < 3 && i < npts; ++i)
+        {
+          if (vert[i] == v)
+          {
+            // UPDATE
+            dA += data[0];
+            K -= data[1 + i];
+          }
+        }
+      }
+
+      if (dA > 0.0)
+      {
+        gaussCurvatureData[v] = 3.0 * K / dA;
+      }
     }
-  }
+  });
 }
 
 void vtkCurvatures::GetMaximumCurvature(vtkPolyData* input, vtkPolyData* output)
@@ -354,29 +471,7 @@ void vtkCurvatures::GetMaximumCurvature(vtkPolyData* input, vtkPolyData* output)
     static_cast<vtkDoubleArray*>(output->GetPointData()->GetArray("Gauss_Curvature"));
   vtkDoubleArray* mean =
     static_cast<vtkDoubleArray*>(output->GetPointData()->GetArray("Mean_Curvature"));
-  double k, h, k_max, tmp;
-
-  for (vtkIdType i = 0; i < numPts; i++)
-  {
-    k = gauss->GetComponent(i, 0);
-    h = mean->GetComponent(i, 0);
-    tmp = h * h - k;
-    if (tmp >= 0)
-    {
-      k_max = h + sqrt(tmp);
-    }
-    else
-    {
-      k_max = h;
-      if (tmp < -0.1)
-      {
-        vtkWarningMacro(
-          << "The Gaussian or mean curvature at point " << i
-          << " have a large computation error... The maximum curvature is likely off.");
-      }
-    }
-    maximumCurvature->SetComponent(i, 0, k_max);
-  }
+  this->ComputePrincipalCurvature(gauss, mean, maximumCurvature, 1.0);
 }
 
 void vtkCurvatures::GetMinimumCurvature(vtkPolyData* input, vtkPolyData* output)
@@ -397,28 +492,53 @@ void vtkCurvatures::GetMinimumCurvature(vtkPolyData* input, vtkPolyData* output)
     static_cast<vtkDoubleArray*>(output->GetPointData()->GetArray("Gauss_Curvature"));
   vtkDoubleArray* mean =
     static_cast<vtkDoubleArray*>(output->GetPointData()->GetArray("Mean_Curvature"));
-  double k, h, k_min, tmp;
+  this->ComputePrincipalCurvature(gauss, mean, minimumCurvature, -1.0);
+}
 
-  for (vtkIdType i = 0; i < numPts; i++)
+void vtkCurvatures::ComputePrincipalCurvature(
+  vtkDoubleArray* gauss, vtkDoubleArray* mean, vtkDoubleArray* principal, double sign)
+{
+  if (!gauss || !mean)
   {
-    k = gauss->GetComponent(i, 0);
-    h = mean->GetComponent(i, 0);
-    tmp = h * h - k;
-    if (tmp >= 0)
-    {
-      k_min = h - sqrt(tmp);
-    }
-    else
+    return;
+  }
+  const double* k = gauss->GetPointer(0);
+  const double* h = mean->GetPointer(0);
+  double* k_p = principal->GetPointer(0);
+
+  // Points with a large computation error, reported once the curvature is
+  // computed.
+  vtkSMPThreadLocal<std::vector<vtkIdType>> localOffPoints;
+  vtkSMPTools::For(0, principal->GetNumberOfTuples(), [&](vtkIdType i, vtkIdType end) {
+    for (; i < end; ++i)
     {
-      k_min = h;
-      if (tmp < -0.1)
+      const double tmp = h[i] * h[i] - k[i];
+      if (tmp >= 0)
       {
-        vtkWarningMacro(
-          << "The Gaussian or mean curvature at point " << i
-          << " have a large computation error... The minimum curvature is likely off.");
+        k_p[i] = h[i] + sign * sqrt(tmp);
+      }
+      else
+      {
+        k_p[i] = h[i];
+        if (tmp < -0.1)
+        {
+          localOffPoints.Local().push_back(i);
+        }
       }
     }
-    minimumCurvature->SetComponent(i, 0, k_min);
+  });
+
+  std::vector<vtkIdType> offPoints;
+  for (auto iter = localOffPoints.begin(); iter != localOffPoints.end(); ++iter)
+  {
+    offPoints.insert(offPoints.end(), iter->begin(), iter->end());
+  }
+  std::sort(offPoints.begin(), offPoints.end());
+  for (vtkIdType i : offPoints)
+  {
+    vtkWarningMacro(<< "The Gaussian or mean curvature at point " << i
+                    << " have a large computation error... The "
+                    << (sign > 0.0 ? "maximum" : "minimum") << " curvature is likely off.");
   }
 }
 
@@ -53,6 +53,10 @@
  *  can be set and the Curvature reported by the Mean calculation will
  * be inverted.
  *
+ * The curvatures are computed in parallel with vtkSMPTools. Each point
+ * gathers the contributions of its facets and edges in the order of the
+ * cells, so the result does not depend on the number of threads.
+ *
  * For a little more information see
  * <a href="https://public.kitware.com/pipermail/vtkusers/2002-July/012198.html"
  * >Computing curvature of a surface</a>
@@ -76,6 +80,8 @@
 #define VTK_CURVATURE_MAXIMUM 2
 #define VTK_CURVATURE_MINIMUM 3
 
+class vtkDoubleArray;
+
 class VTKFILTERSGENERAL_EXPORT vtkCurvatures : public vtkPolyDataAlgorithm
 {
 public:
@@ -141,6 +147,13 @@ protected:
    */
   void GetMinimumCurvature(vtkPolyData* input, vtkPolyData* output);
 
+  /**
+   * Principal curvature H + sign * sqrt(H^2 - K) from the Gauss and mean
+   * curvatures.
+   */
+  void ComputePrincipalCurvature(
+    vtkDoubleArray* gauss, vtkDoubleArray* mean, vtkDoubleArray* principal, double sign);
+
   // Vars
   int CurvatureType;
   vtkTypeBool InvertMeanCurvature;
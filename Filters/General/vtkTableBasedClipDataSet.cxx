@@ -45,6 +45,7 @@
 #include "vtkPlane.h"
 
 #include "vtkAppendFilter.h"
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDoubleArray.h"
@@ -53,10 +54,15 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticEdgeLocatorTemplate.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <atomic>
+
 // NOLINTNEXTLINE(bugprone-suspicious-include)
 #include "vtkTableBasedClipCases.cxx"
 
@@ -1543,6 +1549,284 @@ inline void GetPoint(
 // =============== vtkTableBasedClipperVolumeFromVolume ( end ) ===============
 // ============================================================================
 
+// ============================================================================
+// ============== vtkTableBasedClipperUnstructuredGrid ( begin ) ==============
+// ============================================================================
+
+namespace
+{
+
+typedef const int vtkTableBasedClipperEdgeIds[2];
+using vtkTableBasedClipperEdgeLocator = vtkStaticEdgeLocatorTemplate<vtkIdType, vtkIdType>;
+using vtkTableBasedClipperEdgeTuple = vtkTableBasedClipperEdgeLocator::EdgeTupleType;
+
+// Select the clip case of a cell. Returns false if the cell type is not
+// handled by the clip tables.
+bool GetClipCase(int cellType, int caseIndx, const unsigned char*& thisCase, int& nOutputs,
+  const vtkTableBasedClipperEdgeIds*& edgeVtxs)
+{
+  int startIdx = 0;
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesTet[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
+      return true;
+
+    case VTK_PYRAMID:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesPyr[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
+      return true;
+
+    case VTK_WEDGE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesWdg[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
+      return true;
+
+    case VTK_HEXAHEDRON:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
+      return true;
+
+    case VTK_VOXEL:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesVox[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
+      return true;
+
+    case VTK_TRIANGLE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesTri[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
+      return true;
+
+    case VTK_QUAD:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
+      return true;
+
+    case VTK_PIXEL:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesPix[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
+      return true;
+
+    case VTK_LINE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesLin[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[caseIndx];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
+      return true;
+
+    case VTK_VERTEX:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[caseIndx];
+      thisCase = &vtkTableBasedClipperClipTables::ClipShapesVtx[startIdx];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[caseIndx];
+      edgeVtxs = nullptr;
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// Number of points and VTK cell type of an output shape.
+int GetShapeSize(unsigned char theShape, unsigned char& vtkType)
+{
+  switch (theShape)
+  {
+    case ST_HEX:
+      vtkType = VTK_HEXAHEDRON;
+      return 8;
+    case ST_WDG:
+      vtkType = VTK_WEDGE;
+      return 6;
+    case ST_PYR:
+      vtkType = VTK_PYRAMID;
+      return 5;
+    case ST_TET:
+      vtkType = VTK_TETRA;
+      return 4;
+    case ST_QUA:
+      vtkType = VTK_QUAD;
+      return 4;
+    case ST_TRI:
+      vtkType = VTK_TRIANGLE;
+      return 3;
+    case ST_LIN:
+      vtkType = VTK_LINE;
+      return 2;
+    case ST_VTX:
+      vtkType = VTK_VERTEX;
+      return 1;
+    default:
+      vtkType = VTK_EMPTY_CELL;
+      return 0;
+  }
+}
+
+// The pieces generated by clipping a block of consecutive cells. Points are
+// referenced by their input id for input points, by numPts + their local
+// index for the points on edges, and by -1 - their local index for centroid
+// points.
+struct vtkTableBasedClipperBlock
+{
+  std::vector<unsigned char> Shapes; // ST_HEX, ST_WDG, ...
+  std::vector<vtkIdType> CellIds;    // input cell of each output cell
+  std::vector<vtkIdType> Connectivity;
+  std::vector<vtkTableBasedClipperEdgeTuple> Edges;
+  std::vector<vtkIdType> CentroidOffsets{ 0 };
+  std::vector<vtkIdType> CentroidConnectivity;
+  std::vector<vtkIdType> SpecialCells; // cells the tables cannot clip
+};
+
+// Clip the cells of blocks of consecutive cells with the clip tables.
+struct vtkTableBasedClipperClipCells
+{
+  vtkUnstructuredGrid* Input;
+  vtkDataArray* ClipArray;
+  double IsoValue;
+  bool InsideOut;
+  vtkIdType BlockSize;
+  std::vector<vtkTableBasedClipperBlock>& Blocks;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  vtkTableBasedClipperClipCells(vtkUnstructuredGrid* input, vtkDataArray* clipArray,
+    double isoValue, bool insideOut, vtkIdType blockSize,
+    std::vector<vtkTableBasedClipperBlock>& blocks)
+    : Input(input)
+    , ClipArray(clipArray)
+    , IsoValue(isoValue)
+    , InsideOut(insideOut)
+    , BlockSize(blockSize)
+    , Blocks(blocks)
+  {
+  }
+
+  void Initialize() { this->CellPoints.Local()->Allocate(8); }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkIdList* cellPts = this->CellPoints.Local();
+    const vtkIdType numPts = this->Input->GetNumberOfPoints();
+    const vtkIdType numCells = this->Input->GetNumberOfCells();
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkTableBasedClipperBlock& block = this->Blocks[blockId];
+      const vtkIdType endCell = std::min((blockId + 1) * this->BlockSize, numCells);
+      for (vtkIdType cellId = blockId * this->BlockSize; cellId < endCell; ++cellId)
+      {
+        const int cellType = this->Input->GetCellType(cellId);
+        this->Input->GetCellPoints(cellId, cellPts);
+        const vtkIdType* pntIndxs = cellPts->GetPointer(0);
+        const vtkIdType numbPnts = cellPts->GetNumberOfIds();
+
+        int caseIndx = 0;
+        for (vtkIdType j = std::min<vtkIdType>(numbPnts, 8) - 1; j >= 0; j--)
+        {
+          const double grdDiff = this->ClipArray->GetComponent(pntIndxs[j], 0) - this->IsoValue;
+          caseIndx += ((grdDiff >= 0.0) ? 1 : 0);
+          caseIndx <<= (1 - (!j));
+        }
+
+        const unsigned char* thisCase = nullptr;
+        int nOutputs = 0;
+        const vtkTableBasedClipperEdgeIds* edgeVtxs = nullptr;
+        if (numbPnts > 8 || !GetClipCase(cellType, caseIndx, thisCase, nOutputs, edgeVtxs))
+        {
+          block.SpecialCells.push_back(cellId);
+          continue;
+        }
+
+        vtkIdType intrpIds[4];
+        for (int j = 0; j < nOutputs; j++)
+        {
+          int nCellPts = 0;
+          int theColor = -1;
+          int intrpIdx = -1;
+          unsigned char vtkType = VTK_EMPTY_CELL;
+          const unsigned char theShape = *thisCase++;
+          if (theShape == ST_PNT)
+          {
+            intrpIdx = *thisCase++;
+            theColor = *thisCase++;
+            nCellPts = *thisCase++;
+          }
+          else
+          {
+            nCellPts = GetShapeSize(theShape, vtkType);
+            theColor = *thisCase++;
+          }
+
+          if ((!this->InsideOut && theColor == COLOR0) || (this->InsideOut && theColor == COLOR1))
+          {
+            // We don't want this one; it's the wrong side.
+            thisCase += nCellPts;
+            continue;
+          }
+
+          vtkIdType shapeIds[8];
+          for (int p = 0; p < nCellPts; p++)
+          {
+            const unsigned char pntIndex = *thisCase++;
+            if (pntIndex <= P7)
+            {
+              shapeIds[p] = pntIndxs[pntIndex];
+            }
+            else if (pntIndex >= EA && pntIndex <= EL)
+            {
+              const vtkIdType pntIndx1 = pntIndxs[edgeVtxs[pntIndex - EA][0]];
+              const vtkIdType pntIndx2 = pntIndxs[edgeVtxs[pntIndex - EA][1]];
+              shapeIds[p] = numPts + static_cast<vtkIdType>(block.Edges.size());
+              block.Edges.emplace_back(pntIndx1, pntIndx2, 0);
+            }
+            else if (pntIndex >= N0 && pntIndex <= N3)
+            {
+              shapeIds[p] = intrpIds[pntIndex - N0];
+            }
+          }
+
+          if (theShape == ST_PNT)
+          {
+            intrpIds[intrpIdx] = -1 - (static_cast<vtkIdType>(block.CentroidOffsets.size()) - 1);
+            block.CentroidConnectivity.insert(
+              block.CentroidConnectivity.end(), shapeIds, shapeIds + nCellPts);
+            block.CentroidOffsets.push_back(
+              static_cast<vtkIdType>(block.CentroidConnectivity.size()));
+          }
+          else
+          {
+            block.Shapes.push_back(theShape);
+            block.CellIds.push_back(cellId);
+            block.Connectivity.insert(block.Connectivity.end(), shapeIds, shapeIds + nCellPts);
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// =============== vtkTableBasedClipperUnstructuredGrid ( end ) ===============
+// ============================================================================
+
 //------------------------------------------------------------------------------
 // Construct with user-specified implicit function; InsideOut turned off; value
 // set to 0.0; and generate clip scalars turned off.
@@ -1563,6 +1847,7 @@ vtkTableBasedClipDataSet::vtkTableBasedClipDataSet(vtkImplicitFunction* cf)
   this->UseValueAsOffset = true;
   this->GenerateClipScalars = 0;
   this->GenerateClippedOutput = 0;
+  this->ParallelFunctionEvaluation = 0;
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
 
@@ -1713,7 +1998,6 @@ int vtkTableBasedClipDataSet::RequestData(vtkInformation* vtkNotUsed(request),
   theInput = nullptr;
   vtkDebugMacro(<< "Clipping dataset" << endl);
 
-  int i;
   vtkIdType numbPnts = cpyInput->GetNumberOfPoints();
 
   // handling exceptions
@@ -1748,10 +2032,30 @@ int vtkTableBasedClipDataSet::RequestData(vtkInformation* vtkNotUsed(request),
       cpyInput->GetPointData()->SetScalars(pScalars);
     }
 
-    for (i = 0; i < numbPnts; i++)
+    double x[3];
+    if (this->ParallelFunctionEvaluation)
     {
-      double s = this->ClipFunction->FunctionValue(cpyInput->GetPoint(i));
-      pScalars->SetTuple1(i, s);
+      // the first evaluation happens serially to update the function
+      // transform, if any
+      cpyInput->GetPoint(0, x);
+      pScalars->SetValue(0, this->ClipFunction->FunctionValue(x));
+      vtkImplicitFunction* clipFunction = this->ClipFunction;
+      vtkSMPTools::For(1, numbPnts, [&](vtkIdType begin, vtkIdType end) {
+        double pt[3];
+        for (vtkIdType ptId = begin; ptId < end; ptId++)
+        {
+          cpyInput->GetPoint(ptId, pt);
+          pScalars->SetValue(ptId, clipFunction->FunctionValue(pt));
+        }
+      });
+    }
+    else
+    {
+      for (vtkIdType ptId = 0; ptId < numbPnts; ptId++)
+      {
+        cpyInput->GetPoint(ptId, x);
+        pScalars->SetValue(ptId, this->ClipFunction->FunctionValue(x));
+      }
     }
 
     clipAray = pScalars;
@@ -2902,383 +3206,336 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData(
   vtkDataSet* inputGrd, vtkDataArray* clipAray, double isoValue, vtkUnstructuredGrid* outputUG)
 {
   vtkUnstructuredGrid* unstruct = vtkUnstructuredGrid::SafeDownCast(inputGrd);
-
-  vtkIdType i, j;
-  vtkIdType numbPnts = 0;
-  int numCants = 0; // number of cells not clipped by this filter
-  vtkIdType numCells = unstruct->GetNumberOfCells();
-
-  // volume from volume
-  vtkTableBasedClipperVolumeFromVolume* visItVFV =
-    new vtkTableBasedClipperVolumeFromVolume(this->OutputPointsPrecision,
-      unstruct->GetNumberOfPoints(), int(pow(double(numCells), double(0.6667f))) * 5 + 100);
-
-  // the stuffs that can not be clipped by this filter
-  vtkUnstructuredGrid* specials = vtkUnstructuredGrid::New();
-  specials->SetPoints(unstruct->GetPoints());
-  specials->GetPointData()->ShallowCopy(unstruct->GetPointData());
-  specials->Allocate(numCells);
-
-  for (i = 0; i < numCells; i++)
-  {
-    int cellType = unstruct->GetCellType(i);
-    const vtkIdType* pntIndxs = nullptr;
-    unstruct->GetCellPoints(i, numbPnts, pntIndxs);
-
-    bool bCanClip = false;
-    switch (cellType)
-    {
-      case VTK_TETRA:
-      case VTK_PYRAMID:
-      case VTK_WEDGE:
-      case VTK_HEXAHEDRON:
-      case VTK_VOXEL:
-      case VTK_TRIANGLE:
-      case VTK_QUAD:
-      case VTK_PIXEL:
-      case VTK_LINE:
-      case VTK_VERTEX:
-        bCanClip = true;
-        break;
-
-      default:
-        bCanClip = false;
-        break;
-    }
-
-    if (bCanClip)
+  const vtkIdType numPts = unstruct->GetNumberOfPoints();
+  const vtkIdType numCells = unstruct->GetNumberOfCells();
+
+  // Clip blocks of consecutive cells concurrently. Working on fixed-size
+  // blocks rather than on the ranges given to each thread keeps the output
+  // independent of the number of threads.
+  const vtkIdType blockSize = 1024;
+  const vtkIdType numBlocks = (numCells + blockSize - 1) / blockSize;
+  std::vector<vtkTableBasedClipperBlock> blocks(numBlocks);
+  vtkTableBasedClipperClipCells clipCells(
+    unstruct, clipAray, isoValue, this->InsideOut != 0, blockSize, blocks);
+  vtkSMPTools::For(0, numBlocks, clipCells);
+
+  // Offsets of the output of each block.
+  std::vector<vtkIdType> cellOffsets(numBlocks + 1, 0);
+  std::vector<vtkIdType> connOffsets(numBlocks + 1, 0);
+  std::vector<vtkIdType> edgeOffsets(numBlocks + 1, 0);
+  std::vector<vtkIdType> centroidOffsets(numBlocks + 1, 0);
+  vtkIdType numCants = 0; // number of cells not clipped by the tables
+  for (vtkIdType b = 0; b < numBlocks; b++)
+  {
+    const vtkTableBasedClipperBlock& block = blocks[b];
+    cellOffsets[b + 1] = cellOffsets[b] + static_cast<vtkIdType>(block.Shapes.size());
+    connOffsets[b + 1] = connOffsets[b] + static_cast<vtkIdType>(block.Connectivity.size());
+    edgeOffsets[b + 1] = edgeOffsets[b] + static_cast<vtkIdType>(block.Edges.size());
+    centroidOffsets[b + 1] =
+      centroidOffsets[b] + static_cast<vtkIdType>(block.CentroidOffsets.size()) - 1;
+    numCants += static_cast<vtkIdType>(block.SpecialCells.size());
+  }
+
+  // Merge the points generated on the same edge by different cells. Unique
+  // edges are sorted by point ids.
+  const vtkIdType numEdges = edgeOffsets[numBlocks];
+  std::vector<vtkTableBasedClipperEdgeTuple> edges(numEdges);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    for (vtkIdType b = beginBlock; b < endBlock; b++)
     {
-      int caseIndx = 0;
-      double grdDiffs[8];
-
-      for (j = numbPnts - 1; j >= 0; j--)
+      vtkIdType edgeId = edgeOffsets[b];
+      for (const vtkTableBasedClipperEdgeTuple& edge : blocks[b].Edges)
       {
-        grdDiffs[j] = clipAray->GetComponent(pntIndxs[j], 0) - isoValue;
-        caseIndx += ((grdDiffs[j] >= 0.0) ? 1 : 0);
-        caseIndx <<= (1 - (!j));
+        edges[edgeId] = edge;
+        edges[edgeId].Data = edgeId;
+        edgeId++;
       }
-
-      int startIdx = 0;
-      int nOutputs = 0;
-      typedef const int EDGEIDXS[2];
-      EDGEIDXS* edgeVtxs = nullptr;
-      unsigned char* thisCase = nullptr;
-
-      // start index, split case, number of output, and vertices from edges
-      switch (cellType)
+    }
+  });
+  vtkTableBasedClipperEdgeLocator edgeLocator;
+  vtkIdType numUniqueEdges = 0;
+  const vtkIdType* uniqueEdgeOffsets =
+    edgeLocator.MergeEdges(numEdges, edges.data(), numUniqueEdges);
+  std::vector<vtkIdType> edgeMap(numEdges);
+  vtkSMPTools::For(0, numUniqueEdges, [&](vtkIdType beginEdge, vtkIdType endEdge) {
+    for (vtkIdType e = beginEdge; e < endEdge; e++)
+    {
+      for (vtkIdType i = uniqueEdgeOffsets[e]; i < uniqueEdgeOffsets[e + 1]; i++)
       {
-        case VTK_TETRA:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesTet[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
-          break;
-
-        case VTK_PYRAMID:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesPyr[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
-          break;
-
-        case VTK_WEDGE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesWdg[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
-          break;
-
-        case VTK_HEXAHEDRON:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
-          break;
-
-        case VTK_VOXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesVox[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
-          break;
-
-        case VTK_TRIANGLE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesTri[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
-          break;
-
-        case VTK_QUAD:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
-          break;
-
-        case VTK_PIXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesPix[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
-          break;
-
-        case VTK_LINE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesLin[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[caseIndx];
-          edgeVtxs = (EDGEIDXS*)vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
-          break;
-
-        case VTK_VERTEX:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[caseIndx];
-          thisCase = &vtkTableBasedClipperClipTables::ClipShapesVtx[startIdx];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[caseIndx];
-          edgeVtxs = nullptr;
-          break;
+        edgeMap[edges[i].Data] = e;
       }
+    }
+  });
 
-      int intrpIds[4];
-      for (j = 0; j < nOutputs; j++)
+  // Only bring over the input points used by the output, ordered by id. The
+  // blocks sharing a point mark it concurrently.
+  std::vector<std::atomic<unsigned char>> usedFlags(numPts);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    for (vtkIdType b = beginBlock; b < endBlock; b++)
+    {
+      for (const std::vector<vtkIdType>* conn :
+        { &blocks[b].Connectivity, &blocks[b].CentroidConnectivity })
       {
-        int nCellPts = 0;
-        int theColor = -1;
-        int intrpIdx = -1;
-        unsigned char theShape = *thisCase++;
-
-        // number of points and color
-        switch (theShape)
+        for (vtkIdType pt : *conn)
         {
-          case ST_HEX:
-            nCellPts = 8;
-            theColor = *thisCase++;
-            break;
-
-          case ST_WDG:
-            nCellPts = 6;
-            theColor = *thisCase++;
-            break;
-
-          case ST_PYR:
-            nCellPts = 5;
-            theColor = *thisCase++;
-            break;
-
-          case ST_TET:
-            nCellPts = 4;
-            theColor = *thisCase++;
-            break;
-
-          case ST_QUA:
-            nCellPts = 4;
-            theColor = *thisCase++;
-            break;
-
-          case ST_TRI:
-            nCellPts = 3;
-            theColor = *thisCase++;
-            break;
-
-          case ST_LIN:
-            nCellPts = 2;
-            theColor = *thisCase++;
-            break;
-
-          case ST_VTX:
-            nCellPts = 1;
-            theColor = *thisCase++;
-            break;
-
-          case ST_PNT:
-            intrpIdx = *thisCase++;
-            theColor = *thisCase++;
-            nCellPts = *thisCase++;
-            break;
-
-          default:
-            vtkErrorMacro(<< "An invalid output shape was found "
-                          << "in the ClipCases." << endl);
-        }
-
-        if ((!this->InsideOut && theColor == COLOR0) || (this->InsideOut && theColor == COLOR1))
-        {
-          // We don't want this one; it's the wrong side.
-          thisCase += nCellPts;
-          continue;
-        }
-
-        vtkIdType shapeIds[8];
-        for (int p = 0; p < nCellPts; p++)
-        {
-          unsigned char pntIndex = *thisCase++;
-
-          if (pntIndex <= P7)
-          {
-            // We know pt P0 must be >P0 since we already
-            // assume P0 == 0.  This is why we do not
-            // bother subtracting P0 from pt here.
-            shapeIds[p] = pntIndxs[pntIndex];
-          }
-          else if (pntIndex >= EA && pntIndex <= EL)
-          {
-            int pt1Index = edgeVtxs[pntIndex - EA][0];
-            int pt2Index = edgeVtxs[pntIndex - EA][1];
-            if (pt2Index < pt1Index)
-            {
-              int temp = pt2Index;
-              pt2Index = pt1Index;
-              pt1Index = temp;
-            }
-            double pt1ToPt2 = grdDiffs[pt2Index] - grdDiffs[pt1Index];
-            double pt1ToIso = 0.0 - grdDiffs[pt1Index];
-            double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-            vtkIdType pntIndx1 = pntIndxs[pt1Index];
-            vtkIdType pntIndx2 = pntIndxs[pt2Index];
-
-            shapeIds[p] = visItVFV->AddPoint(pntIndx1, pntIndx2, p1Weight);
-          }
-          else if (pntIndex >= N0 && pntIndex <= N3)
+          if (pt >= 0 && pt < numPts)
           {
-            shapeIds[p] = intrpIds[pntIndex - N0];
-          }
-          else
-          {
-            vtkErrorMacro(<< "An invalid output point value was found "
-                          << "in the ClipCases." << endl);
+            usedFlags[pt].store(1, std::memory_order_relaxed);
           }
         }
+      }
+    }
+  });
+  std::vector<vtkIdType> ptLookup(numPts);
+  vtkIdType numUsed = 0;
+  for (vtkIdType i = 0; i < numPts; i++)
+  {
+    ptLookup[i] = usedFlags[i].load(std::memory_order_relaxed) ? numUsed++ : -1;
+  }
+  std::vector<vtkIdType> usedPts(numUsed);
+  for (vtkIdType i = 0; i < numPts; i++)
+  {
+    if (ptLookup[i] >= 0)
+    {
+      usedPts[ptLookup[i]] = i;
+    }
+  }
 
-        switch (theShape)
-        {
-          case ST_HEX:
-            visItVFV->AddHex(i, shapeIds[0], shapeIds[1], shapeIds[2], shapeIds[3], shapeIds[4],
-              shapeIds[5], shapeIds[6], shapeIds[7]);
-            break;
-
-          case ST_WDG:
-            visItVFV->AddWedge(
-              i, shapeIds[0], shapeIds[1], shapeIds[2], shapeIds[3], shapeIds[4], shapeIds[5]);
-            break;
-
-          case ST_PYR:
-            visItVFV->AddPyramid(
-              i, shapeIds[0], shapeIds[1], shapeIds[2], shapeIds[3], shapeIds[4]);
-            break;
-
-          case ST_TET:
-            visItVFV->AddTet(i, shapeIds[0], shapeIds[1], shapeIds[2], shapeIds[3]);
-            break;
-
-          case ST_QUA:
-            visItVFV->AddQuad(i, shapeIds[0], shapeIds[1], shapeIds[2], shapeIds[3]);
-            break;
+  const vtkIdType centroidStart = numUsed + numUniqueEdges;
+  const vtkIdType nOutPts = centroidStart + centroidOffsets[numBlocks];
+  auto outputPointId = [&](vtkIdType b, vtkIdType pt) {
+    if (pt < 0)
+    {
+      return centroidStart + centroidOffsets[b] - 1 - pt;
+    }
+    else if (pt >= numPts)
+    {
+      return numUsed + edgeMap[edgeOffsets[b] + pt - numPts];
+    }
+    return ptLookup[pt];
+  };
 
-          case ST_TRI:
-            visItVFV->AddTri(i, shapeIds[0], shapeIds[1], shapeIds[2]);
-            break;
+  // The clipped cells go directly to the output, unless some cells must be
+  // clipped by vtkClipDataSet.
+  vtkSmartPointer<vtkUnstructuredGrid> visItGrd = outputUG;
+  if (numCants > 0)
+  {
+    visItGrd = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  }
 
-          case ST_LIN:
-            visItVFV->AddLine(i, shapeIds[0], shapeIds[1]);
-            break;
+  //
+  // Set up the output points and its point data.
+  //
+  vtkNew<vtkPoints> outPts;
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    outPts->SetDataType(unstruct->GetPoints()->GetDataType());
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    outPts->SetDataType(VTK_FLOAT);
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    outPts->SetDataType(VTK_DOUBLE);
+  }
+  outPts->SetNumberOfPoints(nOutPts);
 
-          case ST_VTX:
-            visItVFV->AddVertex(i, shapeIds[0]);
-            break;
+  vtkPointData* inPD = unstruct->GetPointData();
+  vtkPointData* outPD = visItGrd->GetPointData();
+  outPD->CopyAllocate(inPD, nOutPts);
+  vtkIntArray* origNodes = vtkArrayDownCast<vtkIntArray>(inPD->GetArray("avtOriginalNodeNumbers"));
+  vtkSmartPointer<vtkIntArray> newOrigNodes;
+  ArrayList ptArrays;
+  ArrayList centroidArrays;
+  if (origNodes != nullptr)
+  {
+    newOrigNodes = vtkSmartPointer<vtkIntArray>::New();
+    newOrigNodes->SetNumberOfComponents(origNodes->GetNumberOfComponents());
+    newOrigNodes->SetNumberOfTuples(nOutPts);
+    newOrigNodes->SetName(origNodes->GetName());
+    ptArrays.ExcludeArray(origNodes);
+    if (vtkAbstractArray* outOrigNodes = outPD->GetAbstractArray(origNodes->GetName()))
+    {
+      centroidArrays.ExcludeArray(outOrigNodes);
+    }
+  }
+  ptArrays.AddArrays(nOutPts, inPD, outPD, 0.0, false);
 
-          case ST_PNT:
-            intrpIds[intrpIdx] = visItVFV->AddCentroidPoint(nCellPts, shapeIds);
-            break;
-        }
+  // Copy over the used input points, then construct the points along edges.
+  vtkPoints* inputPts = unstruct->GetPoints();
+  vtkSMPTools::For(0, numUsed, [&](vtkIdType beginPt, vtkIdType endPt) {
+    double pt[3];
+    for (vtkIdType i = beginPt; i < endPt; i++)
+    {
+      inputPts->GetPoint(usedPts[i], pt);
+      outPts->SetPoint(i, pt);
+      ptArrays.Copy(usedPts[i], i);
+      if (newOrigNodes)
+      {
+        newOrigNodes->SetTuple(i, usedPts[i], origNodes);
       }
-
-      edgeVtxs = nullptr;
-      thisCase = nullptr;
     }
-    else if (cellType == VTK_POLYHEDRON)
+  });
+  vtkSMPTools::For(0, numUniqueEdges, [&](vtkIdType beginEdge, vtkIdType endEdge) {
+    double pt1[3], pt2[3], pt[3];
+    for (vtkIdType e = beginEdge; e < endEdge; e++)
     {
-      if (numCants == 0)
+      const vtkTableBasedClipperEdgeTuple& edge = edges[uniqueEdgeOffsets[e]];
+      const double grdDiff1 = clipAray->GetComponent(edge.V0, 0) - isoValue;
+      const double grdDiff2 = clipAray->GetComponent(edge.V1, 0) - isoValue;
+      const double t = grdDiff1 / (grdDiff1 - grdDiff2);
+      inputPts->GetPoint(edge.V0, pt1);
+      inputPts->GetPoint(edge.V1, pt2);
+      pt[0] = pt1[0] + t * (pt2[0] - pt1[0]);
+      pt[1] = pt1[1] + t * (pt2[1] - pt1[1]);
+      pt[2] = pt1[2] + t * (pt2[2] - pt1[2]);
+
+      const vtkIdType ptIdx = numUsed + e;
+      outPts->SetPoint(ptIdx, pt);
+      ptArrays.InterpolateEdge(edge.V0, edge.V1, t, ptIdx);
+      if (newOrigNodes)
       {
-        specials->GetCellData()->CopyAllocate(unstruct->GetCellData(), numCells);
+        newOrigNodes->SetTuple(ptIdx, (t <= 0.5 ? edge.V0 : edge.V1), origNodes);
       }
-      vtkIdType nfaces;
-      const vtkIdType* facePtIds;
-      unstruct->GetFaceStream(i, nfaces, facePtIds);
-      specials->InsertNextCell(cellType, nfaces, facePtIds);
-      specials->GetCellData()->CopyData(unstruct->GetCellData(), i, numCants);
-      numCants++;
     }
-    else
+  });
+
+  // Now construct the new "centroid" points, averaging output points. A
+  // centroid may use the previous centroids of its block.
+  centroidArrays.AddSelfInterpolatingArrays(nOutPts, outPD);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    vtkIdType ids[8];
+    double pts[3];
+    for (vtkIdType b = beginBlock; b < endBlock; b++)
     {
-      if (numCants == 0)
+      const vtkTableBasedClipperBlock& block = blocks[b];
+      const vtkIdType nCentroids = static_cast<vtkIdType>(block.CentroidOffsets.size()) - 1;
+      for (vtkIdType c = 0; c < nCentroids; c++)
       {
-        specials->GetCellData()->CopyAllocate(unstruct->GetCellData(), numCells);
+        const vtkIdType begin = block.CentroidOffsets[c];
+        const int nPts = static_cast<int>(block.CentroidOffsets[c + 1] - begin);
+        double pt[3] = { 0.0, 0.0, 0.0 };
+        for (int k = 0; k < nPts; k++)
+        {
+          ids[k] = outputPointId(b, block.CentroidConnectivity[begin + k]);
+          outPts->GetPoint(ids[k], pts);
+          pt[0] += pts[0];
+          pt[1] += pts[1];
+          pt[2] += pts[2];
+        }
+        const double weight_factor = 1.0 / nPts;
+        pt[0] *= weight_factor;
+        pt[1] *= weight_factor;
+        pt[2] *= weight_factor;
+
+        const vtkIdType ptIdx = centroidStart + centroidOffsets[b] + c;
+        outPts->SetPoint(ptIdx, pt);
+        centroidArrays.Average(nPts, ids, ptIdx);
+        if (newOrigNodes)
+        {
+          // these 'created' nodes have no original designation
+          for (int z = 0; z < newOrigNodes->GetNumberOfComponents(); z++)
+          {
+            newOrigNodes->SetTypedComponent(ptIdx, z, -1);
+          }
+        }
       }
-      specials->InsertNextCell(cellType, numbPnts, pntIndxs);
-      specials->GetCellData()->CopyData(unstruct->GetCellData(), i, numCants);
-      numCants++;
     }
+  });
 
-    pntIndxs = nullptr;
-  }
-
-  int toDelete = 0;
-  double* theCords = nullptr;
-  vtkPoints* inputPts = unstruct->GetPoints();
-  if (inputPts->GetDataType() == VTK_DOUBLE)
+  visItGrd->SetPoints(outPts);
+  if (newOrigNodes)
   {
-    theCords = static_cast<double*>(inputPts->GetVoidPointer(0));
+    // AddArray will overwrite an already existing array with
+    // the same name, exactly what we want here.
+    outPD->AddArray(newOrigNodes);
   }
-  else
-  {
-    toDelete = 1;
-    numbPnts = inputPts->GetNumberOfPoints();
-    theCords = new double[numbPnts * 3];
-    for (i = 0; i < numbPnts; i++)
+
+  //
+  // Now set up the shapes and the cell data.
+  //
+  const vtkIdType ncells = cellOffsets[numBlocks];
+  vtkCellData* inCD = unstruct->GetCellData();
+  vtkCellData* outCD = visItGrd->GetCellData();
+  outCD->CopyAllocate(inCD, ncells);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(ncells, inCD, outCD, 0.0, false);
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(ncells + 1);
+  offsets->SetValue(ncells, connOffsets[numBlocks]);
+  vtkNew<vtkIdTypeArray> conn;
+  conn->SetNumberOfValues(connOffsets[numBlocks]);
+  vtkNew<vtkUnsignedCharArray> cellTypes;
+  cellTypes->SetNumberOfValues(ncells);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    for (vtkIdType b = beginBlock; b < endBlock; b++)
     {
-      inputPts->GetPoint(i, theCords + (i << 1) + i);
+      const vtkTableBasedClipperBlock& block = blocks[b];
+      vtkIdType cellId = cellOffsets[b];
+      vtkIdType offset = connOffsets[b];
+      const vtkIdType* list = block.Connectivity.data();
+      for (size_t s = 0; s < block.Shapes.size(); s++, cellId++)
+      {
+        unsigned char vtkType;
+        const int shapesize = GetShapeSize(block.Shapes[s], vtkType);
+        cellTypes->SetValue(cellId, vtkType);
+        offsets->SetValue(cellId, offset);
+        for (int l = 0; l < shapesize; l++)
+        {
+          conn->SetValue(offset++, outputPointId(b, *list++));
+        }
+        cellArrays.Copy(block.CellIds[s], cellId);
+      }
     }
-  }
-  inputPts = nullptr;
+  });
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets, conn);
+  visItGrd->SetCells(cellTypes, cells);
 
-  // the stuff that can not be clipped
+  // the stuff that can not be clipped by the tables
   if (numCants > 0)
   {
-    vtkUnstructuredGrid* vtkUGrid = vtkUnstructuredGrid::New();
-    this->ClipDataSet(specials, clipAray, vtkUGrid);
+    vtkNew<vtkUnstructuredGrid> specials;
+    specials->SetPoints(unstruct->GetPoints());
+    specials->GetPointData()->ShallowCopy(unstruct->GetPointData());
+    specials->Allocate(numCants);
+    specials->GetCellData()->CopyAllocate(unstruct->GetCellData(), numCants);
+    vtkNew<vtkIdList> ptIds;
+    for (const vtkTableBasedClipperBlock& block : blocks)
+    {
+      for (vtkIdType cellId : block.SpecialCells)
+      {
+        const int cellType = unstruct->GetCellType(cellId);
+        if (cellType == VTK_POLYHEDRON)
+        {
+          vtkIdType nfaces;
+          const vtkIdType* facePtIds;
+          unstruct->GetFaceStream(cellId, nfaces, facePtIds);
+          specials->InsertNextCell(cellType, nfaces, facePtIds);
+        }
+        else
+        {
+          unstruct->GetCellPoints(cellId, ptIds);
+          specials->InsertNextCell(cellType, ptIds);
+        }
+        specials->GetCellData()->CopyData(
+          unstruct->GetCellData(), cellId, specials->GetNumberOfCells() - 1);
+      }
+    }
 
-    vtkUnstructuredGrid* visItGrd = vtkUnstructuredGrid::New();
-    visItVFV->ConstructDataSet(unstruct, visItGrd, theCords);
+    vtkNew<vtkUnstructuredGrid> vtkUGrid;
+    this->ClipDataSet(specials, clipAray, vtkUGrid);
 
-    vtkAppendFilter* appender = vtkAppendFilter::New();
+    vtkNew<vtkAppendFilter> appender;
     appender->AddInputData(vtkUGrid);
     appender->AddInputData(visItGrd);
     appender->Update();
 
     outputUG->ShallowCopy(appender->GetOutput());
-
-    appender->Delete();
-    visItGrd->Delete();
-    vtkUGrid->Delete();
-    appender = nullptr;
-    vtkUGrid = nullptr;
-    visItGrd = nullptr;
   }
-  else
-  {
-    visItVFV->ConstructDataSet(unstruct, outputUG, theCords);
-  }
-
-  specials->Delete();
-  delete visItVFV;
-  if (toDelete)
-  {
-    delete[] theCords;
-  }
-  specials = nullptr;
-  visItVFV = nullptr;
-  theCords = nullptr;
-  unstruct = nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -3310,6 +3567,9 @@ void vtkTableBasedClipDataSet::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Generate Clipped Output: " << (this->GenerateClippedOutput ? "On\n" : "Off\n");
 
+  os << indent << "ParallelFunctionEvaluation: "
+     << (this->ParallelFunctionEvaluation ? "On\n" : "Off\n");
+
   os << indent << "UseValueAsOffset: " << (this->UseValueAsOffset ? "On\n" : "Off\n");
 
   os << indent << "Precision of the output points: " << this->OutputPointsPrecision << "\n";
@@ -81,6 +81,13 @@
  *  points produces degenerate cells, which can be fixed by post-processing the
  *  output with a filter like vtkCleanGrid.
  *
+ * @warning
+ *  Unstructured grids are clipped in parallel with vtkSMPTools: blocks of
+ *  cells are clipped concurrently and the points generated on the same edge by
+ *  different cells are merged with vtkStaticEdgeLocatorTemplate. The output
+ *  does not depend on the number of threads. The implicit function is
+ *  evaluated serially, unless ParallelFunctionEvaluation is on.
+ *
  * @par Thanks:
  *  This filter was adapted from the VisIt clipper (vtkVisItClipper).
  *
@@ -211,6 +218,18 @@ public:
   vtkBooleanMacro(GenerateClippedOutput, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Set/Get whether the clip function is evaluated at the points with
+   * vtkSMPTools, for all input types. The clip function must then be thread
+   * safe, which is not the case of all implicit functions, for example
+   * vtkImplicitDataSet. Off by default.
+   */
+  vtkSetMacro(ParallelFunctionEvaluation, vtkTypeBool);
+  vtkGetMacro(ParallelFunctionEvaluation, vtkTypeBool);
+  vtkBooleanMacro(ParallelFunctionEvaluation, vtkTypeBool);
+  ///@}
+
   /**
    * Return the clipped output.
    */
@@ -296,6 +315,7 @@ protected:
   vtkTypeBool InsideOut;
   vtkTypeBool GenerateClipScalars;
   vtkTypeBool GenerateClippedOutput;
+  vtkTypeBool ParallelFunctionEvaluation;
   bool UseValueAsOffset;
   double Value;
   double MergeTolerance;
@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the external faces of an unstructured grid of voxels and tetrahedra
+// extracted by vtkDataSetSurfaceFilter, that they lie on the boundary, and
+// that the output, including the original cell and point ids, does not
+// depend on the number of threads.
+
+#include "vtkAppendFilter.h"
+#include "vtkCell.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+vtkSmartPointer<vtkPolyData> ExtractSurface(vtkUnstructuredGrid* input)
+{
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(input);
+  surface->DelegationOff();
+  surface->PassThroughCellIdsOn();
+  surface->PassThroughPointIdsOn();
+  surface->Update();
+
+  vtkSmartPointer<vtkPolyData> output = surface->GetOutput();
+  return output;
+}
+
+bool SameOutputs(vtkPolyData* output1, vtkPolyData* output2)
+{
+  return vtkTest::SameArrays(output1->GetPoints()->GetData(), output2->GetPoints()->GetData()) &&
+    vtkTest::SameArrays(
+      output1->GetPolys()->GetOffsetsArray(), output2->GetPolys()->GetOffsetsArray()) &&
+    vtkTest::SameArrays(output1->GetPolys()->GetConnectivityArray(),
+      output2->GetPolys()->GetConnectivityArray()) &&
+    vtkTest::SameArrays(output1->GetPointData()->GetArray("RTData"),
+      output2->GetPointData()->GetArray("RTData")) &&
+    vtkTest::SameArrays(output1->GetPointData()->GetArray("vtkOriginalPointIds"),
+      output2->GetPointData()->GetArray("vtkOriginalPointIds")) &&
+    vtkTest::SameArrays(output1->GetCellData()->GetArray("vtkOriginalCellIds"),
+      output2->GetCellData()->GetArray("vtkOriginalCellIds"));
+}
+
+} // anonymous namespace
+
+int TestDataSetSurfaceFilterSMP(int, char*[])
+{
+  // Two disjoint blocks of 10x10x10 cells: one of voxels and one of
+  // tetrahedra.
+  vtkNew<vtkRTAnalyticSource> voxels;
+  voxels->SetWholeExtent(-5, 5, -5, 5, -5, 5);
+  vtkNew<vtkRTAnalyticSource> shifted;
+  shifted->SetWholeExtent(6, 16, -5, 5, -5, 5);
+  vtkNew<vtkDataSetTriangleFilter> tetras;
+  tetras->SetInputConnection(shifted->GetOutputPort());
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputConnection(voxels->GetOutputPort());
+  append->AddInputConnection(tetras->GetOutputPort());
+  append->Update();
+  vtkUnstructuredGrid* input = append->GetOutput();
+
+  auto outputs = vtkTest::RunSequentialAndThreaded([&]() { return ExtractSurface(input); });
+  vtkSmartPointer<vtkPolyData> sequential = outputs.first;
+  vtkSmartPointer<vtkPolyData> threaded = outputs.second;
+
+  // 6 * 10 * 10 quads for the voxels, twice as many triangles for the tetras.
+  if (sequential->GetNumberOfPolys() != 1800)
+  {
+    std::cerr << "Expected 1800 external faces, got " << sequential->GetNumberOfPolys() << "."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!SameOutputs(sequential, threaded))
+  {
+    std::cerr << "Threaded output differs from sequential output." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Faces must lie on a side of their block.
+  for (vtkIdType faceId = 0; faceId < threaded->GetNumberOfCells(); ++faceId)
+  {
+    vtkCell* face = threaded->GetCell(faceId);
+    double bounds[6];
+    face->GetBounds(bounds);
+    const double x = bounds[0];
+    const bool onSide = (x == bounds[1] && (x == -5 || x == 5 || x == 6 || x == 16)) ||
+      (bounds[2] == bounds[3] && (bounds[2] == -5 || bounds[2] == 5)) ||
+      (bounds[4] == bounds[5] && (bounds[4] == -5 || bounds[4] == 5));
+    if (!onSide)
+    {
+      std::cerr << "Face " << faceId << " is not on the boundary." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Faces must come from the cells recorded as their origin.
+  vtkIdTypeArray* cellIds =
+    vtkIdTypeArray::SafeDownCast(threaded->GetCellData()->GetArray("vtkOriginalCellIds"));
+  vtkIdTypeArray* pointIds =
+    vtkIdTypeArray::SafeDownCast(threaded->GetPointData()->GetArray("vtkOriginalPointIds"));
+  vtkNew<vtkIdList> facePts;
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType faceId = 0; faceId < threaded->GetNumberOfCells(); ++faceId)
+  {
+    threaded->GetCellPoints(faceId, facePts);
+    input->GetCellPoints(cellIds->GetValue(faceId), cellPts);
+    for (vtkIdType i = 0; i < facePts->GetNumberOfIds(); ++i)
+    {
+      if (cellPts->IsId(pointIds->GetValue(facePts->GetId(i))) < 0)
+      {
+        std::cerr << "Face " << faceId << " does not belong to its original cell." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -41,6 +41,9 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredData.h"
@@ -62,6 +65,7 @@
 #include <memory>
 #include <numeric>
 #include <unordered_map>
+#include <vector>
 
 namespace
 {
@@ -1384,9 +1388,290 @@ int vtkDataSetSurfaceFilter::UnstructuredGridBaseExecute(
   return this->UnstructuredGridExecuteInternal(input, output, handleSubdivision, cellIter);
 }
 
+namespace
+{
+//------------------------------------------------------------------------------
+// A face of a 3D cell, stored with its smallest point id first (the same
+// ordering as the quad hash) so that equal faces compare point by point.
+struct vtkSurfaceFace
+{
+  vtkIdType CellId;
+  vtkIdType Order; // rank in its buffer, faces of a cell are contiguous
+  vtkIdType Offset;
+  int NumPts;
+};
+
+//------------------------------------------------------------------------------
+// Faces gathered by one thread. The insertion methods reorder the points the
+// same way as InsertQuadInHash(), InsertTriInHash() and InsertPolygonInHash().
+struct vtkSurfaceFaceBuffer
+{
+  std::vector<vtkSurfaceFace> Faces;
+  std::vector<vtkIdType> Points;
+
+  void AddFace(const vtkIdType* pts, int numPts, vtkIdType cellId)
+  {
+    this->Faces.push_back(vtkSurfaceFace{ cellId, static_cast<vtkIdType>(this->Faces.size()),
+      static_cast<vtkIdType>(this->Points.size()), numPts });
+    this->Points.insert(this->Points.end(), pts, pts + numPts);
+  }
+
+  void InsertQuad(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d, vtkIdType cellId)
+  {
+    vtkIdType pts[4] = { a, b, c, d };
+    if (b < a && b < c && b < d)
+    {
+      std::rotate(pts, pts + 1, pts + 4);
+    }
+    else if (c < a && c < b && c < d)
+    {
+      std::rotate(pts, pts + 2, pts + 4);
+    }
+    else if (d < a && d < b && d < c)
+    {
+      std::rotate(pts, pts + 3, pts + 4);
+    }
+    this->AddFace(pts, 4, cellId);
+  }
+
+  void InsertTri(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType cellId)
+  {
+    vtkIdType pts[3] = { a, b, c };
+    if (b < a && b < c)
+    {
+      std::rotate(pts, pts + 1, pts + 3);
+    }
+    else if (c < a && c < b)
+    {
+      std::rotate(pts, pts + 2, pts + 3);
+    }
+    this->AddFace(pts, 3, cellId);
+  }
+
+  void InsertPolygon(const vtkIdType* ids, int numPts, vtkIdType cellId)
+  {
+    if (numPts == 0)
+    {
+      return;
+    }
+    const vtkIdType offset = std::min_element(ids, ids + numPts) - ids;
+    this->Faces.push_back(vtkSurfaceFace{ cellId, static_cast<vtkIdType>(this->Faces.size()),
+      static_cast<vtkIdType>(this->Points.size()), numPts });
+    this->Points.insert(this->Points.end(), ids + offset, ids + numPts);
+    this->Points.insert(this->Points.end(), ids, ids + offset);
+  }
+
+  // Faces of the linear 3D cells with a fixed topology. Returns false for
+  // other cell types.
+  bool InsertCellFaces(int cellType, const vtkIdType* ids, vtkIdType cellId)
+  {
+    switch (cellType)
+    {
+      case VTK_HEXAHEDRON:
+        this->InsertQuad(ids[0], ids[1], ids[5], ids[4], cellId);
+        this->InsertQuad(ids[0], ids[3], ids[2], ids[1], cellId);
+        this->InsertQuad(ids[0], ids[4], ids[7], ids[3], cellId);
+        this->InsertQuad(ids[1], ids[2], ids[6], ids[5], cellId);
+        this->InsertQuad(ids[2], ids[3], ids[7], ids[6], cellId);
+        this->InsertQuad(ids[4], ids[5], ids[6], ids[7], cellId);
+        return true;
+
+      case VTK_VOXEL:
+        this->InsertQuad(ids[0], ids[1], ids[5], ids[4], cellId);
+        this->InsertQuad(ids[0], ids[2], ids[3], ids[1], cellId);
+        this->InsertQuad(ids[0], ids[4], ids[6], ids[2], cellId);
+        this->InsertQuad(ids[1], ids[3], ids[7], ids[5], cellId);
+        this->InsertQuad(ids[2], ids[6], ids[7], ids[3], cellId);
+        this->InsertQuad(ids[4], ids[5], ids[7], ids[6], cellId);
+        return true;
+
+      case VTK_TETRA:
+        this->InsertTri(ids[0], ids[1], ids[3], cellId);
+        this->InsertTri(ids[0], ids[2], ids[1], cellId);
+        this->InsertTri(ids[0], ids[3], ids[2], cellId);
+        this->InsertTri(ids[1], ids[2], ids[3], cellId);
+        return true;
+
+      case VTK_PENTAGONAL_PRISM:
+        this->InsertQuad(ids[0], ids[1], ids[6], ids[5], cellId);
+        this->InsertQuad(ids[1], ids[2], ids[7], ids[6], cellId);
+        this->InsertQuad(ids[2], ids[3], ids[8], ids[7], cellId);
+        this->InsertQuad(ids[3], ids[4], ids[9], ids[8], cellId);
+        this->InsertQuad(ids[4], ids[0], ids[5], ids[9], cellId);
+        this->InsertPolygon(ids, 5, cellId);
+        this->InsertPolygon(&ids[5], 5, cellId);
+        return true;
+
+      case VTK_HEXAGONAL_PRISM:
+        this->InsertQuad(ids[0], ids[1], ids[7], ids[6], cellId);
+        this->InsertQuad(ids[1], ids[2], ids[8], ids[7], cellId);
+        this->InsertQuad(ids[2], ids[3], ids[9], ids[8], cellId);
+        this->InsertQuad(ids[3], ids[4], ids[10], ids[9], cellId);
+        this->InsertQuad(ids[4], ids[5], ids[11], ids[10], cellId);
+        this->InsertQuad(ids[5], ids[0], ids[6], ids[11], cellId);
+        this->InsertPolygon(ids, 6, cellId);
+        this->InsertPolygon(&ids[6], 6, cellId);
+        return true;
+
+      case VTK_PYRAMID:
+        this->InsertQuad(ids[3], ids[2], ids[1], ids[0], cellId);
+        this->InsertTri(ids[0], ids[1], ids[4], cellId);
+        this->InsertTri(ids[1], ids[2], ids[4], cellId);
+        this->InsertTri(ids[2], ids[3], ids[4], cellId);
+        this->InsertTri(ids[3], ids[0], ids[4], cellId);
+        return true;
+
+      case VTK_WEDGE:
+        this->InsertQuad(ids[0], ids[2], ids[5], ids[3], cellId);
+        this->InsertQuad(ids[1], ids[0], ids[3], ids[4], cellId);
+        this->InsertQuad(ids[2], ids[1], ids[4], ids[5], cellId);
+        this->InsertTri(ids[0], ids[1], ids[2], cellId);
+        this->InsertTri(ids[3], ids[5], ids[4], cellId);
+        return true;
+
+      default:
+        return false;
+    }
+  }
+};
+
+//------------------------------------------------------------------------------
+// Entry of the face table, sorted by smallest point id (the hash bin) and
+// then by insertion order, which is the traversal order of the quad hash.
+struct vtkSurfaceFaceRef
+{
+  vtkIdType MinPt;
+  vtkIdType CellId;
+  vtkIdType Order;
+  const vtkIdType* Pts;
+  int NumPts;
+
+  bool operator<(const vtkSurfaceFaceRef& other) const
+  {
+    if (this->MinPt != other.MinPt)
+    {
+      return this->MinPt < other.MinPt;
+    }
+    if (this->CellId != other.CellId)
+    {
+      return this->CellId < other.CellId;
+    }
+    return this->Order < other.Order;
+  }
+
+  // Same matching rules as the quad hash: faces sharing their first point
+  // match if the other points are the same, forward or backward.
+  bool SameFace(const vtkSurfaceFaceRef& other) const
+  {
+    const int n = this->NumPts;
+    if (n != other.NumPts)
+    {
+      return false;
+    }
+    const vtkIdType* p = this->Pts;
+    const vtkIdType* q = other.Pts;
+    bool forward = true;
+    for (int i = 1; i < n && forward; ++i)
+    {
+      forward = p[i] == q[i];
+    }
+    if (forward || (n > 4 && p[1] == q[1]))
+    {
+      return forward;
+    }
+    for (int i = 1; i < n; ++i)
+    {
+      if (p[n - i] != q[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Sort the faces of all the buffers and return the faces used by a single
+// cell, in the traversal order of the quad hash. Faces are partitioned by
+// their smallest point id, each partition is matched independently.
+std::vector<vtkSurfaceFaceRef> ExtractExternalFaces(
+  const std::vector<vtkSurfaceFaceBuffer*>& buffers)
+{
+  vtkIdType numFaces = 0;
+  for (vtkSurfaceFaceBuffer* buffer : buffers)
+  {
+    numFaces += static_cast<vtkIdType>(buffer->Faces.size());
+  }
+  std::vector<vtkSurfaceFaceRef> faces(numFaces);
+  vtkIdType start = 0;
+  for (vtkSurfaceFaceBuffer* buffer : buffers)
+  {
+    vtkSMPTools::For(0, static_cast<vtkIdType>(buffer->Faces.size()),
+      [&faces, buffer, start](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          const vtkSurfaceFace& face = buffer->Faces[i];
+          const vtkIdType* pts = buffer->Points.data() + face.Offset;
+          faces[start + i] = vtkSurfaceFaceRef{ pts[0], face.CellId, face.Order, pts, face.NumPts };
+        }
+      });
+    start += static_cast<vtkIdType>(buffer->Faces.size());
+  }
+  vtkSMPTools::Sort(faces.begin(), faces.end());
+
+  std::vector<unsigned char> external(numFaces);
+  vtkSMPTools::For(0, numFaces, [&faces, &external, numFaces](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkSurfaceFaceRef& face = faces[i];
+      bool unique = true;
+      for (vtkIdType j = i - 1; unique && j >= 0 && faces[j].MinPt == face.MinPt; --j)
+      {
+        unique = !face.SameFace(faces[j]);
+      }
+      for (vtkIdType j = i + 1; unique && j < numFaces && faces[j].MinPt == face.MinPt; ++j)
+      {
+        unique = !face.SameFace(faces[j]);
+      }
+      external[i] = unique ? 1 : 0;
+    }
+  });
+
+  // Compact the external faces, by blocks so that it can be done in parallel.
+  const vtkIdType blockSize = 1024;
+  const vtkIdType numBlocks = (numFaces + blockSize - 1) / blockSize;
+  std::vector<vtkIdType> blockOffsets(numBlocks + 1, 0);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      const vtkIdType end = std::min(numFaces, (block + 1) * blockSize);
+      blockOffsets[block + 1] = std::count(
+        external.begin() + block * blockSize, external.begin() + end, static_cast<unsigned char>(1));
+    }
+  });
+  std::partial_sum(blockOffsets.begin(), blockOffsets.end(), blockOffsets.begin());
+  std::vector<vtkSurfaceFaceRef> externalFaces(blockOffsets[numBlocks]);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType outId = blockOffsets[block];
+      const vtkIdType end = std::min(numFaces, (block + 1) * blockSize);
+      for (vtkIdType i = block * blockSize; i < end; ++i)
+      {
+        if (external[i])
+        {
+          externalFaces[outId++] = faces[i];
+        }
+      }
+    }
+  });
+  return externalFaces;
+}
+} // anonymous namespace
+
 //========================================================================
-// Tris are now degenerate quads so we only need one hash table.
-// We might want to change the method names from QuadHash to just Hash.
+// Faces of 3D cells are gathered in a face table partitioned by smallest
+// point id; the faces used by a single cell are sent to the output.
 int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGridBase* input,
   vtkPolyData* output, bool handleSubdivision, vtkSmartPointer<vtkCellIterator> cellIter)
 {
@@ -1441,7 +1726,6 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
   vtkPointData* outputPD = output->GetPointData();
   vtkCellData* outputCD = output->GetCellData();
   vtkFieldData* outputFD = output->GetFieldData();
-  vtkFastGeomQuad* q;
 
   // Shallow copy field data not associated with points or cells
   outputFD->ShallowCopy(inputFD);
@@ -1471,7 +1755,12 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
   std::vector<double> weights;
 
   this->NumberOfNewCells = 0;
-  this->InitializeQuadHash(numPts);
+
+  // Faces of 3D cells go to the face table below, not to the quad hash: only
+  // the point map and the edge map of nonlinear cells are needed.
+  this->PointMap = new vtkIdType[numPts];
+  std::fill(this->PointMap, this->PointMap + numPts, -1);
+  this->EdgeMap = new vtkEdgeInterpolationMap;
 
   // Allocate
   //
@@ -1532,6 +1821,42 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
     }
   }
 
+  // The faces of the linear 3D cells with a fixed topology are gathered in
+  // parallel. Other 3D cells add their faces to serialFaces in the loop below.
+  vtkSurfaceFaceBuffer serialFaces;
+  vtkSMPThreadLocal<vtkSurfaceFaceBuffer> threadFaces;
+  vtkUnstructuredGrid* grid = vtkUnstructuredGrid::SafeDownCast(input);
+  const bool threadedFaces = grid != nullptr && numCells > 0;
+  if (threadedFaces)
+  {
+    // Build the cell structures while single-threaded.
+    vtkNew<vtkIdList> cellPtIds;
+    grid->GetCellType(0);
+    grid->GetCellPoints(0, cellPtIds);
+
+    vtkSMPThreadLocalObject<vtkIdList> tlCellPtIds;
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkSurfaceFaceBuffer& faces = threadFaces.Local();
+      vtkIdList* ptIds = tlCellPtIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (ghostCells &&
+          (ghostCells->GetValue(cellId) & vtkDataSetAttributes::CellGhostTypes::HIDDENCELL))
+        {
+          continue;
+        }
+        const int type = grid->GetCellType(cellId);
+        if (type == VTK_HEXAHEDRON || type == VTK_VOXEL || type == VTK_TETRA ||
+          type == VTK_PENTAGONAL_PRISM || type == VTK_HEXAGONAL_PRISM || type == VTK_PYRAMID ||
+          type == VTK_WEDGE)
+        {
+          grid->GetCellPoints(cellId, ptIds);
+          faces.InsertCellFaces(type, ptIds->GetPointer(0), cellId);
+        }
+      }
+    });
+  }
+
   // Traverse cells to extract geometry
   //
   progressCount = 0;
@@ -1690,79 +2015,16 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
         break;
       }
       case VTK_HEXAHEDRON:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[5], ids[4], cellId);
-        this->InsertQuadInHash(ids[0], ids[3], ids[2], ids[1], cellId);
-        this->InsertQuadInHash(ids[0], ids[4], ids[7], ids[3], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[6], ids[5], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[6], ids[7], cellId);
-        break;
-
       case VTK_VOXEL:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[5], ids[4], cellId);
-        this->InsertQuadInHash(ids[0], ids[2], ids[3], ids[1], cellId);
-        this->InsertQuadInHash(ids[0], ids[4], ids[6], ids[2], cellId);
-        this->InsertQuadInHash(ids[1], ids[3], ids[7], ids[5], cellId);
-        this->InsertQuadInHash(ids[2], ids[6], ids[7], ids[3], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[7], ids[6], cellId);
-        break;
-
       case VTK_TETRA:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertTriInHash(ids[0], ids[1], ids[3], cellId, 2);
-        this->InsertTriInHash(ids[0], ids[2], ids[1], cellId, 3);
-        this->InsertTriInHash(ids[0], ids[3], ids[2], cellId, 1);
-        this->InsertTriInHash(ids[1], ids[2], ids[3], cellId, 0);
-        break;
-
       case VTK_PENTAGONAL_PRISM:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[6], ids[5], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[8], ids[7], cellId);
-        this->InsertQuadInHash(ids[3], ids[4], ids[9], ids[8], cellId);
-        this->InsertQuadInHash(ids[4], ids[0], ids[5], ids[9], cellId);
-        this->InsertPolygonInHash(ids, 5, cellId);
-        this->InsertPolygonInHash(&ids[5], 5, cellId);
-        break;
-
       case VTK_HEXAGONAL_PRISM:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[1], ids[7], ids[6], cellId);
-        this->InsertQuadInHash(ids[1], ids[2], ids[8], ids[7], cellId);
-        this->InsertQuadInHash(ids[2], ids[3], ids[9], ids[8], cellId);
-        this->InsertQuadInHash(ids[3], ids[4], ids[10], ids[9], cellId);
-        this->InsertQuadInHash(ids[4], ids[5], ids[11], ids[10], cellId);
-        this->InsertQuadInHash(ids[5], ids[0], ids[6], ids[11], cellId);
-        this->InsertPolygonInHash(ids, 6, cellId);
-        this->InsertPolygonInHash(&ids[6], 6, cellId);
-        break;
-
       case VTK_PYRAMID:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[3], ids[2], ids[1], ids[0], cellId);
-        this->InsertTriInHash(ids[0], ids[1], ids[4], cellId);
-        this->InsertTriInHash(ids[1], ids[2], ids[4], cellId);
-        this->InsertTriInHash(ids[2], ids[3], ids[4], cellId);
-        this->InsertTriInHash(ids[3], ids[0], ids[4], cellId);
-        break;
-
       case VTK_WEDGE:
-        pointIdList = cellIter->GetPointIds();
-        ids = pointIdList->GetPointer(0);
-        this->InsertQuadInHash(ids[0], ids[2], ids[5], ids[3], cellId);
-        this->InsertQuadInHash(ids[1], ids[0], ids[3], ids[4], cellId);
-        this->InsertQuadInHash(ids[2], ids[1], ids[4], ids[5], cellId);
-        this->InsertTriInHash(ids[0], ids[1], ids[2], cellId);
-        this->InsertTriInHash(ids[3], ids[5], ids[4], cellId);
+        if (!threadedFaces)
+        {
+          serialFaces.InsertCellFaces(cellType, cellIter->GetPointIds()->GetPointer(0), cellId);
+        }
         break;
 
       case VTK_PIXEL:
@@ -1800,17 +2062,17 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
               numFacePts = face->GetNumberOfPoints();
               if (numFacePts == 4)
               {
-                this->InsertQuadInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
+                serialFaces.InsertQuad(face->PointIds->GetId(0), face->PointIds->GetId(1),
                   face->PointIds->GetId(2), face->PointIds->GetId(3), cellId);
               }
               else if (numFacePts == 3)
               {
-                this->InsertTriInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
+                serialFaces.InsertTri(face->PointIds->GetId(0), face->PointIds->GetId(1),
                   face->PointIds->GetId(2), cellId);
               }
               else
               {
-                this->InsertPolygonInHash(
+                serialFaces.InsertPolygon(
                   face->PointIds->GetPointer(0), face->PointIds->GetNumberOfIds(), cellId);
               }
             } // for all cell faces
@@ -1860,7 +2122,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
                   face->Triangulate(0, pts, coords);
                   for (i = 0; i < pts->GetNumberOfIds(); i += 3)
                   {
-                    this->InsertTriInHash(
+                    serialFaces.InsertTri(
                       pts->GetId(i), pts->GetId(i + 1), pts->GetId(i + 2), cellId);
                   }
                 }
@@ -1871,7 +2133,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
                     case VTK_QUADRATIC_TRIANGLE:
                     case VTK_LAGRANGE_TRIANGLE:
                     case VTK_BEZIER_TRIANGLE:
-                      this->InsertTriInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
+                      serialFaces.InsertTri(face->PointIds->GetId(0), face->PointIds->GetId(1),
                         face->PointIds->GetId(2), cellId);
                       break;
                     case VTK_QUADRATIC_QUAD:
@@ -1879,7 +2141,7 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
                     case VTK_QUADRATIC_LINEAR_QUAD:
                     case VTK_LAGRANGE_QUADRILATERAL:
                     case VTK_BEZIER_QUADRILATERAL:
-                      this->InsertQuadInHash(face->PointIds->GetId(0), face->PointIds->GetId(1),
+                      serialFaces.InsertQuad(face->PointIds->GetId(0), face->PointIds->GetId(1),
                         face->PointIds->GetId(2), face->PointIds->GetId(3), cellId);
                       break;
                     default:
@@ -2155,9 +2417,14 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
     }
   } // for all cells.
 
-  // Now transfer geometry from hash to output (only triangles and quads).
-  this->InitQuadHashTraversal();
-  while ((q = this->GetNextVisibleQuadFromHash()))
+  // Now transfer the faces used by a single cell to the output.
+  std::vector<vtkSurfaceFaceBuffer*> faceBuffers{ &serialFaces };
+  for (vtkSurfaceFaceBuffer& faces : threadFaces)
+  {
+    faceBuffers.push_back(&faces);
+  }
+  std::vector<vtkIdType> facePts;
+  for (const vtkSurfaceFaceRef& q : ExtractExternalFaces(faceBuffers))
   {
     // If one of the points is hidden (meaning invalid), do not
     // extract surface cell.
@@ -2165,27 +2432,28 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
     // incorrect assumption.
     bool oneHidden = false;
     // handle all polys
-    for (i = 0; i < q->numPts; i++)
+    facePts.resize(q.NumPts);
+    for (i = 0; i < q.NumPts; i++)
     {
       if (ghosts)
       {
-        unsigned char val = ghosts->GetValue(q->ptArray[i]);
+        unsigned char val = ghosts->GetValue(q.Pts[i]);
         if (val & vtkDataSetAttributes::HIDDENPOINT)
         {
           oneHidden = true;
         }
       }
 
-      q->ptArray[i] = this->GetOutputPointId(q->ptArray[i], input, newPts, outputPD);
+      facePts[i] = this->GetOutputPointId(q.Pts[i], input, newPts, outputPD);
     }
 
     if (oneHidden)
     {
       continue;
     }
-    newPolys->InsertNextCell(q->numPts, q->ptArray);
-    this->RecordOrigCellId(this->NumberOfNewCells, q);
-    outputCD->CopyData(inputCD, q->SourceId, this->NumberOfNewCells++);
+    newPolys->InsertNextCell(q.NumPts, facePts.data());
+    this->RecordOrigCellId(this->NumberOfNewCells, q.CellId);
+    outputCD->CopyData(inputCD, q.CellId, this->NumberOfNewCells++);
   }
 
   if (this->PassThroughCellIds)
@@ -2235,8 +2503,10 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(vtkUnstructuredGrid
     this->OriginalPointIds->Delete();
     this->OriginalPointIds = nullptr;
   }
-
-  this->DeleteQuadHash();
+  delete[] this->PointMap;
+  this->PointMap = nullptr;
+  delete this->EdgeMap;
+  this->EdgeMap = nullptr;
 
   return 1;
 }
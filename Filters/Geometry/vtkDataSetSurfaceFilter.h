@@ -70,11 +70,16 @@
  * A key step in this algorithm (for 3D cells) is to count the number times a
  * face is used by a cell. If used only once, then the face is considered a
  * boundary face and sent to the filter output. The filter determines this by
- * creating a hash table of faces: faces that are placed into the hash table
- * a single time are used only once, and therefore sent to the output. Thus
- * large amounts of extra memory is necessary to build the hash table. This
- * obsoleted approach requires a significant amount of memory, and is a
- * significant bottleneck to threading.
+ * creating a table of faces partitioned by their smallest point id: faces
+ * that appear a single time in the table are used only once, and therefore
+ * sent to the output. The faces of linear 3D cells with a fixed topology
+ * (tetrahedra, hexahedra, voxels, wedges, pyramids and prisms) of a
+ * vtkUnstructuredGrid are gathered with vtkSMPTools, and the partitions are
+ * matched in parallel. The faces of other 3D cells (quadratic, polyhedral,
+ * ...) are added to the table serially. The output does not depend on the
+ * number of threads. The table holds all the faces of all the cells, so it
+ * needs about four times the memory of the hash of unmatched faces
+ * (InitializeQuadHash()) that the filter used before.
  *
  * @warning
  * This filter may create duplicate points. Unlike vtkGeometryFilter, it does
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestHyperTreeGridContourGhostTree.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the contour of a hyper tree grid near a coarse cell whose
+// children are all ghosts does not depend on the values of the hyper tree
+// traversed before it.
+
+#include "vtkCellData.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkDoubleArray.h"
+#include "vtkHyperTreeGrid.h"
+#include "vtkHyperTreeGridContour.h"
+#include "vtkHyperTreeGridNonOrientedCursor.h"
+#include "vtkHyperTreeGridSource.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+// Sorted contour points lying left of x = 2, away from tree 3
+std::vector<std::array<double, 3>> ContourPoints(vtkHyperTreeGridSource* source, double value3)
+{
+  source->Modified();
+  source->Update();
+  vtkNew<vtkHyperTreeGrid> htg;
+  htg->ShallowCopy(source->GetOutput());
+
+  // Trees are numbered row by row in a 4 x 2 grid. Tree 4 has ghost children
+  // with value 1, tree 3 is a leaf with the given value and all other cells
+  // have value 0.
+  vtkIdType numCells = htg->GetNumberOfVertices();
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(numCells);
+  scalars->FillValue(0.);
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  ghosts->SetNumberOfTuples(numCells);
+  ghosts->FillValue(0);
+
+  vtkNew<vtkHyperTreeGridNonOrientedCursor> cursor;
+  htg->InitializeNonOrientedCursor(cursor, 3);
+  scalars->SetValue(cursor->GetGlobalNodeIndex(), value3);
+  htg->InitializeNonOrientedCursor(cursor, 4);
+  for (unsigned char child = 0; child < cursor->GetNumberOfChildren(); ++child)
+  {
+    cursor->ToChild(child);
+    scalars->SetValue(cursor->GetGlobalNodeIndex(), 1.);
+    ghosts->SetValue(cursor->GetGlobalNodeIndex(), vtkDataSetAttributes::DUPLICATECELL);
+    cursor->ToParent();
+  }
+  htg->GetCellData()->SetScalars(scalars);
+  htg->GetCellData()->AddArray(ghosts);
+
+  vtkNew<vtkHyperTreeGridContour> contour;
+  contour->SetInputData(htg);
+  contour->SetNumberOfContours(1);
+  contour->SetValue(0, .5);
+  contour->Update();
+
+  std::vector<std::array<double, 3>> points;
+  vtkPoints* outPoints = vtkPolyData::SafeDownCast(contour->GetOutput())->GetPoints();
+  for (vtkIdType i = 0; outPoints && i < outPoints->GetNumberOfPoints(); ++i)
+  {
+    std::array<double, 3> pt;
+    outPoints->GetPoint(i, pt.data());
+    if (pt[0] < 2.)
+    {
+      points.push_back(pt);
+    }
+  }
+  std::sort(points.begin(), points.end());
+  return points;
+}
+
+} // anonymous namespace
+
+int TestHyperTreeGridContourGhostTree(int, char*[])
+{
+  vtkNew<vtkHyperTreeGridSource> htGrid;
+  htGrid->SetMaxDepth(2);
+  htGrid->SetDimensions(5, 3, 1); // GridCell 4, 2
+  htGrid->SetGridScale(1., 1., 1.);
+  htGrid->SetBranchFactor(2);
+  htGrid->SetDescriptor("....RR..|.... ....");
+
+  // Tree 3 is traversed right before tree 4 but does not touch tree 5, which
+  // is only refined next to tree 4. The sign of the coarse cell of tree 4 must
+  // not be taken from tree 3.
+  std::vector<std::array<double, 3>> points0 = ContourPoints(htGrid, 0.);
+  std::vector<std::array<double, 3>> points1 = ContourPoints(htGrid, 1.);
+  if (points0.empty() || points0 != points1)
+  {
+    std::cerr << "Contour away from tree 3 depends on its value: " << points0.size() << " and "
+              << points1.size() << " points." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
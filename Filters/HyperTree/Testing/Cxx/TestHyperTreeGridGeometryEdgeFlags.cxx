@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestHyperTreeGridGeometryEdgeFlags.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkHyperTreeGridGeometry stores one edge flag per output point in
+// 3D, with and without merging, and that a merged point keeps the edge flag of
+// the first face using it.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkHyperTreeGridGeometry.h"
+#include "vtkHyperTreeGridSource.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+vtkSmartPointer<vtkPolyData> ComputeGeometry(vtkHyperTreeGridSource* source, bool merging)
+{
+  vtkNew<vtkHyperTreeGridGeometry> geometry;
+  geometry->SetInputConnection(source->GetOutputPort());
+  geometry->SetMerging(merging);
+  geometry->Update();
+  return geometry->GetPolyDataOutput();
+}
+
+} // anonymous namespace
+
+int TestHyperTreeGridGeometryEdgeFlags(int, char*[])
+{
+  // Masked hyper tree grid, so that some edges are hidden
+  vtkNew<vtkHyperTreeGridSource> htGrid;
+  htGrid->SetMaxDepth(5);
+  htGrid->SetDimensions(4, 4, 3); // GridCell 3, 3, 2
+  htGrid->SetGridScale(1.5, 1., .7);
+  htGrid->SetBranchFactor(3);
+  htGrid->UseMaskOn();
+  htGrid->SetDescriptor(
+    "RRR .R. .RR ..R ..R .R.|R.......................... ........................... "
+    "........................... .............R............. ....RR.RR........R......... "
+    ".....RRRR.....R.RR......... ........................... ........................... "
+    "...........................|........................... ........................... "
+    "........................... ...RR.RR.......RR.......... ........................... "
+    "RR......................... ........................... ........................... "
+    "........................... ........................... ........................... "
+    "........................... ........................... "
+    "............RRR............|........................... ........................... "
+    ".......RR.................. ........................... ........................... "
+    "........................... ........................... ........................... "
+    "........................... ........................... "
+    "...........................|........................... ...........................");
+  htGrid->SetMask(
+    "111 011 011 111 011 110|111111111111111111111111111 111111111111111111111111111 "
+    "000000000100110111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "000110011100000100100010100|000001011011111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111001111111101111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111|000000000111100100111100100 000000000111001001111001001 "
+    "000000111100100111111111111 000000111001001111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 "
+    "110110110100111110111000000|111111111111111111111111111  11111111111111111111111111");
+
+  vtkSmartPointer<vtkPolyData> separate = ComputeGeometry(htGrid, false);
+  vtkSmartPointer<vtkPolyData> merged = ComputeGeometry(htGrid, true);
+
+  // One edge flag per point in both modes
+  for (vtkPolyData* output : { separate.Get(), merged.Get() })
+  {
+    vtkDataArray* edgeFlags = output->GetPointData()->GetArray("vtkEdgeFlags");
+    if (!edgeFlags || edgeFlags->GetNumberOfTuples() != output->GetNumberOfPoints())
+    {
+      std::cerr << "Expected one edge flag per point, got "
+                << (edgeFlags ? edgeFlags->GetNumberOfTuples() : 0) << " for "
+                << output->GetNumberOfPoints() << " points." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Faces are generated in the same order in both modes, and each face gives
+  // its own point the same edge flag.
+  vtkIdType nFaces = separate->GetNumberOfCells();
+  if (merged->GetNumberOfCells() != nFaces ||
+    separate->GetNumberOfPoints() != 4 * nFaces ||
+    merged->GetNumberOfPoints() >= separate->GetNumberOfPoints())
+  {
+    std::cerr << "Unexpected numbers of faces or points." << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkDataArray* separateFlags = separate->GetPointData()->GetArray("vtkEdgeFlags");
+  vtkDataArray* mergedFlags = merged->GetPointData()->GetArray("vtkEdgeFlags");
+
+  bool hiddenEdge = false;
+  std::vector<bool> seen(merged->GetNumberOfPoints(), false);
+  vtkNew<vtkIdList> separateIds;
+  vtkNew<vtkIdList> mergedIds;
+  for (vtkIdType face = 0; face < nFaces; ++face)
+  {
+    separate->GetPolys()->GetCellAtId(face, separateIds);
+    merged->GetPolys()->GetCellAtId(face, mergedIds);
+    for (vtkIdType i = 0; i < 4; ++i)
+    {
+      double flag = separateFlags->GetComponent(separateIds->GetId(i), 0);
+      hiddenEdge |= flag != 0.;
+      vtkIdType id = mergedIds->GetId(i);
+      if (seen[id])
+      {
+        continue;
+      }
+      seen[id] = true;
+      if (mergedFlags->GetComponent(id, 0) != flag)
+      {
+        std::cerr << "Merged point " << id << " does not have the edge flag of face " << face
+                  << "." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  if (!hiddenEdge)
+  {
+    std::cerr << "Expected the mask to hide some edges." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,277 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestHyperTreeGridSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the hyper tree grid filters traversing the trees concurrently
+// produce the same output whatever the number of threads, and that points
+// are merged across the pieces of output built by distinct threads.
+
+#include "vtkBitArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkHyperTreeGrid.h"
+#include "vtkHyperTreeGridCellCenters.h"
+#include "vtkHyperTreeGridContour.h"
+#include "vtkHyperTreeGridGeometry.h"
+#include "vtkHyperTreeGridPlaneCutter.h"
+#include "vtkHyperTreeGridSource.h"
+#include "vtkHyperTreeGridThreshold.h"
+#include "vtkHyperTreeGridToUnstructuredGrid.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+bool SameAttributes(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* array = a->GetArray(i);
+    if (array && !vtkTest::SameArrays(array, b->GetArray(array->GetName())))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameDataSets(vtkDataSet* a, vtkDataSet* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+    a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  double pa[3], pb[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    a->GetPoint(i, pa);
+    b->GetPoint(i, pb);
+    if (pa[0] != pb[0] || pa[1] != pb[1] || pa[2] != pb[2])
+    {
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> ida, idb;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    a->GetCellPoints(i, ida);
+    b->GetCellPoints(i, idb);
+    if (a->GetCellType(i) != b->GetCellType(i) || ida->GetNumberOfIds() != idb->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType j = 0; j < ida->GetNumberOfIds(); ++j)
+    {
+      if (ida->GetId(j) != idb->GetId(j))
+      {
+        return false;
+      }
+    }
+  }
+  return SameAttributes(a->GetPointData(), b->GetPointData()) &&
+    SameAttributes(a->GetCellData(), b->GetCellData());
+}
+
+bool SameGrids(vtkHyperTreeGrid* a, vtkHyperTreeGrid* b)
+{
+  return a->GetNumberOfVertices() == b->GetNumberOfVertices() && a->HasMask() == b->HasMask() &&
+    (!a->HasMask() || vtkTest::SameArrays(a->GetMask(), b->GetMask())) &&
+    SameAttributes(a->GetCellData(), b->GetCellData());
+}
+
+// Run a filter sequentially then with several threads and compare the outputs
+bool CheckFilter(const std::string& name, vtkAlgorithm* filter)
+{
+  auto outputs = vtkTest::RunSequentialAndThreaded([&]() -> vtkSmartPointer<vtkDataObject> {
+    filter->Modified();
+    filter->Update();
+    vtkSmartPointer<vtkDataObject> output;
+    output.TakeReference(filter->GetOutputDataObject(0)->NewInstance());
+    output->DeepCopy(filter->GetOutputDataObject(0));
+    return output;
+  });
+
+  vtkHyperTreeGrid* htg = vtkHyperTreeGrid::SafeDownCast(outputs.first);
+  bool same = htg ? SameGrids(htg, vtkHyperTreeGrid::SafeDownCast(outputs.second))
+                  : SameDataSets(vtkDataSet::SafeDownCast(outputs.first),
+                      vtkDataSet::SafeDownCast(outputs.second));
+  if (!same)
+  {
+    std::cerr << name << " output depends on the number of threads." << std::endl;
+  }
+  return same;
+}
+
+// Check that no two points of output coincide
+bool CheckMergedPoints(const std::string& name, vtkAlgorithm* filter)
+{
+  vtkDataSet* output = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+  std::vector<std::array<double, 3>> points(output->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    output->GetPoint(i, points[i].data());
+  }
+  std::sort(points.begin(), points.end());
+  if (points.empty() || std::adjacent_find(points.begin(), points.end()) != points.end())
+  {
+    std::cerr << name << " output has no points or duplicate points." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Check that the scalars interpolated at the points of a contour are contour
+// values
+bool CheckContourValues(vtkHyperTreeGridContour* contour)
+{
+  vtkDataSet* output = vtkDataSet::SafeDownCast(contour->GetOutputDataObject(0));
+  vtkDataArray* scalars = output->GetPointData()->GetArray("Depth");
+  if (!scalars)
+  {
+    std::cerr << "vtkHyperTreeGridContour output has no scalars." << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+  {
+    double value = scalars->GetComponent(i, 0);
+    bool isContourValue = false;
+    for (int c = 0; c < contour->GetNumberOfContours(); ++c)
+    {
+      isContourValue |= std::abs(value - contour->GetValue(c)) < 1e-9;
+    }
+    if (!isContourValue)
+    {
+      std::cerr << "vtkHyperTreeGridContour point " << i << " has scalar " << value
+                << " that is not a contour value." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestHyperTreeGridSMP(int, char*[])
+{
+  // Hyper tree grid of 18 trees with a material mask
+  vtkNew<vtkHyperTreeGridSource> htGrid;
+  htGrid->SetMaxDepth(5);
+  htGrid->SetDimensions(4, 4, 3); // GridCell 3, 3, 2
+  htGrid->SetGridScale(1.5, 1., .7);
+  htGrid->SetBranchFactor(3);
+  htGrid->UseMaskOn();
+  htGrid->SetDescriptor(
+    "RRR .R. .RR ..R ..R .R.|R.......................... ........................... "
+    "........................... .............R............. ....RR.RR........R......... "
+    ".....RRRR.....R.RR......... ........................... ........................... "
+    "...........................|........................... ........................... "
+    "........................... ...RR.RR.......RR.......... ........................... "
+    "RR......................... ........................... ........................... "
+    "........................... ........................... ........................... "
+    "........................... ........................... "
+    "............RRR............|........................... ........................... "
+    ".......RR.................. ........................... ........................... "
+    "........................... ........................... ........................... "
+    "........................... ........................... "
+    "...........................|........................... ...........................");
+  htGrid->SetMask(
+    "111 011 011 111 011 110|111111111111111111111111111 111111111111111111111111111 "
+    "000000000100110111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "000110011100000100100010100|000001011011111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111001111111101111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111|000000000111100100111100100 000000000111001001111001001 "
+    "000000111100100111111111111 000000111001001111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 111111111111111111111111111 "
+    "111111111111111111111111111 111111111111111111111111111 "
+    "110110110100111110111000000|111111111111111111111111111  11111111111111111111111111");
+  htGrid->Update();
+  vtkHyperTreeGrid* htg = vtkHyperTreeGrid::SafeDownCast(htGrid->GetOutput());
+  htg->GetCellData()->SetScalars(htg->GetCellData()->GetArray("Depth"));
+
+  bool success = true;
+
+  vtkNew<vtkHyperTreeGridCellCenters> centers;
+  centers->SetInputConnection(htGrid->GetOutputPort());
+  centers->VertexCellsOn();
+  success &= CheckFilter("vtkHyperTreeGridCellCenters", centers);
+
+  vtkNew<vtkHyperTreeGridToUnstructuredGrid> unstructured;
+  unstructured->SetInputConnection(htGrid->GetOutputPort());
+  success &= CheckFilter("vtkHyperTreeGridToUnstructuredGrid", unstructured);
+
+  for (bool merging : { false, true })
+  {
+    vtkNew<vtkHyperTreeGridGeometry> geometry;
+    geometry->SetInputConnection(htGrid->GetOutputPort());
+    geometry->SetMerging(merging);
+    success &= CheckFilter("vtkHyperTreeGridGeometry", geometry);
+    if (merging)
+    {
+      success &= CheckMergedPoints("vtkHyperTreeGridGeometry", geometry);
+    }
+  }
+
+  for (bool justCreateNewMask : { false, true })
+  {
+    vtkNew<vtkHyperTreeGridThreshold> threshold;
+    threshold->SetInputConnection(htGrid->GetOutputPort());
+    threshold->ThresholdBetween(2., 4.);
+    threshold->SetJustCreateNewMask(justCreateNewMask);
+    success &= CheckFilter("vtkHyperTreeGridThreshold", threshold);
+  }
+
+  vtkNew<vtkHyperTreeGridContour> contour;
+  contour->SetInputConnection(htGrid->GetOutputPort());
+  contour->SetNumberOfContours(3);
+  contour->SetValue(0, 1.5);
+  contour->SetValue(1, 2.5);
+  contour->SetValue(2, 3.5);
+  success &= CheckFilter("vtkHyperTreeGridContour", contour);
+  success &= CheckMergedPoints("vtkHyperTreeGridContour", contour);
+  success &= CheckContourValues(contour);
+
+  for (int dual : { 0, 1 })
+  {
+    vtkNew<vtkHyperTreeGridPlaneCutter> cutter;
+    cutter->SetInputConnection(htGrid->GetOutputPort());
+    cutter->SetPlane(1., -.2, .2, 3.);
+    cutter->SetDual(dual);
+    success &= CheckFilter("vtkHyperTreeGridPlaneCutter", cutter);
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
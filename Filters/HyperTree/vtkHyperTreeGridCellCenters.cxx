@@ -20,6 +20,7 @@
 #include "vtkCellData.h"
 #include "vtkHyperTree.h"
 #include "vtkHyperTreeGrid.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -27,10 +28,39 @@
 #include "vtkPoints.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include "vtkHyperTreeGridNonOrientedCursor.h"
 #include "vtkHyperTreeGridNonOrientedGeometryCursor.h"
+#include "vtkHyperTreeGridSMPInternal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <numeric>
+#include <vector>
 
 vtkStandardNewMacro(vtkHyperTreeGridCellCenters);
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Number of unmasked leaves below the cursor
+vtkIdType CountUnmaskedLeaves(vtkHyperTreeGridNonOrientedCursor* cursor, vtkBitArray* mask)
+{
+  if (cursor->IsLeaf())
+  {
+    return mask->GetValue(cursor->GetGlobalNodeIndex()) ? 0 : 1;
+  }
+  vtkIdType count = 0;
+  const unsigned char numChildren = cursor->GetNumberOfChildren();
+  for (unsigned char child = 0; child < numChildren; ++child)
+  {
+    cursor->ToChild(child);
+    count += CountUnmaskedLeaves(cursor, mask);
+    cursor->ToParent();
+  }
+  return count;
+}
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 vtkHyperTreeGridCellCenters::vtkHyperTreeGridCellCenters()
 {
@@ -158,23 +188,47 @@ void vtkHyperTreeGridCellCenters::ProcessTrees()
   // Retrieve material mask
   this->InMask = this->Input->HasMask() ? this->Input->GetMask() : nullptr;
 
-  // Iterate over all hyper trees
-  vtkIdType index;
-  vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-  this->Input->InitializeTreeIterator(it);
-  vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
-  while (it.GetNextTree(index))
-  {
-    // Initialize new geometric cursor at root of current tree
-    this->Input->InitializeNonOrientedGeometryCursor(cursor, index);
-    // Generate leaf cell centers recursively
-    this->RecursivelyProcessTree(cursor);
-  } // it
+  // Count the unmasked leaves of each hyper tree, the trees being independent
+  std::vector<vtkIdType> trees = vtkHyperTreeGridGetTreeIndices(this->Input);
+  const vtkIdType numTrees = static_cast<vtkIdType>(trees.size());
+  std::vector<vtkIdType> treeOffsets(numTrees + 1, 0);
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> tlCursor;
+  vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+    vtkHyperTreeGridNonOrientedCursor* cursor = tlCursor.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Input->InitializeNonOrientedCursor(cursor, trees[i]);
+      treeOffsets[i + 1] = this->InMask ? CountUnmaskedLeaves(cursor, this->InMask)
+                                        : cursor->GetTree()->GetNumberOfLeaves();
+    }
+  });
+  std::partial_sum(treeOffsets.begin(), treeOffsets.end(), treeOffsets.begin());
+
+  // Generate leaf cell centers of each tree from its offset
+  const vtkIdType numPoints = treeOffsets[numTrees];
+  this->Points->SetNumberOfPoints(numPoints);
+  vtkNew<vtkIdList> leafIds;
+  leafIds->SetNumberOfIds(numPoints);
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedGeometryCursor> tlGeometryCursor;
+  vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+    vtkHyperTreeGridNonOrientedGeometryCursor* cursor = tlGeometryCursor.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      // Initialize new geometric cursor at root of current tree
+      this->Input->InitializeNonOrientedGeometryCursor(cursor, trees[i]);
+      // Generate leaf cell centers recursively
+      vtkIdType outId = treeOffsets[i];
+      this->RecursivelyProcessTree(cursor, leafIds, outId);
+    }
+  });
 
   // Set output geometry and topology if required
   this->Output->SetPoints(this->Points);
   if (this->VertexCells)
   {
+    // Copy cell center data from leaf data
+    this->OutData->CopyData(this->InData, leafIds, vtkIdType(0));
+
     vtkIdType np = this->Points->GetNumberOfPoints();
     vtkCellArray* vertices = vtkCellArray::New();
     vertices->AllocateEstimate(np, 1);
@@ -193,7 +247,7 @@ void vtkHyperTreeGridCellCenters::ProcessTrees()
 
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridCellCenters::RecursivelyProcessTree(
-  vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
+  vtkHyperTreeGridNonOrientedGeometryCursor* cursor, vtkIdList* leafIds, vtkIdType& outId)
 {
   // Create cell center if cursor is at leaf
   if (cursor->IsLeaf())
@@ -211,14 +265,9 @@ void vtkHyperTreeGridCellCenters::RecursivelyProcessTree(
     double pt[3];
     cursor->GetPoint(pt);
 
-    // Insert next point
-    vtkIdType outId = this->Points->InsertNextPoint(pt);
-
-    // Copy cell center data from leaf data, when needed
-    if (this->VertexCells)
-    {
-      this->OutData->CopyData(this->InData, id, outId);
-    }
+    // Set next point and keep track of the leaf it comes from
+    this->Points->SetPoint(outId, pt);
+    leafIds->SetId(outId++, id);
   }
   else
   {
@@ -228,7 +277,7 @@ void vtkHyperTreeGridCellCenters::RecursivelyProcessTree(
     {
       cursor->ToChild(child);
       // Recurse
-      this->RecursivelyProcessTree(cursor);
+      this->RecursivelyProcessTree(cursor, leafIds, outId);
       cursor->ToParent();
     } // child
   }   // else
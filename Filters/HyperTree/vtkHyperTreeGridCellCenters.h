@@ -50,6 +50,7 @@
 class vtkBitArray;
 class vtkDataSetAttributes;
 class vtkHyperTreeGrid;
+class vtkIdList;
 class vtkPolyData;
 class vtkHyperTreeGridNonOrientedGeometryCursor;
 
@@ -75,9 +76,12 @@ protected:
   virtual void ProcessTrees();
 
   /**
-   * Recursively descend into tree down to leaves
+   * Recursively descend into tree down to leaves, generating the centers of
+   * unmasked leaves from outId and storing their global indices in leafIds.
+   * The hyper trees are processed concurrently.
    */
-  void RecursivelyProcessTree(vtkHyperTreeGridNonOrientedGeometryCursor*);
+  void RecursivelyProcessTree(
+    vtkHyperTreeGridNonOrientedGeometryCursor*, vtkIdList* leafIds, vtkIdType& outId);
 
   vtkHyperTreeGrid* Input;
   vtkPolyData* Output;
@@ -35,9 +35,14 @@
 #include "vtkPixel.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkVoxel.h"
 
+#include "vtkHyperTreeGridSMPInternal.h"
+
 static const unsigned int MooreCursors1D[2] = { 0, 2 };
 static const unsigned int MooreCursors2D[8] = { 0, 1, 2, 3, 5, 6, 7, 8 };
 static const unsigned int MooreCursors3D[26] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 14, 15,
@@ -59,23 +64,6 @@ vtkHyperTreeGridContour::vtkHyperTreeGridContour()
   // Initialize locator to null
   this->Locator = nullptr;
 
-  // Initialize list of selected cells
-  this->SelectedCells = nullptr;
-
-  // Initialize per-cell quantities of interest
-  this->CellSigns = nullptr;
-  this->CellScalars = nullptr;
-
-  // Initialize structures for isocontouring
-  this->Helper = nullptr;
-  this->Leaves = vtkIdList::New();
-  this->Line = vtkLine::New();
-  this->Pixel = vtkPixel::New();
-  this->Voxel = vtkVoxel::New();
-
-  // Output indices begin at 0
-  this->CurrentId = 0;
-
   // Process active point scalars by default
   this->SetInputArrayToProcess(
     0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS_THEN_CELLS, vtkDataSetAttributes::SCALARS);
@@ -98,30 +86,6 @@ vtkHyperTreeGridContour::~vtkHyperTreeGridContour()
     this->Locator->Delete();
     this->Locator = nullptr;
   }
-
-  if (this->Line)
-  {
-    this->Line->Delete();
-    this->Line = nullptr;
-  }
-
-  if (this->Pixel)
-  {
-    this->Pixel->Delete();
-    this->Pixel = nullptr;
-  }
-
-  if (this->Voxel)
-  {
-    this->Voxel->Delete();
-    this->Voxel = nullptr;
-  }
-
-  if (this->Leaves)
-  {
-    this->Leaves->Delete();
-    this->Leaves = nullptr;
-  }
 }
 
 //------------------------------------------------------------------------------
@@ -131,8 +95,6 @@ void vtkHyperTreeGridContour::PrintSelf(ostream& os, vtkIndent indent)
 
   this->ContourValues->PrintSelf(os, indent.GetNextIndent());
 
-  os << indent << "CurrentId: " << this->CurrentId << endl;
-
   if (this->InScalars)
   {
     os << indent << "InScalars:\n";
@@ -151,42 +113,6 @@ void vtkHyperTreeGridContour::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Locator: (none)\n";
   }
-
-  if (this->Line)
-  {
-    os << indent << ": " << this->Line << "\n";
-  }
-  else
-  {
-    os << indent << ": (none)\n";
-  }
-
-  if (this->Pixel)
-  {
-    os << indent << ": " << this->Pixel << "\n";
-  }
-  else
-  {
-    os << indent << ": (none)\n";
-  }
-
-  if (this->Voxel)
-  {
-    os << indent << ": " << this->Voxel << "\n";
-  }
-  else
-  {
-    os << indent << ": (none)\n";
-  }
-
-  if (this->Leaves)
-  {
-    os << indent << ": " << this->Leaves << "\n";
-  }
-  else
-  {
-    os << indent << ": (none)\n";
-  }
 }
 
 //------------------------------------------------------------------------------
@@ -279,9 +205,6 @@ int vtkHyperTreeGridContour::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObject
   this->OutData = output->GetPointData();
   this->OutData->CopyAllocate(this->InData);
 
-  // Output indices begin at 0
-  this->CurrentId = 0;
-
   // Retrieve material mask
   this->InMask = input->HasMask() ? input->GetMask() : nullptr;
 
@@ -299,111 +222,102 @@ int vtkHyperTreeGridContour::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObject
     estimatedSize = 1024;
   }
 
-  // Create storage for output points
-  vtkPoints* newPts = vtkPoints::New();
-  newPts->Allocate(estimatedSize, estimatedSize);
-
-  // Create storage for output vertices
-  vtkCellArray* newVerts = vtkCellArray::New();
-  newVerts->AllocateExact(estimatedSize, estimatedSize);
-
-  // Create storage for output lines
-  vtkCellArray* newLines = vtkCellArray::New();
-  newLines->AllocateExact(estimatedSize, estimatedSize);
-
-  // Create storage for output polygons
-  vtkCellArray* newPolys = vtkCellArray::New();
-  newPolys->AllocateExact(estimatedSize, estimatedSize);
+  // Create storage to keep track of selected cells, one byte per cell so
+  // that distinct trees can be processed concurrently
+  this->SelectedCells.assign(numCells, 0);
 
-  // Create storage for output scalar values
-  this->CellScalars = this->InScalars->NewInstance();
-  this->CellScalars->SetNumberOfComponents(this->InScalars->GetNumberOfComponents());
-  this->CellScalars->Allocate(this->CellScalars->GetNumberOfComponents() * 8);
+  // Initialize storage for signs
+  this->CellSigns.assign(numContours, std::vector<unsigned char>(numCells, 0));
 
-  // Initialize point locator
+  // First pass across tree roots to evince cells intersected by contours
+  std::vector<vtkIdType> trees = vtkHyperTreeGridGetTreeIndices(input);
+  const vtkIdType numTrees = static_cast<vtkIdType>(trees.size());
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> tlCursor;
+  vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+    vtkHyperTreeGridNonOrientedCursor* cursor = tlCursor.Local();
+    std::vector<bool> signs;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      // Initialize new grid cursor at root of current input tree
+      input->InitializeNonOrientedCursor(cursor, trees[i]);
+      // Pre-process tree recursively, leaf signs being carried within the tree only
+      signs.assign(numContours, true);
+      this->RecursivelyPreProcessTree(cursor, signs);
+    } // i
+  });
+
+  // Second pass across tree roots: now compute isocontours recursively. Each
+  // range of trees is contoured into its own piece of output, with its own
+  // locator merging the points of the piece, sized to its share of the cells
+  vtkNew<vtkPointData> inPointData;
+  inPointData->PassData(input->GetCellData());
+  const unsigned int dim = input->GetDimension();
+  vtkHyperTreeGridPolyDataPieces pieces;
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedMooreSuperCursor> tlSupercursor;
+  vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+    vtkHyperTreeGridPolyDataPiece* piece = pieces.NewPiece(begin);
+    piece->PointData->CopyAllocate(this->InData);
+    double pieceBounds[6];
+    vtkIdType pieceSize =
+      vtkHyperTreeGridGetTreesBounds(input, trees, begin, end, pieceBounds) * estimatedSize /
+      numCells;
+    pieceSize = std::max(pieceSize / 1024 * 1024, static_cast<vtkIdType>(1024));
+    vtkNew<vtkMergePoints> locator;
+    locator->InitPointInsertion(piece->Points, pieceBounds, pieceSize);
+
+    // Instantiate a contour helper for convenience, with triangle generation on
+    vtkContourHelper helper(locator, piece->Verts, piece->Lines, piece->Polys, inPointData,
+      nullptr, piece->PointData, nullptr, pieceSize, true);
+
+    // Generate contour topology depending on dimensionality
+    vtkSmartPointer<vtkCell> cell;
+    switch (dim)
+    {
+      case 1:
+        cell = vtkSmartPointer<vtkLine>::New();
+        break;
+      case 2:
+        cell = vtkSmartPointer<vtkPixel>::New();
+        break;
+      default:
+        cell = vtkSmartPointer<vtkVoxel>::New();
+    } // switch ( dim )
+
+    // Create storage for output scalar values
+    vtkSmartPointer<vtkDataArray> cellScalars;
+    cellScalars.TakeReference(this->InScalars->NewInstance());
+    cellScalars->SetNumberOfComponents(this->InScalars->GetNumberOfComponents());
+    cellScalars->SetNumberOfTuples(8);
+
+    vtkNew<vtkIdList> leaves;
+    vtkIdType currentId = 0;
+    vtkHyperTreeGridNonOrientedMooreSuperCursor* supercursor = tlSupercursor.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      // Initialize new Moore cursor at root of current tree
+      input->InitializeNonOrientedMooreSuperCursor(supercursor, trees[i]);
+      // Compute contours recursively
+      this->RecursivelyProcessTree(supercursor, cell, cellScalars, leaves, &helper, currentId);
+    } // i
+  });
+
+  // Set output, merging points across pieces in the order of the trees
+  double bounds[6];
+  input->GetBounds(bounds);
+  vtkNew<vtkPoints> newPts;
+  newPts->Allocate(estimatedSize, estimatedSize);
   if (!this->Locator)
   {
     // Create default locator if needed
     this->CreateDefaultLocator();
   }
-  this->Locator->InitPointInsertion(newPts, input->GetBounds(), estimatedSize);
-
-  vtkNew<vtkPointData> inPointData;
-  inPointData->PassData(input->GetCellData());
-
-  // Instantiate a contour helper for convenience, with triangle generation on
-  this->Helper = new vtkContourHelper(this->Locator, newVerts, newLines, newPolys, inPointData,
-    nullptr, output->GetPointData(), nullptr, estimatedSize, true);
-
-  // Create storage to keep track of selected cells
-  this->SelectedCells = vtkBitArray::New();
-  this->SelectedCells->SetNumberOfTuples(numCells);
-
-  // Initialize storage for signs and values
-  // NOLINTNEXTLINE(bugprone-sizeof-expression)
-  this->CellSigns = (vtkBitArray**)malloc(numContours * sizeof(*this->CellSigns));
-  this->Signs.resize(numContours, true);
-  for (int c = 0; c < numContours; ++c)
-  {
-    this->CellSigns[c] = vtkBitArray::New();
-    this->CellSigns[c]->SetNumberOfTuples(numCells);
-  }
-
-  // First pass across tree roots to evince cells intersected by contours
-  vtkIdType index;
-  vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-  input->InitializeTreeIterator(it);
-  vtkNew<vtkHyperTreeGridNonOrientedCursor> cursor;
-  while (it.GetNextTree(index))
-  {
-    // Initialize new grid cursor at root of current input tree
-    input->InitializeNonOrientedCursor(cursor, index);
-    // Pre-process tree recursively
-    this->RecursivelyPreProcessTree(cursor);
-  } // it
-
-  // Second pass across tree roots: now compute isocontours recursively
-  input->InitializeTreeIterator(it);
-  vtkNew<vtkHyperTreeGridNonOrientedMooreSuperCursor> supercursor;
-  while (it.GetNextTree(index))
-  {
-    // Initialize new Moore cursor at root of current tree
-    input->InitializeNonOrientedMooreSuperCursor(supercursor, index);
-    // Compute contours recursively
-    this->RecursivelyProcessTree(supercursor);
-  } // it
-
-  // Set output
-  output->SetPoints(newPts);
-  if (newVerts->GetNumberOfCells())
-  {
-    output->SetVerts(newVerts);
-  }
-  if (newLines->GetNumberOfCells())
-  {
-    output->SetLines(newLines);
-  }
-  if (newPolys->GetNumberOfCells())
-  {
-    output->SetPolys(newPolys);
-  }
-  newPolys->Delete();
+  this->Locator->InitPointInsertion(newPts, bounds, estimatedSize);
+  vtkHyperTreeGridMergePolyDataPieces(
+    pieces.GetOrderedPieces(), newPts, this->Locator, output, nullptr);
 
   // Clean up
-  this->SelectedCells->Delete();
-  for (vtkIdType c = 0; c < this->GetNumberOfContours(); ++c)
-  {
-    if (this->CellSigns[c])
-    {
-      this->CellSigns[c]->Delete();
-    }
-  } // c
-  free(this->CellSigns);
-  delete this->Helper;
-  this->CellScalars->Delete();
-  newPts->Delete();
-  newVerts->Delete();
-  newLines->Delete();
+  this->SelectedCells.clear();
+  this->CellSigns.clear();
   this->Locator->Initialize();
 
   // Squeeze output
@@ -413,12 +327,13 @@ int vtkHyperTreeGridContour::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObject
 }
 
 //------------------------------------------------------------------------------
-bool vtkHyperTreeGridContour::RecursivelyPreProcessTree(vtkHyperTreeGridNonOrientedCursor* cursor)
+bool vtkHyperTreeGridContour::RecursivelyPreProcessTree(
+  vtkHyperTreeGridNonOrientedCursor* cursor, std::vector<bool>& leafSigns)
 {
   // Retrieve global index of input cursor
   vtkIdType id = cursor->GetGlobalNodeIndex();
 
-  if (this->InGhostArray && this->InGhostArray->GetTuple1(id))
+  if (this->InGhostArray && this->InGhostArray->GetValue(id))
   {
     return false;
   }
@@ -440,7 +355,7 @@ bool vtkHyperTreeGridContour::RecursivelyPreProcessTree(vtkHyperTreeGridNonOrien
       cursor->ToChild(child);
 
       // Recurse and keep track of whether this branch is selected
-      selected |= this->RecursivelyPreProcessTree(cursor);
+      selected |= this->RecursivelyPreProcessTree(cursor, leafSigns);
 
       // Check if branch not completely selected
       if (!selected)
@@ -455,12 +370,12 @@ bool vtkHyperTreeGridContour::RecursivelyPreProcessTree(vtkHyperTreeGridNonOrien
           if (!child)
           {
             // Initialize sign array with sign of first child
-            signs[c] = (this->CellSigns[c]->GetTuple1(childId) != 0.0);
+            signs[c] = (this->CellSigns[c][childId] != 0);
           } // if ( ! child )
           else
           {
             // For subsequent children compare their sign with stored value
-            if (signs[c] != (this->CellSigns[c]->GetTuple1(childId) != 0.0))
+            if (signs[c] != (this->CellSigns[c][childId] != 0))
             {
               // A change of sign occurred, therefore cell must selected
               selected = true;
@@ -472,27 +387,27 @@ bool vtkHyperTreeGridContour::RecursivelyPreProcessTree(vtkHyperTreeGridNonOrien
       cursor->ToParent();
     } // child
   }
-  else if (!this->InGhostArray || !this->InGhostArray->GetTuple1(id))
+  else if (!this->InGhostArray || !this->InGhostArray->GetValue(id))
   {
     // Cursor is at leaf, retrieve its active scalar value
-    double val = this->InScalars->GetTuple1(id);
+    double val = this->InScalars->GetComponent(id, 0);
 
     // Iterate over all contours
     double* values = this->ContourValues->GetValues();
     for (int c = 0; c < numContours; ++c)
     {
-      this->Signs[c] = val > values[c];
+      leafSigns[c] = val > values[c];
     }
   } // else
 
   // Update list of selected cells
-  this->SelectedCells->SetTuple1(id, selected);
+  this->SelectedCells[id] = selected;
 
   // Set signs for all contours
   for (int c = 0; c < numContours; ++c)
   {
     // Parent cell has that of one of its children
-    this->CellSigns[c]->SetTuple1(id, this->Signs[c]);
+    this->CellSigns[c][id] = leafSigns[c];
   }
 
   // Return whether current node was fully selected
@@ -501,12 +416,13 @@ bool vtkHyperTreeGridContour::RecursivelyPreProcessTree(vtkHyperTreeGridNonOrien
 
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridContour::RecursivelyProcessTree(
-  vtkHyperTreeGridNonOrientedMooreSuperCursor* supercursor)
+  vtkHyperTreeGridNonOrientedMooreSuperCursor* supercursor, vtkCell* cell,
+  vtkDataArray* cellScalars, vtkIdList* leaves, vtkContourHelper* helper, vtkIdType& currentId)
 {
   // Retrieve global index of input cursor
   vtkIdType id = supercursor->GetGlobalNodeIndex();
 
-  if (this->InGhostArray && this->InGhostArray->GetTuple1(id))
+  if (this->InGhostArray && this->InGhostArray->GetValue(id))
   {
     return;
   }
@@ -523,7 +439,7 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
     for (vtkIdType c = 0; c < this->ContourValues->GetNumberOfContours() && !selected; ++c)
     {
       // Retrieve sign with respect to contour value at current cursor
-      bool sign = (this->CellSigns[c]->GetTuple1(id) != 0.0);
+      bool sign = (this->CellSigns[c][id] != 0);
 
       // Iterate over all cursors of Von Neumann neighborhood around center
       unsigned int nn = supercursor->GetNumberOfCursors() - 1;
@@ -536,9 +452,9 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
           vtkIdType idN = supercursor->GetGlobalNodeIndex(icursorN);
 
           // Decide whether neighbor was selected or must be retained because of a sign change
-          selected = this->SelectedCells->GetTuple1(idN) == 1 ||
-            ((this->CellSigns[c]->GetTuple1(idN) != 0.0) != sign) ||
-            (this->InGhostArray && this->InGhostArray->GetTuple1(idN));
+          selected = this->SelectedCells[idN] == 1 ||
+            ((this->CellSigns[c][idN] != 0) != sign) ||
+            (this->InGhostArray && this->InGhostArray->GetValue(idN));
         }
         else
         {
@@ -556,24 +472,24 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
         // Create child cursor from parent in input grid
         supercursor->ToChild(child);
         // Recurse
-        this->RecursivelyProcessTree(supercursor);
+        this->RecursivelyProcessTree(supercursor, cell, cellScalars, leaves, helper, currentId);
         supercursor->ToParent();
       }
     }
   }
-  else if ((!this->InMask || !this->InMask->GetTuple1(id)))
+  else if ((!this->InMask || !this->InMask->GetValue(id)))
   {
     // Cell is not masked, iterate over its corners
     unsigned int numLeavesCorners = 1 << dim;
     for (unsigned int cornerIdx = 0; cornerIdx < numLeavesCorners; ++cornerIdx)
     {
       bool owner = true;
-      this->Leaves->SetNumberOfIds(numLeavesCorners);
+      leaves->SetNumberOfIds(numLeavesCorners);
 
       // Iterate over every leaf touching the corner and check ownership
       for (unsigned int leafIdx = 0; leafIdx < numLeavesCorners && owner; ++leafIdx)
       {
-        owner = supercursor->GetCornerCursors(cornerIdx, leafIdx, this->Leaves);
+        owner = supercursor->GetCornerCursors(cornerIdx, leafIdx, leaves);
       } // leafIdx
 
       // If cell owns dual cell, compute contours thereof
@@ -582,27 +498,13 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
         vtkIdType numContours = this->ContourValues->GetNumberOfContours();
         double* values = this->ContourValues->GetValues();
 
-        // Generate contour topology depending on dimensionality
-        vtkCell* cell = nullptr;
-        switch (dim)
-        {
-          case 1:
-            cell = this->Line;
-            break;
-          case 2:
-            cell = this->Pixel;
-            break;
-          case 3:
-            cell = this->Voxel;
-        } // switch ( dim )
-
         // Iterate over cell corners
         double x[3];
         supercursor->GetPoint(x);
         for (unsigned int _cornerIdx = 0; _cornerIdx < numLeavesCorners; ++_cornerIdx)
         {
           // Get cursor corresponding to this corner
-          vtkIdType cursorId = this->Leaves->GetId(_cornerIdx);
+          vtkIdType cursorId = leaves->GetId(_cornerIdx);
 
           // Retrieve neighbor coordinates and store them
           supercursor->GetPoint(cursorId, x);
@@ -613,17 +515,17 @@ void vtkHyperTreeGridContour::RecursivelyProcessTree(
           cell->PointIds->SetId(_cornerIdx, idN);
 
           // Assign scalar value attached to this contour item
-          this->CellScalars->SetTuple(_cornerIdx, this->InScalars->GetTuple(idN));
+          cellScalars->SetTuple(_cornerIdx, idN, this->InScalars);
         } // cornerIdx
         // Compute cell isocontour for each isovalue
         for (int c = 0; c < numContours; ++c)
         {
-          this->Helper->Contour(cell, values[c], this->CellScalars, this->CurrentId);
+          helper->Contour(cell, values[c], cellScalars, currentId);
         } // c
 
         // Increment output cell counter
-        ++this->CurrentId;
+        ++currentId;
       } // if ( owner )
     }   // cornerIdx
-  }     // else if ( ! this->InMask || this->InMask->GetTuple1( id ) )
+  }     // else if ( ! this->InMask || this->InMask->GetValue( id ) )
 }
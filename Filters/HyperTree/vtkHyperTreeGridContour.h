@@ -23,6 +23,10 @@
  * value for the active scalar is within a specified range (inclusive).
  * The output remains a hyper tree grid.
  *
+ * The hyper trees are contoured concurrently with vtkSMPTools, points being
+ * merged with the locator in the order of the trees afterwards so that the
+ * output does not depend on the number of threads.
+ *
  * @sa
  * vtkHyperTreeGrid vtkHyperTreeGridAlgorithm vtkContourFilter
  *
@@ -44,16 +48,14 @@
 #include <vector> // For STL
 
 class vtkBitArray;
+class vtkCell;
 class vtkCellData;
 class vtkContourHelper;
 class vtkDataArray;
 class vtkHyperTreeGrid;
 class vtkIdList;
 class vtkIncrementalPointLocator;
-class vtkLine;
-class vtkPixel;
 class vtkUnsignedCharArray;
-class vtkVoxel;
 class vtkHyperTreeGridNonOrientedCursor;
 class vtkHyperTreeGridNonOrientedMooreSuperCursor;
 
@@ -113,14 +115,19 @@ protected:
   int ProcessTrees(vtkHyperTreeGrid*, vtkDataObject*) override;
 
   /**
-   * Recursively decide whether a cell is intersected by a contour
+   * Recursively decide whether a cell is intersected by a contour, leafSigns
+   * holding the signs of the last leaf met relative to the contour values
    */
-  bool RecursivelyPreProcessTree(vtkHyperTreeGridNonOrientedCursor*);
+  bool RecursivelyPreProcessTree(
+    vtkHyperTreeGridNonOrientedCursor*, std::vector<bool>& leafSigns);
 
   /**
-   * Recursively descend into tree down to leaves
+   * Recursively descend into tree down to leaves, contouring the dual cells
+   * with helper. cell, cellScalars and leaves are scratch storage of the
+   * calling thread, currentId the index of the next dual cell.
    */
-  void RecursivelyProcessTree(vtkHyperTreeGridNonOrientedMooreSuperCursor*);
+  void RecursivelyProcessTree(vtkHyperTreeGridNonOrientedMooreSuperCursor*, vtkCell* cell,
+    vtkDataArray* cellScalars, vtkIdList* leaves, vtkContourHelper* helper, vtkIdType& currentId);
 
   /**
    * Storage for contour values.
@@ -130,40 +137,18 @@ protected:
   /**
    * Storage for pre-selected cells to be processed
    */
-  vtkBitArray* SelectedCells;
+  std::vector<unsigned char> SelectedCells;
 
   /**
    * Sign of isovalue if cell not treated
    */
-  vtkBitArray** CellSigns;
+  std::vector<std::vector<unsigned char>> CellSigns;
 
   /**
    * Spatial locator to merge points.
    */
   vtkIncrementalPointLocator* Locator;
 
-  ///@{
-  /**
-   * Pointers needed to perform isocontouring
-   */
-  vtkContourHelper* Helper;
-  vtkDataArray* CellScalars;
-  vtkLine* Line;
-  vtkPixel* Pixel;
-  vtkVoxel* Voxel;
-  vtkIdList* Leaves;
-  ///@}
-
-  /**
-   * Storage for signs relative to current contour value
-   */
-  std::vector<bool> Signs;
-
-  /**
-   * Keep track of current index in output polydata
-   */
-  vtkIdType CurrentId;
-
   /**
    * Keep track of selected input scalars
    */
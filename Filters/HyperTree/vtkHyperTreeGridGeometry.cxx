@@ -24,6 +24,7 @@
 #include "vtkHyperTreeGridNonOrientedGeometryCursor.h"
 #include "vtkHyperTreeGridNonOrientedVonNeumannSuperCursor.h"
 #include "vtkHyperTreeGridOrientedGeometryCursor.h"
+#include "vtkHyperTreeGridSMPInternal.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
@@ -35,6 +36,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
@@ -52,17 +55,87 @@ static constexpr unsigned int EdgeIndices[3][2][4] = { { { 3, 11, 7, 8 }, { 1, 1
 
 constexpr unsigned char FULL_WORK_FACES = std::numeric_limits<unsigned char>::max();
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Generates the geometry of a range of hyper trees into a piece of output.
+// Each thread works on its own pieces, with its own points, cells and locator.
+struct GeometryWorker
+{
+  GeometryWorker(vtkHyperTreeGrid* input, vtkBitArray* pureMask, vtkDoubleArray* normals,
+    vtkDoubleArray* intercepts, vtkHyperTreeGridPolyDataPiece* piece, const double* bounds,
+    vtkIdType estimatedSize);
+
+  /**
+   * Recursively descend into tree down to leaves
+   */
+  void RecursivelyProcessTreeNot3D(vtkHyperTreeGridNonOrientedGeometryCursor*);
+  void RecursivelyProcessTree3D(vtkHyperTreeGridNonOrientedVonNeumannSuperCursor*, unsigned char);
+
+  /**
+   * Process 1D leaves and issue corresponding edges (lines)
+   */
+  void ProcessLeaf1D(vtkHyperTreeGridNonOrientedGeometryCursor*);
+
+  /**
+   * Process 2D leaves and issue corresponding faces (quads)
+   */
+  void ProcessLeaf2D(vtkHyperTreeGridNonOrientedGeometryCursor*);
+
+  /**
+   * Process 3D leaves and issue corresponding cells (voxels)
+   */
+  void ProcessLeaf3D(vtkHyperTreeGridNonOrientedVonNeumannSuperCursor*);
+
+  /**
+   * Helper method to generate a face based on its normal and offset from cursor origin
+   */
+  void AddFace(vtkIdType useId, const double* origin, const double* size, unsigned int offset,
+    unsigned int orientation, unsigned char hideEdge);
+
+  void AddFace2(vtkIdType inId, vtkIdType useId, const double* origin, const double* size,
+    unsigned int offset, unsigned int orientation, bool create = true);
+
+  /**
+   * Insert a vertex of a 3D face along with its edge flag. When points are
+   * merged, the flag of a point is the one of the first face using it.
+   */
+  vtkIdType InsertFacePoint(const double pt[3], unsigned char edgeFlag);
+
+  // Input grid parameters
+  vtkBitArray* Mask;
+  vtkBitArray* PureMask;
+  unsigned int Dimension;
+  unsigned int Orientation;
+  int BranchFactor;
+  bool HasInterface;
+  vtkDoubleArray* Normals;
+  vtkDoubleArray* Intercepts;
+
+  // Output piece, and input cell of each of its cells
+  vtkPoints* Points;
+  vtkCellArray* Cells;
+  std::vector<vtkIdType>* CellIds;
+  vtkSmartPointer<vtkIncrementalPointLocator> Locator;
+  vtkSmartPointer<vtkUnsignedCharArray> EdgeFlags;
+
+  // Storage for interface faces
+  vtkNew<vtkIdList> FaceIDs;
+  vtkNew<vtkPoints> FacePoints;
+  vtkIdType EdgesA[12];
+  vtkIdType EdgesB[12];
+  vtkNew<vtkIdTypeArray> FacesA;
+  vtkNew<vtkIdTypeArray> FacesB;
+  vtkNew<vtkDoubleArray> FaceScalarsA;
+  vtkNew<vtkDoubleArray> FaceScalarsB;
+};
+} // anonymous namespace
+
 vtkStandardNewMacro(vtkHyperTreeGridGeometry);
 
 //------------------------------------------------------------------------------
 vtkHyperTreeGridGeometry::vtkHyperTreeGridGeometry()
 {
-  // Create storage for corners of leaf cells
-  this->Points = vtkPoints::New();
-
-  // Create storage for untructured leaf cells
-  this->Cells = vtkCellArray::New();
-
   // Default dimension is 0
   this->Dimension = 0;
 
@@ -80,98 +153,16 @@ vtkHyperTreeGridGeometry::vtkHyperTreeGridGeometry()
   this->HasInterface = false;
   this->Normals = nullptr;
   this->Intercepts = nullptr;
-  this->FaceIDs = vtkIdList::New();
-  this->FacePoints = vtkPoints::New();
-  this->FacePoints->SetNumberOfPoints(4);
-  this->FacesA = vtkIdTypeArray::New();
-  this->FacesA->SetNumberOfComponents(2);
-  this->FacesB = vtkIdTypeArray::New();
-  this->FacesB->SetNumberOfComponents(2);
-  this->FaceScalarsA = vtkDoubleArray::New();
-  this->FaceScalarsA->SetNumberOfTuples(4);
-  this->FaceScalarsB = vtkDoubleArray::New();
-  this->FaceScalarsB->SetNumberOfTuples(4);
-
-  this->EdgeFlags = nullptr;
 }
 
 //------------------------------------------------------------------------------
-vtkHyperTreeGridGeometry::~vtkHyperTreeGridGeometry()
-{
-  if (this->Points)
-  {
-    this->Points->Delete();
-    this->Points = nullptr;
-  }
-
-  if (this->Cells)
-  {
-    this->Cells->Delete();
-    this->Cells = nullptr;
-  }
-
-  if (this->FacePoints)
-  {
-    this->FacePoints->Delete();
-    this->FacePoints = nullptr;
-  }
-
-  if (this->FaceIDs)
-  {
-    this->FaceIDs->Delete();
-    this->FaceIDs = nullptr;
-  }
-
-  if (this->FacesA)
-  {
-    this->FacesA->Delete();
-    this->FacesA = nullptr;
-  }
-
-  if (this->FacesB)
-  {
-    this->FacesB->Delete();
-    this->FacesB = nullptr;
-  }
-
-  if (this->FaceScalarsA)
-  {
-    this->FaceScalarsA->Delete();
-    this->FaceScalarsA = nullptr;
-  }
-
-  if (this->FaceScalarsB)
-  {
-    this->FaceScalarsB->Delete();
-    this->FaceScalarsB = nullptr;
-  }
-}
+vtkHyperTreeGridGeometry::~vtkHyperTreeGridGeometry() = default;
 
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridGeometry::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
 
-  if (this->Points)
-  {
-    os << indent << "Points:\n";
-    this->Points->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "Points: ( none )\n";
-  }
-
-  if (this->Cells)
-  {
-    os << indent << "Cells:\n";
-    this->Cells->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "Cells: ( none )\n";
-  }
-
   os << indent << "Dimension: " << this->Dimension << endl;
   os << indent << "Orientation: " << this->Orientation << endl;
   os << indent << "Merging: " << this->Merging << endl;
@@ -194,72 +185,6 @@ void vtkHyperTreeGridGeometry::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Intercepts: ( none )\n";
   }
-  if (this->FacePoints)
-  {
-    os << indent << ":\n";
-    this->FacePoints->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "FacePoints: ( none )\n";
-  }
-  if (this->FaceIDs)
-  {
-    os << indent << ":\n";
-    this->FaceIDs->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "FaceIDs: ( none )\n";
-  }
-  os << indent << "EdgesA:";
-  for (unsigned int i = 0; i < 12; ++i)
-  {
-    os << " " << EdgesA[i];
-  }
-  os << endl;
-  os << indent << "EdgesB:";
-  for (unsigned int i = 0; i < 12; ++i)
-  {
-    os << " " << EdgesB[i];
-  }
-  os << endl;
-  if (this->FacesA)
-  {
-    os << indent << ":\n";
-    this->FacesA->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "FacesA: ( none )\n";
-  }
-  if (this->FacesB)
-  {
-    os << indent << ":\n";
-    this->FacesB->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "FacesB: ( none )\n";
-  }
-  if (this->FaceScalarsA)
-  {
-    os << indent << ":\n";
-    this->FaceScalarsA->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "FaceScalarsA: ( none )\n";
-  }
-  if (this->FaceScalarsB)
-  {
-    os << indent << ":\n";
-    this->FaceScalarsB->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "FaceScalarsB: ( none )\n";
-  }
 }
 
 //------------------------------------------------------------------------------
@@ -289,7 +214,6 @@ int vtkHyperTreeGridGeometry::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObjec
   // Initialize output cell data
   this->InData = input->GetCellData();
   this->OutData = output->GetCellData();
-  this->OutData->CopyAllocate(this->InData);
 
   // Retrieve material mask
   this->Mask = input->HasMask() ? input->GetMask() : nullptr;
@@ -307,107 +231,128 @@ int vtkHyperTreeGridGeometry::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObjec
       vtkDoubleArray::SafeDownCast(this->InData->GetArray(input->GetInterfaceInterceptsName()));
   } // this->HasInterface
 
-  // Create storage for corners of leaf cells
-  if (this->Points)
-  {
-    this->Points->Delete();
+  // Points are merged with a locator, except in 2D where faces never share them
+  const bool merging = this->Merging && this->Dimension != 2;
+
+  // Build the geometry of ranges of hyper trees concurrently, each range into
+  // its own piece of output with its own locator, sized to the trees of the range
+  std::vector<vtkIdType> trees = vtkHyperTreeGridGetTreeIndices(input);
+  vtkHyperTreeGridPolyDataPieces pieces;
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedGeometryCursor> tlCursor;
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedVonNeumannSuperCursor> tlSuperCursor;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(trees.size()), [&](vtkIdType begin, vtkIdType end) {
+    double pieceBounds[6];
+    const vtkIdType pieceCells =
+      vtkHyperTreeGridGetTreesBounds(input, trees, begin, end, pieceBounds);
+    GeometryWorker worker(input, this->PureMask, this->Normals, this->Intercepts,
+      pieces.NewPiece(begin), merging ? pieceBounds : nullptr, pieceCells);
+    if (this->Dimension == 3)
+    {
+      vtkHyperTreeGridNonOrientedVonNeumannSuperCursor* cursor = tlSuperCursor.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // Initialize new cursor at root of current tree
+        // In 3 dimensions, von Neumann neighborhood information is needed
+        input->InitializeNonOrientedVonNeumannSuperCursor(cursor, trees[i]);
+        // Build geometry recursively
+        worker.RecursivelyProcessTree3D(cursor, FULL_WORK_FACES);
+      } // i
+    }
+    else
+    {
+      vtkHyperTreeGridNonOrientedGeometryCursor* cursor = tlCursor.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // Initialize new cursor at root of current tree
+        // Otherwise, geometric properties of the cells suffice
+        input->InitializeNonOrientedGeometryCursor(cursor, trees[i]);
+        // Build geometry recursively
+        worker.RecursivelyProcessTreeNot3D(cursor);
+      } // i
+    }   // else
+  });
+
+  // Set output geometry and topology, merging points across pieces if needed
+  vtkNew<vtkPoints> points;
+  if (merging)
+  {
+    double bounds[6];
+    input->GetBounds(bounds);
+    this->Locator = vtkMergePoints::New();
+    this->Locator->InitPointInsertion(points, bounds);
   }
-  this->Points = vtkPoints::New();
-
-  // Create storage for untructured leaf cells
-  if (this->Cells)
+  vtkHyperTreeGridMergePolyDataPieces(
+    pieces.GetOrderedPieces(), points, this->Locator, output, this->InData);
+  if (this->Locator)
   {
-    this->Cells->Delete();
+    this->Locator->Delete();
+    this->Locator = nullptr;
   }
-  this->Cells = vtkCellArray::New();
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+GeometryWorker::GeometryWorker(vtkHyperTreeGrid* input, vtkBitArray* pureMask,
+  vtkDoubleArray* normals, vtkDoubleArray* intercepts, vtkHyperTreeGridPolyDataPiece* piece,
+  const double* bounds, vtkIdType estimatedSize)
+{
+  this->Mask = input->HasMask() ? input->GetMask() : nullptr;
+  this->PureMask = pureMask;
+  this->Dimension = input->GetDimension();
+  this->Orientation = input->GetOrientation();
+  this->BranchFactor = static_cast<int>(input->GetBranchFactor());
+  this->HasInterface = input->GetHasInterface();
+  this->Normals = normals;
+  this->Intercepts = intercepts;
 
-  // JB Initialize a Locator
-  if (this->Merging)
+  // Edges in 1D, faces otherwise
+  this->Points = piece->Points;
+  this->Cells = this->Dimension == 1 ? piece->Lines : piece->Polys;
+  this->CellIds = this->Dimension == 1 ? &piece->LineIds : &piece->PolyIds;
+
+  // Points are merged within the piece when bounds are given
+  if (bounds)
   {
-    if (this->Locator)
-    {
-      this->Locator->Delete();
-    }
-    this->Locator = vtkMergePoints::New();
-    this->Locator->InitPointInsertion(this->Points, input->GetBounds());
+    this->Locator = vtkSmartPointer<vtkMergePoints>::New();
+    this->Locator->InitPointInsertion(this->Points, bounds, estimatedSize);
   }
 
-  // Iterate over all hyper trees
-  vtkIdType index;
-  vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-  input->InitializeTreeIterator(it);
   if (this->Dimension == 3)
   {
     // Flag used to hide edges when needed
-    this->EdgeFlags = vtkUnsignedCharArray::New();
+    this->EdgeFlags = vtkSmartPointer<vtkUnsignedCharArray>::New();
     this->EdgeFlags->SetName("vtkEdgeFlags");
     this->EdgeFlags->SetNumberOfComponents(1);
-
-    vtkPointData* outPointData = output->GetPointData();
-    outPointData->AddArray(this->EdgeFlags);
-    outPointData->SetActiveAttribute(this->EdgeFlags->GetName(), vtkDataSetAttributes::EDGEFLAG);
-
-    vtkNew<vtkHyperTreeGridNonOrientedVonNeumannSuperCursor> cursor;
-    while (it.GetNextTree(index))
-    {
-      // Initialize new cursor at root of current tree
-      // In 3 dimensions, von Neumann neighborhood information is needed
-      input->InitializeNonOrientedVonNeumannSuperCursor(cursor, index);
-      // Build geometry recursively
-      this->RecursivelyProcessTree3D(cursor, FULL_WORK_FACES);
-    } // it
-  }
-  else
-  {
-    vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
-    while (it.GetNextTree(index))
-    {
-      // Initialize new cursor at root of current tree
-      // Otherwise, geometric properties of the cells suffice
-      input->InitializeNonOrientedGeometryCursor(cursor, index);
-      // Build geometry recursively
-      this->RecursivelyProcessTreeNot3D(cursor);
-    } // it
-  }   // else
-
-  // Set output geometry and topology
-  output->SetPoints(this->Points);
-  if (this->Dimension == 1)
-  {
-    output->SetLines(this->Cells);
-  }
-  else
-  {
-    output->SetPolys(this->Cells);
+    piece->PointData->AddArray(this->EdgeFlags);
+    piece->PointData->SetActiveAttribute(
+      this->EdgeFlags->GetName(), vtkDataSetAttributes::EDGEFLAG);
   }
 
-  if (this->EdgeFlags)
-  {
-    this->EdgeFlags->Delete();
-    this->EdgeFlags = nullptr;
-  }
+  this->FacePoints->SetNumberOfPoints(4);
+  this->FacesA->SetNumberOfComponents(2);
+  this->FacesB->SetNumberOfComponents(2);
+  this->FaceScalarsA->SetNumberOfTuples(4);
+  this->FaceScalarsB->SetNumberOfTuples(4);
+}
 
-  if (this->Points)
-  {
-    this->Points->Delete();
-    this->Points = nullptr;
-  }
-  if (this->Cells)
+//------------------------------------------------------------------------------
+vtkIdType GeometryWorker::InsertFacePoint(const double pt[3], unsigned char edgeFlag)
+{
+  vtkIdType id;
+  if (!this->Locator)
   {
-    this->Cells->Delete();
-    this->Cells = nullptr;
+    id = this->Points->InsertNextPoint(pt);
   }
-
-  if (this->Locator)
+  else if (!this->Locator->InsertUniquePoint(pt, id))
   {
-    this->Locator->Delete();
-    this->Locator = nullptr;
+    return id;
   }
-  return 1;
+  this->EdgeFlags->InsertValue(id, edgeFlag);
+  return id;
 }
 
 //------------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::RecursivelyProcessTreeNot3D(
+void GeometryWorker::RecursivelyProcessTreeNot3D(
   vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
 {
   if (this->Mask ? this->Mask->GetValue(cursor->GetGlobalNodeIndex()) : false)
@@ -446,7 +391,7 @@ void vtkHyperTreeGridGeometry::RecursivelyProcessTreeNot3D(
 
 //------------------------------------------------------------------------------
 // JB Meme code que vtkAdaptativeDataSetSurfaceFiltre ??
-void vtkHyperTreeGridGeometry::ProcessLeaf1D(vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
+void GeometryWorker::ProcessLeaf1D(vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
 {
   // Cell at cursor center is a leaf, retrieve its global index
   vtkIdType inId = cursor->GetGlobalNodeIndex();
@@ -478,15 +423,15 @@ void vtkHyperTreeGridGeometry::ProcessLeaf1D(vtkHyperTreeGridNonOrientedGeometry
   }
 
   // Insert edge into 1D geometry
-  vtkIdType outId = this->Cells->InsertNextCell(2, ids);
+  this->Cells->InsertNextCell(2, ids);
 
-  // Copy edge data from that of the cell from which it comes
-  this->OutData->CopyData(this->InData, inId, outId);
+  // Keep track of the cell from which the edge comes
+  this->CellIds->push_back(inId);
 }
 
 //------------------------------------------------------------------------------
 // JB Meme code que vtkAdaptativeDataSetSurfaceFiltre ??
-void vtkHyperTreeGridGeometry::ProcessLeaf2D(vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
+void GeometryWorker::ProcessLeaf2D(vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
 
 {
   // Cell at cursor center is a leaf, retrieve its global index
@@ -509,7 +454,7 @@ void vtkHyperTreeGridGeometry::ProcessLeaf2D(vtkHyperTreeGridNonOrientedGeometry
 }
 
 //------------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::RecursivelyProcessTree3D(
+void GeometryWorker::RecursivelyProcessTree3D(
   vtkHyperTreeGridNonOrientedVonNeumannSuperCursor* cursor, unsigned char crtWorkFaces)
 {
   // FR Traitement specifique pour la maille fille centrale en raffinement 3
@@ -601,7 +546,7 @@ void vtkHyperTreeGridGeometry::RecursivelyProcessTree3D(
 
 //------------------------------------------------------------------------------
 // JB Meme code que vtkAdaptativeDataSetSurfaceFiltre ??
-void vtkHyperTreeGridGeometry::ProcessLeaf3D(
+void GeometryWorker::ProcessLeaf3D(
   vtkHyperTreeGridNonOrientedVonNeumannSuperCursor* superCursor)
 {
   // Cell at cursor center is a leaf, retrieve its global index, and mask
@@ -772,10 +717,10 @@ void vtkHyperTreeGridGeometry::ProcessLeaf3D(
       } // while ( edge0[0] != edge0[1] )
 
       // Create new face
-      vtkIdType outId = this->Cells->InsertNextCell(this->FaceIDs);
+      this->Cells->InsertNextCell(this->FaceIDs);
 
-      // Copy face data from that of the cell from which it comes
-      this->OutData->CopyData(this->InData, inId, outId);
+      // Keep track of the cell from which the face comes
+      this->CellIds->push_back(inId);
     } // if ( nA > 0 )
 
     // Create face B when its vertices are present
@@ -815,23 +760,21 @@ void vtkHyperTreeGridGeometry::ProcessLeaf3D(
       } // while ( edge0[0] != edge0[1] )
 
       // Create new face
-      vtkIdType outId = this->Cells->InsertNextCell(this->FaceIDs);
+      this->Cells->InsertNextCell(this->FaceIDs);
 
-      // Copy face data from that of the cell from which it comes
-      this->OutData->CopyData(this->InData, inId, outId);
+      // Keep track of the cell from which the face comes
+      this->CellIds->push_back(inId);
     } // if ( nB > 0 )
   }   // if ( this->HasInterface )
 }
 
 //------------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::AddFace(vtkIdType useId, const double* origin, const double* size,
+void GeometryWorker::AddFace(vtkIdType useId, const double* origin, const double* size,
   unsigned int offset, unsigned int orientation, unsigned char hideEdge)
 {
   // Reading edge flag encoded in binary, each bit corresponding to an edge of the constructed face.
-  this->EdgeFlags->InsertNextValue((hideEdge & 4) != 0);
-  this->EdgeFlags->InsertNextValue((hideEdge & 2) != 0);
-  this->EdgeFlags->InsertNextValue((hideEdge & 8) != 0);
-  this->EdgeFlags->InsertNextValue((hideEdge & 1) != 0);
+  const unsigned char edgeFlags[] = { (hideEdge & 4) != 0, (hideEdge & 2) != 0,
+    (hideEdge & 8) != 0, (hideEdge & 1) != 0 };
 
   double pt[] = { 0., 0., 0. };
 
@@ -848,16 +791,16 @@ void vtkHyperTreeGridGeometry::AddFace(vtkIdType useId, const double* origin, co
       // Offset point coordinate as needed
       pt[orientation] += size[orientation];
     }
-    this->Locator->InsertUniquePoint(pt, ids[0]);
+    ids[0] = this->InsertFacePoint(pt, edgeFlags[0]);
     // Create other face vertices depending on orientation
     unsigned int axis1 = orientation ? 0 : 1;
     unsigned int axis2 = orientation == 2 ? 1 : 2;
     pt[axis1] += size[axis1];
-    this->Locator->InsertUniquePoint(pt, ids[1]);
+    ids[1] = this->InsertFacePoint(pt, edgeFlags[1]);
     pt[axis2] += size[axis2];
-    this->Locator->InsertUniquePoint(pt, ids[2]);
+    ids[2] = this->InsertFacePoint(pt, edgeFlags[2]);
     pt[axis1] = origin[axis1];
-    this->Locator->InsertUniquePoint(pt, ids[3]);
+    ids[3] = this->InsertFacePoint(pt, edgeFlags[3]);
   }
   else
   {
@@ -866,7 +809,7 @@ void vtkHyperTreeGridGeometry::AddFace(vtkIdType useId, const double* origin, co
       // Offset point coordinate as needed
       pt[orientation] += size[orientation];
     }
-    ids[0] = this->Points->InsertNextPoint(pt);
+    ids[0] = this->InsertFacePoint(pt, edgeFlags[0]);
 #ifdef TRACE
     cerr << "Point #" << ids[0] << " : ";
     for (unsigned int ipt = 0; ipt < 3; ++ipt)
@@ -879,7 +822,7 @@ void vtkHyperTreeGridGeometry::AddFace(vtkIdType useId, const double* origin, co
     unsigned int axis1 = (orientation + 1) % 3;
     unsigned int axis2 = (orientation + 2) % 3;
     pt[axis1] += size[axis1];
-    ids[1] = this->Points->InsertNextPoint(pt);
+    ids[1] = this->InsertFacePoint(pt, edgeFlags[1]);
 #ifdef TRACE
     cerr << "Point #" << ids[1] << " : ";
     for (unsigned int ipt = 0; ipt < 3; ++ipt)
@@ -889,7 +832,7 @@ void vtkHyperTreeGridGeometry::AddFace(vtkIdType useId, const double* origin, co
     cerr << std::endl;
 #endif
     pt[axis2] += size[axis2];
-    ids[2] = this->Points->InsertNextPoint(pt);
+    ids[2] = this->InsertFacePoint(pt, edgeFlags[2]);
 #ifdef TRACE
     cerr << "Point #" << ids[2] << " : ";
     for (unsigned int ipt = 0; ipt < 3; ++ipt)
@@ -899,7 +842,7 @@ void vtkHyperTreeGridGeometry::AddFace(vtkIdType useId, const double* origin, co
     cerr << std::endl;
 #endif
     pt[axis1] = origin[axis1];
-    ids[3] = this->Points->InsertNextPoint(pt);
+    ids[3] = this->InsertFacePoint(pt, edgeFlags[3]);
 #ifdef TRACE
     cerr << "Point #" << ids[3] << " : ";
     for (unsigned int ipt = 0; ipt < 3; ++ipt)
@@ -917,13 +860,13 @@ void vtkHyperTreeGridGeometry::AddFace(vtkIdType useId, const double* origin, co
   }
 
   // Insert next face
-  vtkIdType outId = this->Cells->InsertNextCell(4, ids);
+  this->Cells->InsertNextCell(4, ids);
 
-  // Copy face data from that of the cell from which it comes
-  this->OutData->CopyData(this->InData, useId, outId);
+  // Keep track of the cell from which the face comes
+  this->CellIds->push_back(useId);
 }
 //------------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::AddFace2(vtkIdType inId, vtkIdType useId, const double* origin,
+void GeometryWorker::AddFace2(vtkIdType inId, vtkIdType useId, const double* origin,
   const double* size, unsigned int offset, unsigned int orientation, bool create)
 {
   // First cell vertex is always at origin of cursor
@@ -946,7 +889,8 @@ void vtkHyperTreeGridGeometry::AddFace2(vtkIdType inId, vtkIdType useId, const d
   if (this->HasInterface)
   {
     // Retrieve intercept tuple and type
-    double* inter = this->Intercepts->GetTuple(inId);
+    double inter[3];
+    this->Intercepts->GetTypedTuple(inId, inter);
     double type = inter[2];
 
     // Distinguish cases depending on intercept type
@@ -963,7 +907,8 @@ void vtkHyperTreeGridGeometry::AddFace2(vtkIdType inId, vtkIdType useId, const d
 
       // Create interface intersection faces
       double coordsA[3];
-      double* normal = this->Normals->GetTuple(inId);
+      double normal[3];
+      this->Normals->GetTypedTuple(inId, normal);
       for (vtkIdType pId = 0; pId < 4; ++pId)
       {
         // Retrieve vertex coordinates
@@ -1255,9 +1200,9 @@ void vtkHyperTreeGridGeometry::AddFace2(vtkIdType inId, vtkIdType useId, const d
   if (create)
   {
     // Create cell and corresponding ID
-    vtkIdType outId = this->Cells->InsertNextCell(nPts, ids);
+    this->Cells->InsertNextCell(nPts, ids);
 
-    // Copy face data from that of the cell from which it comes
-    this->OutData->CopyData(this->InData, useId, outId);
+    // Keep track of the cell from which the face comes
+    this->CellIds->push_back(useId);
   } // if ( create )
 }
@@ -16,6 +16,9 @@
  * @class   vtkHyperTreeGridGeometry
  * @brief   Hyper tree grid outer surface
  *
+ * The hyper trees are processed concurrently with vtkSMPTools, the output
+ * does not depend on the number of threads.
+ *
  * @sa
  * vtkHyperTreeGrid vtkHyperTreeGridAlgorithm
  *
@@ -35,16 +38,9 @@
 #include "vtkHyperTreeGridAlgorithm.h"
 
 class vtkBitArray;
-class vtkCellArray;
 class vtkDoubleArray;
 class vtkHyperTreeGrid;
-class vtkHyperTreeGridNonOrientedGeometryCursor;
-class vtkHyperTreeGridNonOrientedVonNeumannSuperCursor;
-class vtkIdList;
-class vtkIdTypeArray;
 class vtkIncrementalPointLocator;
-class vtkPoints;
-class vtkUnsignedCharArray;
 
 class VTKFILTERSHYPERTREE_EXPORT vtkHyperTreeGridGeometry : public vtkHyperTreeGridAlgorithm
 {
@@ -77,36 +73,6 @@ protected:
    */
   int ProcessTrees(vtkHyperTreeGrid*, vtkDataObject*) override;
 
-  /**
-   * Recursively descend into tree down to leaves
-   */
-  void RecursivelyProcessTreeNot3D(vtkHyperTreeGridNonOrientedGeometryCursor*);
-  void RecursivelyProcessTree3D(vtkHyperTreeGridNonOrientedVonNeumannSuperCursor*, unsigned char);
-
-  /**
-   * Process 1D leaves and issue corresponding edges (lines)
-   */
-  void ProcessLeaf1D(vtkHyperTreeGridNonOrientedGeometryCursor*);
-
-  /**
-   * Process 2D leaves and issue corresponding faces (quads)
-   */
-  void ProcessLeaf2D(vtkHyperTreeGridNonOrientedGeometryCursor*);
-
-  /**
-   * Process 3D leaves and issue corresponding cells (voxels)
-   */
-  void ProcessLeaf3D(vtkHyperTreeGridNonOrientedVonNeumannSuperCursor*);
-
-  /**
-   * Helper method to generate a face based on its normal and offset from cursor origin
-   */
-  void AddFace(vtkIdType useId, const double* origin, const double* size, unsigned int offset,
-    unsigned int orientation, unsigned char hideEdge);
-
-  void AddFace2(vtkIdType inId, vtkIdType useId, const double* origin, const double* size,
-    unsigned int offset, unsigned int orientation, bool create = true);
-
   /**
    * material Mask
    */
@@ -132,16 +98,6 @@ protected:
    */
   int BranchFactor;
 
-  /**
-   * Storage for points of output unstructured mesh
-   */
-  vtkPoints* Points;
-
-  /**
-   * Storage for cells of output unstructured mesh
-   */
-  vtkCellArray* Cells;
-
   /**
    *JB Un locator est utilise afin de produire un maillage avec moins
    *JB de points. Le gain en 3D est de l'ordre d'un facteur 4 !
@@ -154,24 +110,6 @@ protected:
   vtkDoubleArray* Normals;
   vtkDoubleArray* Intercepts;
 
-  vtkIdList* FaceIDs;
-  vtkPoints* FacePoints;
-
-  vtkIdType EdgesA[12];
-  vtkIdType EdgesB[12];
-
-  vtkIdTypeArray* FacesA;
-  vtkIdTypeArray* FacesB;
-
-  vtkDoubleArray* FaceScalarsA;
-  vtkDoubleArray* FaceScalarsB;
-
-  /**
-   * Array used to hide edges
-   * left by masked cells.
-   */
-  vtkUnsignedCharArray* EdgeFlags;
-
 private:
   vtkHyperTreeGridGeometry(const vtkHyperTreeGridGeometry&) = delete;
   void operator=(const vtkHyperTreeGridGeometry&) = delete;
@@ -23,6 +23,7 @@
 #include "vtkHyperTreeGrid.h"
 #include "vtkHyperTreeGridNonOrientedGeometryCursor.h"
 #include "vtkHyperTreeGridNonOrientedMooreSuperCursor.h"
+#include "vtkHyperTreeGridSMPInternal.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkMath.h"
@@ -31,6 +32,8 @@
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <cassert>
@@ -49,61 +52,15 @@ vtkStandardNewMacro(vtkHyperTreeGridPlaneCutter);
 //------------------------------------------------------------------------------
 vtkHyperTreeGridPlaneCutter::vtkHyperTreeGridPlaneCutter()
 {
-  this->Points = nullptr;
-  this->Cells = nullptr;
-
   // Initialize plane parameters
   std::fill(this->Plane, this->Plane + 4, 0.);
 
   // By default a non-conforming output mesh is produced for better rendering
   this->Dual = 0;
-
-  // By default member variables for dual-based computation are not used
-  this->SelectedCells = nullptr;
-  this->Centers = nullptr;
-  this->Cutter = nullptr;
-  this->Leaves = nullptr;
 }
 
 //------------------------------------------------------------------------------
-vtkHyperTreeGridPlaneCutter::~vtkHyperTreeGridPlaneCutter()
-{
-  if (this->Points)
-  {
-    this->Points->Delete();
-    this->Points = nullptr;
-  }
-
-  if (this->Cells)
-  {
-    this->Cells->Delete();
-    this->Cells = nullptr;
-  }
-
-  if (this->Leaves)
-  {
-    this->Leaves->Delete();
-    this->Leaves = nullptr;
-  }
-
-  if (this->Centers)
-  {
-    this->Centers->Delete();
-    this->Centers = nullptr;
-  }
-
-  if (this->Cutter)
-  {
-    this->Cutter->Delete();
-    this->Cutter = nullptr;
-  }
-
-  if (this->SelectedCells)
-  {
-    this->SelectedCells->Delete();
-    this->SelectedCells = nullptr;
-  }
-}
+vtkHyperTreeGridPlaneCutter::~vtkHyperTreeGridPlaneCutter() = default;
 
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridPlaneCutter::PrintSelf(ostream& os, vtkIndent indent)
@@ -121,56 +78,6 @@ void vtkHyperTreeGridPlaneCutter::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Dual: No\n";
   }
-
-  if (this->Points)
-  {
-    os << indent << "Points:\n";
-    this->Points->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "Points: ( none )\n";
-  }
-
-  if (this->Cells)
-  {
-    os << indent << "Cells:\n";
-    this->Cells->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "Cells: ( none )\n";
-  }
-
-  if (this->Leaves)
-  {
-    os << indent << "Leaves:\n";
-    this->Leaves->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "Leaves: ( none )\n";
-  }
-
-  if (this->Centers)
-  {
-    os << indent << "Centers:\n";
-    this->Centers->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "Centers: ( none )\n";
-  }
-
-  if (this->Cutter)
-  {
-    os << indent << "Cutter:\n";
-    this->Cutter->PrintSelf(os, indent.GetNextIndent());
-  }
-  else
-  {
-    os << indent << "Cutter: ( none )\n";
-  }
 }
 
 //------------------------------------------------------------------------------
@@ -183,33 +90,7 @@ int vtkHyperTreeGridPlaneCutter::FillOutputPortInformation(int, vtkInformation*
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridPlaneCutter::Reset()
 {
-  // Points and Cells are created in the constructor
-  if (this->Points)
-  {
-    this->Points->Delete();
-  }
-  this->Points = vtkPoints::New();
-  if (this->Cells)
-  {
-    this->Cells->Delete();
-  }
-  this->Cells = vtkCellArray::New();
-  if (this->Centers)
-  {
-    this->Centers->Initialize();
-  }
-  if (this->Leaves)
-  {
-    this->Leaves->Initialize();
-  }
-  if (this->Cutter)
-  {
-    this->Cutter->SetNumberOfContours(0);
-  }
-  if (this->SelectedCells)
-  {
-    this->SelectedCells->Initialize();
-  }
+  this->SelectedCells.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -239,27 +120,13 @@ int vtkHyperTreeGridPlaneCutter::ProcessTrees(vtkHyperTreeGrid* input, vtkDataOb
   // Retrieve material mask
   this->InMask = input->HasMask() ? input->GetMask() : nullptr;
 
-  // Compute cut on dual or primal input depending on specification
+  // Compute cut on dual or primal input depending on specification, each
+  // range of trees being cut into its own piece of output
+  std::vector<vtkIdType> trees = vtkHyperTreeGridGetTreeIndices(input);
+  const vtkIdType numTrees = static_cast<vtkIdType>(trees.size());
+  vtkHyperTreeGridPolyDataPieces pieces;
   if (this->Dual)
   {
-    // Initialize output point data
-    this->OutData = output->GetPointData();
-    this->OutData->CopyAllocate(this->InData);
-
-    // Storage for leaf indices
-    if (this->Leaves == nullptr)
-    {
-      this->Leaves = vtkIdList::New();
-    }
-    this->Leaves->SetNumberOfIds(8);
-
-    // Initialize storage for dual geometry
-    if (this->Centers == nullptr)
-    {
-      this->Centers = vtkPoints::New();
-    }
-    this->Centers->SetNumberOfPoints(8);
-
     // Convert plane parameters into normal/origin specification
     unsigned int maxId = 0;
     if (fabs(this->Plane[1]) > fabs(this->Plane[0]))
@@ -272,89 +139,84 @@ int vtkHyperTreeGridPlaneCutter::ProcessTrees(vtkHyperTreeGrid* input, vtkDataOb
     }
     double origin[] = { 0., 0., 0. };
     origin[maxId] = this->Plane[3] / this->Plane[maxId];
-    vtkPlane* plane = vtkPlane::New();
-    plane->SetOrigin(origin);
-    plane->SetNormal(this->Plane[0], this->Plane[1], this->Plane[2]);
 
-    // Initialize plane cutter
-    if (this->Cutter == nullptr)
-    {
-      this->Cutter = vtkCutter::New();
-    }
-    this->Cutter->GenerateTrianglesOff();
-    this->Cutter->SetCutFunction(plane);
-
-    // Clean up
-    plane->Delete();
-
-    // Create storage to keep track of selected cells
-    if (this->SelectedCells == nullptr)
-    {
-      this->SelectedCells = vtkBitArray::New();
-    }
+    // Create storage to keep track of selected cells, one byte per cell so
+    // that distinct trees can be processed concurrently. Initialization is
+    // needed because not all cells are pre-processed
     vtkIdType numCells = input->GetNumberOfVertices();
-    this->SelectedCells->SetNumberOfTuples(numCells);
-    for (vtkIdType i = 0; i < numCells; ++i)
-    {
-      // Initialization is needed because not all cells are pre-processed
-      this->SelectedCells->SetValue(i, 0);
-    }
+    this->SelectedCells.assign(numCells, 0);
 
     // First pass across tree roots to evince cells intersected by contours
-    vtkIdType index;
-    vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-    input->InitializeTreeIterator(it);
-    vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
-    while (it.GetNextTree(index))
-    {
-      // Initialize new geometric cursor at root of current input tree
-      input->InitializeNonOrientedGeometryCursor(cursor, index);
-      // Pre-process tree recursively
-      this->RecursivelyPreProcessTree(cursor);
-    } // it
+    vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedGeometryCursor> tlCursor;
+    vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+      vtkHyperTreeGridNonOrientedGeometryCursor* cursor = tlCursor.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // Initialize new geometric cursor at root of current input tree
+        input->InitializeNonOrientedGeometryCursor(cursor, trees[i]);
+        // Pre-process tree recursively
+        this->RecursivelyPreProcessTree(cursor);
+      } // i
+    });
 
     // Second pass across tree roots: now compute isocontours recursively
-    input->InitializeTreeIterator(it);
-    vtkNew<vtkHyperTreeGridNonOrientedMooreSuperCursor> supercursor;
-    while (it.GetNextTree(index))
-    {
-      // Initialize new Moore cursor at root of current tree
-      input->InitializeNonOrientedMooreSuperCursor(supercursor, index);
-      // Generate leaf cell centers recursively
-      this->RecursivelyProcessTreeDual(supercursor);
-    } // it
+    vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedMooreSuperCursor> tlSupercursor;
+    vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+      vtkHyperTreeGridPolyDataPiece* piece = pieces.NewPiece(begin);
+      piece->PointData->CopyAllocate(this->InData);
+
+      // Storage for leaf indices
+      vtkNew<vtkIdList> leaves;
+      leaves->SetNumberOfIds(8);
+
+      // Initialize storage for dual geometry
+      vtkNew<vtkPoints> centers;
+      centers->SetNumberOfPoints(8);
+
+      // Initialize plane cutter
+      vtkNew<vtkPlane> plane;
+      plane->SetOrigin(origin);
+      plane->SetNormal(this->Plane[0], this->Plane[1], this->Plane[2]);
+      vtkNew<vtkCutter> cutter;
+      cutter->GenerateTrianglesOff();
+      cutter->SetCutFunction(plane);
+
+      vtkHyperTreeGridNonOrientedMooreSuperCursor* supercursor = tlSupercursor.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // Initialize new Moore cursor at root of current tree
+        input->InitializeNonOrientedMooreSuperCursor(supercursor, trees[i]);
+        // Generate leaf cell centers recursively
+        this->RecursivelyProcessTreeDual(
+          supercursor, cutter, centers, leaves, piece->Points, piece->Polys, piece->PointData);
+      } // i
+    });
 
     // Clean up
-    this->SelectedCells->Delete();
-    this->SelectedCells = nullptr;
+    this->SelectedCells.clear();
   } // if ( this->Dual )
   else
   {
-    // Initialize output cell data
-    this->OutData = output->GetCellData();
-    this->OutData->CopyAllocate(this->InData);
-
     // Iterate over all hyper trees
-    vtkIdType index;
-    vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-    input->InitializeTreeIterator(it);
-    vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
-    while (it.GetNextTree(index))
-    {
-      // Initialize new geometric cursor at root of current tree
-      input->InitializeNonOrientedGeometryCursor(cursor, index);
-      // Generate leaf cell centers recursively
-      this->RecursivelyProcessTreePrimal(cursor);
-    } // it
-  }   // else
-
-  // Set output geometry and topology
-  output->SetPoints(this->Points);
-  this->Points->FastDelete();
-  this->Points = nullptr;
-  output->SetPolys(this->Cells);
-  this->Cells->FastDelete();
-  this->Cells = nullptr;
+    vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedGeometryCursor> tlCursor;
+    vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+      vtkHyperTreeGridPolyDataPiece* piece = pieces.NewPiece(begin);
+      vtkHyperTreeGridNonOrientedGeometryCursor* cursor = tlCursor.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // Initialize new geometric cursor at root of current tree
+        input->InitializeNonOrientedGeometryCursor(cursor, trees[i]);
+        // Generate leaf cell centers recursively
+        this->RecursivelyProcessTreePrimal(cursor, piece->Points, piece->Polys, piece->PolyIds);
+      } // i
+    });
+  } // else
+
+  // Set output geometry and topology, with point data in dual mode and cell
+  // data otherwise
+  vtkNew<vtkPoints> points;
+  vtkHyperTreeGridMergePolyDataPieces(
+    pieces.GetOrderedPieces(), points, nullptr, output, this->Dual ? nullptr : this->InData);
 
   // Clean and squeeze output
   vtkCleanPolyData* cleaner = vtkCleanPolyData::New();
@@ -369,7 +231,8 @@ int vtkHyperTreeGridPlaneCutter::ProcessTrees(vtkHyperTreeGrid* input, vtkDataOb
 
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreePrimal(
-  vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
+  vtkHyperTreeGridNonOrientedGeometryCursor* cursor, vtkPoints* points, vtkCellArray* cells,
+  std::vector<vtkIdType>& cellIds)
 {
   // If cursor is at a masked cell stop recursion
   vtkIdType inId = cursor->GetGlobalNodeIndex();
@@ -438,7 +301,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreePrimal(
       int n = 0;
 
       // Storage for intersection points
-      double points[8][3];
+      double cutPoints[8][3];
 
       // Iterate over cell vertices
       for (int i = 0; i < 8; ++i)
@@ -447,7 +310,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreePrimal(
         if (std::abs(functEval[i]) < SQRT_DBL_EPSILON)
         {
           // If current vertex is intersected then save it
-          memcpy(points[n], cellCoords[i], 3 * sizeof(double));
+          memcpy(cutPoints[n], cellCoords[i], 3 * sizeof(double));
           ++n;
         }
         else
@@ -456,37 +319,37 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreePrimal(
           if (!(i & 1) && functEval[i] * functEval[i + 1] < 0)
           {
             // Edge in X
-            this->PlaneCut(i, i + 1, cellCoords, n, points);
+            this->PlaneCut(i, i + 1, cellCoords, n, cutPoints);
           }
           if (!(i & 2) && functEval[i] * functEval[i + 2] < 0)
           {
             // Edge in Y
-            this->PlaneCut(i, i + 2, cellCoords, n, points);
+            this->PlaneCut(i, i + 2, cellCoords, n, cutPoints);
           }
           if (!(i & 4) && functEval[i] * functEval[i + 4] < 0)
           {
             // Edge in Z
-            this->PlaneCut(i, i + 4, cellCoords, n, points);
+            this->PlaneCut(i, i + 4, cellCoords, n, cutPoints);
           }
         } // else
       }   // i
 
       // Now reorder points if necessary
-      this->ReorderCutPoints(n, points);
+      this->ReorderCutPoints(n, cutPoints);
 
       // Storage for face vertex IDs
       vtkIdType ids[8];
       for (int i = 0; i < n; ++i)
       {
         // Save points and get their IDs
-        ids[i] = this->Points->InsertNextPoint(points[i]);
+        ids[i] = points->InsertNextPoint(cutPoints[i]);
       }
 
       // Insert next face
-      vtkIdType outId = this->Cells->InsertNextCell(n, ids);
+      cells->InsertNextCell(n, ids);
 
-      // Copy face data from that of the cell from which it comes
-      this->OutData->CopyData(this->InData, inId, outId);
+      // Keep track of the cell from which it comes
+      cellIds.push_back(inId);
     } // if ( cursor->IsLeaf() )
     else
     {
@@ -496,7 +359,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreePrimal(
       {
         cursor->ToChild(ichild);
         // Recurse
-        this->RecursivelyProcessTreePrimal(cursor);
+        this->RecursivelyProcessTreePrimal(cursor, points, cells, cellIds);
         cursor->ToParent();
       } // ichild
     }   // else
@@ -553,7 +416,7 @@ bool vtkHyperTreeGridPlaneCutter::RecursivelyPreProcessTree(
   }     // if ( this->CheckIntersection )
 
   // Update list of selected cells
-  this->SelectedCells->SetTuple1(id, selected);
+  this->SelectedCells[id] = selected;
 
   // Return whether current node was selected
   return selected;
@@ -561,7 +424,8 @@ bool vtkHyperTreeGridPlaneCutter::RecursivelyPreProcessTree(
 
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
-  vtkHyperTreeGridNonOrientedMooreSuperCursor* cursor)
+  vtkHyperTreeGridNonOrientedMooreSuperCursor* cursor, vtkCutter* cutter, vtkPoints* centers,
+  vtkIdList* leaves, vtkPoints* points, vtkCellArray* cells, vtkPointData* outData)
 {
   // If cursor is at a masked cell stop recursion
   vtkIdType id = cursor->GetGlobalNodeIndex();
@@ -574,7 +438,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
   if (!cursor->IsLeaf())
   {
     // Check if cursor is at selected cell
-    if (!this->SelectedCells->GetTuple1(id))
+    if (!this->SelectedCells[id])
     {
       // Cell is not selected until proven otherwise
       bool selected = false;
@@ -589,7 +453,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
           vtkIdType idN = cursor->GetGlobalNodeIndex(indN);
 
           // Decide whether neighbor was selected
-          selected = (this->SelectedCells->GetTuple1(idN) != 0.0);
+          selected = (this->SelectedCells[idN] != 0);
         }
         else
         {
@@ -602,7 +466,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
       {
         return;
       }
-    } // if ( this->SelectedCells->GetTuple1( id ) )
+    } // if ( ! this->SelectedCells[id] )
 
     // Recurse to all children
     int numChildren = cursor->GetNumberOfChildren();
@@ -610,7 +474,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
     {
       cursor->ToChild(ichild);
       // Recurse
-      this->RecursivelyProcessTreeDual(cursor);
+      this->RecursivelyProcessTreeDual(cursor, cutter, centers, leaves, points, cells, outData);
       cursor->ToParent();
     } // ichild
   }   // if ( ! cursor->IsLeaf() )
@@ -625,7 +489,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
       // Iterate over every leaf touching the corner and check ownership
       for (unsigned int leafIdx = 0; leafIdx < 8 && owner; ++leafIdx)
       {
-        owner = cursor->GetCornerCursors(cornerIdx, leafIdx, this->Leaves);
+        owner = cursor->GetCornerCursors(cornerIdx, leafIdx, leaves);
       } // leafIdx
 
       // If cell owns dual cell, compute intersection thereof
@@ -642,11 +506,11 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
         for (int _cornerIdx = 0; _cornerIdx < 8; ++_cornerIdx)
         {
           // Get cursor corresponding to this corner
-          vtkIdType cursorId = this->Leaves->GetId(_cornerIdx);
+          vtkIdType cursorId = leaves->GetId(_cornerIdx);
 
           // Retrieve neighbor coordinates and store them
           cursor->GetPoint(cursorId, x);
-          this->Centers->SetPoint(_cornerIdx, x);
+          centers->SetPoint(_cornerIdx, x);
 
           // Retrieve neighbor index and corresponding input scalar value
           vtkIdType idN = cursor->GetGlobalNodeIndex(cursorId);
@@ -656,14 +520,14 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
         } // _cornerIdx
 
         // Assign geometry of dual cell
-        dual->SetPoints(this->Centers);
+        dual->SetPoints(centers);
 
         // Compute intersection with plane
-        this->Cutter->SetInputData(dual);
-        this->Cutter->Update();
+        cutter->SetInputData(dual);
+        cutter->Update();
 
         // Append computed polygons if some are present in cutter output
-        vtkPolyData* pd = this->Cutter->GetOutput();
+        vtkPolyData* pd = cutter->GetOutput();
         vtkIdType nPoints = pd->GetNumberOfPoints();
         if (nPoints)
         {
@@ -671,16 +535,16 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
           vtkPointData* pdata = pd->GetPointData();
 
           // Append new points to existing cut points
-          vtkIdType offset = this->Points->GetNumberOfPoints();
+          vtkIdType offset = points->GetNumberOfPoints();
           double pt[3];
           for (vtkIdType i = 0; i < nPoints; ++i)
           {
             // Retrieve cut point coordinates and insert them into output points
             pd->GetPoint(i, pt);
-            this->Points->InsertNextPoint(pt);
+            points->InsertNextPoint(pt);
 
             // Copy cut point data to that of corresponding output point
-            this->OutData->CopyData(pdata, i, i + offset);
+            outData->CopyData(pdata, i, i + offset);
           } // i
 
           // Append new elements to existing cut element
@@ -699,7 +563,7 @@ void vtkHyperTreeGridPlaneCutter::RecursivelyProcessTreeDual(
             } // j
 
             // Insert next cell with offset ids
-            this->Cells->InsertNextCell(n, ids);
+            cells->InsertNextCell(n, ids);
           } // i
         }   // if ( nPoints )
 
@@ -27,6 +27,9 @@
  * cost of interpolation to the dual of the input AMR mesh, and therefore
  * of missing intersection plane pieces near the primal boundary.
  *
+ * The hyper trees are cut concurrently with vtkSMPTools, the pieces of cut
+ * surface being appended in the order of the trees.
+ *
  * @sa
  * vtkHyperTreeGrid vtkHyperTreeGridAlgorithm
  *
@@ -43,9 +46,12 @@
 #include "vtkFiltersHyperTreeModule.h" // For export macro
 #include "vtkHyperTreeGridAlgorithm.h"
 
+#include <vector> // For std::vector
+
 class vtkCellArray;
 class vtkCutter;
 class vtkIdList;
+class vtkPointData;
 class vtkPoints;
 class vtkHyperTreeGridNonOrientedGeometryCursor;
 class vtkHyperTreeGridNonOrientedMooreSuperCursor;
@@ -112,9 +118,12 @@ protected:
   int ProcessTrees(vtkHyperTreeGrid*, vtkDataObject*) override;
 
   /**
-   * Recursively descend into tree down to leaves, cutting primal cells
+   * Recursively descend into tree down to leaves, cutting primal cells.
+   * Cut polygons are added to points and cells, the leaves they come from
+   * to cellIds.
    */
-  void RecursivelyProcessTreePrimal(vtkHyperTreeGridNonOrientedGeometryCursor*);
+  void RecursivelyProcessTreePrimal(vtkHyperTreeGridNonOrientedGeometryCursor*,
+    vtkPoints* points, vtkCellArray* cells, std::vector<vtkIdType>& cellIds);
 
   /**
    * Recursively decide whether cell is intersected by plane
@@ -122,9 +131,13 @@ protected:
   bool RecursivelyPreProcessTree(vtkHyperTreeGridNonOrientedGeometryCursor*);
 
   /**
-   * Recursively descend into tree down to leaves, cutting dual cells
+   * Recursively descend into tree down to leaves, cutting dual cells with
+   * cutter. centers and leaves are scratch storage for the dual cells, cut
+   * polygons are added to points, cells and outData.
    */
-  void RecursivelyProcessTreeDual(vtkHyperTreeGridNonOrientedMooreSuperCursor*);
+  void RecursivelyProcessTreeDual(vtkHyperTreeGridNonOrientedMooreSuperCursor*, vtkCutter* cutter,
+    vtkPoints* centers, vtkIdList* leaves, vtkPoints* points, vtkCellArray* cells,
+    vtkPointData* outData);
 
   /**
    * Check if a cursor is intersected by a plane
@@ -158,32 +171,7 @@ protected:
   /**
    * Storage for pre-selected cells to be processed in dual mode
    */
-  vtkBitArray* SelectedCells;
-
-  /**
-   * Storage for points of output unstructured mesh
-   */
-  vtkPoints* Points;
-
-  /**
-   * Storage for cells of output unstructured mesh
-   */
-  vtkCellArray* Cells;
-
-  /**
-   * Storage for dual vertex indices
-   */
-  vtkIdList* Leaves;
-
-  /**
-   * Storage for dual vertices at center of primal cells
-   */
-  vtkPoints* Centers;
-
-  /**
-   * Cutter to be used on dual cells
-   */
-  vtkCutter* Cutter;
+  std::vector<unsigned char> SelectedCells;
 
   /**
    * material Mask
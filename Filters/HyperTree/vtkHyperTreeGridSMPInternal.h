@@ -0,0 +1,339 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkHyperTreeGridSMPInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkHyperTreeGridSMPInternal
+ * @brief   helpers to traverse the trees of a hyper tree grid concurrently
+ *
+ * The hyper trees of a vtkHyperTreeGrid are independent, the filters of this
+ * module traverse them with vtkSMPTools, each thread using its own cursors.
+ * Filters producing polygonal data let each range of trees fill a piece of
+ * output, the pieces are then appended in the order of the trees so that the
+ * output does not depend on the number of threads.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ */
+
+#ifndef vtkHyperTreeGridSMPInternal_h
+#define vtkHyperTreeGridSMPInternal_h
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkHyperTree.h"
+#include "vtkHyperTreeGrid.h"
+#include "vtkHyperTreeGridScales.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIncrementalPointLocator.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+//------------------------------------------------------------------------------
+// Indices of the trees of a grid, in the order of vtkHyperTreeGridIterator.
+// Cursors extend the cell scales of the trees lazily, those of the neighbor
+// trees included for super cursors: they are computed level by level down to
+// the deepest one here so that the trees can then be traversed concurrently.
+inline std::vector<vtkIdType> vtkHyperTreeGridGetTreeIndices(vtkHyperTreeGrid* grid)
+{
+  const unsigned int numberOfLevels = grid->GetNumberOfLevels();
+  std::vector<vtkIdType> indices;
+  vtkIdType index;
+  vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
+  grid->InitializeTreeIterator(it);
+  while (vtkHyperTree* tree = it.GetNextTree(index))
+  {
+    indices.push_back(index);
+    if (tree->HasScales())
+    {
+      for (unsigned int level = 1; level <= numberOfLevels; ++level)
+      {
+        tree->GetScales()->GetScale(level);
+      }
+    }
+  }
+  return indices;
+}
+
+//------------------------------------------------------------------------------
+// Bounds of the level zero cells of the trees of ranks begin to end in
+// indices, returning their number of cells. The locator of the piece of output
+// of these trees is sized from them rather than from the whole grid; points
+// lying outside these bounds are still merged, in the buckets on the border.
+inline vtkIdType vtkHyperTreeGridGetTreesBounds(vtkHyperTreeGrid* grid,
+  const std::vector<vtkIdType>& indices, vtkIdType begin, vtkIdType end, double bounds[6])
+{
+  vtkIdType numberOfCells = 0;
+  double origin[3];
+  double size[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    bounds[2 * i] = VTK_DOUBLE_MAX;
+    bounds[2 * i + 1] = VTK_DOUBLE_MIN;
+  }
+  for (vtkIdType t = begin; t < end; ++t)
+  {
+    grid->GetLevelZeroOriginAndSizeFromIndex(indices[t], origin, size);
+    for (int i = 0; i < 3; ++i)
+    {
+      bounds[2 * i] = std::min(bounds[2 * i], std::min(origin[i], origin[i] + size[i]));
+      bounds[2 * i + 1] = std::max(bounds[2 * i + 1], std::max(origin[i], origin[i] + size[i]));
+    }
+    numberOfCells += grid->GetTree(indices[t])->GetNumberOfVertices();
+  }
+  return numberOfCells;
+}
+
+//------------------------------------------------------------------------------
+// Polygonal output of a range of trees starting at rank Begin.
+struct vtkHyperTreeGridPolyDataPiece
+{
+  vtkIdType Begin = 0;
+  vtkNew<vtkPoints> Points;
+  vtkNew<vtkCellArray> Verts;
+  vtkNew<vtkCellArray> Lines;
+  vtkNew<vtkCellArray> Polys;
+  vtkNew<vtkPointData> PointData;
+
+  // Input cell each output cell comes from, when cell data is passed
+  std::vector<vtkIdType> VertIds;
+  std::vector<vtkIdType> LineIds;
+  std::vector<vtkIdType> PolyIds;
+};
+
+//------------------------------------------------------------------------------
+// Pieces created by the threads, handed back in the order of the trees.
+class vtkHyperTreeGridPolyDataPieces
+{
+public:
+  vtkHyperTreeGridPolyDataPiece* NewPiece(vtkIdType begin)
+  {
+    auto& pieces = this->Pieces.Local();
+    pieces.emplace_back(new vtkHyperTreeGridPolyDataPiece);
+    pieces.back()->Begin = begin;
+    return pieces.back().get();
+  }
+
+  std::vector<vtkHyperTreeGridPolyDataPiece*> GetOrderedPieces()
+  {
+    std::vector<vtkHyperTreeGridPolyDataPiece*> ordered;
+    for (auto& pieces : this->Pieces)
+    {
+      for (auto& piece : pieces)
+      {
+        ordered.push_back(piece.get());
+      }
+    }
+    std::sort(ordered.begin(), ordered.end(),
+      [](vtkHyperTreeGridPolyDataPiece* a, vtkHyperTreeGridPolyDataPiece* b) {
+        return a->Begin < b->Begin;
+      });
+    return ordered;
+  }
+
+private:
+  vtkSMPThreadLocal<std::vector<std::shared_ptr<vtkHyperTreeGridPolyDataPiece>>> Pieces;
+};
+
+//------------------------------------------------------------------------------
+// Concatenate the cells of the pieces returned by getCells, renumbering their
+// points. Returns nullptr when there is no such cell.
+template <typename CellsGetter>
+vtkSmartPointer<vtkCellArray> vtkHyperTreeGridMergeCells(
+  const std::vector<vtkHyperTreeGridPolyDataPiece*>& pieces,
+  const std::vector<vtkIdType>& pointOffsets,
+  const std::vector<std::vector<vtkIdType>>& pointMaps, CellsGetter getCells)
+{
+  const vtkIdType numPieces = static_cast<vtkIdType>(pieces.size());
+  std::vector<vtkIdType> cellOffsets(numPieces + 1, 0);
+  std::vector<vtkIdType> connectivityOffsets(numPieces + 1, 0);
+  for (vtkIdType p = 0; p < numPieces; ++p)
+  {
+    vtkCellArray* cells = getCells(pieces[p]);
+    cellOffsets[p + 1] = cellOffsets[p] + cells->GetNumberOfCells();
+    connectivityOffsets[p + 1] = connectivityOffsets[p] + cells->GetNumberOfConnectivityIds();
+  }
+  const vtkIdType numCells = cellOffsets[numPieces];
+  if (numCells == 0)
+  {
+    return nullptr;
+  }
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numCells + 1);
+  offsets->SetValue(numCells, connectivityOffsets[numPieces]);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(connectivityOffsets[numPieces]);
+  vtkSMPTools::For(0, numPieces, [&](vtkIdType begin, vtkIdType end) {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType p = begin; p < end; ++p)
+    {
+      vtkCellArray* cells = getCells(pieces[p]);
+      vtkIdType offset = connectivityOffsets[p];
+      for (vtkIdType cellId = 0; cellId < cells->GetNumberOfCells(); ++cellId)
+      {
+        cells->GetCellAtId(cellId, npts, pts);
+        offsets->SetValue(cellOffsets[p] + cellId, offset);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          connectivity->SetValue(
+            offset++, pointMaps.empty() ? pts[i] + pointOffsets[p] : pointMaps[p][pts[i]]);
+        }
+      }
+    }
+  });
+
+  auto merged = vtkSmartPointer<vtkCellArray>::New();
+  merged->SetData(offsets, connectivity);
+  return merged;
+}
+
+//------------------------------------------------------------------------------
+// Append the pieces to output in the order of the trees. Points are merged
+// with locator when one is given, it must then have been initialized for
+// insertion into points; otherwise they are appended to points. Point data
+// comes from the pieces, cell data from inCellData when not null.
+inline void vtkHyperTreeGridMergePolyDataPieces(
+  const std::vector<vtkHyperTreeGridPolyDataPiece*>& pieces, vtkPoints* points,
+  vtkIncrementalPointLocator* locator, vtkPolyData* output, vtkDataSetAttributes* inCellData)
+{
+  const vtkIdType numPieces = static_cast<vtkIdType>(pieces.size());
+  std::vector<vtkIdType> pointOffsets(numPieces + 1, 0);
+  for (vtkIdType p = 0; p < numPieces; ++p)
+  {
+    pointOffsets[p + 1] = pointOffsets[p] + pieces[p]->Points->GetNumberOfPoints();
+  }
+  const vtkIdType numPts = pointOffsets[numPieces];
+
+  // All pieces share the layout of their point data
+  vtkPointData* outPD = output->GetPointData();
+  if (numPieces > 0)
+  {
+    outPD->CopyAllocate(pieces[0]->PointData, numPts);
+  }
+
+  std::vector<std::vector<vtkIdType>> pointMaps;
+  if (locator)
+  {
+    // Merging is sequential, points keep the order in which they are first met
+    pointMaps.resize(numPieces);
+    double x[3];
+    for (vtkIdType p = 0; p < numPieces; ++p)
+    {
+      vtkHyperTreeGridPolyDataPiece* piece = pieces[p];
+      std::vector<vtkIdType>& pointMap = pointMaps[p];
+      pointMap.resize(piece->Points->GetNumberOfPoints());
+      for (vtkIdType i = 0; i < piece->Points->GetNumberOfPoints(); ++i)
+      {
+        piece->Points->GetPoint(i, x);
+        if (locator->InsertUniquePoint(x, pointMap[i]))
+        {
+          outPD->CopyData(piece->PointData, i, pointMap[i]);
+        }
+      }
+    }
+  }
+  else
+  {
+    points->SetNumberOfPoints(numPts);
+    vtkSMPTools::For(0, numPieces, [&](vtkIdType begin, vtkIdType end) {
+      double x[3];
+      for (vtkIdType p = begin; p < end; ++p)
+      {
+        vtkPoints* piecePoints = pieces[p]->Points;
+        for (vtkIdType i = 0; i < piecePoints->GetNumberOfPoints(); ++i)
+        {
+          piecePoints->GetPoint(i, x);
+          points->SetPoint(pointOffsets[p] + i, x);
+        }
+      }
+    });
+    for (vtkIdType p = 0; p < numPieces; ++p)
+    {
+      outPD->CopyData(pieces[p]->PointData, pointOffsets[p],
+        pieces[p]->Points->GetNumberOfPoints(), vtkIdType(0));
+    }
+  }
+  output->SetPoints(points);
+
+  // Cells are ordered by type then by piece
+  auto verts = vtkHyperTreeGridMergeCells(pieces, pointOffsets, pointMaps,
+    [](vtkHyperTreeGridPolyDataPiece* piece) -> vtkCellArray* { return piece->Verts; });
+  auto lines = vtkHyperTreeGridMergeCells(pieces, pointOffsets, pointMaps,
+    [](vtkHyperTreeGridPolyDataPiece* piece) -> vtkCellArray* { return piece->Lines; });
+  auto polys = vtkHyperTreeGridMergeCells(pieces, pointOffsets, pointMaps,
+    [](vtkHyperTreeGridPolyDataPiece* piece) -> vtkCellArray* { return piece->Polys; });
+  if (verts)
+  {
+    output->SetVerts(verts);
+  }
+  if (lines)
+  {
+    output->SetLines(lines);
+  }
+  if (polys)
+  {
+    output->SetPolys(polys);
+  }
+
+  if (inCellData)
+  {
+    vtkNew<vtkIdList> cellIds;
+    for (auto piece : pieces)
+    {
+      for (vtkIdType cellId : piece->VertIds)
+      {
+        cellIds->InsertNextId(cellId);
+      }
+    }
+    for (auto piece : pieces)
+    {
+      for (vtkIdType cellId : piece->LineIds)
+      {
+        cellIds->InsertNextId(cellId);
+      }
+    }
+    for (auto piece : pieces)
+    {
+      for (vtkIdType cellId : piece->PolyIds)
+      {
+        cellIds->InsertNextId(cellId);
+      }
+    }
+    vtkDataSetAttributes* outCD = output->GetCellData();
+    outCD->CopyAllocate(inCellData, cellIds->GetNumberOfIds());
+    outCD->CopyData(inCellData, cellIds, vtkIdType(0));
+  }
+}
+
+} // anonymous namespace
+
+#endif // vtkHyperTreeGridSMPInternal_h
+// VTK-HeaderTest-Exclude: vtkHyperTreeGridSMPInternal.h
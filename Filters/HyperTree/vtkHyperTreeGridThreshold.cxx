@@ -18,19 +18,49 @@
 #include "vtkCellData.h"
 #include "vtkHyperTree.h"
 #include "vtkHyperTreeGrid.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkUniformHyperTreeGrid.h"
 
 #include "vtkHyperTreeGridNonOrientedCursor.h"
+#include "vtkHyperTreeGridSMPInternal.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <numeric>
+#include <vector>
 
 vtkStandardNewMacro(vtkHyperTreeGridThreshold);
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Number of cells below the cursor that are copied to the output tree, which is
+// not subdivided below masked cells
+vtkIdType CountOutputCells(vtkHyperTreeGridNonOrientedCursor* cursor, vtkBitArray* mask)
+{
+  vtkIdType count = 1;
+  if (cursor->IsLeaf() || (mask && mask->GetValue(cursor->GetGlobalNodeIndex())))
+  {
+    return count;
+  }
+  const unsigned char numChildren = cursor->GetNumberOfChildren();
+  for (unsigned char child = 0; child < numChildren; ++child)
+  {
+    cursor->ToChild(child);
+    count += CountOutputCells(cursor, mask);
+    cursor->ToParent();
+  }
+  return count;
+}
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 vtkHyperTreeGridThreshold::vtkHyperTreeGridThreshold()
 {
@@ -136,24 +166,28 @@ int vtkHyperTreeGridThreshold::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObje
   // Retrieve material mask
   this->InMask = input->HasMask() ? input->GetMask() : nullptr;
 
+  // Mask values are first stored one per byte, the trees setting them concurrently
+  std::vector<unsigned char> outMask;
+
   if (this->JustCreateNewMask)
   {
     output->ShallowCopy(input);
 
-    this->OutMask->SetNumberOfTuples(output->GetNumberOfVertices());
+    outMask.resize(output->GetNumberOfVertices());
 
     // Iterate over all input and output hyper trees
-    vtkIdType outIndex;
-    vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-    output->InitializeTreeIterator(it);
-    vtkNew<vtkHyperTreeGridNonOrientedCursor> outCursor;
-    while (it.GetNextTree(outIndex))
-    {
-      // Initialize new grid cursor at root of current input tree
-      output->InitializeNonOrientedCursor(outCursor, outIndex);
-      // Limit depth recursively
-      this->RecursivelyProcessTreeWithCreateNewMask(outCursor);
-    } // it
+    std::vector<vtkIdType> trees = vtkHyperTreeGridGetTreeIndices(output);
+    vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> tlOutCursor;
+    vtkSMPTools::For(0, static_cast<vtkIdType>(trees.size()), [&](vtkIdType begin, vtkIdType end) {
+      vtkHyperTreeGridNonOrientedCursor* outCursor = tlOutCursor.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // Initialize new grid cursor at root of current input tree
+        output->InitializeNonOrientedCursor(outCursor, trees[i]);
+        // Limit depth recursively
+        this->RecursivelyProcessTreeWithCreateNewMask(outCursor, outMask.data());
+      }
+    });
   }
   else
   {
@@ -171,28 +205,63 @@ int vtkHyperTreeGridThreshold::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObje
     this->OutData = output->GetCellData();
     this->OutData->CopyAllocate(this->InData);
 
-    // Output indices begin at 0
-    this->CurrentId = 0;
+    // Create output trees beforehand, the grid storing them is not thread safe.
+    // Count the output cells of each tree and number them from the offset of
+    // their tree in the order of the input trees.
+    std::vector<vtkIdType> trees = vtkHyperTreeGridGetTreeIndices(input);
+    const vtkIdType numTrees = static_cast<vtkIdType>(trees.size());
+    std::vector<vtkIdType> treeOffsets(numTrees + 1, 0);
+    for (vtkIdType index : trees)
+    {
+      output->GetTree(index, true);
+    }
+    vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> tlInCursor;
+    vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+      vtkHyperTreeGridNonOrientedCursor* inCursor = tlInCursor.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        input->InitializeNonOrientedCursor(inCursor, trees[i]);
+        treeOffsets[i + 1] = CountOutputCells(inCursor, this->InMask);
+      }
+    });
+    std::partial_sum(treeOffsets.begin(), treeOffsets.end(), treeOffsets.begin());
+    this->CurrentId = treeOffsets[numTrees];
+
+    vtkNew<vtkIdList> inIds;
+    inIds->SetNumberOfIds(this->CurrentId);
+    outMask.resize(this->CurrentId);
 
     // Iterate over all input and output hyper trees
-    vtkIdType inIndex;
-    vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-    input->InitializeTreeIterator(it);
-    vtkNew<vtkHyperTreeGridNonOrientedCursor> inCursor;
-    vtkNew<vtkHyperTreeGridNonOrientedCursor> outCursor;
-    while (it.GetNextTree(inIndex))
-    {
-      // Initialize new cursor at root of current input tree
-      input->InitializeNonOrientedCursor(inCursor, inIndex);
-      // Initialize new cursor at root of current output tree
-      output->InitializeNonOrientedCursor(outCursor, inIndex, true);
-      // Limit depth recursively
-      this->RecursivelyProcessTree(inCursor, outCursor);
-    } // it
+    vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> tlOutCursor;
+    vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+      vtkHyperTreeGridNonOrientedCursor* inCursor = tlInCursor.Local();
+      vtkHyperTreeGridNonOrientedCursor* outCursor = tlOutCursor.Local();
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // Initialize new cursor at root of current input tree
+        input->InitializeNonOrientedCursor(inCursor, trees[i]);
+        // Initialize new cursor at root of current output tree
+        output->InitializeNonOrientedCursor(outCursor, trees[i]);
+        // Limit depth recursively
+        vtkIdType outId = treeOffsets[i];
+        this->RecursivelyProcessTree(inCursor, outCursor, inIds, outMask.data(), outId);
+      }
+    });
+
+    // Copy out cell data from that of input cells
+    this->OutData->CopyData(this->InData, inIds, vtkIdType(0));
   }
 
-  // Squeeze and set output material mask if necessary
-  this->OutMask->Squeeze();
+  // Set output material mask, each byte of the bit array being filled by a single thread
+  const vtkIdType numValues = static_cast<vtkIdType>(outMask.size());
+  this->OutMask->SetNumberOfTuples(numValues);
+  vtkSMPTools::For(0, (numValues + 7) / 8, [&](vtkIdType begin, vtkIdType end) {
+    const vtkIdType last = std::min(8 * end, numValues);
+    for (vtkIdType i = 8 * begin; i < last; ++i)
+    {
+      this->OutMask->SetValue(i, outMask[i]);
+    }
+  });
   output->SetMask(this->OutMask);
 
   this->UpdateProgress(1.);
@@ -200,17 +269,18 @@ int vtkHyperTreeGridThreshold::ProcessTrees(vtkHyperTreeGrid* input, vtkDataObje
 }
 
 //------------------------------------------------------------------------------
-bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
-  vtkHyperTreeGridNonOrientedCursor* inCursor, vtkHyperTreeGridNonOrientedCursor* outCursor)
+bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(vtkHyperTreeGridNonOrientedCursor* inCursor,
+  vtkHyperTreeGridNonOrientedCursor* outCursor, vtkIdList* inIds, unsigned char* outMask,
+  vtkIdType& currentId)
 {
   // Retrieve global index of input cursor
   vtkIdType inId = inCursor->GetGlobalNodeIndex();
 
   // Increase index count on output: postfix is intended
-  vtkIdType outId = this->CurrentId++;
+  vtkIdType outId = currentId++;
 
-  // Copy out cell data from that of input cell
-  this->OutData->CopyData(this->InData, inId, outId);
+  // Keep track of the input cell from which output cell data comes
+  inIds->SetId(outId, inId);
 
   // Retrieve output tree and set global index of output cursor
   vtkHyperTree* outTree = outCursor->GetTree();
@@ -222,7 +292,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
   if (this->InMask && this->InMask->GetValue(inId))
   {
     // Mask output cell if necessary
-    this->OutMask->InsertTuple1(outId, discard);
+    outMask[outId] = discard;
 
     // Return whether current node is within range
     return discard;
@@ -243,17 +313,17 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
       // Descend into child in output grid as well
       outCursor->ToChild(ichild);
       // Recurse and keep track of whether some children are kept
-      discard &= this->RecursivelyProcessTree(inCursor, outCursor);
-      // Return to parent in input grid
-      outCursor->ToParent();
+      discard &= this->RecursivelyProcessTree(inCursor, outCursor, inIds, outMask, currentId);
       // Return to parent in output grid
+      outCursor->ToParent();
+      // Return to parent in input grid
       inCursor->ToParent();
     } // child
   }   // if (! inCursor->IsLeaf() && inCursor->GetCurrentDepth() < this->Depth)
   else
   {
     // Input cursor is at leaf, check whether it is within range
-    double value = this->InScalars->GetTuple1(inId);
+    double value = this->InScalars->GetComponent(inId, 0);
     if (!(this->InMask && this->InMask->GetValue(inId)) && value >= this->LowerThreshold &&
       value <= this->UpperThreshold)
     {
@@ -263,7 +333,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
   } // else
 
   // Mask output cell if necessary
-  this->OutMask->InsertTuple1(outId, discard);
+  outMask[outId] = discard;
 
   // Return whether current node is within range
   return discard;
@@ -271,7 +341,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTree(
 
 //------------------------------------------------------------------------------
 bool vtkHyperTreeGridThreshold::RecursivelyProcessTreeWithCreateNewMask(
-  vtkHyperTreeGridNonOrientedCursor* outCursor)
+  vtkHyperTreeGridNonOrientedCursor* outCursor, unsigned char* outMask)
 {
   // Retrieve global index of input cursor
   vtkIdType outId = outCursor->GetGlobalNodeIndex();
@@ -282,7 +352,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTreeWithCreateNewMask(
   if (this->InMask && this->InMask->GetValue(outId))
   {
     // Mask output cell if necessary
-    this->OutMask->InsertTuple1(outId, discard);
+    outMask[outId] = discard;
 
     // Return whether current node is within range
     return discard;
@@ -298,7 +368,7 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTreeWithCreateNewMask(
       // Descend into child in output grid as well
       outCursor->ToChild(ichild);
       // Recurse and keep track of whether some children are kept
-      discard &= this->RecursivelyProcessTreeWithCreateNewMask(outCursor);
+      discard &= this->RecursivelyProcessTreeWithCreateNewMask(outCursor, outMask);
       // Return to parent in output grid
       outCursor->ToParent();
     } // child
@@ -306,12 +376,12 @@ bool vtkHyperTreeGridThreshold::RecursivelyProcessTreeWithCreateNewMask(
   else
   {
     // Input cursor is at leaf, check whether it is within range
-    double value = this->InScalars->GetTuple1(outId);
+    double value = this->InScalars->GetComponent(outId, 0);
     discard = value < this->LowerThreshold || value > this->UpperThreshold;
   } // else
 
   // Mask output cell if necessary
-  this->OutMask->InsertTuple1(outId, discard);
+  outMask[outId] = discard;
 
   // Return whether current node is within range
   return discard;
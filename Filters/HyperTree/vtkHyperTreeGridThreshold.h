@@ -45,6 +45,7 @@
 
 class vtkBitArray;
 class vtkHyperTreeGrid;
+class vtkIdList;
 
 class vtkHyperTreeGridNonOrientedCursor;
 
@@ -99,11 +100,16 @@ protected:
   int ProcessTrees(vtkHyperTreeGrid*, vtkDataObject*) override;
 
   /**
-   * Recursively descend into tree down to leaves
+   * Recursively descend into tree down to leaves. Output cells are numbered
+   * from currentId, the input cells they come from are stored in inIds and
+   * their mask values in outMask, one byte per cell. Hyper trees are processed
+   * concurrently.
    */
-  bool RecursivelyProcessTree(
-    vtkHyperTreeGridNonOrientedCursor*, vtkHyperTreeGridNonOrientedCursor*);
-  bool RecursivelyProcessTreeWithCreateNewMask(vtkHyperTreeGridNonOrientedCursor*);
+  bool RecursivelyProcessTree(vtkHyperTreeGridNonOrientedCursor*,
+    vtkHyperTreeGridNonOrientedCursor*, vtkIdList* inIds, unsigned char* outMask,
+    vtkIdType& currentId);
+  bool RecursivelyProcessTreeWithCreateNewMask(
+    vtkHyperTreeGridNonOrientedCursor*, unsigned char* outMask);
 
   /**
    * LowerThreshold scalar value to be accepted
@@ -126,7 +132,7 @@ protected:
   vtkBitArray* OutMask;
 
   /**
-   * Keep track of current index in output hyper tree grid
+   * Number of cells of the output hyper tree grid
    */
   vtkIdType CurrentId;
 
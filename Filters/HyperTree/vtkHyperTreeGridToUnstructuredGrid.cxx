@@ -18,15 +18,50 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkHyperTreeGrid.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkUnstructuredGrid.h"
 
+#include "vtkHyperTreeGridNonOrientedCursor.h"
 #include "vtkHyperTreeGridNonOrientedGeometryCursor.h"
+#include "vtkHyperTreeGridSMPInternal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <numeric>
+#include <vector>
 
 vtkStandardNewMacro(vtkHyperTreeGridToUnstructuredGrid);
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Number of leaves below the cursor that are not masked nor below a masked cell
+vtkIdType CountUnmaskedLeaves(vtkHyperTreeGridNonOrientedCursor* cursor)
+{
+  if (cursor->IsMasked())
+  {
+    return 0;
+  }
+  if (cursor->IsLeaf())
+  {
+    return 1;
+  }
+  vtkIdType count = 0;
+  const unsigned char numChildren = cursor->GetNumberOfChildren();
+  for (unsigned char child = 0; child < numChildren; ++child)
+  {
+    cursor->ToChild(child);
+    count += CountUnmaskedLeaves(cursor);
+    cursor->ToParent();
+  }
+  return count;
+}
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 vtkHyperTreeGridToUnstructuredGrid::vtkHyperTreeGridToUnstructuredGrid()
   : Points(nullptr)
@@ -79,19 +114,57 @@ int vtkHyperTreeGridToUnstructuredGrid::ProcessTrees(
   this->OutData = output->GetCellData();
   this->OutData->CopyAllocate(this->InData);
 
-  // Iterate over all hyper trees
-  vtkIdType index;
-  vtkHyperTreeGrid::vtkHyperTreeGridIterator it;
-  input->InitializeTreeIterator(it);
-  vtkNew<vtkHyperTreeGridNonOrientedGeometryCursor> cursor;
-  while (it.GetNextTree(index))
-  {
-    // Initialize new geometric cursor at root of current tree
-    input->InitializeNonOrientedGeometryCursor(cursor, index);
+  // Count the cells generated by each hyper tree, the trees being independent
+  std::vector<vtkIdType> trees = vtkHyperTreeGridGetTreeIndices(input);
+  const vtkIdType numTrees = static_cast<vtkIdType>(trees.size());
+  vtkBitArray* mask = input->HasMask() ? input->GetMask() : nullptr;
+  std::vector<vtkIdType> treeOffsets(numTrees + 1, 0);
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedCursor> tlCursor;
+  vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+    vtkHyperTreeGridNonOrientedCursor* cursor = tlCursor.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      input->InitializeNonOrientedCursor(cursor, trees[i]);
+      treeOffsets[i + 1] =
+        mask ? CountUnmaskedLeaves(cursor) : cursor->GetTree()->GetNumberOfLeaves();
+    }
+  });
+  std::partial_sum(treeOffsets.begin(), treeOffsets.end(), treeOffsets.begin());
+
+  // Each cell has its own 2^d points
+  const vtkIdType numCells = treeOffsets[numTrees];
+  const vtkIdType cellSize = vtkIdType(1) << this->Dimension;
+  this->Points->SetNumberOfPoints(numCells * cellSize);
+  vtkNew<vtkIdList> leafIds;
+  leafIds->SetNumberOfIds(numCells);
+
+  // Convert hyper trees into unstructured mesh from their offset
+  vtkSMPThreadLocalObject<vtkHyperTreeGridNonOrientedGeometryCursor> tlGeometryCursor;
+  vtkSMPTools::For(0, numTrees, [&](vtkIdType begin, vtkIdType end) {
+    vtkHyperTreeGridNonOrientedGeometryCursor* cursor = tlGeometryCursor.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      // Initialize new geometric cursor at root of current tree
+      input->InitializeNonOrientedGeometryCursor(cursor, trees[i]);
+
+      // Convert hyper tree into unstructured mesh recursively
+      vtkIdType outId = treeOffsets[i];
+      this->RecursivelyProcessTree(cursor, leafIds, outId);
+    }
+  });
 
-    // Convert hyper tree into unstructured mesh recursively
-    this->RecursivelyProcessTree(cursor);
-  } // it
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(numCells * cellSize);
+  vtkSMPTools::For(0, numCells * cellSize, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      connectivity->SetValue(i, i);
+    }
+  });
+  this->Cells->SetData(cellSize, connectivity);
+
+  // Copy output data from input
+  this->OutData->CopyData(this->InData, leafIds, vtkIdType(0));
 
   // Set output geometry and topology
   output->SetPoints(this->Points);
@@ -123,7 +196,7 @@ int vtkHyperTreeGridToUnstructuredGrid::ProcessTrees(
 
 //------------------------------------------------------------------------------
 void vtkHyperTreeGridToUnstructuredGrid::RecursivelyProcessTree(
-  vtkHyperTreeGridNonOrientedGeometryCursor* cursor)
+  vtkHyperTreeGridNonOrientedGeometryCursor* cursor, vtkIdList* leafIds, vtkIdType& outId)
 {
   // If leaf is masked, skip it
   if (cursor->IsMasked())
@@ -134,11 +207,11 @@ void vtkHyperTreeGridToUnstructuredGrid::RecursivelyProcessTree(
   // Create unstructured output if cursor is at leaf
   if (cursor->IsLeaf())
   {
-    // Cursor is at leaf, retrieve its global index
-    vtkIdType id = cursor->GetGlobalNodeIndex();
+    // Cursor is at leaf, keep track of its global index
+    leafIds->SetId(outId, cursor->GetGlobalNodeIndex());
 
     // Create cell
-    this->AddCell(id, cursor->GetOrigin(), cursor->GetSize());
+    this->AddCell(outId++, cursor->GetOrigin(), cursor->GetSize());
   } // if ( cursor->IsLeaf() )
   else
   {
@@ -148,28 +221,25 @@ void vtkHyperTreeGridToUnstructuredGrid::RecursivelyProcessTree(
     {
       cursor->ToChild(ichild);
       // Recurse
-      this->RecursivelyProcessTree(cursor);
+      this->RecursivelyProcessTree(cursor, leafIds, outId);
       cursor->ToParent();
     } // child
   }   // else
 }
 
 //------------------------------------------------------------------------------
-void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin, double* size)
+void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType outId, double* origin, double* size)
 {
   // Storage for point coordinates
   double pt[] = { 0., 0., 0. };
 
-  // Storage for cell vertex IDs
-  vtkIdType ids[8];
-
-  // Storage for cell ID
-  vtkIdType outId;
+  // Points of the cell follow those of the previous ones
+  const vtkIdType id = outId << this->Dimension;
 
   // First cell vertex is always at origin of cursor
   // Add vertex #0 : (0,0)
   memcpy(pt, origin, 3 * sizeof(double));
-  ids[0] = this->Points->InsertNextPoint(pt);
+  this->Points->SetPoint(id, pt);
 
   // Create remaining 2^d - 1 vertices depending on dimension
   switch (this->Dimension)
@@ -180,10 +250,7 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
 
       // In 1D there is only one other vertex
       pt[0] = origin[this->Orientation] + size[this->Orientation];
-      ids[1] = this->Points->InsertNextPoint(pt);
-
-      // Insert next line
-      outId = this->Cells->InsertNextCell(2, ids);
+      this->Points->SetPoint(id + 1, pt);
       break;
     }
     case 2:
@@ -194,20 +261,17 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
       // Add vertex #1 : (1,0)
       pt[axis1] = origin[axis1] + size[axis1];
       pt[axis2] = origin[axis2];
-      ids[1] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(id + 1, pt);
 
       // Add vertex #2 : (0,1)
       pt[axis1] = origin[axis1];
       pt[axis2] = origin[axis2] + size[axis2];
-      ids[2] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(id + 2, pt);
 
       // Add vertex #3 : (1,1)
       pt[axis1] = origin[axis1] + size[axis1];
       pt[axis2] = origin[axis2] + size[axis2];
-      ids[3] = this->Points->InsertNextPoint(pt);
-
-      // Insert next quadrangle
-      outId = this->Cells->InsertNextCell(4, ids);
+      this->Points->SetPoint(id + 3, pt);
       break;
     }
     case 3:
@@ -218,17 +282,17 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
       // Add vertex #1 : (1,0,0)
       pt[0] = origin[0] + size[0];
       pt[1] = origin[1];
-      ids[1] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(id + 1, pt);
 
       // Add vertex #2 : (0,1,0)
       pt[0] = origin[0];
       pt[1] = origin[1] + size[1];
-      ids[2] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(id + 2, pt);
 
       // Add vertex #3 : (1,1,0)
       pt[0] = origin[0] + size[0];
       pt[1] = origin[1] + size[1];
-      ids[3] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(id + 3, pt);
 
       // z=1 plane
       pt[2] = origin[2] + size[2];
@@ -236,25 +300,22 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
       // Add vertex #4 : (0,0,1)
       pt[0] = origin[0];
       pt[1] = origin[1];
-      ids[4] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(id + 4, pt);
 
       // Add vertex #5 : (1,0,1)
       pt[0] = origin[0] + size[0];
       pt[1] = origin[1];
-      ids[5] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(id + 5, pt);
 
       // Add vertex #6 : (0,1,1)
       pt[0] = origin[0];
       pt[1] = origin[1] + size[1];
-      ids[6] = this->Points->InsertNextPoint(pt);
+      this->Points->SetPoint(id + 6, pt);
 
       // Add vertex #7 : (1,1,1)
       pt[0] = origin[0] + size[0];
       pt[1] = origin[1] + size[1];
-      ids[7] = this->Points->InsertNextPoint(pt);
-
-      // Insert next voxel
-      outId = this->Cells->InsertNextCell(8, ids);
+      this->Points->SetPoint(id + 7, pt);
       break;
     }
     default:
@@ -262,7 +323,4 @@ void vtkHyperTreeGridToUnstructuredGrid::AddCell(vtkIdType inId, double* origin,
       return;
     }
   } // switch ( this->Dimension )
-
-  // Copy output data from input
-  this->OutData->CopyData(this->InData, inId, outId);
 }
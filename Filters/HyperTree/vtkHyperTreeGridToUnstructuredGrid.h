@@ -46,6 +46,7 @@
 class vtkBitArray;
 class vtkCellArray;
 class vtkHyperTreeGrid;
+class vtkIdList;
 class vtkPoints;
 class vtkUnstructuredGrid;
 class vtkHyperTreeGridNonOrientedGeometryCursor;
@@ -73,14 +74,17 @@ protected:
   int ProcessTrees(vtkHyperTreeGrid*, vtkDataObject*) override;
 
   /**
-   * Recursively descend into tree down to leaves
+   * Recursively descend into tree down to leaves, generating cells from outId
+   * and storing the global indices of their leaves in leafIds. The hyper trees
+   * are processed concurrently.
    */
-  void RecursivelyProcessTree(vtkHyperTreeGridNonOrientedGeometryCursor*);
+  void RecursivelyProcessTree(
+    vtkHyperTreeGridNonOrientedGeometryCursor*, vtkIdList* leafIds, vtkIdType& outId);
 
   /**
-   * Helper method to generate a 2D or 3D cell
+   * Helper method to generate the points of a 1D, 2D or 3D cell
    */
-  void AddCell(vtkIdType, double*, double*);
+  void AddCell(vtkIdType outId, double*, double*);
 
   /**
    * Storage for points of output unstructured mesh
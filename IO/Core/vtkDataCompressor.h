@@ -28,6 +28,12 @@
  * should be implemented with this in mind to provide a predictable
  * compressor interface for vtkDataCompressor users.
  *
+ * @par Note:
+ * The XML writers and readers compress and decompress independent blocks
+ * concurrently with the same compressor. Compress and Uncompress must
+ * therefore be thread-safe: subclasses must not modify their state in
+ * CompressBuffer and UncompressBuffer.
+ *
  * @par Thanks:
  * Homogeneous CompressionLevel behavior contributed by Quincy Wofford
  * (qwofford@lanl.gov) and John Patchett (patchett@lanl.gov)
@@ -34,6 +34,7 @@
 #include <cctype>
 #include <cstdlib>
 #include <string>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 vtkStandardNewMacro(vtkSTLReader);
@@ -175,6 +176,12 @@ int vtkSTLReader::RequestData(vtkInformation* vtkNotUsed(request),
     }
     locator->InitPointInsertion(mergedPts, newPts->GetBounds());
 
+    // the triangles use the points in order, three points each, so they
+    // are all merged at once
+    std::vector<vtkIdType> mergedIds(3 * newPolys->GetNumberOfCells());
+    locator->InsertUniquePoints(
+      newPts, static_cast<vtkIdType>(mergedIds.size()), nullptr, mergedIds.data());
+
     int nextCell = 0;
     const vtkIdType* pts = nullptr;
     vtkIdType npts;
@@ -183,9 +190,7 @@ int vtkSTLReader::RequestData(vtkInformation* vtkNotUsed(request),
       vtkIdType nodes[3];
       for (int i = 0; i < 3; i++)
       {
-        double x[3];
-        newPts->GetPoint(pts[i], x);
-        locator->InsertUniquePoint(x, nodes[i]);
+        nodes[i] = mergedIds[pts[i]];
       }
 
       if (nodes[0] != nodes[1] && nodes[0] != nodes[2] && nodes[1] != nodes[2])
@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressedBlocks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compressed blocks are compressed and decompressed concurrently. Check that
+// the written files are compressed, do not depend on the number of threads,
+// and that data read back match the original data.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSMPTools.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+std::string Write(vtkImageData* image, int compressor, int dataMode, bool encode, int byteOrder)
+{
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image);
+  writer->WriteToOutputStringOn();
+  writer->SetCompressorType(compressor);
+  writer->SetDataMode(dataMode);
+  writer->SetEncodeAppendedData(encode);
+  writer->SetByteOrder(byteOrder);
+  // Small blocks, so that arrays span many blocks.
+  writer->SetBlockSize(4096);
+  writer->Write();
+  return writer->GetOutputString();
+}
+
+} // anonymous namespace
+
+int TestXMLCompressedBlocks(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(50, 40, 30);
+  const vtkIdType numPts = image->GetNumberOfPoints();
+
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    scalars->SetValue(ptId, static_cast<float>(std::sin(0.01 * ptId)));
+    vectors->SetTuple3(ptId, ptId, std::cos(0.02 * ptId), 0.5);
+  }
+  image->GetPointData()->SetScalars(scalars);
+  image->GetPointData()->AddArray(vectors);
+
+  const int compressors[] = { vtkXMLWriter::ZLIB, vtkXMLWriter::LZ4, vtkXMLWriter::LZMA };
+  const char* compressorNames[] = { "vtkZLibDataCompressor", "vtkLZ4DataCompressor",
+    "vtkLZMADataCompressor" };
+  const int byteOrders[] = { vtkXMLWriter::LittleEndian, vtkXMLWriter::BigEndian };
+  struct Mode
+  {
+    int DataMode;
+    bool Encode;
+  };
+  const Mode modes[] = { { vtkXMLWriter::Binary, true }, { vtkXMLWriter::Appended, true },
+    { vtkXMLWriter::Appended, false } };
+
+  for (int c = 0; c < 3; ++c)
+  {
+    const int compressor = compressors[c];
+    for (int byteOrder : byteOrders)
+    {
+      for (const Mode& mode : modes)
+      {
+        const auto outputs = vtkTest::RunSequentialAndThreaded(
+          [&]() { return Write(image, compressor, mode.DataMode, mode.Encode, byteOrder); });
+        if (outputs.first.empty() || outputs.first != outputs.second)
+        {
+          std::cerr << "Output depends on the number of threads (compressor " << compressor
+                    << ", byte order " << byteOrder << ", data mode " << mode.DataMode
+                    << ", encoded " << mode.Encode << ")." << std::endl;
+          return EXIT_FAILURE;
+        }
+        const std::string uncompressed =
+          Write(image, vtkXMLWriter::NONE, mode.DataMode, mode.Encode, byteOrder);
+        if (outputs.first.find(compressorNames[c]) == std::string::npos ||
+          outputs.first.size() >= uncompressed.size())
+        {
+          std::cerr << "Data were not compressed with " << compressorNames[c] << "."
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        vtkNew<vtkXMLImageDataReader> reader;
+        reader->ReadFromInputStringOn();
+        reader->SetInputString(outputs.second);
+        vtkSMPTools::LocalScope(vtkTest::ThreadedConfig(), [&]() { reader->Update(); });
+        vtkPointData* pd = reader->GetOutput()->GetPointData();
+        if (!vtkTest::SameArrays(scalars, pd->GetArray("Scalars")) ||
+          !vtkTest::SameArrays(vectors, pd->GetArray("Vectors")))
+        {
+          std::cerr << "Wrong data read back (compressor " << compressor << ", byte order "
+                    << byteOrder << ", data mode " << mode.DataMode << ", encoded " << mode.Encode
+                    << ")." << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
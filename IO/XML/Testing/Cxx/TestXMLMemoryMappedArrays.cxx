@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLMemoryMappedArrays.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that arrays read with MemoryMapAppendedData on match the written
+// arrays, whether they can be mapped or not, and that modifying them does not
+// modify the file. Also check that all the arrays of raw appended data in the
+// byte order of this machine are mapped, whatever their value size since the
+// writer aligns them, and that the others are read.
+
+#include "vtkDoubleArray.h"
+#include "vtkEndian.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+// Gives access to vtkXMLReader::IsMemoryMapped
+class MappedArrays : public vtkXMLImageDataReader
+{
+public:
+  static bool IsMapped(vtkAbstractArray* array) { return vtkXMLReader::IsMemoryMapped(array); }
+};
+
+vtkSmartPointer<vtkImageData> Read(const std::string& fileName, bool memoryMap)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetMemoryMapAppendedData(memoryMap);
+  reader->Update();
+  vtkSmartPointer<vtkImageData> output = reader->GetOutput();
+  return output;
+}
+
+// Number of arrays of the output whose values are mapped from the file
+int CountMappedArrays(vtkImageData* output)
+{
+  int count = 0;
+  vtkPointData* outPD = output->GetPointData();
+  for (int i = 0; i < outPD->GetNumberOfArrays(); ++i)
+  {
+    count += MappedArrays::IsMapped(outPD->GetArray(i)) ? 1 : 0;
+  }
+  return count;
+}
+
+bool CheckArrays(vtkImageData* input, vtkImageData* output)
+{
+  vtkPointData* inPD = input->GetPointData();
+  vtkPointData* outPD = output->GetPointData();
+  for (int i = 0; i < inPD->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* array = inPD->GetArray(i);
+    vtkDataArray* read = outPD->GetArray(array->GetName());
+    if (!vtkTest::SameArrays(array, read) || read->GetDataType() != array->GetDataType())
+    {
+      std::cerr << "Wrong values read for array " << array->GetName() << "." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestXMLMemoryMappedArrays(int argc, char* argv[])
+{
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string dirName(tempDir);
+  delete[] tempDir;
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(31, 21, 11); // An odd number of bytes
+  const vtkIdType numPts = image->GetNumberOfPoints();
+
+  // Arrays of different value sizes, which the writer must align in the file
+  // for the float and double arrays to be mapped.
+  vtkNew<vtkUnsignedCharArray> bytes;
+  bytes->SetName("Bytes");
+  bytes->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    bytes->SetValue(ptId, static_cast<unsigned char>(ptId % 251));
+    scalars->SetValue(ptId, static_cast<float>(std::sin(0.01 * ptId)));
+    vectors->SetTuple3(ptId, ptId, std::cos(0.02 * ptId), 0.5);
+  }
+  image->GetPointData()->AddArray(bytes);
+  image->GetPointData()->SetScalars(scalars);
+  image->GetPointData()->AddArray(vectors);
+
+#ifdef VTK_WORDS_BIGENDIAN
+  const int nativeByteOrder = vtkXMLWriter::BigEndian;
+#else
+  const int nativeByteOrder = vtkXMLWriter::LittleEndian;
+#endif
+  const int byteOrders[] = { vtkXMLWriter::LittleEndian, vtkXMLWriter::BigEndian };
+  const int compressors[] = { vtkXMLWriter::NONE, vtkXMLWriter::ZLIB };
+  for (int encode = 0; encode < 2; ++encode)
+  {
+    for (int byteOrder : byteOrders)
+    {
+      for (int compressor : compressors)
+      {
+        const std::string fileName = dirName + "/TestXMLMemoryMappedArrays_" +
+          std::to_string(encode) + "_" + std::to_string(byteOrder) + "_" +
+          std::to_string(compressor) + ".vti";
+        vtkNew<vtkXMLImageDataWriter> writer;
+        writer->SetInputData(image);
+        writer->SetFileName(fileName.c_str());
+        writer->SetDataModeToAppended();
+        writer->SetEncodeAppendedData(encode);
+        writer->SetByteOrder(byteOrder);
+        writer->SetCompressorType(compressor);
+        if (!writer->Write())
+        {
+          std::cerr << "Could not write " << fileName << "." << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        vtkSmartPointer<vtkImageData> mapped = Read(fileName, true);
+        if (!CheckArrays(image, mapped))
+        {
+          return EXIT_FAILURE;
+        }
+
+        // All arrays are mapped whenever the data can be used in place.
+        const bool mappable =
+          !encode && byteOrder == nativeByteOrder && compressor == vtkXMLWriter::NONE;
+        const int numMapped = CountMappedArrays(mapped);
+        if (numMapped != (mappable ? 3 : 0))
+        {
+          std::cerr << "Expected the arrays of " << fileName << " to be "
+                    << (mappable ? "mapped" : "read") << ", " << numMapped << " are mapped."
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+        if (CountMappedArrays(Read(fileName, false)) != 0)
+        {
+          std::cerr << "Arrays of " << fileName << " are mapped with the option off."
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        // Mappings are copy-on-write: the file must not see the modification.
+        vtkPointData* mappedPD = mapped->GetPointData();
+        for (int i = 0; i < mappedPD->GetNumberOfArrays(); ++i)
+        {
+          mappedPD->GetArray(i)->SetComponent(0, 0, 42);
+        }
+        if (!CheckArrays(image, Read(fileName, true)) ||
+          !CheckArrays(image, Read(fileName, false)))
+        {
+          std::cerr << "Modifying a mapped array modified " << fileName << "." << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include "vtkDataCompressor.h"
 #include "vtkDataSet.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkEndian.h"
 #include "vtkInformation.h"
 #include "vtkInformationDoubleKey.h"
 #include "vtkInformationDoubleVectorKey.h"
@@ -55,10 +56,21 @@
 #include <cctype>
 #include <functional>
 #include <locale> // C++ locale
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <sstream>
 #include <vector>
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 vtkCxxSetObjectMacro(vtkXMLReader, ReaderErrorObserver, vtkCommand);
 vtkCxxSetObjectMacro(vtkXMLReader, ParserErrorObserver, vtkCommand);
 
@@ -90,6 +102,113 @@ vtkCxxSetObjectMacro(vtkXMLReader, ParserErrorObserver, vtkCommand);
     }                                                                                              \
     break
 
+//------------------------------------------------------------------------------
+namespace
+{
+
+// File regions mapped by vtkXMLReader::MapAppendedArrayValues. vtkBuffer only
+// passes the data pointer to its free function, so the start and length of
+// the mapping have to be looked up from it. The registry is never destroyed
+// so that arrays outliving static destruction can still be released.
+struct vtkXMLMappedRegion
+{
+  void* Base;
+  size_t Length;
+};
+
+std::mutex& GetMappedRegionsMutex()
+{
+  static std::mutex* mutex = new std::mutex;
+  return *mutex;
+}
+
+std::map<void*, vtkXMLMappedRegion>& GetMappedRegions()
+{
+  static std::map<void*, vtkXMLMappedRegion>* regions =
+    new std::map<void*, vtkXMLMappedRegion>;
+  return *regions;
+}
+
+void UnmapFileRegion(void* data)
+{
+  vtkXMLMappedRegion region;
+  {
+    std::lock_guard<std::mutex> lock(GetMappedRegionsMutex());
+    auto& regions = GetMappedRegions();
+    auto it = regions.find(data);
+    if (it == regions.end())
+    {
+      return;
+    }
+    region = it->second;
+    regions.erase(it);
+  }
+#if defined(_WIN32)
+  ::UnmapViewOfFile(region.Base);
+#else
+  ::munmap(region.Base, region.Length);
+#endif
+}
+
+// Map length bytes of the file starting at offset, copy-on-write. Returns the
+// address of the byte at offset, or nullptr on failure.
+void* MapFileRegion(const char* fileName, vtkTypeInt64 offset, size_t length)
+{
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  ::GetSystemInfo(&info);
+  const vtkTypeInt64 granularity = info.dwAllocationGranularity;
+#else
+  const vtkTypeInt64 granularity = ::sysconf(_SC_PAGESIZE);
+#endif
+  const vtkTypeInt64 mapOffset = offset - offset % granularity;
+  const size_t delta = static_cast<size_t>(offset - mapOffset);
+  const size_t mapLength = length + delta;
+
+  void* base = nullptr;
+#if defined(_WIN32)
+  std::wstring wfileName = vtksys::Encoding::ToWindowsExtendedPath(fileName);
+  HANDLE file = ::CreateFileW(wfileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (mapping)
+  {
+    base = ::MapViewOfFile(mapping, FILE_MAP_COPY, static_cast<DWORD>(mapOffset >> 32),
+      static_cast<DWORD>(mapOffset & 0xffffffff), mapLength);
+    ::CloseHandle(mapping);
+  }
+  ::CloseHandle(file);
+#else
+  int fd = ::open(fileName, O_RDONLY);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+  base = ::mmap(nullptr, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+    static_cast<off_t>(mapOffset));
+  ::close(fd);
+  if (base == MAP_FAILED)
+  {
+    base = nullptr;
+  }
+#endif
+  if (!base)
+  {
+    return nullptr;
+  }
+
+  void* data = static_cast<char*>(base) + delta;
+  std::lock_guard<std::mutex> lock(GetMappedRegionsMutex());
+  GetMappedRegions()[data] = vtkXMLMappedRegion{ base, mapLength };
+  return data;
+}
+
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 static void ReadStringVersion(const char* version, int& major, int& minor)
 {
@@ -139,6 +258,7 @@ vtkXMLReader::vtkXMLReader()
   this->FileStream = nullptr;
   this->StringStream = nullptr;
   this->ReadFromInputString = 0;
+  this->MemoryMapAppendedData = false;
   this->InputString = "";
   this->XMLParser = nullptr;
   this->ReaderErrorObserver = nullptr;
@@ -235,6 +355,7 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Stream: (none)\n";
   }
+  os << indent << "MemoryMapAppendedData: " << this->MemoryMapAppendedData << "\n";
   os << indent << "TimeStep:" << this->TimeStep << "\n";
   os << indent << "ActiveTimeDataArrayName:"
      << (this->ActiveTimeDataArrayName ? this->ActiveTimeDataArrayName : "(null)") << "\n";
@@ -922,12 +1043,20 @@ int vtkXMLReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
                                << arrayIndex + numValues << " were requested to be read");
     return 0;
   }
-  switch (array->GetDataType())
+  if (this->MemoryMapAppendedData && arrayIndex == 0 && startIndex == 0 &&
+    numValues == array->GetNumberOfValues() && this->MapAppendedArrayValues(da, array))
   {
-    vtkArrayIteratorTemplateMacro(result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-                                    arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-    default:
-      result = 0;
+    result = 1;
+  }
+  else
+  {
+    switch (array->GetDataType())
+    {
+      vtkArrayIteratorTemplateMacro(result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
+                                      arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+      default:
+        result = 0;
+    }
   }
   if (iter)
   {
@@ -947,6 +1076,106 @@ int vtkXMLReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
   return result;
 }
 
+//------------------------------------------------------------------------------
+bool vtkXMLReader::MapAppendedArrayValues(vtkXMLDataElement* da, vtkAbstractArray* array)
+{
+  // Only files can be mapped, and only raw, uncompressed appended data.
+  if (this->ReadFromInputString || !this->FileName || this->Stream != this->FileStream ||
+    !this->FileStream || this->XMLParser->GetCompressor() || !da->GetAttribute("offset"))
+  {
+    return false;
+  }
+  vtkXMLDataElement* eAppended =
+    this->XMLParser->GetRootElement()->FindNestedElementWithName("AppendedData");
+  const char* encoding = eAppended ? eAppended->GetAttribute("encoding") : nullptr;
+  if (!encoding || strcmp(encoding, "raw") != 0)
+  {
+    return false;
+  }
+#ifdef VTK_WORDS_BIGENDIAN
+  if (this->XMLParser->GetByteOrder() != vtkXMLDataParser::BigEndian)
+#else
+  if (this->XMLParser->GetByteOrder() != vtkXMLDataParser::LittleEndian)
+#endif
+  {
+    return false;
+  }
+
+  // The buffer is handed over to the array, which must store its values
+  // contiguously with the type used in the file.
+  vtkDataArray* dataArray = vtkArrayDownCast<vtkDataArray>(array);
+  if (!dataArray || dataArray->GetArrayType() != vtkAbstractArray::AoSDataArrayTemplate ||
+    dataArray->GetDataType() == VTK_BIT)
+  {
+    return false;
+  }
+  const size_t wordSize = dataArray->GetDataTypeSize();
+  const size_t length = static_cast<size_t>(dataArray->GetNumberOfValues()) * wordSize;
+  if (length == 0)
+  {
+    return false;
+  }
+
+  // Read the header holding the number of bytes of the array.
+  vtkTypeInt64 offset = 0;
+  da->GetScalarAttribute("offset", offset);
+  const vtkTypeInt64 headerPosition = this->XMLParser->GetAppendedDataPosition() + offset;
+  vtkTypeUInt64 size = 0;
+  this->Stream->clear();
+  this->Stream->seekg(std::streampos(headerPosition));
+  if (this->XMLParser->GetHeaderType() == 64)
+  {
+    this->Stream->read(reinterpret_cast<char*>(&size), sizeof(vtkTypeUInt64));
+  }
+  else
+  {
+    vtkTypeUInt32 size32 = 0;
+    this->Stream->read(reinterpret_cast<char*>(&size32), sizeof(vtkTypeUInt32));
+    size = size32;
+  }
+  if (!(*this->Stream))
+  {
+    this->Stream->clear();
+    return false;
+  }
+  const vtkTypeInt64 dataPosition = this->Stream->tellg();
+
+  // Values must be naturally aligned in memory, i.e. in the file since
+  // mappings start on a page boundary. Do not map past the end of the file.
+  if (size < length || dataPosition % wordSize != 0 ||
+    static_cast<vtkTypeUInt64>(dataPosition) + length >
+      vtksys::SystemTools::FileLength(this->FileName))
+  {
+    return false;
+  }
+
+  void* data = ::MapFileRegion(this->FileName, dataPosition, length);
+  if (!data)
+  {
+    vtkDebugMacro("Could not map " << length << " bytes of " << this->FileName
+                                   << ", reading them instead.");
+    return false;
+  }
+  dataArray->SetVoidArray(data, dataArray->GetNumberOfValues(), 0,
+    vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  dataArray->SetArrayFreeFunction(::UnmapFileRegion);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool vtkXMLReader::IsMemoryMapped(vtkAbstractArray* array)
+{
+  vtkDataArray* dataArray = vtkArrayDownCast<vtkDataArray>(array);
+  if (!dataArray || dataArray->GetArrayType() != vtkAbstractArray::AoSDataArrayTemplate ||
+    dataArray->GetNumberOfValues() == 0)
+  {
+    return false;
+  }
+  void* data = dataArray->GetVoidPointer(0);
+  std::lock_guard<std::mutex> lock(GetMappedRegionsMutex());
+  return GetMappedRegions().count(data) != 0;
+}
+
 //------------------------------------------------------------------------------
 void vtkXMLReader::ReadXMLData()
 {
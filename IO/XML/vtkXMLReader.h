@@ -74,6 +74,27 @@ public:
   void SetInputString(const std::string& s) { this->InputString = s; }
   ///@}
 
+  ///@{
+  /**
+   * Enable memory mapping of appended data. When on, data arrays stored
+   * uncompressed in a raw-encoded appended data section of a file are not
+   * copied: their buffers are mapped directly from the file and pages are
+   * loaded on first access. Mapping is copy-on-write, so arrays can still be
+   * modified without changing the file. Arrays that do not qualify (inline,
+   * base64-encoded or compressed data, byte order different from the one of
+   * this machine, data not aligned on its value size, string and bit arrays,
+   * arrays assembled from several pieces) are read as usual. vtkXMLWriter
+   * aligns raw uncompressed appended data on its value size.
+   * Default is off.
+   *
+   * @warning The file must not be modified or truncated while mapped arrays
+   * are in use.
+   */
+  vtkSetMacro(MemoryMapAppendedData, bool);
+  vtkGetMacro(MemoryMapAppendedData, bool);
+  vtkBooleanMacro(MemoryMapAppendedData, bool);
+  ///@}
+
   /**
    * Test whether the file (type) with the given name can be read by this
    * reader. If the file has a newer version than the reader, we still say
@@ -298,6 +319,15 @@ protected:
   virtual int ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex, vtkAbstractArray* array,
     vtkIdType startIndex, vtkIdType numValues, FieldType type = OTHER);
 
+  // Replace the buffer of the given array by the file region holding its
+  // appended data, see MemoryMapAppendedData. Returns false when the array
+  // cannot be mapped and has to be read.
+  bool MapAppendedArrayValues(vtkXMLDataElement* da, vtkAbstractArray* array);
+
+  // Return whether the values of the given array are mapped from a file by
+  // MapAppendedArrayValues, rather than stored in memory it allocated.
+  static bool IsMemoryMapped(vtkAbstractArray* array);
+
   // Setup the data array selections for the input's set of arrays.
   void SetDataArraySelections(vtkXMLDataElement* eDSA, vtkDataArraySelection* sel);
 
@@ -343,6 +373,9 @@ protected:
   // Default is 0: read from file.
   vtkTypeBool ReadFromInputString;
 
+  // Whether raw appended data are memory mapped instead of read.
+  bool MemoryMapAppendedData;
+
   // The input string.
   std::string InputString;
 
@@ -43,6 +43,8 @@
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
@@ -63,9 +65,11 @@
 #include "vtksys/FStream.hxx"
 #include <memory>
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
 #include <unistd.h> /* unlink */
@@ -76,6 +80,33 @@
 #include <cctype> // for isalnum
 #include <locale> // C++ locale
 
+//*****************************************************************************
+// Uncompressed blocks of the array being written, waiting to be compressed.
+// The blocks are stored contiguously: block i spans [Offsets[i],
+// Offsets[i + 1]) in Data.
+class vtkXMLWriterCompressionQueue
+{
+public:
+  std::vector<unsigned char> Data;
+  std::vector<size_t> Offsets{ 0 };
+  std::vector<vtkSmartPointer<vtkUnsignedCharArray>> CompressedBlocks;
+
+  size_t GetNumberOfBlocks() const { return this->Offsets.size() - 1; }
+
+  void Push(const unsigned char* data, size_t size)
+  {
+    this->Data.insert(this->Data.end(), data, data + size);
+    this->Offsets.push_back(this->Data.size());
+  }
+
+  void Clear()
+  {
+    this->Data.clear();
+    this->Offsets.resize(1);
+    this->CompressedBlocks.clear();
+  }
+};
+
 //*****************************************************************************
 // Friend class to enable access for template functions to the protected
 // writer methods.
@@ -451,6 +482,7 @@ vtkXMLWriter::vtkXMLWriter()
 
   // Initialize compression data.
   this->CompressionHeader = nullptr;
+  this->CompressionQueue = new vtkXMLWriterCompressionQueue;
   this->Int32IdTypeBuffer = nullptr;
   this->ByteSwapBuffer = nullptr;
 
@@ -482,6 +514,7 @@ vtkXMLWriter::~vtkXMLWriter()
   this->OutStringStream = nullptr;
   delete this->FieldDataOM;
   delete[] this->NumberOfTimeValues;
+  delete this->CompressionQueue;
 }
 
 //------------------------------------------------------------------------------
@@ -1018,6 +1051,12 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
       result = 0;
     }
 
+    // Compress and write the remaining blocks.
+    if (result && !this->FlushCompressionBlocks())
+    {
+      result = 0;
+    }
+
     // Finish writing the data.
     if (result && !this->DataStream->EndWriting())
     {
@@ -1373,6 +1412,7 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 
   // Initialize counter for block writing.
   this->CompressionBlockNumber = 0;
+  this->CompressionQueue->Clear();
 
   return result;
 }
@@ -1380,25 +1420,71 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 //------------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
 {
-  // Compress the data.
-  vtkUnsignedCharArray* outputArray = this->Compressor->Compress(data, size);
-
-  // Find the compressed size.
-  size_t outputSize = outputArray->GetNumberOfTuples();
-  unsigned char* outputPointer = outputArray->GetPointer(0);
+  // Queue the block. Compression is deferred until enough blocks are
+  // available to keep all threads busy. The bound keeps the memory
+  // overhead to a few blocks per thread.
+  this->CompressionQueue->Push(data, size);
+  const size_t maxQueuedBlocks =
+    4 * static_cast<size_t>(std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads()));
+  if (this->CompressionQueue->GetNumberOfBlocks() < maxQueuedBlocks)
+  {
+    return 1;
+  }
+  return this->FlushCompressionBlocks();
+}
 
-  // Write the compressed data.
-  int result = this->DataStream->Write(outputPointer, outputSize);
-  this->Stream->flush();
-  if (this->Stream->fail())
+//------------------------------------------------------------------------------
+int vtkXMLWriter::FlushCompressionBlocks()
+{
+  vtkXMLWriterCompressionQueue* queue = this->CompressionQueue;
+  const size_t numBlocks = queue->GetNumberOfBlocks();
+  if (numBlocks == 0)
   {
-    this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+    return 1;
   }
 
-  // Store the resulting compressed size in the compression header.
-  this->CompressionHeader->Set(3 + this->CompressionBlockNumber++, outputSize);
+  // Compress the blocks concurrently. Compressors do not modify their state
+  // while compressing.
+  queue->CompressedBlocks.resize(numBlocks);
+  vtkDataCompressor* compressor = this->Compressor;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numBlocks), [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      const size_t offset = queue->Offsets[block];
+      queue->CompressedBlocks[block].TakeReference(
+        compressor->Compress(queue->Data.data() + offset, queue->Offsets[block + 1] - offset));
+    }
+  });
+
+  // Write the compressed data in block order.
+  int result = 1;
+  for (size_t block = 0; result && block < numBlocks; ++block)
+  {
+    vtkUnsignedCharArray* outputArray = queue->CompressedBlocks[block];
+    if (!outputArray)
+    {
+      vtkErrorMacro("Error compressing block " << this->CompressionBlockNumber << ".");
+      result = 0;
+      break;
+    }
+
+    // Find the compressed size.
+    size_t outputSize = outputArray->GetNumberOfTuples();
+    unsigned char* outputPointer = outputArray->GetPointer(0);
+
+    // Write the compressed data.
+    result = this->DataStream->Write(outputPointer, outputSize);
+    this->Stream->flush();
+    if (this->Stream->fail())
+    {
+      this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+    }
+
+    // Store the resulting compressed size in the compression header.
+    this->CompressionHeader->Set(3 + this->CompressionBlockNumber++, outputSize);
+  }
 
-  outputArray->Delete();
+  queue->Clear();
 
   return result;
 }
@@ -2040,6 +2126,24 @@ void vtkXMLWriter::WriteArrayAppended(vtkAbstractArray* a, vtkIndent indent, Off
 void vtkXMLWriter::WriteArrayAppendedData(
   vtkAbstractArray* a, vtkTypeInt64 pos, vtkTypeInt64& lastoffset)
 {
+  // Raw uncompressed values are padded to start on a multiple of their size
+  // in the file, so that readers can map them in place (see
+  // vtkXMLReader::MemoryMapAppendedData). Readers locate the data with the
+  // offset attribute, so the padding bytes are never read.
+  if (!this->EncodeAppendedData && !this->Compressor && vtkArrayDownCast<vtkDataArray>(a) &&
+    a->GetDataType() != VTK_BIT)
+  {
+    ostream& os = *(this->Stream);
+    const vtkTypeInt64 wordSize =
+      static_cast<vtkTypeInt64>(this->GetOutputWordTypeSize(a->GetDataType()));
+    const vtkTypeInt64 headerSize = this->HeaderType == vtkXMLWriter::UInt64 ? 8 : 4;
+    const vtkTypeInt64 dataPosition = static_cast<vtkTypeInt64>(os.tellp()) + headerSize;
+    const vtkTypeInt64 padding = (wordSize - dataPosition % wordSize) % wordSize;
+    for (vtkTypeInt64 i = 0; i < padding; ++i)
+    {
+      os.put('\0');
+    }
+  }
   this->WriteAppendedDataOffset(pos, lastoffset, "offset");
   this->WriteBinaryData(a);
 }
@@ -52,6 +52,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkFieldData;
 class vtkXMLDataHeader;
+class vtkXMLWriterCompressionQueue;
 
 class vtkStdString;
 class OffsetsManager;      // one per piece/per time
@@ -139,6 +140,10 @@ protected:
   vtkXMLDataHeader* CompressionHeader;
   vtkTypeInt64 CompressionHeaderPosition;
 
+  // Uncompressed blocks waiting to be compressed. Blocks are compressed
+  // concurrently and written in order by FlushCompressionBlocks.
+  vtkXMLWriterCompressionQueue* CompressionQueue;
+
   // The output stream used to write binary and appended data.  May
   // transparently encode the data.
   vtkOutputStream* DataStream;
@@ -254,6 +259,7 @@ protected:
   void PerformByteSwap(void* data, size_t numWords, size_t wordSize);
   int CreateCompressionHeader(size_t size);
   int WriteCompressionBlock(unsigned char* data, size_t size);
+  int FlushCompressionBlocks();
   int WriteCompressionHeader();
   size_t GetWordTypeSize(int dataType);
   const char* GetWordTypeName(int dataType);
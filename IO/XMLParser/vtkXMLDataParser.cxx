@@ -21,12 +21,14 @@
 #include "vtkEndian.h"
 #include "vtkInputStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkXMLDataElement.h"
 #define vtkXMLDataHeaderPrivate_DoNotInclude
 #include "vtkXMLDataHeaderPrivate.h"
 #undef vtkXMLDataHeaderPrivate_DoNotInclude
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
 #include <memory>
@@ -639,6 +641,51 @@ unsigned char* vtkXMLDataParser::ReadBlock(vtkTypeUInt64 block)
   return decompressBuffer;
 }
 
+//------------------------------------------------------------------------------
+int vtkXMLDataParser::ReadCompleteBlocks(
+  vtkTypeUInt64 firstBlock, vtkTypeUInt64 endBlock, unsigned char* buffer, size_t wordSize)
+{
+  // The compressed blocks are stored one after the other: read them all at
+  // once, then decompress and byte swap them concurrently. Each complete
+  // block is decompressed directly at its place in the output buffer.
+  const vtkTypeInt64 beginOffset = this->BlockStartOffsets[firstBlock];
+  const size_t compressedSize = static_cast<size_t>(this->BlockStartOffsets[endBlock - 1] +
+    this->BlockCompressedSizes[endBlock - 1] - beginOffset);
+
+  if (!this->DataStream->Seek(beginOffset))
+  {
+    return 0;
+  }
+  std::vector<unsigned char> readBuffer(compressedSize);
+  if (this->DataStream->Read(readBuffer.data(), compressedSize) < compressedSize)
+  {
+    return 0;
+  }
+
+  const size_t blockSize = this->BlockUncompressedSize;
+  std::atomic<bool> success(true);
+  vtkSMPTools::For(static_cast<vtkIdType>(firstBlock), static_cast<vtkIdType>(endBlock),
+    [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType block = begin; block < end && success; ++block)
+      {
+        unsigned char* outputPointer = buffer + (block - firstBlock) * blockSize;
+        if (!this->Compressor->Uncompress(
+              readBuffer.data() + (this->BlockStartOffsets[block] - beginOffset),
+              this->BlockCompressedSizes[block], outputPointer, blockSize))
+        {
+          success = false;
+          break;
+        }
+
+        // Byte swap this block.  Note that blockSize will always be an
+        // integer multiple of the word size.
+        this->PerformByteSwap(outputPointer, blockSize / wordSize, wordSize);
+      }
+    });
+
+  return success ? 1 : 0;
+}
+
 //------------------------------------------------------------------------------
 size_t vtkXMLDataParser::ReadUncompressedData(
   unsigned char* data, vtkTypeUInt64 startWord, size_t numWords, size_t wordSize)
@@ -811,21 +858,22 @@ size_t vtkXMLDataParser::ReadCompressedData(
     // Report progress.
     this->UpdateProgress(float(outputPointer - data) / length);
 
-    unsigned int currentBlock = firstBlock + 1;
-    for (; currentBlock != lastBlock && !this->Abort; ++currentBlock)
+    // Read the complete blocks in batches, so that several blocks can be
+    // decompressed concurrently while progress is still reported.
+    const vtkTypeUInt64 batchSize =
+      8 * static_cast<vtkTypeUInt64>(std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads()));
+    vtkTypeUInt64 currentBlock = firstBlock + 1;
+    while (currentBlock < lastBlock && !this->Abort)
     {
-      // Read this block.
-      if (!this->ReadBlock(currentBlock, outputPointer))
+      const vtkTypeUInt64 endBlock = std::min(currentBlock + batchSize, lastBlock);
+      if (!this->ReadCompleteBlocks(currentBlock, endBlock, outputPointer, wordSize))
       {
         return 0;
       }
 
-      // Byte swap this block.  Note that blockSize will always be an
-      // integer multiple of the word size.
-      this->PerformByteSwap(outputPointer, blockSize / wordSize, wordSize);
-
       // Advance the pointer to the beginning of the next block.
-      outputPointer += this->FindBlockSize(currentBlock);
+      outputPointer += (endBlock - currentBlock) * this->BlockUncompressedSize;
+      currentBlock = endBlock;
 
       // Report progress.
       this->UpdateProgress(float(outputPointer - data) / length);
@@ -158,6 +158,15 @@ public:
    */
   vtkTypeInt64 GetAppendedDataPosition() { return this->AppendedDataPosition; }
 
+  ///@{
+  /**
+   * Get the byte order (BigEndian or LittleEndian) and the size in bits of
+   * the headers (32 or 64) of binary data. Valid after the XML is parsed.
+   */
+  vtkGetMacro(ByteOrder, int);
+  vtkGetMacro(HeaderType, int);
+  ///@}
+
 protected:
   vtkXMLDataParser();
   ~vtkXMLDataParser() override;
@@ -186,6 +195,8 @@ protected:
   size_t FindBlockSize(vtkTypeUInt64 block);
   int ReadBlock(vtkTypeUInt64 block, unsigned char* buffer);
   unsigned char* ReadBlock(vtkTypeUInt64 block);
+  int ReadCompleteBlocks(
+    vtkTypeUInt64 firstBlock, vtkTypeUInt64 endBlock, unsigned char* buffer, size_t wordSize);
   size_t ReadUncompressedData(
     unsigned char* data, vtkTypeUInt64 startWord, size_t numWords, size_t wordSize);
   size_t ReadCompressedData(
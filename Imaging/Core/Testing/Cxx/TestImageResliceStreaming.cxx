@@ -0,0 +1,160 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageResliceStreaming.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkImageReslice generates the same output when it streams its
+// input in bricks, and that the input requested for each brick stays within
+// the memory limit.
+
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageReslice.h"
+#include "vtkImageStencilData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkTransform.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+
+struct SourceStatistics
+{
+  int Executions = 0;
+  vtkIdType MaxPoints = 0;
+};
+
+void CountExecution(vtkObject* caller, unsigned long, void* clientData, void*)
+{
+  SourceStatistics* stats = static_cast<SourceStatistics*>(clientData);
+  vtkRTAnalyticSource* source = static_cast<vtkRTAnalyticSource*>(caller);
+  stats->Executions++;
+  stats->MaxPoints = std::max(stats->MaxPoints, source->GetOutput()->GetNumberOfPoints());
+}
+
+bool SameScalars(vtkImageData* a, vtkImageData* b)
+{
+  vtkDataArray* sa = a->GetPointData()->GetScalars();
+  vtkDataArray* sb = b->GetPointData()->GetScalars();
+  if (sa->GetNumberOfValues() != sb->GetNumberOfValues())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < sa->GetNumberOfValues(); i++)
+  {
+    if (sa->GetVariantValue(i) != sb->GetVariantValue(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameStencils(vtkImageStencilData* a, vtkImageStencilData* b)
+{
+  int extent[6];
+  a->GetExtent(extent);
+  for (int z = extent[4]; z <= extent[5]; z++)
+  {
+    for (int y = extent[2]; y <= extent[3]; y++)
+    {
+      int iterA = 0;
+      int iterB = 0;
+      bool moreA = true;
+      while (moreA)
+      {
+        int a1 = 0, a2 = 0, b1 = 0, b2 = 0;
+        moreA = (a->GetNextExtent(a1, a2, extent[0], extent[1], y, z, iterA) != 0);
+        bool moreB = (b->GetNextExtent(b1, b2, extent[0], extent[1], y, z, iterB) != 0);
+        if (moreA != moreB || (moreA && (a1 != b1 || a2 != b2)))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestImageResliceStreaming(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-40, 40, -40, 40, -30, 30);
+
+  SourceStatistics stats;
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetCallback(CountExecution);
+  callback->SetClientData(&stats);
+  source->AddObserver(vtkCommand::EndEvent, callback);
+
+  vtkNew<vtkTransform> transform;
+  transform->RotateWXYZ(30., 1., 2., 3.);
+
+  vtkNew<vtkImageReslice> reslice;
+  reslice->SetInputConnection(source->GetOutputPort());
+  reslice->SetResliceAxes(transform->GetMatrix());
+  reslice->SetInterpolationModeToCubic();
+  reslice->SetOutputSpacing(0.8, 0.9, 1.1);
+  reslice->AutoCropOutputOn();
+  reslice->GenerateStencilOutputOn();
+  reslice->Update();
+
+  vtkNew<vtkImageData> expected;
+  expected->DeepCopy(reslice->GetOutput());
+  vtkNew<vtkImageStencilData> expectedStencil;
+  expectedStencil->DeepCopy(reslice->GetStencilOutput());
+
+  bool success = true;
+  const unsigned long limits[2] = { 256, 48 };
+  for (unsigned long limit : limits)
+  {
+    stats = SourceStatistics();
+    source->Modified();
+    reslice->SetStreamingMemoryLimit(limit);
+    reslice->Update();
+
+    // the source produces float scalars
+    vtkIdType maxPoints = static_cast<vtkIdType>(limit * 1024 / sizeof(float));
+    if (stats.Executions < 2 || stats.MaxPoints > maxPoints)
+    {
+      std::cerr << "Streaming with a limit of " << limit << " KiB executed the source "
+                << stats.Executions << " times with up to " << stats.MaxPoints << " points."
+                << std::endl;
+      success = false;
+    }
+
+    if (!SameScalars(expected, reslice->GetOutput()))
+    {
+      std::cerr << "Streaming with a limit of " << limit << " KiB changed the output."
+                << std::endl;
+      success = false;
+    }
+
+    if (!SameStencils(expectedStencil, reslice->GetStencilOutput()))
+    {
+      std::cerr << "Streaming with a limit of " << limit << " KiB changed the stencil."
+                << std::endl;
+      success = false;
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -25,6 +25,7 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
 
@@ -149,6 +150,12 @@ vtkImageReslice::vtkImageReslice()
   // the output stencil
   this->GenerateStencilOutput = 0;
 
+  // no streaming by default
+  this->StreamingMemoryLimit = 0;
+  this->StreamingBrick = 0;
+  this->StreamingBricks = vtkIntArray::New();
+  this->StreamingBricks->SetNumberOfComponents(6);
+
   // There is an optional second input (the stencil input)
   this->SetNumberOfInputPorts(2);
   // There is an optional second output (the stencil output)
@@ -176,6 +183,7 @@ vtkImageReslice::~vtkImageReslice()
   }
   this->SetInformationInput(nullptr);
   this->SetInterpolator(nullptr);
+  this->StreamingBricks->Delete();
 }
 
 //------------------------------------------------------------------------------
@@ -235,6 +243,7 @@ void vtkImageReslice::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Stencil: " << this->GetStencil() << "\n";
   os << indent << "GenerateStencilOutput: " << (this->GenerateStencilOutput ? "On\n" : "Off\n");
   os << indent << "StencilOutput: " << this->GetStencilOutput() << "\n";
+  os << indent << "StreamingMemoryLimit: " << this->StreamingMemoryLimit << "\n";
 }
 
 //------------------------------------------------------------------------------
@@ -556,6 +565,12 @@ int vtkImageReslice::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
   outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
   this->HitInputExtent = 1;
 
+  // the bricks are computed before the first one is generated
+  if (this->StreamingBrick == 0)
+  {
+    this->StreamingBricks->Reset();
+  }
+
   if (this->ResliceTransform)
   {
     this->ResliceTransform->Update();
@@ -567,12 +582,47 @@ int vtkImageReslice::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
     }
   }
 
+  vtkMatrix4x4* matrix = this->GetIndexMatrix(inInfo, outInfo);
+
+  // when streaming, request only the input needed for the current brick
+  if (this->StreamingMemoryLimit > 0)
+  {
+    if (this->StreamingBrick == 0)
+    {
+      this->ComputeStreamingBricks(inInfo, matrix, outExt, this->StreamingBricks);
+    }
+    this->StreamingBricks->GetTypedTuple(this->StreamingBrick, outExt);
+  }
+
+  this->HitInputExtent = this->ComputeInputUpdateExtent(inInfo, matrix, outExt, inExt);
+
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+
+  // need to set the stencil update extent to the output extent
+  if (this->GetNumberOfInputConnections(1) > 0)
+  {
+    vtkInformation* stencilInfo = inputVector[1]->GetInformationObject(0);
+    stencilInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt, 6);
+  }
+
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+int vtkImageReslice::ComputeInputUpdateExtent(
+  vtkInformation* inInfo, vtkMatrix4x4* matrix, const int extent[6], int inExt[6])
+{
+  int hitInputExtent = 1;
+  int outExt[6];
+  for (int i = 0; i < 6; i++)
+  {
+    outExt[i] = extent[i];
+  }
+
   bool wrap = (this->Wrap || this->Mirror);
 
   double xAxis[4], yAxis[4], zAxis[4], origin[4];
 
-  vtkMatrix4x4* matrix = this->GetIndexMatrix(inInfo, outInfo);
-
   // convert matrix from world coordinates to pixel indices
   for (int i = 0; i < 4; i++)
   {
@@ -690,7 +740,7 @@ int vtkImageReslice::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
       {
         // didn't hit any of the input extent
         inExt[2 * k + 1] = wholeExtent[2 * k];
-        this->HitInputExtent = 0;
+        hitInputExtent = 0;
       }
     }
     if (inExt[2 * k + 1] > wholeExtent[2 * k + 1])
@@ -709,21 +759,73 @@ int vtkImageReslice::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
         {
           inExt[2 * k] = wholeExtent[2 * k];
         }
-        this->HitInputExtent = 0;
+        hitInputExtent = 0;
       }
     }
   }
 
-  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+  return hitInputExtent;
+}
 
-  // need to set the stencil update extent to the output extent
-  if (this->GetNumberOfInputConnections(1) > 0)
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkImageReslice::ComputeInputUpdateSize(
+  vtkInformation* inInfo, vtkMatrix4x4* matrix, const int outExt[6])
+{
+  int inExt[6];
+  this->ComputeInputUpdateExtent(inInfo, matrix, outExt, inExt);
+
+  vtkTypeInt64 size = vtkAbstractArray::GetDataTypeSize(vtkImageData::GetScalarType(inInfo)) *
+    vtkImageData::GetNumberOfScalarComponents(inInfo);
+  for (int i = 0; i < 3; i++)
   {
-    vtkInformation* stencilInfo = inputVector[1]->GetInformationObject(0);
-    stencilInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt, 6);
+    size *= inExt[2 * i + 1] - inExt[2 * i] + 1;
   }
+  return size;
+}
 
-  return 1;
+//------------------------------------------------------------------------------
+void vtkImageReslice::ComputeStreamingBricks(
+  vtkInformation* inInfo, vtkMatrix4x4* matrix, const int outExt[6], vtkIntArray* bricks)
+{
+  vtkTypeInt64 limit = static_cast<vtkTypeInt64>(this->StreamingMemoryLimit) * 1024;
+  vtkTypeInt64 size = this->ComputeInputUpdateSize(inInfo, matrix, outExt);
+
+  // halve the longest axis, the bricks are listed depth first so that the
+  // bricks along each row of the output stencil are generated in order
+  int axis = -1;
+  int length = 1;
+  for (int i = 0; i < 3; i++)
+  {
+    if (outExt[2 * i + 1] - outExt[2 * i] + 1 > length)
+    {
+      length = outExt[2 * i + 1] - outExt[2 * i] + 1;
+      axis = i;
+    }
+  }
+
+  int lowerExt[6], upperExt[6];
+  for (int i = 0; i < 6; i++)
+  {
+    lowerExt[i] = outExt[i];
+    upperExt[i] = outExt[i];
+  }
+  if (axis >= 0)
+  {
+    lowerExt[2 * axis + 1] = outExt[2 * axis] + length / 2 - 1;
+    upperExt[2 * axis] = lowerExt[2 * axis + 1] + 1;
+  }
+
+  // stop when splitting does not reduce the input, e.g. when wrapping
+  if (size <= limit || axis < 0 ||
+    (this->ComputeInputUpdateSize(inInfo, matrix, lowerExt) >= size &&
+      this->ComputeInputUpdateSize(inInfo, matrix, upperExt) >= size))
+  {
+    bricks->InsertNextTypedTuple(outExt);
+    return;
+  }
+
+  this->ComputeStreamingBricks(inInfo, matrix, lowerExt, bricks);
+  this->ComputeStreamingBricks(inInfo, matrix, upperExt, bricks);
 }
 
 //------------------------------------------------------------------------------
@@ -3011,6 +3113,12 @@ int vtkImageReslice::RequestData(
     this->SplitPathLength = 2;
   }
 
+  // the output is generated brick by brick when streaming
+  if (this->StreamingBricks->GetNumberOfTuples() > 1)
+  {
+    return this->RequestStreamingData(request, inputVector, outputVector);
+  }
+
   vtkAbstractImageInterpolator* interpolator = this->GetInterpolator();
   vtkInformation* info = inputVector[0]->GetInformationObject(0);
   interpolator->Initialize(info->Get(vtkDataObject::DATA_OBJECT()));
@@ -3022,6 +3130,62 @@ int vtkImageReslice::RequestData(
   return rval;
 }
 
+//------------------------------------------------------------------------------
+// Generate one brick of the output, the pipeline executes the filter again
+// for each brick with the input extent that the brick needs
+int vtkImageReslice::RequestStreamingData(
+  vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkImageData* output = vtkImageData::GetData(outInfo);
+  vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+
+  // the whole output is allocated before the first brick is generated
+  if (this->StreamingBrick == 0)
+  {
+    int updateExtent[6];
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent);
+    this->AllocateOutputData(output, outInfo, updateExtent);
+    this->CopyAttributeData(input, output, inputVector);
+    request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+  }
+
+  vtkAbstractImageInterpolator* interpolator = this->GetInterpolator();
+  interpolator->Initialize(input);
+
+  // split the brick into pieces like the superclass does
+  vtkImageData* connections[2] = { input, output };
+  vtkImageData** inputs[2] = { &connections[0], nullptr };
+  vtkImageData** outputs = &connections[1];
+  int brickExt[6];
+  this->StreamingBricks->GetTypedTuple(this->StreamingBrick, brickExt);
+  int subExtent[6];
+  vtkIdType pieces =
+    this->SplitExtent(subExtent, brickExt, 0, vtkSMPTools::GetEstimatedNumberOfThreads());
+
+  // always shut off debugging to avoid threading problems with GetMacros
+  bool debug = this->Debug;
+  this->Debug = false;
+  vtkSMPTools::For(0, pieces, [&](vtkIdType begin, vtkIdType end) {
+    this->SMPRequestData(
+      request, inputVector, outputVector, inputs, outputs, begin, end, pieces, brickExt);
+  });
+  this->Debug = debug;
+
+  interpolator->ReleaseData();
+
+  vtkIdType numberOfBricks = this->StreamingBricks->GetNumberOfTuples();
+  this->StreamingBrick++;
+  this->UpdateProgress(static_cast<double>(this->StreamingBrick) / numberOfBricks);
+  if (this->StreamingBrick == numberOfBricks)
+  {
+    request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+    this->StreamingBrick = 0;
+  }
+
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 // This method is passed a input and output region, and executes the filter
 // algorithm to fill the output from the input.
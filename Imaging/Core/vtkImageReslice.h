@@ -43,6 +43,9 @@
  * You can use both the ResliceAxes and the ResliceTransform at the
  * same time, in order to extract slices from a volume that you have
  * applied a transformation to.
+ * <p>4) Reslicing of images that are too large to fit in memory, via
+ * SetStreamingMemoryLimit(), which generates the output in bricks and
+ * streams the input needed for each brick through the pipeline.
  * @warning
  * This filter is very inefficient if the output X dimension is 1.
  * @sa
@@ -64,6 +67,7 @@ class vtkImageData;
 class vtkAbstractTransform;
 class vtkMatrix4x4;
 class vtkImageStencilData;
+class vtkIntArray;
 class vtkScalarsToColors;
 class vtkAbstractImageInterpolator;
 
@@ -492,6 +496,20 @@ public:
   void SetStencilOutput(vtkImageStencilData* stencil);
   ///@}
 
+  ///@{
+  /**
+   * Set the maximum amount of input data, in kibibytes, to request from
+   * the upstream pipeline at once.  When non-zero, the output is split
+   * into bricks that each need less input than this limit, and the input
+   * is updated once per brick, so that images that do not fit in memory
+   * can be resliced.  The output itself is allocated in full.  This has
+   * no effect with a nonlinear ResliceTransform, which needs the whole
+   * input.  The default is zero, which disables streaming.
+   */
+  vtkSetMacro(StreamingMemoryLimit, unsigned long);
+  vtkGetMacro(StreamingMemoryLimit, unsigned long);
+  ///@}
+
 protected:
   vtkImageReslice();
   ~vtkImageReslice() override;
@@ -528,6 +546,9 @@ protected:
   int ComputeOutputOrigin;
   int ComputeOutputExtent;
   vtkTypeBool GenerateStencilOutput;
+  unsigned long StreamingMemoryLimit;
+  vtkIdType StreamingBrick;
+  vtkIntArray* StreamingBricks;
 
   vtkMatrix4x4* IndexMatrix;
   vtkAbstractTransform* OptimizedTransform;
@@ -584,6 +605,32 @@ protected:
   vtkMatrix4x4* GetIndexMatrix(vtkInformation* inInfo, vtkInformation* outInfo);
   vtkAbstractTransform* GetOptimizedTransform() { return this->OptimizedTransform; }
 
+  /**
+   * Compute the input extent that is needed to generate the given output
+   * extent, returns zero if the output extent misses the input.
+   */
+  int ComputeInputUpdateExtent(
+    vtkInformation* inInfo, vtkMatrix4x4* matrix, const int outExt[6], int inExt[6]);
+
+  /**
+   * Compute the size in bytes of the input that is needed to generate the
+   * given output extent.
+   */
+  vtkTypeInt64 ComputeInputUpdateSize(
+    vtkInformation* inInfo, vtkMatrix4x4* matrix, const int outExt[6]);
+
+  /**
+   * Split the output extent into bricks whose input extents fit within
+   * the StreamingMemoryLimit, the bricks are appended to the array.
+   */
+  void ComputeStreamingBricks(
+    vtkInformation* inInfo, vtkMatrix4x4* matrix, const int outExt[6], vtkIntArray* bricks);
+
+  /**
+   * Generate the current brick of the output when streaming.
+   */
+  int RequestStreamingData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
+
 private:
   vtkImageReslice(const vtkImageReslice&) = delete;
   void operator=(const vtkImageReslice&) = delete;
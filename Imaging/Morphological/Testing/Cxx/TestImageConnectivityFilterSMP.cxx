@@ -0,0 +1,172 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageConnectivityFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the regions found by vtkImageConnectivityFilter and
+// vtkImageThresholdConnectivity, and that they do not depend on the number
+// of threads.
+
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageConnectivityFilter.h"
+#include "vtkImageData.h"
+#include "vtkImageThresholdConnectivity.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSmartPointer.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+// Run a filter sequentially then with several threads and compare the outputs
+bool CheckFilter(const std::string& name, vtkAlgorithm* filter)
+{
+  auto outputs = vtkTest::RunSequentialAndThreaded([&]() -> vtkSmartPointer<vtkImageData> {
+    filter->Modified();
+    filter->Update();
+    vtkNew<vtkImageData> output;
+    output->DeepCopy(filter->GetOutputDataObject(0));
+    return output.GetPointer();
+  });
+
+  if (!vtkTest::SameArrays(
+        outputs.first->GetPointData()->GetScalars(), outputs.second->GetPointData()->GetScalars()))
+  {
+    std::cerr << name << " output depends on the number of threads." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Check that the voxels of the regions are labeled and the others are not,
+// and that the bar has the label of the cubes it joins
+bool CheckLabels(vtkImageData* image, vtkImageData* labels)
+{
+  vtkDataArray* in = image->GetPointData()->GetScalars();
+  vtkDataArray* out = labels->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < in->GetNumberOfTuples(); ++i)
+  {
+    if ((in->GetComponent(i, 0) != 0.) != (out->GetComponent(i, 0) != 0.))
+    {
+      std::cerr << "vtkImageConnectivityFilter labeled voxel " << i << " wrongly." << std::endl;
+      return false;
+    }
+  }
+  int bar[3] = { 2, 2, 6 };
+  int cube[3] = { 0, 0, 0 };
+  if (out->GetComponent(labels->ComputePointId(bar), 0) != 1. ||
+    out->GetComponent(labels->ComputePointId(cube), 0) != 1.)
+  {
+    std::cerr << "vtkImageConnectivityFilter did not label the largest region 1." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+int TestImageConnectivityFilterSMP(int, char*[])
+{
+  // A checkerboard of 4x4x4 cubes, the cubes only share edges so each one is
+  // a region, except for those of the first column that are joined by a bar
+  // along z crossing all the slabs of the image
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(64, 48, 40);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* ptr = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int z = 0; z < 40; z++)
+  {
+    for (int y = 0; y < 48; y++)
+    {
+      for (int x = 0; x < 64; x++)
+      {
+        bool bar = (x == 2 && y == 2);
+        *ptr++ = ((x / 4 + y / 4 + z / 4) % 2 == 0 || bar ? 1 : 0);
+      }
+    }
+  }
+
+  bool success = true;
+
+  vtkNew<vtkImageConnectivityFilter> connectivity;
+  connectivity->SetInputData(image);
+  connectivity->SetScalarRange(1., 1.);
+  connectivity->SetExtractionModeToAllRegions();
+  connectivity->SetLabelModeToSizeRank();
+  connectivity->SetLabelScalarTypeToShort();
+  connectivity->GenerateRegionExtentsOn();
+  success &= CheckFilter("vtkImageConnectivityFilter", connectivity);
+  success &= CheckLabels(image, connectivity->GetOutput());
+
+  // 960 cubes, the 5 cubes of the first column and the bar form one region
+  int* extent = connectivity->GetExtractedRegionExtents()->GetPointer(0);
+  if (connectivity->GetNumberOfExtractedRegions() != 956 ||
+    connectivity->GetExtractedRegionSizes()->GetValue(0) != 5 * 64 + 5 * 4 ||
+    connectivity->GetExtractedRegionSizes()->GetValue(955) != 64 || extent[0] != 0 ||
+    extent[1] != 3 || extent[2] != 0 || extent[3] != 3 || extent[4] != 0 || extent[5] != 39)
+  {
+    std::cerr << "vtkImageConnectivityFilter found wrong regions." << std::endl;
+    success = false;
+  }
+
+  // More regions than labels, they are pruned while being found
+  connectivity->SetLabelScalarTypeToUnsignedChar();
+  connectivity->SetLabelModeToSeedScalar();
+  connectivity->SetSizeRange(2, VTK_ID_MAX);
+  success &= CheckFilter("vtkImageConnectivityFilter", connectivity);
+
+  vtkNew<vtkPoints> points;
+  points->InsertNextPoint(2., 2., 20.);
+  points->InsertNextPoint(10., 30., 7.);
+  points->InsertNextPoint(9., 30., 7.);
+  vtkNew<vtkPolyData> seeds;
+  seeds->SetPoints(points);
+  connectivity->SetSeedData(seeds);
+  connectivity->SetExtractionModeToSeededRegions();
+  success &= CheckFilter("vtkImageConnectivityFilter", connectivity);
+  if (connectivity->GetNumberOfExtractedRegions() != 2 ||
+    connectivity->GetExtractedRegionSeedIds()->GetValue(1) != 1)
+  {
+    std::cerr << "vtkImageConnectivityFilter found wrong seeded regions." << std::endl;
+    success = false;
+  }
+
+  vtkNew<vtkImageThresholdConnectivity> threshold;
+  threshold->SetInputData(image);
+  threshold->SetSeedPoints(points);
+  threshold->ThresholdByUpper(1.);
+  threshold->ReplaceInOn();
+  threshold->SetInValue(2.);
+  success &= CheckFilter("vtkImageThresholdConnectivity", threshold);
+  if (threshold->GetNumberOfInVoxels() != 5 * 64 + 5 * 4 + 64)
+  {
+    std::cerr << "vtkImageThresholdConnectivity filled " << threshold->GetNumberOfInVoxels()
+              << " voxels." << std::endl;
+    success = false;
+  }
+
+  // The bar is too thin to be within a neighborhood
+  threshold->SetNeighborhoodRadius(1., 1., 1.);
+  threshold->SetNeighborhoodFraction(0.9);
+  success &= CheckFilter("vtkImageThresholdConnectivity", threshold);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
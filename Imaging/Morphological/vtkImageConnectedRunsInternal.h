@@ -0,0 +1,346 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageConnectedRunsInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkImageConnectedRuns
+ * @brief   parallel labeling of the 6-connected components of an image
+ *
+ * The foreground voxels of an image are stored as runs, i.e. ranges of
+ * consecutive voxels along a row, built concurrently plane by plane. The runs
+ * of each slab of planes are then joined with a union-find, the slabs being
+ * processed concurrently before their boundary planes are joined. Two runs
+ * are connected when they overlap in adjacent rows of a plane or in the same
+ * row of adjacent planes.
+ *
+ * Components are numbered in the order of their first voxel in memory order,
+ * the order in which a raster scan of the image would discover them. The
+ * result does not depend on the number of threads.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkImageConnectivityFilter vtkImageThresholdConnectivity
+ */
+
+#ifndef vtkImageConnectedRunsInternal_h
+#define vtkImageConnectedRunsInternal_h
+
+#include "vtkSMPTools.h"
+#include "vtkType.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+class vtkImageConnectedRuns
+{
+public:
+  // Consecutive voxels of a row, from X0 to X1 included
+  struct Run
+  {
+    int X0;
+    int X1;
+  };
+
+  //----------------------------------------------------------------------------
+  // Build the runs of an image of dims[0] x dims[1] x dims[2] voxels, indexed
+  // from 0. rowRuns(y, z, runs) must append the runs of row (y, z) to runs in
+  // increasing order, it is called concurrently for distinct planes.
+  template <typename RowRunsFunctor>
+  void Build(const int dims[3], RowRunsFunctor&& rowRuns)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      this->Dims[i] = dims[i];
+    }
+    const vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+    this->RowOffsets.assign(numRows + 1, 0);
+
+    // Runs of each plane, then concatenated in plane order
+    std::vector<std::vector<Run>> planeRuns(dims[2]);
+    vtkSMPTools::For(0, dims[2], [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType z = begin; z < end; ++z)
+      {
+        std::vector<Run>& runs = planeRuns[z];
+        for (int y = 0; y < dims[1]; ++y)
+        {
+          rowRuns(y, static_cast<int>(z), runs);
+          this->RowOffsets[z * dims[1] + y + 1] = static_cast<vtkIdType>(runs.size());
+        }
+      }
+    });
+
+    std::vector<vtkIdType> planeOffsets(dims[2] + 1, 0);
+    for (int z = 0; z < dims[2]; ++z)
+    {
+      planeOffsets[z + 1] = planeOffsets[z] + static_cast<vtkIdType>(planeRuns[z].size());
+    }
+    this->Runs.resize(planeOffsets[dims[2]]);
+    vtkSMPTools::For(0, dims[2], [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType z = begin; z < end; ++z)
+      {
+        std::copy(planeRuns[z].begin(), planeRuns[z].end(), this->Runs.begin() + planeOffsets[z]);
+        std::vector<Run>().swap(planeRuns[z]);
+        for (int y = 0; y < dims[1]; ++y)
+        {
+          this->RowOffsets[z * dims[1] + y + 1] += planeOffsets[z];
+        }
+      }
+    });
+  }
+
+  //----------------------------------------------------------------------------
+  // Label the connected components of the runs.
+  void Label()
+  {
+    const vtkIdType numRuns = this->GetNumberOfRuns();
+    const int numPlanes = this->Dims[2];
+    std::vector<vtkIdType> parents(numRuns);
+    vtkSMPTools::For(0, numRuns, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        parents[i] = i;
+      }
+    });
+
+    // Join the runs within each slab of planes, then across slabs. The root
+    // of a set is its smallest run so that the result does not depend on the
+    // order of the unions.
+    const int numSlabs = std::min(numPlanes, 4 * vtkSMPTools::GetEstimatedNumberOfThreads());
+    auto slabBegin = [&](vtkIdType slab) {
+      return static_cast<int>(slab * numPlanes / std::max(numSlabs, 1));
+    };
+    vtkSMPTools::For(0, numSlabs, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType slab = begin; slab < end; ++slab)
+      {
+        for (int z = slabBegin(slab); z < slabBegin(slab + 1); ++z)
+        {
+          this->JoinPlane(parents, z, z > slabBegin(slab));
+        }
+      }
+    });
+    for (int slab = 1; slab < numSlabs; ++slab)
+    {
+      const int z = slabBegin(slab);
+      for (int y = 0; y < this->Dims[1]; ++y)
+      {
+        this->JoinRows(parents, this->GetRow(y, z), this->GetRow(y, z - 1));
+      }
+    }
+
+    // Number the components by increasing root, each root preceding the
+    // other runs of its set
+    this->Components.resize(numRuns);
+    vtkSMPTools::For(0, numRuns, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        vtkIdType root = i;
+        while (parents[root] != root)
+        {
+          root = parents[root];
+        }
+        this->Components[i] = root;
+      }
+    });
+    this->NumberOfComponents = 0;
+    for (vtkIdType i = 0; i < numRuns; ++i)
+    {
+      const vtkIdType root = this->Components[i];
+      this->Components[i] = (root == i ? this->NumberOfComponents++ : this->Components[root]);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  vtkIdType GetNumberOfRuns() const { return static_cast<vtkIdType>(this->Runs.size()); }
+  vtkIdType GetNumberOfComponents() const { return this->NumberOfComponents; }
+  const Run& GetRun(vtkIdType run) const { return this->Runs[run]; }
+  vtkIdType GetComponent(vtkIdType run) const { return this->Components[run]; }
+
+  // Index of the row (y, z), its runs are [GetRowBegin(row), GetRowBegin(row + 1))
+  vtkIdType GetRow(int y, int z) const { return static_cast<vtkIdType>(z) * this->Dims[1] + y; }
+  vtkIdType GetRowBegin(vtkIdType row) const { return this->RowOffsets[row]; }
+
+  // Run containing voxel (x, y, z), -1 if it is not a foreground voxel
+  vtkIdType FindRun(int x, int y, int z) const
+  {
+    const vtkIdType row = this->GetRow(y, z);
+    auto first = this->Runs.begin() + this->RowOffsets[row];
+    auto last = this->Runs.begin() + this->RowOffsets[row + 1];
+    auto it = std::upper_bound(
+      first, last, x, [](int value, const Run& run) { return value < run.X0; });
+    if (it == first || (--it)->X1 < x)
+    {
+      return -1;
+    }
+    return static_cast<vtkIdType>(it - this->Runs.begin());
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of voxels of each component
+  std::vector<vtkIdType> ComputeComponentSizes() const
+  {
+    std::vector<vtkIdType> sizes(this->NumberOfComponents, 0);
+    for (vtkIdType i = 0; i < this->GetNumberOfRuns(); ++i)
+    {
+      sizes[this->Components[i]] += this->Runs[i].X1 - this->Runs[i].X0 + 1;
+    }
+    return sizes;
+  }
+
+  // Bounding extent of each component, 6 values per component
+  std::vector<int> ComputeComponentExtents() const
+  {
+    std::vector<int> extents(6 * this->NumberOfComponents);
+    std::vector<bool> found(this->NumberOfComponents, false);
+    for (int z = 0; z < this->Dims[2]; ++z)
+    {
+      for (int y = 0; y < this->Dims[1]; ++y)
+      {
+        const vtkIdType row = this->GetRow(y, z);
+        for (vtkIdType i = this->RowOffsets[row]; i < this->RowOffsets[row + 1]; ++i)
+        {
+          const vtkIdType component = this->Components[i];
+          int* extent = &extents[6 * component];
+          const Run& run = this->Runs[i];
+          if (!found[component])
+          {
+            found[component] = true;
+            extent[0] = run.X0;
+            extent[1] = run.X1;
+            extent[2] = extent[3] = y;
+            extent[4] = extent[5] = z;
+            continue;
+          }
+          extent[0] = std::min(extent[0], run.X0);
+          extent[1] = std::max(extent[1], run.X1);
+          extent[2] = std::min(extent[2], y);
+          extent[3] = std::max(extent[3], y);
+          extent[5] = z;
+        }
+      }
+    }
+    return extents;
+  }
+
+  // First voxel of each component in memory order, 3 values per component
+  std::vector<int> ComputeComponentFirstVoxels() const
+  {
+    std::vector<int> voxels(3 * this->NumberOfComponents);
+    vtkIdType next = 0;
+    for (int z = 0; z < this->Dims[2] && next < this->NumberOfComponents; ++z)
+    {
+      for (int y = 0; y < this->Dims[1]; ++y)
+      {
+        const vtkIdType row = this->GetRow(y, z);
+        for (vtkIdType i = this->RowOffsets[row]; i < this->RowOffsets[row + 1]; ++i)
+        {
+          // components are numbered in the order of their first run
+          if (this->Components[i] == next)
+          {
+            voxels[3 * next] = this->Runs[i].X0;
+            voxels[3 * next + 1] = y;
+            voxels[3 * next + 2] = z;
+            ++next;
+          }
+        }
+      }
+    }
+    return voxels;
+  }
+
+private:
+  static vtkIdType Find(std::vector<vtkIdType>& parents, vtkIdType i)
+  {
+    while (parents[i] != i)
+    {
+      parents[i] = parents[parents[i]];
+      i = parents[i];
+    }
+    return i;
+  }
+
+  static void Union(std::vector<vtkIdType>& parents, vtkIdType i, vtkIdType j)
+  {
+    i = Find(parents, i);
+    j = Find(parents, j);
+    if (i < j)
+    {
+      parents[j] = i;
+    }
+    else if (j < i)
+    {
+      parents[i] = j;
+    }
+  }
+
+  // Join the overlapping runs of two rows
+  void JoinRows(std::vector<vtkIdType>& parents, vtkIdType rowA, vtkIdType rowB) const
+  {
+    vtkIdType a = this->RowOffsets[rowA];
+    vtkIdType b = this->RowOffsets[rowB];
+    const vtkIdType aEnd = this->RowOffsets[rowA + 1];
+    const vtkIdType bEnd = this->RowOffsets[rowB + 1];
+    while (a < aEnd && b < bEnd)
+    {
+      const Run& runA = this->Runs[a];
+      const Run& runB = this->Runs[b];
+      if (runA.X0 <= runB.X1 && runB.X0 <= runA.X1)
+      {
+        Union(parents, a, b);
+      }
+      // move on with the run ending first
+      if (runA.X1 < runB.X1)
+      {
+        ++a;
+      }
+      else
+      {
+        ++b;
+      }
+    }
+  }
+
+  // Join the runs of plane z, and with the previous plane if requested
+  void JoinPlane(std::vector<vtkIdType>& parents, int z, bool withPreviousPlane) const
+  {
+    for (int y = 0; y < this->Dims[1]; ++y)
+    {
+      if (y > 0)
+      {
+        this->JoinRows(parents, this->GetRow(y, z), this->GetRow(y - 1, z));
+      }
+      if (withPreviousPlane)
+      {
+        this->JoinRows(parents, this->GetRow(y, z), this->GetRow(y, z - 1));
+      }
+    }
+  }
+
+  int Dims[3] = { 0, 0, 0 };
+  std::vector<Run> Runs;
+  std::vector<vtkIdType> RowOffsets;
+  std::vector<vtkIdType> Components;
+  vtkIdType NumberOfComponents = 0;
+};
+
+} // anonymous namespace
+
+#endif // vtkImageConnectedRunsInternal_h
+// VTK-HeaderTest-Exclude: vtkImageConnectedRunsInternal.h
@@ -45,13 +45,12 @@
 =========================================================================*/
 
 #include "vtkImageConnectivityFilter.h"
+#include "vtkImageConnectedRunsInternal.h"
 
 #include "vtkDataSet.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
-#include "vtkImageIterator.h"
 #include "vtkImageStencilData.h"
-#include "vtkImageStencilIterator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
@@ -59,6 +58,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTemplateAliasMacro.h"
@@ -66,7 +66,6 @@
 #include "vtkVersion.h"
 
 #include <algorithm>
-#include <stack>
 #include <vector>
 
 vtkStandardNewMacro(vtkImageConnectivityFilter);
@@ -259,49 +258,35 @@ public:
   class RegionVector;
 
 protected:
-  // Simple class that holds a seed location and a scalar value.
-  class Seed;
-
   // A functor to assist in comparing region sizes.
   struct CompareSize;
 
-  // Remove all but the largest region from the output image.
-  template <class OT>
-  static void PruneAllButLargest(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-    int extent[6], const OT& value, vtkICF::RegionVector& regionInfo);
+  // Remove all but the largest region from the list of regions.
+  static void PruneAllButLargest(vtkICF::RegionVector& regionInfo);
 
-  // Remove the smallest region from the output image.
+  // Remove the smallest region from the list of regions.
   // This is called when there are no labels left, i.e. when the label
   // value reaches the maximum allowed by the output data type.
-  template <class OT>
-  static void PruneSmallestRegion(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-    int extent[6], vtkICF::RegionVector& regionInfo);
+  static void PruneSmallestRegion(vtkICF::RegionVector& regionInfo);
 
   // Remove all islands that aren't in the given range of sizes
-  template <class OT>
-  static void PruneBySize(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-    int extent[6], vtkIdType sizeRange[2], vtkICF::RegionVector& regionInfo);
-
-  // This is the function that grows a region from a seed.
-  template <class OT>
-  static vtkIdType Fill(OT* outPtr, vtkIdType outInc[3], int outLimits[6], unsigned char* maskPtr,
-    int maxIdx[3], int fillExtent[6], std::stack<vtkICF::Seed>& seedStack);
+  static void PruneBySize(vtkIdType sizeRange[2], vtkICF::RegionVector& regionInfo);
 
   // Add a region to the list of regions.
   template <class OT>
-  static void AddRegion(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-    int extent[6], vtkIdType sizeRange[2], vtkICF::RegionVector& regionInfo, vtkIdType voxelCount,
-    vtkIdType regionId, int regionExtent[6], int extractionMode);
+  static void AddRegion(vtkIdType sizeRange[2], vtkICF::RegionVector& regionInfo,
+    vtkIdType voxelCount, vtkIdType regionId, const int regionExtent[6], vtkIdType component,
+    int extractionMode);
 
   // Fill the ExtractedRegionSizes and ExtractedRegionLabels arrays.
   static void GenerateRegionArrays(vtkImageConnectivityFilter* self,
     vtkICF::RegionVector& regionInfo, vtkDataArray* seedScalars, int extent[6], int minLabel,
     int maxLabel);
 
-  // Relabel the image, usually the last method called.
+  // Label the voxels of the output with the label of their component.
   template <class OT>
-  static void Relabel(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-    int extent[6], vtkIdTypeArray* labelMap);
+  static void WriteOutput(vtkImageData* outData, OT* outPtr, int extent[6],
+    const vtkImageConnectedRuns& runs, const std::vector<OT>& componentLabels);
 
   // Sort the ExtractedRegionLabels array and the other arrays.
   static void SortRegionArrays(vtkImageConnectivityFilter* self);
@@ -309,36 +294,32 @@ protected:
   // Finalize the output
   template <class OT>
   static void Finish(vtkImageConnectivityFilter* self, vtkImageData* outData, OT* outPtr,
-    vtkImageStencilData* stencil, int extent[6], vtkDataArray* seedScalars,
-    vtkICF::RegionVector& regionInfo);
-
-  // Subtract the lower extent limit from "limits", and return the
-  // extent size subtract 1 in maxIdx.
-  static int* ZeroBaseExtent(const int wholeExtent[6], int extent[6], int maxIdx[3]);
+    int extent[6], vtkDataArray* seedScalars, vtkICF::RegionVector& regionInfo,
+    const vtkImageConnectedRuns& runs);
 
   // Execute method for when point seeds are provided.
   template <class OT>
   static void SeededExecute(vtkImageConnectivityFilter* self, vtkImageData* outData,
-    vtkDataSet* seedData, vtkImageStencilData* stencil, OT* outPtr, unsigned char* maskPtr,
-    int extent[6], vtkICF::RegionVector& regionInfo);
+    vtkDataSet* seedData, int extent[6], const vtkImageConnectedRuns& runs,
+    const std::vector<vtkIdType>& sizes, const std::vector<int>& extents,
+    std::vector<bool>& extracted, vtkICF::RegionVector& regionInfo);
 
   // Execute method for when no seeds are provided.
   template <class OT>
-  static void SeedlessExecute(vtkImageConnectivityFilter* self, vtkImageData* outData,
-    vtkImageStencilData* stencil, OT* outPtr, unsigned char* maskPtr, int extent[6],
-    vtkICF::RegionVector& regionInfo);
+  static void SeedlessExecute(vtkImageConnectivityFilter* self, const vtkImageConnectedRuns& runs,
+    const std::vector<vtkIdType>& sizes, const std::vector<int>& extents,
+    std::vector<bool>& extracted, vtkICF::RegionVector& regionInfo);
 
 public:
-  // Create a bit mask from the input
+  // Find the connected components of the voxels within the scalar range
   template <class IT>
   static void ExecuteInput(vtkImageConnectivityFilter* self, vtkImageData* inData, IT* inPtr,
-    unsigned char* maskPtr, vtkImageStencilData* stencil, int extent[6]);
+    vtkImageStencilData* stencil, int extent[6], vtkImageConnectedRuns& runs);
 
   // Generate the output
   template <class OT>
   static void ExecuteOutput(vtkImageConnectivityFilter* self, vtkImageData* outData,
-    vtkDataSet* seedData, vtkImageStencilData* stencil, OT* outPtr, unsigned char* maskPtr,
-    int extent[6]);
+    vtkDataSet* seedData, OT* outPtr, int extent[6], const vtkImageConnectedRuns& runs);
 
   // Utility method to find the intersection of two extents.
   // Returns false if the extents do not intersect.
@@ -346,57 +327,13 @@ public:
 };
 
 //------------------------------------------------------------------------------
-// seed struct: structured coordinates and a value,
-// the coords can be accessed with [] and the value with *
-class vtkICF::Seed
-{
-public:
-  Seed(int i, int j, int k, int v)
-  {
-    pos[0] = i;
-    pos[1] = j;
-    pos[2] = k;
-    value = v;
-  }
-
-  Seed(const vtkICF::Seed& seed)
-  {
-    pos[0] = seed.pos[0];
-    pos[1] = seed.pos[1];
-    pos[2] = seed.pos[2];
-    value = seed.value;
-  }
-
-  int& operator[](int i) { return pos[i]; }
-
-  int& operator*() { return value; }
-
-  vtkICF::Seed& operator=(const vtkICF::Seed& seed)
-  {
-    if (this == &seed)
-    {
-      return *this;
-    }
-
-    pos[0] = seed.pos[0];
-    pos[1] = seed.pos[1];
-    pos[2] = seed.pos[2];
-    value = seed.value;
-    return *this;
-  }
-
-private:
-  int pos[3];
-  int value;
-};
-
-//------------------------------------------------------------------------------
-// region struct: size and id
+// region struct: size, id and the connected component of the voxels
 struct vtkICF::Region
 {
-  Region(vtkIdType s, vtkIdType i, const int e[6])
+  Region(vtkIdType s, vtkIdType i, const int e[6], vtkIdType c = -1)
     : size(s)
     , id(i)
+    , component(c)
   {
     extent[0] = e[0];
     extent[1] = e[1];
@@ -408,6 +345,7 @@ struct vtkICF::Region
   Region()
     : size(0)
     , id(0)
+    , component(-1)
   {
     extent[0] = extent[1] = extent[2] = 0;
     extent[3] = extent[4] = extent[5] = 0;
@@ -415,6 +353,7 @@ struct vtkICF::Region
 
   vtkIdType size;
   vtkIdType id;
+  vtkIdType component;
   int extent[6];
 };
 
@@ -481,8 +420,8 @@ bool vtkICF::IntersectExtents(const int extent1[6], const int extent2[6], int ou
 
 //------------------------------------------------------------------------------
 template <class IT>
-void vtkICF::ExecuteInput(vtkImageConnectivityFilter* self, vtkImageData* inData, IT*,
-  unsigned char* maskPtr, vtkImageStencilData* stencil, int extent[6])
+void vtkICF::ExecuteInput(vtkImageConnectivityFilter* self, vtkImageData* inData, IT* inPtr,
+  vtkImageStencilData* stencil, int extent[6], vtkImageConnectedRuns& runs)
 {
   // Get active component (only one component is thresholded)
   int nComponents = inData->GetNumberOfScalarComponents();
@@ -515,340 +454,147 @@ void vtkICF::ExecuteInput(vtkImageConnectivityFilter* self, vtkImageData* inData
     srange[1] = static_cast<IT>(drange[1]);
   }
 
-  // offset into the mask
-  unsigned char* maskPtr1 = maskPtr;
-  unsigned char bit = 1;
-  unsigned char bits = 0;
+  vtkIdType inInc[3];
+  inData->GetIncrements(inInc);
+  int dims[3];
+  dims[0] = extent[1] - extent[0] + 1;
+  dims[1] = extent[3] - extent[2] + 1;
+  dims[2] = extent[5] - extent[4] + 1;
+
+  // the runs of each row are the spans of voxels within the scalar range,
+  // clipped by the stencil, indexed from the lower bound of "extent"
+  runs.Build(dims, [&](int yIdx, int zIdx, std::vector<vtkImageConnectedRuns::Run>& rowRuns) {
+    const size_t rowBegin = rowRuns.size();
+    const IT* rowPtr = inPtr + yIdx * inInc[1] + zIdx * inInc[2] + activeComponent;
+
+    auto addRun = [&](int x0, int x1) {
+      // stencil sub-extents may touch each other
+      if (rowRuns.size() > rowBegin && rowRuns.back().X1 + 1 == x0)
+      {
+        rowRuns.back().X1 = x1;
+      }
+      else
+      {
+        rowRuns.push_back({ x0, x1 });
+      }
+    };
 
-  vtkImageStencilIterator<IT> iter(inData, stencil, extent);
-  for (; !iter.IsAtEnd(); iter.NextSpan())
-  {
-    IT* inPtr = iter.BeginSpan();
-    IT* inPtrEnd = iter.EndSpan();
-    if (iter.IsInStencil())
-    {
-      while (inPtr != inPtrEnd)
+    auto addSpan = [&](int x0, int x1) {
+      int runStart = -1;
+      for (int xIdx = x0; xIdx <= x1; xIdx++)
       {
-        IT val = inPtr[activeComponent];
+        IT val = rowPtr[xIdx * inInc[0]];
         if (val < srange[0] || val > srange[1])
         {
-          bits ^= bit;
+          if (runStart >= 0)
+          {
+            addRun(runStart, xIdx - 1);
+            runStart = -1;
+          }
         }
-        bit <<= 1;
-        if (bit == 0)
+        else if (runStart < 0)
         {
-          *maskPtr1++ = bits;
-          bits = 0;
-          bit = 1;
+          runStart = xIdx;
         }
-        inPtr += nComponents;
       }
+      if (runStart >= 0)
+      {
+        addRun(runStart, x1);
+      }
+    };
+
+    if (!stencil)
+    {
+      addSpan(0, dims[0] - 1);
+      return;
     }
-    else
+
+    int r1, r2;
+    int iter = 0;
+    int moreSubExtents = 1;
+    while (moreSubExtents)
     {
-      // set all bits that are outside the stencil region
-      while (inPtr != inPtrEnd)
+      moreSubExtents = stencil->GetNextExtent(
+        r1, r2, extent[0], extent[1], yIdx + extent[2], zIdx + extent[4], iter);
+      if (r1 <= r2)
       {
-        bits ^= bit;
-        bit <<= 1;
-        if (bit == 0)
-        {
-          *maskPtr1++ = bits;
-          bits = 0;
-          bit = 1;
-        }
-        inPtr += nComponents;
+        addSpan(r1 - extent[0], r2 - extent[0]);
       }
     }
-  }
+  });
 
-  // write the last byte to the bitmask
-  if (bit != 1)
-  {
-    *maskPtr1++ = bits;
-  }
+  runs.Label();
 }
 
 //------------------------------------------------------------------------------
-template <class OT>
-void vtkICF::PruneAllButLargest(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-  int extent[6], const OT& value, vtkICF::RegionVector& regionInfo)
+void vtkICF::PruneAllButLargest(vtkICF::RegionVector& regionInfo)
 {
-  // clip the extent with the output extent
-  int outExt[6];
-  outData->GetExtent(outExt);
-  if (!vtkICF::IntersectExtents(outExt, extent, outExt))
-  {
-    return;
-  }
-
   // find the largest region
   vtkICF::RegionVector::iterator largest = regionInfo.largest();
   if (largest != regionInfo.end())
   {
-    // get its position, remove all other regions from the list
-    OT t = std::distance(regionInfo.begin(), largest);
+    // remove all other regions from the list
     regionInfo[1] = *largest;
     regionInfo.erase(regionInfo.begin() + 2, regionInfo.end());
-
-    // remove all other regions from the output
-    vtkImageStencilIterator<OT> iter(outData, stencil, outExt);
-    for (; !iter.IsAtEnd(); iter.NextSpan())
-    {
-      if (iter.IsInStencil())
-      {
-        outPtr = iter.BeginSpan();
-        OT* endPtr = iter.EndSpan();
-        for (; outPtr != endPtr; ++outPtr)
-        {
-          OT v = *outPtr;
-          if (v == t)
-          {
-            *outPtr = value;
-          }
-          else if (v != 0)
-          {
-            *outPtr = 0;
-          }
-        }
-      }
-    }
   }
 }
 
 //------------------------------------------------------------------------------
-template <class OT>
-void vtkICF::PruneSmallestRegion(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-  int extent[6], vtkICF::RegionVector& regionInfo)
+void vtkICF::PruneSmallestRegion(vtkICF::RegionVector& regionInfo)
 {
-  // clip the extent with the output extent
-  int outExt[6];
-  outData->GetExtent(outExt);
-  if (!vtkICF::IntersectExtents(outExt, extent, outExt))
-  {
-    return;
-  }
-
-  // find the smallest region
+  // find the smallest region and remove it, the labels of the following
+  // regions are shifted down since they are the positions in the list
   vtkICF::RegionVector::iterator smallest = regionInfo.smallest();
   if (smallest != regionInfo.end())
   {
-    // get the index to the smallest value and remove it
-    OT t = std::distance(regionInfo.begin(), smallest);
     regionInfo.erase(smallest);
-
-    // remove the corresponding region from the output
-    vtkImageStencilIterator<OT> iter(outData, stencil, outExt);
-    for (; !iter.IsAtEnd(); iter.NextSpan())
-    {
-      if (iter.IsInStencil())
-      {
-        outPtr = iter.BeginSpan();
-        OT* endPtr = iter.EndSpan();
-        for (; outPtr != endPtr; ++outPtr)
-        {
-          OT v = *outPtr;
-          if (v == t)
-          {
-            *outPtr = 0;
-          }
-          else if (v > t)
-          {
-            *outPtr = v - 1;
-          }
-        }
-      }
-    }
   }
 }
 
 //------------------------------------------------------------------------------
-template <class OT>
-void vtkICF::PruneBySize(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-  int extent[6], vtkIdType sizeRange[2], vtkICF::RegionVector& regionInfo)
+void vtkICF::PruneBySize(vtkIdType sizeRange[2], vtkICF::RegionVector& regionInfo)
 {
-  // find all the regions in the allowed size range
+  // keep all the regions in the allowed size range
   size_t n = regionInfo.size();
-  std::vector<OT> newlabels(n);
-  newlabels[0] = 0;
   size_t m = 1;
   for (size_t i = 1; i < n; i++)
   {
-    size_t l = 0;
     vtkIdType s = regionInfo[i].size;
     if (s >= sizeRange[0] && s <= sizeRange[1])
     {
-      l = m++;
-      if (i != l)
+      if (i != m)
       {
-        regionInfo[l] = regionInfo[i];
-      }
-    }
-    newlabels[i] = static_cast<OT>(l);
-  }
-
-  // were any regions outside of the range?
-  if (m < n)
-  {
-    // resize regionInfo
-    regionInfo.resize(m);
-
-    // clip the extent with the output extent
-    int outExt[6];
-    outData->GetExtent(outExt);
-    if (!vtkICF::IntersectExtents(outExt, extent, outExt))
-    {
-      return;
-    }
-
-    // remove the corresponding regions from the output
-    vtkImageStencilIterator<OT> iter(outData, stencil, outExt);
-    for (; !iter.IsAtEnd(); iter.NextSpan())
-    {
-      if (iter.IsInStencil())
-      {
-        outPtr = iter.BeginSpan();
-        OT* endPtr = iter.EndSpan();
-        for (; outPtr != endPtr; ++outPtr)
-        {
-          OT v = *outPtr;
-          if (v != 0)
-          {
-            *outPtr = newlabels[v];
-          }
-        }
+        regionInfo[m] = regionInfo[i];
       }
+      m++;
     }
   }
+  regionInfo.resize(m);
 }
 
 //------------------------------------------------------------------------------
-// Perform a flood fill for each given seed.
 template <class OT>
-vtkIdType vtkICF::Fill(OT* outPtr, vtkIdType outInc[3], int outLimits[6], unsigned char* maskPtr,
-  int maxIdx[3], int fillExtent[6], std::stack<vtkICF::Seed>& seedStack)
+void vtkICF::AddRegion(vtkIdType sizeRange[2], vtkICF::RegionVector& regionInfo,
+  vtkIdType voxelCount, vtkIdType regionId, const int regionExtent[6], vtkIdType component,
+  int extractionMode)
 {
-  vtkIdType counter = 0;
-
-  while (!seedStack.empty())
-  {
-    // get the seed at the top of the stack
-    vtkICF::Seed seed = seedStack.top();
-    seedStack.pop();
-
-    // get the offset into the bitmask
-    vtkIdType bitOffset = seed[2];
-    bitOffset = bitOffset * (maxIdx[1] + 1) + seed[1];
-    bitOffset = bitOffset * (maxIdx[0] + 1) + seed[0];
-    unsigned char bit = 1 << static_cast<unsigned char>(bitOffset & 0x7);
-    unsigned char* maskPtr1 = maskPtr + (bitOffset >> 3);
-
-    // if already colored, skip
-    if ((*maskPtr1 & bit) != 0)
-    {
-      continue;
-    }
-
-    // paint the mask and count the voxel
-    *maskPtr1 ^= bit;
-    counter++;
-
-    if (fillExtent != nullptr)
-    {
-      if (seed[0] < fillExtent[0])
-      {
-        fillExtent[0] = seed[0];
-      }
-      if (seed[0] > fillExtent[1])
-      {
-        fillExtent[1] = seed[0];
-      }
-      if (seed[1] < fillExtent[2])
-      {
-        fillExtent[2] = seed[1];
-      }
-      if (seed[1] > fillExtent[3])
-      {
-        fillExtent[3] = seed[1];
-      }
-      if (seed[2] < fillExtent[4])
-      {
-        fillExtent[4] = seed[2];
-      }
-      if (seed[2] > fillExtent[5])
-      {
-        fillExtent[5] = seed[2];
-      }
-    }
-
-    if (outLimits == nullptr)
-    {
-      // get the pointer to the seed position in the mask
-      vtkIdType outOffset = (seed[0] * outInc[0] + seed[1] * outInc[1] + seed[2] * outInc[2]);
-
-      // set the output
-      outPtr[outOffset] = static_cast<OT>(*seed);
-    }
-    else if (seed[0] >= outLimits[0] && seed[0] <= outLimits[1] && seed[1] >= outLimits[2] &&
-      seed[1] <= outLimits[3] && seed[2] >= outLimits[4] && seed[2] <= outLimits[5])
-    {
-      // get the pointer to the seed position in the mask
-      vtkIdType outOffset = ((seed[0] - outLimits[0]) * outInc[0] +
-        (seed[1] - outLimits[2]) * outInc[1] + (seed[2] - outLimits[4]) * outInc[2]);
-
-      // set the output if within output extent
-      outPtr[outOffset] = static_cast<OT>(*seed);
-    }
-
-    // push the new seeds for the six neighbors, make sure offsets in X are
-    // pushed last so that they will be popped first (we want to raster X,
-    // Y, and Z in that order).
-    int i = 3;
-    do
-    {
-      i--;
-      if (seed[i] > 0)
-      {
-        seed[i]--;
-        seedStack.push(seed);
-        seed[i]++;
-      }
-      if (seed[i] < maxIdx[i])
-      {
-        seed[i]++;
-        seedStack.push(seed);
-        seed[i]--;
-      }
-    } while (i != 0);
-  }
-
-  return counter;
-}
-
-//------------------------------------------------------------------------------
-template <class OT>
-void vtkICF::AddRegion(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil,
-  int extent[6], vtkIdType sizeRange[2], vtkICF::RegionVector& regionInfo, vtkIdType voxelCount,
-  vtkIdType regionId, int regionExtent[6], int extractionMode)
-{
-  regionInfo.push_back(vtkICF::Region(voxelCount, regionId, regionExtent));
+  regionInfo.push_back(vtkICF::Region(voxelCount, regionId, regionExtent, component));
   // check if the label value has reached its maximum, and if so,
   // remove some of the regions
   if (regionInfo.size() > static_cast<size_t>(vtkTypeTraits<OT>::Max()))
   {
-    vtkICF::PruneBySize(outData, outPtr, stencil, extent, sizeRange, regionInfo);
+    vtkICF::PruneBySize(sizeRange, regionInfo);
 
     // if that didn't remove anything, try these:
     if (regionInfo.size() > static_cast<size_t>(vtkTypeTraits<OT>::Max()))
     {
       if (extractionMode == vtkImageConnectivityFilter::LargestRegion)
       {
-        OT label = 1;
-        vtkICF::PruneAllButLargest(outData, outPtr, stencil, extent, label, regionInfo);
+        vtkICF::PruneAllButLargest(regionInfo);
       }
       else
       {
-        vtkICF::PruneSmallestRegion(outData, outPtr, stencil, extent, regionInfo);
+        vtkICF::PruneSmallestRegion(regionInfo);
       }
     }
   }
@@ -1018,43 +764,6 @@ void vtkICF::GenerateRegionArrays(vtkImageConnectivityFilter* self,
   }
 }
 
-//------------------------------------------------------------------------------
-// generate the output image
-template <class OT>
-void vtkICF::Relabel(vtkImageData* outData, OT* outPtr, vtkImageStencilData* stencil, int extent[6],
-  vtkIdTypeArray* labelMap)
-{
-  // clip the extent with the output extent
-  int outExt[6];
-  outData->GetExtent(outExt);
-  if (!vtkICF::IntersectExtents(outExt, extent, outExt))
-  {
-    return;
-  }
-
-  vtkImageStencilIterator<OT> iter(outData, stencil, outExt);
-
-  // loop through the output voxels and change the "region id" value
-  // stored in the voxel into a "region label" value.
-  for (; !iter.IsAtEnd(); iter.NextSpan())
-  {
-    outPtr = iter.BeginSpan();
-    OT* outEnd = iter.EndSpan();
-
-    if (iter.IsInStencil())
-    {
-      for (; outPtr != outEnd; outPtr++)
-      {
-        OT v = *outPtr;
-        if (v > 0)
-        {
-          *outPtr = labelMap->GetValue(v - 1);
-        }
-      }
-    }
-  }
-}
-
 //------------------------------------------------------------------------------
 void vtkICF::SortRegionArrays(vtkImageConnectivityFilter* self)
 {
@@ -1090,11 +799,53 @@ void vtkICF::SortRegionArrays(vtkImageConnectivityFilter* self)
   }
 }
 
+//------------------------------------------------------------------------------
+// generate the output image
+template <class OT>
+void vtkICF::WriteOutput(vtkImageData* outData, OT* outPtr, int extent[6],
+  const vtkImageConnectedRuns& runs, const std::vector<OT>& componentLabels)
+{
+  // clip the extent with the output extent
+  int outExt[6];
+  outData->GetExtent(outExt);
+  int clipExt[6];
+  if (!vtkICF::IntersectExtents(outExt, extent, clipExt))
+  {
+    return;
+  }
+
+  vtkIdType outInc[3];
+  outData->GetIncrements(outInc);
+
+  // the output planes are labeled concurrently
+  vtkSMPTools::For(clipExt[4], clipExt[5] + 1, [&](vtkIdType zBegin, vtkIdType zEnd) {
+    for (int zIdx = static_cast<int>(zBegin); zIdx < zEnd; zIdx++)
+    {
+      for (int yIdx = clipExt[2]; yIdx <= clipExt[3]; yIdx++)
+      {
+        OT* rowPtr = outPtr + (yIdx - outExt[2]) * outInc[1] + (zIdx - outExt[4]) * outInc[2];
+        vtkIdType row = runs.GetRow(yIdx - extent[2], zIdx - extent[4]);
+        for (vtkIdType i = runs.GetRowBegin(row); i < runs.GetRowBegin(row + 1); i++)
+        {
+          OT label = componentLabels[runs.GetComponent(i)];
+          const vtkImageConnectedRuns::Run& run = runs.GetRun(i);
+          int x0 = std::max(run.X0 + extent[0], clipExt[0]);
+          int x1 = std::min(run.X1 + extent[0], clipExt[1]);
+          if (label != 0 && x0 <= x1)
+          {
+            std::fill(rowPtr + (x0 - outExt[0]), rowPtr + (x1 - outExt[0] + 1), label);
+          }
+        }
+      }
+    }
+  });
+}
+
 //------------------------------------------------------------------------------
 template <class OT>
 void vtkICF::Finish(vtkImageConnectivityFilter* self, vtkImageData* outData, OT* outPtr,
-  vtkImageStencilData* stencil, int extent[6], vtkDataArray* seedScalars,
-  vtkICF::RegionVector& regionInfo)
+  int extent[6], vtkDataArray* seedScalars, vtkICF::RegionVector& regionInfo,
+  const vtkImageConnectedRuns& runs)
 {
   // Get the execution parameters
   int labelMode = self->GetLabelMode();
@@ -1103,91 +854,66 @@ void vtkICF::Finish(vtkImageConnectivityFilter* self, vtkImageData* outData, OT*
   self->GetSizeRange(sizeRange);
 
   // get only the regions in the requested range of sizes
-  vtkICF::PruneBySize(outData, outPtr, stencil, extent, sizeRange, regionInfo);
+  vtkICF::PruneBySize(sizeRange, regionInfo);
 
   // create the three region info arrays
   vtkICF::GenerateRegionArrays(
     self, regionInfo, seedScalars, extent, vtkTypeTraits<OT>::Min(), vtkTypeTraits<OT>::Max());
 
+  // the label of each connected component, zero if it was not extracted
+  std::vector<OT> componentLabels(runs.GetNumberOfComponents(), 0);
+
   vtkIdTypeArray* labelArray = self->GetExtractedRegionLabels();
   if (labelArray->GetNumberOfTuples() > 0)
   {
     // do the extraction and final labeling
     if (extractionMode == vtkImageConnectivityFilter::LargestRegion)
     {
-      OT label = static_cast<OT>(labelArray->GetValue(0));
-      vtkICF::PruneAllButLargest(outData, outPtr, stencil, extent, label, regionInfo);
+      vtkICF::PruneAllButLargest(regionInfo);
+      componentLabels[regionInfo[1].component] = static_cast<OT>(labelArray->GetValue(0));
     }
-    else if (labelMode != vtkImageConnectivityFilter::SeedScalar || seedScalars != nullptr)
+    else
     {
-      // this is done unless labelMode == SeedScalar and seedScalars == 0
-      vtkICF::Relabel(outData, outPtr, stencil, extent, labelArray);
+      // labels are the region positions when labelMode == SeedScalar and
+      // seedScalars == 0
+      bool relabel =
+        (labelMode != vtkImageConnectivityFilter::SeedScalar || seedScalars != nullptr);
+      for (size_t i = 1; i < regionInfo.size(); i++)
+      {
+        componentLabels[regionInfo[i].component] =
+          static_cast<OT>(relabel ? labelArray->GetValue(i - 1) : static_cast<vtkIdType>(i));
+      }
     }
 
-    // sort the three region info arrays (must be done after Relabel)
+    // sort the three region info arrays (must be done after labeling)
     vtkICF::SortRegionArrays(self);
   }
-}
-
-//------------------------------------------------------------------------------
-int* vtkICF::ZeroBaseExtent(const int wholeExtent[6], int extent[6], int maxIdx[3])
-{
-  // Indexing goes from 0 to maxIdX
-  maxIdx[0] = wholeExtent[1] - wholeExtent[0];
-  maxIdx[1] = wholeExtent[3] - wholeExtent[2];
-  maxIdx[2] = wholeExtent[5] - wholeExtent[4];
-
-  // Get the limits for the output data
-  bool useLimits = false;
-  for (int k = 0; k < 3; k++)
-  {
-    extent[2 * k] -= wholeExtent[2 * k];
-    useLimits |= (extent[2 * k] != 0);
-    extent[2 * k + 1] -= wholeExtent[2 * k];
-    useLimits |= (extent[2 * k + 1] != maxIdx[k]);
-  }
 
-  // return limits as nullptr if we don't have to use them
-  return (useLimits ? extent : nullptr);
+  vtkICF::WriteOutput(outData, outPtr, extent, runs, componentLabels);
 }
 
 //------------------------------------------------------------------------------
 template <class OT>
 void vtkICF::SeededExecute(vtkImageConnectivityFilter* self, vtkImageData* outData,
-  vtkDataSet* seedData, vtkImageStencilData* stencil, OT* outPtr, unsigned char* maskPtr,
-  int extent[6], vtkICF::RegionVector& regionInfo)
+  vtkDataSet* seedData, int extent[6], const vtkImageConnectedRuns& runs,
+  const std::vector<vtkIdType>& sizes, const std::vector<int>& extents,
+  std::vector<bool>& extracted, vtkICF::RegionVector& regionInfo)
 {
   // Get execution parameters
   int extractionMode = self->GetExtractionMode();
   vtkIdType sizeRange[2];
   self->GetSizeRange(sizeRange);
 
-  vtkIdType outInc[3];
-  outData->GetIncrements(outInc);
-
   double spacing[3];
   double origin[3];
   outData->GetOrigin(origin);
   outData->GetSpacing(spacing);
 
-  int outExt[6];
-  outData->GetExtent(outExt);
-
-  // Indexing will go from 0 to maxIdX, and the lower limit if "extent" will
-  // be subtracted from outExt.  If outExt was the same as extent, then nullptr
-  // is returned, else outExt is returned.
+  // Indexing goes from 0 to maxIdX
   int maxIdx[3];
-  int* outLimits = vtkICF::ZeroBaseExtent(extent, outExt, maxIdx);
-
-  // for measuring extent of fill
-  int seedExtent[6];
-  // only set to non-null if extent generation was requested
-  int* fillExtent = (self->GetGenerateRegionExtents() ? seedExtent : nullptr);
-
-  // label consecutively, starting at 1
-  OT label = 1;
-
-  std::stack<vtkICF::Seed> seedStack;
+  maxIdx[0] = extent[1] - extent[0];
+  maxIdx[1] = extent[3] - extent[2];
+  maxIdx[2] = extent[5] - extent[4];
 
   vtkIdType nPoints = seedData->GetNumberOfPoints();
   vtkDataArray* scalars = seedData->GetPointData()->GetScalars();
@@ -1217,109 +943,71 @@ void vtkICF::SeededExecute(vtkImageConnectivityFilter* self, vtkImageData* outDa
       continue;
     }
 
-    // initialize the region extent from the seed position
-    seedExtent[0] = seedExtent[1] = idx[0];
-    seedExtent[2] = seedExtent[3] = idx[1];
-    seedExtent[4] = seedExtent[5] = idx[2];
-
-    seedStack.push(vtkICF::Seed(idx[0], idx[1], idx[2], label));
-
-    // find all voxels that are connected to the seed
-    vtkIdType voxelCount =
-      vtkICF::Fill(outPtr, outInc, outLimits, maskPtr, maxIdx, fillExtent, seedStack);
-
-    if (voxelCount != 0)
+    // a seed outside of the foreground, or within the component of a
+    // previous seed, does not generate a region
+    vtkIdType run = runs.FindRun(idx[0], idx[1], idx[2]);
+    if (run < 0 || extracted[runs.GetComponent(run)])
     {
-      vtkICF::AddRegion(outData, outPtr, stencil, extent, sizeRange, regionInfo, voxelCount, i,
-        seedExtent, extractionMode);
-      label = static_cast<OT>(regionInfo.size());
+      continue;
     }
+    vtkIdType component = runs.GetComponent(run);
+    extracted[component] = true;
+
+    // the region extent is the seed position unless extents were requested
+    int seedExtent[6] = { idx[0], idx[0], idx[1], idx[1], idx[2], idx[2] };
+    const int* regionExtent = (extents.empty() ? seedExtent : &extents[6 * component]);
+
+    vtkICF::AddRegion<OT>(
+      sizeRange, regionInfo, sizes[component], i, regionExtent, component, extractionMode);
   }
 }
 
 //------------------------------------------------------------------------------
 template <class OT>
-void vtkICF::SeedlessExecute(vtkImageConnectivityFilter* self, vtkImageData* outData,
-  vtkImageStencilData* stencil, OT* outPtr, unsigned char* maskPtr, int extent[6],
-  vtkICF::RegionVector& regionInfo)
+void vtkICF::SeedlessExecute(vtkImageConnectivityFilter* self, const vtkImageConnectedRuns& runs,
+  const std::vector<vtkIdType>& sizes, const std::vector<int>& extents,
+  std::vector<bool>& extracted, vtkICF::RegionVector& regionInfo)
 {
   // Get execution parameters
   int extractionMode = self->GetExtractionMode();
   vtkIdType sizeRange[2];
   self->GetSizeRange(sizeRange);
 
-  vtkIdType outInc[3];
-  outData->GetIncrements(outInc);
-
-  int outExt[6];
-  outData->GetExtent(outExt);
-
-  // Indexing will go from 0 to maxIdX, and the lower limit if "extent" will
-  // be subtracted from outExt.  If outExt was the same as extent, then nullptr
-  // is returned, else outExt is returned.
-  int maxIdx[3];
-  int* outLimits = vtkICF::ZeroBaseExtent(extent, outExt, maxIdx);
-
-  // for measuring extent of fill
-  int seedExtent[6];
-  // only set to non-null if extent generation was requested
-  int* fillExtent = (self->GetGenerateRegionExtents() ? seedExtent : nullptr);
-
-  // keep track of position in bitmask
-  unsigned char* maskPtr1 = maskPtr;
-  unsigned char bit = 1;
-
-  std::stack<vtkICF::Seed> seedStack;
+  // the region extent is the first voxel unless extents were requested
+  std::vector<int> firstVoxels;
+  if (extents.empty())
+  {
+    firstVoxels = runs.ComputeComponentFirstVoxels();
+  }
 
-  for (int zIdx = 0; zIdx <= maxIdx[2]; zIdx++)
+  // components are numbered in the order of a raster scan of the image
+  for (vtkIdType component = 0; component < runs.GetNumberOfComponents(); component++)
   {
-    for (int yIdx = 0; yIdx <= maxIdx[1]; yIdx++)
+    if (extracted[component])
     {
-      for (int xIdx = 0; xIdx <= maxIdx[0]; xIdx++)
-      {
-        // check the bitmask to see if voxel is already colored
-        unsigned char bitSet = *maskPtr1 & bit;
-        bit <<= 1;
-        if (bit == 0)
-        {
-          maskPtr1++;
-          bit = 1;
-        }
-
-        // if already colored, skip
-        if (bitSet != 0)
-        {
-          continue;
-        }
-
-        // initialize the region extent from the seed position
-        seedExtent[0] = seedExtent[1] = xIdx;
-        seedExtent[2] = seedExtent[3] = yIdx;
-        seedExtent[4] = seedExtent[5] = zIdx;
-
-        OT label = static_cast<OT>(regionInfo.size());
-        seedStack.push(vtkICF::Seed(xIdx, yIdx, zIdx, label));
+      continue;
+    }
+    extracted[component] = true;
 
-        // find all voxels that are connected to the seed
-        vtkIdType voxelCount =
-          vtkICF::Fill(outPtr, outInc, outLimits, maskPtr, maxIdx, fillExtent, seedStack);
+    vtkIdType voxelCount = sizes[component];
+    if (voxelCount == 1 && static_cast<OT>(regionInfo.size()) == vtkTypeTraits<OT>::Max())
+    {
+      // smallest region is definitely the one we would add
+      continue;
+    }
 
-        if (voxelCount != 0)
-        {
-          if (voxelCount == 1 && static_cast<OT>(regionInfo.size()) == vtkTypeTraits<OT>::Max())
-          {
-            // smallest region is definitely the one we just added
-            vtkIdType outOffset = (xIdx * outInc[0] + yIdx * outInc[1] + zIdx * outInc[2]);
-            outPtr[outOffset] = 0;
-          }
-          else
-          {
-            vtkICF::AddRegion(outData, outPtr, stencil, extent, sizeRange, regionInfo, voxelCount,
-              -1, seedExtent, extractionMode);
-          }
-        }
-      }
+    int seedExtent[6];
+    if (extents.empty())
+    {
+      const int* idx = &firstVoxels[3 * component];
+      seedExtent[0] = seedExtent[1] = idx[0];
+      seedExtent[2] = seedExtent[3] = idx[1];
+      seedExtent[4] = seedExtent[5] = idx[2];
     }
+    const int* regionExtent = (extents.empty() ? seedExtent : &extents[6 * component]);
+
+    vtkICF::AddRegion<OT>(
+      sizeRange, regionInfo, voxelCount, -1, regionExtent, component, extractionMode);
   }
 }
 
@@ -1327,30 +1015,40 @@ void vtkICF::SeedlessExecute(vtkImageConnectivityFilter* self, vtkImageData* out
 // This templated function executes the filter for any type of data.
 template <class OT>
 void vtkICF::ExecuteOutput(vtkImageConnectivityFilter* self, vtkImageData* outData,
-  vtkDataSet* seedData, vtkImageStencilData* stencil, OT* outPtr, unsigned char* maskPtr,
-  int extent[6])
+  vtkDataSet* seedData, OT* outPtr, int extent[6], const vtkImageConnectedRuns& runs)
 {
   // push the "background" onto the region vector
   vtkICF::RegionVector regionInfo;
   regionInfo.push_back(vtkICF::Region(0, 0, extent));
 
+  // the size and extent of the connected components, the regions are
+  // then selected among them exactly as a sequential flood fill would
+  std::vector<vtkIdType> sizes = runs.ComputeComponentSizes();
+  std::vector<int> extents;
+  if (self->GetGenerateRegionExtents())
+  {
+    extents = runs.ComputeComponentExtents();
+  }
+  std::vector<bool> extracted(runs.GetNumberOfComponents(), false);
+
   // execution depends on how regions are seeded
   vtkDataArray* seedScalars = nullptr;
   if (seedData)
   {
     seedScalars = seedData->GetPointData()->GetScalars();
-    vtkICF::SeededExecute(self, outData, seedData, stencil, outPtr, maskPtr, extent, regionInfo);
+    vtkICF::SeededExecute<OT>(
+      self, outData, seedData, extent, runs, sizes, extents, extracted, regionInfo);
   }
 
   // if no seeds, or if AllRegions selected, search for all regions
   int extractionMode = self->GetExtractionMode();
   if (!seedData || extractionMode == vtkImageConnectivityFilter::AllRegions)
   {
-    vtkICF::SeedlessExecute(self, outData, stencil, outPtr, maskPtr, extent, regionInfo);
+    vtkICF::SeedlessExecute<OT>(self, runs, sizes, extents, extracted, regionInfo);
   }
 
   // do final relabelling and other bookkeeping
-  vtkICF::Finish(self, outData, outPtr, stencil, extent, seedScalars, regionInfo);
+  vtkICF::Finish(self, outData, outPtr, extent, seedScalars, regionInfo, runs);
 }
 
 } // end anonymous namespace
@@ -1447,54 +1145,44 @@ int vtkImageConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
     return 0;
   }
 
-  // create and clear the image bitmask (each bit is a voxel)
-  size = (extent[1] - extent[0] + 1);
-  size *= (extent[3] - extent[2] + 1);
-  size *= (extent[5] - extent[4] + 1);
-  byteSize = (size + 7) / 8;
-  unsigned char* mask = new unsigned char[byteSize];
-
   // get scalar pointers
   void* inPtr = inData->GetScalarPointerForExtent(extent);
 
-  int rval = 1;
+  // find the connected components of the foreground voxels
+  vtkImageConnectedRuns runs;
 
   switch (inData->GetScalarType())
   {
     vtkTemplateAliasMacro(
-      vtkICF::ExecuteInput(this, inData, static_cast<VTK_TT*>(inPtr), mask, stencil, extent));
+      vtkICF::ExecuteInput(this, inData, static_cast<VTK_TT*>(inPtr), stencil, extent, runs));
 
     default:
       vtkErrorMacro(<< "Execute: Unknown input ScalarType");
-      rval = 0;
+      return 0;
   }
 
   switch (outData->GetScalarType())
   {
     case VTK_UNSIGNED_CHAR:
       vtkICF::ExecuteOutput(
-        this, outData, seedData, stencil, static_cast<unsigned char*>(outPtr), mask, extent);
+        this, outData, seedData, static_cast<unsigned char*>(outPtr), extent, runs);
       break;
 
     case VTK_SHORT:
-      vtkICF::ExecuteOutput(
-        this, outData, seedData, stencil, static_cast<short*>(outPtr), mask, extent);
+      vtkICF::ExecuteOutput(this, outData, seedData, static_cast<short*>(outPtr), extent, runs);
       break;
 
     case VTK_UNSIGNED_SHORT:
       vtkICF::ExecuteOutput(
-        this, outData, seedData, stencil, static_cast<unsigned short*>(outPtr), mask, extent);
+        this, outData, seedData, static_cast<unsigned short*>(outPtr), extent, runs);
       break;
 
     case VTK_INT:
-      vtkICF::ExecuteOutput(
-        this, outData, seedData, stencil, static_cast<int*>(outPtr), mask, extent);
+      vtkICF::ExecuteOutput(this, outData, seedData, static_cast<int*>(outPtr), extent, runs);
       break;
   }
 
-  delete[] mask;
-
-  return rval;
+  return 1;
 }
 
 //------------------------------------------------------------------------------
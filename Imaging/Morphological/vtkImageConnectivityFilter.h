@@ -86,6 +86,10 @@
  * is called.  These extents can be useful for cropping the output
  * of the filter.
  *
+ * The connected regions are found with vtkSMPTools, slabs of the image
+ * being labeled concurrently before they are joined.  The regions, and
+ * the labels assigned to them, do not depend on the number of threads.
+ *
  * @sa
  * vtkConnectivityFilter, vtkPolyDataConnectivityFilter, vtkmImageConnectivity
  */
@@ -14,20 +14,22 @@
 =========================================================================*/
 
 #include "vtkImageThresholdConnectivity.h"
+#include "vtkImageConnectedRunsInternal.h"
 
 #include "vtkImageData.h"
 #include "vtkImageIterator.h"
 #include "vtkImageStencilData.h"
-#include "vtkImageStencilIterator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTemplateAliasMacro.h"
 
-#include <stack>
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkImageThresholdConnectivity);
 vtkCxxSetObjectMacro(vtkImageThresholdConnectivity, SeedPoints, vtkPoints);
@@ -58,8 +60,6 @@ vtkImageThresholdConnectivity::vtkImageThresholdConnectivity()
 
   this->ActiveComponent = -1;
 
-  this->ImageMask = vtkImageData::New();
-
   this->NumberOfInVoxels = 0;
 
   this->SetNumberOfInputPorts(2);
@@ -72,7 +72,6 @@ vtkImageThresholdConnectivity::~vtkImageThresholdConnectivity()
   {
     this->SeedPoints->Delete();
   }
-  this->ImageMask->Delete();
 }
 
 //------------------------------------------------------------------------------
@@ -180,47 +179,6 @@ vtkMTimeType vtkImageThresholdConnectivity::GetMTime()
   return mTime;
 }
 
-//------------------------------------------------------------------------------
-// seed struct: just a set of indices
-class vtkFloodFillSeed
-{
-public:
-  vtkFloodFillSeed()
-  {
-    store[0] = 0;
-    store[1] = 0;
-    store[2] = 0;
-  }
-  vtkFloodFillSeed(int i, int j, int k)
-  {
-    store[0] = i;
-    store[1] = j;
-    store[2] = k;
-  }
-  vtkFloodFillSeed(const vtkFloodFillSeed& seed)
-  {
-    store[0] = seed.store[0];
-    store[1] = seed.store[1];
-    store[2] = seed.store[2];
-  }
-  const int& operator[](int i) const { return store[i]; }
-  vtkFloodFillSeed& operator=(const vtkFloodFillSeed& seed)
-  {
-    if (this == &seed)
-    {
-      return *this;
-    }
-
-    store[0] = seed.store[0];
-    store[1] = seed.store[1];
-    store[2] = seed.store[2];
-    return *this;
-  }
-
-private:
-  int store[3];
-};
-
 //------------------------------------------------------------------------------
 // Make sure the thresholds are valid for the input scalar range
 template <class IT>
@@ -298,31 +256,73 @@ void vtkImageThresholdConnectivityValues(
 }
 
 //------------------------------------------------------------------------------
-static void vtkImageThresholdConnectivityApplyStencil(
-  vtkImageData* maskData, vtkImageStencilData* stencil, int extent[6])
+// Build the runs of the voxels of the extent that pass the test isInside(x, y, z),
+// indices being relative to the lower bound of the extent. Only the voxels of
+// the stencil are considered.
+template <typename InsideFunctor>
+void vtkImageThresholdConnectivityBuildRuns(vtkImageStencilData* stencil, const int extent[6],
+  vtkImageConnectedRuns& runs, InsideFunctor&& isInside)
 {
-  vtkImageStencilIterator<unsigned char> iter(maskData, stencil, extent);
-  while (!iter.IsAtEnd())
-  {
-    unsigned char* beginptr = iter.BeginSpan();
-    unsigned char* endptr = iter.EndSpan();
-    unsigned char val = (iter.IsInStencil() ? 0 : 1);
+  int dims[3];
+  dims[0] = extent[1] - extent[0] + 1;
+  dims[1] = extent[3] - extent[2] + 1;
+  dims[2] = extent[5] - extent[4] + 1;
+
+  runs.Build(dims, [&](int yIdx, int zIdx, std::vector<vtkImageConnectedRuns::Run>& rowRuns) {
+    const size_t rowBegin = rowRuns.size();
+    auto addSpan = [&](int x0, int x1) {
+      int runStart = -1;
+      for (int xIdx = x0; xIdx <= x1 + 1; xIdx++)
+      {
+        if (xIdx <= x1 && isInside(xIdx, yIdx, zIdx))
+        {
+          runStart = (runStart < 0 ? xIdx : runStart);
+        }
+        else if (runStart >= 0)
+        {
+          // stencil sub-extents may touch each other
+          if (rowRuns.size() > rowBegin && rowRuns.back().X1 + 1 == runStart)
+          {
+            rowRuns.back().X1 = xIdx - 1;
+          }
+          else
+          {
+            rowRuns.push_back({ runStart, xIdx - 1 });
+          }
+          runStart = -1;
+        }
+      }
+    };
 
-    for (unsigned char* ptr = beginptr; ptr < endptr; ptr++)
+    if (stencil == nullptr)
     {
-      *ptr = val;
+      addSpan(0, dims[0] - 1);
+      return;
     }
 
-    iter.NextSpan();
-  }
+    int r1, r2;
+    int iter = 0;
+    int moreSubExtents = 1;
+    while (moreSubExtents)
+    {
+      moreSubExtents = stencil->GetNextExtent(
+        r1, r2, extent[0], extent[1], yIdx + extent[2], zIdx + extent[4], iter);
+      if (r1 <= r2)
+      {
+        addSpan(r1 - extent[0], r2 - extent[0]);
+      }
+    }
+  });
+
+  runs.Label();
 }
 
 //------------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
 template <class IT, class OT>
 void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, vtkImageData* inData,
-  vtkImageData* outData, vtkImageStencilData* stencil, vtkImageData* maskData, int outExt[6],
-  int id, IT* inPtr, OT* outPtr, int& voxelCount)
+  vtkImageData* outData, vtkImageStencilData* stencil, int outExt[6], IT* inPtr, OT* outPtr,
+  int& voxelCount)
 {
   // Get active component (only one component is thresholded)
   int nComponents = outData->GetNumberOfScalarComponents();
@@ -344,55 +344,59 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
   vtkImageThresholdConnectivityValues(self, outData, inValue, outValue);
 
   // Set the "outside" with either the input or the OutValue
-  vtkImageIterator<IT> inIt(inData, outExt);
-  vtkImageIterator<OT> outIt(outData, outExt);
-  while (!outIt.IsAtEnd())
-  {
-    IT* inSI = inIt.BeginSpan();
-    OT* outSI = outIt.BeginSpan();
-    OT* outSIEnd = outIt.EndSpan();
-
-    if (replaceOut)
+  vtkSMPTools::For(outExt[4], outExt[5] + 1, [&](vtkIdType zBegin, vtkIdType zEnd) {
+    int planeExt[6] = { outExt[0], outExt[1], outExt[2], outExt[3], static_cast<int>(zBegin),
+      static_cast<int>(zEnd - 1) };
+    vtkImageIterator<IT> inIt(inData, planeExt);
+    vtkImageIterator<OT> outIt(outData, planeExt);
+    while (!outIt.IsAtEnd())
     {
-      if (nComponents == 1)
-      {
-        while (outSI < outSIEnd)
-        {
-          *outSI++ = outValue;
-        }
-      }
-      else
+      IT* inSI = inIt.BeginSpan();
+      OT* outSI = outIt.BeginSpan();
+      OT* outSIEnd = outIt.EndSpan();
+
+      if (replaceOut)
       {
-        // only color the active component, copy the rest
-        while (outSI < outSIEnd)
+        if (nComponents == 1)
         {
-          int jj = 0;
-          while (jj < activeComponent)
+          while (outSI < outSIEnd)
           {
-            *outSI++ = static_cast<OT>(*inSI++);
-            jj++;
+            *outSI++ = outValue;
           }
-          *outSI++ = outValue;
-          inSI++;
-          jj++;
-          while (jj < nComponents)
+        }
+        else
+        {
+          // only color the active component, copy the rest
+          while (outSI < outSIEnd)
           {
-            *outSI++ = static_cast<OT>(*inSI++);
+            int jj = 0;
+            while (jj < activeComponent)
+            {
+              *outSI++ = static_cast<OT>(*inSI++);
+              jj++;
+            }
+            *outSI++ = outValue;
+            inSI++;
             jj++;
+            while (jj < nComponents)
+            {
+              *outSI++ = static_cast<OT>(*inSI++);
+              jj++;
+            }
           }
         }
       }
-    }
-    else
-    {
-      while (outSI < outSIEnd)
+      else
       {
-        *outSI++ = static_cast<OT>(*inSI++);
+        while (outSI < outSIEnd)
+        {
+          *outSI++ = static_cast<OT>(*inSI++);
+        }
       }
+      inIt.NextSpan();
+      outIt.NextSpan();
     }
-    inIt.NextSpan();
-    outIt.NextSpan();
-  }
+  });
 
   // Get the extent for the flood fill, and clip with the input extent
   int extent[6];
@@ -401,7 +405,6 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
   self->GetSliceRangeY(&extent[2]);
   self->GetSliceRangeZ(&extent[4]);
   inData->GetExtent(inExt);
-  int outCheck = 0;
   for (int ii = 0; ii < 3; ii++)
   {
     if (extent[2 * ii] > inExt[2 * ii + 1] || extent[2 * ii + 1] < inExt[2 * ii])
@@ -416,11 +419,6 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
     {
       extent[2 * ii + 1] = inExt[2 * ii + 1];
     }
-    // check against output extent
-    if (extent[2 * ii] < outExt[2 * ii] || extent[2 * ii + 1] > outExt[2 * ii + 1])
-    {
-      outCheck = 1;
-    }
   }
 
   // Indexing goes from 0 to maxIdX
@@ -428,37 +426,7 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
   int maxIdY = extent[3] - extent[2];
   int maxIdZ = extent[5] - extent[4];
 
-  // Convert output limits
-  int minOutIdX = outExt[0] - extent[0];
-  int maxOutIdX = outExt[1] - extent[0];
-  int minOutIdY = outExt[2] - extent[2];
-  int maxOutIdY = outExt[3] - extent[2];
-  int minOutIdZ = outExt[4] - extent[4];
-  int maxOutIdZ = outExt[5] - extent[4];
-
-  // Total number of voxels
-  vtkIdType fullsize = (static_cast<vtkIdType>(extent[1] - extent[0] + 1) *
-    static_cast<vtkIdType>(extent[3] - extent[2] + 1) *
-    static_cast<vtkIdType>(extent[5] - extent[4] + 1));
-
-  // for the progress meter
-  double progress = 0.0;
-  vtkIdType target = static_cast<vtkIdType>(fullsize / 50.0);
-  target++;
-
-  // Setup the mask
-  maskData->SetOrigin(inData->GetOrigin());
-  maskData->SetSpacing(inData->GetSpacing());
-  maskData->SetExtent(extent);
-  maskData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
-
-  unsigned char* maskPtr = static_cast<unsigned char*>(maskData->GetScalarPointerForExtent(extent));
-  vtkIdType maskInc[3];
-  maskInc[0] = 1;
-  maskInc[1] = (extent[1] - extent[0] + 1);
-  maskInc[2] = maskInc[1] * (extent[3] - extent[2] + 1);
-
-  // Get input pointer for the extent used by the maskData
+  // Get input pointer for the extent of the flood fill
   inPtr = static_cast<IT*>(inData->GetScalarPointerForExtent(extent));
   vtkIdType inInc[3];
   inData->GetIncrements(inInc);
@@ -467,23 +435,11 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
   outPtr = static_cast<OT*>(outData->GetScalarPointerForExtent(outExt));
   vtkIdType outInc[3];
   outData->GetIncrements(outInc);
-  // Adjust it so that it corresponds to the maskData extent
-  outPtr -= minOutIdX * outInc[0] + minOutIdY * outInc[1] + minOutIdZ * outInc[2];
 
   // Adjust pointers to active component
   inPtr += activeComponent;
   outPtr += activeComponent;
 
-  if (stencil == nullptr)
-  {
-    memset(maskPtr, 0, fullsize);
-  }
-  else
-  {
-    // pre-set all mask voxels that are outside the stencil
-    vtkImageThresholdConnectivityApplyStencil(maskData, stencil, extent);
-  }
-
   // Check whether neighborhood will be used
   double f = self->GetNeighborhoodFraction();
   double radius[3];
@@ -500,16 +456,6 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
     fz = 1.0 / radius[2];
   }
 
-  // Perform the flood fill within the extent
-  double spacing[3];
-  double origin[3];
-  outData->GetSpacing(spacing);
-  outData->GetOrigin(origin);
-
-  // create the seed stack:
-  // stack has methods empty(), top(), push(), and pop()
-  std::stack<vtkFloodFillSeed> seedStack;
-
   // initialize with the seeds provided by the user
   vtkPoints* points = self->GetSeedPoints();
   if (points == nullptr)
@@ -517,76 +463,83 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
     return;
   }
 
+  double spacing[3];
+  double origin[3];
+  outData->GetSpacing(spacing);
+  outData->GetOrigin(origin);
+
+  std::vector<int> seeds;
   double point[3];
   vtkIdType nPoints = points->GetNumberOfPoints();
   for (vtkIdType p = 0; p < nPoints; p++)
   {
     points->GetPoint(p, point);
-    vtkFloodFillSeed seed =
-      vtkFloodFillSeed(vtkMath::Floor((point[0] - origin[0]) / spacing[0] + 0.5) - extent[0],
-        vtkMath::Floor((point[1] - origin[1]) / spacing[1] + 0.5) - extent[2],
-        vtkMath::Floor((point[2] - origin[2]) / spacing[2] + 0.5) - extent[4]);
+    int seed[3];
+    seed[0] = vtkMath::Floor((point[0] - origin[0]) / spacing[0] + 0.5) - extent[0];
+    seed[1] = vtkMath::Floor((point[1] - origin[1]) / spacing[1] + 0.5) - extent[2];
+    seed[2] = vtkMath::Floor((point[2] - origin[2]) / spacing[2] + 0.5) - extent[4];
 
     if (seed[0] >= 0 && seed[0] <= maxIdX && seed[1] >= 0 && seed[1] <= maxIdY && seed[2] >= 0 &&
       seed[2] <= maxIdZ)
     {
-      seedStack.push(seed);
+      seeds.insert(seeds.end(), seed, seed + 3);
     }
   }
 
-  vtkIdType counter = 0;
-  vtkIdType fullcount = 0;
-
-  while (!seedStack.empty())
-  {
-    vtkFloodFillSeed seed = seedStack.top();
-    seedStack.pop();
-
-    unsigned char* maskPtr1 =
-      maskPtr + (seed[0] * maskInc[0] + seed[1] * maskInc[1] + seed[2] * maskInc[2]);
-
-    if (*maskPtr1)
-    {
-      continue;
-    }
-    *maskPtr1 = 255;
+  // The flood fill from the seeds reaches the connected components of the
+  // voxels within the thresholds that contain a seed
+  auto withinThresholds = [&](int xIdx, int yIdx, int zIdx) {
+    IT temp = inPtr[xIdx * inInc[0] + yIdx * inInc[1] + zIdx * inInc[2]];
+    return ((lowerThreshold <= temp) & (temp <= upperThreshold));
+  };
 
-    fullcount++;
-    if (id == 0 && (fullcount % target) == 0)
+  auto selectSeededComponents = [&](const vtkImageConnectedRuns& runs) {
+    std::vector<bool> selected(runs.GetNumberOfComponents(), false);
+    for (size_t s = 0; s < seeds.size(); s += 3)
     {
-      double v = counter / (10.0 * fullcount);
-      double p = fullcount / (v * fullsize + (1.0 - v) * fullcount);
-      if (p > progress)
+      vtkIdType run = runs.FindRun(seeds[s], seeds[s + 1], seeds[s + 2]);
+      if (run >= 0)
       {
-        progress = p;
-        self->UpdateProgress(progress);
+        selected[runs.GetComponent(run)] = true;
       }
     }
+    return selected;
+  };
+
+  vtkImageConnectedRuns runs;
+  vtkImageThresholdConnectivityBuildRuns(stencil, extent, runs, withinThresholds);
+  std::vector<bool> selected = selectSeededComponents(runs);
+  self->UpdateProgress(0.5);
+
+  // use a spherical neighborhood: a voxel is inside only if the given fraction
+  // of its neighborhood is within the thresholds. The test is only done for
+  // the components reached above, that contain all the voxels that can still
+  // be reached, then the components are computed again.
+  if (useNeighborhood)
+  {
+    auto withinNeighborhood = [&](int xIdx, int yIdx, int zIdx) {
+      vtkIdType run = runs.FindRun(xIdx, yIdx, zIdx);
+      if (run < 0 || !selected[runs.GetComponent(run)])
+      {
+        return false;
+      }
 
-    IT* inPtr1 = inPtr + (seed[0] * inInc[0] + seed[1] * inInc[1] + seed[2] * inInc[2]);
-    IT temp = *inPtr1;
-
-    bool inside = ((lowerThreshold <= temp) & (temp <= upperThreshold));
-
-    // use a spherical neighborhood
-    if (useNeighborhood)
-    {
-      int xmin = seed[0] - xradius;
+      int xmin = xIdx - xradius;
       xmin = (xmin >= 0 ? xmin : 0);
-      int xmax = seed[0] + xradius;
+      int xmax = xIdx + xradius;
       xmax = (xmax <= maxIdX ? xmax : maxIdX);
 
-      int ymin = seed[1] - yradius;
+      int ymin = yIdx - yradius;
       ymin = (ymin >= 0 ? ymin : 0);
-      int ymax = seed[1] + yradius;
+      int ymax = yIdx + yradius;
       ymax = (ymax <= maxIdY ? ymax : maxIdY);
 
-      int zmin = seed[2] - zradius;
+      int zmin = zIdx - zradius;
       zmin = (zmin >= 0 ? zmin : 0);
-      int zmax = seed[2] + zradius;
+      int zmax = zIdx + zradius;
       zmax = (zmax <= maxIdZ ? zmax : maxIdZ);
 
-      inPtr1 = inPtr + (xmin * inInc[0] + ymin * inInc[1] + zmin * inInc[2]);
+      IT* inPtr1 = inPtr + (xmin * inInc[0] + ymin * inInc[1] + zmin * inInc[2]);
 
       int totalcount = 0;
       int threshcount = 0;
@@ -594,19 +547,19 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
       do
       {
         IT* inPtr2 = inPtr1;
-        double rz = (iz - seed[2]) * fz;
+        double rz = (iz - zIdx) * fz;
         rz *= rz;
         int iy = ymin;
         do
         {
           IT* inPtr3 = inPtr2;
-          double ry = (iy - seed[1]) * fy;
+          double ry = (iy - yIdx) * fy;
           ry *= ry;
           double rzy = rz + ry;
           int ix = xmin;
           do
           {
-            double rx = (ix - seed[0]) * fx;
+            double rx = (ix - xIdx) * fx;
             rx *= rx;
             double rzyx = rzy + rx;
             // include a tolerance in radius check
@@ -622,57 +575,59 @@ void vtkImageThresholdConnectivityExecute(vtkImageThresholdConnectivity* self, v
       } while (++iz <= zmax);
 
       // what fraction of the sphere is within threshold?
-      inside &= !(static_cast<double>(threshcount) < totalcount * f);
-    }
+      return !(static_cast<double>(threshcount) < totalcount * f);
+    };
 
-    if (inside)
-    {
-      // match
-      OT* outPtr1 = outPtr + (seed[0] * outInc[0] + seed[1] * outInc[1] + seed[2] * outInc[2]);
-
-      if (outCheck == 0 ||
-        (seed[0] >= minOutIdX && seed[0] <= maxOutIdX && seed[1] >= minOutIdY &&
-          seed[1] <= maxOutIdY && seed[2] >= minOutIdZ && seed[2] <= maxOutIdZ))
-      {
-        *outPtr1 = (replaceIn ? inValue : static_cast<OT>(temp));
-      }
-
-      // count the seed
-      counter += 1;
+    vtkImageConnectedRuns neighborhoodRuns;
+    vtkImageThresholdConnectivityBuildRuns(stencil, extent, neighborhoodRuns, withinNeighborhood);
+    std::swap(runs, neighborhoodRuns);
+    selected = selectSeededComponents(runs);
+  }
 
-      // push the new seeds
-      if (seed[2] > 0 && *(maskPtr1 - maskInc[2]) == 0)
-      {
-        seedStack.push(vtkFloodFillSeed(seed[0], seed[1], seed[2] - 1));
-      }
-      if (seed[2] < maxIdZ && *(maskPtr1 + maskInc[2]) == 0)
-      {
-        seedStack.push(vtkFloodFillSeed(seed[0], seed[1], seed[2] + 1));
-      }
-      if (seed[1] > 0 && *(maskPtr1 - maskInc[1]) == 0)
-      {
-        seedStack.push(vtkFloodFillSeed(seed[0], seed[1] - 1, seed[2]));
-      }
-      if (seed[1] < maxIdY && *(maskPtr1 + maskInc[1]) == 0)
-      {
-        seedStack.push(vtkFloodFillSeed(seed[0], seed[1] + 1, seed[2]));
-      }
-      if (seed[0] > 0 && *(maskPtr1 - maskInc[0]) == 0)
-      {
-        seedStack.push(vtkFloodFillSeed(seed[0] - 1, seed[1], seed[2]));
-      }
-      if (seed[0] < maxIdX && *(maskPtr1 + maskInc[0]) == 0)
+  // Set the "inside" voxels within the output extent
+  int clipExt[6];
+  for (int ii = 0; ii < 3; ii++)
+  {
+    clipExt[2 * ii] = std::max(outExt[2 * ii], extent[2 * ii]);
+    clipExt[2 * ii + 1] = std::min(outExt[2 * ii + 1], extent[2 * ii + 1]);
+  }
+  vtkSMPTools::For(clipExt[4], clipExt[5] + 1, [&](vtkIdType zBegin, vtkIdType zEnd) {
+    for (int zIdx = static_cast<int>(zBegin); zIdx < zEnd; zIdx++)
+    {
+      for (int yIdx = clipExt[2]; yIdx <= clipExt[3]; yIdx++)
       {
-        seedStack.push(vtkFloodFillSeed(seed[0] + 1, seed[1], seed[2]));
+        vtkIdType row = runs.GetRow(yIdx - extent[2], zIdx - extent[4]);
+        for (vtkIdType i = runs.GetRowBegin(row); i < runs.GetRowBegin(row + 1); i++)
+        {
+          if (!selected[runs.GetComponent(i)])
+          {
+            continue;
+          }
+          const vtkImageConnectedRuns::Run& run = runs.GetRun(i);
+          int x0 = std::max(run.X0 + extent[0], clipExt[0]);
+          int x1 = std::min(run.X1 + extent[0], clipExt[1]);
+          for (int xIdx = x0; xIdx <= x1; xIdx++)
+          {
+            IT temp = inPtr[(xIdx - extent[0]) * inInc[0] + (yIdx - extent[2]) * inInc[1] +
+              (zIdx - extent[4]) * inInc[2]];
+            outPtr[(xIdx - outExt[0]) * outInc[0] + (yIdx - outExt[2]) * outInc[1] +
+              (zIdx - outExt[4]) * outInc[2]] = (replaceIn ? inValue : static_cast<OT>(temp));
+          }
+        }
       }
     }
-  }
+  });
 
-  if (id == 0)
+  // count the voxels that were reached
+  std::vector<vtkIdType> sizes = runs.ComputeComponentSizes();
+  vtkIdType counter = 0;
+  for (vtkIdType c = 0; c < runs.GetNumberOfComponents(); c++)
   {
-    self->UpdateProgress(1.0);
+    counter += (selected[c] ? sizes[c] : 0);
   }
 
+  self->UpdateProgress(1.0);
+
   voxelCount = counter;
 }
 
@@ -724,7 +679,6 @@ int vtkImageThresholdConnectivity::RequestData(vtkInformation* vtkNotUsed(reques
 
   vtkImageData* outData = static_cast<vtkImageData*>(outInfo->Get(vtkDataObject::DATA_OBJECT()));
   vtkImageData* inData = static_cast<vtkImageData*>(inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  vtkImageData* maskData = this->ImageMask;
 
   vtkImageStencilData* stencil = nullptr;
   if (stencilInfo)
@@ -740,8 +694,6 @@ int vtkImageThresholdConnectivity::RequestData(vtkInformation* vtkNotUsed(reques
   void* inPtr = inData->GetScalarPointerForExtent(outExt);
   void* outPtr = outData->GetScalarPointerForExtent(outExt);
 
-  int id = 0; // not multi-threaded
-
   if (inData->GetScalarType() != outData->GetScalarType())
   {
     vtkErrorMacro("Execute: Output ScalarType "
@@ -752,7 +704,7 @@ int vtkImageThresholdConnectivity::RequestData(vtkInformation* vtkNotUsed(reques
   switch (inData->GetScalarType())
   {
     vtkTemplateAliasMacro(
-      vtkImageThresholdConnectivityExecute(this, inData, outData, stencil, maskData, outExt, id,
+      vtkImageThresholdConnectivityExecute(this, inData, outData, stencil, outExt,
         static_cast<VTK_TT*>(inPtr), static_cast<VTK_TT*>(outPtr), this->NumberOfInVoxels));
 
     default:
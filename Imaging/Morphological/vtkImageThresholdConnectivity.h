@@ -24,6 +24,8 @@
  * output by default, while the "outside" will be replaced with zeros.
  * This behavior can be changed by using the ReplaceIn() and ReplaceOut()
  * methods.  The scalar type of the output is the same as the input.
+ * The connected regions containing the seeds are found with vtkSMPTools,
+ * the result does not depend on the number of threads.
  * @sa
  * vtkImageThreshold
  * @par Thanks:
@@ -201,8 +203,6 @@ protected:
 
   int ActiveComponent;
 
-  vtkImageData* ImageMask;
-
   void ComputeInputUpdateExtent(int inExt[6], int outExt[6]);
 
   int FillInputPortInformation(int port, vtkInformation* info) override;
@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestFixedPointRayCastSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the images cast by vtkFixedPointVolumeRayCastMapper, gradients
+// included, do not depend on the number of threads, that each blend mode
+// renders the volume, and that the progress events are invoked by the calling
+// thread up to completion.
+
+#include "vtkCallbackCommand.h"
+#include "vtkColorTransferFunction.h"
+#include "vtkCommand.h"
+#include "vtkDataArray.h"
+#include "vtkFixedPointVolumeRayCastMapper.h"
+#include "vtkImageCast.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPiecewiseFunction.h"
+#include "vtkPointData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPTestUtilities.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkVolume.h"
+#include "vtkVolumeProperty.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+
+// Progress events of a kind, and whether they all came from the main thread
+struct ProgressEvents
+{
+  int Count = 0;
+  double LastFraction = 0.;
+  bool OnMainThread = true;
+  std::thread::id MainThread = std::this_thread::get_id();
+};
+
+void RecordProgress(vtkObject*, unsigned long, void* clientData, void* callData)
+{
+  ProgressEvents* events = static_cast<ProgressEvents*>(clientData);
+  events->Count++;
+  events->LastFraction = *static_cast<double*>(callData);
+  events->OnMainThread &= std::this_thread::get_id() == events->MainThread;
+}
+
+bool CheckProgress(const ProgressEvents& events, const char* kind)
+{
+  if (events.Count == 0 || events.LastFraction != 1. || !events.OnMainThread)
+  {
+    std::cerr << kind << " progress: " << events.Count << " events, last at "
+              << events.LastFraction << (events.OnMainThread ? "" : ", not all on main thread")
+              << "." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Cast a canonical view of the volume
+vtkSmartPointer<vtkImageData> CastImage(
+  vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* volume, int blendMode)
+{
+  double direction[3] = { 1., .5, .25 };
+  double viewUp[3] = { 0., 0., 1. };
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(96, 80, 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  // Gradients are computed when first needed, force them to be recomputed
+  mapper->Modified();
+  mapper->CreateCanonicalView(volume, image, blendMode, direction, viewUp);
+  return image.GetPointer();
+}
+
+// Number of pixels of an image that are not black
+vtkIdType CountLitPixels(vtkImageData* image)
+{
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  vtkIdType count = 0;
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+  {
+    bool lit = false;
+    for (int c = 0; c < scalars->GetNumberOfComponents(); ++c)
+    {
+      lit |= scalars->GetComponent(i, c) != 0.;
+    }
+    count += lit ? 1 : 0;
+  }
+  return count;
+}
+
+} // anonymous namespace
+
+int TestFixedPointRayCastSMP(int, char*[])
+{
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-20, 20, -16, 16, -12, 12);
+  vtkNew<vtkImageCast> cast;
+  cast->SetInputConnection(source->GetOutputPort());
+  cast->SetOutputScalarTypeToUnsignedShort();
+
+  vtkNew<vtkFixedPointVolumeRayCastMapper> mapper;
+  mapper->SetInputConnection(cast->GetOutputPort());
+  mapper->IntermixIntersectingGeometryOff();
+  mapper->AutoAdjustSampleDistancesOff();
+
+  vtkNew<vtkColorTransferFunction> color;
+  color->AddRGBPoint(40., 0., 0., 1.);
+  color->AddRGBPoint(160., 1., .5, 0.);
+  color->AddRGBPoint(280., 1., 1., 1.);
+  vtkNew<vtkPiecewiseFunction> opacity;
+  opacity->AddPoint(40., 0.);
+  opacity->AddPoint(280., .3);
+  vtkNew<vtkPiecewiseFunction> gradientOpacity;
+  gradientOpacity->AddPoint(0., .2);
+  gradientOpacity->AddPoint(60., 1.);
+
+  vtkNew<vtkVolumeProperty> property;
+  property->SetColor(color);
+  property->SetScalarOpacity(opacity);
+  property->SetInterpolationTypeToLinear();
+
+  vtkNew<vtkVolume> volume;
+  volume->SetMapper(mapper);
+  volume->SetProperty(property);
+
+  bool success = true;
+
+  // With a backend whose calling thread may not cast rays itself, progress
+  // is still reported by the calling thread.
+  property->SetShade(1);
+  ProgressEvents renderEvents, gradientEvents;
+  vtkNew<vtkCallbackCommand> renderProgress;
+  renderProgress->SetCallback(RecordProgress);
+  renderProgress->SetClientData(&renderEvents);
+  mapper->AddObserver(vtkCommand::VolumeMapperRenderProgressEvent, renderProgress);
+  vtkNew<vtkCallbackCommand> gradientProgress;
+  gradientProgress->SetCallback(RecordProgress);
+  gradientProgress->SetClientData(&gradientEvents);
+  mapper->AddObserver(vtkCommand::VolumeMapperComputeGradientsProgressEvent, gradientProgress);
+  vtkSMPTools::LocalScope(vtkTest::ThreadedConfig(),
+    [&]() { CastImage(mapper, volume, vtkVolumeMapper::COMPOSITE_BLEND); });
+  success &= CheckProgress(renderEvents, "Render");
+  success &= CheckProgress(gradientEvents, "Gradient");
+  mapper->RemoveAllObservers();
+
+  vtkSmartPointer<vtkImageData> previous;
+  for (int mode = 0; mode < 4; ++mode)
+  {
+    // Composite, shaded composite, shaded composite with gradient opacity, MIP
+    property->SetShade(mode == 1 || mode == 2);
+    property->SetDisableGradientOpacity(mode != 2);
+    if (mode == 2)
+    {
+      property->SetGradientOpacity(gradientOpacity);
+    }
+    const int blendMode =
+      mode == 3 ? vtkVolumeMapper::MAXIMUM_INTENSITY_BLEND : vtkVolumeMapper::COMPOSITE_BLEND;
+
+    auto images =
+      vtkTest::RunSequentialAndThreaded([&]() { return CastImage(mapper, volume, blendMode); });
+    if (!vtkTest::SameArrays(
+          images.first->GetPointData()->GetScalars(), images.second->GetPointData()->GetScalars()))
+    {
+      std::cerr << "Image of mode " << mode << " depends on the number of threads." << std::endl;
+      success = false;
+    }
+
+    // The volume covers part of the image only, and each mode renders it
+    // differently from the previous one
+    vtkIdType lit = CountLitPixels(images.first);
+    vtkIdType numPixels = images.first->GetNumberOfPoints();
+    if (lit == 0 || lit == numPixels)
+    {
+      std::cerr << "Image of mode " << mode << " has " << lit << " lit pixels out of "
+                << numPixels << "." << std::endl;
+      success = false;
+    }
+    if (previous &&
+      vtkTest::SameArrays(
+        previous->GetPointData()->GetScalars(), images.first->GetPointData()->GetScalars()))
+    {
+      std::cerr << "Image of mode " << mode << " is that of the previous mode." << std::endl;
+      success = false;
+    }
+    previous = images.first;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -47,7 +47,7 @@ vtkFixedPointVolumeRayCastCompositeGOHelper::~vtkFixedPointVolumeRayCastComposit
 // Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageOneSimpleNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGONN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -89,7 +89,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageOneSimpleNN(
 // Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageOneNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGONN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -132,7 +132,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageOneNN(
 // threshold). Finally we move to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageTwoDependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGONN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -187,7 +187,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageTwoDependentNN(
 // Finally we move onto the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageFourDependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGONN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -241,7 +241,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageFourDependentNN(
 // threshold). Finally we increment to the next sample on the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageIndependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartGONN();
@@ -290,7 +290,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageIndependentNN(
 // sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageOneSimpleTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOTrilin();
   VTKKWRCHelper_InitializeCompositeOneTrilin();
@@ -370,7 +370,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageOneSimpleTrilin(
 // threshold). Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageOneTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOTrilin();
   VTKKWRCHelper_InitializeCompositeOneTrilin();
@@ -452,7 +452,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageOneTrilin(
 // the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageTwoDependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOTrilin();
   VTKKWRCHelper_InitializeCompositeMultiTrilin();
@@ -539,7 +539,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageTwoDependentTrilin(
 // move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageFourDependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOTrilin();
   VTKKWRCHelper_InitializeCompositeMultiTrilin();
@@ -628,7 +628,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageFourDependentTrilin(
 // move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOHelperGenerateImageIndependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartGOTrilin();
@@ -705,7 +705,7 @@ void vtkFixedPointCompositeGOHelperGenerateImageIndependentTrilin(
 }
 
 void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
-  int threadID, int threadCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
+  int tileIndex, int tileCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
 {
   void* data = mapper->GetCurrentScalars()->GetVoidPointer(0);
   int scalarType = mapper->GetCurrentScalars()->GetDataType();
@@ -722,7 +722,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOHelperGenerateImageOneSimpleNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       else
@@ -730,7 +730,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOHelperGenerateImageOneNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -740,7 +740,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointCompositeGOHelperGenerateImageIndependentNN(
-          static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent (color) components
@@ -753,7 +753,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOHelperGenerateImageTwoDependentNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Four components - they must be unsigned char, the first three directly
@@ -763,7 +763,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
         if (scalarType == VTK_UNSIGNED_CHAR)
         {
           vtkFixedPointCompositeGOHelperGenerateImageFourDependentNN(
-            static_cast<unsigned char*>(data), threadID, threadCount, mapper, vol);
+            static_cast<unsigned char*>(data), tileIndex, tileCount, mapper, vol);
         }
         else
         {
@@ -784,7 +784,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOHelperGenerateImageOneSimpleTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Scale != 1.0 or shift != 0.0 - must apply scale/shift in inner loop
@@ -793,7 +793,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOHelperGenerateImageOneTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -803,7 +803,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointCompositeGOHelperGenerateImageIndependentTrilin(
-          static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent components
@@ -816,7 +816,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOHelperGenerateImageTwoDependentTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Four components - they must be unsigned char, the first three directly
@@ -827,7 +827,7 @@ void vtkFixedPointVolumeRayCastCompositeGOHelper::GenerateImage(
         if (scalarType == VTK_UNSIGNED_CHAR)
         {
           vtkFixedPointCompositeGOHelperGenerateImageFourDependentTrilin(
-            static_cast<unsigned char*>(data), threadID, threadCount, mapper, vol);
+            static_cast<unsigned char*>(data), tileIndex, tileCount, mapper, vol);
         }
         else
         {
@@ -44,7 +44,7 @@ public:
   vtkTypeMacro(vtkFixedPointVolumeRayCastCompositeGOHelper, vtkFixedPointVolumeRayCastHelper);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
-  void GenerateImage(int threadID, int threadCount, vtkVolume* vol,
+  void GenerateImage(int tileIndex, int tileCount, vtkVolume* vol,
     vtkFixedPointVolumeRayCastMapper* mapper) override;
 
 protected:
@@ -47,7 +47,7 @@ vtkFixedPointVolumeRayCastCompositeGOShadeHelper::
 // Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageOneSimpleNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOShadeNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -91,7 +91,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageOneSimpleNN(
 // Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageOneNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOShadeNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -136,7 +136,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageOneNN(
 // threshold). Finally we move to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageTwoDependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOShadeNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -196,7 +196,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageTwoDependentNN(
 // Finally we move onto the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageFourDependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOShadeNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -255,7 +255,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageFourDependentNN(
 // threshold). Finally we increment to the next sample on the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageIndependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartGOShadeNN();
@@ -307,7 +307,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageIndependentNN(
 // sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageOneSimpleTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOShadeTrilin();
   VTKKWRCHelper_InitializeCompositeOneTrilin();
@@ -400,7 +400,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageOneSimpleTrilin(
 // threshold). Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageOneTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOShadeTrilin();
   VTKKWRCHelper_InitializeCompositeOneTrilin();
@@ -495,7 +495,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageOneTrilin(
 // the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageTwoDependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOShadeTrilin();
   VTKKWRCHelper_InitializeCompositeMultiTrilin();
@@ -595,7 +595,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageTwoDependentTrilin(
 // move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageFourDependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartGOShadeTrilin();
   VTKKWRCHelper_InitializeCompositeMultiTrilin();
@@ -696,7 +696,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageFourDependentTrilin(
 // move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeGOShadeHelperGenerateImageIndependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartGOShadeTrilin();
@@ -796,7 +796,7 @@ void vtkFixedPointCompositeGOShadeHelperGenerateImageIndependentTrilin(
 }
 
 void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
-  int threadID, int threadCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
+  int tileIndex, int tileCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
 {
   void* data = mapper->GetCurrentScalars()->GetVoidPointer(0);
   int scalarType = mapper->GetCurrentScalars()->GetDataType();
@@ -813,7 +813,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOShadeHelperGenerateImageOneSimpleNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       else
@@ -821,7 +821,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOShadeHelperGenerateImageOneNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -831,7 +831,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointCompositeGOShadeHelperGenerateImageIndependentNN(
-          static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent (color) components
@@ -844,7 +844,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOShadeHelperGenerateImageTwoDependentNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Four components - they must be unsigned char, the first three directly
@@ -855,7 +855,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
         if (scalarType == VTK_UNSIGNED_CHAR)
         {
           vtkFixedPointCompositeGOShadeHelperGenerateImageFourDependentNN(
-            static_cast<unsigned char*>(data), threadID, threadCount, mapper, vol);
+            static_cast<unsigned char*>(data), tileIndex, tileCount, mapper, vol);
         }
         else
         {
@@ -876,7 +876,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOShadeHelperGenerateImageOneSimpleTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Scale != 1.0 or shift != 0.0 - must apply scale/shift in inner loop
@@ -885,7 +885,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOShadeHelperGenerateImageOneTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -895,7 +895,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointCompositeGOShadeHelperGenerateImageIndependentTrilin(
-          static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent components
@@ -908,7 +908,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeGOShadeHelperGenerateImageTwoDependentTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Four components - they must be unsigned char, the first three directly
@@ -919,7 +919,7 @@ void vtkFixedPointVolumeRayCastCompositeGOShadeHelper::GenerateImage(
         if (scalarType == VTK_UNSIGNED_CHAR)
         {
           vtkFixedPointCompositeGOShadeHelperGenerateImageFourDependentTrilin(
-            static_cast<unsigned char*>(data), threadID, threadCount, mapper, vol);
+            static_cast<unsigned char*>(data), tileIndex, tileCount, mapper, vol);
         }
         else
         {
@@ -44,7 +44,7 @@ vtkFixedPointVolumeRayCastCompositeHelper::~vtkFixedPointVolumeRayCastCompositeH
 // this point (if the accumulated opacity is higher than some threshold).
 // Finally we move on to the next sample along the ray.
 template <class T>
-void vtkFixedPointCompositeHelperGenerateImageOneSimpleNN(T* data, int threadID, int threadCount,
+void vtkFixedPointCompositeHelperGenerateImageOneSimpleNN(T* data, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartNN();
@@ -84,7 +84,7 @@ void vtkFixedPointCompositeHelperGenerateImageOneSimpleNN(T* data, int threadID,
 // this point (if the accumulated opacity is higher than some threshold).
 // Finally we move on to the next sample along the ray.
 template <class T>
-void vtkFixedPointCompositeHelperGenerateImageOneNN(T* data, int threadID, int threadCount,
+void vtkFixedPointCompositeHelperGenerateImageOneNN(T* data, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartNN();
@@ -124,7 +124,7 @@ void vtkFixedPointCompositeHelperGenerateImageOneNN(T* data, int threadID, int t
 // see if we can terminate here (if the opacity accumulated exceed some
 // threshold). Finally we move to the next sample along the ray.
 template <class T>
-void vtkFixedPointCompositeHelperGenerateImageTwoDependentNN(T* data, int threadID, int threadCount,
+void vtkFixedPointCompositeHelperGenerateImageTwoDependentNN(T* data, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartNN();
@@ -177,8 +177,8 @@ void vtkFixedPointCompositeHelperGenerateImageTwoDependentNN(T* data, int thread
 // terminate here (if our accumulated opacity has exceed some threshold).
 // Finally we move onto the next sample along the ray.
 template <class T>
-void vtkFixedPointCompositeHelperGenerateImageFourDependentNN(T* data, int threadID,
-  int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
+void vtkFixedPointCompositeHelperGenerateImageFourDependentNN(T* data, int tileIndex, int tileCount,
+  vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -229,7 +229,7 @@ void vtkFixedPointCompositeHelperGenerateImageFourDependentNN(T* data, int threa
 // threshold). Finally we increment to the next sample on the ray.
 template <class T>
 void vtkFixedPointCompositeHelperGenerateImageIndependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartNN();
@@ -273,8 +273,8 @@ void vtkFixedPointCompositeHelperGenerateImageIndependentNN(
 // opacity is higher than some threshold). Finally we move on to the next
 // sample along the ray.
 template <class T>
-void vtkFixedPointCompositeHelperGenerateImageOneSimpleTrilin(T* data, int threadID,
-  int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
+void vtkFixedPointCompositeHelperGenerateImageOneSimpleTrilin(T* data, int tileIndex, int tileCount,
+  vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartTrilin();
   VTKKWRCHelper_InitializeCompositeOneTrilin();
@@ -324,7 +324,7 @@ void vtkFixedPointCompositeHelperGenerateImageOneSimpleTrilin(T* data, int threa
 // terminate at this point (if the accumulated opacity is higher than some
 // threshold). Finally we move on to the next sample along the ray.
 template <class T>
-void vtkFixedPointCompositeHelperGenerateImageOneTrilin(T* data, int threadID, int threadCount,
+void vtkFixedPointCompositeHelperGenerateImageOneTrilin(T* data, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartTrilin();
@@ -376,8 +376,8 @@ void vtkFixedPointCompositeHelperGenerateImageOneTrilin(T* data, int threadID, i
 // higher than some threshold). Finally we move on to the next sample along
 // the ray.
 template <class T>
-void vtkFixedPointCompositeHelperGenerateImageTwoDependentTrilin(T* data, int threadID,
-  int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
+void vtkFixedPointCompositeHelperGenerateImageTwoDependentTrilin(T* data, int tileIndex,
+  int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartTrilin();
   VTKKWRCHelper_InitializeCompositeMultiTrilin();
@@ -444,8 +444,8 @@ void vtkFixedPointCompositeHelperGenerateImageTwoDependentTrilin(T* data, int th
 // point (if the accumulated opacity is higher than some threshold). Finally we
 // move on to the next sample along the ray.
 template <class T>
-void vtkFixedPointCompositeHelperGenerateImageFourDependentTrilin(T* data, int threadID,
-  int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
+void vtkFixedPointCompositeHelperGenerateImageFourDependentTrilin(T* data, int tileIndex,
+  int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartTrilin();
   VTKKWRCHelper_InitializeCompositeMultiTrilin();
@@ -515,7 +515,7 @@ void vtkFixedPointCompositeHelperGenerateImageFourDependentTrilin(T* data, int t
 // move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeHelperGenerateImageIndependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartTrilin();
@@ -570,7 +570,7 @@ void vtkFixedPointCompositeHelperGenerateImageIndependentTrilin(
 }
 
 void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
-  int threadID, int threadCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
+  int tileIndex, int tileCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
 {
   void* data = mapper->GetCurrentScalars()->GetVoidPointer(0);
   int scalarType = mapper->GetCurrentScalars()->GetDataType();
@@ -587,7 +587,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeHelperGenerateImageOneSimpleNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       else
@@ -595,7 +595,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeHelperGenerateImageOneNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -605,7 +605,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointCompositeHelperGenerateImageIndependentNN(
-          static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent (color) components
@@ -618,7 +618,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeHelperGenerateImageTwoDependentNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Four components - they must be unsigned char, the first three directly
@@ -629,7 +629,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
         if (scalarType == VTK_UNSIGNED_CHAR)
         {
           vtkFixedPointCompositeHelperGenerateImageFourDependentNN(
-            static_cast<unsigned char*>(data), threadID, threadCount, mapper, vol);
+            static_cast<unsigned char*>(data), tileIndex, tileCount, mapper, vol);
         }
         else
         {
@@ -650,7 +650,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeHelperGenerateImageOneSimpleTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Scale != 1.0 or shift != 0.0 - must apply scale/shift in inner loop
@@ -659,7 +659,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeHelperGenerateImageOneTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -669,7 +669,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointCompositeHelperGenerateImageIndependentTrilin(
-          static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent components
@@ -682,7 +682,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeHelperGenerateImageTwoDependentTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Four components - they must be unsigned char, the first three directly
@@ -693,7 +693,7 @@ void vtkFixedPointVolumeRayCastCompositeHelper::GenerateImage(
         if (scalarType == VTK_UNSIGNED_CHAR)
         {
           vtkFixedPointCompositeHelperGenerateImageFourDependentTrilin(
-            static_cast<unsigned char*>(data), threadID, threadCount, mapper, vol);
+            static_cast<unsigned char*>(data), tileIndex, tileCount, mapper, vol);
         }
         else
         {
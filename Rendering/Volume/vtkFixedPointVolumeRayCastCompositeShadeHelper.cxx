@@ -47,7 +47,7 @@ vtkFixedPointVolumeRayCastCompositeShadeHelper::~vtkFixedPointVolumeRayCastCompo
 // Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageOneSimpleNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartShadeNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -87,7 +87,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageOneSimpleNN(
 // Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageOneNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartShadeNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -128,7 +128,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageOneNN(
 // threshold). Finally we move to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageTwoDependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartShadeNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -181,7 +181,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageTwoDependentNN(
 // Finally we move onto the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageFourDependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartShadeNN();
   VTKKWRCHelper_InitializeCompositeOneNN();
@@ -234,7 +234,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageFourDependentNN(
 // TODO: short circuit calculations when opacity is 0
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageIndependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartShadeNN();
@@ -283,7 +283,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageIndependentNN(
 // sample along the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageOneSimpleTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartShadeTrilin();
   VTKKWRCHelper_InitializeCompositeOneTrilin();
@@ -345,7 +345,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageOneSimpleTrilin(
 // threshold). Finally we move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageOneTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartShadeTrilin();
   VTKKWRCHelper_InitializeCompositeOneTrilin();
@@ -408,7 +408,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageOneTrilin(
 // the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageTwoDependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartShadeTrilin();
   VTKKWRCHelper_InitializeCompositeMultiTrilin();
@@ -489,7 +489,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageTwoDependentTrilin(
 // move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageFourDependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializationAndLoopStartShadeTrilin();
   VTKKWRCHelper_InitializeCompositeMultiTrilin();
@@ -572,7 +572,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageFourDependentTrilin(
 // move on to the next sample along the ray.
 template <class T>
 void vtkFixedPointCompositeShadeHelperGenerateImageIndependentTrilin(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartShadeTrilin();
@@ -648,7 +648,7 @@ void vtkFixedPointCompositeShadeHelperGenerateImageIndependentTrilin(
 }
 
 void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
-  int threadID, int threadCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
+  int tileIndex, int tileCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
 {
   void* data = mapper->GetCurrentScalars()->GetVoidPointer(0);
   int scalarType = mapper->GetCurrentScalars()->GetDataType();
@@ -665,7 +665,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeShadeHelperGenerateImageOneSimpleNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       else
@@ -673,7 +673,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeShadeHelperGenerateImageOneNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -683,7 +683,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointCompositeShadeHelperGenerateImageIndependentNN(
-          static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent (color) components
@@ -696,7 +696,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeShadeHelperGenerateImageTwoDependentNN(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Four components - they must be unsigned char, the first three directly
@@ -707,7 +707,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
         if (scalarType == VTK_UNSIGNED_CHAR)
         {
           vtkFixedPointCompositeShadeHelperGenerateImageFourDependentNN(
-            static_cast<unsigned char*>(data), threadID, threadCount, mapper, vol);
+            static_cast<unsigned char*>(data), tileIndex, tileCount, mapper, vol);
         }
         else
         {
@@ -728,7 +728,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeShadeHelperGenerateImageOneSimpleTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Scale != 1.0 or shift != 0.0 - must apply scale/shift in inner loop
@@ -737,7 +737,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeShadeHelperGenerateImageOneTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -747,7 +747,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointCompositeShadeHelperGenerateImageIndependentTrilin(
-          static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent components
@@ -760,7 +760,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointCompositeShadeHelperGenerateImageTwoDependentTrilin(
-            static_cast<VTK_TT*>(data), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(data), tileIndex, tileCount, mapper, vol));
         }
       }
       // Four components - they must be unsigned char, the first three directly
@@ -771,7 +771,7 @@ void vtkFixedPointVolumeRayCastCompositeShadeHelper::GenerateImage(
         if (scalarType == VTK_UNSIGNED_CHAR)
         {
           vtkFixedPointCompositeShadeHelperGenerateImageFourDependentTrilin(
-            static_cast<unsigned char*>(data), threadID, threadCount, mapper, vol);
+            static_cast<unsigned char*>(data), tileIndex, tileCount, mapper, vol);
         }
         else
         {
@@ -823,7 +823,8 @@
                                                                                                    \
   int* rowBounds = mapper->GetRowBounds();                                                         \
   unsigned short* image = mapper->GetRayCastImage()->GetImage();                                   \
-  vtkRenderWindow* renWin = mapper->GetRenderWindow();                                             \
+  const int firstRow = tileIndex * imageInUseSize[1] / tileCount;                                  \
+  const int endRow = (tileIndex + 1) * imageInUseSize[1] / tileCount;                              \
   int components = 1;                                                                              \
   if (imData)                                                                                      \
   {                                                                                                \
@@ -944,18 +945,7 @@
   vtkIdType dDHinc = dim[0] * dirOffset + dirOffset;
 
 #define VTKKWRCHelper_OuterInitialization()                                                        \
-  if (j % threadCount != threadID)                                                                 \
-  {                                                                                                \
-    continue;                                                                                      \
-  }                                                                                                \
-  if (!threadID)                                                                                   \
-  {                                                                                                \
-    if (renWin->CheckAbortStatus())                                                                \
-    {                                                                                              \
-      break;                                                                                       \
-    }                                                                                              \
-  }                                                                                                \
-  else if (renWin->GetAbortRender())                                                               \
+  if (mapper->CheckAbortStatus())                                                                  \
   {                                                                                                \
     break;                                                                                         \
   }                                                                                                \
@@ -1114,7 +1104,7 @@
 
 #define VTKKWRCHelper_InitializationAndLoopStartNN()                                               \
   VTKKWRCHelper_InitializeVariables();                                                             \
-  for (j = 0; j < imageInUseSize[1]; j++)                                                          \
+  for (j = firstRow; j < endRow; j++)                                                              \
   {                                                                                                \
     VTKKWRCHelper_OuterInitialization();                                                           \
     for (i = rowBounds[j * 2]; i <= rowBounds[j * 2 + 1]; i++)                                     \
@@ -1124,7 +1114,7 @@
 #define VTKKWRCHelper_InitializationAndLoopStartGONN()                                             \
   VTKKWRCHelper_InitializeVariables();                                                             \
   VTKKWRCHelper_InitializeVariablesGO();                                                           \
-  for (j = 0; j < imageInUseSize[1]; j++)                                                          \
+  for (j = firstRow; j < endRow; j++)                                                              \
   {                                                                                                \
     VTKKWRCHelper_OuterInitialization();                                                           \
     for (i = rowBounds[j * 2]; i <= rowBounds[j * 2 + 1]; i++)                                     \
@@ -1134,7 +1124,7 @@
 #define VTKKWRCHelper_InitializationAndLoopStartShadeNN()                                          \
   VTKKWRCHelper_InitializeVariables();                                                             \
   VTKKWRCHelper_InitializeVariablesShade();                                                        \
-  for (j = 0; j < imageInUseSize[1]; j++)                                                          \
+  for (j = firstRow; j < endRow; j++)                                                              \
   {                                                                                                \
     VTKKWRCHelper_OuterInitialization();                                                           \
     for (i = rowBounds[j * 2]; i <= rowBounds[j * 2 + 1]; i++)                                     \
@@ -1145,7 +1135,7 @@
   VTKKWRCHelper_InitializeVariables();                                                             \
   VTKKWRCHelper_InitializeVariablesGO();                                                           \
   VTKKWRCHelper_InitializeVariablesShade();                                                        \
-  for (j = 0; j < imageInUseSize[1]; j++)                                                          \
+  for (j = firstRow; j < endRow; j++)                                                              \
   {                                                                                                \
     VTKKWRCHelper_OuterInitialization();                                                           \
     for (i = rowBounds[j * 2]; i <= rowBounds[j * 2 + 1]; i++)                                     \
@@ -1155,7 +1145,7 @@
 #define VTKKWRCHelper_InitializationAndLoopStartTrilin()                                           \
   VTKKWRCHelper_InitializeVariables();                                                             \
   VTKKWRCHelper_InitializeTrilinVariables();                                                       \
-  for (j = 0; j < imageInUseSize[1]; j++)                                                          \
+  for (j = firstRow; j < endRow; j++)                                                              \
   {                                                                                                \
     VTKKWRCHelper_OuterInitialization();                                                           \
     for (i = rowBounds[j * 2]; i <= rowBounds[j * 2 + 1]; i++)                                     \
@@ -1167,7 +1157,7 @@
   VTKKWRCHelper_InitializeVariablesGO();                                                           \
   VTKKWRCHelper_InitializeTrilinVariables();                                                       \
   VTKKWRCHelper_InitializeTrilinVariablesGO();                                                     \
-  for (j = 0; j < imageInUseSize[1]; j++)                                                          \
+  for (j = firstRow; j < endRow; j++)                                                              \
   {                                                                                                \
     VTKKWRCHelper_OuterInitialization();                                                           \
     for (i = rowBounds[j * 2]; i <= rowBounds[j * 2 + 1]; i++)                                     \
@@ -1179,7 +1169,7 @@
   VTKKWRCHelper_InitializeVariablesShade();                                                        \
   VTKKWRCHelper_InitializeTrilinVariables();                                                       \
   VTKKWRCHelper_InitializeTrilinVariablesShade();                                                  \
-  for (j = 0; j < imageInUseSize[1]; j++)                                                          \
+  for (j = firstRow; j < endRow; j++)                                                              \
   {                                                                                                \
     VTKKWRCHelper_OuterInitialization();                                                           \
     for (i = rowBounds[j * 2]; i <= rowBounds[j * 2 + 1]; i++)                                     \
@@ -1193,7 +1183,7 @@
   VTKKWRCHelper_InitializeTrilinVariables();                                                       \
   VTKKWRCHelper_InitializeTrilinVariablesShade();                                                  \
   VTKKWRCHelper_InitializeTrilinVariablesGO();                                                     \
-  for (j = 0; j < imageInUseSize[1]; j++)                                                          \
+  for (j = firstRow; j < endRow; j++)                                                              \
   {                                                                                                \
     VTKKWRCHelper_OuterInitialization();                                                           \
     for (i = rowBounds[j * 2]; i <= rowBounds[j * 2 + 1]; i++)                                     \
@@ -1203,12 +1193,6 @@
 #define VTKKWRCHelper_IncrementAndLoopEnd()                                                        \
   imagePtr += 4;                                                                                   \
   }                                                                                                \
-  if ((j / threadCount) % 8 == 7 && threadID == 0)                                                 \
-  {                                                                                                \
-    double fargs[1];                                                                               \
-    fargs[0] = static_cast<double>(j) / static_cast<float>(imageInUseSize[1] - 1);                 \
-    mapper->InvokeEvent(vtkCommand::VolumeMapperRenderProgressEvent, fargs);                       \
-  }                                                                                                \
   }
 
 #define VTKKWRCHelper_CroppingCheckTrilin(POS)                                                     \
@@ -1301,6 +1285,12 @@ public:
   vtkTypeMacro(vtkFixedPointVolumeRayCastHelper, vtkObject);
   void PrintSelf(ostream& os, vtkIndent indent) override;
 
+  /**
+   * Cast the rays of the scan lines of a tile of the image, the image being
+   * split into bands of consecutive scan lines. The first two arguments are the
+   * index of the tile and the number of tiles. Distinct tiles may be generated
+   * concurrently.
+   */
   virtual void GenerateImage(int, int, vtkVolume*, vtkFixedPointVolumeRayCastMapper*) {}
 
 protected:
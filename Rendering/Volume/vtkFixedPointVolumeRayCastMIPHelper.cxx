@@ -41,7 +41,7 @@ vtkFixedPointVolumeRayCastMIPHelper::~vtkFixedPointVolumeRayCastMIPHelper() = de
 // we will convert it to unsigned short using the scale/shift, then use this
 // index to lookup the final color/opacity.
 template <class T>
-void vtkFixedPointMIPHelperGenerateImageOneNN(T* data, int threadID, int threadCount,
+void vtkFixedPointMIPHelperGenerateImageOneNN(T* data, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartNN();
@@ -125,7 +125,7 @@ void vtkFixedPointMIPHelperGenerateImageOneNN(T* data, int threadID, int threadC
 // then use first component to look up a color (2 component data) or first three
 // as the color directly (four component data). Lookup alpha off the last component.
 template <class T>
-void vtkFixedPointMIPHelperGenerateImageDependentNN(T* data, int threadID, int threadCount,
+void vtkFixedPointMIPHelperGenerateImageDependentNN(T* data, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartNN();
@@ -199,7 +199,7 @@ void vtkFixedPointMIPHelperGenerateImageDependentNN(T* data, int threadID, int t
 // blend these into one final color.
 template <class T>
 void vtkFixedPointMIPHelperGenerateImageIndependentNN(
-  T* data, int threadID, int threadCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
+  T* data, int tileIndex, int tileCount, vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
   VTKKWRCHelper_InitializationAndLoopStartNN();
@@ -264,7 +264,7 @@ void vtkFixedPointMIPHelperGenerateImageIndependentNN(
 // interpolation to compute the index. We find the maximum index along
 // the ray, and then use this to look up a final color.
 template <class T>
-void vtkFixedPointMIPHelperGenerateImageOneSimpleTrilin(T* dataPtr, int threadID, int threadCount,
+void vtkFixedPointMIPHelperGenerateImageOneSimpleTrilin(T* dataPtr, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartTrilin();
@@ -356,7 +356,7 @@ void vtkFixedPointMIPHelperGenerateImageOneSimpleTrilin(T* dataPtr, int threadID
 // We find the maximum index along the ray, and then use this to look up a
 // final color.
 template <class T>
-void vtkFixedPointMIPHelperGenerateImageOneTrilin(T* dataPtr, int threadID, int threadCount,
+void vtkFixedPointMIPHelperGenerateImageOneTrilin(T* dataPtr, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartTrilin();
@@ -426,7 +426,7 @@ void vtkFixedPointMIPHelperGenerateImageOneTrilin(T* dataPtr, int threadID, int
 // check if we can terminate at this point (if the accumulated opacity is
 // higher than some threshold).
 template <class T>
-void vtkFixedPointMIPHelperGenerateImageDependentTrilin(T* dataPtr, int threadID, int threadCount,
+void vtkFixedPointMIPHelperGenerateImageDependentTrilin(T* dataPtr, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vtkNotUsed(vol))
 {
   VTKKWRCHelper_InitializationAndLoopStartTrilin();
@@ -513,7 +513,7 @@ void vtkFixedPointMIPHelperGenerateImageDependentTrilin(T* dataPtr, int threadID
 // per component, then we look up a color/opacity for each component and blend
 // them according to the component weights.
 template <class T>
-void vtkFixedPointMIPHelperGenerateImageIndependentTrilin(T* dataPtr, int threadID, int threadCount,
+void vtkFixedPointMIPHelperGenerateImageIndependentTrilin(T* dataPtr, int tileIndex, int tileCount,
   vtkFixedPointVolumeRayCastMapper* mapper, vtkVolume* vol)
 {
   VTKKWRCHelper_InitializeWeights();
@@ -579,7 +579,7 @@ void vtkFixedPointMIPHelperGenerateImageIndependentTrilin(T* dataPtr, int thread
 }
 
 void vtkFixedPointVolumeRayCastMIPHelper::GenerateImage(
-  int threadID, int threadCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
+  int tileIndex, int tileCount, vtkVolume* vol, vtkFixedPointVolumeRayCastMapper* mapper)
 {
   void* dataPtr = mapper->GetCurrentScalars()->GetVoidPointer(0);
   int scalarType = mapper->GetCurrentScalars()->GetDataType();
@@ -593,7 +593,7 @@ void vtkFixedPointVolumeRayCastMIPHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointMIPHelperGenerateImageOneNN(
-          static_cast<VTK_TT*>(dataPtr), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(dataPtr), tileIndex, tileCount, mapper, vol));
       }
     }
     // More that one independent components
@@ -602,7 +602,7 @@ void vtkFixedPointVolumeRayCastMIPHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointMIPHelperGenerateImageIndependentNN(
-          static_cast<VTK_TT*>(dataPtr), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(dataPtr), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent (color) components
@@ -611,7 +611,7 @@ void vtkFixedPointVolumeRayCastMIPHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointMIPHelperGenerateImageDependentNN(
-          static_cast<VTK_TT*>(dataPtr), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(dataPtr), tileIndex, tileCount, mapper, vol));
       }
     }
   }
@@ -627,7 +627,7 @@ void vtkFixedPointVolumeRayCastMIPHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointMIPHelperGenerateImageOneSimpleTrilin(
-            static_cast<VTK_TT*>(dataPtr), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(dataPtr), tileIndex, tileCount, mapper, vol));
         }
       }
       // Scale != 1.0 or shift != 0.0 - must apply scale/shift in inner loop
@@ -636,7 +636,7 @@ void vtkFixedPointVolumeRayCastMIPHelper::GenerateImage(
         switch (scalarType)
         {
           vtkTemplateMacro(vtkFixedPointMIPHelperGenerateImageOneTrilin(
-            static_cast<VTK_TT*>(dataPtr), threadID, threadCount, mapper, vol));
+            static_cast<VTK_TT*>(dataPtr), tileIndex, tileCount, mapper, vol));
         }
       }
     }
@@ -646,7 +646,7 @@ void vtkFixedPointVolumeRayCastMIPHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointMIPHelperGenerateImageIndependentTrilin(
-          static_cast<VTK_TT*>(dataPtr), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(dataPtr), tileIndex, tileCount, mapper, vol));
       }
     }
     // Dependent components
@@ -655,7 +655,7 @@ void vtkFixedPointVolumeRayCastMIPHelper::GenerateImage(
       switch (scalarType)
       {
         vtkTemplateMacro(vtkFixedPointMIPHelperGenerateImageDependentTrilin(
-          static_cast<VTK_TT*>(dataPtr), threadID, threadCount, mapper, vol));
+          static_cast<VTK_TT*>(dataPtr), tileIndex, tileCount, mapper, vol));
       }
     }
   }
@@ -30,7 +30,6 @@
 #include "vtkImageData.h"
 #include "vtkLight.h"
 #include "vtkMath.h"
-#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPiecewiseFunction.h"
 #include "vtkPlaneCollection.h"
@@ -38,6 +37,7 @@
 #include "vtkRayCastImageDisplayHelper.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderer.h"
+#include "vtkSMPTools.h"
 #include "vtkSphericalDirectionEncoder.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTimerLog.h"
@@ -45,6 +45,7 @@
 #include "vtkVolumeProperty.h"
 #include "vtkVolumeRayCastSpaceLeapingImageFilter.h"
 
+#include <algorithm>
 #include <cmath>
 #include <exception>
 
@@ -72,8 +73,7 @@ vtkCxxSetObjectMacro(vtkFixedPointVolumeRayCastMapper, RayCastImage, vtkFixedPoi
 template <class T>
 void vtkFixedPointVolumeRayCastMapperComputeCS1CGradients(T* dataPtr, int dim[3], double spacing[3],
   double scalarRange[2], unsigned short** gradientNormal, unsigned char** gradientMagnitude,
-  vtkDirectionEncoder* directionEncoder, int thread_id, int thread_count,
-  vtkFixedPointVolumeRayCastMapper* me)
+  vtkDirectionEncoder* directionEncoder, int tile_index, int tile_count)
 {
   int x, y, z;
   vtkIdType yinc, zinc;
@@ -89,11 +89,6 @@ void vtkFixedPointVolumeRayCastMapperComputeCS1CGradients(T* dataPtr, int dim[3]
   unsigned short* dirPtr;
   unsigned char* magPtr;
 
-  if (thread_id == 0)
-  {
-    me->InvokeEvent(vtkCommand::VolumeMapperComputeGradientsStartEvent, nullptr);
-  }
-
   double avgSpacing = (spacing[0] + spacing[1] + spacing[2]) / 3.0;
 
   // adjust the aspect
@@ -118,8 +113,8 @@ void vtkFixedPointVolumeRayCastMapperComputeCS1CGradients(T* dataPtr, int dim[3]
   x_limit = dim[0];
   y_start = 0;
   y_limit = dim[1];
-  z_start = (int)(((float)thread_id / (float)thread_count) * dim[2]);
-  z_limit = (int)(((float)(thread_id + 1) / (float)thread_count) * dim[2]);
+  z_start = tile_index * dim[2] / tile_count;
+  z_limit = (tile_index + 1) * dim[2] / tile_count;
 
   // Do sanity checking on limits - make sure they are all within bounds
   // of the scalar input
@@ -209,7 +204,7 @@ void vtkFixedPointVolumeRayCastMapperComputeCS1CGradients(T* dataPtr, int dim[3]
 
       // Find the pointer for the slice after - use this if there is
       // no slice after
-      if (z < z_limit - 1)
+      if (z < dim[2] - 1)
       {
         dptr = dataPtr + (z + 1) * zinc + y * yinc + xlow;
       }
@@ -263,75 +258,94 @@ void vtkFixedPointVolumeRayCastMapperComputeCS1CGradients(T* dataPtr, int dim[3]
         *(dirPtr++) = directionEncoder->GetEncodedDirection(n);
       }
     }
-
-    if ((z / thread_count) % 8 == 7 && thread_id == 0)
-    {
-      double args[1];
-      args[0] = static_cast<float>(z - z_start) / static_cast<float>(z_limit - z_start - 1);
-      me->InvokeEvent(vtkCommand::VolumeMapperComputeGradientsProgressEvent, args);
-    }
   }
 
   delete[] dxBuffer;
   delete[] dyBuffer;
   delete[] dzBuffer;
+}
 
-  if (thread_id == 0)
+namespace
+{
+// Whether the current thread started the render or the gradient computation,
+// the only one allowed to invoke events while the work is split into tiles.
+thread_local bool vtkFPVRCMIsMainThread = false;
+
+// Number of scan lines in a tile of the ray cast image
+constexpr int vtkFPVRCMRowsPerTile = 8;
+
+// Number of tiles per thread dispatched in a batch
+constexpr int vtkFPVRCMTilesPerThread = 4;
+
+// Process numberOfTiles tiles with vtkSMPTools, using at most numberOfThreads
+// threads if positive. The tiles are dispatched in batches, a thread picking
+// the next tile of the batch when done with its current one. Between the
+// batches, the calling thread calls progress with the fraction of processed
+// tiles, the remaining tiles being skipped if it returns false. The calling
+// thread may not process any tile itself, with the STDThread backend for
+// instance, so this is where it can invoke events and check for aborts.
+template <typename TileWorker, typename ProgressReporter>
+void vtkFPVRCMForEachTile(
+  int numberOfThreads, int numberOfTiles, TileWorker&& worker, ProgressReporter&& progress)
+{
+  auto process = [&]() {
+    const int batchSize =
+      vtkFPVRCMTilesPerThread * std::max(1, vtkSMPTools::GetEstimatedNumberOfThreads());
+    for (int first = 0; first < numberOfTiles; first += batchSize)
+    {
+      const int last = std::min(first + batchSize, numberOfTiles);
+      vtkSMPTools::For(first, last, 1, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType tile = begin; tile < end; ++tile)
+        {
+          worker(static_cast<int>(tile));
+        }
+      });
+      if (!progress(static_cast<double>(last) / numberOfTiles))
+      {
+        break;
+      }
+    }
+  };
+
+  const bool wasMainThread = vtkFPVRCMIsMainThread;
+  vtkFPVRCMIsMainThread = true;
+  if (numberOfThreads > 0)
   {
-    me->InvokeEvent(vtkCommand::VolumeMapperComputeGradientsEndEvent, nullptr);
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ numberOfThreads }, process);
   }
+  else
+  {
+    process();
+  }
+  vtkFPVRCMIsMainThread = wasMainThread;
 }
+} // anonymous namespace
 
-VTK_THREAD_RETURN_TYPE vtkFPVRCMSwitchOnDataType(void* arg)
+static void vtkFPVRCMSwitchOnDataType(void* dataPtr, int scalarType, int dim[3],
+  double spacing[3], double scalarRange[2], unsigned short** gradientNormal,
+  unsigned char** gradientMagnitude, vtkDirectionEncoder* directionEncoder, int tile_index,
+  int tile_count)
 {
-  vtkFixedPointVolumeRayCastMapper* mapper;
-  int thread_count;
-  int thread_id;
-
-  thread_id = ((vtkMultiThreader::ThreadInfo*)(arg))->ThreadID;
-  thread_count = ((vtkMultiThreader::ThreadInfo*)(arg))->NumberOfThreads;
-  mapper = (vtkFixedPointVolumeRayCastMapper*)(((vtkMultiThreader::ThreadInfo*)(arg))->UserData);
-
-  vtkImageData* input = vtkImageData::SafeDownCast(mapper->GetInput());
-
-  void* dataPtr = mapper->GetCurrentScalars()->GetVoidPointer(0);
-  int scalarType = mapper->GetCurrentScalars()->GetDataType();
-
-  int dim[3];
-  double spacing[3];
-  input->GetDimensions(dim);
-  input->GetSpacing(spacing);
-
-  // Find the scalar range
-  double scalarRange[2];
-  mapper->GetCurrentScalars()->GetRange(scalarRange, 0);
-
   if (scalarType == VTK_UNSIGNED_CHAR)
   {
     vtkFixedPointVolumeRayCastMapperComputeCS1CGradients((unsigned char*)(dataPtr), dim, spacing,
-      scalarRange, mapper->GradientNormal, mapper->GradientMagnitude, mapper->DirectionEncoder,
-      thread_id, thread_count, mapper);
+      scalarRange, gradientNormal, gradientMagnitude, directionEncoder, tile_index, tile_count);
   }
   else if (scalarType == VTK_UNSIGNED_SHORT)
   {
     vtkFixedPointVolumeRayCastMapperComputeCS1CGradients((unsigned short*)(dataPtr), dim, spacing,
-      scalarRange, mapper->GradientNormal, mapper->GradientMagnitude, mapper->DirectionEncoder,
-      thread_id, thread_count, mapper);
+      scalarRange, gradientNormal, gradientMagnitude, directionEncoder, tile_index, tile_count);
   }
   else if (scalarType == VTK_CHAR)
   {
     vtkFixedPointVolumeRayCastMapperComputeCS1CGradients((char*)(dataPtr), dim, spacing,
-      scalarRange, mapper->GradientNormal, mapper->GradientMagnitude, mapper->DirectionEncoder,
-      thread_id, thread_count, mapper);
+      scalarRange, gradientNormal, gradientMagnitude, directionEncoder, tile_index, tile_count);
   }
   else if (scalarType == VTK_SHORT)
   {
     vtkFixedPointVolumeRayCastMapperComputeCS1CGradients((short*)(dataPtr), dim, spacing,
-      scalarRange, mapper->GradientNormal, mapper->GradientMagnitude, mapper->DirectionEncoder,
-      thread_id, thread_count, mapper);
+      scalarRange, gradientNormal, gradientMagnitude, directionEncoder, tile_index, tile_count);
   }
-
-  return VTK_THREAD_RETURN_VALUE;
 }
 
 template <class T>
@@ -574,8 +588,7 @@ vtkFixedPointVolumeRayCastMapper::vtkFixedPointVolumeRayCastMapper()
   this->VoxelsTransform = vtkTransform::New();
   this->VoxelsToViewTransform = vtkTransform::New();
 
-  this->Threader = vtkMultiThreader::New();
-  this->ThreadWarning = true;
+  this->NumberOfThreads = 0;
   this->RayCastImage = vtkFixedPointRayCastImage::New();
 
   this->RowBounds = nullptr;
@@ -679,6 +692,7 @@ vtkFixedPointVolumeRayCastMapper::vtkFixedPointVolumeRayCastMapper()
   this->TableScale[3] = 1;
 
   this->SpaceLeapFilter = vtkVolumeRayCastSpaceLeapingImageFilter::New();
+  this->SpaceLeapFilter->SetEnableSMP(true);
 
   // Cached space leaping output. This is shared between runs. The output
   // of the last run is passed back to the SpaceLeapFilter and its reused
@@ -705,8 +719,6 @@ vtkFixedPointVolumeRayCastMapper::~vtkFixedPointVolumeRayCastMapper()
   this->VoxelsToViewTransform->Delete();
   this->PerspectiveTransform->Delete();
 
-  this->Threader->Delete();
-
   this->MIPHelper->Delete();
   this->CompositeHelper->Delete();
   this->CompositeGOHelper->Delete();
@@ -907,16 +919,17 @@ void vtkFixedPointVolumeRayCastMapper::StoreRenderTime(vtkRenderer* ren, vtkVolu
 
 void vtkFixedPointVolumeRayCastMapper::SetNumberOfThreads(int num)
 {
-  this->Threader->SetNumberOfThreads(num);
+  num = std::max(num, 0);
+  if (this->NumberOfThreads != num)
+  {
+    this->NumberOfThreads = num;
+    this->Modified();
+  }
 }
 
 int vtkFixedPointVolumeRayCastMapper::GetNumberOfThreads()
 {
-  if (this->Threader)
-  {
-    return this->Threader->GetNumberOfThreads();
-  }
-  return 0;
+  return this->NumberOfThreads;
 }
 
 //------------------------------------------------------------------------------
@@ -989,7 +1002,15 @@ void vtkFixedPointVolumeRayCastMapper::UpdateMinMaxVolume(vtkVolume* vol)
     this->SpaceLeapFilter->SetGradientOpacityTable(compIdx, this->GradientOpacityTable[compIdx]);
   }
   this->SpaceLeapFilter->SetCache(this->MinMaxVolumeCache);
-  this->SpaceLeapFilter->Update();
+  if (this->NumberOfThreads > 0)
+  {
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ this->NumberOfThreads },
+      [this]() { this->SpaceLeapFilter->Update(); });
+  }
+  else
+  {
+    this->SpaceLeapFilter->Update();
+  }
   this->MinMaxVolume = this->SpaceLeapFilter->GetMinMaxVolume(this->MinMaxVolumeSize);
 
   // Cached space leaping output. This is shared between runs. The output
@@ -1209,11 +1230,20 @@ void vtkFixedPointVolumeRayCastMapper::PerSubVolumeInitialization(
 // This is the render method for the subvolume
 void vtkFixedPointVolumeRayCastMapper::RenderSubVolume()
 {
-  // Set the number of threads to use for ray casting,
-  // then set the execution method and do it.
+  // Cast the rays tile by tile, the number of scan lines varying from a tile
+  // to another is balanced by letting the threads pick the next tile.
   this->InvokeEvent(vtkCommand::VolumeMapperRenderStartEvent, nullptr);
-  this->Threader->SetSingleMethod(FixedPointVolumeRayCastMapper_CastRays, (void*)this);
-  this->Threader->SingleMethodExecute();
+  int imageInUseSize[2];
+  this->RayCastImage->GetImageInUseSize(imageInUseSize);
+  const int numberOfTiles =
+    std::max(1, (imageInUseSize[1] + vtkFPVRCMRowsPerTile - 1) / vtkFPVRCMRowsPerTile);
+  vtkFPVRCMForEachTile(
+    this->NumberOfThreads, numberOfTiles, [&](int tile) { this->CastRays(tile, numberOfTiles); },
+    [&](double fraction) {
+      this->InvokeEvent(vtkCommand::VolumeMapperRenderProgressEvent, &fraction);
+      // the tiles left skip their scan lines once the render is aborted
+      return !this->CheckAbortStatus();
+    });
   this->InvokeEvent(vtkCommand::VolumeMapperRenderEndEvent, nullptr);
 }
 
@@ -1360,15 +1390,6 @@ void vtkFixedPointVolumeRayCastMapper::CaptureZBuffer(vtkRenderer* ren)
 
 void vtkFixedPointVolumeRayCastMapper::Render(vtkRenderer* ren, vtkVolume* vol)
 {
-  //  if (this->Threader->GetNumberOfThreads() > 1 && this->ThreadWarning)
-  //    {
-  //    vtkWarningMacro("Number of threads "
-  //                    << this->Threader->GetNumberOfThreads()
-  //                    << " is  > 1. This class does not produce repeatable results when the number
-  //                    of threads exceeds 1.");
-  //    this->ThreadWarning = false;
-  //    }
-
   if (vtkImageData::SafeDownCast(this->GetInput()) == nullptr)
   {
     vtkWarningMacro("Mapper supports only vtkImageData");
@@ -1437,55 +1458,46 @@ void vtkFixedPointVolumeRayCastMapper::Render(vtkRenderer* ren, vtkVolume* vol)
   this->SampleDistance = this->OldSampleDistance;
 }
 
-VTK_THREAD_RETURN_TYPE FixedPointVolumeRayCastMapper_CastRays(void* arg)
+void vtkFixedPointVolumeRayCastMapper::CastRays(int tileID, int numberOfTiles)
 {
-  // Get the info out of the input structure
-  int threadID = ((vtkMultiThreader::ThreadInfo*)(arg))->ThreadID;
-  int threadCount = ((vtkMultiThreader::ThreadInfo*)(arg))->NumberOfThreads;
-
-  vtkFixedPointVolumeRayCastMapper* me =
-    (vtkFixedPointVolumeRayCastMapper*)(((vtkMultiThreader::ThreadInfo*)arg)->UserData);
+  vtkVolume* vol = this->Volume;
 
-  if (!me)
+  if (this->GetBlendMode() == vtkVolumeMapper::MAXIMUM_INTENSITY_BLEND ||
+    this->GetBlendMode() == vtkVolumeMapper::MINIMUM_INTENSITY_BLEND)
   {
-    vtkGenericWarningMacro("Irrecoverable error: no mapper specified");
-    return VTK_THREAD_RETURN_VALUE;
-  }
-
-  vtkVolume* vol = me->GetVolume();
-
-  if (me->GetBlendMode() == vtkVolumeMapper::MAXIMUM_INTENSITY_BLEND ||
-    me->GetBlendMode() == vtkVolumeMapper::MINIMUM_INTENSITY_BLEND)
-  {
-    me->GetMIPHelper()->GenerateImage(threadID, threadCount, vol, me);
+    this->GetMIPHelper()->GenerateImage(tileID, numberOfTiles, vol, this);
   }
   else
   {
-    if (me->GetShadingRequired() == 0)
+    if (this->GetShadingRequired() == 0)
     {
-      if (me->GetGradientOpacityRequired() == 0)
+      if (this->GetGradientOpacityRequired() == 0)
       {
-        me->GetCompositeHelper()->GenerateImage(threadID, threadCount, vol, me);
+        this->GetCompositeHelper()->GenerateImage(tileID, numberOfTiles, vol, this);
       }
       else
       {
-        me->GetCompositeGOHelper()->GenerateImage(threadID, threadCount, vol, me);
+        this->GetCompositeGOHelper()->GenerateImage(tileID, numberOfTiles, vol, this);
       }
     }
     else
     {
-      if (me->GetGradientOpacityRequired() == 0)
+      if (this->GetGradientOpacityRequired() == 0)
       {
-        me->GetCompositeShadeHelper()->GenerateImage(threadID, threadCount, vol, me);
+        this->GetCompositeShadeHelper()->GenerateImage(tileID, numberOfTiles, vol, this);
       }
       else
       {
-        me->GetCompositeGOShadeHelper()->GenerateImage(threadID, threadCount, vol, me);
+        this->GetCompositeGOShadeHelper()->GenerateImage(tileID, numberOfTiles, vol, this);
       }
     }
   }
+}
 
-  return VTK_THREAD_RETURN_VALUE;
+int vtkFixedPointVolumeRayCastMapper::CheckAbortStatus()
+{
+  return vtkFPVRCMIsMainThread ? this->RenderWindow->CheckAbortStatus()
+                               : this->RenderWindow->GetAbortRender();
 }
 
 // Create an image into the vtkImageData argmument. Used generally for
@@ -2690,8 +2702,19 @@ void vtkFixedPointVolumeRayCastMapper::ComputeGradients(vtkVolume* vol)
     (scalarType == VTK_UNSIGNED_CHAR || scalarType == VTK_CHAR ||
       scalarType == VTK_UNSIGNED_SHORT || scalarType == VTK_SHORT))
   {
-    this->Threader->SetSingleMethod(vtkFPVRCMSwitchOnDataType, (vtkObject*)this);
-    this->Threader->SingleMethodExecute();
+    // One tile per slice, the gradients of a slice only depend on the input
+    this->InvokeEvent(vtkCommand::VolumeMapperComputeGradientsStartEvent, nullptr);
+    vtkFPVRCMForEachTile(
+      this->NumberOfThreads, dim[2],
+      [&](int tile) {
+        vtkFPVRCMSwitchOnDataType(dataPtr, scalarType, dim, spacing, scalarRange[0],
+          this->GradientNormal, this->GradientMagnitude, this->DirectionEncoder, tile, dim[2]);
+      },
+      [&](double fraction) {
+        this->InvokeEvent(vtkCommand::VolumeMapperComputeGradientsProgressEvent, &fraction);
+        return true;
+      });
+    this->InvokeEvent(vtkCommand::VolumeMapperComputeGradientsEndEvent, nullptr);
   }
 
   else
@@ -3178,6 +3201,7 @@ void vtkFixedPointVolumeRayCastMapper::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Minimum Image Sample Distance: " << this->MinimumImageSampleDistance << endl;
   os << indent << "Maximum Image Sample Distance: " << this->MaximumImageSampleDistance << endl;
   os << indent << "Auto Adjust Sample Distances: " << this->AutoAdjustSampleDistances << endl;
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << endl;
   os << indent << "LockSampleDistanceToInputSpacing: "
      << (this->LockSampleDistanceToInputSpacing ? "On\n" : "Off\n");
   os << indent << "Intermix Intersecting Geometry: "
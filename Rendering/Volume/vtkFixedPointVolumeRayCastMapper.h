@@ -21,12 +21,10 @@
  * composite or MIP rendering, and can be intermixed with geometric data.
  * Space leaping is used to speed up the rendering process. In addition,
  * calculation are performed in 15 bit fixed point precision. This mapper
- * is threaded, and will interleave scan lines across processors.
- *
- * WARNING: This ray caster may not produce consistent results when
- * the number of threads exceeds 1. The class warns if the number of
- * threads > 1. The differences may be subtle. Applications should decide
- * if the trade-off in performance is worth the lack of consistency.
+ * is threaded with vtkSMPTools: the image is split into tiles of a few scan
+ * lines that are cast concurrently, idle threads picking the next tile so
+ * that the load remains balanced when the volume covers part of the screen.
+ * The image does not depend on the number of threads.
  *
  * Other limitations of this ray caster include that:
  *   - it does not do isosurface ray casting
@@ -57,7 +55,6 @@
 #define vtkFixedPointVolumeRayCastMapper_h
 
 #include "vtkRenderingVolumeModule.h" // For export macro
-#include "vtkThreads.h"               // for VTK_THREAD_RETURN_TYPE
 #include "vtkVolumeMapper.h"
 
 #define VTKKW_FP_SHIFT 15
@@ -66,7 +63,6 @@
 #define VTKKW_FP_SCALE 32767.0
 
 class vtkMatrix4x4;
-class vtkMultiThreader;
 class vtkPlaneCollection;
 class vtkRenderer;
 class vtkTimerLog;
@@ -88,10 +84,6 @@ class vtkRayCastImageDisplayHelper;
 class vtkFixedPointRayCastImage;
 class vtkDataArray;
 
-// Forward declaration needed for use by friend declaration below.
-VTK_THREAD_RETURN_TYPE FixedPointVolumeRayCastMapper_CastRays(void* arg);
-VTK_THREAD_RETURN_TYPE vtkFPVRCMSwitchOnDataType(void* arg);
-
 class VTKRENDERINGVOLUME_EXPORT vtkFixedPointVolumeRayCastMapper : public vtkVolumeMapper
 {
 public:
@@ -182,9 +174,8 @@ public:
 
   ///@{
   /**
-   * Set/Get the number of threads to use. This by default is equal to
-   * the number of available processors detected.
-   * WARNING: If number of threads > 1, results may not be consistent.
+   * Set/Get the maximum number of threads to use. The default, 0, uses the
+   * number of threads of vtkSMPTools.
    */
   void SetNumberOfThreads(int num);
   int GetNumberOfThreads();
@@ -286,6 +277,13 @@ public:
   void DisplayRenderedImage(vtkRenderer*, vtkVolume*);
   void AbortRender();
 
+  /**
+   * Check whether the render was aborted, used by the helpers before casting
+   * each scan line. Only the thread that started the render asks the render
+   * window to check for an abort request, the other threads read its flag.
+   */
+  int CheckAbortStatus();
+
   void CreateCanonicalView(vtkVolume* volume, vtkImageData* image, int blend_mode,
     double viewDirection[3], double viewUp[3]);
 
@@ -365,10 +363,10 @@ protected:
 
   void CaptureZBuffer(vtkRenderer* ren);
 
-  friend VTK_THREAD_RETURN_TYPE FixedPointVolumeRayCastMapper_CastRays(void* arg);
-  friend VTK_THREAD_RETURN_TYPE vtkFPVRCMSwitchOnDataType(void* arg);
+  // Cast the rays of the scan lines of one of numberOfTiles tiles
+  void CastRays(int tileID, int numberOfTiles);
 
-  vtkMultiThreader* Threader;
+  int NumberOfThreads;
 
   vtkMatrix4x4* PerspectiveMatrix;
   vtkMatrix4x4* ViewToWorldMatrix;
@@ -512,8 +510,6 @@ protected:
 private:
   vtkFixedPointVolumeRayCastMapper(const vtkFixedPointVolumeRayCastMapper&) = delete;
   void operator=(const vtkFixedPointVolumeRayCastMapper&) = delete;
-
-  bool ThreadWarning;
 };
 
 inline unsigned int vtkFixedPointVolumeRayCastMapper::ToFixedPointPosition(float val)
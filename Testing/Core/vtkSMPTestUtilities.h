@@ -0,0 +1,100 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTestUtilities.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @file vtkSMPTestUtilities.h
+ * @brief Helpers for the tests that check that a threaded algorithm produces
+ * the same result as its sequential execution.
+ *
+ * A typical test builds and updates its algorithm in a function, runs it with
+ * RunSequentialAndThreaded() and compares the two results, for instance with
+ * SameArrays():
+ *
+ * \code
+ * auto outputs = vtkTest::RunSequentialAndThreaded([&]() { return Threshold(input); });
+ * if (!vtkTest::SameArrays(outputs.first->GetCellTypesArray(),
+ *       outputs.second->GetCellTypesArray()))
+ * {
+ *   return EXIT_FAILURE;
+ * }
+ * \endcode
+ */
+
+#ifndef vtkSMPTestUtilities_h
+#define vtkSMPTestUtilities_h
+
+#include "vtkDataArray.h"
+#include "vtkSMPTools.h"
+
+#include <utility> // Needed for std::pair
+
+namespace vtkTest
+{
+/**
+ * Configuration running vtkSMPTools with the sequential backend.
+ */
+inline vtkSMPTools::Config SequentialConfig()
+{
+  return vtkSMPTools::Config{ 1, "Sequential", false };
+}
+
+/**
+ * Configuration running vtkSMPTools with the default backend on 4 threads.
+ */
+inline vtkSMPTools::Config ThreadedConfig()
+{
+  return vtkSMPTools::Config{ 4 };
+}
+
+/**
+ * Call `run` once in the scope of SequentialConfig() and once in the scope of
+ * ThreadedConfig(), and return the sequential and threaded results.
+ */
+template <typename Functor>
+auto RunSequentialAndThreaded(Functor&& run) -> std::pair<decltype(run()), decltype(run())>
+{
+  std::pair<decltype(run()), decltype(run())> results;
+  vtkSMPTools::LocalScope(SequentialConfig(), [&]() { results.first = run(); });
+  vtkSMPTools::LocalScope(ThreadedConfig(), [&]() { results.second = run(); });
+  return results;
+}
+
+/**
+ * Return whether both arrays exist and have the same number of tuples,
+ * number of components and values.
+ */
+inline bool SameArrays(vtkDataArray* array1, vtkDataArray* array2)
+{
+  if (!array1 || !array2 || array1->GetNumberOfTuples() != array2->GetNumberOfTuples() ||
+    array1->GetNumberOfComponents() != array2->GetNumberOfComponents())
+  {
+    return false;
+  }
+  const int numComps = array1->GetNumberOfComponents();
+  for (vtkIdType i = 0; i < array1->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < numComps; ++c)
+    {
+      if (array1->GetComponent(i, c) != array2->GetComponent(i, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPTestUtilities.h
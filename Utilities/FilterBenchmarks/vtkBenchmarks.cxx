@@ -0,0 +1,636 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBenchmarks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+/*
+Micro-benchmarks of the core filters on synthetic inputs. Every benchmark
+is run for each requested SMP backend and number of threads, and the
+results (time, throughput and peak resident set size) are written as JSON
+so that runs of different VTK versions or machines can be compared.
+
+On Linux, the peak resident set size is reset before each benchmark, so it
+is the peak of its runs, which includes the resident inputs given by
+rss_start_bytes. Elsewhere it is the peak of the process since it started,
+as told by peak_rss_scope.
+
+To add a benchmark, add an entry to the list built by CreateBenchmarks():
+it names the synthetic input it uses and returns the number of items
+(cells, points or queries) it processed.
+*/
+
+#include "vtkCellTypeSource.h"
+#include "vtkContourFilter.h"
+#include "vtkCurvatures.h"
+#include "vtkCutter.h"
+#include "vtkDelaunay3D.h"
+#include "vtkGenericCell.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkPointSource.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkProbeFilter.h"
+#include "vtkQuadricDecimation.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSmoothPolyDataFilter.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkTableBasedClipDataSet.h"
+#include "vtkThreshold.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkUnstructuredGridReader.h"
+#include "vtkUnstructuredGridWriter.h"
+#include "vtkVersion.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+
+#include <vtksys/CommandLineArguments.hxx>
+#include <vtksys/RegularExpression.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+// psapi.h must come after windows.h
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+
+#if defined(__linux__)
+//------------------------------------------------------------------------------
+// Value of a field of /proc/self/status given in kB, in bytes.
+long long GetStatusSize(const char* field)
+{
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  const size_t length = std::strlen(field);
+  while (std::getline(status, line))
+  {
+    if (line.compare(0, length, field) == 0 && line.size() > length && line[length] == ':')
+    {
+      return std::atoll(line.c_str() + length + 1) * 1024;
+    }
+  }
+  return 0;
+}
+#endif
+
+//------------------------------------------------------------------------------
+// Reset the peak resident set size to the current one. Returns false if the
+// platform cannot, the peak is then that of the whole process.
+bool ResetPeakResidentSetSize()
+{
+#if defined(__linux__)
+  // since Linux 4.0
+  FILE* file = std::fopen("/proc/self/clear_refs", "w");
+  if (!file)
+  {
+    return false;
+  }
+  const bool reset = std::fputs("5", file) >= 0;
+  return std::fclose(file) == 0 && reset;
+#else
+  return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Current resident set size of the process, in bytes, or 0 if unknown.
+long long GetResidentSetSize()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+  {
+    return static_cast<long long>(counters.WorkingSetSize);
+  }
+  return 0;
+#elif defined(__linux__)
+  return GetStatusSize("VmRSS");
+#else
+  return 0;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Peak resident set size of the process since it started, or since it was
+// last reset, in bytes.
+long long GetPeakResidentSetSize()
+{
+#if defined(__linux__)
+  if (long long peak = GetStatusSize("VmHWM"))
+  {
+    return peak;
+  }
+#endif
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+  {
+    return static_cast<long long>(counters.PeakWorkingSetSize);
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return static_cast<long long>(usage.ru_maxrss);
+#else
+  return static_cast<long long>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Scalar value at a fraction of the range of the active point scalars.
+double ScalarAt(vtkDataSet* input, double fraction)
+{
+  const double* range = input->GetPointData()->GetScalars()->GetRange();
+  return range[0] + fraction * (range[1] - range[0]);
+}
+
+//------------------------------------------------------------------------------
+// The synthetic inputs, generated once for a given size.
+struct vtkBenchmarkInputs
+{
+  // vtkRTAnalyticSource on [-size, size]^3.
+  vtkSmartPointer<vtkImageData> Wavelet;
+  // vtkCellTypeSource tetrahedra in size^3 blocks, with a point scalar.
+  vtkSmartPointer<vtkUnstructuredGrid> Tetras;
+  // size^3 random points in the bounds of the wavelet.
+  vtkSmartPointer<vtkPolyData> Points;
+  // Isosurface of the wavelet, for the surface filters.
+  vtkSmartPointer<vtkPolyData> Surface;
+
+  void Generate(int size)
+  {
+    vtkNew<vtkRTAnalyticSource> wavelet;
+    wavelet->SetWholeExtent(-size, size, -size, size, -size, size);
+    wavelet->Update();
+    this->Wavelet = wavelet->GetOutput();
+
+    vtkNew<vtkCellTypeSource> tetras;
+    tetras->SetCellType(VTK_TETRA);
+    tetras->SetBlocksDimensions(size, size, size);
+    tetras->Update();
+    this->Tetras = tetras->GetOutput();
+    this->Tetras->GetPointData()->SetActiveScalars("DistanceToCenter");
+
+    vtkMath::RandomSeed(8775070);
+    vtkNew<vtkPointSource> points;
+    points->SetNumberOfPoints(static_cast<vtkIdType>(size) * size * size);
+    points->SetRadius(size);
+    points->SetDistributionToUniform();
+    points->Update();
+    this->Points = points->GetOutput();
+
+    vtkNew<vtkContourFilter> contour;
+    contour->SetInputData(this->Wavelet);
+    contour->SetValue(0, ScalarAt(this->Wavelet, 0.5));
+    contour->Update();
+    this->Surface = contour->GetOutput();
+  }
+};
+
+//------------------------------------------------------------------------------
+// The benchmarks. Each one returns the number of items it processed.
+vtkIdType ContourImage(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkContourFilter> contour;
+  contour->SetInputData(inputs.Wavelet);
+  contour->GenerateValues(4, ScalarAt(inputs.Wavelet, 0.2), ScalarAt(inputs.Wavelet, 0.8));
+  contour->Update();
+  return inputs.Wavelet->GetNumberOfCells();
+}
+
+vtkIdType ContourUnstructured(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkContourFilter> contour;
+  contour->SetInputData(inputs.Tetras);
+  contour->GenerateValues(4, ScalarAt(inputs.Tetras, 0.2), ScalarAt(inputs.Tetras, 0.8));
+  contour->Update();
+  return inputs.Tetras->GetNumberOfCells();
+}
+
+vtkIdType ClipScalar(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkTableBasedClipDataSet> clip;
+  clip->SetInputData(inputs.Tetras);
+  clip->SetValue(ScalarAt(inputs.Tetras, 0.5));
+  clip->Update();
+  return inputs.Tetras->GetNumberOfCells();
+}
+
+vtkIdType ClipPlane(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkPlane> plane;
+  plane->SetNormal(1.0, 1.0, 1.0);
+  vtkNew<vtkTableBasedClipDataSet> clip;
+  clip->SetInputData(inputs.Wavelet);
+  clip->SetClipFunction(plane);
+  clip->Update();
+  return inputs.Wavelet->GetNumberOfCells();
+}
+
+vtkIdType Cut(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(inputs.Tetras->GetCenter());
+  plane->SetNormal(1.0, 1.0, 1.0);
+  vtkNew<vtkCutter> cutter;
+  cutter->SetInputData(inputs.Tetras);
+  cutter->SetCutFunction(plane);
+  cutter->Update();
+  return inputs.Tetras->GetNumberOfCells();
+}
+
+vtkIdType Threshold(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputData(inputs.Tetras);
+  threshold->SetLowerThreshold(ScalarAt(inputs.Tetras, 0.25));
+  threshold->SetUpperThreshold(ScalarAt(inputs.Tetras, 0.75));
+  threshold->SetThresholdFunction(vtkThreshold::THRESHOLD_BETWEEN);
+  threshold->Update();
+  return inputs.Tetras->GetNumberOfCells();
+}
+
+vtkIdType Probe(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkProbeFilter> probe;
+  probe->SetInputData(inputs.Points);
+  probe->SetSourceData(inputs.Wavelet);
+  probe->Update();
+  return inputs.Points->GetNumberOfPoints();
+}
+
+vtkIdType Normals(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(inputs.Surface);
+  normals->SplittingOn();
+  normals->Update();
+  return inputs.Surface->GetNumberOfCells();
+}
+
+vtkIdType QuadricDecimation(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkQuadricDecimation> decimate;
+  decimate->SetInputData(inputs.Surface);
+  decimate->SetTargetReduction(0.75);
+  decimate->Update();
+  return inputs.Surface->GetNumberOfCells();
+}
+
+vtkIdType Smooth(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkSmoothPolyDataFilter> smooth;
+  smooth->SetInputData(inputs.Surface);
+  smooth->ParallelSmoothingOn();
+  smooth->Update();
+  return inputs.Surface->GetNumberOfPoints();
+}
+
+vtkIdType Curvatures(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkCurvatures> curvatures;
+  curvatures->SetInputData(inputs.Surface);
+  curvatures->SetCurvatureTypeToMaximum();
+  curvatures->Update();
+  return inputs.Surface->GetNumberOfPoints();
+}
+
+vtkIdType Delaunay3D(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkDelaunay3D> delaunay;
+  delaunay->SetInputData(inputs.Points);
+  delaunay->ParallelInsertionOn();
+  delaunay->Update();
+  return inputs.Points->GetNumberOfPoints();
+}
+
+// Locators are built, then queried in parallel with the point cloud.
+vtkIdType StaticPointLocator(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(inputs.Wavelet);
+  locator->BuildLocator();
+  vtkPoints* queries = inputs.Points->GetPoints();
+  const vtkIdType numQueries = queries->GetNumberOfPoints();
+  vtkSMPTools::For(0, numQueries, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      queries->GetPoint(i, x);
+      locator->FindClosestPoint(x);
+    }
+  });
+  return numQueries;
+}
+
+vtkIdType StaticCellLocator(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkStaticCellLocator> locator;
+  locator->SetDataSet(inputs.Tetras);
+  locator->BuildLocator();
+  vtkPoints* queries = inputs.Points->GetPoints();
+  const vtkIdType numQueries = queries->GetNumberOfPoints();
+  // The point cloud fills a sphere of radius size around the origin and the
+  // tetrahedra fill [0, size]^3: move the queries into the tetrahedra.
+  const double offset = 0.5 * inputs.Tetras->GetBounds()[1];
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPTools::For(0, numQueries, [&](vtkIdType begin, vtkIdType end) {
+    vtkGenericCell* cell = tlCell.Local();
+    double x[3], pcoords[3], weights[VTK_CELL_SIZE];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      queries->GetPoint(i, x);
+      for (int j = 0; j < 3; ++j)
+      {
+        x[j] = offset + 0.5 * x[j];
+      }
+      locator->FindCell(x, 0.0, cell, pcoords, weights);
+    }
+  });
+  return numQueries;
+}
+
+vtkIdType XMLWriteRead(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkXMLUnstructuredGridWriter> writer;
+  writer->SetInputData(inputs.Tetras);
+  writer->WriteToOutputStringOn();
+  writer->SetDataModeToAppended();
+  writer->Write();
+  vtkNew<vtkXMLUnstructuredGridReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(writer->GetOutputString());
+  reader->Update();
+  return inputs.Tetras->GetNumberOfCells();
+}
+
+vtkIdType LegacyWriteRead(const vtkBenchmarkInputs& inputs)
+{
+  vtkNew<vtkUnstructuredGridWriter> writer;
+  writer->SetInputData(inputs.Tetras);
+  writer->WriteToOutputStringOn();
+  writer->SetFileTypeToBinary();
+  writer->Write();
+  vtkNew<vtkUnstructuredGridReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(writer->GetOutputStdString());
+  reader->Update();
+  return inputs.Tetras->GetNumberOfCells();
+}
+
+//------------------------------------------------------------------------------
+struct vtkBenchmark
+{
+  std::string Name;
+  // Name of the synthetic input used.
+  std::string Input;
+  std::function<vtkIdType(const vtkBenchmarkInputs&)> Run;
+};
+
+std::vector<vtkBenchmark> CreateBenchmarks()
+{
+  return { { "ContourImage", "wavelet", ContourImage },
+    { "ContourUnstructured", "tetras", ContourUnstructured },
+    { "ClipScalar", "tetras", ClipScalar }, { "ClipPlane", "wavelet", ClipPlane },
+    { "Cut", "tetras", Cut }, { "Threshold", "tetras", Threshold },
+    { "Probe", "points", Probe }, { "Normals", "surface", Normals },
+    { "QuadricDecimation", "surface", QuadricDecimation }, { "Smooth", "surface", Smooth },
+    { "Curvatures", "surface", Curvatures },
+    { "Delaunay3D", "points", Delaunay3D },
+    { "StaticPointLocator", "points", StaticPointLocator },
+    { "StaticCellLocator", "points", StaticCellLocator },
+    { "XMLWriteRead", "tetras", XMLWriteRead }, { "LegacyWriteRead", "tetras", LegacyWriteRead } };
+}
+
+//------------------------------------------------------------------------------
+struct vtkBenchmarkResult
+{
+  std::string Name;
+  std::string Input;
+  std::string Backend;
+  int Threads;
+  vtkIdType Items;
+  double MinTime;
+  double MeanTime;
+  long long StartRSS;
+  long long PeakRSS;
+  // Whether PeakRSS is the peak of the runs, or of the process.
+  bool PeakRSSReset;
+};
+
+//------------------------------------------------------------------------------
+void WriteJSON(
+  std::ostream& os, int size, int repeat, const std::vector<vtkBenchmarkResult>& results)
+{
+  os << "{\n"
+     << "  \"vtk_version\": \"" << vtkVersion::GetVTKVersion() << "\",\n"
+     << "  \"size\": " << size << ",\n"
+     << "  \"repeat\": " << repeat << ",\n"
+     << "  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const vtkBenchmarkResult& result = results[i];
+    os << (i == 0 ? "\n" : ",\n") << "    {\n"
+       << "      \"name\": \"" << result.Name << "\",\n"
+       << "      \"input\": \"" << result.Input << "\",\n"
+       << "      \"backend\": \"" << result.Backend << "\",\n"
+       << "      \"threads\": " << result.Threads << ",\n"
+       << "      \"items\": " << result.Items << ",\n"
+       << "      \"time_min_s\": " << result.MinTime << ",\n"
+       << "      \"time_mean_s\": " << result.MeanTime << ",\n"
+       << "      \"throughput_items_per_s\": "
+       << (result.MinTime > 0.0 ? result.Items / result.MinTime : 0.0) << ",\n"
+       << "      \"rss_start_bytes\": " << result.StartRSS << ",\n"
+       << "      \"peak_rss_bytes\": " << result.PeakRSS << ",\n"
+       << "      \"peak_rss_scope\": \"" << (result.PeakRSSReset ? "benchmark" : "process")
+       << "\"\n"
+       << "    }";
+  }
+  os << "\n  ]\n}\n";
+}
+
+} // anonymous namespace
+
+/*=========================================================================
+The main entry point
+=========================================================================*/
+int main(int argc, char* argv[])
+{
+  int size = 32;
+  int repeat = 3;
+  std::string regex;
+  std::string outputFileName;
+  std::vector<std::string> backends;
+  std::vector<int> threads;
+  bool displayHelp = false;
+  bool listBenchmarks = false;
+
+  vtksys::CommandLineArguments arguments;
+  arguments.Initialize(argc, argv);
+  typedef vtksys::CommandLineArguments argT;
+  arguments.AddArgument("-size", argT::SPACE_ARGUMENT, &size,
+    "Size of the synthetic inputs: the wavelet has (2 * size + 1)^3 points, the "
+    "tetrahedra fill size^3 blocks and the point cloud has size^3 points. Defaults to 32.");
+  arguments.AddArgument("-repeat", argT::SPACE_ARGUMENT, &repeat,
+    "Number of runs of each benchmark. The minimum and mean times are reported. Defaults to 3.");
+  arguments.AddArgument(
+    "-regex", argT::SPACE_ARGUMENT, &regex, "Regular expression selecting the benchmarks to run.");
+  arguments.AddArgument("-backends", argT::MULTI_ARGUMENT, &backends,
+    "SMP backends to use among Sequential, STDThread, TBB and OpenMP. Backends not "
+    "built in are skipped. Defaults to the current backend.");
+  arguments.AddArgument("-threads", argT::MULTI_ARGUMENT, &threads,
+    "Numbers of threads to use. 0 means the backend default. Defaults to 0.");
+  arguments.AddArgument("-o", argT::SPACE_ARGUMENT, &outputFileName,
+    "File to write the JSON results to. Defaults to the standard output.");
+  arguments.AddBooleanArgument("-list", &listBenchmarks, "List the available benchmarks.");
+  arguments.AddBooleanArgument(
+    "--help", &displayHelp, "Provide a listing of command line options.");
+
+  if (!arguments.Parse())
+  {
+    cerr << "Problem parsing arguments" << endl;
+    return 1;
+  }
+  if (displayHelp)
+  {
+    cerr << "Usage" << endl
+         << endl
+         << "  vtkBenchmarks [options]" << endl
+         << endl
+         << "Options" << endl;
+    cerr << arguments.GetHelp();
+    return 0;
+  }
+
+  vtksys::RegularExpression re(regex.empty() ? "." : regex.c_str());
+  std::vector<vtkBenchmark> benchmarks;
+  for (const vtkBenchmark& benchmark : CreateBenchmarks())
+  {
+    if (re.find(benchmark.Name))
+    {
+      benchmarks.push_back(benchmark);
+    }
+  }
+  if (listBenchmarks)
+  {
+    for (const vtkBenchmark& benchmark : benchmarks)
+    {
+      cout << benchmark.Name << " (" << benchmark.Input << ")" << endl;
+    }
+    return 0;
+  }
+
+  // Keep only the backends that are available.
+  const std::string defaultBackend = vtkSMPTools::GetBackend();
+  if (backends.empty())
+  {
+    backends.push_back(defaultBackend);
+  }
+  std::vector<std::string> availableBackends;
+  for (const std::string& backend : backends)
+  {
+    if (vtkSMPTools::SetBackend(backend.c_str()))
+    {
+      availableBackends.push_back(backend);
+    }
+    else
+    {
+      cerr << "Backend " << backend << " is not available, skipping it." << endl;
+    }
+  }
+  vtkSMPTools::SetBackend(defaultBackend.c_str());
+  if (threads.empty())
+  {
+    threads.push_back(0);
+  }
+  repeat = std::max(repeat, 1);
+
+  cerr << "Generating inputs of size " << size << endl;
+  vtkBenchmarkInputs inputs;
+  inputs.Generate(size);
+
+  std::vector<vtkBenchmarkResult> results;
+  for (const vtkBenchmark& benchmark : benchmarks)
+  {
+    for (const std::string& backend : availableBackends)
+    {
+      for (int numThreads : threads)
+      {
+        vtkBenchmarkResult result{ benchmark.Name, benchmark.Input, backend, numThreads, 0,
+          VTK_DOUBLE_MAX, 0.0, 0, 0, false };
+        result.PeakRSSReset = ResetPeakResidentSetSize();
+        result.StartRSS = GetResidentSetSize();
+        vtkSMPTools::LocalScope(vtkSMPTools::Config{ numThreads, backend, false }, [&]() {
+          result.Threads = vtkSMPTools::GetEstimatedNumberOfThreads();
+          for (int run = 0; run < repeat; ++run)
+          {
+            const double start = vtkTimerLog::GetUniversalTime();
+            result.Items = benchmark.Run(inputs);
+            const double time = vtkTimerLog::GetUniversalTime() - start;
+            result.MinTime = std::min(result.MinTime, time);
+            result.MeanTime += time / repeat;
+          }
+        });
+        result.PeakRSS = GetPeakResidentSetSize();
+        cerr << benchmark.Name << ", " << backend << ", " << result.Threads << " threads: "
+             << result.MinTime << " s" << endl;
+        results.push_back(result);
+      }
+    }
+  }
+
+  if (outputFileName.empty())
+  {
+    WriteJSON(cout, size, repeat, results);
+  }
+  else
+  {
+    std::ofstream file(outputFileName);
+    if (!file)
+    {
+      cerr << "Cannot write " << outputFileName << endl;
+      return 1;
+    }
+    WriteJSON(file, size, repeat, results);
+  }
+  return 0;
+}